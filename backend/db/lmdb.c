@@ -0,0 +1,3982 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include <math.h>
+#include <string.h>
+
+#include <lmdb.h>
+
+#include <julea.h>
+#include <julea-db.h>
+
+#include <db-util/jbson.h>
+
+/*
+ * Data layout (all keys start with "namespace \0 name \0"):
+ * - schema: prefix -> schema BSON as passed to backend_schema_create
+ * - row:    prefix, ID (big-endian) -> null bitmap followed by the present values in schema order
+ * - index:  prefix, index number (1 byte), encoded fields, ID (big-endian) -> empty
+ *
+ * Fields in index keys consist of a presence byte and an encoding whose byte order equals the value order.
+ * Strings are truncated to J_LMDB_INDEX_STRING_LENGTH bytes and blobs end an index key.
+ * Indexes and the primary key are therefore only used to find candidates, all predicates are checked on the row.
+ */
+
+#define J_LMDB_FIELD_ID G_MAXUINT
+#define J_LMDB_FIELD_COUNT (G_MAXUINT - 1)
+#define J_LMDB_INDEX_MAX 255
+#define J_LMDB_INDEX_STRING_LENGTH 64
+
+/*
+ * LMDB can not grow the map while transactions are active, so the map size is fixed when opening the environment.
+ * The map only reserves address space, the file grows as needed.
+ */
+#if GLIB_SIZEOF_VOID_P == 8
+#define J_LMDB_MAP_SIZE_DEFAULT (G_GUINT64_CONSTANT(1) << 40)
+#else
+#define J_LMDB_MAP_SIZE_DEFAULT (G_GUINT64_CONSTANT(1) << 30)
+#endif
+
+struct JLMDBData
+{
+	MDB_env* env;
+	MDB_dbi schema_dbi;
+	MDB_dbi row_dbi;
+	MDB_dbi index_dbi;
+};
+
+typedef struct JLMDBData JLMDBData;
+
+struct JLMDBSchema
+{
+	gchar* name;
+	/// The prefix of all keys belonging to this schema.
+	GByteArray* prefix;
+	GPtrArray* fields;
+	GArray* types;
+	/// Maps field names to their position + 1.
+	GHashTable* positions;
+	/// Contains one GArray of field positions per index.
+	GPtrArray* indexes;
+	/// The next free ID, 0 if it has not been determined yet.
+	guint64 next_id;
+};
+
+typedef struct JLMDBSchema JLMDBSchema;
+
+struct JLMDBBatch
+{
+	/// The transaction is started lazily and is read-only until the first modification.
+	MDB_txn* txn;
+	gboolean write;
+	gchar* namespace;
+	JSemantics* semantics;
+	/// Schemas used by this batch, maps names to JLMDBSchema.
+	GHashTable* schemas;
+	/// Scratch buffer for keys that are used immediately.
+	GByteArray* key;
+};
+
+typedef struct JLMDBBatch JLMDBBatch;
+
+struct JLMDBRow
+{
+	guint64 id;
+	JDBTypeValue* values;
+	gboolean* present;
+};
+
+typedef struct JLMDBRow JLMDBRow;
+
+struct JLMDBPredicate
+{
+	gboolean group;
+	JDBSelectorMode mode;
+	GPtrArray* children;
+	/// Position of the table within the query.
+	guint table;
+	guint field;
+	JDBType type;
+	JDBSelectorOperator op;
+	JDBTypeValue value;
+};
+
+typedef struct JLMDBPredicate JLMDBPredicate;
+
+struct JLMDBJoin
+{
+	guint table[2];
+	guint field[2];
+};
+
+typedef struct JLMDBJoin JLMDBJoin;
+
+enum JLMDBAccessType
+{
+	J_LMDB_ACCESS_SCAN,
+	J_LMDB_ACCESS_PRIMARY,
+	J_LMDB_ACCESS_INDEX
+};
+
+typedef enum JLMDBAccessType JLMDBAccessType;
+
+struct JLMDBAccess
+{
+	JLMDBAccessType type;
+	guint table;
+	guint index;
+	/// Equality predicates on _id or on the leading fields of the index.
+	GPtrArray* eq;
+	JLMDBPredicate* lower;
+	JLMDBPredicate* upper;
+	/// If set, the first field of the index (or _id) is looked up using a row of an earlier table.
+	JLMDBJoin* join;
+	guint join_side;
+	guint score;
+};
+
+typedef struct JLMDBAccess JLMDBAccess;
+
+struct JLMDBQuery
+{
+	gchar const* namespace;
+	/// The selector, used to look up the values bound to parameters.
+	bson_t const* selector;
+	/// JLMDBSchema, owned by the batch.
+	GPtrArray* tables;
+	GPtrArray* joins;
+	JLMDBPredicate* root;
+	/// Whether all predicates are already checked when the rows are fetched.
+	gboolean prefiltered;
+	/// One access per table in join order.
+	GPtrArray* accesses;
+	guint merged;
+};
+
+typedef struct JLMDBQuery JLMDBQuery;
+
+struct JLMDBIterator
+{
+	JLMDBBatch* batch;
+	JLMDBQuery* query;
+	/// Contains one ID per table for every result.
+	GArray* results;
+	guint position;
+	JLMDBRow* rows;
+	/// Contains the full field names per table.
+	GPtrArray* names;
+	/// Contains one bson_t per result if the query computes an aggregate, NULL otherwise.
+	GPtrArray* aggregates;
+};
+
+typedef struct JLMDBIterator JLMDBIterator;
+
+struct JLMDBAggregate
+{
+	JDBAggregate function;
+	guint table;
+	/// The aggregated field, J_LMDB_FIELD_COUNT if entries are counted.
+	guint field;
+	JDBType type;
+	JDBType result_type;
+	gboolean grouped;
+	guint group;
+	JDBType group_type;
+};
+
+typedef struct JLMDBAggregate JLMDBAggregate;
+
+struct JLMDBGroup
+{
+	/// The group value as order-preserving key.
+	GByteArray* key;
+	gboolean group_present;
+	JDBTypeValue group_value;
+	guint64 count;
+	gboolean present;
+	/// The minimum or maximum, strings point into the memory map.
+	JDBTypeValue value;
+	gint64 sum_sint64;
+	guint64 sum_uint64;
+	gdouble sum_float64;
+};
+
+typedef struct JLMDBGroup JLMDBGroup;
+
+static void
+j_lmdb_set_error(GError** error, gint rc)
+{
+	if (rc == MDB_MAP_FULL)
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "lmdb map is full, the map size can be increased using the backend path (directory:size)");
+		return;
+	}
+
+	g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "lmdb failed error was '%s'", mdb_strerror(rc));
+}
+
+/**
+ * Parses a map size, optionally followed by a binary unit (K, M, G or T).
+ *
+ * \param str      A string.
+ * \param map_size Returns the map size.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_lmdb_parse_map_size(gchar const* str, guint64* map_size)
+{
+	gchar* end;
+	guint64 value;
+	guint shift = 0;
+
+	// g_ascii_strtoull() would accept signs and whitespace
+	if (!g_ascii_isdigit(*str))
+	{
+		return FALSE;
+	}
+
+	value = g_ascii_strtoull(str, &end, 10);
+
+	switch (g_ascii_toupper(*end))
+	{
+		case 'T':
+			shift += 10;
+			// fallthrough
+		case 'G':
+			shift += 10;
+			// fallthrough
+		case 'M':
+			shift += 10;
+			// fallthrough
+		case 'K':
+			shift += 10;
+			end++;
+			break;
+		default:
+			break;
+	}
+
+	if (*end != '\0' || value == 0 || value > (G_MAXSIZE >> shift))
+	{
+		return FALSE;
+	}
+
+	*map_size = value << shift;
+
+	return TRUE;
+}
+
+static void
+j_lmdb_key_prefix(GByteArray* key, gchar const* namespace, gchar const* name)
+{
+	g_byte_array_append(key, (guint8 const*)namespace, strlen(namespace) + 1);
+	g_byte_array_append(key, (guint8 const*)name, strlen(name) + 1);
+}
+
+static void
+j_lmdb_key_append_id(GByteArray* key, guint64 id)
+{
+	guint64 be_id = GUINT64_TO_BE(id);
+
+	g_byte_array_append(key, (guint8 const*)&be_id, sizeof(be_id));
+}
+
+static guint64
+j_lmdb_key_get_id(MDB_val const* key)
+{
+	guint64 be_id;
+
+	memcpy(&be_id, (guint8 const*)key->mv_data + key->mv_size - sizeof(be_id), sizeof(be_id));
+
+	return GUINT64_FROM_BE(be_id);
+}
+
+static void
+j_lmdb_schema_free(gpointer data)
+{
+	JLMDBSchema* schema = data;
+
+	g_free(schema->name);
+	g_byte_array_unref(schema->prefix);
+	g_ptr_array_unref(schema->fields);
+	g_array_unref(schema->types);
+	g_hash_table_unref(schema->positions);
+	g_ptr_array_unref(schema->indexes);
+	g_free(schema);
+}
+
+static JDBType
+j_lmdb_schema_type(JLMDBSchema const* schema, guint field)
+{
+	if (field == J_LMDB_FIELD_ID)
+	{
+		return J_DB_TYPE_UINT64;
+	}
+
+	return g_array_index(schema->types, JDBType, field);
+}
+
+static gchar const*
+j_lmdb_schema_field_name(JLMDBSchema const* schema, guint field)
+{
+	if (field == J_LMDB_FIELD_ID)
+	{
+		return "_id";
+	}
+
+	return g_ptr_array_index(schema->fields, field);
+}
+
+static gboolean
+j_lmdb_schema_field(JLMDBSchema const* schema, gchar const* name, guint* field, JDBType* type, GError** error)
+{
+	gpointer position;
+
+	if (g_str_equal(name, "_id"))
+	{
+		*field = J_LMDB_FIELD_ID;
+		*type = J_DB_TYPE_UINT64;
+
+		return TRUE;
+	}
+
+	if (G_UNLIKELY(!g_hash_table_lookup_extended(schema->positions, name, NULL, &position)))
+	{
+		g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND, "variable %s not found", name);
+		return FALSE;
+	}
+
+	*field = GPOINTER_TO_UINT(position) - 1;
+	*type = g_array_index(schema->types, JDBType, *field);
+
+	return TRUE;
+}
+
+static JLMDBSchema*
+j_lmdb_schema_new(gchar const* namespace, gchar const* name, bson_t const* bson, GError** error)
+{
+	JLMDBSchema* schema;
+	JDBTypeValue value;
+	bson_iter_t iter;
+	gboolean has_next;
+	gboolean has_index = FALSE;
+
+	schema = g_new0(JLMDBSchema, 1);
+	schema->name = g_strdup(name);
+	schema->prefix = g_byte_array_new();
+	schema->fields = g_ptr_array_new_with_free_func(g_free);
+	schema->types = g_array_new(FALSE, FALSE, sizeof(JDBType));
+	// the keys are owned by fields
+	schema->positions = g_hash_table_new(g_str_hash, g_str_equal);
+	schema->indexes = g_ptr_array_new_with_free_func((GDestroyNotify)g_array_unref);
+
+	j_lmdb_key_prefix(schema->prefix, namespace, name);
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, bson, error)))
+	{
+		goto _error;
+	}
+
+	while (TRUE)
+	{
+		gchar const* key;
+		gchar* field;
+		JDBType type;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY((key = j_bson_iter_key(&iter, error)) == NULL))
+		{
+			goto _error;
+		}
+
+		if (g_str_equal(key, "_index"))
+		{
+			has_index = TRUE;
+			continue;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_value(&iter, J_DB_TYPE_UINT32, &value, error)))
+		{
+			goto _error;
+		}
+
+		type = value.val_uint32;
+
+		switch (type)
+		{
+			case J_DB_TYPE_ID:
+				type = J_DB_TYPE_UINT64;
+				break;
+			case J_DB_TYPE_SINT32:
+			case J_DB_TYPE_UINT32:
+			case J_DB_TYPE_FLOAT32:
+			case J_DB_TYPE_SINT64:
+			case J_DB_TYPE_UINT64:
+			case J_DB_TYPE_FLOAT64:
+			case J_DB_TYPE_STRING:
+			case J_DB_TYPE_BLOB:
+				break;
+			default:
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_DB_TYPE_INVALID, "db type invalid");
+				goto _error;
+		}
+
+		field = g_strdup(key);
+		g_hash_table_insert(schema->positions, field, GUINT_TO_POINTER(schema->fields->len + 1));
+		g_ptr_array_add(schema->fields, field);
+		g_array_append_val(schema->types, type);
+	}
+
+	if (G_UNLIKELY(schema->fields->len == 0))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SCHEMA_EMPTY, "schema empty");
+		goto _error;
+	}
+
+	if (has_index)
+	{
+		bson_iter_t iter_child;
+
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, bson, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "_index", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_array(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		while (TRUE)
+		{
+			bson_iter_t iter_field;
+			GArray* index;
+
+			if (G_UNLIKELY(!j_bson_iter_next(&iter_child, &has_next, error)))
+			{
+				goto _error;
+			}
+
+			if (!has_next)
+			{
+				break;
+			}
+
+			if (G_UNLIKELY(schema->indexes->len == J_LMDB_INDEX_MAX))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "too many indexes");
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_array(&iter_child, &iter_field, error)))
+			{
+				goto _error;
+			}
+
+			index = g_array_new(FALSE, FALSE, sizeof(guint));
+			g_ptr_array_add(schema->indexes, index);
+
+			while (TRUE)
+			{
+				guint field;
+				JDBType type;
+
+				if (G_UNLIKELY(!j_bson_iter_next(&iter_field, &has_next, error)))
+				{
+					goto _error;
+				}
+
+				if (!has_next)
+				{
+					break;
+				}
+
+				if (G_UNLIKELY(!j_bson_iter_value(&iter_field, J_DB_TYPE_STRING, &value, error)))
+				{
+					goto _error;
+				}
+
+				if (G_UNLIKELY(!j_lmdb_schema_field(schema, value.val_string, &field, &type, error)))
+				{
+					goto _error;
+				}
+
+				g_array_append_val(index, field);
+			}
+		}
+	}
+
+	return schema;
+
+_error:
+	j_lmdb_schema_free(schema);
+
+	return NULL;
+}
+
+static gboolean
+j_lmdb_batch_begin(JLMDBData* bd, JLMDBBatch* batch, gboolean write, GError** error)
+{
+	gint rc;
+
+	if (batch->txn != NULL)
+	{
+		if (batch->write || !write)
+		{
+			return TRUE;
+		}
+
+		// LMDB can not upgrade read-only transactions, the snapshot is released before starting the write transaction
+		mdb_txn_abort(batch->txn);
+		batch->txn = NULL;
+	}
+
+	if (G_UNLIKELY((rc = mdb_txn_begin(bd->env, NULL, (write) ? 0 : MDB_RDONLY, &(batch->txn))) != 0))
+	{
+		batch->txn = NULL;
+		j_lmdb_set_error(error, rc);
+		return FALSE;
+	}
+
+	batch->write = write;
+
+	return TRUE;
+}
+
+static void
+j_lmdb_batch_abort(JLMDBBatch* batch)
+{
+	if (batch->txn != NULL)
+	{
+		mdb_txn_abort(batch->txn);
+		batch->txn = NULL;
+	}
+
+	// the cache might contain schemas or IDs that have not been committed
+	g_hash_table_remove_all(batch->schemas);
+}
+
+static JLMDBSchema*
+j_lmdb_schema_get(JLMDBData* bd, JLMDBBatch* batch, gchar const* name, GError** error)
+{
+	JLMDBSchema* schema;
+	MDB_val key;
+	MDB_val value;
+	bson_t bson;
+	gint rc;
+
+	if ((schema = g_hash_table_lookup(batch->schemas, name)) != NULL)
+	{
+		return schema;
+	}
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, FALSE, error)))
+	{
+		goto _error;
+	}
+
+	g_byte_array_set_size(batch->key, 0);
+	j_lmdb_key_prefix(batch->key, batch->namespace, name);
+
+	key.mv_size = batch->key->len;
+	key.mv_data = batch->key->data;
+
+	if (G_UNLIKELY((rc = mdb_get(batch->txn, bd->schema_dbi, &key, &value)) != 0))
+	{
+		if (rc == MDB_NOTFOUND)
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND, "schema not found");
+		}
+		else
+		{
+			j_lmdb_set_error(error, rc);
+		}
+
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!bson_init_static(&bson, value.mv_data, value.mv_size)))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "schema corrupted");
+		goto _error;
+	}
+
+	if (G_UNLIKELY((schema = j_lmdb_schema_new(batch->namespace, name, &bson, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	g_hash_table_insert(batch->schemas, g_strdup(name), schema);
+
+	return schema;
+
+_error:
+	return NULL;
+}
+
+static void
+j_lmdb_row_init(JLMDBRow* row, JLMDBSchema const* schema)
+{
+	row->id = 0;
+	row->values = g_new0(JDBTypeValue, schema->fields->len);
+	row->present = g_new0(gboolean, schema->fields->len);
+}
+
+static void
+j_lmdb_row_clear(JLMDBRow* row)
+{
+	g_free(row->values);
+	g_free(row->present);
+
+	row->values = NULL;
+	row->present = NULL;
+}
+
+static gboolean
+j_lmdb_row_value(JLMDBRow const* row, guint field, JDBTypeValue* value)
+{
+	if (field == J_LMDB_FIELD_ID)
+	{
+		value->val_uint64 = row->id;
+		return TRUE;
+	}
+
+	if (!row->present[field])
+	{
+		return FALSE;
+	}
+
+	*value = row->values[field];
+
+	return TRUE;
+}
+
+static void
+j_lmdb_row_key(GByteArray* key, JLMDBSchema const* schema, guint64 id)
+{
+	g_byte_array_set_size(key, 0);
+	g_byte_array_append(key, schema->prefix->data, schema->prefix->len);
+	j_lmdb_key_append_id(key, id);
+}
+
+static void
+j_lmdb_row_encode(JLMDBSchema const* schema, JLMDBRow const* row, GByteArray* buffer)
+{
+	guint bitmap_size = (schema->fields->len + 7) / 8;
+
+	g_byte_array_set_size(buffer, bitmap_size);
+	memset(buffer->data, 0, bitmap_size);
+
+	for (guint i = 0; i < schema->fields->len; i++)
+	{
+		JDBTypeValue const* value = &(row->values[i]);
+		guint32 length;
+
+		if (!row->present[i])
+		{
+			continue;
+		}
+
+		buffer->data[i / 8] |= 1 << (i % 8);
+
+		switch (g_array_index(schema->types, JDBType, i))
+		{
+			case J_DB_TYPE_SINT32:
+			case J_DB_TYPE_UINT32:
+			case J_DB_TYPE_FLOAT32:
+				// all members of JDBTypeValue start at the same address
+				g_byte_array_append(buffer, (guint8 const*)value, 4);
+				break;
+			case J_DB_TYPE_SINT64:
+			case J_DB_TYPE_UINT64:
+			case J_DB_TYPE_FLOAT64:
+				g_byte_array_append(buffer, (guint8 const*)value, 8);
+				break;
+			case J_DB_TYPE_STRING:
+				length = strlen(value->val_string) + 1;
+				g_byte_array_append(buffer, (guint8 const*)&length, sizeof(length));
+				g_byte_array_append(buffer, (guint8 const*)value->val_string, length);
+				break;
+			case J_DB_TYPE_BLOB:
+				length = value->val_blob_length;
+				g_byte_array_append(buffer, (guint8 const*)&length, sizeof(length));
+
+				if (length > 0)
+				{
+					g_byte_array_append(buffer, (guint8 const*)value->val_blob, length);
+				}
+
+				break;
+			case J_DB_TYPE_ID:
+			default:
+				g_assert_not_reached();
+		}
+	}
+}
+
+/**
+ * Decodes a row without copying it, strings and blobs point into the memory map of the current transaction.
+ **/
+static gboolean
+j_lmdb_row_decode(JLMDBSchema const* schema, guint64 id, MDB_val const* data, JLMDBRow* row, GError** error)
+{
+	guint8 const* bytes = data->mv_data;
+	gsize size = data->mv_size;
+	gsize offset = (schema->fields->len + 7) / 8;
+
+	if (G_UNLIKELY(size < offset))
+	{
+		goto _corrupted;
+	}
+
+	row->id = id;
+
+	for (guint i = 0; i < schema->fields->len; i++)
+	{
+		JDBTypeValue* value = &(row->values[i]);
+		guint32 length;
+		gsize width = 0;
+
+		memset(value, 0, sizeof(*value));
+		row->present[i] = (bytes[i / 8] & (1 << (i % 8))) != 0;
+
+		if (!row->present[i])
+		{
+			continue;
+		}
+
+		switch (g_array_index(schema->types, JDBType, i))
+		{
+			case J_DB_TYPE_SINT32:
+			case J_DB_TYPE_UINT32:
+			case J_DB_TYPE_FLOAT32:
+				width = 4;
+				break;
+			case J_DB_TYPE_SINT64:
+			case J_DB_TYPE_UINT64:
+			case J_DB_TYPE_FLOAT64:
+				width = 8;
+				break;
+			case J_DB_TYPE_STRING:
+			case J_DB_TYPE_BLOB:
+				if (G_UNLIKELY(offset + sizeof(length) > size))
+				{
+					goto _corrupted;
+				}
+
+				memcpy(&length, bytes + offset, sizeof(length));
+				offset += sizeof(length);
+
+				if (G_UNLIKELY(offset + length > size))
+				{
+					goto _corrupted;
+				}
+
+				if (g_array_index(schema->types, JDBType, i) == J_DB_TYPE_STRING)
+				{
+					if (G_UNLIKELY(length == 0 || bytes[offset + length - 1] != '\0'))
+					{
+						goto _corrupted;
+					}
+
+					value->val_string = (gchar const*)(bytes + offset);
+				}
+				else
+				{
+					value->val_blob = (gchar const*)(bytes + offset);
+					value->val_blob_length = length;
+				}
+
+				offset += length;
+				break;
+			case J_DB_TYPE_ID:
+			default:
+				goto _corrupted;
+		}
+
+		if (width > 0)
+		{
+			if (G_UNLIKELY(offset + width > size))
+			{
+				goto _corrupted;
+			}
+
+			memcpy(value, bytes + offset, width);
+			offset += width;
+		}
+	}
+
+	return TRUE;
+
+_corrupted:
+	g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "row corrupted");
+
+	return FALSE;
+}
+
+static gboolean
+j_lmdb_row_load(JLMDBData* bd, JLMDBBatch* batch, JLMDBSchema const* schema, guint64 id, JLMDBRow* row, gboolean* found, GError** error)
+{
+	MDB_val key;
+	MDB_val value;
+	gint rc;
+
+	j_lmdb_row_key(batch->key, schema, id);
+
+	key.mv_size = batch->key->len;
+	key.mv_data = batch->key->data;
+
+	if ((rc = mdb_get(batch->txn, bd->row_dbi, &key, &value)) != 0)
+	{
+		if (rc == MDB_NOTFOUND)
+		{
+			*found = FALSE;
+			return TRUE;
+		}
+
+		j_lmdb_set_error(error, rc);
+		return FALSE;
+	}
+
+	*found = TRUE;
+
+	return j_lmdb_row_decode(schema, id, &value, row, error);
+}
+
+static gboolean
+j_lmdb_type_indexable(JDBType type)
+{
+	return (type != J_DB_TYPE_BLOB);
+}
+
+/**
+ * Appends a present value to an index key.
+ *
+ * Unterminated strings are used as scan bounds, they sort before all strings they are a prefix of.
+ **/
+static void
+j_lmdb_encode_value(GByteArray* key, JDBType type, JDBTypeValue const* value, gboolean terminate)
+{
+	guint8 present = 1;
+	guint32 u32;
+	guint64 u64;
+	gfloat f32;
+	gdouble f64;
+	gsize length;
+
+	g_byte_array_append(key, &present, 1);
+
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			u32 = GUINT32_TO_BE((guint32)value->val_sint32 ^ 0x80000000U);
+			g_byte_array_append(key, (guint8 const*)&u32, sizeof(u32));
+			break;
+		case J_DB_TYPE_UINT32:
+			u32 = GUINT32_TO_BE(value->val_uint32);
+			g_byte_array_append(key, (guint8 const*)&u32, sizeof(u32));
+			break;
+		case J_DB_TYPE_FLOAT32:
+			// -0.0 and 0.0 are equal and have to be encoded identically
+			f32 = (value->val_float32 == 0.0f) ? 0.0f : value->val_float32;
+			memcpy(&u32, &f32, sizeof(u32));
+			u32 = (u32 & 0x80000000) ? ~u32 : (u32 | 0x80000000);
+			u32 = GUINT32_TO_BE(u32);
+			g_byte_array_append(key, (guint8 const*)&u32, sizeof(u32));
+			break;
+		case J_DB_TYPE_SINT64:
+			u64 = GUINT64_TO_BE((guint64)value->val_sint64 ^ G_GUINT64_CONSTANT(0x8000000000000000));
+			g_byte_array_append(key, (guint8 const*)&u64, sizeof(u64));
+			break;
+		case J_DB_TYPE_UINT64:
+			u64 = GUINT64_TO_BE(value->val_uint64);
+			g_byte_array_append(key, (guint8 const*)&u64, sizeof(u64));
+			break;
+		case J_DB_TYPE_FLOAT64:
+			f64 = (value->val_float64 == 0.0) ? 0.0 : value->val_float64;
+			memcpy(&u64, &f64, sizeof(u64));
+			u64 = (u64 & G_GUINT64_CONSTANT(0x8000000000000000)) ? ~u64 : (u64 | G_GUINT64_CONSTANT(0x8000000000000000));
+			u64 = GUINT64_TO_BE(u64);
+			g_byte_array_append(key, (guint8 const*)&u64, sizeof(u64));
+			break;
+		case J_DB_TYPE_STRING:
+			length = strlen(value->val_string);
+			g_byte_array_append(key, (guint8 const*)value->val_string, MIN(length, J_LMDB_INDEX_STRING_LENGTH));
+
+			if (terminate)
+			{
+				// truncated strings sort after all shorter strings with the same prefix
+				guint8 terminator = (length > J_LMDB_INDEX_STRING_LENGTH) ? 1 : 0;
+
+				g_byte_array_append(key, &terminator, 1);
+			}
+
+			break;
+		case J_DB_TYPE_BLOB:
+		case J_DB_TYPE_ID:
+		default:
+			g_assert_not_reached();
+	}
+}
+
+static void
+j_lmdb_index_key(GByteArray* key, JLMDBSchema const* schema, guint index, JLMDBRow const* row)
+{
+	GArray* fields = g_ptr_array_index(schema->indexes, index);
+	guint8 number = index;
+
+	g_byte_array_set_size(key, 0);
+	g_byte_array_append(key, schema->prefix->data, schema->prefix->len);
+	g_byte_array_append(key, &number, 1);
+
+	for (guint i = 0; i < fields->len; i++)
+	{
+		guint field = g_array_index(fields, guint, i);
+		JDBType type = j_lmdb_schema_type(schema, field);
+		JDBTypeValue value;
+
+		if (!j_lmdb_type_indexable(type))
+		{
+			break;
+		}
+
+		if (j_lmdb_row_value(row, field, &value))
+		{
+			j_lmdb_encode_value(key, type, &value, TRUE);
+		}
+		else
+		{
+			guint8 present = 0;
+
+			g_byte_array_append(key, &present, 1);
+		}
+	}
+
+	j_lmdb_key_append_id(key, row->id);
+}
+
+/**
+ * Computes all index keys of a row.
+ *
+ * The keys are copied, so they stay valid after the row's memory has been modified.
+ **/
+static void
+j_lmdb_index_keys(JLMDBSchema const* schema, JLMDBRow const* row, GPtrArray* keys)
+{
+	for (guint i = 0; i < schema->indexes->len; i++)
+	{
+		GByteArray* key = g_byte_array_new();
+
+		j_lmdb_index_key(key, schema, i, row);
+		g_ptr_array_add(keys, key);
+	}
+}
+
+static gboolean
+j_lmdb_put(JLMDBData* bd, JLMDBBatch* batch, MDB_dbi dbi, GByteArray const* key, gconstpointer data, gsize length, guint flags, GError** error)
+{
+	MDB_val m_key;
+	MDB_val m_value;
+	gint rc;
+
+	if (G_UNLIKELY(key->len > (guint)mdb_env_get_maxkeysize(bd->env)))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "key too long");
+		return FALSE;
+	}
+
+	m_key.mv_size = key->len;
+	m_key.mv_data = key->data;
+	m_value.mv_size = length;
+	m_value.mv_data = (gpointer)data;
+
+	if (G_UNLIKELY((rc = mdb_put(batch->txn, dbi, &m_key, &m_value, flags)) != 0))
+	{
+		j_lmdb_set_error(error, rc);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+j_lmdb_del(JLMDBBatch* batch, MDB_dbi dbi, GByteArray const* key, GError** error)
+{
+	MDB_val m_key;
+	gint rc;
+
+	m_key.mv_size = key->len;
+	m_key.mv_data = key->data;
+
+	if (G_UNLIKELY((rc = mdb_del(batch->txn, dbi, &m_key, NULL)) != 0 && rc != MDB_NOTFOUND))
+	{
+		j_lmdb_set_error(error, rc);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+j_lmdb_del_prefix(JLMDBBatch* batch, MDB_dbi dbi, GByteArray const* prefix, GError** error)
+{
+	MDB_cursor* cursor;
+	MDB_val key;
+	MDB_val value;
+	gint rc;
+
+	if (G_UNLIKELY((rc = mdb_cursor_open(batch->txn, dbi, &cursor)) != 0))
+	{
+		goto _error;
+	}
+
+	key.mv_size = prefix->len;
+	key.mv_data = prefix->data;
+
+	rc = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+
+	while (rc == 0)
+	{
+		if (key.mv_size < prefix->len || memcmp(key.mv_data, prefix->data, prefix->len) != 0)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY((rc = mdb_cursor_del(cursor, 0)) != 0))
+		{
+			break;
+		}
+
+		// the cursor already points to the following key, MDB_NEXT takes that into account
+		rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+	}
+
+	mdb_cursor_close(cursor);
+
+	if (G_UNLIKELY(rc != 0 && rc != MDB_NOTFOUND))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	j_lmdb_set_error(error, rc);
+
+	return FALSE;
+}
+
+/**
+ * Collects the IDs of all keys that start with prefix, beginning at start.
+ *
+ * If upper is given, the scan stops as soon as the bytes following the prefix are greater than upper.
+ * Row keys consist of the prefix and the ID, index keys end with the ID.
+ **/
+static gboolean
+j_lmdb_scan(JLMDBBatch* batch, MDB_dbi dbi, GByteArray const* prefix, GByteArray const* start, GByteArray const* upper, GArray* ids, GError** error)
+{
+	MDB_cursor* cursor;
+	MDB_val key;
+	MDB_val value;
+	gint rc;
+
+	if (G_UNLIKELY((rc = mdb_cursor_open(batch->txn, dbi, &cursor)) != 0))
+	{
+		goto _error;
+	}
+
+	key.mv_size = start->len;
+	key.mv_data = start->data;
+
+	rc = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+
+	while (rc == 0)
+	{
+		guint8 const* data = key.mv_data;
+		guint64 id;
+
+		if (key.mv_size < prefix->len + sizeof(id) || memcmp(data, prefix->data, prefix->len) != 0)
+		{
+			break;
+		}
+
+		if (upper != NULL && memcmp(data + prefix->len, upper->data, MIN(upper->len, key.mv_size - prefix->len)) > 0)
+		{
+			break;
+		}
+
+		id = j_lmdb_key_get_id(&key);
+		g_array_append_val(ids, id);
+
+		rc = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+	}
+
+	mdb_cursor_close(cursor);
+
+	if (G_UNLIKELY(rc != 0 && rc != MDB_NOTFOUND))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	j_lmdb_set_error(error, rc);
+
+	return FALSE;
+}
+
+static gboolean
+j_lmdb_next_id(JLMDBData* bd, JLMDBBatch* batch, JLMDBSchema* schema, guint64* id, GError** error)
+{
+	MDB_cursor* cursor;
+	MDB_val key;
+	MDB_val value;
+	gint rc;
+
+	// only one write transaction can exist at a time, so the ID can be cached for the rest of the batch
+	if (schema->next_id > 0)
+	{
+		*id = schema->next_id++;
+		return TRUE;
+	}
+
+	if (G_UNLIKELY((rc = mdb_cursor_open(batch->txn, bd->row_dbi, &cursor)) != 0))
+	{
+		goto _error;
+	}
+
+	j_lmdb_row_key(batch->key, schema, G_MAXUINT64);
+
+	key.mv_size = batch->key->len;
+	key.mv_data = batch->key->data;
+
+	// position the cursor on the last key that is smaller than the largest possible key of this schema
+	rc = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+
+	if (rc == 0)
+	{
+		rc = mdb_cursor_get(cursor, &key, &value, MDB_PREV);
+	}
+	else if (rc == MDB_NOTFOUND)
+	{
+		rc = mdb_cursor_get(cursor, &key, &value, MDB_LAST);
+	}
+
+	schema->next_id = 1;
+
+	if (rc == 0 && key.mv_size == schema->prefix->len + sizeof(guint64) && memcmp(key.mv_data, schema->prefix->data, schema->prefix->len) == 0)
+	{
+		schema->next_id = j_lmdb_key_get_id(&key) + 1;
+	}
+
+	mdb_cursor_close(cursor);
+
+	if (G_UNLIKELY(rc != 0 && rc != MDB_NOTFOUND))
+	{
+		schema->next_id = 0;
+		goto _error;
+	}
+
+	*id = schema->next_id++;
+
+	return TRUE;
+
+_error:
+	j_lmdb_set_error(error, rc);
+
+	return FALSE;
+}
+
+static gint
+j_lmdb_compare(JDBType type, JDBTypeValue const* a, JDBTypeValue const* b)
+{
+	gint ret;
+
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			return (a->val_sint32 > b->val_sint32) - (a->val_sint32 < b->val_sint32);
+		case J_DB_TYPE_UINT32:
+			return (a->val_uint32 > b->val_uint32) - (a->val_uint32 < b->val_uint32);
+		case J_DB_TYPE_FLOAT32:
+			return (a->val_float32 > b->val_float32) - (a->val_float32 < b->val_float32);
+		case J_DB_TYPE_SINT64:
+			return (a->val_sint64 > b->val_sint64) - (a->val_sint64 < b->val_sint64);
+		case J_DB_TYPE_UINT64:
+			return (a->val_uint64 > b->val_uint64) - (a->val_uint64 < b->val_uint64);
+		case J_DB_TYPE_FLOAT64:
+			return (a->val_float64 > b->val_float64) - (a->val_float64 < b->val_float64);
+		case J_DB_TYPE_STRING:
+			return strcmp(a->val_string, b->val_string);
+		case J_DB_TYPE_BLOB:
+			ret = 0;
+
+			if (MIN(a->val_blob_length, b->val_blob_length) > 0)
+			{
+				ret = memcmp(a->val_blob, b->val_blob, MIN(a->val_blob_length, b->val_blob_length));
+			}
+
+			if (ret == 0)
+			{
+				ret = (a->val_blob_length > b->val_blob_length) - (a->val_blob_length < b->val_blob_length);
+			}
+
+			return ret;
+		case J_DB_TYPE_ID:
+		default:
+			g_assert_not_reached();
+	}
+
+	return 0;
+}
+
+static gboolean
+j_lmdb_is_nan(JDBType type, JDBTypeValue const* value)
+{
+	return (type == J_DB_TYPE_FLOAT32 && isnan(value->val_float32)) || (type == J_DB_TYPE_FLOAT64 && isnan(value->val_float64));
+}
+
+static gboolean
+j_lmdb_to_double(JDBType type, JDBTypeValue const* value, gdouble* result)
+{
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			*result = value->val_sint32;
+			return TRUE;
+		case J_DB_TYPE_UINT32:
+			*result = value->val_uint32;
+			return TRUE;
+		case J_DB_TYPE_FLOAT32:
+			*result = value->val_float32;
+			return TRUE;
+		case J_DB_TYPE_SINT64:
+			*result = value->val_sint64;
+			return TRUE;
+		case J_DB_TYPE_UINT64:
+			*result = value->val_uint64;
+			return TRUE;
+		case J_DB_TYPE_FLOAT64:
+			*result = value->val_float64;
+			return TRUE;
+		case J_DB_TYPE_STRING:
+		case J_DB_TYPE_BLOB:
+		case J_DB_TYPE_ID:
+		default:
+			return FALSE;
+	}
+}
+
+static gboolean
+j_lmdb_type_integer(JDBType type)
+{
+	return (type == J_DB_TYPE_SINT32 || type == J_DB_TYPE_UINT32 || type == J_DB_TYPE_SINT64 || type == J_DB_TYPE_UINT64);
+}
+
+static gboolean
+j_lmdb_to_id(JDBType type, JDBTypeValue const* value, guint64* id)
+{
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			*id = value->val_sint32;
+			return (value->val_sint32 >= 0);
+		case J_DB_TYPE_UINT32:
+			*id = value->val_uint32;
+			return TRUE;
+		case J_DB_TYPE_SINT64:
+			*id = value->val_sint64;
+			return (value->val_sint64 >= 0);
+		case J_DB_TYPE_UINT64:
+			*id = value->val_uint64;
+			return TRUE;
+		case J_DB_TYPE_FLOAT32:
+		case J_DB_TYPE_FLOAT64:
+		case J_DB_TYPE_STRING:
+		case J_DB_TYPE_BLOB:
+		case J_DB_TYPE_ID:
+		default:
+			return FALSE;
+	}
+}
+
+static JLMDBPredicate*
+j_lmdb_predicate_new_group(JDBSelectorMode mode)
+{
+	JLMDBPredicate* predicate;
+
+	predicate = g_new0(JLMDBPredicate, 1);
+	predicate->group = TRUE;
+	predicate->mode = mode;
+	predicate->children = g_ptr_array_new_with_free_func(g_free);
+
+	return predicate;
+}
+
+static void
+j_lmdb_predicate_free(gpointer data)
+{
+	JLMDBPredicate* predicate = data;
+
+	if (predicate->children != NULL)
+	{
+		g_ptr_array_unref(predicate->children);
+	}
+
+	g_free(predicate);
+}
+
+static gboolean
+j_lmdb_predicate_match(JLMDBPredicate const* predicate, JLMDBRow const* rows)
+{
+	JDBTypeValue value;
+	gint c;
+
+	if (predicate->group)
+	{
+		for (guint i = 0; i < predicate->children->len; i++)
+		{
+			gboolean match = j_lmdb_predicate_match(g_ptr_array_index(predicate->children, i), rows);
+
+			if (predicate->mode == J_DB_SELECTOR_MODE_AND && !match)
+			{
+				return FALSE;
+			}
+
+			if (predicate->mode == J_DB_SELECTOR_MODE_OR && match)
+			{
+				return TRUE;
+			}
+		}
+
+		// an empty group does not restrict anything
+		return (predicate->mode == J_DB_SELECTOR_MODE_AND || predicate->children->len == 0);
+	}
+
+	// like in SQL, NULL does not match any predicate
+	if (!j_lmdb_row_value(&rows[predicate->table], predicate->field, &value))
+	{
+		return FALSE;
+	}
+
+	if (j_lmdb_is_nan(predicate->type, &value) || j_lmdb_is_nan(predicate->type, &(predicate->value)))
+	{
+		return FALSE;
+	}
+
+	c = j_lmdb_compare(predicate->type, &value, &(predicate->value));
+
+	switch (predicate->op)
+	{
+		case J_DB_SELECTOR_OPERATOR_LT:
+			return (c < 0);
+		case J_DB_SELECTOR_OPERATOR_LE:
+			return (c <= 0);
+		case J_DB_SELECTOR_OPERATOR_GT:
+			return (c > 0);
+		case J_DB_SELECTOR_OPERATOR_GE:
+			return (c >= 0);
+		case J_DB_SELECTOR_OPERATOR_EQ:
+			return (c == 0);
+		case J_DB_SELECTOR_OPERATOR_NE:
+			return (c != 0);
+		default:
+			g_assert_not_reached();
+	}
+
+	return FALSE;
+}
+
+static guint
+j_lmdb_predicate_count(JLMDBPredicate const* predicate)
+{
+	guint count = 0;
+
+	if (!predicate->group)
+	{
+		return 1;
+	}
+
+	for (guint i = 0; i < predicate->children->len; i++)
+	{
+		count += j_lmdb_predicate_count(g_ptr_array_index(predicate->children, i));
+	}
+
+	return count;
+}
+
+static gboolean
+j_lmdb_predicate_is_range(JLMDBPredicate const* predicate)
+{
+	if (predicate->group || predicate->type == J_DB_TYPE_STRING || predicate->type == J_DB_TYPE_BLOB)
+	{
+		return FALSE;
+	}
+
+	if (j_lmdb_is_nan(predicate->type, &(predicate->value)))
+	{
+		return FALSE;
+	}
+
+	return (predicate->op == J_DB_SELECTOR_OPERATOR_LT || predicate->op == J_DB_SELECTOR_OPERATOR_LE || predicate->op == J_DB_SELECTOR_OPERATOR_GT || predicate->op == J_DB_SELECTOR_OPERATOR_GE);
+}
+
+static gboolean
+j_lmdb_operator_is_lower(JDBSelectorOperator op)
+{
+	return (op == J_DB_SELECTOR_OPERATOR_GT || op == J_DB_SELECTOR_OPERATOR_GE);
+}
+
+static void
+j_lmdb_query_free(JLMDBQuery* query)
+{
+	if (query == NULL)
+	{
+		return;
+	}
+
+	if (query->root != NULL)
+	{
+		j_lmdb_predicate_free(query->root);
+	}
+
+	g_ptr_array_unref(query->tables);
+	g_ptr_array_unref(query->joins);
+	g_ptr_array_unref(query->accesses);
+	g_free(query);
+}
+
+static guint
+j_lmdb_query_table(JLMDBQuery const* query, gchar const* name)
+{
+	for (guint i = 0; i < query->tables->len; i++)
+	{
+		JLMDBSchema const* schema = g_ptr_array_index(query->tables, i);
+
+		if (g_str_equal(schema->name, name))
+		{
+			return i;
+		}
+	}
+
+	return G_MAXUINT;
+}
+
+/**
+ * Looks up the value bound to a parameter of a prepared selector.
+ *
+ * The values are stored in an array in parameter order.
+ **/
+static gboolean
+j_lmdb_query_parameter(JLMDBQuery* query, bson_iter_t* iter, JDBType type, JDBTypeValue* value, GError** error)
+{
+	JDBTypeValue index;
+	bson_iter_t iter_parameters;
+	bson_iter_t iter_value;
+	gchar key[16];
+
+	if (G_UNLIKELY(!j_bson_iter_value(iter, J_DB_TYPE_UINT32, &index, error)))
+	{
+		goto _error;
+	}
+
+	g_snprintf(key, sizeof(key), "%u", index.val_uint32);
+
+	if (G_UNLIKELY(query->selector == NULL || !bson_iter_init_find(&iter_parameters, query->selector, "p") || !bson_iter_recurse(&iter_parameters, &iter_value) || !bson_iter_find(&iter_value, key)))
+	{
+		g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_NO_VARIABLE_SET, "parameter %u not bound", index.val_uint32);
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_value(&iter_value, type, value, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+static gboolean
+j_lmdb_query_parse(JLMDBQuery* query, bson_iter_t* iter, JLMDBPredicate* group, GError** error)
+{
+	JDBTypeValue value;
+
+	while (TRUE)
+	{
+		bson_iter_t iter_child;
+		gboolean has_next;
+		gchar const* key;
+
+		if (G_UNLIKELY(!j_bson_iter_next(iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY((key = j_bson_iter_key(iter, error)) == NULL))
+		{
+			goto _error;
+		}
+
+		if (g_str_equal(key, "m"))
+		{
+			if (G_UNLIKELY(!j_bson_iter_value(iter, J_DB_TYPE_UINT32, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(value.val_uint32 != J_DB_SELECTOR_MODE_AND && value.val_uint32 != J_DB_SELECTOR_MODE_OR))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_OPERATOR_INVALID, "operator invalid");
+				goto _error;
+			}
+
+			group->mode = value.val_uint32;
+		}
+		else if (g_str_equal(key, "_s"))
+		{
+			JLMDBPredicate* child;
+
+			child = j_lmdb_predicate_new_group(J_DB_SELECTOR_MODE_AND);
+			g_ptr_array_add(group->children, child);
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_lmdb_query_parse(query, &iter_child, child, error)))
+			{
+				goto _error;
+			}
+		}
+		else
+		{
+			JLMDBPredicate* leaf;
+			JLMDBSchema const* schema;
+
+			leaf = g_new0(JLMDBPredicate, 1);
+			g_ptr_array_add(group->children, leaf);
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "t", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY((leaf->table = j_lmdb_query_table(query, value.val_string)) == G_MAXUINT))
+			{
+				g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND, "schema %s is not part of the query", value.val_string);
+				goto _error;
+			}
+
+			schema = g_ptr_array_index(query->tables, leaf->table);
+
+			if (G_UNLIKELY(!j_lmdb_schema_field(schema, key, &(leaf->field), &(leaf->type), error)))
+			{
+				goto _error;
+			}
+
+			// do not rely on the order of the keys
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "o", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_UINT32, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(value.val_uint32 > J_DB_SELECTOR_OPERATOR_NE))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_COMPARATOR_INVALID, "comparator invalid");
+				goto _error;
+			}
+
+			leaf->op = value.val_uint32;
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			// prepared selectors refer to a parameter instead of containing the value
+			if (bson_iter_find(&iter_child, "p"))
+			{
+				if (G_UNLIKELY(!j_lmdb_query_parameter(query, &iter_child, leaf->type, &(leaf->value), error)))
+				{
+					goto _error;
+				}
+
+				continue;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "v", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_child, leaf->type, &(leaf->value), error)))
+			{
+				goto _error;
+			}
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Keeps only the tightest lower and upper bound per numeric field of a conjunction.
+ **/
+static void
+j_lmdb_query_merge_ranges(JLMDBQuery* query, JLMDBPredicate* group)
+{
+	for (guint i = 0; i < group->children->len; i++)
+	{
+		JLMDBPredicate* child = g_ptr_array_index(group->children, i);
+
+		if (child->group)
+		{
+			j_lmdb_query_merge_ranges(query, child);
+		}
+	}
+
+	if (group->mode != J_DB_SELECTOR_MODE_AND)
+	{
+		return;
+	}
+
+	for (guint i = 0; i < group->children->len; i++)
+	{
+		JLMDBPredicate* a = g_ptr_array_index(group->children, i);
+		gboolean lower;
+
+		if (!j_lmdb_predicate_is_range(a))
+		{
+			continue;
+		}
+
+		lower = j_lmdb_operator_is_lower(a->op);
+
+		for (guint j = i + 1; j < group->children->len;)
+		{
+			JLMDBPredicate* b = g_ptr_array_index(group->children, j);
+			gint c;
+
+			if (!j_lmdb_predicate_is_range(b) || b->table != a->table || b->field != a->field || j_lmdb_operator_is_lower(b->op) != lower)
+			{
+				j++;
+				continue;
+			}
+
+			c = j_lmdb_compare(a->type, &(b->value), &(a->value));
+
+			if ((lower && (c > 0 || (c == 0 && b->op == J_DB_SELECTOR_OPERATOR_GT))) || (!lower && (c < 0 || (c == 0 && b->op == J_DB_SELECTOR_OPERATOR_LT))))
+			{
+				a->op = b->op;
+				a->value = b->value;
+			}
+
+			g_ptr_array_remove_index(group->children, j);
+			query->merged++;
+		}
+	}
+}
+
+/**
+ * Returns a predicate of the top-level conjunction that restricts the given field.
+ **/
+static JLMDBPredicate*
+j_lmdb_query_find(JLMDBQuery const* query, guint table, guint field, JDBSelectorOperator op1, JDBSelectorOperator op2)
+{
+	if (query->root == NULL || query->root->mode != J_DB_SELECTOR_MODE_AND)
+	{
+		return NULL;
+	}
+
+	for (guint i = 0; i < query->root->children->len; i++)
+	{
+		JLMDBPredicate* predicate = g_ptr_array_index(query->root->children, i);
+
+		if (!predicate->group && predicate->table == table && predicate->field == field && (predicate->op == op1 || predicate->op == op2))
+		{
+			return predicate;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+j_lmdb_access_free(gpointer data)
+{
+	JLMDBAccess* access = data;
+
+	g_ptr_array_unref(access->eq);
+	g_free(access);
+}
+
+static void
+j_lmdb_access_reset(JLMDBAccess* access, JLMDBAccessType type)
+{
+	g_ptr_array_set_size(access->eq, 0);
+	access->type = type;
+	access->index = 0;
+	access->lower = NULL;
+	access->upper = NULL;
+	access->join = NULL;
+	access->join_side = 0;
+	access->score = 0;
+}
+
+/**
+ * Chooses how to access a table based on its own predicates.
+ *
+ * Equality on _id wins, otherwise the index with the longest equality prefix (and a range on the following field) is used.
+ **/
+static JLMDBAccess*
+j_lmdb_access_new(JLMDBQuery const* query, guint table)
+{
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, table);
+	JLMDBAccess* access;
+	JLMDBPredicate* predicate;
+
+	access = g_new0(JLMDBAccess, 1);
+	access->type = J_LMDB_ACCESS_SCAN;
+	access->table = table;
+	access->eq = g_ptr_array_new();
+
+	if ((predicate = j_lmdb_query_find(query, table, J_LMDB_FIELD_ID, J_DB_SELECTOR_OPERATOR_EQ, J_DB_SELECTOR_OPERATOR_EQ)) != NULL)
+	{
+		access->type = J_LMDB_ACCESS_PRIMARY;
+		access->score = G_MAXUINT;
+		g_ptr_array_add(access->eq, predicate);
+
+		return access;
+	}
+
+	for (guint i = 0; i < schema->indexes->len; i++)
+	{
+		GArray* fields = g_ptr_array_index(schema->indexes, i);
+		g_autoptr(GPtrArray) eq = g_ptr_array_new();
+		JLMDBPredicate* lower = NULL;
+		JLMDBPredicate* upper = NULL;
+		guint score;
+
+		for (guint j = 0; j < fields->len; j++)
+		{
+			guint field = g_array_index(fields, guint, j);
+
+			if (!j_lmdb_type_indexable(j_lmdb_schema_type(schema, field)))
+			{
+				break;
+			}
+
+			if ((predicate = j_lmdb_query_find(query, table, field, J_DB_SELECTOR_OPERATOR_EQ, J_DB_SELECTOR_OPERATOR_EQ)) == NULL)
+			{
+				lower = j_lmdb_query_find(query, table, field, J_DB_SELECTOR_OPERATOR_GT, J_DB_SELECTOR_OPERATOR_GE);
+				upper = j_lmdb_query_find(query, table, field, J_DB_SELECTOR_OPERATOR_LT, J_DB_SELECTOR_OPERATOR_LE);
+				break;
+			}
+
+			g_ptr_array_add(eq, predicate);
+		}
+
+		score = 2 * eq->len + ((lower != NULL || upper != NULL) ? 1 : 0);
+
+		if (score > access->score)
+		{
+			g_ptr_array_unref(access->eq);
+
+			access->type = J_LMDB_ACCESS_INDEX;
+			access->index = i;
+			access->eq = g_steal_pointer(&eq);
+			access->lower = lower;
+			access->upper = upper;
+			access->score = score;
+		}
+	}
+
+	if (access->score == 0)
+	{
+		access->lower = j_lmdb_query_find(query, table, J_LMDB_FIELD_ID, J_DB_SELECTOR_OPERATOR_GT, J_DB_SELECTOR_OPERATOR_GE);
+		access->upper = j_lmdb_query_find(query, table, J_LMDB_FIELD_ID, J_DB_SELECTOR_OPERATOR_LT, J_DB_SELECTOR_OPERATOR_LE);
+
+		if (access->lower != NULL || access->upper != NULL)
+		{
+			access->type = J_LMDB_ACCESS_PRIMARY;
+			access->score = 1;
+		}
+	}
+
+	return access;
+}
+
+/**
+ * Switches an access to a lookup using a join with an already placed table if possible.
+ *
+ * \return TRUE if the table is connected to a placed table, FALSE otherwise.
+ **/
+static gboolean
+j_lmdb_access_join(JLMDBQuery const* query, JLMDBAccess* access, gboolean const* placed)
+{
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, access->table);
+	gboolean connected = FALSE;
+
+	for (guint i = 0; i < query->joins->len; i++)
+	{
+		JLMDBJoin* join = g_ptr_array_index(query->joins, i);
+
+		for (guint side = 0; side < 2; side++)
+		{
+			guint other = 1 - side;
+			JDBType type;
+			JDBType other_type;
+
+			if (join->table[side] != access->table || !placed[join->table[other]])
+			{
+				continue;
+			}
+
+			connected = TRUE;
+
+			// a lookup by _id can not be improved upon
+			if (access->type == J_LMDB_ACCESS_PRIMARY && (access->eq->len > 0 || access->join != NULL))
+			{
+				return TRUE;
+			}
+
+			type = j_lmdb_schema_type(schema, join->field[side]);
+			other_type = j_lmdb_schema_type(g_ptr_array_index(query->tables, join->table[other]), join->field[other]);
+
+			if (join->field[side] == J_LMDB_FIELD_ID)
+			{
+				if (j_lmdb_type_integer(other_type))
+				{
+					j_lmdb_access_reset(access, J_LMDB_ACCESS_PRIMARY);
+					access->join = join;
+					access->join_side = side;
+				}
+
+				continue;
+			}
+
+			if (access->join != NULL || type != other_type || !j_lmdb_type_indexable(type))
+			{
+				continue;
+			}
+
+			for (guint j = 0; j < schema->indexes->len; j++)
+			{
+				GArray* fields = g_ptr_array_index(schema->indexes, j);
+
+				if (fields->len > 0 && g_array_index(fields, guint, 0) == join->field[side])
+				{
+					j_lmdb_access_reset(access, J_LMDB_ACCESS_INDEX);
+					access->index = j;
+					access->join = join;
+					access->join_side = side;
+					break;
+				}
+			}
+		}
+	}
+
+	return connected;
+}
+
+/**
+ * Determines the join order greedily.
+ *
+ * The first table is the one with the most selective access, afterwards tables that can be looked up using a join are preferred.
+ **/
+static void
+j_lmdb_query_plan(JLMDBQuery* query)
+{
+	g_autofree gboolean* placed = g_new0(gboolean, query->tables->len);
+
+	for (guint level = 0; level < query->tables->len; level++)
+	{
+		JLMDBAccess* best = NULL;
+		guint best_rank = 0;
+
+		for (guint table = 0; table < query->tables->len; table++)
+		{
+			JLMDBAccess* access;
+			guint rank;
+
+			if (placed[table])
+			{
+				continue;
+			}
+
+			access = j_lmdb_access_new(query, table);
+			rank = (j_lmdb_access_join(query, access, placed)) ? 2 : 0;
+			rank += (access->join != NULL) ? 1 : 0;
+
+			if (best == NULL || rank > best_rank || (rank == best_rank && access->score > best->score))
+			{
+				if (best != NULL)
+				{
+					j_lmdb_access_free(best);
+				}
+
+				best = access;
+				best_rank = rank;
+			}
+			else
+			{
+				j_lmdb_access_free(access);
+			}
+		}
+
+		placed[best->table] = TRUE;
+		g_ptr_array_add(query->accesses, best);
+	}
+}
+
+static JLMDBQuery*
+j_lmdb_query_new(JLMDBData* bd, JLMDBBatch* batch, gchar const* name, bson_t const* selector, GError** error)
+{
+	JLMDBQuery* query;
+	JLMDBSchema* schema;
+	JDBTypeValue value;
+	bson_iter_t iter;
+	bson_iter_t iter_child;
+	gboolean has_next;
+
+	query = g_new0(JLMDBQuery, 1);
+	query->namespace = batch->namespace;
+	query->selector = selector;
+	query->tables = g_ptr_array_new();
+	query->joins = g_ptr_array_new_with_free_func(g_free);
+	query->accesses = g_ptr_array_new_with_free_func(j_lmdb_access_free);
+
+	// contains joins?
+	if (selector != NULL && bson_has_field(selector, "t"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "t", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_array(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		while (TRUE)
+		{
+			if (G_UNLIKELY(!j_bson_iter_next(&iter_child, &has_next, error)))
+			{
+				goto _error;
+			}
+
+			if (!has_next)
+			{
+				break;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY((schema = j_lmdb_schema_get(bd, batch, value.val_string, error)) == NULL))
+			{
+				goto _error;
+			}
+
+			g_ptr_array_add(query->tables, schema);
+		}
+	}
+	else
+	{
+		if (G_UNLIKELY((schema = j_lmdb_schema_get(bd, batch, name, error)) == NULL))
+		{
+			goto _error;
+		}
+
+		g_ptr_array_add(query->tables, schema);
+	}
+
+	if (selector != NULL && bson_has_field(selector, "j"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "j", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		while (TRUE)
+		{
+			bson_iter_t iter_join;
+			JLMDBJoin* join;
+
+			if (G_UNLIKELY(!j_bson_iter_next(&iter_child, &has_next, error)))
+			{
+				goto _error;
+			}
+
+			if (!has_next)
+			{
+				break;
+			}
+
+			join = g_new0(JLMDBJoin, 1);
+			g_ptr_array_add(query->joins, join);
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter_child, &iter_join, error)))
+			{
+				goto _error;
+			}
+
+			// every join consists of exactly two entries of the form table: field
+			for (guint side = 0; side < 2; side++)
+			{
+				gchar const* table;
+				JDBType type;
+
+				if (G_UNLIKELY(!j_bson_iter_next(&iter_join, &has_next, error)))
+				{
+					goto _error;
+				}
+
+				if (G_UNLIKELY(!has_next))
+				{
+					g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "join invalid");
+					goto _error;
+				}
+
+				if (G_UNLIKELY((table = j_bson_iter_key(&iter_join, error)) == NULL))
+				{
+					goto _error;
+				}
+
+				if (G_UNLIKELY((join->table[side] = j_lmdb_query_table(query, table)) == G_MAXUINT))
+				{
+					g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND, "schema %s is not part of the query", table);
+					goto _error;
+				}
+
+				if (G_UNLIKELY(!j_bson_iter_value(&iter_join, J_DB_TYPE_STRING, &value, error)))
+				{
+					goto _error;
+				}
+
+				if (G_UNLIKELY(!j_lmdb_schema_field(g_ptr_array_index(query->tables, join->table[side]), value.val_string, &(join->field[side]), &type, error)))
+				{
+					goto _error;
+				}
+			}
+		}
+	}
+
+	if (selector != NULL && bson_has_field(selector, "s"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "s", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		query->root = j_lmdb_predicate_new_group(J_DB_SELECTOR_MODE_AND);
+		// the children are freed recursively
+		g_ptr_array_set_free_func(query->root->children, j_lmdb_predicate_free);
+
+		if (G_UNLIKELY(!j_lmdb_query_parse(query, &iter_child, query->root, error)))
+		{
+			goto _error;
+		}
+
+		j_lmdb_query_merge_ranges(query, query->root);
+
+		query->prefiltered = (query->root->mode == J_DB_SELECTOR_MODE_AND);
+
+		for (guint i = 0; i < query->root->children->len; i++)
+		{
+			if (((JLMDBPredicate*)g_ptr_array_index(query->root->children, i))->group)
+			{
+				query->prefiltered = FALSE;
+			}
+		}
+	}
+
+	j_lmdb_query_plan(query);
+
+	return query;
+
+_error:
+	j_lmdb_query_free(query);
+
+	return NULL;
+}
+
+static gboolean
+j_lmdb_join_value(JLMDBQuery const* query, JLMDBAccess const* access, JLMDBRow const* rows, JDBType* type, JDBTypeValue* value)
+{
+	guint other = 1 - access->join_side;
+	guint table = access->join->table[other];
+	guint field = access->join->field[other];
+
+	*type = j_lmdb_schema_type(g_ptr_array_index(query->tables, table), field);
+
+	return j_lmdb_row_value(&rows[table], field, value);
+}
+
+static gboolean
+j_lmdb_join_match(JLMDBQuery const* query, JLMDBJoin const* join, JLMDBRow const* rows)
+{
+	JDBType type[2];
+	JDBTypeValue value[2];
+	gdouble number[2];
+
+	for (guint side = 0; side < 2; side++)
+	{
+		type[side] = j_lmdb_schema_type(g_ptr_array_index(query->tables, join->table[side]), join->field[side]);
+
+		if (!j_lmdb_row_value(&rows[join->table[side]], join->field[side], &value[side]) || j_lmdb_is_nan(type[side], &value[side]))
+		{
+			return FALSE;
+		}
+	}
+
+	if (type[0] == type[1])
+	{
+		return (j_lmdb_compare(type[0], &value[0], &value[1]) == 0);
+	}
+
+	if (j_lmdb_to_double(type[0], &value[0], &number[0]) && j_lmdb_to_double(type[1], &value[1], &number[1]))
+	{
+		return (number[0] == number[1]);
+	}
+
+	return FALSE;
+}
+
+/**
+ * Collects the candidate IDs of an access, the rows still have to be checked against all predicates.
+ **/
+static gboolean
+j_lmdb_access_collect(JLMDBData* bd, JLMDBBatch* batch, JLMDBQuery const* query, JLMDBAccess const* access, JLMDBRow const* rows, GArray* ids, GError** error)
+{
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, access->table);
+	g_autoptr(GByteArray) prefix = g_byte_array_new();
+	g_autoptr(GByteArray) start = NULL;
+	g_autoptr(GByteArray) upper = NULL;
+	MDB_dbi dbi = bd->row_dbi;
+	JDBTypeValue value;
+	JDBType type;
+	guint8 number;
+	guint64 id;
+
+	g_byte_array_append(prefix, schema->prefix->data, schema->prefix->len);
+
+	switch (access->type)
+	{
+		case J_LMDB_ACCESS_SCAN:
+			break;
+		case J_LMDB_ACCESS_PRIMARY:
+			if (access->join != NULL)
+			{
+				// NULL and negative values can not match any row
+				if (j_lmdb_join_value(query, access, rows, &type, &value) && j_lmdb_to_id(type, &value, &id))
+				{
+					g_array_append_val(ids, id);
+				}
+
+				return TRUE;
+			}
+
+			if (access->eq->len > 0)
+			{
+				id = ((JLMDBPredicate*)g_ptr_array_index(access->eq, 0))->value.val_uint64;
+				g_array_append_val(ids, id);
+
+				return TRUE;
+			}
+
+			start = g_byte_array_new();
+			g_byte_array_append(start, prefix->data, prefix->len);
+
+			if (access->lower != NULL)
+			{
+				j_lmdb_key_append_id(start, access->lower->value.val_uint64);
+			}
+
+			if (access->upper != NULL)
+			{
+				upper = g_byte_array_new();
+				j_lmdb_key_append_id(upper, access->upper->value.val_uint64);
+			}
+
+			break;
+		case J_LMDB_ACCESS_INDEX:
+			dbi = bd->index_dbi;
+			number = access->index;
+			g_byte_array_append(prefix, &number, 1);
+
+			if (access->join != NULL)
+			{
+				if (!j_lmdb_join_value(query, access, rows, &type, &value) || j_lmdb_is_nan(type, &value))
+				{
+					return TRUE;
+				}
+
+				j_lmdb_encode_value(prefix, type, &value, TRUE);
+			}
+
+			for (guint i = 0; i < access->eq->len; i++)
+			{
+				JLMDBPredicate const* predicate = g_ptr_array_index(access->eq, i);
+
+				j_lmdb_encode_value(prefix, predicate->type, &(predicate->value), TRUE);
+			}
+
+			start = g_byte_array_new();
+			g_byte_array_append(start, prefix->data, prefix->len);
+
+			if (access->lower != NULL)
+			{
+				j_lmdb_encode_value(start, access->lower->type, &(access->lower->value), FALSE);
+			}
+
+			if (access->upper != NULL)
+			{
+				upper = g_byte_array_new();
+				j_lmdb_encode_value(upper, access->upper->type, &(access->upper->value), FALSE);
+			}
+
+			break;
+		default:
+			g_assert_not_reached();
+	}
+
+	return j_lmdb_scan(batch, dbi, prefix, (start != NULL) ? start : prefix, upper, ids, error);
+}
+
+static gboolean
+j_lmdb_query_level(JLMDBData* bd, JLMDBBatch* batch, JLMDBQuery const* query, guint level, JLMDBRow* rows, gboolean* placed, GArray* results, GError** error)
+{
+	JLMDBAccess const* access = g_ptr_array_index(query->accesses, level);
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, access->table);
+	JLMDBRow* row = &rows[access->table];
+	g_autoptr(GArray) ids = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+	if (G_UNLIKELY(!j_lmdb_access_collect(bd, batch, query, access, rows, ids, error)))
+	{
+		goto _error;
+	}
+
+	placed[access->table] = TRUE;
+
+	for (guint i = 0; i < ids->len; i++)
+	{
+		gboolean found;
+		gboolean match = TRUE;
+
+		if (G_UNLIKELY(!j_lmdb_row_load(bd, batch, schema, g_array_index(ids, guint64, i), row, &found, error)))
+		{
+			goto _error;
+		}
+
+		if (!found)
+		{
+			continue;
+		}
+
+		for (guint j = 0; j < query->joins->len && match; j++)
+		{
+			JLMDBJoin const* join = g_ptr_array_index(query->joins, j);
+
+			if ((join->table[0] == access->table && placed[join->table[1]]) || (join->table[1] == access->table && placed[join->table[0]]))
+			{
+				match = j_lmdb_join_match(query, join, rows);
+			}
+		}
+
+		// check the predicates of this table as early as possible
+		if (query->root != NULL && query->root->mode == J_DB_SELECTOR_MODE_AND)
+		{
+			for (guint j = 0; j < query->root->children->len && match; j++)
+			{
+				JLMDBPredicate const* predicate = g_ptr_array_index(query->root->children, j);
+
+				if (!predicate->group && predicate->table == access->table)
+				{
+					match = j_lmdb_predicate_match(predicate, rows);
+				}
+			}
+		}
+
+		if (!match)
+		{
+			continue;
+		}
+
+		if (level + 1 < query->accesses->len)
+		{
+			if (G_UNLIKELY(!j_lmdb_query_level(bd, batch, query, level + 1, rows, placed, results, error)))
+			{
+				goto _error;
+			}
+		}
+		else if (query->root == NULL || query->prefiltered || j_lmdb_predicate_match(query->root, rows))
+		{
+			for (guint j = 0; j < query->tables->len; j++)
+			{
+				g_array_append_val(results, rows[j].id);
+			}
+		}
+	}
+
+	placed[access->table] = FALSE;
+
+	return TRUE;
+
+_error:
+	placed[access->table] = FALSE;
+
+	return FALSE;
+}
+
+/**
+ * Executes a query, results contains one ID per table for every matching combination of rows.
+ **/
+static gboolean
+j_lmdb_query_execute(JLMDBData* bd, JLMDBBatch* batch, JLMDBQuery const* query, GArray* results, GError** error)
+{
+	gboolean ret;
+	JLMDBRow* rows;
+	g_autofree gboolean* placed = NULL;
+
+	rows = g_new0(JLMDBRow, query->tables->len);
+	placed = g_new0(gboolean, query->tables->len);
+
+	for (guint i = 0; i < query->tables->len; i++)
+	{
+		j_lmdb_row_init(&rows[i], g_ptr_array_index(query->tables, i));
+	}
+
+	ret = j_lmdb_query_level(bd, batch, query, 0, rows, placed, results, error);
+
+	for (guint i = 0; i < query->tables->len; i++)
+	{
+		j_lmdb_row_clear(&rows[i]);
+	}
+
+	g_free(rows);
+
+	return ret;
+}
+
+static gchar*
+j_lmdb_query_explain(JLMDBQuery const* query)
+{
+	GString* report = g_string_new(NULL);
+	g_autofree gboolean* placed = g_new0(gboolean, query->tables->len);
+
+	for (guint level = 0; level < query->accesses->len; level++)
+	{
+		JLMDBAccess const* access = g_ptr_array_index(query->accesses, level);
+		JLMDBSchema const* schema = g_ptr_array_index(query->tables, access->table);
+
+		switch (access->type)
+		{
+			case J_LMDB_ACCESS_SCAN:
+				g_string_append_printf(report, "SCAN %s_%s\n", query->namespace, schema->name);
+				break;
+			case J_LMDB_ACCESS_PRIMARY:
+				g_string_append_printf(report, "SEARCH %s_%s USING PRIMARY KEY (%s)\n", query->namespace, schema->name, (access->join != NULL || access->eq->len > 0) ? "_id=?" : "_id range");
+				break;
+			case J_LMDB_ACCESS_INDEX:
+			{
+				GArray* fields = g_ptr_array_index(schema->indexes, access->index);
+				guint count = access->eq->len + ((access->join != NULL) ? 1 : 0);
+
+				g_string_append_printf(report, "SEARCH %s_%s USING INDEX %s_%s_%u (", query->namespace, schema->name, query->namespace, schema->name, access->index);
+
+				for (guint i = 0; i < count; i++)
+				{
+					g_string_append_printf(report, "%s%s=?", (i > 0) ? " AND " : "", j_lmdb_schema_field_name(schema, g_array_index(fields, guint, i)));
+				}
+
+				if (access->lower != NULL || access->upper != NULL)
+				{
+					g_string_append_printf(report, "%s%s range", (count > 0) ? " AND " : "", j_lmdb_schema_field_name(schema, g_array_index(fields, guint, count)));
+				}
+
+				g_string_append(report, ")\n");
+			}
+			break;
+			default:
+				g_assert_not_reached();
+		}
+
+		placed[access->table] = TRUE;
+
+		for (guint i = 0; i < query->joins->len; i++)
+		{
+			JLMDBJoin const* join = g_ptr_array_index(query->joins, i);
+			JLMDBSchema const* first = g_ptr_array_index(query->tables, join->table[0]);
+			JLMDBSchema const* second = g_ptr_array_index(query->tables, join->table[1]);
+
+			// report every join once, when its second table has been placed
+			if ((join->table[0] == access->table && placed[join->table[1]]) || (join->table[1] == access->table && placed[join->table[0]]))
+			{
+				g_string_append_printf(report, "JOIN %s_%s.%s = %s_%s.%s\n", query->namespace, first->name, j_lmdb_schema_field_name(first, join->field[0]), query->namespace, second->name, j_lmdb_schema_field_name(second, join->field[1]));
+			}
+		}
+	}
+
+	if (query->root != NULL)
+	{
+		g_string_append_printf(report, "FILTER %u predicate(s)\n", j_lmdb_predicate_count(query->root));
+	}
+
+	if (query->merged > 0)
+	{
+		g_string_append_printf(report, "NORMALIZE %u range predicate(s) merged\n", query->merged);
+	}
+
+	return g_string_free(report, FALSE);
+}
+
+static gboolean
+j_lmdb_aggregate_parse(JLMDBQuery const* query, bson_t const* selector, JLMDBAggregate* aggregate, GError** error)
+{
+	JLMDBSchema const* schema;
+	JDBTypeValue value;
+	bson_iter_t iter;
+	bson_iter_t iter_child;
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_find(&iter, "a", error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "f", error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_UINT32, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(value.val_uint32 > J_DB_AGGREGATE_AVG))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_OPERATOR_INVALID, "operator invalid");
+		goto _error;
+	}
+
+	aggregate->function = value.val_uint32;
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "t", error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((aggregate->table = j_lmdb_query_table(query, value.val_string)) == G_MAXUINT))
+	{
+		g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND, "schema %s is not part of the query", value.val_string);
+		goto _error;
+	}
+
+	schema = g_ptr_array_index(query->tables, aggregate->table);
+	aggregate->field = J_LMDB_FIELD_COUNT;
+	aggregate->type = J_DB_TYPE_UINT64;
+	aggregate->grouped = FALSE;
+	aggregate->group_type = J_DB_TYPE_UINT64;
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
+
+	if (bson_iter_find(&iter_child, "n"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_lmdb_schema_field(schema, value.val_string, &(aggregate->field), &(aggregate->type), error)))
+		{
+			goto _error;
+		}
+	}
+
+	if (G_UNLIKELY(!j_bson_aggregate_type(aggregate->function, aggregate->type, &(aggregate->result_type))))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_DB_TYPE_INVALID, "db type invalid");
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
+
+	if (bson_iter_find(&iter_child, "g"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_lmdb_schema_field(schema, value.val_string, &(aggregate->group), &(aggregate->group_type), error)))
+		{
+			goto _error;
+		}
+
+		aggregate->grouped = TRUE;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Builds a key that identifies a group value, unlike index keys strings and blobs are not truncated.
+ **/
+static void
+j_lmdb_group_key(GByteArray* key, JDBType type, JDBTypeValue const* value, gboolean present)
+{
+	guint8 flag = (present) ? 1 : 0;
+
+	g_byte_array_set_size(key, 0);
+
+	if (!present)
+	{
+		g_byte_array_append(key, &flag, 1);
+		return;
+	}
+
+	switch (type)
+	{
+		case J_DB_TYPE_STRING:
+			g_byte_array_append(key, &flag, 1);
+			g_byte_array_append(key, (guint8 const*)value->val_string, strlen(value->val_string) + 1);
+			break;
+		case J_DB_TYPE_BLOB:
+			g_byte_array_append(key, &flag, 1);
+			g_byte_array_append(key, (guint8 const*)value->val_blob, value->val_blob_length);
+			break;
+		case J_DB_TYPE_SINT32:
+		case J_DB_TYPE_UINT32:
+		case J_DB_TYPE_FLOAT32:
+		case J_DB_TYPE_SINT64:
+		case J_DB_TYPE_UINT64:
+		case J_DB_TYPE_FLOAT64:
+			j_lmdb_encode_value(key, type, value, TRUE);
+			break;
+		case J_DB_TYPE_ID:
+		default:
+			g_assert_not_reached();
+	}
+}
+
+static void
+j_lmdb_group_free(gpointer data)
+{
+	JLMDBGroup* group = data;
+
+	g_byte_array_unref(group->key);
+	g_free(group);
+}
+
+static gint
+j_lmdb_group_compare(gconstpointer a, gconstpointer b)
+{
+	JLMDBGroup const* group_a = *(JLMDBGroup* const*)a;
+	JLMDBGroup const* group_b = *(JLMDBGroup* const*)b;
+	gint ret;
+
+	ret = memcmp(group_a->key->data, group_b->key->data, MIN(group_a->key->len, group_b->key->len));
+
+	if (ret == 0)
+	{
+		ret = (group_a->key->len > group_b->key->len) - (group_a->key->len < group_b->key->len);
+	}
+
+	return ret;
+}
+
+static void
+j_lmdb_group_add(JLMDBAggregate const* aggregate, JLMDBGroup* group, JLMDBRow const* row)
+{
+	JDBTypeValue value;
+	gint c;
+
+	if (aggregate->field == J_LMDB_FIELD_COUNT)
+	{
+		group->count++;
+		return;
+	}
+
+	// like in SQL, NULL values are ignored
+	if (!j_lmdb_row_value(row, aggregate->field, &value) || j_lmdb_is_nan(aggregate->type, &value))
+	{
+		return;
+	}
+
+	group->count++;
+
+	switch (aggregate->function)
+	{
+		case J_DB_AGGREGATE_COUNT:
+			break;
+		case J_DB_AGGREGATE_MIN:
+		case J_DB_AGGREGATE_MAX:
+			if (!group->present)
+			{
+				group->value = value;
+				group->present = TRUE;
+				break;
+			}
+
+			c = j_lmdb_compare(aggregate->type, &value, &(group->value));
+
+			if ((aggregate->function == J_DB_AGGREGATE_MIN && c < 0) || (aggregate->function == J_DB_AGGREGATE_MAX && c > 0))
+			{
+				group->value = value;
+			}
+
+			break;
+		case J_DB_AGGREGATE_SUM:
+		case J_DB_AGGREGATE_AVG:
+			group->present = TRUE;
+
+			switch (aggregate->type)
+			{
+				case J_DB_TYPE_SINT32:
+					group->sum_sint64 += value.val_sint32;
+					group->sum_float64 += value.val_sint32;
+					break;
+				case J_DB_TYPE_UINT32:
+					group->sum_uint64 += value.val_uint32;
+					group->sum_float64 += value.val_uint32;
+					break;
+				case J_DB_TYPE_SINT64:
+					group->sum_sint64 += value.val_sint64;
+					group->sum_float64 += value.val_sint64;
+					break;
+				case J_DB_TYPE_UINT64:
+					group->sum_uint64 += value.val_uint64;
+					group->sum_float64 += value.val_uint64;
+					break;
+				case J_DB_TYPE_FLOAT32:
+					group->sum_float64 += value.val_float32;
+					break;
+				case J_DB_TYPE_FLOAT64:
+					group->sum_float64 += value.val_float64;
+					break;
+				case J_DB_TYPE_STRING:
+				case J_DB_TYPE_BLOB:
+				case J_DB_TYPE_ID:
+				default:
+					g_assert_not_reached();
+			}
+
+			break;
+		default:
+			g_assert_not_reached();
+	}
+}
+
+static gboolean
+j_lmdb_group_to_bson(JLMDBQuery const* query, JLMDBAggregate const* aggregate, JLMDBGroup const* group, bson_t* bson, GError** error)
+{
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, aggregate->table);
+	JDBTypeValue value;
+	g_autofree gchar* name = NULL;
+
+	memset(&value, 0, sizeof(value));
+
+	switch (aggregate->function)
+	{
+		case J_DB_AGGREGATE_COUNT:
+			value.val_uint64 = group->count;
+			break;
+		case J_DB_AGGREGATE_MIN:
+		case J_DB_AGGREGATE_MAX:
+			value = group->value;
+			break;
+		case J_DB_AGGREGATE_SUM:
+			if (aggregate->result_type == J_DB_TYPE_SINT64)
+			{
+				value.val_sint64 = group->sum_sint64;
+			}
+			else if (aggregate->result_type == J_DB_TYPE_UINT64)
+			{
+				value.val_uint64 = group->sum_uint64;
+			}
+			else
+			{
+				value.val_float64 = group->sum_float64;
+			}
+
+			break;
+		case J_DB_AGGREGATE_AVG:
+			value.val_float64 = group->sum_float64 / group->count;
+			break;
+		default:
+			g_assert_not_reached();
+	}
+
+	name = g_strdup_printf("%s_%s._aggregate", query->namespace, schema->name);
+
+	if (G_UNLIKELY(!j_bson_append_value(bson, name, aggregate->result_type, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (aggregate->grouped)
+	{
+		JDBType type = j_lmdb_schema_type(schema, aggregate->group);
+
+		g_free(name);
+		name = g_strdup_printf("%s_%s.%s", query->namespace, schema->name, j_lmdb_schema_field_name(schema, aggregate->group));
+		memset(&value, 0, sizeof(value));
+
+		if (group->group_present)
+		{
+			value = group->group_value;
+		}
+
+		if (G_UNLIKELY(!j_bson_append_value(bson, name, type, &value, error)))
+		{
+			goto _error;
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Computes an aggregate over the results of a query.
+ *
+ * Groups are sorted by their value, so the order matches the one of the SQL backends.
+ **/
+static gboolean
+j_lmdb_aggregate_execute(JLMDBData* bd, JLMDBBatch* batch, JLMDBQuery const* query, JLMDBAggregate const* aggregate, GArray const* results, GPtrArray* aggregates, GError** error)
+{
+	JLMDBSchema const* schema = g_ptr_array_index(query->tables, aggregate->table);
+	guint width = query->tables->len;
+	JLMDBRow row;
+	gboolean ret = FALSE;
+	g_autoptr(GHashTable) groups = NULL;
+	g_autoptr(GPtrArray) sorted = NULL;
+	g_autoptr(GByteArray) key = g_byte_array_new();
+
+	groups = g_hash_table_new_full(g_bytes_hash, g_bytes_equal, (GDestroyNotify)g_bytes_unref, j_lmdb_group_free);
+	sorted = g_ptr_array_new();
+
+	j_lmdb_row_init(&row, schema);
+
+	for (guint i = 0; i * width < results->len; i++)
+	{
+		JLMDBGroup* group;
+		JDBTypeValue group_value;
+		gboolean group_present = FALSE;
+		gboolean found;
+		g_autoptr(GBytes) group_key = NULL;
+
+		if (G_UNLIKELY(!j_lmdb_row_load(bd, batch, schema, g_array_index(results, guint64, i * width + aggregate->table), &row, &found, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!found))
+		{
+			continue;
+		}
+
+		memset(&group_value, 0, sizeof(group_value));
+
+		if (aggregate->grouped)
+		{
+			group_present = j_lmdb_row_value(&row, aggregate->group, &group_value);
+		}
+
+		j_lmdb_group_key(key, aggregate->group_type, &group_value, group_present);
+		group_key = g_bytes_new(key->data, key->len);
+
+		if ((group = g_hash_table_lookup(groups, group_key)) == NULL)
+		{
+			group = g_new0(JLMDBGroup, 1);
+			group->key = g_byte_array_new();
+			g_byte_array_append(group->key, key->data, key->len);
+			group->group_present = group_present;
+			group->group_value = group_value;
+
+			g_hash_table_insert(groups, g_bytes_ref(group_key), group);
+			g_ptr_array_add(sorted, group);
+		}
+
+		j_lmdb_group_add(aggregate, group, &row);
+	}
+
+	// without grouping, the count of an empty set is returned as one result
+	if (aggregate->function == J_DB_AGGREGATE_COUNT && !aggregate->grouped && sorted->len == 0)
+	{
+		JLMDBGroup* group;
+
+		group = g_new0(JLMDBGroup, 1);
+		group->key = g_byte_array_new();
+
+		g_hash_table_insert(groups, g_bytes_new(NULL, 0), group);
+		g_ptr_array_add(sorted, group);
+	}
+
+	g_ptr_array_sort(sorted, j_lmdb_group_compare);
+
+	for (guint i = 0; i < sorted->len; i++)
+	{
+		JLMDBGroup const* group = g_ptr_array_index(sorted, i);
+		bson_t* bson;
+
+		// Like the SQL backends, other functions do not return results for groups without values
+		if (aggregate->function != J_DB_AGGREGATE_COUNT && group->count == 0)
+		{
+			continue;
+		}
+
+		bson = bson_new();
+		g_ptr_array_add(aggregates, bson);
+
+		if (G_UNLIKELY(!j_lmdb_group_to_bson(query, aggregate, group, bson, error)))
+		{
+			goto _error;
+		}
+	}
+
+	ret = TRUE;
+
+_error:
+	j_lmdb_row_clear(&row);
+
+	return ret;
+}
+
+static void
+j_lmdb_iterator_free(JLMDBIterator* iterator)
+{
+	for (guint i = 0; i < iterator->query->tables->len; i++)
+	{
+		j_lmdb_row_clear(&(iterator->rows[i]));
+	}
+
+	g_free(iterator->rows);
+	g_ptr_array_unref(iterator->names);
+	g_array_unref(iterator->results);
+
+	if (iterator->aggregates != NULL)
+	{
+		g_ptr_array_unref(iterator->aggregates);
+	}
+
+	j_lmdb_query_free(iterator->query);
+	g_free(iterator);
+}
+
+static gboolean
+backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* _batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBBatch* batch;
+
+	(void)backend_data;
+	(void)error;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+	g_return_val_if_fail(_batch != NULL, FALSE);
+
+	batch = g_new(JLMDBBatch, 1);
+	batch->txn = NULL;
+	batch->write = FALSE;
+	batch->namespace = g_strdup(namespace);
+	batch->semantics = j_semantics_ref(semantics);
+	batch->schemas = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, j_lmdb_schema_free);
+	batch->key = g_byte_array_new();
+
+	*_batch = batch;
+
+	return TRUE;
+}
+
+static gboolean
+backend_batch_execute(gpointer backend_data, gpointer _batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+	JLMDBBatch* batch = _batch;
+	gint rc;
+
+	(void)backend_data;
+
+	g_return_val_if_fail(batch != NULL, FALSE);
+
+	if (batch->txn != NULL && G_UNLIKELY((rc = mdb_txn_commit(batch->txn)) != 0))
+	{
+		j_lmdb_set_error(error, rc);
+		ret = FALSE;
+	}
+
+	g_byte_array_unref(batch->key);
+	g_hash_table_unref(batch->schemas);
+	j_semantics_unref(batch->semantics);
+	g_free(batch->namespace);
+	g_free(batch);
+
+	return ret;
+}
+
+static gboolean
+backend_schema_create(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* schema, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBSchema* lmdb_schema = NULL;
+	MDB_val key;
+	MDB_val value;
+	gint rc;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(schema != NULL, FALSE);
+
+	if (G_UNLIKELY((lmdb_schema = j_lmdb_schema_new(batch->namespace, name, schema, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	// row keys are the longest keys that do not depend on values
+	if (G_UNLIKELY(lmdb_schema->prefix->len + sizeof(guint64) > (guint)mdb_env_get_maxkeysize(bd->env)))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "schema name too long");
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, TRUE, error)))
+	{
+		goto _error;
+	}
+
+	key.mv_size = lmdb_schema->prefix->len;
+	key.mv_data = lmdb_schema->prefix->data;
+	value.mv_size = schema->len;
+	value.mv_data = (gpointer)bson_get_data(schema);
+
+	if (G_UNLIKELY((rc = mdb_put(batch->txn, bd->schema_dbi, &key, &value, MDB_NOOVERWRITE)) != 0))
+	{
+		if (rc == MDB_KEYEXIST)
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "schema already exists");
+		}
+		else
+		{
+			j_lmdb_set_error(error, rc);
+		}
+
+		goto _error;
+	}
+
+	g_hash_table_replace(batch->schemas, g_strdup(name), lmdb_schema);
+
+	return TRUE;
+
+_error:
+	if (lmdb_schema != NULL)
+	{
+		j_lmdb_schema_free(lmdb_schema);
+	}
+
+	j_lmdb_batch_abort(batch);
+
+	return FALSE;
+}
+
+static gboolean
+backend_schema_get(gpointer backend_data, gpointer _batch, gchar const* name, bson_t* schema, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBSchema* lmdb_schema;
+	JDBTypeValue value;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+
+	if (G_UNLIKELY((lmdb_schema = j_lmdb_schema_get(bd, batch, name, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	if (schema != NULL)
+	{
+		// assume that the passed pointer is an uninitialized bson (e.g., in a JBackendOperationParam struct)
+		if (G_UNLIKELY(!j_bson_init(schema, error)))
+		{
+			goto _error;
+		}
+
+		value.val_uint32 = J_DB_TYPE_UINT64;
+
+		if (G_UNLIKELY(!j_bson_append_value(schema, "_id", J_DB_TYPE_UINT32, &value, error)))
+		{
+			goto _error;
+		}
+
+		for (guint i = 0; i < lmdb_schema->fields->len; i++)
+		{
+			value.val_uint32 = g_array_index(lmdb_schema->types, JDBType, i);
+
+			if (G_UNLIKELY(!j_bson_append_value(schema, g_ptr_array_index(lmdb_schema->fields, i), J_DB_TYPE_UINT32, &value, error)))
+			{
+				goto _error;
+			}
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+static gboolean
+backend_schema_delete(gpointer backend_data, gpointer _batch, gchar const* name, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	g_autoptr(GByteArray) prefix = g_byte_array_new();
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, TRUE, error)))
+	{
+		goto _error;
+	}
+
+	j_lmdb_key_prefix(prefix, batch->namespace, name);
+
+	if (G_UNLIKELY(!j_lmdb_del(batch, bd->schema_dbi, prefix, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_lmdb_del_prefix(batch, bd->row_dbi, prefix, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_lmdb_del_prefix(batch, bd->index_dbi, prefix, error)))
+	{
+		goto _error;
+	}
+
+	g_hash_table_remove(batch->schemas, name);
+
+	return TRUE;
+
+_error:
+	j_lmdb_batch_abort(batch);
+
+	return FALSE;
+}
+
+static gboolean
+backend_insert(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* metadata, bson_t* id, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBSchema* schema;
+	JLMDBRow row = { 0, NULL, NULL };
+	JDBTypeValue value;
+	bson_iter_t iter;
+	guint count = 0;
+	g_autoptr(GByteArray) buffer = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(metadata != NULL, FALSE);
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, TRUE, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((schema = j_lmdb_schema_get(bd, batch, name, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	j_lmdb_row_init(&row, schema);
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, metadata, error)))
+	{
+		goto _error;
+	}
+
+	while (TRUE)
+	{
+		gboolean has_next;
+		gchar const* key;
+		guint field;
+		JDBType type;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY((key = j_bson_iter_key(&iter, error)) == NULL))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_lmdb_schema_field(schema, key, &field, &type, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(field == J_LMDB_FIELD_ID))
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "_id can not be set");
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_value(&iter, type, &(row.values[field]), error)))
+		{
+			goto _error;
+		}
+
+		row.present[field] = (type != J_DB_TYPE_BLOB || row.values[field].val_blob != NULL);
+		count++;
+	}
+
+	if (G_UNLIKELY(!count))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_NO_VARIABLE_SET, "no variable set");
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_lmdb_next_id(bd, batch, schema, &(row.id), error)))
+	{
+		goto _error;
+	}
+
+	buffer = g_byte_array_new();
+	j_lmdb_row_encode(schema, &row, buffer);
+	j_lmdb_row_key(batch->key, schema, row.id);
+
+	if (G_UNLIKELY(!j_lmdb_put(bd, batch, bd->row_dbi, batch->key, buffer->data, buffer->len, MDB_NOOVERWRITE, error)))
+	{
+		goto _error;
+	}
+
+	// the values point into metadata, so the index keys can be written one after the other
+	for (guint i = 0; i < schema->indexes->len; i++)
+	{
+		j_lmdb_index_key(batch->key, schema, i, &row);
+
+		if (G_UNLIKELY(!j_lmdb_put(bd, batch, bd->index_dbi, batch->key, NULL, 0, 0, error)))
+		{
+			goto _error;
+		}
+	}
+
+	value.val_uint64 = row.id;
+
+	if (G_UNLIKELY(!j_bson_append_value(id, "_value", J_DB_TYPE_UINT64, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_uint32 = J_DB_TYPE_UINT64;
+
+	if (G_UNLIKELY(!j_bson_append_value(id, "_value_type", J_DB_TYPE_UINT32, &value, error)))
+	{
+		goto _error;
+	}
+
+	j_lmdb_row_clear(&row);
+
+	return TRUE;
+
+_error:
+	j_lmdb_row_clear(&row);
+	j_lmdb_batch_abort(batch);
+
+	return FALSE;
+}
+
+static gboolean
+backend_update(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t const* entry_updates, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBSchema* schema;
+	JLMDBQuery* query = NULL;
+	JLMDBRow old_row = { 0, NULL, NULL };
+	JLMDBRow new_row = { 0, NULL, NULL };
+	bson_iter_t iter;
+	g_autoptr(GArray) fields = NULL;
+	g_autoptr(GArray) values = NULL;
+	g_autoptr(GArray) ids = NULL;
+	g_autoptr(GByteArray) buffer = NULL;
+	g_autoptr(GPtrArray) old_keys = NULL;
+	g_autoptr(GPtrArray) new_keys = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(entry_updates != NULL, FALSE);
+	g_return_val_if_fail(selector != NULL, FALSE);
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, TRUE, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((schema = j_lmdb_schema_get(bd, batch, name, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	fields = g_array_new(FALSE, FALSE, sizeof(guint));
+	values = g_array_new(FALSE, FALSE, sizeof(JDBTypeValue));
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, entry_updates, error)))
+	{
+		goto _error;
+	}
+
+	while (TRUE)
+	{
+		gboolean has_next;
+		gchar const* key;
+		guint field;
+		JDBType type;
+		JDBTypeValue value;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY((key = j_bson_iter_key(&iter, error)) == NULL))
+		{
+			goto _error;
+		}
+
+		if (g_str_equal(key, "_index"))
+		{
+			continue;
+		}
+
+		if (G_UNLIKELY(!j_lmdb_schema_field(schema, key, &field, &type, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(field == J_LMDB_FIELD_ID))
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "_id can not be set");
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_value(&iter, type, &value, error)))
+		{
+			goto _error;
+		}
+
+		g_array_append_val(fields, field);
+		g_array_append_val(values, value);
+	}
+
+	if (G_UNLIKELY(fields->len == 0))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_NO_VARIABLE_SET, "no variable set");
+		goto _error;
+	}
+
+	if (G_UNLIKELY((query = j_lmdb_query_new(bd, batch, name, selector, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	ids = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+	if (G_UNLIKELY(!j_lmdb_query_execute(bd, batch, query, ids, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(ids->len == 0))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS, "no more elements");
+		goto _error;
+	}
+
+	j_lmdb_row_init(&old_row, schema);
+	j_lmdb_row_init(&new_row, schema);
+	buffer = g_byte_array_new();
+	old_keys = g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+	new_keys = g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+
+	for (guint i = 0; i < ids->len; i++)
+	{
+		gboolean found;
+
+		if (G_UNLIKELY(!j_lmdb_row_load(bd, batch, schema, g_array_index(ids, guint64, i), &old_row, &found, error)))
+		{
+			goto _error;
+		}
+
+		if (!found)
+		{
+			continue;
+		}
+
+		new_row.id = old_row.id;
+		memcpy(new_row.values, old_row.values, schema->fields->len * sizeof(JDBTypeValue));
+		memcpy(new_row.present, old_row.present, schema->fields->len * sizeof(gboolean));
+
+		for (guint j = 0; j < fields->len; j++)
+		{
+			guint field = g_array_index(fields, guint, j);
+
+			new_row.values[field] = g_array_index(values, JDBTypeValue, j);
+			new_row.present[field] = (j_lmdb_schema_type(schema, field) != J_DB_TYPE_BLOB || new_row.values[field].val_blob != NULL);
+		}
+
+		// the old row points into the memory map, so everything is copied before modifying the database
+		j_lmdb_row_encode(schema, &new_row, buffer);
+		g_ptr_array_set_size(old_keys, 0);
+		g_ptr_array_set_size(new_keys, 0);
+		j_lmdb_index_keys(schema, &old_row, old_keys);
+		j_lmdb_index_keys(schema, &new_row, new_keys);
+
+		for (guint j = 0; j < schema->indexes->len; j++)
+		{
+			GByteArray const* old_key = g_ptr_array_index(old_keys, j);
+			GByteArray const* new_key = g_ptr_array_index(new_keys, j);
+
+			if (old_key->len == new_key->len && memcmp(old_key->data, new_key->data, old_key->len) == 0)
+			{
+				continue;
+			}
+
+			if (G_UNLIKELY(!j_lmdb_del(batch, bd->index_dbi, old_key, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_lmdb_put(bd, batch, bd->index_dbi, new_key, NULL, 0, 0, error)))
+			{
+				goto _error;
+			}
+		}
+
+		j_lmdb_row_key(batch->key, schema, new_row.id);
+
+		if (G_UNLIKELY(!j_lmdb_put(bd, batch, bd->row_dbi, batch->key, buffer->data, buffer->len, 0, error)))
+		{
+			goto _error;
+		}
+	}
+
+	j_lmdb_row_clear(&old_row);
+	j_lmdb_row_clear(&new_row);
+	j_lmdb_query_free(query);
+
+	return TRUE;
+
+_error:
+	j_lmdb_row_clear(&old_row);
+	j_lmdb_row_clear(&new_row);
+	j_lmdb_query_free(query);
+	j_lmdb_batch_abort(batch);
+
+	return FALSE;
+}
+
+static gboolean
+backend_delete(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBSchema* schema;
+	JLMDBQuery* query = NULL;
+	JLMDBRow row = { 0, NULL, NULL };
+	g_autoptr(GArray) ids = NULL;
+	g_autoptr(GPtrArray) keys = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, TRUE, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((schema = j_lmdb_schema_get(bd, batch, name, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((query = j_lmdb_query_new(bd, batch, name, selector, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	ids = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+	if (G_UNLIKELY(!j_lmdb_query_execute(bd, batch, query, ids, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(ids->len == 0))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS, "no more elements");
+		goto _error;
+	}
+
+	j_lmdb_row_init(&row, schema);
+	keys = g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+
+	for (guint i = 0; i < ids->len; i++)
+	{
+		gboolean found;
+
+		if (G_UNLIKELY(!j_lmdb_row_load(bd, batch, schema, g_array_index(ids, guint64, i), &row, &found, error)))
+		{
+			goto _error;
+		}
+
+		if (!found)
+		{
+			continue;
+		}
+
+		g_ptr_array_set_size(keys, 0);
+		j_lmdb_index_keys(schema, &row, keys);
+
+		for (guint j = 0; j < keys->len; j++)
+		{
+			if (G_UNLIKELY(!j_lmdb_del(batch, bd->index_dbi, g_ptr_array_index(keys, j), error)))
+			{
+				goto _error;
+			}
+		}
+
+		j_lmdb_row_key(batch->key, schema, row.id);
+
+		if (G_UNLIKELY(!j_lmdb_del(batch, bd->row_dbi, batch->key, error)))
+		{
+			goto _error;
+		}
+	}
+
+	j_lmdb_row_clear(&row);
+	j_lmdb_query_free(query);
+
+	return TRUE;
+
+_error:
+	j_lmdb_row_clear(&row);
+	j_lmdb_query_free(query);
+	j_lmdb_batch_abort(batch);
+
+	return FALSE;
+}
+
+static gboolean
+backend_query(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, gpointer* _iterator, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBQuery* query = NULL;
+	JLMDBIterator* iterator;
+	g_autoptr(GArray) results = NULL;
+	g_autoptr(GPtrArray) aggregates = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(_iterator != NULL, FALSE);
+
+	if (G_UNLIKELY(!j_lmdb_batch_begin(bd, batch, FALSE, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY((query = j_lmdb_query_new(bd, batch, name, selector, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	results = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+	if (G_UNLIKELY(!j_lmdb_query_execute(bd, batch, query, results, error)))
+	{
+		goto _error;
+	}
+
+	if (selector != NULL && bson_has_field(selector, "a"))
+	{
+		JLMDBAggregate aggregate;
+
+		aggregates = g_ptr_array_new_with_free_func((GDestroyNotify)bson_destroy);
+
+		if (G_UNLIKELY(!j_lmdb_aggregate_parse(query, selector, &aggregate, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_lmdb_aggregate_execute(bd, batch, query, &aggregate, results, aggregates, error)))
+		{
+			goto _error;
+		}
+	}
+
+	iterator = g_new(JLMDBIterator, 1);
+	iterator->batch = batch;
+	iterator->query = query;
+	iterator->results = g_steal_pointer(&results);
+	iterator->aggregates = g_steal_pointer(&aggregates);
+	iterator->position = 0;
+	iterator->rows = g_new0(JLMDBRow, query->tables->len);
+	iterator->names = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+
+	for (guint i = 0; i < query->tables->len; i++)
+	{
+		JLMDBSchema const* schema = g_ptr_array_index(query->tables, i);
+		GPtrArray* names = g_ptr_array_new_with_free_func(g_free);
+
+		j_lmdb_row_init(&(iterator->rows[i]), schema);
+
+		g_ptr_array_add(names, g_strdup_printf("%s_%s._id", batch->namespace, schema->name));
+
+		for (guint j = 0; j < schema->fields->len; j++)
+		{
+			g_ptr_array_add(names, g_strdup_printf("%s_%s.%s", batch->namespace, schema->name, (gchar const*)g_ptr_array_index(schema->fields, j)));
+		}
+
+		g_ptr_array_add(iterator->names, names);
+	}
+
+	*_iterator = iterator;
+
+	return TRUE;
+
+_error:
+	j_lmdb_query_free(query);
+
+	return FALSE;
+}
+
+static gboolean
+backend_iterate(gpointer backend_data, gpointer _iterator, bson_t* query_result, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBIterator* iterator = _iterator;
+	JLMDBQuery const* query;
+	guint width;
+
+	g_return_val_if_fail(iterator != NULL, FALSE);
+	g_return_val_if_fail(query_result != NULL, FALSE);
+
+	query = iterator->query;
+	width = query->tables->len;
+
+	if (iterator->aggregates != NULL)
+	{
+		if (iterator->position >= iterator->aggregates->len)
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS, "no more elements while iterating");
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!bson_concat(query_result, g_ptr_array_index(iterator->aggregates, iterator->position))))
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "bson concat failed");
+			goto _error;
+		}
+
+		iterator->position++;
+
+		return TRUE;
+	}
+
+	if ((iterator->position + 1) * width > iterator->results->len)
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS, "no more elements while iterating");
+		goto _error;
+	}
+
+	for (guint i = 0; i < width; i++)
+	{
+		JLMDBSchema const* schema = g_ptr_array_index(query->tables, i);
+		JLMDBRow* row = &(iterator->rows[i]);
+		GPtrArray* names = g_ptr_array_index(iterator->names, i);
+		JDBTypeValue value;
+		gboolean found;
+
+		if (G_UNLIKELY(!j_lmdb_row_load(bd, iterator->batch, schema, g_array_index(iterator->results, guint64, iterator->position * width + i), row, &found, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!found))
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_INVALID, "iterator invalid");
+			goto _error;
+		}
+
+		value.val_uint64 = row->id;
+
+		if (G_UNLIKELY(!j_bson_append_value(query_result, g_ptr_array_index(names, 0), J_DB_TYPE_UINT64, &value, error)))
+		{
+			goto _error;
+		}
+
+		// NULL values are returned as zero or null, just like the SQL backends do
+		for (guint j = 0; j < schema->fields->len; j++)
+		{
+			if (G_UNLIKELY(!j_bson_append_value(query_result, g_ptr_array_index(names, j + 1), g_array_index(schema->types, JDBType, j), &(row->values[j]), error)))
+			{
+				goto _error;
+			}
+		}
+	}
+
+	iterator->position++;
+
+	return TRUE;
+
+_error:
+	j_lmdb_iterator_free(iterator);
+
+	return FALSE;
+}
+
+static gboolean
+backend_explain(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t* result, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = _batch;
+	JLMDBQuery* query = NULL;
+	JDBTypeValue value;
+	g_autofree gchar* report = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (G_UNLIKELY((query = j_lmdb_query_new(bd, batch, name, selector, error)) == NULL))
+	{
+		goto _error;
+	}
+
+	report = j_lmdb_query_explain(query);
+	value.val_string = report;
+
+	if (G_UNLIKELY(!j_bson_append_value(result, "plan", J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	j_lmdb_query_free(query);
+
+	return TRUE;
+
+_error:
+	j_lmdb_query_free(query);
+
+	return FALSE;
+}
+
+static gboolean
+backend_init(gchar const* path, gpointer* backend_data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd;
+	MDB_txn* txn;
+	g_autofree gchar* directory = NULL;
+	gchar const* separator;
+	guint64 map_size = J_LMDB_MAP_SIZE_DEFAULT;
+
+	g_return_val_if_fail(path != NULL, FALSE);
+
+	// The path has the format directory[:size]
+	if ((separator = strrchr(path, ':')) != NULL)
+	{
+		if (!j_lmdb_parse_map_size(separator + 1, &map_size))
+		{
+			g_critical("Invalid map size %s.", separator + 1);
+			return FALSE;
+		}
+
+		directory = g_strndup(path, separator - path);
+	}
+	else
+	{
+		directory = g_strdup(path);
+	}
+
+	g_mkdir_with_parents(directory, 0700);
+
+	bd = g_new(JLMDBData, 1);
+	bd->env = NULL;
+
+	if (mdb_env_create(&(bd->env)) != 0)
+	{
+		bd->env = NULL;
+		goto _error;
+	}
+
+	if (mdb_env_set_mapsize(bd->env, map_size) != 0)
+	{
+		goto _error;
+	}
+
+	if (mdb_env_set_maxdbs(bd->env, 3) != 0)
+	{
+		goto _error;
+	}
+
+	// read-only transactions are not tied to the thread that started them
+	if (mdb_env_open(bd->env, directory, MDB_NOTLS, 0600) != 0)
+	{
+		goto _error;
+	}
+
+	if (mdb_txn_begin(bd->env, NULL, 0, &txn) != 0)
+	{
+		goto _error;
+	}
+
+	if (mdb_dbi_open(txn, "schema", MDB_CREATE, &(bd->schema_dbi)) != 0
+	    || mdb_dbi_open(txn, "row", MDB_CREATE, &(bd->row_dbi)) != 0
+	    || mdb_dbi_open(txn, "index", MDB_CREATE, &(bd->index_dbi)) != 0)
+	{
+		mdb_txn_abort(txn);
+		goto _error;
+	}
+
+	if (mdb_txn_commit(txn) != 0)
+	{
+		goto _error;
+	}
+
+	*backend_data = bd;
+
+	return TRUE;
+
+_error:
+	if (bd->env != NULL)
+	{
+		mdb_env_close(bd->env);
+	}
+
+	g_free(bd);
+
+	return FALSE;
+}
+
+static void
+backend_fini(gpointer backend_data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JLMDBData* bd = backend_data;
+
+	if (bd->env != NULL)
+	{
+		mdb_env_close(bd->env);
+	}
+
+	g_free(bd);
+}
+
+static JBackend lmdb_backend = {
+	.type = J_BACKEND_TYPE_DB,
+	.component = J_BACKEND_COMPONENT_SERVER,
+	.flags = 0,
+	.db = {
+		.backend_init = backend_init,
+		.backend_fini = backend_fini,
+		.backend_schema_create = backend_schema_create,
+		.backend_schema_get = backend_schema_get,
+		.backend_schema_delete = backend_schema_delete,
+		.backend_insert = backend_insert,
+		.backend_update = backend_update,
+		.backend_delete = backend_delete,
+		.backend_query = backend_query,
+		.backend_iterate = backend_iterate,
+		.backend_explain = backend_explain,
+		.backend_batch_start = backend_batch_start,
+		.backend_batch_execute = backend_batch_execute,
+	},
+};
+
+G_MODULE_EXPORT
+JBackend*
+backend_info(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return &lmdb_backend;
+}
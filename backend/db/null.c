@@ -146,6 +146,19 @@ backend_iterate(gpointer backend_data, gpointer iterator, bson_t* metadata, GErr
 	return TRUE;
 }
 
+static gboolean
+backend_explain(gpointer backend_data, gpointer batch, gchar const* name, bson_t const* selector, bson_t* result, GError** error)
+{
+	(void)backend_data;
+	(void)batch;
+	(void)name;
+	(void)selector;
+	(void)result;
+	(void)error;
+
+	return TRUE;
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
@@ -176,6 +189,7 @@ static JBackend null_backend = {
 		.backend_delete = backend_delete,
 		.backend_query = backend_query,
 		.backend_iterate = backend_iterate,
+		.backend_explain = backend_explain,
 		.backend_batch_start = backend_batch_start,
 		.backend_batch_execute = backend_batch_execute }
 };
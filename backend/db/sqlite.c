@@ -519,6 +519,7 @@ static JBackend sqlite_backend = {
 		.backend_delete = sql_generic_delete,
 		.backend_query = sql_generic_query,
 		.backend_iterate = sql_generic_iterate,
+		.backend_explain = sql_generic_explain,
 		.backend_batch_start = sql_generic_batch_start,
 		.backend_batch_execute = sql_generic_batch_execute,
 	},
@@ -45,7 +45,7 @@ j_cmd_usage(void)
 	g_print("Commands:\n");
 	g_print("  create      uri\n");
 	g_print("  create-all  uri\n");
-	g_print("  copy        src-uri dst-uri\n");
+	g_print("  copy        [--block-size=bytes] [--buffers=n] [--jobs=n] [--progress] src-uri dst-uri [src-uri dst-uri …]\n");
 	g_print("  delete      uri\n");
 	g_print("  list        uri\n");
 	g_print("  status      uri\n");
@@ -22,249 +22,547 @@
 
 #include <gio/gio.h>
 
-gboolean
-j_cmd_copy(gchar const** arguments)
+/*
+ * Copies are pipelined: While the write of a block is executed in the background, the next block is already being read.
+ * Every copy uses opt_buffers buffers of opt_block_size bytes, so at most opt_buffers - 1 writes overlap with a read.
+ * Multiple source and destination pairs are copied by up to opt_jobs threads.
+ */
+
+static gint64 opt_block_size = 4 * 1024 * 1024;
+static gint opt_buffers = 2;
+static gint opt_jobs = 1;
+static gboolean opt_progress = FALSE;
+
+struct JCmdCopyEndpoint
 {
-	gboolean ret = TRUE;
-	JObjectURI* ouri[2] = { NULL, NULL };
-	JURI* uri[2] = { NULL, NULL };
-	GError* error;
-	GFile* file;
-	GFileIOStream* stream[2] = { NULL, NULL };
-	g_autofree gchar* buffer = NULL;
+	JObjectURI* ouri;
+	JURI* uri;
+	GFileIOStream* stream;
+};
+
+typedef struct JCmdCopyEndpoint JCmdCopyEndpoint;
+
+struct JCmdCopyBuffer
+{
+	gchar* data;
 	guint64 offset;
-	guint i;
+	guint64 length;
+	guint64 bytes_written;
+	/// the stream to write to, only set for streams
+	GOutputStream* output;
+	/// the pending write, either a batch or a background operation
+	JBatch* batch;
+	JBackgroundOperation* operation;
+	gboolean ret;
+};
+
+typedef struct JCmdCopyBuffer JCmdCopyBuffer;
+
+struct JCmdCopy
+{
+	gchar const* source;
+	gchar const* destination;
+	gboolean ret;
+};
+
+typedef struct JCmdCopy JCmdCopy;
+
+struct JCmdCopyProgress
+{
+	GMutex mutex;
+	/// the next copy to process
+	guint next;
+	guint64 volatile bytes;
+	gint64 start_time;
+	gint64 last_report;
+};
+
+typedef struct JCmdCopyProgress JCmdCopyProgress;
 
-	if (j_cmd_arguments_length(arguments) != 2)
+static JCmdCopyProgress j_cmd_copy_progress;
+
+static void
+j_cmd_copy_report(gboolean force)
+{
+	g_autofree gchar* copied = NULL;
+	g_autofree gchar* rate = NULL;
+	gint64 now;
+	guint64 bytes;
+	gdouble elapsed;
+
+	if (!opt_progress)
 	{
-		ret = FALSE;
-		j_cmd_usage();
-		goto end;
+		return;
 	}
 
-	for (i = 0; i <= 1; i++)
+	now = g_get_monotonic_time();
+
+	g_mutex_lock(&j_cmd_copy_progress.mutex);
+
+	if (!force && now - j_cmd_copy_progress.last_report < G_USEC_PER_SEC)
 	{
-		g_autoptr(JBatch) batch = NULL;
+		g_mutex_unlock(&j_cmd_copy_progress.mutex);
+		return;
+	}
+
+	j_cmd_copy_progress.last_report = now;
+	bytes = j_helper_atomic_add(&j_cmd_copy_progress.bytes, 0);
+	elapsed = MAX((gdouble)(now - j_cmd_copy_progress.start_time) / G_USEC_PER_SEC, 1e-6);
+
+	copied = g_format_size(bytes);
+	rate = g_format_size(bytes / elapsed);
+
+	g_printerr("\r%s copied (%s/s)%s", copied, rate, (force) ? "\n" : "");
 
-		if ((ouri[i] = j_object_uri_new(arguments[i], J_OBJECT_URI_SCHEME_OBJECT)) != NULL)
+	g_mutex_unlock(&j_cmd_copy_progress.mutex);
+}
+
+static gboolean
+j_cmd_copy_open(JCmdCopyEndpoint* endpoint, gchar const* argument, gboolean destination)
+{
+	g_autoptr(JBatch) batch = NULL;
+	GError* error = NULL;
+	GFile* file;
+
+	if ((endpoint->ouri = j_object_uri_new(argument, J_OBJECT_URI_SCHEME_OBJECT)) != NULL)
+	{
+		if (!destination)
 		{
-			if (i == 0)
-			{
-				/// \todo check whether object exists
-			}
-			else if (i == 1)
-			{
-				batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
-				j_object_create(j_object_uri_get_object(ouri[i]), batch);
+			/// \todo check whether object exists
+		}
+		else
+		{
+			batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+			j_object_create(j_object_uri_get_object(endpoint->ouri), batch);
 
-				if (!j_batch_execute(batch))
-				{
-					ret = FALSE;
-					goto end;
-				}
+			if (!j_batch_execute(batch))
+			{
+				return FALSE;
 			}
 		}
-		else if ((uri[i] = j_uri_new(arguments[i])) != NULL)
+	}
+	else if ((endpoint->uri = j_uri_new(argument)) != NULL)
+	{
+		if (j_uri_get_item_name(endpoint->uri) == NULL)
 		{
-			error = NULL;
+			j_cmd_usage();
+			return FALSE;
+		}
 
-			if (j_uri_get_item_name(uri[i]) == NULL)
+		if (!destination)
+		{
+			if (!j_uri_get(endpoint->uri, &error))
 			{
-				ret = FALSE;
-				j_cmd_usage();
-				goto end;
+				g_print("Error: %s\n", error->message);
+				g_error_free(error);
+				return FALSE;
 			}
+		}
+		else
+		{
+			g_autoptr(JItem) item = NULL;
 
-			if (i == 0)
+			if (j_uri_get(endpoint->uri, &error))
 			{
-				if (!j_uri_get(uri[i], &error))
+				if (j_uri_get_item(endpoint->uri) != NULL)
 				{
-					ret = FALSE;
-					g_print("Error: %s\n", error->message);
-					g_error_free(error);
-					goto end;
+					g_print("Error: Item “%s” already exists.\n", j_item_get_name(j_uri_get_item(endpoint->uri)));
 				}
+
+				return FALSE;
 			}
-			else if (i == 1)
+			else
 			{
-				g_autoptr(JItem) item = NULL;
-
-				if (j_uri_get(uri[i], &error))
+				if (!j_cmd_error_last(endpoint->uri))
 				{
-					ret = FALSE;
-
-					if (j_uri_get_item(uri[i]) != NULL)
-					{
-						g_print("Error: Item “%s” already exists.\n", j_item_get_name(j_uri_get_item(uri[i])));
-					}
-
-					goto end;
-				}
-				else
-				{
-					if (!j_cmd_error_last(uri[i]))
-					{
-						ret = FALSE;
-						g_print("Error: %s\n", error->message);
-						g_error_free(error);
-						goto end;
-					}
-
+					g_print("Error: %s\n", error->message);
 					g_error_free(error);
+					return FALSE;
 				}
 
-				batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
-				item = j_item_create(j_uri_get_collection(uri[i]), j_uri_get_item_name(uri[i]), NULL, batch);
+				g_error_free(error);
+			}
 
-				if (!j_batch_execute(batch))
-				{
-					ret = FALSE;
-					goto end;
-				}
+			batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+			item = j_item_create(j_uri_get_collection(endpoint->uri), j_uri_get_item_name(endpoint->uri), NULL, batch);
 
-				j_uri_get(uri[i], NULL);
+			if (!j_batch_execute(batch))
+			{
+				return FALSE;
 			}
+
+			j_uri_get(endpoint->uri, NULL);
+		}
+	}
+	else
+	{
+		file = g_file_new_for_commandline_arg(argument);
+
+		if (!destination)
+		{
+			endpoint->stream = g_file_open_readwrite(file, NULL, &error);
 		}
 		else
 		{
-			error = NULL;
+			endpoint->stream = g_file_create_readwrite(file, G_FILE_CREATE_NONE, NULL, &error);
+		}
 
-			file = g_file_new_for_commandline_arg(arguments[i]);
+		g_object_unref(file);
 
-			if (i == 0)
-			{
-				stream[i] = g_file_open_readwrite(file, NULL, &error);
-			}
-			else if (i == 1)
+		if (endpoint->stream == NULL)
+		{
+			if (error != NULL)
 			{
-				stream[i] = g_file_create_readwrite(file, G_FILE_CREATE_NONE, NULL, &error);
+				g_print("Error: %s\n", error->message);
+				g_error_free(error);
 			}
 
-			g_object_unref(file);
+			return FALSE;
+		}
+	}
 
-			if (stream[i] == NULL)
-			{
-				ret = FALSE;
+	return TRUE;
+}
 
-				if (error != NULL)
-				{
-					g_print("Error: %s\n", error->message);
-					g_error_free(error);
-				}
+static void
+j_cmd_copy_close(JCmdCopyEndpoint* endpoint)
+{
+	if (endpoint->stream != NULL)
+	{
+		g_object_unref(endpoint->stream);
+	}
 
-				goto end;
-			}
-		}
+	if (endpoint->ouri != NULL)
+	{
+		j_object_uri_free(endpoint->ouri);
+	}
+
+	if (endpoint->uri != NULL)
+	{
+		j_uri_free(endpoint->uri);
 	}
+}
 
-	offset = 0;
-	buffer = g_new(gchar, 1024 * 1024);
+static gboolean
+j_cmd_copy_read(JCmdCopyEndpoint* endpoint, JCmdCopyBuffer* buffer)
+{
+	g_autoptr(JBatch) batch = NULL;
+	guint64 nbytes = 0;
 
-	while (TRUE)
+	if (endpoint->stream != NULL)
 	{
-		g_autoptr(JBatch) batch = NULL;
-		guint64 bytes_read = 0;
+		GInputStream* input;
+		gsize stream_nbytes = 0;
 
-		batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+		input = g_io_stream_get_input_stream(G_IO_STREAM(endpoint->stream));
 
-		if (ouri[0] != NULL)
+		if (!g_input_stream_read_all(input, buffer->data, opt_block_size, &stream_nbytes, NULL, NULL))
 		{
-			guint64 nbytes;
+			return FALSE;
+		}
 
-			j_object_read(j_object_uri_get_object(ouri[0]), buffer, 1024 * 1024, offset, &nbytes, batch);
+		buffer->length = stream_nbytes;
 
-			if (!j_batch_execute(batch))
-			{
-				ret = FALSE;
-				goto end;
-			}
+		return TRUE;
+	}
 
-			bytes_read = nbytes;
-		}
-		else if (uri[0] != NULL)
-		{
-			guint64 nbytes;
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
 
-			j_item_read(j_uri_get_item(uri[0]), buffer, 1024 * 1024, offset, &nbytes, batch);
+	if (endpoint->ouri != NULL)
+	{
+		j_object_read(j_object_uri_get_object(endpoint->ouri), buffer->data, opt_block_size, buffer->offset, &nbytes, batch);
+	}
+	else if (endpoint->uri != NULL)
+	{
+		j_item_read(j_uri_get_item(endpoint->uri), buffer->data, opt_block_size, buffer->offset, &nbytes, batch);
+	}
 
-			if (!j_batch_execute(batch))
-			{
-				ret = FALSE;
-				goto end;
-			}
+	if (!j_batch_execute(batch))
+	{
+		return FALSE;
+	}
 
-			bytes_read = nbytes;
-		}
-		else if (stream[0] != NULL)
-		{
-			GInputStream* input;
-			gsize nbytes;
+	buffer->length = nbytes;
 
-			input = g_io_stream_get_input_stream(G_IO_STREAM(stream[0]));
+	return TRUE;
+}
 
-			g_input_stream_read_all(input, buffer, 1024 * 1024, &nbytes, NULL, NULL);
-			bytes_read = nbytes;
-		}
+static void
+j_cmd_copy_write_callback(JBatch* batch, gboolean ret, gpointer data)
+{
+	JCmdCopyBuffer* buffer = data;
 
-		if (ouri[1] != NULL)
-		{
-			guint64 dummy;
+	(void)batch;
 
-			j_object_write(j_object_uri_get_object(ouri[1]), buffer, bytes_read, offset, &dummy, batch);
+	buffer->ret = ret;
+}
 
-			if (!j_batch_execute(batch))
-			{
-				ret = FALSE;
-				goto end;
-			}
-		}
-		else if (uri[1] != NULL)
-		{
-			guint64 dummy;
+static gpointer
+j_cmd_copy_write_stream(gpointer data)
+{
+	JCmdCopyBuffer* buffer = data;
+	gsize nbytes = 0;
 
-			j_item_write(j_uri_get_item(uri[1]), buffer, bytes_read, offset, &dummy, batch);
+	buffer->ret = g_output_stream_write_all(buffer->output, buffer->data, buffer->length, &nbytes, NULL, NULL);
+	buffer->bytes_written = nbytes;
 
-			if (!j_batch_execute(batch))
-			{
-				ret = FALSE;
-				goto end;
-			}
+	return buffer;
+}
+
+/**
+ * Starts writing a buffer in the background.
+ **/
+static void
+j_cmd_copy_write(JCmdCopyEndpoint* endpoint, JCmdCopyBuffer* buffer)
+{
+	if (endpoint->stream != NULL)
+	{
+		buffer->output = g_io_stream_get_output_stream(G_IO_STREAM(endpoint->stream));
+		buffer->operation = j_background_operation_new(j_cmd_copy_write_stream, buffer);
+
+		return;
+	}
+
+	buffer->batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	if (endpoint->ouri != NULL)
+	{
+		j_object_write(j_object_uri_get_object(endpoint->ouri), buffer->data, buffer->length, buffer->offset, &buffer->bytes_written, buffer->batch);
+	}
+	else if (endpoint->uri != NULL)
+	{
+		j_item_write(j_uri_get_item(endpoint->uri), buffer->data, buffer->length, buffer->offset, &buffer->bytes_written, buffer->batch);
+	}
+
+	j_batch_execute_async(buffer->batch, j_cmd_copy_write_callback, buffer);
+}
+
+/**
+ * Waits for a buffer's pending write.
+ *
+ * \return TRUE if there was no pending write or it was successful, FALSE otherwise.
+ **/
+static gboolean
+j_cmd_copy_wait(JCmdCopyBuffer* buffer)
+{
+	gboolean ret = TRUE;
+
+	if (buffer->batch != NULL)
+	{
+		j_batch_wait(buffer->batch);
+		g_clear_pointer(&buffer->batch, j_batch_unref);
+		ret = buffer->ret;
+	}
+	else if (buffer->operation != NULL)
+	{
+		j_background_operation_wait(buffer->operation);
+		g_clear_pointer(&buffer->operation, j_background_operation_unref);
+		ret = buffer->ret;
+	}
+
+	return ret;
+}
+
+static gboolean
+j_cmd_copy_run(JCmdCopy* copy)
+{
+	JCmdCopyEndpoint endpoint[2] = { { NULL, NULL, NULL }, { NULL, NULL, NULL } };
+	JCmdCopyBuffer* buffers;
+	gboolean ret = TRUE;
+	guint64 offset = 0;
+	guint slot = 0;
+
+	buffers = g_new0(JCmdCopyBuffer, opt_buffers);
+
+	if (!j_cmd_copy_open(&endpoint[0], copy->source, FALSE) || !j_cmd_copy_open(&endpoint[1], copy->destination, TRUE))
+	{
+		ret = FALSE;
+		goto end;
+	}
+
+	for (gint i = 0; i < opt_buffers; i++)
+	{
+		buffers[i].data = g_malloc(opt_block_size);
+	}
+
+	while (TRUE)
+	{
+		JCmdCopyBuffer* buffer = &buffers[slot];
+
+		if (!j_cmd_copy_wait(buffer))
+		{
+			ret = FALSE;
+			break;
 		}
-		else if (stream[1] != NULL)
+
+		buffer->offset = offset;
+
+		if (!j_cmd_copy_read(&endpoint[0], buffer))
 		{
-			GOutputStream* output;
+			ret = FALSE;
+			break;
+		}
 
-			output = g_io_stream_get_output_stream(G_IO_STREAM(stream[1]));
+		if (buffer->length == 0)
+		{
+			break;
+		}
 
-			g_output_stream_write_all(output, buffer, bytes_read, NULL, NULL, NULL);
+		// streams are written sequentially, so only one write may be pending
+		if (endpoint[1].stream != NULL && !j_cmd_copy_wait(&buffers[(slot + opt_buffers - 1) % opt_buffers]))
+		{
+			ret = FALSE;
+			break;
 		}
 
-		offset += bytes_read;
+		j_cmd_copy_write(&endpoint[1], buffer);
+
+		offset += buffer->length;
+		j_helper_atomic_add(&j_cmd_copy_progress.bytes, buffer->length);
+		j_cmd_copy_report(FALSE);
 
-		if (bytes_read < 1024 * 1024)
+		if (buffer->length < (guint64)opt_block_size)
 		{
 			break;
 		}
+
+		slot = (slot + 1) % opt_buffers;
 	}
 
-end:
-	for (i = 0; i <= 1; i++)
+	for (gint i = 0; i < opt_buffers; i++)
 	{
-		if (stream[i] != NULL)
+		if (!j_cmd_copy_wait(&buffers[i]))
 		{
-			g_object_unref(stream[i]);
+			ret = FALSE;
 		}
 
-		if (ouri[i] != NULL)
-		{
-			j_object_uri_free(ouri[i]);
-		}
+		g_free(buffers[i].data);
+	}
+
+end:
+	j_cmd_copy_close(&endpoint[0]);
+	j_cmd_copy_close(&endpoint[1]);
+
+	g_free(buffers);
+
+	if (!ret)
+	{
+		g_print("Error: Could not copy “%s” to “%s”.\n", copy->source, copy->destination);
+	}
+
+	return ret;
+}
+
+static gpointer
+j_cmd_copy_thread(gpointer data)
+{
+	GArray* copies = data;
+
+	while (TRUE)
+	{
+		JCmdCopy* copy;
+		guint next;
 
-		if (uri[i] != NULL)
+		g_mutex_lock(&j_cmd_copy_progress.mutex);
+		next = j_cmd_copy_progress.next++;
+		g_mutex_unlock(&j_cmd_copy_progress.mutex);
+
+		if (next >= copies->len)
 		{
-			j_uri_free(uri[i]);
+			break;
 		}
+
+		copy = &g_array_index(copies, JCmdCopy, next);
+		copy->ret = j_cmd_copy_run(copy);
+	}
+
+	return NULL;
+}
+
+gboolean
+j_cmd_copy(gchar const** arguments)
+{
+	gboolean ret = TRUE;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GArray) copies = NULL;
+	g_auto(GStrv) args = NULL;
+	GThread** threads;
+	guint args_length;
+	guint threads_length;
+
+	GOptionEntry entries[] = {
+		{ "block-size", 0, 0, G_OPTION_ARG_INT64, &opt_block_size, "Number of bytes to copy at once", "4194304" },
+		{ "buffers", 0, 0, G_OPTION_ARG_INT, &opt_buffers, "Number of buffers per copy", "2" },
+		{ "jobs", 0, 0, G_OPTION_ARG_INT, &opt_jobs, "Number of copies to perform in parallel", "1" },
+		{ "progress", 0, 0, G_OPTION_ARG_NONE, &opt_progress, "Print progress and throughput", NULL },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// GOption expects the program name in front of the arguments
+	args_length = j_cmd_arguments_length(arguments);
+	args = g_new(gchar*, args_length + 2);
+	args[0] = g_strdup("copy");
+
+	for (guint i = 0; i < args_length; i++)
+	{
+		args[i + 1] = g_strdup(arguments[i]);
+	}
+
+	args[args_length + 1] = NULL;
+
+	context = g_option_context_new(NULL);
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse_strv(context, &args, &error))
+	{
+		g_print("Error: %s\n", error->message);
+		return FALSE;
+	}
+
+	args_length = g_strv_length(args) - 1;
+
+	if (args_length == 0 || args_length % 2 != 0 || opt_block_size <= 0 || opt_buffers <= 0 || opt_jobs <= 0)
+	{
+		j_cmd_usage();
+		return FALSE;
+	}
+
+	copies = g_array_new(FALSE, TRUE, sizeof(JCmdCopy));
+
+	for (guint i = 1; i < args_length; i += 2)
+	{
+		JCmdCopy copy = { args[i], args[i + 1], FALSE };
+
+		g_array_append_val(copies, copy);
+	}
+
+	g_mutex_init(&j_cmd_copy_progress.mutex);
+	j_cmd_copy_progress.start_time = g_get_monotonic_time();
+
+	threads_length = MIN((guint)opt_jobs, copies->len);
+	threads = g_new(GThread*, threads_length);
+
+	for (guint i = 0; i < threads_length; i++)
+	{
+		threads[i] = g_thread_new("julea-cli-copy", j_cmd_copy_thread, copies);
 	}
 
+	for (guint i = 0; i < threads_length; i++)
+	{
+		g_thread_join(threads[i]);
+	}
+
+	g_free(threads);
+
+	j_cmd_copy_report(TRUE);
+
+	for (guint i = 0; i < copies->len; i++)
+	{
+		ret = g_array_index(copies, JCmdCopy, i).ret && ret;
+	}
+
+	g_mutex_clear(&j_cmd_copy_progress.mutex);
+
 	return ret;
 }
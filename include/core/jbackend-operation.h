@@ -128,6 +128,7 @@ gboolean j_backend_operation_unwrap_db_insert(JBackend*, gpointer, JBackendOpera
 gboolean j_backend_operation_unwrap_db_update(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_delete(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_query(JBackend*, gpointer, JBackendOperation*);
+gboolean j_backend_operation_unwrap_db_explain(JBackend*, gpointer, JBackendOperation*);
 
 /*
  * this function is called only on the client side of the backend
@@ -271,6 +272,27 @@ static const JBackendOperation j_backend_operation_db_query = {
 	.out_param_count = 2,
 };
 
+static const JBackendOperation j_backend_operation_db_explain = {
+	.in_param = {
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_STR },
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_STR },
+		{
+			.type = J_BACKEND_OPERATION_PARAM_TYPE_BSON,
+			.bson_initialized = TRUE,
+		},
+	},
+	.out_param = {
+		{
+			.type = J_BACKEND_OPERATION_PARAM_TYPE_BSON,
+			.bson_initialized = TRUE,
+		},
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_ERROR },
+	},
+	.backend_func = j_backend_operation_unwrap_db_explain,
+	.in_param_count = 3,
+	.out_param_count = 2,
+};
+
 /**
  * @}
  **/
@@ -85,7 +85,9 @@ enum JBackendDBError
 	J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND,
 	J_BACKEND_DB_ERROR_SELECTOR_EMPTY,
 	J_BACKEND_DB_ERROR_THREADING_ERROR,
-	J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND
+	J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND,
+	// Error codes are sent to clients, new ones have to be appended
+	J_BACKEND_DB_ERROR_HANDLE_UNKNOWN
 };
 
 typedef enum JBackendDBError JBackendDBError;
@@ -381,6 +383,24 @@ struct JBackend
 			* \return TRUE on success, FALSE otherwise.
 			**/
 			gboolean (*backend_iterate)(gpointer, gpointer, bson_t*, GError**);
+
+			/**
+			* Explains how a query would be executed
+			*
+			* This function is optional.
+			*
+			* \param[in] name     Schema name (e.g., "files")
+			* \param[in] selector The selector as passed to backend_query
+			* \param[out] result  An initialized BSON that will be filled with a human-readable report
+			* \code
+			* {
+			* 	"plan": report (utf8)
+			* }
+			* \endcode
+			*
+			* \return TRUE on success, FALSE otherwise.
+			**/
+			gboolean (*backend_explain)(gpointer, gpointer, gchar const*, bson_t const*, bson_t*, GError**);
 		} db;
 	};
 };
@@ -396,6 +416,13 @@ JBackend* backend_info(void);
 gboolean j_backend_load(gchar const*, JBackendComponent, JBackendType, GModule**, JBackend**);
 gboolean j_backend_unload(JBackend*, GModule*);
 
+/**
+ * Returns the time the calling thread has spent in backend functions.
+ *
+ * \return The time in microseconds.
+ **/
+guint64 j_backend_get_thread_time(void);
+
 gboolean j_backend_object_init(JBackend*, gchar const*);
 void j_backend_object_fini(JBackend*);
 
@@ -445,6 +472,7 @@ gboolean j_backend_db_delete(JBackend*, gpointer, gchar const*, bson_t const*, G
 
 gboolean j_backend_db_query(JBackend*, gpointer, gchar const*, bson_t const*, gpointer*, GError**);
 gboolean j_backend_db_iterate(JBackend*, gpointer, bson_t*, GError**);
+gboolean j_backend_db_explain(JBackend*, gpointer, gchar const*, bson_t const*, bson_t*, GError**);
 
 G_END_DECLS
 
@@ -112,6 +112,23 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(JBackgroundOperation, j_background_operation_unref
  **/
 gpointer j_background_operation_wait(JBackgroundOperation* background_operation);
 
+/**
+ * Waits for multiple background operations to finish.
+ * The waiting thread executes pending background operations instead of blocking right away.
+ * Worker threads execute any pending background operation, other threads only the ones they are waiting for.
+ * Afterwards, the return values can be fetched using j_background_operation_wait() without blocking.
+ *
+ * \code
+ * JBackgroundOperation* background_operations[2];
+ *
+ * j_background_operation_wait_all(background_operations, 2);
+ * \endcode
+ *
+ * \param background_operations An array of background operations, which may contain NULL entries.
+ * \param length                The length of \p background_operations.
+ **/
+void j_background_operation_wait_all(JBackgroundOperation** background_operations, guint length);
+
 /**
  * @}
  **/
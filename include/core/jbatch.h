@@ -113,6 +113,8 @@ JSemantics* j_batch_get_semantics(JBatch* batch);
 
 /**
  * Adds a new operation to the batch.
+ * For automatically executed batches, the operation might be executed before this function returns.
+ * Results the operation writes to have to be initialized before adding it.
  *
  * \private
  *
@@ -124,6 +126,65 @@ JSemantics* j_batch_get_semantics(JBatch* batch);
  **/
 void j_batch_add(JBatch* batch, JOperation* operation);
 
+/**
+ * Enables automatic execution for a batch.
+ * Added operations are executed in the background as soon as one of the limits is reached.
+ * Operations are executed in the order they have been added.
+ * j_batch_execute() executes all pending operations and waits for them to finish.
+ * A limit of 0 disables the respective check.
+ * Automatic execution is only supported for batches with immediate consistency.
+ *
+ * \code
+ * JBatch* batch;
+ *
+ * batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+ * j_batch_set_auto(batch, 64, 1024 * 1024, 1000);
+ *
+ * for (guint i = 0; i < 1000; i++)
+ * {
+ *     j_kv_put(kv[i], value, value_len, NULL, batch);
+ * }
+ *
+ * j_batch_execute(batch);
+ * \endcode
+ *
+ * \param batch          A batch, which has to be empty.
+ * \param max_operations The maximum number of pending operations.
+ * \param max_bytes      The maximum amount of pending data in bytes.
+ * \param max_latency    The maximum time an operation can be pending in microseconds.
+ *
+ * \return TRUE if automatic execution has been enabled, FALSE if the batch's consistency is not immediate.
+ **/
+gboolean j_batch_set_auto(JBatch* batch, guint max_operations, guint64 max_bytes, guint64 max_latency);
+
+/**
+ * Returns a handle for the most recently added operation.
+ * For automatically executed batches, the handle can be used to wait for the operation using j_batch_wait_handle().
+ *
+ * \code
+ * \endcode
+ *
+ * \param batch A batch.
+ *
+ * \return A handle.
+ **/
+guint64 j_batch_get_handle(JBatch* batch);
+
+/**
+ * Waits for an operation of an automatically executed batch to finish.
+ * Operations are not executed earlier because of this, use j_batch_execute() for that.
+ *
+ * \code
+ * \endcode
+ *
+ * \param batch  A batch.
+ * \param handle A handle returned by j_batch_get_handle().
+ *
+ * \return TRUE if the operation and all operations before it succeeded, FALSE otherwise.
+ *         Only operations added since the last j_batch_execute() are taken into account, earlier failures have been reported by it.
+ **/
+gboolean j_batch_wait_handle(JBatch* batch, guint64 handle);
+
 /**
  * Executes the batch.
  *
@@ -108,9 +108,12 @@ gchar const* j_configuration_get_backend_path(JConfiguration*, JBackendType);
 
 guint64 j_configuration_get_max_operation_size(JConfiguration*);
 guint64 j_configuration_get_max_inject_size(JConfiguration*);
+guint64 j_configuration_get_zerocopy_size(JConfiguration*);
 guint16 j_configuration_get_port(JConfiguration*);
 
 guint32 j_configuration_get_max_connections(JConfiguration*);
+guint32 j_configuration_get_min_connections(JConfiguration*);
+guint32 j_configuration_get_idle_timeout(JConfiguration*);
 guint64 j_configuration_get_stripe_size(JConfiguration*);
 
 gchar const* j_configuration_get_checksum(JConfiguration*);
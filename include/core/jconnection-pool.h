@@ -42,8 +42,95 @@ G_BEGIN_DECLS
  * @{
  **/
 
-gpointer j_connection_pool_pop(JBackendType, guint32);
-void j_connection_pool_push(JBackendType, guint32, gpointer);
+/**
+ * Statistics collected per server.
+ **/
+enum JConnectionPoolStatistics
+{
+	/**
+	 * Connections that were taken from the pool.
+	 **/
+	J_CONNECTION_POOL_HITS,
+
+	/**
+	 * Connections that had to be established.
+	 **/
+	J_CONNECTION_POOL_MISSES,
+
+	/**
+	 * Requests that had to wait for a connection.
+	 **/
+	J_CONNECTION_POOL_WAITS,
+
+	/**
+	 * The time spent waiting for connections in microseconds.
+	 **/
+	J_CONNECTION_POOL_WAIT_TIME,
+
+	/**
+	 * Failed connection attempts.
+	 **/
+	J_CONNECTION_POOL_FAILURES,
+
+	/**
+	 * Broken connections that have been replaced.
+	 **/
+	J_CONNECTION_POOL_BROKEN,
+
+	/**
+	 * Connections that have been closed because they were idle.
+	 **/
+	J_CONNECTION_POOL_IDLE_CLOSED,
+
+	/**
+	 * The number of currently open connections.
+	 **/
+	J_CONNECTION_POOL_CONNECTIONS
+};
+
+typedef enum JConnectionPoolStatistics JConnectionPoolStatistics;
+
+/**
+ * Returns a connection to a server.
+ * Idle connections are checked before being returned and replaced if they are broken.
+ * If the maximum number of connections has been reached, waits for a connection to be returned.
+ *
+ * \code
+ * \endcode
+ *
+ * \param backend A backend type.
+ * \param index   A server index.
+ *
+ * \return A connection, NULL if no connection could be established.
+ **/
+gpointer j_connection_pool_pop(JBackendType backend, guint32 index);
+
+/**
+ * Returns a connection to the pool.
+ * Connections that have been idle for longer than the configured timeout are closed.
+ *
+ * \code
+ * \endcode
+ *
+ * \param backend    A backend type.
+ * \param index      A server index.
+ * \param connection A connection.
+ **/
+void j_connection_pool_push(JBackendType backend, guint32 index, gpointer connection);
+
+/**
+ * Returns a connection pool statistic for a server.
+ *
+ * \code
+ * \endcode
+ *
+ * \param backend A backend type.
+ * \param index   A server index.
+ * \param type    A statistic type.
+ *
+ * \return The statistic's value.
+ **/
+guint64 j_connection_pool_get_statistics(JBackendType backend, guint32 index, JConnectionPoolStatistics type);
 
 /**
  * @}
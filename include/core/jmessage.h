@@ -38,6 +38,16 @@ G_BEGIN_DECLS
  * @{
  **/
 
+/**
+ * The newest supported protocol version.
+ *
+ * Version 1 uses 32-bit message lengths.
+ * Version 2 uses 64-bit message lengths and lets servers stream large object operations.
+ * Version 3 adds a trace context to the header.
+ * It is negotiated using J_MESSAGE_PING.
+ **/
+#define J_MESSAGE_VERSION 3
+
 enum JMessageType
 {
 	J_MESSAGE_NONE,
@@ -62,7 +72,8 @@ enum JMessageType
 	J_MESSAGE_DB_INSERT,
 	J_MESSAGE_DB_UPDATE,
 	J_MESSAGE_DB_DELETE,
-	J_MESSAGE_DB_QUERY
+	J_MESSAGE_DB_QUERY,
+	J_MESSAGE_DB_EXPLAIN
 };
 
 typedef enum JMessageType JMessageType;
@@ -154,6 +165,46 @@ JMessageType j_message_get_type(JMessage const* message);
  **/
 guint32 j_message_get_count(JMessage const* message);
 
+/**
+ * Returns a message's length.
+ * This does not include the header and the additional data to send.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message A message.
+ *
+ * \return The message's length.
+ **/
+guint64 j_message_get_length(JMessage const* message);
+
+/**
+ * Returns a message's trace ID.
+ * New messages use the current thread's correlation ID, replies inherit it from their request.
+ * The trace context is only transmitted with protocol version 3 and later.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message A message.
+ *
+ * \return The trace ID or 0 if the message is not traced.
+ **/
+guint64 j_message_get_trace_id(JMessage const* message);
+
+/**
+ * Returns a message's span ID.
+ * Requests get a new span each time they are sent, replies inherit it from their request.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message A message.
+ *
+ * \return The span ID or 0 if the message is not traced.
+ **/
+guint64 j_message_get_span_id(JMessage const* message);
+
 /**
  * Appends 1 byte to a message.
  *
@@ -317,8 +368,45 @@ gboolean j_message_send(JMessage* message, gpointer stream);
  **/
 gboolean j_message_receive(JMessage* message, gpointer stream);
 
+/**
+ * Returns the protocol version used on a connection.
+ *
+ * \code
+ * \endcode
+ *
+ * \param connection A connection.
+ *
+ * \return The protocol version, 1 if none has been negotiated.
+ **/
+guint32 j_message_get_version(gpointer connection);
+
+/**
+ * Sets the protocol version used on a connection.
+ * Both sides have to switch after negotiating the version using J_MESSAGE_PING.
+ *
+ * \code
+ * \endcode
+ *
+ * \param connection A connection.
+ * \param version    A protocol version.
+ **/
+void j_message_set_version(gpointer connection, guint32 version);
+
+/**
+ * Sets the minimum payload size for zero-copy transmission on a connection.
+ * Overrides the configured zero-copy size, 0 disables zero-copy transmission.
+ *
+ * \code
+ * \endcode
+ *
+ * \param connection    A connection.
+ * \param zerocopy_size A size in bytes.
+ **/
+void j_message_set_zerocopy_size(gpointer connection, guint64 zerocopy_size);
+
 /**
  * Reads a message from the network.
+ * Streams always use protocol version 1.
  *
  * \code
  * \endcode
@@ -332,6 +420,7 @@ gboolean j_message_read(JMessage* message, GInputStream* stream);
 
 /**
  * Writes a message to the network.
+ * Streams always use protocol version 1.
  *
  * \code
  * \endcode
@@ -366,6 +455,19 @@ void j_message_add_send(JMessage* message, gconstpointer data, guint64 length);
  **/
 void j_message_add_operation(JMessage* message, gsize length);
 
+/**
+ * Reserves space in a message.
+ * Appending up to length bytes afterwards does not require reallocating the message's buffer.
+ * This is useful for batches whose operations are known in advance.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message A message.
+ * \param length  A length.
+ **/
+void j_message_reserve(JMessage* message, gsize length);
+
 /**
  * Set the semantics of a message.
  *
@@ -53,6 +53,12 @@ struct JOperation
 
 	JOperationExecFunc exec_func;
 	JOperationFreeFunc free_func;
+
+	/**
+	 * The amount of data transferred by the operation.
+	 * Used to decide when automatically executed batches are executed.
+	 **/
+	guint64 size;
 };
 
 typedef struct JOperation JOperation;
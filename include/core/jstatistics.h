@@ -29,6 +29,8 @@
 
 #include <glib.h>
 
+#include <core/jmessage.h>
+
 G_BEGIN_DECLS
 
 /**
@@ -51,6 +53,30 @@ enum JStatisticsType
 
 typedef enum JStatisticsType JStatisticsType;
 
+/**
+ * The parts of an operation's latency.
+ **/
+enum JStatisticsLatency
+{
+	/**
+	 * The time spent in the server, excluding the backend.
+	 **/
+	J_STATISTICS_LATENCY_SERVER,
+
+	/**
+	 * The time spent in the backend.
+	 **/
+	J_STATISTICS_LATENCY_BACKEND
+};
+
+typedef enum JStatisticsLatency JStatisticsLatency;
+
+/**
+ * The number of buckets of a latency histogram.
+ * Each power of two is split into four buckets, covering latencies of up to 38 hours in microseconds.
+ **/
+#define J_STATISTICS_LATENCY_BUCKETS 144
+
 struct JStatistics;
 
 typedef struct JStatistics JStatistics;
@@ -114,6 +140,171 @@ guint64 j_statistics_get(JStatistics* statistics, JStatisticsType type);
  **/
 void j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value);
 
+/**
+ * Adds another statistics to a statistics.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param other      Another statistics.
+ **/
+void j_statistics_merge(JStatistics* statistics, JStatistics* other);
+
+/**
+ * Records a handled operation.
+ * Only the thread owning the statistics may record operations, but all threads may read them concurrently.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics   A statistics.
+ * \param type         The operation's message type.
+ * \param bytes        The number of bytes transferred.
+ * \param server_time  The time spent in the server, excluding the backend, in microseconds.
+ * \param backend_time The time spent in the backend, in microseconds.
+ **/
+void j_statistics_add_operation(JStatistics* statistics, JMessageType type, guint64 bytes, guint64 server_time, guint64 backend_time);
+
+/**
+ * Returns the name of an operation.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param type A message type.
+ *
+ * \return The name.
+ **/
+gchar const* j_statistics_get_operation_name(JMessageType type);
+
+/**
+ * Returns the number of handled operations.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ *
+ * \return The number of operations.
+ **/
+guint64 j_statistics_get_operations(JStatistics* statistics, JMessageType type);
+
+/**
+ * Returns the number of bytes transferred by operations.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ *
+ * \return The number of bytes.
+ **/
+guint64 j_statistics_get_operation_bytes(JStatistics* statistics, JMessageType type);
+
+/**
+ * Returns the total latency of operations.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param latency    A latency part.
+ *
+ * \return The latency in microseconds.
+ **/
+guint64 j_statistics_get_latency_sum(JStatistics* statistics, JMessageType type, JStatisticsLatency latency);
+
+/**
+ * Returns the number of operations within a latency histogram bucket.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param latency    A latency part.
+ * \param bucket     A bucket, smaller than J_STATISTICS_LATENCY_BUCKETS.
+ *
+ * \return The number of operations.
+ **/
+guint64 j_statistics_get_latency_bucket(JStatistics* statistics, JMessageType type, JStatisticsLatency latency, guint bucket);
+
+/**
+ * Returns the exclusive upper bound of a latency histogram bucket.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param bucket A bucket, smaller than J_STATISTICS_LATENCY_BUCKETS.
+ *
+ * \return The bound in microseconds.
+ **/
+guint64 j_statistics_get_latency_bucket_bound(guint bucket);
+
+/**
+ * Returns a latency percentile.
+ * The result is the upper bound of the histogram bucket containing the percentile.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param latency    A latency part.
+ * \param percentile A percentile between 0 and 100.
+ *
+ * \return The latency in microseconds.
+ **/
+guint64 j_statistics_get_latency_percentile(JStatistics* statistics, JMessageType type, JStatisticsLatency latency, gdouble percentile);
+
+/**
+ * Appends the operation statistics to a message as a new operation.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param message    A message.
+ **/
+void j_statistics_serialize_operations(JStatistics* statistics, JMessage* message);
+
+/**
+ * Adds operation statistics read from a message.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param message    A message.
+ **/
+void j_statistics_deserialize_operations(JStatistics* statistics, JMessage* message);
+
 /**
  * @}
  **/
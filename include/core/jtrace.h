@@ -55,6 +55,18 @@ enum JTraceFileOperation
 
 typedef enum JTraceFileOperation JTraceFileOperation;
 
+/**
+ * Phases of a flow that connects events across threads and processes.
+ **/
+enum JTraceFlow
+{
+	J_TRACE_FLOW_BEGIN,
+	J_TRACE_FLOW_STEP,
+	J_TRACE_FLOW_END
+};
+
+typedef enum JTraceFlow JTraceFlow;
+
 struct JTrace;
 
 typedef struct JTrace JTrace;
@@ -63,7 +75,7 @@ typedef struct JTrace JTrace;
  * Initializes the trace framework.
  * Tracing is disabled by default.
  * Set the \c J_TRACE environment variable to enable it.
- * Valid values are \e echo and \e otf.
+ * Valid values are \e echo, \e otf, \e summary and \e binary.
  * Multiple values can be combined with commas.
  *
  * \code
@@ -85,6 +97,7 @@ void j_trace_fini(void);
 
 /**
  * Traces the entering of a function.
+ * When using binary tracing, names are cached by their address and should therefore not be modified.
  *
  * \code
  * \endcode
@@ -159,6 +172,80 @@ void j_trace_file_end(gchar const* path, JTraceFileOperation op, guint64 length,
  **/
 void j_trace_counter(gchar const* name, guint64 counter_value);
 
+/**
+ * Creates a new correlation ID.
+ * Correlation IDs are random and can be used to match traces of different processes.
+ *
+ * \code
+ * \endcode
+ *
+ * \return A new correlation ID or 0 if tracing is disabled.
+ **/
+guint64 j_trace_correlation_new(void);
+
+/**
+ * Returns the current thread's correlation ID.
+ *
+ * \code
+ * \endcode
+ *
+ * \return The correlation ID or 0 if none is set.
+ **/
+guint64 j_trace_get_correlation(void);
+
+/**
+ * Sets the current thread's correlation ID.
+ * All subsequent trace events of the thread are tagged with it.
+ *
+ * \code
+ * guint64 correlation;
+ *
+ * correlation = j_trace_get_correlation();
+ * j_trace_set_correlation(j_trace_correlation_new());
+ * ...
+ * j_trace_set_correlation(correlation);
+ * \endcode
+ *
+ * \param correlation A correlation ID or 0 to unset it.
+ **/
+void j_trace_set_correlation(guint64 correlation);
+
+/**
+ * Returns the current thread's span ID.
+ *
+ * \code
+ * \endcode
+ *
+ * \return The span ID or 0 if none is set.
+ **/
+guint64 j_trace_get_span(void);
+
+/**
+ * Sets the current thread's span ID.
+ * Subsequently entered functions are recorded as children of the span.
+ * Together with the correlation ID, it forms the trace context that is transmitted in message headers.
+ *
+ * \code
+ * \endcode
+ *
+ * \param span A span ID or 0 to unset it.
+ **/
+void j_trace_set_span(guint64 span);
+
+/**
+ * Traces a phase of a flow.
+ * A flow begins in one thread and can be continued in other threads or processes using the same ID.
+ *
+ * \code
+ * j_trace_flow("object_write", J_TRACE_FLOW_BEGIN, span);
+ * \endcode
+ *
+ * \param name A flow name.
+ * \param flow The flow phase.
+ * \param id   A flow ID, usually a span ID.
+ **/
+void j_trace_flow(gchar const* name, JTraceFlow flow, guint64 id);
+
 /**
  * @}
  **/
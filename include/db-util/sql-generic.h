@@ -78,5 +78,6 @@ gboolean sql_generic_update(gpointer backend_data, gpointer _batch, gchar const*
 gboolean sql_generic_delete(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, GError** error);
 gboolean sql_generic_query(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, gpointer* iterator, GError** error);
 gboolean sql_generic_iterate(gpointer backend_data, gpointer _iterator, bson_t* metadata, GError** error);
+gboolean sql_generic_explain(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t* result, GError** error);
 
 #endif
@@ -47,7 +47,8 @@ enum JDBError
 	J_DB_ERROR_SELECTOR_TOO_COMPLEX,
 	J_DB_ERROR_TYPE_INVALID,
 	J_DB_ERROR_VARIABLE_ALREADY_SET,
-	J_DB_ERROR_VARIABLE_NOT_FOUND
+	J_DB_ERROR_VARIABLE_NOT_FOUND,
+	J_DB_ERROR_PARAMETER_NOT_BOUND
 };
 
 typedef enum JDBError JDBError;
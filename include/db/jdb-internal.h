@@ -85,6 +85,13 @@ struct JDBSchema
 	gchar* namespace;
 	gchar* name;
 
+	/**
+	 * The version of the client-side schema cache entry this schema was filled from.
+	 *
+	 * It is 0 if the schema has not been served from the cache.
+	 */
+	guint64 cache_version;
+
 	guint bson_index_count;
 	gint ref_count;
 
@@ -117,6 +124,25 @@ struct JDBSelector
 
 	GHashTable* join_schema; /// Stores the names of joined schemas. It is used as a set and all values are NULL.
 
+	gboolean aggregated; /// TRUE iff the selector computes an aggregate.
+	JDBAggregate aggregate; /// The aggregate function.
+	gchar* aggregate_field; /// The aggregated field or NULL to count entries.
+	gchar* aggregate_group; /// The field to group by or NULL.
+
+	GArray* parameters; /// The types (JDBType) of the parameters in the order they were added.
+	GPtrArray* arguments; /// The values bound to the parameters (JDBTypeValue*). NULL if a parameter is not bound.
+
+	/**
+	 * The selector without the bound values.
+	 *
+	 * Only used if the selector contains parameters.
+	 */
+	bson_t template;
+
+	gboolean template_valid; /// TRUE iff template got built and the selector was not modified, binding values does not modify the template.
+	guint64 handle; /// Identifies the template on the server.
+	gboolean registered; /// TRUE iff the server knows the template, so it does not need to be sent again.
+
 	guint selection_count; /// The number of selecotr entries must not exceed 500.
 	gint ref_count;
 };
@@ -130,6 +156,7 @@ gboolean j_db_internal_update(JDBEntry* j_db_entry, JDBSelector* j_db_selector,
 gboolean j_db_internal_delete(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* batch, GError** error);
 gboolean j_db_internal_query(JDBSchema* j_db_schema, JDBSelector* j_db_selector, JDBIterator* j_db_iterator, JBatch* batch, GError** error);
 gboolean j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error);
+gboolean j_db_internal_explain(JDBSelector* j_db_selector, gchar** plan, JBatch* batch, GError** error);
 
 // Client-side additional internal functions
 
@@ -149,6 +176,7 @@ bson_t* j_db_selector_get_bson(JDBSelector* selector);
  *
  * Appends the "t" and "j" section if joins are present.
  * In any case the "s" section will be created.
+ * Selectors containing parameters additionally get the "h" and "p" sections, the other sections are omitted if the server already knows the template.
  *
  * \param selector a pointer of type JDBSelector.
  *
@@ -162,6 +190,38 @@ gboolean j_db_selector_finalize(JDBSelector* selector, GError** error);
 
 G_GNUC_INTERNAL JBackend* j_db_get_backend(void);
 
+// Client-side schema cache
+
+/**
+ * \brief Fill a schema from the process-wide schema cache.
+ *
+ * \param schema A schema that has not been fetched yet.
+ *
+ * \return TRUE if the schema was found in the cache, FALSE otherwise.
+ */
+G_GNUC_INTERNAL gboolean j_db_schema_cache_lookup(JDBSchema* schema);
+
+/**
+ * \brief Store a schema fetched from the backend in the process-wide schema cache.
+ *
+ * \param schema A schema that has been fetched from the backend.
+ */
+G_GNUC_INTERNAL void j_db_schema_cache_insert(JDBSchema* schema);
+
+/**
+ * \brief Remove a schema from the process-wide schema cache.
+ *
+ * \param namespace The namespace of the schema.
+ * \param name The name of the schema.
+ * \param version Only remove the entry if it still has this version. 0 removes the entry unconditionally.
+ */
+G_GNUC_INTERNAL void j_db_schema_cache_invalidate(gchar const* namespace, gchar const* name, guint64 version);
+
+/**
+ * \brief Free the process-wide schema cache.
+ */
+G_GNUC_INTERNAL void j_db_schema_cache_fini(void);
+
 G_END_DECLS
 
 #endif
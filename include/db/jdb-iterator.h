@@ -109,6 +109,25 @@ gboolean j_db_iterator_next(JDBIterator* iterator, GError** error);
  **/
 gboolean j_db_iterator_get_field(JDBIterator* iterator, JDBSchema* schema, gchar const* name, JDBType* type, gpointer* value, guint64* length, GError** error);
 
+/**
+ * Get the aggregate from the current entry of the iterator.
+ *
+ * \param[in] iterator The iterator to query. Its selector must have been set up using j_db_selector_set_aggregate.
+ * \param[out] type The type of the retrieved value.
+ * \param[out] value The retieved value.
+ * \param[out] length The length of the retrieved value.
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre iterator != NULL
+ * \pre type != NULL
+ * \pre value != NULL
+ * \pre length != NULL
+ * \post *value points to a new allocated memory region. The caller must free this later using g_free.
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_iterator_get_aggregate(JDBIterator* iterator, JDBType* type, gpointer* value, guint64* length, GError** error);
+
 G_END_DECLS
 
 #endif
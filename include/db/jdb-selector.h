@@ -57,6 +57,22 @@ enum JDBSelectorOperator
 
 typedef enum JDBSelectorOperator JDBSelectorOperator;
 
+enum JDBAggregate
+{
+	// COUNT
+	J_DB_AGGREGATE_COUNT,
+	// MIN
+	J_DB_AGGREGATE_MIN,
+	// MAX
+	J_DB_AGGREGATE_MAX,
+	// SUM
+	J_DB_AGGREGATE_SUM,
+	// AVG
+	J_DB_AGGREGATE_AVG
+};
+
+typedef enum JDBAggregate JDBAggregate;
+
 struct JDBSelector;
 
 typedef struct JDBSelector JDBSelector;
@@ -121,6 +137,49 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(JDBSelector, j_db_selector_unref)
  **/
 gboolean j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, gconstpointer value, guint64 length, GError** error);
 
+/**
+ * Add a search field whose value is bound later to the selector.
+ *
+ * Selectors containing parameters are prepared: The selector without the bound values is sent to the server only once and referred to by a handle afterwards.
+ * The server reuses the plan and the statement of the selector, so executing the selector repeatedly with different values is cheap.
+ * Parameters are numbered in the order they are added, starting with 0.
+ *
+ * \param[in] selector to add a search field to
+ * \param[in] name the name of the field to compare
+ * \param[in] operator_ the operator to use to compare the stored value with the bound value
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre selector != NULL
+ * \pre name != NULL
+ * \pre name must exist in the schema
+ * \pre selector including all previously added sub_selectors must not contain more than 500 search fields after applying this operation
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_selector_add_parameter(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, GError** error);
+
+/**
+ * Bind a value to a parameter of the selector.
+ *
+ * All parameters have to be bound before the selector is used.
+ * Values stay bound until they are replaced by binding a new value.
+ *
+ * \param[in] selector the selector
+ * \param[in] index the number of the parameter
+ * \param[in] value the value to compare with
+ * \param[in] length the length of the value. Only used if value is binary
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre selector != NULL
+ * \pre index must refer to a parameter added by j_db_selector_add_parameter
+ * \pre value != NULL
+ * \pre operations using the selector must have been executed before binding new values
+ * \post the value may be freed or modified by the caller immediately after calling this function
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_selector_bind(JDBSelector* selector, guint32 index, gconstpointer value, guint64 length, GError** error);
+
 /**
  * \brief Add a second selector as sub selector.
  *
@@ -134,6 +193,7 @@ gboolean j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSe
  * \pre selector != NULL
  * \pre sub_selector != NULL
  * \pre selector != sub_selector
+ * \pre sub_selector must not contain parameters
  * \pre selector including all previously added sub_selectors must not contain more than 500 search fields after applying this operation
  *
  * \return TRUE on success, FALSE otherwise
@@ -154,6 +214,7 @@ gboolean j_db_selector_add_selector(JDBSelector* selector, JDBSelector* sub_sele
  * \pre selector != NULL
  * \pre sub_selector != NULL
  * \pre selector != sub_selector
+ * \pre sub_selector must not contain parameters
  * \pre selector including all previously added sub_selectors must not contain more than 500 search fields after applying this operation
  *
  * \return TRUE on success, FALSE otherwise
@@ -161,6 +222,51 @@ gboolean j_db_selector_add_selector(JDBSelector* selector, JDBSelector* sub_sele
 
 gboolean j_db_selector_add_join(JDBSelector* selector, gchar const* selector_field, JDBSelector* sub_selector, gchar const* sub_selector_field, GError** error);
 
+/**
+ * Aggregate the entries matched by the selector instead of returning them.
+ *
+ * The aggregate is computed by the server, an iterator created with this selector returns one entry per group.
+ * Its value can be retrieved using j_db_iterator_get_aggregate, the value of the group field using j_db_iterator_get_field.
+ * Groups are returned in ascending order of the group field.
+ * If group_by is NULL, exactly one entry is returned, even if no entries match.
+ * Fields that are not set are ignored; the aggregates of an empty set (except COUNT) are returned as 0 or NULL.
+ *
+ * The result type is J_DB_TYPE_UINT64 for COUNT and J_DB_TYPE_FLOAT64 for AVG.
+ * SUM returns J_DB_TYPE_SINT64, J_DB_TYPE_UINT64 or J_DB_TYPE_FLOAT64 depending on the field type, MIN and MAX return the field type.
+ *
+ * \param[in] selector The selector to aggregate.
+ * \param[in] aggregate The aggregate function.
+ * \param[in] field The field to aggregate. May be NULL for J_DB_AGGREGATE_COUNT to count entries.
+ * \param[in] group_by The field to group by or NULL.
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre selector != NULL
+ * \pre field != NULL || aggregate == J_DB_AGGREGATE_COUNT
+ * \pre SUM and AVG require a numeric field, MIN and MAX must not be used on blobs
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_selector_set_aggregate(JDBSelector* selector, JDBAggregate aggregate, gchar const* field, gchar const* group_by, GError** error);
+
+/**
+ * Explain how the query described by the selector would be executed.
+ *
+ * The report lists the tables in join order, whether an index can be used for each of them and the normalized condition.
+ * It is meant to help diagnosing slow queries; its format is not stable and should not be parsed.
+ *
+ * \param[in] selector The selector to explain.
+ * \param[out] plan Will point to the report after the batch has been executed. Must be freed using g_free.
+ * \param[in] batch The batch to add the operation to.
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre selector != NULL
+ * \pre plan != NULL
+ * \pre batch != NULL
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_selector_explain(JDBSelector* selector, gchar** plan, JBatch* batch, GError** error);
+
 G_END_DECLS
 
 #endif
@@ -37,6 +37,8 @@ G_BEGIN_DECLS
 
 void j_hdf5_set_semantics(JSemantics*);
 
+herr_t j_hdf5_dataset_select_range(hid_t, hid_t, gdouble, gdouble);
+
 G_END_DECLS
 
 #endif
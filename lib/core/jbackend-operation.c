@@ -26,6 +26,8 @@
 #include <glib.h>
 #include <gmodule.h>
 
+#include <string.h>
+
 #include <jbackend-operation.h>
 
 #include <jtrace.h>
@@ -36,6 +38,202 @@
  * @{
  **/
 
+/**
+ * The maximum number of prepared selector templates kept by j_backend_operation_resolve_selector.
+ **/
+#define J_BACKEND_OPERATION_TEMPLATES_MAX 1024
+
+/**
+ * A prepared selector template.
+ **/
+struct JBackendOperationTemplate
+{
+	/**
+	 * The key in j_backend_operation_templates.
+	 **/
+	gchar* key;
+
+	bson_t* template;
+
+	/**
+	 * The template's position in j_backend_operation_templates_lru.
+	 **/
+	GList link;
+};
+
+typedef struct JBackendOperationTemplate JBackendOperationTemplate;
+
+/**
+ * Prepared selector templates.
+ *
+ * (namespace, schema, handle) -> JBackendOperationTemplate
+ * The templates are shared by all threads because clients may use any connection to refer to a template.
+ * The handle is only unique per schema, so the namespace and schema are part of the key.
+ **/
+static GHashTable* j_backend_operation_templates = NULL;
+
+/**
+ * The templates ordered by their last use, the most recently used one first.
+ **/
+static GQueue j_backend_operation_templates_lru = G_QUEUE_INIT;
+
+G_LOCK_DEFINE_STATIC(j_backend_operation_templates);
+
+static void
+j_backend_operation_template_free(gpointer data)
+{
+	JBackendOperationTemplate* template = data;
+
+	bson_destroy(template->template);
+	g_free(template->key);
+	g_free(template);
+}
+
+static gchar*
+j_backend_operation_template_key(gchar const* namespace, gchar const* name, gint64 handle)
+{
+	// Prefix the namespace's length to keep the key unambiguous
+	return g_strdup_printf("%" G_GSIZE_FORMAT ":%s:%s:%" G_GINT64_MODIFIER "x", strlen(namespace), namespace, name, handle);
+}
+
+/**
+ * Remembers a template, evicting the least recently used one if necessary.
+ * Has to be called with j_backend_operation_templates locked.
+ *
+ * \param key      The template's key, ownership is transferred.
+ * \param template The template, ownership is transferred.
+ **/
+static void
+j_backend_operation_template_insert(gchar* key, bson_t* template)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackendOperationTemplate* entry;
+
+	if (j_backend_operation_templates == NULL)
+	{
+		j_backend_operation_templates = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, j_backend_operation_template_free);
+	}
+
+	if ((entry = g_hash_table_lookup(j_backend_operation_templates, key)) != NULL)
+	{
+		if (!bson_equal(entry->template, template))
+		{
+			g_warning("Prepared selector %s has been registered with a different template.", key);
+		}
+
+		bson_destroy(entry->template);
+		entry->template = template;
+		g_free(key);
+
+		g_queue_unlink(&j_backend_operation_templates_lru, &(entry->link));
+		g_queue_push_head_link(&j_backend_operation_templates_lru, &(entry->link));
+
+		return;
+	}
+
+	// Clients send their templates again if the handle is unknown
+	while (g_hash_table_size(j_backend_operation_templates) >= J_BACKEND_OPERATION_TEMPLATES_MAX)
+	{
+		GList* oldest;
+
+		oldest = g_queue_pop_tail_link(&j_backend_operation_templates_lru);
+		g_hash_table_remove(j_backend_operation_templates, ((JBackendOperationTemplate*)oldest->data)->key);
+	}
+
+	entry = g_new(JBackendOperationTemplate, 1);
+	entry->key = key;
+	entry->template = template;
+	entry->link.data = entry;
+	entry->link.prev = NULL;
+	entry->link.next = NULL;
+
+	g_hash_table_insert(j_backend_operation_templates, entry->key, entry);
+	g_queue_push_head_link(&j_backend_operation_templates_lru, &(entry->link));
+}
+
+/**
+ * Resolves a prepared selector.
+ *
+ * Prepared selectors contain a handle ("h") and the bound values of their parameters ("p").
+ * The template is only included if the client cannot be sure that it is already known, it is remembered in that case.
+ * Otherwise, the template is looked up and combined with the bound values.
+ *
+ * \param namespace The namespace of the schema.
+ * \param name The name of the schema.
+ * \param selector The selector sent by the client. May be NULL.
+ * \param resolved An uninitialized BSON document. It is initialized iff it is returned.
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \return The selector to pass to the backend. NULL if the template is unknown.
+ **/
+static bson_t const*
+j_backend_operation_resolve_selector(gchar const* namespace, gchar const* name, bson_t const* selector, bson_t* resolved, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackendOperationTemplate* entry;
+	g_autofree gchar* key = NULL;
+	bson_iter_t iter;
+	gint64 handle;
+	gboolean found = FALSE;
+
+	if (selector == NULL || !bson_iter_init_find(&iter, selector, "h"))
+	{
+		return selector;
+	}
+
+	if (G_UNLIKELY(!BSON_ITER_HOLDS_INT64(&iter)))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_HANDLE_UNKNOWN, "handle invalid");
+		return NULL;
+	}
+
+	handle = bson_iter_int64(&iter);
+	key = j_backend_operation_template_key(namespace, name, handle);
+
+	if (bson_has_field(selector, "s"))
+	{
+		bson_t* template;
+
+		template = bson_new();
+		bson_copy_to_excluding_noinit(selector, template, "p", NULL);
+
+		G_LOCK(j_backend_operation_templates);
+		j_backend_operation_template_insert(g_steal_pointer(&key), template);
+		G_UNLOCK(j_backend_operation_templates);
+
+		return selector;
+	}
+
+	G_LOCK(j_backend_operation_templates);
+
+	if (j_backend_operation_templates != NULL && (entry = g_hash_table_lookup(j_backend_operation_templates, key)) != NULL)
+	{
+		bson_copy_to(entry->template, resolved);
+
+		g_queue_unlink(&j_backend_operation_templates_lru, &(entry->link));
+		g_queue_push_head_link(&j_backend_operation_templates_lru, &(entry->link));
+
+		found = TRUE;
+	}
+
+	G_UNLOCK(j_backend_operation_templates);
+
+	if (!found)
+	{
+		g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_HANDLE_UNKNOWN, "handle %" G_GINT64_MODIFIER "x unknown", handle);
+		return NULL;
+	}
+
+	if (bson_iter_init_find(&iter, selector, "p"))
+	{
+		bson_append_iter(resolved, "p", -1, &iter);
+	}
+
+	return resolved;
+}
+
 gboolean
 j_backend_operation_unwrap_db_schema_create(JBackend* backend, gpointer batch, JBackendOperation* data)
 {
@@ -87,7 +285,23 @@ j_backend_operation_unwrap_db_update(JBackend* backend, gpointer batch, JBackend
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_update(backend, batch, data->in_param[1].ptr, data->in_param[2].ptr, data->in_param[3].ptr, data->out_param[0].ptr);
+	gboolean ret;
+	bson_t resolved;
+	bson_t const* selector;
+
+	if ((selector = j_backend_operation_resolve_selector(data->in_param[0].ptr, data->in_param[1].ptr, data->in_param[2].ptr, &resolved, data->out_param[0].ptr)) == NULL)
+	{
+		return FALSE;
+	}
+
+	ret = j_backend_db_update(backend, batch, data->in_param[1].ptr, selector, data->in_param[3].ptr, data->out_param[0].ptr);
+
+	if (selector == &resolved)
+	{
+		bson_destroy(&resolved);
+	}
+
+	return ret;
 }
 
 gboolean
@@ -95,7 +309,23 @@ j_backend_operation_unwrap_db_delete(JBackend* backend, gpointer batch, JBackend
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_delete(backend, batch, data->in_param[1].ptr, data->in_param[2].ptr, data->out_param[0].ptr);
+	gboolean ret;
+	bson_t resolved;
+	bson_t const* selector = data->in_param[2].ptr;
+
+	if (selector != NULL && (selector = j_backend_operation_resolve_selector(data->in_param[0].ptr, data->in_param[1].ptr, selector, &resolved, data->out_param[0].ptr)) == NULL)
+	{
+		return FALSE;
+	}
+
+	ret = j_backend_db_delete(backend, batch, data->in_param[1].ptr, selector, data->out_param[0].ptr);
+
+	if (selector == &resolved)
+	{
+		bson_destroy(&resolved);
+	}
+
+	return ret;
 }
 
 /// \todo clean up
@@ -112,9 +342,18 @@ j_backend_operation_unwrap_db_query(JBackend* backend, gpointer batch, JBackendO
 	const char* key;
 	bson_t* bson = data->out_param[0].ptr;
 	bson_t tmp[1];
+	bson_t resolved;
+	// the selector has to stay valid while iterating because backends may refer to its values
+	bson_t const* selector = data->in_param[2].ptr;
 
 	bson_init(bson);
-	ret = j_backend_db_query(backend, batch, data->in_param[1].ptr, data->in_param[2].ptr, &iter, data->out_param[1].ptr);
+
+	if (selector != NULL && (selector = j_backend_operation_resolve_selector(data->in_param[0].ptr, data->in_param[1].ptr, selector, &resolved, data->out_param[1].ptr)) == NULL)
+	{
+		goto _error;
+	}
+
+	ret = j_backend_db_query(backend, batch, data->in_param[1].ptr, selector, &iter, data->out_param[1].ptr);
 	if (!ret)
 	{
 		goto _error;
@@ -138,8 +377,55 @@ j_backend_operation_unwrap_db_query(JBackend* backend, gpointer batch, JBackendO
 		g_error_free(*error);
 		*error = NULL;
 	}
+	if (selector == &resolved)
+	{
+		bson_destroy(&resolved);
+	}
+	return TRUE;
+_error:
+	if (selector == &resolved)
+	{
+		bson_destroy(&resolved);
+	}
+	return FALSE;
+}
+
+gboolean
+j_backend_operation_unwrap_db_explain(JBackend* backend, gpointer batch, JBackendOperation* data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_t* bson = data->out_param[0].ptr;
+	bson_t resolved;
+	bson_t const* selector = data->in_param[2].ptr;
+	gboolean ret;
+
+	bson_init(bson);
+
+	if (selector != NULL && (selector = j_backend_operation_resolve_selector(data->in_param[0].ptr, data->in_param[1].ptr, selector, &resolved, data->out_param[1].ptr)) == NULL)
+	{
+		goto _error;
+	}
+
+	ret = j_backend_db_explain(backend, batch, data->in_param[1].ptr, selector, data->out_param[0].ptr, data->out_param[1].ptr);
+
+	if (selector == &resolved)
+	{
+		bson_destroy(&resolved);
+	}
+
+	if (!ret)
+	{
+		goto _error;
+	}
+
 	return TRUE;
+
 _error:
+	bson_destroy(bson);
+	// the client uses a zeroed BSON to detect failed operations
+	memset(bson, 0, sizeof(bson_t));
+
 	return FALSE;
 }
 
@@ -37,6 +37,55 @@
  * @{
  **/
 
+/**
+ * The time the current thread has spent in backend functions, in microseconds.
+ **/
+static GPrivate j_backend_thread_time = G_PRIVATE_INIT(g_free);
+
+typedef gint64 JBackendTimer;
+
+/**
+ * Adds the time since a timer has been started to the current thread's backend time.
+ *
+ * \private
+ *
+ * \param timer A timer.
+ **/
+static void
+j_backend_timer_stop(JBackendTimer* timer)
+{
+	guint64* thread_time;
+
+	thread_time = g_private_get(&j_backend_thread_time);
+
+	if (G_UNLIKELY(thread_time == NULL))
+	{
+		thread_time = g_new0(guint64, 1);
+		g_private_set(&j_backend_thread_time, thread_time);
+	}
+
+	*thread_time += g_get_monotonic_time() - *timer;
+}
+
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC(JBackendTimer, j_backend_timer_stop)
+
+/**
+ * Measures the time spent in the rest of the current scope.
+ **/
+#define J_BACKEND_TIMER g_auto(JBackendTimer) G_PASTE(j_backend_timer, __LINE__) G_GNUC_UNUSED = g_get_monotonic_time()
+
+guint64
+j_backend_get_thread_time(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64* thread_time;
+
+	thread_time = g_private_get(&j_backend_thread_time);
+
+	return (thread_time != NULL) ? *thread_time : 0;
+}
+
 GQuark
 j_backend_bson_error_quark(void)
 {
@@ -320,6 +369,7 @@ j_backend_object_create(JBackend* backend, gchar const* namespace, gchar const*
 
 	{
 		J_TRACE("backend_create", "%s, %s, %p", namespace, path, (gpointer)data);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_create(backend->data, namespace, path, data);
 	}
 
@@ -341,6 +391,7 @@ j_backend_object_open(JBackend* backend, gchar const* namespace, gchar const* pa
 
 	{
 		J_TRACE("backend_open", "%s, %s, %p", namespace, path, (gpointer)data);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_open(backend->data, namespace, path, data);
 	}
 
@@ -360,6 +411,7 @@ j_backend_object_delete(JBackend* backend, gpointer data)
 
 	{
 		J_TRACE("backend_delete", "%p", data);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_delete(backend->data, data);
 	}
 
@@ -380,6 +432,7 @@ j_backend_object_get_all(JBackend* backend, gchar const* namespace, gpointer* it
 
 	{
 		J_TRACE("backend_get_all", "%s, %p", namespace, (gpointer)iterator);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_get_all(backend->data, namespace, iterator);
 	}
 
@@ -401,6 +454,7 @@ j_backend_object_get_by_prefix(JBackend* backend, gchar const* namespace, gchar
 
 	{
 		J_TRACE("backend_get_by_prefix", "%s, %s, %p", namespace, prefix, (gpointer)iterator);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_get_by_prefix(backend->data, namespace, prefix, iterator);
 	}
 
@@ -420,6 +474,7 @@ j_backend_object_iterate(JBackend* backend, gpointer iterator, gchar const** nam
 
 	{
 		J_TRACE("backend_iterate", "%p, %p", iterator, (gpointer)name);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_iterate(backend->data, iterator, name);
 	}
 
@@ -439,6 +494,7 @@ j_backend_object_close(JBackend* backend, gpointer data)
 
 	{
 		J_TRACE("backend_close", "%p", data);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_close(backend->data, data);
 	}
 
@@ -460,6 +516,7 @@ j_backend_object_status(JBackend* backend, gpointer data, gint64* modification_t
 
 	{
 		J_TRACE("backend_status", "%p, %p, %p", data, (gpointer)modification_time, (gpointer)size);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_status(backend->data, data, modification_time, size);
 	}
 
@@ -479,6 +536,7 @@ j_backend_object_sync(JBackend* backend, gpointer data)
 
 	{
 		J_TRACE("backend_sync", "%p", data);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_sync(backend->data, data);
 	}
 
@@ -500,6 +558,7 @@ j_backend_object_read(JBackend* backend, gpointer data, gpointer buffer, guint64
 
 	{
 		J_TRACE("backend_read", "%p, %p, %" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT ", %p", data, buffer, length, offset, (gpointer)bytes_read);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_read(backend->data, data, buffer, length, offset, bytes_read);
 	}
 
@@ -521,6 +580,7 @@ j_backend_object_write(JBackend* backend, gpointer data, gconstpointer buffer, g
 
 	{
 		J_TRACE("backend_write", "%p, %p, %" G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT ", %p", data, buffer, length, offset, (gpointer)bytes_written);
+		J_BACKEND_TIMER;
 		ret = backend->object.backend_write(backend->data, data, buffer, length, offset, bytes_written);
 	}
 
@@ -575,6 +635,7 @@ j_backend_kv_batch_start(JBackend* backend, gchar const* namespace, JSemantics*
 
 	{
 		J_TRACE("backend_batch_start", "%s, %p, %p", namespace, (gpointer)semantics, (gpointer)batch);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_batch_start(backend->data, namespace, semantics, batch);
 	}
 
@@ -594,6 +655,7 @@ j_backend_kv_batch_execute(JBackend* backend, gpointer batch)
 
 	{
 		J_TRACE("backend_batch_execute", "%p", batch);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_batch_execute(backend->data, batch);
 	}
 
@@ -615,6 +677,7 @@ j_backend_kv_put(JBackend* backend, gpointer batch, gchar const* key, gconstpoin
 
 	{
 		J_TRACE("backend_put", "%p, %s, %p, %u", batch, key, (gconstpointer)value, value_len);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_put(backend->data, batch, key, value, value_len);
 	}
 
@@ -635,6 +698,7 @@ j_backend_kv_delete(JBackend* backend, gpointer batch, gchar const* key)
 
 	{
 		J_TRACE("backend_delete", "%p, %s", batch, key);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_delete(backend->data, batch, key);
 	}
 
@@ -657,6 +721,7 @@ j_backend_kv_get(JBackend* backend, gpointer batch, gchar const* key, gpointer*
 
 	{
 		J_TRACE("backend_get", "%p, %s, %p, %p", batch, key, (gpointer)value, (gpointer)value_len);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_get(backend->data, batch, key, value, value_len);
 	}
 
@@ -677,6 +742,7 @@ j_backend_kv_get_all(JBackend* backend, gchar const* namespace, gpointer* iterat
 
 	{
 		J_TRACE("backend_get_all", "%s, %p", namespace, (gpointer)iterator);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_get_all(backend->data, namespace, iterator);
 	}
 
@@ -698,6 +764,7 @@ j_backend_kv_get_by_prefix(JBackend* backend, gchar const* namespace, gchar cons
 
 	{
 		J_TRACE("backend_get_by_prefix", "%s, %s, %p", namespace, prefix, (gpointer)iterator);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_get_by_prefix(backend->data, namespace, prefix, iterator);
 	}
 
@@ -719,6 +786,7 @@ j_backend_kv_iterate(JBackend* backend, gpointer iterator, gchar const** key, gc
 
 	{
 		J_TRACE("backend_iterate", "%p, %p, %p, %p", iterator, (gpointer)key, (gpointer)value, (gpointer)value_len);
+		J_BACKEND_TIMER;
 		ret = backend->kv.backend_iterate(backend->data, iterator, key, value, value_len);
 	}
 
@@ -774,6 +842,7 @@ j_backend_db_batch_start(JBackend* backend, gchar const* namespace, JSemantics*
 
 	{
 		J_TRACE("backend_batch_start", "%s, %p, %p, %p", namespace, (gpointer)semantics, (gpointer)batch, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_batch_start(backend->data, namespace, semantics, batch, error);
 	}
 
@@ -794,6 +863,7 @@ j_backend_db_batch_execute(JBackend* backend, gpointer batch, GError** error)
 
 	{
 		J_TRACE("backend_batch_execute", "%p, %p", batch, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_batch_execute(backend->data, batch, error);
 	}
 
@@ -816,6 +886,7 @@ j_backend_db_schema_create(JBackend* backend, gpointer batch, gchar const* name,
 
 	{
 		J_TRACE("backend_schema_create", "%p, %s, %p, %p", batch, name, (gconstpointer)schema, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_schema_create(backend->data, batch, name, schema, error);
 	}
 
@@ -837,6 +908,7 @@ j_backend_db_schema_get(JBackend* backend, gpointer batch, gchar const* name, bs
 
 	{
 		J_TRACE("backend_schema_get", "%p, %s, %p, %p", batch, name, (gpointer)schema, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_schema_get(backend->data, batch, name, schema, error);
 	}
 
@@ -858,6 +930,7 @@ j_backend_db_schema_delete(JBackend* backend, gpointer batch, gchar const* name,
 
 	{
 		J_TRACE("backend_schema_delete", "%p, %s, %p", batch, name, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_schema_delete(backend->data, batch, name, error);
 	}
 
@@ -881,6 +954,7 @@ j_backend_db_insert(JBackend* backend, gpointer batch, gchar const* name, bson_t
 
 	{
 		J_TRACE("backend_insert", "%p, %s, %p, %p, %p", batch, name, (gconstpointer)metadata, (gpointer)id, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_insert(backend->data, batch, name, metadata, id, error);
 	}
 
@@ -904,6 +978,7 @@ j_backend_db_update(JBackend* backend, gpointer batch, gchar const* name, bson_t
 
 	{
 		J_TRACE("backend_update", "%p, %s, %p, %p, %p", batch, name, (gconstpointer)selector, (gconstpointer)metadata, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_update(backend->data, batch, name, selector, metadata, error);
 	}
 
@@ -925,6 +1000,7 @@ j_backend_db_delete(JBackend* backend, gpointer batch, gchar const* name, bson_t
 
 	{
 		J_TRACE("backend_delete", "%p, %s, %p, %p", batch, name, (gconstpointer)selector, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_delete(backend->data, batch, name, selector, error);
 	}
 
@@ -947,6 +1023,7 @@ j_backend_db_query(JBackend* backend, gpointer batch, gchar const* name, bson_t
 
 	{
 		J_TRACE("backend_query", "%p, %s, %p, %p, %p", batch, name, (gconstpointer)selector, (gpointer)iterator, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_query(backend->data, batch, name, selector, iterator, error);
 	}
 
@@ -968,12 +1045,42 @@ j_backend_db_iterate(JBackend* backend, gpointer iterator, bson_t* metadata, GEr
 
 	{
 		J_TRACE("backend_iterate", "%p, %p, %p", iterator, (gpointer)metadata, (gpointer)error);
+		J_BACKEND_TIMER;
 		ret = backend->db.backend_iterate(backend->data, iterator, metadata, error);
 	}
 
 	return ret;
 }
 
+gboolean
+j_backend_db_explain(JBackend* backend, gpointer batch, gchar const* name, bson_t const* selector, bson_t* result, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_DB, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (backend->db.backend_explain == NULL)
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "explain not supported by backend");
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_explain", "%p, %s, %p, %p, %p", batch, name, (gconstpointer)selector, (gpointer)result, (gpointer)error);
+		J_BACKEND_TIMER;
+		ret = backend->db.backend_explain(backend->data, batch, name, selector, result, error);
+	}
+
+	return ret;
+}
+
 /**
  * @}
  **/
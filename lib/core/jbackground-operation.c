@@ -22,10 +22,21 @@
 
 #include <julea-config.h>
 
+#ifdef HAVE_FUTEX
+// syscall() is not part of POSIX
+#define _DEFAULT_SOURCE
+#endif
+
 #include <glib.h>
 
+#include <string.h>
 #include <unistd.h>
 
+#ifdef HAVE_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 #include <jbackground-operation.h>
 #include <jbackground-operation-internal.h>
 
@@ -38,6 +49,42 @@
  * @{
  **/
 
+/**
+ * The number of background operations a worker's deque can hold.
+ * Has to be a power of two.
+ **/
+#define J_BACKGROUND_OPERATION_DEQUE_SIZE 1024
+
+/**
+ * Marks a background operation as completed.
+ **/
+#define J_BACKGROUND_OPERATION_COMPLETED ((gpointer)&j_background_operation_completed)
+
+/**
+ * A waiter for one or more background operations.
+ **/
+struct JBackgroundOperationWaiter
+{
+	/**
+	 * The number of background operations that have not finished yet.
+	 **/
+	gint count;
+
+#ifndef HAVE_FUTEX
+	/**
+	 * The mutex for #count.
+	 **/
+	GMutex mutex[1];
+
+	/**
+	 * The condition for #count.
+	 **/
+	GCond cond[1];
+#endif
+};
+
+typedef struct JBackgroundOperationWaiter JBackgroundOperationWaiter;
+
 /**
  * A background operation.
  **/
@@ -59,19 +106,15 @@ struct JBackgroundOperation
 	gpointer result;
 
 	/**
-	 * Whether the background operation has finished.
+	 * The waiter to notify when the background operation has finished.
+	 * Set to J_BACKGROUND_OPERATION_COMPLETED afterwards.
 	 **/
-	gboolean completed;
+	gpointer waiter;
 
 	/**
-	 * The mutex for #completed.
-	 */
-	GMutex mutex[1];
-
-	/**
-	 * The condition for #completed.
-	 */
-	GCond cond[1];
+	 * Whether a thread has started executing the background operation.
+	 **/
+	gint started;
 
 	/**
 	 * The reference count.
@@ -79,36 +122,508 @@ struct JBackgroundOperation
 	gint ref_count;
 };
 
-static GThreadPool* j_thread_pool = NULL;
+/**
+ * A work-stealing deque.
+ * Only the owning worker pushes and pops at the bottom, other threads steal from the top.
+ **/
+struct JBackgroundOperationDeque
+{
+	gint top;
+	gint bottom;
+
+	JBackgroundOperation* operations[J_BACKGROUND_OPERATION_DEQUE_SIZE];
+};
+
+typedef struct JBackgroundOperationDeque JBackgroundOperationDeque;
 
 /**
- * Executes background operations.
+ * A worker thread.
+ **/
+struct JBackgroundOperationWorker
+{
+	GThread* thread;
+
+	/**
+	 * The background operations created by the worker itself.
+	 **/
+	JBackgroundOperationDeque deque;
+
+	/**
+	 * The background operations created by other threads.
+	 **/
+	GAsyncQueue* inbox;
+
+	guint index;
+};
+
+typedef struct JBackgroundOperationWorker JBackgroundOperationWorker;
+
+/**
+ * The executor running background operations.
+ **/
+struct JBackgroundOperationExecutor
+{
+	JBackgroundOperationWorker* workers;
+	guint workers_len;
+
+	/**
+	 * The number of background operations that have not been started yet.
+	 **/
+	gint pending;
+
+	/**
+	 * The number of sleeping workers.
+	 **/
+	gint sleeping;
+
+	/**
+	 * The worker to give the next background operation created by another thread to.
+	 **/
+	gint next;
+
+	/**
+	 * Whether the workers should exit.
+	 **/
+	gboolean stop;
+
+	/**
+	 * The mutex for #stop and sleeping workers.
+	 **/
+	GMutex mutex[1];
+
+	/**
+	 * The condition sleeping workers wait on.
+	 **/
+	GCond cond[1];
+};
+
+typedef struct JBackgroundOperationExecutor JBackgroundOperationExecutor;
+
+static JBackgroundOperationExecutor* j_background_operation_executor = NULL;
+
+static GPrivate j_background_operation_worker;
+
+static gchar j_background_operation_completed;
+
+/**
+ * Pushes a background operation to the bottom of a deque.
  *
  * \private
  *
- * \code
- * \endcode
+ * \param deque                A deque.
+ * \param background_operation A background operation.
+ *
+ * \return TRUE on success, FALSE if the deque is full.
+ **/
+static gboolean
+j_background_operation_deque_push(JBackgroundOperationDeque* deque, JBackgroundOperation* background_operation)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint bottom;
+	guint top;
+
+	bottom = g_atomic_int_get(&(deque->bottom));
+	top = g_atomic_int_get(&(deque->top));
+
+	if (bottom - top >= J_BACKGROUND_OPERATION_DEQUE_SIZE)
+	{
+		return FALSE;
+	}
+
+	g_atomic_pointer_set(&(deque->operations[bottom % J_BACKGROUND_OPERATION_DEQUE_SIZE]), background_operation);
+	g_atomic_int_set(&(deque->bottom), bottom + 1);
+
+	return TRUE;
+}
+
+/**
+ * Pops a background operation from the bottom of a deque.
+ * Must only be called by the deque's owner.
+ *
+ * \private
+ *
+ * \param deque A deque.
+ *
+ * \return A background operation, NULL if the deque is empty.
+ **/
+static JBackgroundOperation*
+j_background_operation_deque_pop(JBackgroundOperationDeque* deque)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperation* background_operation;
+	guint bottom;
+	guint top;
+	gint size;
+
+	bottom = (guint)g_atomic_int_get(&(deque->bottom)) - 1;
+	g_atomic_int_set(&(deque->bottom), bottom);
+	top = g_atomic_int_get(&(deque->top));
+
+	// Indices wrap around, so their difference has to be interpreted as signed
+	size = (gint)(bottom - top);
+
+	if (size < 0)
+	{
+		g_atomic_int_set(&(deque->bottom), top);
+		return NULL;
+	}
+
+	background_operation = g_atomic_pointer_get(&(deque->operations[bottom % J_BACKGROUND_OPERATION_DEQUE_SIZE]));
+
+	if (size == 0)
+	{
+		// The last background operation might be stolen concurrently
+		if (!g_atomic_int_compare_and_exchange(&(deque->top), top, top + 1))
+		{
+			background_operation = NULL;
+		}
+
+		g_atomic_int_set(&(deque->bottom), top + 1);
+	}
+
+	return background_operation;
+}
+
+/**
+ * Steals a background operation from the top of a deque.
+ *
+ * \private
  *
- * \param data A background operations.
- * \param user_data User data.
+ * \param deque A deque.
+ *
+ * \return A background operation, NULL if the deque is empty or another thread was faster.
  **/
+static JBackgroundOperation*
+j_background_operation_deque_steal(JBackgroundOperationDeque* deque)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperation* background_operation;
+	guint bottom;
+	guint top;
+
+	top = g_atomic_int_get(&(deque->top));
+	bottom = g_atomic_int_get(&(deque->bottom));
+
+	if ((gint)(bottom - top) <= 0)
+	{
+		return NULL;
+	}
+
+	background_operation = g_atomic_pointer_get(&(deque->operations[top % J_BACKGROUND_OPERATION_DEQUE_SIZE]));
+
+	if (!g_atomic_int_compare_and_exchange(&(deque->top), top, top + 1))
+	{
+		return NULL;
+	}
+
+	return background_operation;
+}
+
 static void
-j_background_operation_thread(gpointer data, gpointer user_data)
+j_background_operation_waiter_init(JBackgroundOperationWaiter* waiter, gint count)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JBackgroundOperation* background_operation = data;
+	waiter->count = count;
+
+#ifndef HAVE_FUTEX
+	g_mutex_init(waiter->mutex);
+	g_cond_init(waiter->cond);
+#endif
+}
+
+static void
+j_background_operation_waiter_clear(JBackgroundOperationWaiter* waiter)
+{
+	J_TRACE_FUNCTION(NULL);
 
-	(void)user_data;
+#ifndef HAVE_FUTEX
+	g_cond_clear(waiter->cond);
+	g_mutex_clear(waiter->mutex);
+#else
+	(void)waiter;
+#endif
+}
+
+/**
+ * Notifies a waiter that one of its background operations has finished.
+ *
+ * \private
+ *
+ * \param waiter A waiter.
+ **/
+static void
+j_background_operation_waiter_signal(JBackgroundOperationWaiter* waiter)
+{
+	J_TRACE_FUNCTION(NULL);
+
+#ifdef HAVE_FUTEX
+	if (g_atomic_int_dec_and_test(&(waiter->count)))
+	{
+		syscall(SYS_futex, &(waiter->count), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+	}
+#else
+	g_mutex_lock(waiter->mutex);
+
+	if (g_atomic_int_dec_and_test(&(waiter->count)))
+	{
+		g_cond_signal(waiter->cond);
+	}
+
+	g_mutex_unlock(waiter->mutex);
+#endif
+}
+
+/**
+ * Takes a background operation that has not been started yet.
+ * Workers prefer their own background operations and steal from other workers otherwise.
+ *
+ * \private
+ *
+ * \param worker The calling worker, NULL if the calling thread is not a worker.
+ *
+ * \return A background operation, NULL if none could be found.
+ **/
+static JBackgroundOperation*
+j_background_operation_take(JBackgroundOperationWorker* worker)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationExecutor* executor = j_background_operation_executor;
+	JBackgroundOperation* background_operation = NULL;
+	guint start = 0;
+
+	if (g_atomic_int_get(&(executor->pending)) <= 0)
+	{
+		return NULL;
+	}
+
+	if (worker != NULL)
+	{
+		if ((background_operation = j_background_operation_deque_pop(&(worker->deque))) == NULL)
+		{
+			background_operation = g_async_queue_try_pop(worker->inbox);
+		}
+
+		start = worker->index + 1;
+	}
+
+	for (guint i = 0; i < executor->workers_len && background_operation == NULL; i++)
+	{
+		JBackgroundOperationWorker* victim = &(executor->workers[(start + i) % executor->workers_len]);
+
+		if (victim == worker)
+		{
+			continue;
+		}
+
+		if ((background_operation = j_background_operation_deque_steal(&(victim->deque))) == NULL)
+		{
+			background_operation = g_async_queue_try_pop(victim->inbox);
+		}
+	}
+
+	if (background_operation != NULL)
+	{
+		g_atomic_int_add(&(executor->pending), -1);
+	}
+
+	return background_operation;
+}
+
+/**
+ * Executes a background operation and notifies its waiter.
+ * Does nothing if another thread has already started the background operation.
+ *
+ * \private
+ *
+ * \param background_operation A background operation.
+ *
+ * \return TRUE if the background operation has been executed, FALSE otherwise.
+ **/
+static gboolean
+j_background_operation_run(JBackgroundOperation* background_operation)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gpointer waiter;
+
+	if (!g_atomic_int_compare_and_exchange(&(background_operation->started), FALSE, TRUE))
+	{
+		return FALSE;
+	}
 
 	background_operation->result = (*(background_operation->func))(background_operation->data);
 
-	g_mutex_lock(background_operation->mutex);
-	background_operation->completed = TRUE;
-	g_cond_signal(background_operation->cond);
-	g_mutex_unlock(background_operation->mutex);
+	do
+	{
+		waiter = g_atomic_pointer_get(&(background_operation->waiter));
+	} while (!g_atomic_pointer_compare_and_exchange(&(background_operation->waiter), waiter, J_BACKGROUND_OPERATION_COMPLETED));
+
+	if (waiter != NULL)
+	{
+		j_background_operation_waiter_signal(waiter);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Executes a background operation instead of waiting for it.
+ * Workers execute any pending background operation, because all workers might be waiting for nested background operations.
+ * Other threads only execute the background operations they are waiting for themselves.
+ *
+ * \private
+ *
+ * \param background_operations The background operations being waited for.
+ * \param length                The number of background operations.
+ *
+ * \return TRUE if a background operation has been executed, FALSE otherwise.
+ **/
+static gboolean
+j_background_operation_help(JBackgroundOperation** background_operations, guint length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationWorker* worker;
+
+	worker = g_private_get(&j_background_operation_worker);
+
+	if (worker != NULL)
+	{
+		JBackgroundOperation* background_operation;
+
+		if ((background_operation = j_background_operation_take(worker)) == NULL)
+		{
+			return FALSE;
+		}
+
+		j_background_operation_run(background_operation);
+		j_background_operation_unref(background_operation);
 
-	j_background_operation_unref(background_operation);
+		return TRUE;
+	}
+
+	for (guint i = 0; i < length; i++)
+	{
+		// The background operation stays queued, the worker taking it will skip it
+		if (background_operations[i] != NULL && j_background_operation_run(background_operations[i]))
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ * Waits until all of a waiter's background operations have finished.
+ * Executes background operations while waiting instead of blocking right away, see j_background_operation_help().
+ *
+ * \private
+ *
+ * \param waiter                A waiter.
+ * \param background_operations The background operations being waited for.
+ * \param length                The number of background operations.
+ **/
+static void
+j_background_operation_waiter_wait(JBackgroundOperationWaiter* waiter, JBackgroundOperation** background_operations, guint length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint count;
+
+	while ((count = g_atomic_int_get(&(waiter->count))) > 0)
+	{
+		if (j_background_operation_help(background_operations, length))
+		{
+			continue;
+		}
+
+#ifdef HAVE_FUTEX
+		syscall(SYS_futex, &(waiter->count), FUTEX_WAIT_PRIVATE, count, NULL, NULL, 0);
+#else
+		g_mutex_lock(waiter->mutex);
+
+		if (g_atomic_int_get(&(waiter->count)) > 0)
+		{
+			g_cond_wait(waiter->cond, waiter->mutex);
+		}
+
+		g_mutex_unlock(waiter->mutex);
+#endif
+	}
+
+#ifndef HAVE_FUTEX
+	// Make sure the last signaling thread does not use the mutex anymore
+	g_mutex_lock(waiter->mutex);
+	g_mutex_unlock(waiter->mutex);
+#endif
+}
+
+/**
+ * Executes background operations.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param data A worker.
+ *
+ * \return NULL.
+ **/
+static gpointer
+j_background_operation_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationExecutor* executor = j_background_operation_executor;
+	JBackgroundOperationWorker* worker = data;
+
+	g_private_set(&j_background_operation_worker, worker);
+
+	while (TRUE)
+	{
+		JBackgroundOperation* background_operation;
+		gboolean stop;
+
+		if ((background_operation = j_background_operation_take(worker)) != NULL)
+		{
+			j_background_operation_run(background_operation);
+			j_background_operation_unref(background_operation);
+			continue;
+		}
+
+		if (g_atomic_int_get(&(executor->pending)) > 0)
+		{
+			// A background operation has been announced but not published yet
+			g_thread_yield();
+			continue;
+		}
+
+		g_mutex_lock(executor->mutex);
+		g_atomic_int_inc(&(executor->sleeping));
+
+		while (g_atomic_int_get(&(executor->pending)) <= 0 && !executor->stop)
+		{
+			g_cond_wait(executor->cond, executor->mutex);
+		}
+
+		g_atomic_int_add(&(executor->sleeping), -1);
+		stop = (executor->stop && g_atomic_int_get(&(executor->pending)) <= 0);
+		g_mutex_unlock(executor->mutex);
+
+		if (stop)
+		{
+			break;
+		}
+	}
+
+	return NULL;
 }
 
 void
@@ -116,17 +631,38 @@ j_background_operation_init(guint count)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GThreadPool* thread_pool;
+	JBackgroundOperationExecutor* executor;
 
-	g_return_if_fail(j_thread_pool == NULL);
+	g_return_if_fail(j_background_operation_executor == NULL);
 
 	if (count == 0)
 	{
 		count = g_get_num_processors();
 	}
 
-	thread_pool = g_thread_pool_new(j_background_operation_thread, NULL, count, FALSE, NULL);
-	g_atomic_pointer_set(&j_thread_pool, thread_pool);
+	executor = g_new(JBackgroundOperationExecutor, 1);
+	executor->workers = g_new0(JBackgroundOperationWorker, count);
+	executor->workers_len = count;
+	executor->pending = 0;
+	executor->sleeping = 0;
+	executor->next = 0;
+	executor->stop = FALSE;
+
+	g_mutex_init(executor->mutex);
+	g_cond_init(executor->cond);
+
+	for (guint i = 0; i < count; i++)
+	{
+		executor->workers[i].inbox = g_async_queue_new();
+		executor->workers[i].index = i;
+	}
+
+	g_atomic_pointer_set(&j_background_operation_executor, executor);
+
+	for (guint i = 0; i < count; i++)
+	{
+		executor->workers[i].thread = g_thread_new("JBackgroundOperation", j_background_operation_thread, &(executor->workers[i]));
+	}
 }
 
 void
@@ -134,14 +670,31 @@ j_background_operation_fini(void)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GThreadPool* thread_pool;
+	JBackgroundOperationExecutor* executor;
+
+	g_return_if_fail(j_background_operation_executor != NULL);
+
+	executor = g_atomic_pointer_get(&j_background_operation_executor);
 
-	g_return_if_fail(j_thread_pool != NULL);
+	// Workers finish all pending background operations before exiting
+	g_mutex_lock(executor->mutex);
+	executor->stop = TRUE;
+	g_cond_broadcast(executor->cond);
+	g_mutex_unlock(executor->mutex);
 
-	thread_pool = g_atomic_pointer_get(&j_thread_pool);
-	g_atomic_pointer_set(&j_thread_pool, NULL);
+	for (guint i = 0; i < executor->workers_len; i++)
+	{
+		g_thread_join(executor->workers[i].thread);
+		g_async_queue_unref(executor->workers[i].inbox);
+	}
 
-	g_thread_pool_free(thread_pool, FALSE, TRUE);
+	g_atomic_pointer_set(&j_background_operation_executor, NULL);
+
+	g_cond_clear(executor->cond);
+	g_mutex_clear(executor->mutex);
+
+	g_free(executor->workers);
+	g_free(executor);
 }
 
 guint
@@ -149,7 +702,7 @@ j_background_operation_get_num_threads(void)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return g_thread_pool_get_max_threads(j_thread_pool);
+	return j_background_operation_executor->workers_len;
 }
 
 JBackgroundOperation*
@@ -157,7 +710,9 @@ j_background_operation_new(JBackgroundOperationFunc func, gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JBackgroundOperationExecutor* executor = j_background_operation_executor;
 	JBackgroundOperation* background_operation;
+	JBackgroundOperationWorker* worker;
 
 	g_return_val_if_fail(func != NULL, NULL);
 
@@ -165,13 +720,27 @@ j_background_operation_new(JBackgroundOperationFunc func, gpointer data)
 	background_operation->func = func;
 	background_operation->data = data;
 	background_operation->result = NULL;
-	background_operation->completed = FALSE;
+	background_operation->waiter = NULL;
+	background_operation->started = FALSE;
 	background_operation->ref_count = 2;
 
-	g_mutex_init(background_operation->mutex);
-	g_cond_init(background_operation->cond);
+	worker = g_private_get(&j_background_operation_worker);
 
-	g_thread_pool_push(j_thread_pool, background_operation, NULL);
+	g_atomic_int_inc(&(executor->pending));
+
+	// Background operations created by workers are kept local, so nested operations do not have to cross threads
+	if (worker == NULL || !j_background_operation_deque_push(&(worker->deque), background_operation))
+	{
+		worker = &(executor->workers[(guint)g_atomic_int_add(&(executor->next), 1) % executor->workers_len]);
+		g_async_queue_push(worker->inbox, background_operation);
+	}
+
+	if (g_atomic_int_get(&(executor->sleeping)) > 0)
+	{
+		g_mutex_lock(executor->mutex);
+		g_cond_signal(executor->cond);
+		g_mutex_unlock(executor->mutex);
+	}
 
 	return background_operation;
 }
@@ -197,9 +766,6 @@ j_background_operation_unref(JBackgroundOperation* background_operation)
 
 	if (g_atomic_int_dec_and_test(&(background_operation->ref_count)))
 	{
-		g_cond_clear(background_operation->cond);
-		g_mutex_clear(background_operation->mutex);
-
 		g_free(background_operation);
 	}
 }
@@ -211,16 +777,67 @@ j_background_operation_wait(JBackgroundOperation* background_operation)
 
 	g_return_val_if_fail(background_operation != NULL, NULL);
 
-	g_mutex_lock(background_operation->mutex);
+	j_background_operation_wait_all(&background_operation, 1);
+
+	return background_operation->result;
+}
+
+void
+j_background_operation_wait_all(JBackgroundOperation** background_operations, guint length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationWaiter waiter;
+	gboolean contended = FALSE;
+
+	g_return_if_fail(background_operations != NULL || length == 0);
 
-	while (!background_operation->completed)
+	// The additional count prevents the wait from finishing while background operations are still being registered
+	j_background_operation_waiter_init(&waiter, 1);
+
+	for (guint i = 0; i < length; i++)
 	{
-		g_cond_wait(background_operation->cond, background_operation->mutex);
+		if (background_operations[i] == NULL)
+		{
+			continue;
+		}
+
+		g_atomic_int_inc(&(waiter.count));
+
+		if (!g_atomic_pointer_compare_and_exchange(&(background_operations[i]->waiter), NULL, &waiter))
+		{
+			// The background operation has either finished or another thread is waiting for it
+			g_atomic_int_add(&(waiter.count), -1);
+
+			if (g_atomic_pointer_get(&(background_operations[i]->waiter)) != J_BACKGROUND_OPERATION_COMPLETED)
+			{
+				contended = TRUE;
+			}
+		}
 	}
 
-	g_mutex_unlock(background_operation->mutex);
+	j_background_operation_waiter_signal(&waiter);
+	j_background_operation_waiter_wait(&waiter, background_operations, length);
+	j_background_operation_waiter_clear(&waiter);
 
-	return background_operation->result;
+	if (contended)
+	{
+		for (guint i = 0; i < length; i++)
+		{
+			if (background_operations[i] == NULL)
+			{
+				continue;
+			}
+
+			while (g_atomic_pointer_get(&(background_operations[i]->waiter)) != J_BACKGROUND_OPERATION_COMPLETED)
+			{
+				if (!j_background_operation_help(&(background_operations[i]), 1))
+				{
+					g_thread_yield();
+				}
+			}
+		}
+	}
 }
 
 /**
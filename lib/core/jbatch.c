@@ -42,6 +42,87 @@
  * @{
  **/
 
+/**
+ * The state of an automatically executed batch.
+ **/
+struct JBatchAuto
+{
+	/**
+	 * The thread executing the operations.
+	 **/
+	GThread* thread;
+
+	GMutex mutex;
+	GCond cond;
+
+	/**
+	 * The maximum number of pending operations.
+	 **/
+	guint max_operations;
+
+	/**
+	 * The maximum amount of pending data.
+	 **/
+	guint64 max_bytes;
+
+	/**
+	 * The maximum time an operation stays pending in microseconds.
+	 **/
+	gint64 max_latency;
+
+	/**
+	 * The number of pending operations.
+	 **/
+	guint operations;
+
+	/**
+	 * The amount of pending data.
+	 **/
+	guint64 bytes;
+
+	/**
+	 * The time the pending operations have to be executed at.
+	 **/
+	gint64 deadline;
+
+	/**
+	 * The number of operations that have been added.
+	 **/
+	guint64 added;
+
+	/**
+	 * The number of operations that have been executed.
+	 **/
+	guint64 completed;
+
+	/**
+	 * The number of operations that had been added at the last j_batch_execute().
+	 **/
+	guint64 executed;
+
+	/**
+	 * The number of the first operation that failed since the last j_batch_execute(), G_MAXUINT64 if none failed.
+	 **/
+	guint64 first_failed;
+
+	/**
+	 * Whether all operations since the last j_batch_execute() succeeded.
+	 **/
+	gboolean ret;
+
+	/**
+	 * Whether the pending operations should be executed immediately.
+	 **/
+	gboolean flush;
+
+	/**
+	 * Whether the thread should exit.
+	 **/
+	gboolean stop;
+};
+
+typedef struct JBatchAuto JBatchAuto;
+
 /**
  * An operation.
  **/
@@ -62,6 +143,11 @@ struct JBatch
 	 **/
 	JBackgroundOperation* background_operation;
 
+	/**
+	 * The state for automatic execution, NULL if disabled.
+	 **/
+	JBatchAuto* auto_;
+
 	/**
 	 * The reference count.
 	 **/
@@ -99,6 +185,114 @@ j_batch_background_operation(gpointer data)
 	return NULL;
 }
 
+/**
+ * Checks whether an automatically executed batch's pending operations have to be executed.
+ *
+ * \private
+ *
+ * \param batch_auto The automatic execution state.
+ *
+ * \return TRUE if the operations have to be executed, FALSE otherwise.
+ **/
+static gboolean
+j_batch_auto_is_due(JBatchAuto* batch_auto)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (batch_auto->operations == 0)
+	{
+		return FALSE;
+	}
+
+	if (batch_auto->flush || batch_auto->stop)
+	{
+		return TRUE;
+	}
+
+	if (batch_auto->max_operations > 0 && batch_auto->operations >= batch_auto->max_operations)
+	{
+		return TRUE;
+	}
+
+	if (batch_auto->max_bytes > 0 && batch_auto->bytes >= batch_auto->max_bytes)
+	{
+		return TRUE;
+	}
+
+	return (batch_auto->max_latency > 0 && g_get_monotonic_time() >= batch_auto->deadline);
+}
+
+static gpointer
+j_batch_auto_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBatch* batch = data;
+	JBatchAuto* batch_auto = batch->auto_;
+
+	g_mutex_lock(&(batch_auto->mutex));
+
+	while (TRUE)
+	{
+		JBatch* pending;
+		gboolean ret;
+		guint64 first;
+		guint64 last;
+
+		if (!j_batch_auto_is_due(batch_auto))
+		{
+			if (batch_auto->stop)
+			{
+				break;
+			}
+
+			if (batch_auto->operations > 0 && batch_auto->max_latency > 0)
+			{
+				g_cond_wait_until(&(batch_auto->cond), &(batch_auto->mutex), batch_auto->deadline);
+			}
+			else
+			{
+				g_cond_wait(&(batch_auto->cond), &(batch_auto->mutex));
+			}
+
+			continue;
+		}
+
+		// Operations added while the pending ones are executed end up in the next batch
+		pending = j_batch_new_from_batch(batch);
+		first = batch_auto->completed;
+		last = batch_auto->added;
+
+		batch_auto->operations = 0;
+		batch_auto->bytes = 0;
+		batch_auto->flush = FALSE;
+
+		g_mutex_unlock(&(batch_auto->mutex));
+
+		// Automatically executed batches are immediate, so operations cached by eventual batches have to be executed first
+		j_operation_cache_flush();
+
+		ret = j_batch_execute_internal(pending);
+		j_list_delete_all(pending->list);
+		j_batch_unref(pending);
+
+		g_mutex_lock(&(batch_auto->mutex));
+
+		if (!ret)
+		{
+			batch_auto->ret = FALSE;
+			batch_auto->first_failed = MIN(batch_auto->first_failed, first);
+		}
+
+		batch_auto->completed = last;
+		g_cond_broadcast(&(batch_auto->cond));
+	}
+
+	g_mutex_unlock(&(batch_auto->mutex));
+
+	return NULL;
+}
+
 /**
  * Clang's function sanitizer flags incompatible function pointer casts.
  * See: https://github.com/systemd/systemd/issues/29972
@@ -122,6 +316,7 @@ j_batch_new(JSemantics* semantics)
 	batch->list = j_list_new(j_batch_operation_free);
 	batch->semantics = j_semantics_ref(semantics);
 	batch->background_operation = NULL;
+	batch->auto_ = NULL;
 	batch->ref_count = 1;
 
 	return batch;
@@ -166,6 +361,21 @@ j_batch_unref(JBatch* batch)
 
 		is_session = j_semantics_get(batch->semantics, J_SEMANTICS_CONSISTENCY) == J_SEMANTICS_CONSISTENCY_SESSION;
 
+		if (batch->auto_ != NULL)
+		{
+			// The thread executes the remaining operations before exiting
+			g_mutex_lock(&(batch->auto_->mutex));
+			batch->auto_->stop = TRUE;
+			g_cond_broadcast(&(batch->auto_->cond));
+			g_mutex_unlock(&(batch->auto_->mutex));
+
+			g_thread_join(batch->auto_->thread);
+
+			g_cond_clear(&(batch->auto_->cond));
+			g_mutex_clear(&(batch->auto_->mutex));
+			g_free(batch->auto_);
+		}
+
 		if (is_session)
 		{
 			// Freeing the batch ends the current session
@@ -237,6 +447,37 @@ j_batch_execute(JBatch* batch)
 
 	g_return_val_if_fail(batch != NULL, FALSE);
 
+	if (batch->auto_ != NULL)
+	{
+		JBatchAuto* batch_auto = batch->auto_;
+		guint64 added;
+
+		g_mutex_lock(&(batch_auto->mutex));
+
+		added = batch_auto->added;
+
+		if (batch_auto->operations > 0)
+		{
+			batch_auto->flush = TRUE;
+			g_cond_broadcast(&(batch_auto->cond));
+		}
+
+		while (batch_auto->completed < added)
+		{
+			g_cond_wait(&(batch_auto->cond), &(batch_auto->mutex));
+		}
+
+		// Like for regular batches, executing without any new operations fails
+		ret = (added > batch_auto->executed) ? batch_auto->ret : FALSE;
+		batch_auto->executed = added;
+		batch_auto->ret = TRUE;
+		batch_auto->first_failed = G_MAXUINT64;
+
+		g_mutex_unlock(&(batch_auto->mutex));
+
+		return ret;
+	}
+
 	consistency = j_semantics_get(batch->semantics, J_SEMANTICS_CONSISTENCY);
 
 	if (j_list_length(batch->list) == 0)
@@ -291,6 +532,7 @@ j_batch_execute_async(JBatch* batch, JBatchAsyncCallback callback, gpointer user
 
 	g_return_if_fail(batch != NULL);
 	g_return_if_fail(batch->background_operation == NULL);
+	g_return_if_fail(batch->auto_ == NULL);
 
 	async = g_new(JBatchAsync, 1);
 	async->batch = j_batch_ref(batch);
@@ -333,9 +575,137 @@ j_batch_add(JBatch* batch, JOperation* operation)
 	g_return_if_fail(batch != NULL);
 	g_return_if_fail(operation != NULL);
 
+	if (batch->auto_ != NULL)
+	{
+		JBatchAuto* batch_auto = batch->auto_;
+		gboolean was_due;
+
+		g_mutex_lock(&(batch_auto->mutex));
+
+		was_due = j_batch_auto_is_due(batch_auto);
+
+		if (batch_auto->operations == 0)
+		{
+			batch_auto->deadline = g_get_monotonic_time() + batch_auto->max_latency;
+		}
+
+		j_list_append(batch->list, operation);
+		batch_auto->operations++;
+		batch_auto->bytes += operation->size;
+		batch_auto->added++;
+
+		// Only wake up the thread if its deadline or state changes
+		if (batch_auto->operations == 1 || (!was_due && j_batch_auto_is_due(batch_auto)))
+		{
+			g_cond_broadcast(&(batch_auto->cond));
+		}
+
+		g_mutex_unlock(&(batch_auto->mutex));
+
+		return;
+	}
+
 	j_list_append(batch->list, operation);
 }
 
+gboolean
+j_batch_set_auto(JBatch* batch, guint max_operations, guint64 max_bytes, guint64 max_latency)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBatchAuto* batch_auto;
+
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(batch->auto_ == NULL, FALSE);
+	g_return_val_if_fail(batch->background_operation == NULL, FALSE);
+	g_return_val_if_fail(j_list_length(batch->list) == 0, FALSE);
+
+	// The operations are executed as soon as a limit is reached, which does not match the other consistency levels
+	if (j_semantics_get(batch->semantics, J_SEMANTICS_CONSISTENCY) != J_SEMANTICS_CONSISTENCY_IMMEDIATE)
+	{
+		return FALSE;
+	}
+
+	batch_auto = g_new(JBatchAuto, 1);
+	g_mutex_init(&(batch_auto->mutex));
+	g_cond_init(&(batch_auto->cond));
+	batch_auto->max_operations = max_operations;
+	batch_auto->max_bytes = max_bytes;
+	batch_auto->max_latency = max_latency;
+	batch_auto->operations = 0;
+	batch_auto->bytes = 0;
+	batch_auto->deadline = 0;
+	batch_auto->added = 0;
+	batch_auto->completed = 0;
+	batch_auto->executed = 0;
+	batch_auto->first_failed = G_MAXUINT64;
+	batch_auto->ret = TRUE;
+	batch_auto->flush = FALSE;
+	batch_auto->stop = FALSE;
+
+	batch->auto_ = batch_auto;
+	batch_auto->thread = g_thread_new("JBatch", j_batch_auto_thread, batch);
+
+	return TRUE;
+}
+
+guint64
+j_batch_get_handle(JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 handle;
+
+	g_return_val_if_fail(batch != NULL, 0);
+
+	if (batch->auto_ == NULL)
+	{
+		return j_list_length(batch->list);
+	}
+
+	g_mutex_lock(&(batch->auto_->mutex));
+	handle = batch->auto_->added;
+	g_mutex_unlock(&(batch->auto_->mutex));
+
+	return handle;
+}
+
+gboolean
+j_batch_wait_handle(JBatch* batch, guint64 handle)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBatchAuto* batch_auto;
+	gboolean ret = FALSE;
+
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(batch->auto_ != NULL, FALSE);
+	g_return_val_if_fail(handle > 0, FALSE);
+
+	batch_auto = batch->auto_;
+
+	g_mutex_lock(&(batch_auto->mutex));
+
+	if (handle > batch_auto->added)
+	{
+		g_critical("Invalid batch handle %" G_GUINT64_FORMAT ".", handle);
+		goto end;
+	}
+
+	while (batch_auto->completed < handle)
+	{
+		g_cond_wait(&(batch_auto->cond), &(batch_auto->mutex));
+	}
+
+	// Handles start at 1, while first_failed counts the operations before the failed ones
+	ret = (batch_auto->first_failed >= handle);
+
+end:
+	g_mutex_unlock(&(batch_auto->mutex));
+
+	return ret;
+}
+
 /* Internal */
 
 JBatch*
@@ -351,6 +721,7 @@ j_batch_new_from_batch(JBatch* old_batch)
 	batch->list = old_batch->list;
 	batch->semantics = j_semantics_ref(old_batch->semantics);
 	batch->background_operation = NULL;
+	batch->auto_ = NULL;
 	batch->ref_count = 1;
 
 	old_batch->list = j_list_new(j_batch_operation_free);
@@ -378,6 +749,11 @@ j_batch_execute_internal(JBatch* batch)
 	JOperationExecFunc last_exec_func;
 	gconstpointer last_key;
 	gboolean ret = TRUE;
+	guint64 correlation;
+
+	// all operations of a batch share a correlation ID in traces
+	correlation = j_trace_get_correlation();
+	j_trace_set_correlation(j_trace_correlation_new());
 
 	iterator = j_list_iterator_new(batch->list);
 	same_list = j_list_new(NULL);
@@ -411,6 +787,8 @@ j_batch_execute_internal(JBatch* batch)
 
 	ret = j_batch_execute_same(batch, last_exec_func, same_list) && ret;
 
+	j_trace_set_correlation(correlation);
+
 	return ret;
 }
 
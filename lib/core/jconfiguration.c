@@ -127,9 +127,12 @@ struct JConfiguration
 
 	guint64 max_operation_size;
 	guint64 max_inject_size;
+	guint64 zerocopy_size;
 	guint16 port;
 
 	guint32 max_connections;
+	guint32 min_connections;
+	guint32 idle_timeout;
 	guint64 stripe_size;
 
 	gchar* checksum;
@@ -269,16 +272,22 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	g_autofree gchar* key_file_str = NULL;
 	guint64 max_operation_size;
 	guint64 max_inject_size;
+	guint64 zerocopy_size;
 	guint32 port;
 	guint32 max_connections;
+	guint32 min_connections;
+	guint32 idle_timeout;
 	guint64 stripe_size;
 
 	g_return_val_if_fail(key_file != NULL, FALSE);
 
 	max_operation_size = g_key_file_get_uint64(key_file, "core", "max-operation-size", NULL);
 	max_inject_size = g_key_file_get_uint64(key_file, "core", "max-inject-size", NULL);
+	zerocopy_size = g_key_file_get_uint64(key_file, "core", "zerocopy-size", NULL);
 	port = g_key_file_get_integer(key_file, "core", "port", NULL);
 	max_connections = g_key_file_get_integer(key_file, "clients", "max-connections", NULL);
+	min_connections = g_key_file_get_integer(key_file, "clients", "min-connections", NULL);
+	idle_timeout = g_key_file_get_integer(key_file, "clients", "idle-timeout", NULL);
 	stripe_size = g_key_file_get_uint64(key_file, "clients", "stripe-size", NULL);
 	servers_object = g_key_file_get_string_list(key_file, "servers", "object", NULL, NULL);
 	servers_kv = g_key_file_get_string_list(key_file, "servers", "kv", NULL, NULL);
@@ -332,7 +341,12 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	configuration->max_operation_size = max_operation_size;
 	configuration->port = port;
 	configuration->max_inject_size = max_inject_size;
+	// 0 disables zero-copy transmission
+	configuration->zerocopy_size = zerocopy_size;
 	configuration->max_connections = max_connections;
+	// 0 disables warming up connections
+	configuration->min_connections = min_connections;
+	configuration->idle_timeout = idle_timeout;
 	configuration->stripe_size = stripe_size;
 	configuration->checksum = NULL;
 	configuration->ref_count = 1;
@@ -359,6 +373,13 @@ j_configuration_new_for_data(GKeyFile* key_file)
 		configuration->max_connections = g_get_num_processors();
 	}
 
+	configuration->min_connections = MIN(configuration->min_connections, configuration->max_connections);
+
+	if (configuration->idle_timeout == 0)
+	{
+		configuration->idle_timeout = 60;
+	}
+
 	if (configuration->stripe_size == 0)
 	{
 		configuration->stripe_size = 4 * 1024 * 1024;
@@ -521,6 +542,16 @@ j_configuration_get_max_inject_size(JConfiguration* configuration)
 	return configuration->max_inject_size;
 }
 
+guint64
+j_configuration_get_zerocopy_size(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->zerocopy_size;
+}
+
 guint32
 j_configuration_get_max_connections(JConfiguration* configuration)
 {
@@ -531,6 +562,26 @@ j_configuration_get_max_connections(JConfiguration* configuration)
 	return configuration->max_connections;
 }
 
+guint32
+j_configuration_get_min_connections(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->min_connections;
+}
+
+guint32
+j_configuration_get_idle_timeout(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->idle_timeout;
+}
+
 guint64
 j_configuration_get_stripe_size(JConfiguration* configuration)
 {
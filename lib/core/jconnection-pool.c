@@ -26,6 +26,8 @@
 #include <glib-object.h>
 #include <gio/gio.h>
 
+#include <string.h>
+
 #include <jconnection-pool.h>
 #include <jconnection-pool-internal.h>
 
@@ -40,10 +42,48 @@
  * @{
  **/
 
+/**
+ * The number of attempts to establish a connection before giving up.
+ **/
+#define J_CONNECTION_POOL_CONNECT_ATTEMPTS 3
+
+/**
+ * An idle connection.
+ **/
+struct JConnectionPoolEntry
+{
+	GSocketConnection* connection;
+
+	/**
+	 * The time the connection has been returned to the pool.
+	 **/
+	gint64 idle_since;
+};
+
+typedef struct JConnectionPoolEntry JConnectionPoolEntry;
+
+/**
+ * The connections to a single server.
+ **/
 struct JConnectionPoolQueue
 {
-	GAsyncQueue* queue;
+	GMutex mutex;
+	GCond cond;
+
+	/**
+	 * The idle connections, the most recently used one first.
+	 * Contains JConnectionPoolEntry elements.
+	 **/
+	GQueue* entries;
+
+	/**
+	 * The number of open connections, including the ones in use.
+	 **/
 	guint count;
+
+	gchar const* server;
+
+	guint64 statistics[J_CONNECTION_POOL_CONNECTIONS];
 };
 
 typedef struct JConnectionPoolQueue JConnectionPoolQueue;
@@ -61,12 +101,304 @@ struct JConnectionPool
 	guint kv_len;
 	guint db_len;
 	guint max_count;
+	guint min_count;
+	gint64 idle_timeout;
 };
 
 typedef struct JConnectionPool JConnectionPool;
 
 static JConnectionPool* j_connection_pool = NULL;
 
+/**
+ * Establishes a new connection and negotiates the protocol version.
+ *
+ * \private
+ *
+ * \param configuration A configuration.
+ * \param server        A server.
+ * \param error         A GError.
+ *
+ * \return A new connection, NULL if an error occurred.
+ **/
+static GSocketConnection*
+j_connection_pool_connect(JConfiguration* configuration, gchar const* server, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GSocketClient) client = NULL;
+	g_autoptr(JMessage) message = NULL;
+	g_autoptr(JMessage) reply = NULL;
+
+	g_autofree gchar* client_version = NULL;
+	GSocketConnection* connection;
+	gchar const* client_checksum;
+	gchar const* server_checksum;
+	guint32 version = 1;
+	guint op_count;
+
+	client = g_socket_client_new();
+	connection = g_socket_client_connect_to_host(client, server, j_configuration_get_port(configuration), NULL, error);
+
+	if (connection == NULL)
+	{
+		return NULL;
+	}
+
+	j_helper_set_nodelay(connection, TRUE);
+
+	client_checksum = j_configuration_get_checksum(configuration);
+
+	client_version = g_strdup_printf("version %d", J_MESSAGE_VERSION);
+
+	message = j_message_new(J_MESSAGE_PING, strlen(client_checksum) + 1);
+	j_message_append_string(message, client_checksum);
+	// Older servers only read the checksum and ignore the version
+	j_message_add_operation(message, strlen(client_version) + 1);
+	j_message_append_string(message, client_version);
+
+	reply = j_message_new_reply(message);
+
+	if (!j_message_send(message, connection) || !j_message_receive(reply, connection))
+	{
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Server %s did not answer the ping.", server);
+
+		g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+		g_object_unref(connection);
+
+		return NULL;
+	}
+
+	server_checksum = j_message_get_string(reply);
+
+	if (g_strcmp0(client_checksum, server_checksum) != 0)
+	{
+		g_warning("Server %s uses different configuration than client.", server);
+	}
+
+	op_count = j_message_get_count(reply);
+
+	for (guint i = 0; i < op_count; i++)
+	{
+		gchar const* backend;
+
+		backend = j_message_get_string(reply);
+
+		if (g_strcmp0(backend, "object") == 0)
+		{
+			//g_print("Server has object backend.\n");
+		}
+		else if (g_strcmp0(backend, "kv") == 0)
+		{
+			//g_print("Server has kv backend.\n");
+		}
+		else if (g_strcmp0(backend, "db") == 0)
+		{
+			//g_print("Server has db backend.\n");
+		}
+		else if (g_str_has_prefix(backend, "version "))
+		{
+			version = MIN(g_ascii_strtoull(backend + strlen("version "), NULL, 10), J_MESSAGE_VERSION);
+		}
+	}
+
+	if (version >= 2)
+	{
+		j_message_set_version(connection, version);
+	}
+
+	return connection;
+}
+
+/**
+ * Closes a connection.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ **/
+static void
+j_connection_pool_close(GSocketConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+	g_object_unref(connection);
+}
+
+/**
+ * Checks whether an idle connection can still be used.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ *
+ * \return TRUE if the connection is usable, FALSE otherwise.
+ **/
+static gboolean
+j_connection_pool_check(GSocketConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GSocket* socket_;
+
+	if (g_io_stream_is_closed(G_IO_STREAM(connection)))
+	{
+		return FALSE;
+	}
+
+	socket_ = g_socket_connection_get_socket(connection);
+
+	if (!g_socket_is_connected(socket_))
+	{
+		return FALSE;
+	}
+
+	// Idle connections do not have pending data, so being readable means that the server has closed the connection
+	return (g_socket_condition_check(socket_, G_IO_IN | G_IO_ERR | G_IO_HUP) == 0);
+}
+
+/**
+ * Initializes a queue.
+ *
+ * \private
+ *
+ * \param queue  A queue.
+ * \param server A server.
+ **/
+static void
+j_connection_pool_queue_init(JConnectionPoolQueue* queue, gchar const* server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_mutex_init(&(queue->mutex));
+	g_cond_init(&(queue->cond));
+	queue->entries = g_queue_new();
+	queue->count = 0;
+	queue->server = server;
+
+	memset(queue->statistics, 0, sizeof(queue->statistics));
+}
+
+/**
+ * Closes a queue's connections and frees its resources.
+ *
+ * \private
+ *
+ * \param queue A queue.
+ **/
+static void
+j_connection_pool_queue_fini(JConnectionPoolQueue* queue)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnectionPoolEntry* entry;
+
+	g_debug("Connection pool for %s: %" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT " misses, %" G_GUINT64_FORMAT " waits (%" G_GUINT64_FORMAT " µs), %" G_GUINT64_FORMAT " failures, %" G_GUINT64_FORMAT " broken, %" G_GUINT64_FORMAT " closed while idle.",
+		queue->server,
+		queue->statistics[J_CONNECTION_POOL_HITS],
+		queue->statistics[J_CONNECTION_POOL_MISSES],
+		queue->statistics[J_CONNECTION_POOL_WAITS],
+		queue->statistics[J_CONNECTION_POOL_WAIT_TIME],
+		queue->statistics[J_CONNECTION_POOL_FAILURES],
+		queue->statistics[J_CONNECTION_POOL_BROKEN],
+		queue->statistics[J_CONNECTION_POOL_IDLE_CLOSED]);
+
+	while ((entry = g_queue_pop_head(queue->entries)) != NULL)
+	{
+		j_connection_pool_close(entry->connection);
+		g_free(entry);
+	}
+
+	g_queue_free(queue->entries);
+	g_cond_clear(&(queue->cond));
+	g_mutex_clear(&(queue->mutex));
+}
+
+/**
+ * Establishes the minimum number of connections to a server.
+ *
+ * \private
+ *
+ * \param data A queue.
+ *
+ * \return NULL.
+ **/
+static gpointer
+j_connection_pool_warm_up(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnectionPoolQueue* queue = data;
+
+	for (guint i = 0; i < j_connection_pool->min_count; i++)
+	{
+		GError* error = NULL;
+		GSocketConnection* connection;
+		JConnectionPoolEntry* entry;
+
+		connection = j_connection_pool_connect(j_connection_pool->configuration, queue->server, &error);
+
+		g_mutex_lock(&(queue->mutex));
+
+		if (connection == NULL)
+		{
+			queue->statistics[J_CONNECTION_POOL_FAILURES]++;
+			g_mutex_unlock(&(queue->mutex));
+
+			// Connecting will be retried when the connection is needed
+			g_warning("Can not connect to %s: %s", queue->server, error->message);
+			g_error_free(error);
+
+			break;
+		}
+
+		entry = g_new(JConnectionPoolEntry, 1);
+		entry->connection = connection;
+		entry->idle_since = g_get_monotonic_time();
+
+		g_queue_push_head(queue->entries, entry);
+		queue->count++;
+
+		g_mutex_unlock(&(queue->mutex));
+	}
+
+	return NULL;
+}
+
+/**
+ * Returns a server's queue.
+ *
+ * \private
+ *
+ * \param pool    A connection pool.
+ * \param backend A backend type.
+ * \param index   A server index.
+ *
+ * \return The queue, NULL if the index is invalid.
+ **/
+static JConnectionPoolQueue*
+j_connection_pool_get_queue(JConnectionPool* pool, JBackendType backend, guint32 index)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (backend)
+	{
+		case J_BACKEND_TYPE_OBJECT:
+			g_return_val_if_fail(index < pool->object_len, NULL);
+			return &(pool->object_queues[index]);
+		case J_BACKEND_TYPE_KV:
+			g_return_val_if_fail(index < pool->kv_len, NULL);
+			return &(pool->kv_queues[index]);
+		case J_BACKEND_TYPE_DB:
+			g_return_val_if_fail(index < pool->db_len, NULL);
+			return &(pool->db_queues[index]);
+		default:
+			g_assert_not_reached();
+	}
+
+	return NULL;
+}
+
 void
 j_connection_pool_init(JConfiguration* configuration)
 {
@@ -85,26 +417,53 @@ j_connection_pool_init(JConfiguration* configuration)
 	pool->db_len = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_DB);
 	pool->db_queues = g_new(JConnectionPoolQueue, pool->db_len);
 	pool->max_count = j_configuration_get_max_connections(configuration);
+	pool->min_count = j_configuration_get_min_connections(configuration);
+	pool->idle_timeout = j_configuration_get_idle_timeout(configuration) * G_USEC_PER_SEC;
 
 	for (guint i = 0; i < pool->object_len; i++)
 	{
-		pool->object_queues[i].queue = g_async_queue_new();
-		pool->object_queues[i].count = 0;
+		j_connection_pool_queue_init(&(pool->object_queues[i]), j_configuration_get_server(configuration, J_BACKEND_TYPE_OBJECT, i));
 	}
 
 	for (guint i = 0; i < pool->kv_len; i++)
 	{
-		pool->kv_queues[i].queue = g_async_queue_new();
-		pool->kv_queues[i].count = 0;
+		j_connection_pool_queue_init(&(pool->kv_queues[i]), j_configuration_get_server(configuration, J_BACKEND_TYPE_KV, i));
 	}
 
 	for (guint i = 0; i < pool->db_len; i++)
 	{
-		pool->db_queues[i].queue = g_async_queue_new();
-		pool->db_queues[i].count = 0;
+		j_connection_pool_queue_init(&(pool->db_queues[i]), j_configuration_get_server(configuration, J_BACKEND_TYPE_DB, i));
 	}
 
 	g_atomic_pointer_set(&j_connection_pool, pool);
+
+	if (pool->min_count > 0)
+	{
+		g_autoptr(GPtrArray) threads = NULL;
+
+		threads = g_ptr_array_new();
+
+		// Connect to all servers in parallel, so startup only has to wait for the slowest one
+		for (guint i = 0; i < pool->object_len; i++)
+		{
+			g_ptr_array_add(threads, g_thread_new("JConnectionPool", j_connection_pool_warm_up, &(pool->object_queues[i])));
+		}
+
+		for (guint i = 0; i < pool->kv_len; i++)
+		{
+			g_ptr_array_add(threads, g_thread_new("JConnectionPool", j_connection_pool_warm_up, &(pool->kv_queues[i])));
+		}
+
+		for (guint i = 0; i < pool->db_len; i++)
+		{
+			g_ptr_array_add(threads, g_thread_new("JConnectionPool", j_connection_pool_warm_up, &(pool->db_queues[i])));
+		}
+
+		for (guint i = 0; i < threads->len; i++)
+		{
+			g_thread_join(g_ptr_array_index(threads, i));
+		}
+	}
 }
 
 void
@@ -121,41 +480,17 @@ j_connection_pool_fini(void)
 
 	for (guint i = 0; i < pool->object_len; i++)
 	{
-		GSocketConnection* connection;
-
-		while ((connection = g_async_queue_try_pop(pool->object_queues[i].queue)) != NULL)
-		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
-		}
-
-		g_async_queue_unref(pool->object_queues[i].queue);
+		j_connection_pool_queue_fini(&(pool->object_queues[i]));
 	}
 
 	for (guint i = 0; i < pool->kv_len; i++)
 	{
-		GSocketConnection* connection;
-
-		while ((connection = g_async_queue_try_pop(pool->kv_queues[i].queue)) != NULL)
-		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
-		}
-
-		g_async_queue_unref(pool->kv_queues[i].queue);
+		j_connection_pool_queue_fini(&(pool->kv_queues[i]));
 	}
 
 	for (guint i = 0; i < pool->db_len; i++)
 	{
-		GSocketConnection* connection;
-
-		while ((connection = g_async_queue_try_pop(pool->db_queues[i].queue)) != NULL)
-		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
-		}
-
-		g_async_queue_unref(pool->db_queues[i].queue);
+		j_connection_pool_queue_fini(&(pool->db_queues[i]));
 	}
 
 	j_configuration_unref(pool->configuration);
@@ -168,115 +503,155 @@ j_connection_pool_fini(void)
 }
 
 static GSocketConnection*
-j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* server)
+j_connection_pool_pop_internal(JConnectionPoolQueue* queue)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GSocketConnection* connection;
+	GSocketConnection* connection = NULL;
+	gint64 wait_start = 0;
+	guint attempts = 0;
 
 	g_return_val_if_fail(queue != NULL, NULL);
-	g_return_val_if_fail(count != NULL, NULL);
 
-	connection = g_async_queue_try_pop(queue);
+	g_mutex_lock(&(queue->mutex));
 
-	if (connection != NULL)
+	while (connection == NULL)
 	{
-		return connection;
-	}
+		JConnectionPoolEntry* entry;
 
-	if ((guint)g_atomic_int_get(count) < j_connection_pool->max_count)
-	{
-		if ((guint)g_atomic_int_add(count, 1) < j_connection_pool->max_count)
+		if ((entry = g_queue_pop_head(queue->entries)) != NULL)
 		{
-			GError* error = NULL;
-			g_autoptr(GSocketClient) client = NULL;
-
-			g_autoptr(JMessage) message = NULL;
-			g_autoptr(JMessage) reply = NULL;
+			connection = entry->connection;
+			g_free(entry);
 
-			gchar const* client_checksum;
-			gchar const* server_checksum;
-			guint op_count;
+			if (!j_connection_pool_check(connection))
+			{
+				// The connection is replaced transparently
+				queue->count--;
+				queue->statistics[J_CONNECTION_POOL_BROKEN]++;
 
-			client = g_socket_client_new();
-			connection = g_socket_client_connect_to_host(client, server, j_configuration_get_port(j_configuration()), NULL, &error);
+				j_connection_pool_close(connection);
+				connection = NULL;
 
-			if (error != NULL)
-			{
-				g_critical("%s", error->message);
-				g_error_free(error);
+				continue;
 			}
 
-			if (connection == NULL)
+			if (wait_start == 0)
 			{
-				g_critical("Can not connect to %s [%d].", server, g_atomic_int_get(count));
+				queue->statistics[J_CONNECTION_POOL_HITS]++;
 			}
 
-			j_helper_set_nodelay(connection, TRUE);
+			break;
+		}
 
-			client_checksum = j_configuration_get_checksum(j_configuration());
+		if (queue->count < j_connection_pool->max_count)
+		{
+			GError* error = NULL;
 
-			message = j_message_new(J_MESSAGE_PING, strlen(client_checksum) + 1);
-			j_message_append_string(message, client_checksum);
-			j_message_send(message, connection);
+			queue->count++;
+			g_mutex_unlock(&(queue->mutex));
 
-			reply = j_message_new_reply(message);
-			j_message_receive(reply, connection);
+			connection = j_connection_pool_connect(j_connection_pool->configuration, queue->server, &error);
 
-			server_checksum = j_message_get_string(reply);
+			g_mutex_lock(&(queue->mutex));
 
-			if (g_strcmp0(client_checksum, server_checksum) != 0)
+			if (connection != NULL)
 			{
-				g_warning("Server %s uses different configuration than client.", server);
+				queue->statistics[J_CONNECTION_POOL_MISSES]++;
+				break;
 			}
 
-			op_count = j_message_get_count(reply);
+			queue->count--;
+			queue->statistics[J_CONNECTION_POOL_FAILURES]++;
+			attempts++;
+
+			g_critical("Can not connect to %s [%u]: %s", queue->server, queue->count, error->message);
+			g_error_free(error);
 
-			for (guint i = 0; i < op_count; i++)
+			// Another thread might be waiting for a free slot
+			g_cond_signal(&(queue->cond));
+
+			if (attempts >= J_CONNECTION_POOL_CONNECT_ATTEMPTS)
 			{
-				gchar const* backend;
-
-				backend = j_message_get_string(reply);
-
-				if (g_strcmp0(backend, "object") == 0)
-				{
-					//g_print("Server has object backend.\n");
-				}
-				else if (g_strcmp0(backend, "kv") == 0)
-				{
-					//g_print("Server has kv backend.\n");
-				}
-				else if (g_strcmp0(backend, "db") == 0)
-				{
-					//g_print("Server has db backend.\n");
-				}
+				break;
 			}
+
+			g_mutex_unlock(&(queue->mutex));
+			g_usleep(attempts * 100 * G_TIME_SPAN_MILLISECOND);
+			g_mutex_lock(&(queue->mutex));
+
+			continue;
 		}
-		else
+
+		if (wait_start == 0)
 		{
-			g_atomic_int_add(count, -1);
+			queue->statistics[J_CONNECTION_POOL_WAITS]++;
+			wait_start = g_get_monotonic_time();
 		}
+
+		g_cond_wait(&(queue->cond), &(queue->mutex));
 	}
 
-	if (connection != NULL)
+	if (wait_start != 0)
 	{
-		return connection;
+		queue->statistics[J_CONNECTION_POOL_WAIT_TIME] += g_get_monotonic_time() - wait_start;
 	}
 
-	connection = g_async_queue_pop(queue);
+	g_mutex_unlock(&(queue->mutex));
 
 	return connection;
 }
 
 static void
-j_connection_pool_push_internal(GAsyncQueue* queue, GSocketConnection* connection)
+j_connection_pool_push_internal(JConnectionPoolQueue* queue, GSocketConnection* connection)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	GList* idle = NULL;
+	gint64 now;
+
 	g_return_if_fail(queue != NULL);
 	g_return_if_fail(connection != NULL);
 
-	g_async_queue_push(queue, connection);
+	now = g_get_monotonic_time();
+
+	g_mutex_lock(&(queue->mutex));
+
+	if (g_io_stream_is_closed(G_IO_STREAM(connection)))
+	{
+		queue->count--;
+		queue->statistics[J_CONNECTION_POOL_BROKEN]++;
+
+		g_object_unref(connection);
+	}
+	else
+	{
+		JConnectionPoolEntry* entry;
+
+		entry = g_new(JConnectionPoolEntry, 1);
+		entry->connection = connection;
+		entry->idle_since = now;
+
+		// Reusing the most recently used connection first lets the others become idle
+		g_queue_push_head(queue->entries, entry);
+
+		while (queue->count > j_connection_pool->min_count
+		       && (entry = g_queue_peek_tail(queue->entries)) != NULL
+		       && now - entry->idle_since > j_connection_pool->idle_timeout)
+		{
+			g_queue_pop_tail(queue->entries);
+			idle = g_list_prepend(idle, entry->connection);
+			g_free(entry);
+
+			queue->count--;
+			queue->statistics[J_CONNECTION_POOL_IDLE_CLOSED]++;
+		}
+	}
+
+	g_cond_signal(&(queue->cond));
+	g_mutex_unlock(&(queue->mutex));
+
+	g_list_free_full(idle, (GDestroyNotify)j_connection_pool_close);
 }
 
 gpointer
@@ -284,24 +659,16 @@ j_connection_pool_pop(JBackendType backend, guint32 index)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JConnectionPoolQueue* queue;
+
 	g_return_val_if_fail(j_connection_pool != NULL, NULL);
 
-	switch (backend)
+	if ((queue = j_connection_pool_get_queue(j_connection_pool, backend, index)) == NULL)
 	{
-		case J_BACKEND_TYPE_OBJECT:
-			g_return_val_if_fail(index < j_connection_pool->object_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->object_queues[index].queue, &(j_connection_pool->object_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_OBJECT, index));
-		case J_BACKEND_TYPE_KV:
-			g_return_val_if_fail(index < j_connection_pool->kv_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->kv_queues[index].queue, &(j_connection_pool->kv_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_KV, index));
-		case J_BACKEND_TYPE_DB:
-			g_return_val_if_fail(index < j_connection_pool->db_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->db_queues[index].queue, &(j_connection_pool->db_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_DB, index));
-		default:
-			g_assert_not_reached();
+		return NULL;
 	}
 
-	return NULL;
+	return j_connection_pool_pop_internal(queue);
 }
 
 void
@@ -309,26 +676,49 @@ j_connection_pool_push(JBackendType backend, guint32 index, gpointer connection)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JConnectionPoolQueue* queue;
+
 	g_return_if_fail(j_connection_pool != NULL);
 	g_return_if_fail(connection != NULL);
 
-	switch (backend)
+	if ((queue = j_connection_pool_get_queue(j_connection_pool, backend, index)) == NULL)
 	{
-		case J_BACKEND_TYPE_OBJECT:
-			g_return_if_fail(index < j_connection_pool->object_len);
-			j_connection_pool_push_internal(j_connection_pool->object_queues[index].queue, connection);
-			break;
-		case J_BACKEND_TYPE_KV:
-			g_return_if_fail(index < j_connection_pool->kv_len);
-			j_connection_pool_push_internal(j_connection_pool->kv_queues[index].queue, connection);
-			break;
-		case J_BACKEND_TYPE_DB:
-			g_return_if_fail(index < j_connection_pool->db_len);
-			j_connection_pool_push_internal(j_connection_pool->db_queues[index].queue, connection);
-			break;
-		default:
-			g_assert_not_reached();
+		return;
 	}
+
+	j_connection_pool_push_internal(queue, connection);
+}
+
+guint64
+j_connection_pool_get_statistics(JBackendType backend, guint32 index, JConnectionPoolStatistics type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnectionPoolQueue* queue;
+	guint64 value;
+
+	g_return_val_if_fail(j_connection_pool != NULL, 0);
+	g_return_val_if_fail(type <= J_CONNECTION_POOL_CONNECTIONS, 0);
+
+	if ((queue = j_connection_pool_get_queue(j_connection_pool, backend, index)) == NULL)
+	{
+		return 0;
+	}
+
+	g_mutex_lock(&(queue->mutex));
+
+	if (type == J_CONNECTION_POOL_CONNECTIONS)
+	{
+		value = queue->count;
+	}
+	else
+	{
+		value = queue->statistics[type];
+	}
+
+	g_mutex_unlock(&(queue->mutex));
+
+	return value;
 }
 
 /**
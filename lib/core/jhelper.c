@@ -156,6 +156,8 @@ j_helper_execute_parallel(JBackgroundOperationFunc func, gpointer* data, guint l
 		}
 	}
 
+	j_background_operation_wait_all(operations, length);
+
 	for (guint i = 0; i < length; i++)
 	{
 		if (operations[i] != NULL)
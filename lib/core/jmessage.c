@@ -25,15 +25,25 @@
 #include <glib.h>
 #include <gio/gio.h>
 
-#include <math.h>
+#include <errno.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 
 #include <jmessage.h>
 
+#include <jconfiguration.h>
 #include <jhelper.h>
 #include <jlist.h>
 #include <jlist-iterator.h>
 #include <jsemantics.h>
+#include <jstatistics.h>
 #include <jtrace.h>
 
 /**
@@ -42,6 +52,26 @@
  * @{
  **/
 
+/**
+ * The maximum number of vectors passed to a single system call.
+ **/
+#if defined(IOV_MAX)
+#define J_MESSAGE_MAX_VECTORS IOV_MAX
+#elif defined(__linux__)
+#define J_MESSAGE_MAX_VECTORS 1024
+#else
+#define J_MESSAGE_MAX_VECTORS 16
+#endif
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#define J_MESSAGE_ZEROCOPY
+#endif
+
+/**
+ * The maximum time in milliseconds to wait for a zero-copy completion.
+ **/
+#define J_MESSAGE_ZEROCOPY_TIMEOUT 60000
+
 enum JMessageSemantics
 {
 	J_MESSAGE_SEMANTICS_ATOMICITY_BATCH = 1 << 0,
@@ -79,6 +109,8 @@ typedef struct JMessageData JMessageData;
 
 /**
  * A message header.
+ * This is the extended header used by protocol version 2 and later.
+ * Version 2 only transmits the fields up to the trace context.
  **/
 #pragma pack(4)
 struct JMessageHeader
@@ -86,7 +118,7 @@ struct JMessageHeader
 	/**
 	 * The message length.
 	 **/
-	guint32 length;
+	guint64 length;
 
 	/**
 	 * The message ID.
@@ -107,12 +139,41 @@ struct JMessageHeader
 	 * The operation count.
 	 **/
 	guint32 op_count;
+
+	/**
+	 * The trace ID, see j_trace_get_correlation().
+	 **/
+	guint64 trace_id;
+
+	/**
+	 * The span ID, shared by a request and its replies.
+	 **/
+	guint64 span_id;
 };
 #pragma pack()
 
 typedef struct JMessageHeader JMessageHeader;
 
-G_STATIC_ASSERT(sizeof(JMessageHeader) == 5 * sizeof(guint32));
+G_STATIC_ASSERT(sizeof(JMessageHeader) == 10 * sizeof(guint32));
+
+/**
+ * A message header as used by protocol version 1.
+ * It only differs from the extended header in the length's size.
+ **/
+#pragma pack(4)
+struct JMessageHeaderCompat
+{
+	guint32 length;
+	guint32 id;
+	guint32 semantics;
+	guint32 op_type;
+	guint32 op_count;
+};
+#pragma pack()
+
+typedef struct JMessageHeaderCompat JMessageHeaderCompat;
+
+G_STATIC_ASSERT(sizeof(JMessageHeaderCompat) == 5 * sizeof(guint32));
 
 /**
  * A message.
@@ -174,11 +235,11 @@ j_message_length(JMessage const* message)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	guint32 length;
+	guint64 length;
 
 	length = message->header.length;
 
-	return GUINT32_FROM_LE(length);
+	return GUINT64_FROM_LE(length);
 }
 
 static void
@@ -189,6 +250,280 @@ j_message_data_free(gpointer data)
 	g_free(data);
 }
 
+/**
+ * The size of the smallest buffer size class.
+ **/
+#define J_MESSAGE_POOL_MIN_SIZE 256
+
+/**
+ * The number of buffer size classes, each one being twice as large as the previous one.
+ * Larger buffers are not cached.
+ **/
+#define J_MESSAGE_POOL_CLASSES 9
+
+/**
+ * The maximum number of buffers and messages cached per thread and size class.
+ **/
+#define J_MESSAGE_POOL_DEPTH 16
+
+/**
+ * A thread-local pool of messages and their buffers.
+ **/
+struct JMessagePool
+{
+	/**
+	 * The cached buffers, one stack per size class.
+	 **/
+	gchar* buffers[J_MESSAGE_POOL_CLASSES][J_MESSAGE_POOL_DEPTH];
+
+	/**
+	 * The number of cached buffers per size class.
+	 **/
+	guint buffers_len[J_MESSAGE_POOL_CLASSES];
+
+	/**
+	 * The cached messages, without buffers.
+	 **/
+	JMessage* messages[J_MESSAGE_POOL_DEPTH];
+
+	/**
+	 * The number of cached messages.
+	 **/
+	guint messages_len;
+};
+
+typedef struct JMessagePool JMessagePool;
+
+static void j_message_pool_free(gpointer);
+
+static GPrivate j_message_pool = G_PRIVATE_INIT(j_message_pool_free);
+
+/**
+ * Frees a thread's pool when the thread exits.
+ *
+ * \private
+ *
+ * \param data A pool.
+ **/
+static void
+j_message_pool_free(gpointer data)
+{
+	JMessagePool* pool = data;
+
+	for (guint i = 0; i < J_MESSAGE_POOL_CLASSES; i++)
+	{
+		for (guint j = 0; j < pool->buffers_len[i]; j++)
+		{
+			g_free(pool->buffers[i][j]);
+		}
+	}
+
+	for (guint i = 0; i < pool->messages_len; i++)
+	{
+		j_list_unref(pool->messages[i]->send_list);
+		g_free(pool->messages[i]);
+	}
+
+	g_free(pool);
+}
+
+/**
+ * Returns the current thread's pool.
+ *
+ * \private
+ *
+ * \return The pool.
+ **/
+static JMessagePool*
+j_message_pool_get(void)
+{
+	JMessagePool* pool;
+
+	pool = g_private_get(&j_message_pool);
+
+	if (G_UNLIKELY(pool == NULL))
+	{
+		pool = g_new0(JMessagePool, 1);
+		g_private_set(&j_message_pool, pool);
+	}
+
+	return pool;
+}
+
+/**
+ * Allocates a message buffer.
+ *
+ * \private
+ *
+ * \param size A size, rounded up to the buffer's actual size.
+ *
+ * \return A buffer. Should be freed with j_message_buffer_free().
+ **/
+static gchar*
+j_message_buffer_new(gsize* size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessagePool* pool;
+	gsize class_size = J_MESSAGE_POOL_MIN_SIZE;
+
+	for (guint i = 0; i < J_MESSAGE_POOL_CLASSES; i++, class_size *= 2)
+	{
+		if (*size <= class_size)
+		{
+			*size = class_size;
+			pool = j_message_pool_get();
+
+			if (pool->buffers_len[i] > 0)
+			{
+				pool->buffers_len[i]--;
+				return pool->buffers[i][pool->buffers_len[i]];
+			}
+
+			return g_malloc(class_size);
+		}
+	}
+
+	return g_malloc(*size);
+}
+
+/**
+ * Frees a message buffer, caching it if possible.
+ *
+ * \private
+ *
+ * \param buffer A buffer.
+ * \param size   The buffer's size as returned by j_message_buffer_new().
+ **/
+static void
+j_message_buffer_free(gchar* buffer, gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessagePool* pool;
+	gsize class_size = J_MESSAGE_POOL_MIN_SIZE;
+
+	for (guint i = 0; i < J_MESSAGE_POOL_CLASSES; i++, class_size *= 2)
+	{
+		if (size == class_size)
+		{
+			pool = j_message_pool_get();
+
+			if (pool->buffers_len[i] < J_MESSAGE_POOL_DEPTH)
+			{
+				pool->buffers[i][pool->buffers_len[i]] = buffer;
+				pool->buffers_len[i]++;
+				return;
+			}
+
+			break;
+		}
+	}
+
+	g_free(buffer);
+}
+
+/**
+ * Allocates a message, including its buffer.
+ *
+ * \private
+ *
+ * \param size The minimum buffer size.
+ *
+ * \return A new message.
+ **/
+static JMessage*
+j_message_alloc(gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessagePool* pool;
+	JMessage* message;
+
+	pool = j_message_pool_get();
+
+	if (pool->messages_len > 0)
+	{
+		pool->messages_len--;
+		message = pool->messages[pool->messages_len];
+	}
+	else
+	{
+		message = g_new(JMessage, 1);
+		message->send_list = j_list_new(j_message_data_free);
+	}
+
+	message->size = size;
+	message->data = j_message_buffer_new(&(message->size));
+	message->current = message->data;
+	message->original_message = NULL;
+	message->ref_count = 1;
+
+	return message;
+}
+
+/**
+ * Frees a message, caching it and its buffer if possible.
+ *
+ * \private
+ *
+ * \param message A message.
+ **/
+static void
+j_message_release(JMessage* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessagePool* pool;
+
+	j_message_buffer_free(message->data, message->size);
+	j_list_delete_all(message->send_list);
+
+	pool = j_message_pool_get();
+
+	if (pool->messages_len < J_MESSAGE_POOL_DEPTH)
+	{
+		pool->messages[pool->messages_len] = message;
+		pool->messages_len++;
+		return;
+	}
+
+	j_list_unref(message->send_list);
+	g_free(message);
+}
+
+/**
+ * Resizes a message's buffer.
+ *
+ * \private
+ *
+ * \param message A message.
+ * \param size    The new minimum size.
+ * \param copy    The number of bytes to preserve.
+ **/
+static void
+j_message_resize(JMessage* message, gsize size, gsize copy)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gchar* data;
+	gsize position;
+
+	position = message->current - message->data;
+	data = j_message_buffer_new(&size);
+
+	if (copy > 0)
+	{
+		memcpy(data, message->data, copy);
+	}
+
+	j_message_buffer_free(message->data, message->size);
+
+	message->size = size;
+	message->data = data;
+	message->current = message->data + position;
+}
+
 /**
  * Checks whether it is possible to append data to a message.
  *
@@ -236,10 +571,7 @@ j_message_extend(JMessage* message, gsize length)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gsize factor = 1;
 	gsize current_length;
-	gsize position;
-	guint32 count;
 
 	if (length == 0)
 	{
@@ -253,18 +585,8 @@ j_message_extend(JMessage* message, gsize length)
 		return;
 	}
 
-	count = j_message_get_count(message);
-
-	if (count > 10)
-	{
-		factor = pow(10, floor(log10(count)));
-	}
-
-	message->size += length * factor;
-
-	position = message->current - message->data;
-	message->data = g_realloc(message->data, message->size);
-	message->current = message->data + position;
+	// Grow geometrically to keep the number of copies low
+	j_message_resize(message, MAX(current_length + length, message->size * 2), current_length);
 }
 
 static void
@@ -272,18 +594,13 @@ j_message_ensure_size(JMessage* message, gsize length)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gsize position;
-
 	if (length <= message->size)
 	{
 		return;
 	}
 
-	message->size = length;
-
-	position = message->current - message->data;
-	message->data = g_realloc(message->data, message->size);
-	message->current = message->data + position;
+	// The buffer's content is about to be overwritten
+	j_message_resize(message, length, 0);
 }
 
 JMessage*
@@ -296,22 +613,18 @@ j_message_new(JMessageType op_type, gsize length)
 
 	//g_return_val_if_fail(op_type != J_MESSAGE_NONE, NULL);
 
-	length = MAX(256, length);
 	rand = g_random_int();
 
-	message = g_new(JMessage, 1);
-	message->size = length;
-	message->data = g_malloc(message->size);
-	message->current = message->data;
-	message->send_list = j_list_new(j_message_data_free);
-	message->original_message = NULL;
-	message->ref_count = 1;
+	message = j_message_alloc(length);
 
-	message->header.length = GUINT32_TO_LE(0);
+	message->header.length = GUINT64_TO_LE(0);
 	message->header.id = GUINT32_TO_LE(rand);
 	message->header.semantics = GUINT32_TO_LE(0);
 	message->header.op_type = GUINT32_TO_LE(op_type);
 	message->header.op_count = GUINT32_TO_LE(0);
+	// the span is created when the message is sent
+	message->header.trace_id = GUINT64_TO_LE(j_trace_get_correlation());
+	message->header.span_id = GUINT64_TO_LE(0);
 
 	return message;
 }
@@ -325,19 +638,16 @@ j_message_new_reply(JMessage* message)
 
 	g_return_val_if_fail(message != NULL, NULL);
 
-	reply = g_new(JMessage, 1);
-	reply->size = 256;
-	reply->data = g_malloc(reply->size);
-	reply->current = reply->data;
-	reply->send_list = j_list_new(j_message_data_free);
+	reply = j_message_alloc(0);
 	reply->original_message = j_message_ref(message);
-	reply->ref_count = 1;
 
-	reply->header.length = GUINT32_TO_LE(0);
+	reply->header.length = GUINT64_TO_LE(0);
 	reply->header.id = message->header.id;
 	reply->header.semantics = GUINT32_TO_LE(0);
 	reply->header.op_type = message->header.op_type;
 	reply->header.op_count = GUINT32_TO_LE(0);
+	reply->header.trace_id = message->header.trace_id;
+	reply->header.span_id = message->header.span_id;
 
 	return reply;
 }
@@ -368,14 +678,7 @@ j_message_unref(JMessage* message)
 			j_message_unref(message->original_message);
 		}
 
-		if (message->send_list != NULL)
-		{
-			j_list_unref(message->send_list);
-		}
-
-		g_free(message->data);
-
-		g_free(message);
+		j_message_release(message);
 	}
 }
 
@@ -409,12 +712,22 @@ j_message_get_count(JMessage const* message)
 	return op_count;
 }
 
+guint64
+j_message_get_length(JMessage const* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(message != NULL, 0);
+
+	return j_message_length(message);
+}
+
 gboolean
 j_message_append_1(JMessage* message, gconstpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	guint32 new_length;
+	guint64 new_length;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -424,7 +737,7 @@ j_message_append_1(JMessage* message, gconstpointer data)
 	message->current += 1;
 
 	new_length = j_message_length(message) + 1;
-	message->header.length = GUINT32_TO_LE(new_length);
+	message->header.length = GUINT64_TO_LE(new_length);
 
 	return TRUE;
 }
@@ -435,7 +748,7 @@ j_message_append_4(JMessage* message, gconstpointer data)
 	J_TRACE_FUNCTION(NULL);
 
 	gint32 new_data;
-	guint32 new_length;
+	guint64 new_length;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -446,7 +759,7 @@ j_message_append_4(JMessage* message, gconstpointer data)
 	message->current += 4;
 
 	new_length = j_message_length(message) + 4;
-	message->header.length = GUINT32_TO_LE(new_length);
+	message->header.length = GUINT64_TO_LE(new_length);
 
 	return TRUE;
 }
@@ -457,7 +770,7 @@ j_message_append_8(JMessage* message, gconstpointer data)
 	J_TRACE_FUNCTION(NULL);
 
 	gint64 new_data;
-	guint32 new_length;
+	guint64 new_length;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -468,7 +781,7 @@ j_message_append_8(JMessage* message, gconstpointer data)
 	message->current += 8;
 
 	new_length = j_message_length(message) + 8;
-	message->header.length = GUINT32_TO_LE(new_length);
+	message->header.length = GUINT64_TO_LE(new_length);
 
 	return TRUE;
 }
@@ -478,7 +791,7 @@ j_message_append_n(JMessage* message, gconstpointer data, gsize length)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	guint32 new_length;
+	guint64 new_length;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -488,7 +801,7 @@ j_message_append_n(JMessage* message, gconstpointer data, gsize length)
 	message->current += length;
 
 	new_length = j_message_length(message) + length;
-	message->header.length = GUINT32_TO_LE(new_length);
+	message->header.length = GUINT64_TO_LE(new_length);
 
 	return TRUE;
 }
@@ -585,44 +898,69 @@ j_message_get_string(JMessage* message)
 	return ret;
 }
 
-gboolean
-j_message_receive(JMessage* message, gpointer connection)
+/**
+ * Converts a message's header to protocol version 1.
+ *
+ * \private
+ *
+ * \param message A message.
+ * \param compat  Returns the header.
+ *
+ * \return TRUE on success, FALSE if the message is too long.
+ **/
+static gboolean
+j_message_header_to_compat(JMessage const* message, JMessageHeaderCompat* compat)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GInputStream* stream;
+	guint64 length;
 
-	g_return_val_if_fail(message != NULL, FALSE);
-	g_return_val_if_fail(connection != NULL, FALSE);
+	length = j_message_length(message);
 
-	stream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
-	return j_message_read(message, stream);
+	if (length > G_MAXUINT32)
+	{
+		g_critical("Message length %" G_GUINT64_FORMAT " requires protocol version 2.", length);
+		return FALSE;
+	}
+
+	compat->length = GUINT32_TO_LE((guint32)length);
+	compat->id = message->header.id;
+	compat->semantics = message->header.semantics;
+	compat->op_type = message->header.op_type;
+	compat->op_count = message->header.op_count;
+
+	return TRUE;
 }
 
-gboolean
-j_message_send(JMessage* message, gpointer connection)
+/**
+ * Returns the size of the extended header for a protocol version.
+ * Newer versions append fields, so older ones transmit a prefix of the header.
+ *
+ * \private
+ *
+ * \param version A protocol version of at least 2.
+ *
+ * \return The header size.
+ **/
+static gsize
+j_message_header_size(guint32 version)
 {
-	J_TRACE_FUNCTION(NULL);
+	return (version >= 3) ? sizeof(JMessageHeader) : G_STRUCT_OFFSET(JMessageHeader, trace_id);
+}
 
-	gboolean ret;
-
-	GOutputStream* stream;
-
-	g_return_val_if_fail(message != NULL, FALSE);
-	g_return_val_if_fail(connection != NULL, FALSE);
-
-	j_helper_set_cork(connection, TRUE);
-
-	stream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
-	ret = j_message_write(message, stream);
-
-	j_helper_set_cork(connection, FALSE);
-
-	return ret;
-}
-
-gboolean
-j_message_read(JMessage* message, GInputStream* stream)
+/**
+ * Reads a message from a stream.
+ *
+ * \private
+ *
+ * \param message A message.
+ * \param stream  A stream.
+ * \param version The protocol version.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_read_internal(JMessage* message, GInputStream* stream, guint32 version)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -631,12 +969,39 @@ j_message_read(JMessage* message, GInputStream* stream)
 	GError* error = NULL;
 	gsize bytes_read;
 
-	g_return_val_if_fail(message != NULL, FALSE);
-	g_return_val_if_fail(stream != NULL, FALSE);
+	if (version >= 2)
+	{
+		gsize header_size;
+
+		header_size = j_message_header_size(version);
 
-	if (!g_input_stream_read_all(stream, &(message->header), sizeof(JMessageHeader), &bytes_read, NULL, &error) || bytes_read != sizeof(JMessageHeader))
+		if (!g_input_stream_read_all(stream, &(message->header), header_size, &bytes_read, NULL, &error) || bytes_read != header_size)
+		{
+			goto end;
+		}
+
+		if (version < 3)
+		{
+			message->header.trace_id = GUINT64_TO_LE(0);
+			message->header.span_id = GUINT64_TO_LE(0);
+		}
+	}
+	else
 	{
-		goto end;
+		JMessageHeaderCompat compat;
+
+		if (!g_input_stream_read_all(stream, &compat, sizeof(JMessageHeaderCompat), &bytes_read, NULL, &error) || bytes_read != sizeof(JMessageHeaderCompat))
+		{
+			goto end;
+		}
+
+		message->header.length = GUINT64_TO_LE((guint64)GUINT32_FROM_LE(compat.length));
+		message->header.id = compat.id;
+		message->header.semantics = compat.semantics;
+		message->header.op_type = compat.op_type;
+		message->header.op_count = compat.op_count;
+		message->header.trace_id = GUINT64_TO_LE(0);
+		message->header.span_id = GUINT64_TO_LE(0);
 	}
 
 	j_message_ensure_size(message, j_message_length(message));
@@ -665,50 +1030,404 @@ end:
 	return ret;
 }
 
+guint32
+j_message_get_version(gpointer connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gpointer version;
+
+	g_return_val_if_fail(connection != NULL, 1);
+
+	version = g_object_get_data(G_OBJECT(connection), "j-message-version");
+
+	return (version != NULL) ? GPOINTER_TO_UINT(version) : 1;
+}
+
+void
+j_message_set_version(gpointer connection, guint32 version)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+	g_return_if_fail(version >= 1 && version <= J_MESSAGE_VERSION);
+
+	g_object_set_data(G_OBJECT(connection), "j-message-version", GUINT_TO_POINTER(version));
+}
+
+void
+j_message_set_zerocopy_size(gpointer connection, guint64 zerocopy_size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64* size;
+
+	g_return_if_fail(connection != NULL);
+
+	size = g_new(guint64, 1);
+	*size = zerocopy_size;
+
+	g_object_set_data_full(G_OBJECT(connection), "j-message-zerocopy-size", size, g_free);
+}
+
 gboolean
-j_message_write(JMessage* message, GOutputStream* stream)
+j_message_receive(JMessage* message, gpointer connection)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gboolean ret = FALSE;
+	GInputStream* stream;
+	guint64 span_id;
+
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(connection != NULL, FALSE);
+
+	stream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+
+	if (!j_message_read_internal(message, stream, j_message_get_version(connection)))
+	{
+		return FALSE;
+	}
+
+	span_id = GUINT64_FROM_LE(message->header.span_id);
+
+	if (span_id != 0)
+	{
+		// servers receive requests, clients receive replies
+		j_trace_flow(j_statistics_get_operation_name(j_message_get_type(message)), (message->original_message == NULL) ? J_TRACE_FLOW_STEP : J_TRACE_FLOW_END, span_id);
+	}
+
+	return TRUE;
+}
+
+guint64
+j_message_get_trace_id(JMessage const* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(message != NULL, 0);
+
+	return GUINT64_FROM_LE(message->header.trace_id);
+}
+
+guint64
+j_message_get_span_id(JMessage const* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(message != NULL, 0);
+
+	return GUINT64_FROM_LE(message->header.span_id);
+}
+
+/**
+ * Collects the header, the data and the send list of a message.
+ *
+ * \private
+ *
+ * \param message   A message.
+ * \param compat    A header for protocol version 1, or NULL to use the extended header.
+ * \param version   The protocol version, only used for the extended header.
+ * \param n_vectors Returns the number of vectors.
+ * \param size      Returns the size of the send list.
+ *
+ * \return The vectors, to be freed with g_free().
+ **/
+static GOutputVector*
+j_message_get_vectors(JMessage* message, JMessageHeaderCompat const* compat, guint32 version, guint* n_vectors, guint64* size)
+{
+	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JListIterator) iterator = NULL;
-	GError* error = NULL;
-	gsize bytes_written;
+	GOutputVector* vectors;
+	guint n = 0;
 
-	g_return_val_if_fail(message != NULL, FALSE);
-	g_return_val_if_fail(stream != NULL, FALSE);
+	vectors = g_new(GOutputVector, 2 + j_list_length(message->send_list));
 
-	if (!g_output_stream_write_all(stream, &(message->header), sizeof(JMessageHeader), &bytes_written, NULL, &error) || bytes_written != sizeof(JMessageHeader))
+	if (compat != NULL)
 	{
-		goto end;
+		vectors[n].buffer = compat;
+		vectors[n].size = sizeof(JMessageHeaderCompat);
+	}
+	else
+	{
+		vectors[n].buffer = &(message->header);
+		vectors[n].size = j_message_header_size(version);
 	}
 
-	if (!g_output_stream_write_all(stream, message->data, j_message_length(message), &bytes_written, NULL, &error) || bytes_written != j_message_length(message))
+	n++;
+
+	if (j_message_length(message) > 0)
+	{
+		vectors[n].buffer = message->data;
+		vectors[n].size = j_message_length(message);
+		n++;
+	}
+
+	*size = 0;
+
+	iterator = j_list_iterator_new(message->send_list);
+
+	while (j_list_iterator_next(iterator))
+	{
+		JMessageData* message_data = j_list_iterator_get(iterator);
+
+		vectors[n].buffer = message_data->data;
+		vectors[n].size = message_data->length;
+		*size += message_data->length;
+		n++;
+	}
+
+	*n_vectors = n;
+
+	return vectors;
+}
+
+/**
+ * Writes vectors to a stream.
+ *
+ * \private
+ *
+ * \param stream    A stream.
+ * \param vectors   The vectors.
+ * \param n_vectors The number of vectors.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_write_vectors(GOutputStream* stream, GOutputVector* vectors, guint n_vectors)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	GError* error = NULL;
+
+#if GLIB_CHECK_VERSION(2, 60, 0)
+	// socket streams use sendmsg, partial writes are handled by GLib
+	if (!g_output_stream_writev_all(stream, vectors, n_vectors, NULL, NULL, &error))
 	{
 		goto end;
 	}
+#else
+	for (guint i = 0; i < n_vectors; i++)
+	{
+		gsize bytes_written;
+
+		if (!g_output_stream_write_all(stream, vectors[i].buffer, vectors[i].size, &bytes_written, NULL, &error) || bytes_written != vectors[i].size)
+		{
+			goto end;
+		}
+	}
+#endif
+
+	g_output_stream_flush(stream, NULL, NULL);
+
+	ret = TRUE;
+
+end:
+	if (error != NULL)
+	{
+		g_critical("%s", error->message);
+		g_error_free(error);
+	}
+
+	return ret;
+}
+
+#ifdef J_MESSAGE_ZEROCOPY
+/**
+ * Checks whether zero-copy transmission can be used on a socket.
+ *
+ * \private
+ *
+ * \param socket_ A socket.
+ *
+ * \return TRUE if zero-copy transmission is enabled, FALSE otherwise.
+ **/
+static gboolean
+j_message_zerocopy_enable(GSocket* socket_)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint const flag = 1;
+
+	gpointer state;
+
+	// the result is cached per socket: 1 means enabled, 2 means unsupported
+	state = g_object_get_data(G_OBJECT(socket_), "j-message-zerocopy");
+
+	if (state == NULL)
+	{
+		gint fd;
+
+		fd = g_socket_get_fd(socket_);
+		state = GINT_TO_POINTER((setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(gint)) == 0) ? 1 : 2);
+
+		g_object_set_data(G_OBJECT(socket_), "j-message-zerocopy", state);
+	}
+
+	return (GPOINTER_TO_INT(state) == 1);
+}
+
+/**
+ * Waits until the kernel has released the buffers of zero-copy transmissions.
+ * Fails if a transmission could not be completed, if the socket reports an error without pending completions
+ * or if no completion arrives within J_MESSAGE_ZEROCOPY_TIMEOUT.
+ *
+ * \private
+ *
+ * \param socket_ A socket.
+ * \param count   The number of zero-copy system calls to wait for.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_zerocopy_wait(GSocket* socket_, guint64 count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint fd;
+	gshort revents = 0;
 
-	if (message->send_list != NULL)
+	fd = g_socket_get_fd(socket_);
+
+	while (count > 0)
 	{
-		iterator = j_list_iterator_new(message->send_list);
+		gchar control[128];
+		struct msghdr msg = { 0 };
+		struct cmsghdr* cmsg;
+
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
 
-		while (j_list_iterator_next(iterator))
+		if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
 		{
-			JMessageData* message_data = j_list_iterator_get(iterator);
+			struct pollfd pfd;
+			gint ret;
+
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				return FALSE;
+			}
+
+			// the socket signaled an error or hang-up but there is no completion, polling again would return immediately
+			if (revents & (POLLERR | POLLHUP | POLLNVAL))
+			{
+				return FALSE;
+			}
+
+			// completions are signaled using POLLERR, which is always reported
+			pfd.fd = fd;
+			pfd.events = 0;
+			pfd.revents = 0;
+
+			ret = poll(&pfd, 1, J_MESSAGE_ZEROCOPY_TIMEOUT);
+
+			if (ret < 0 && errno != EINTR)
+			{
+				return FALSE;
+			}
+
+			if (ret == 0)
+			{
+				return FALSE;
+			}
+
+			revents = (ret > 0) ? pfd.revents : 0;
+
+			continue;
+		}
+
+		revents = 0;
+
+		for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			struct sock_extended_err const* err;
+
+			if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+			{
+				continue;
+			}
+
+			err = (struct sock_extended_err const*)(gconstpointer)CMSG_DATA(cmsg);
 
-			if (!g_output_stream_write_all(stream, message_data->data, message_data->length, &bytes_written, NULL, &error))
+			// the error queue only contains zero-copy notifications unless the transmission failed
+			if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
 			{
-				goto end;
+				return FALSE;
 			}
+
+			// a notification covers the system calls from ee_info to ee_data
+			count -= MIN(count, (guint64)(err->ee_data - err->ee_info) + 1);
 		}
 	}
 
-	g_output_stream_flush(stream, NULL, NULL);
+	return TRUE;
+}
+
+/**
+ * Writes vectors to a socket using MSG_ZEROCOPY.
+ * Only returns after the kernel has released the buffers, so callers may reuse them afterwards.
+ *
+ * \private
+ *
+ * \param socket_   A socket.
+ * \param vectors   The vectors, they are modified.
+ * \param n_vectors The number of vectors.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_write_zerocopy(GSocket* socket_, GOutputVector* vectors, guint n_vectors)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	GError* error = NULL;
+	guint64 zerocopy_count = 0;
+	guint i = 0;
+
+	while (i < n_vectors)
+	{
+		gssize bytes_written;
+
+		bytes_written = g_socket_send_message(socket_, NULL, vectors + i, MIN(n_vectors - i, J_MESSAGE_MAX_VECTORS), NULL, 0, MSG_ZEROCOPY, NULL, &error);
+
+		if (bytes_written < 0)
+		{
+			goto end;
+		}
+
+		zerocopy_count++;
+
+		// handle partial writes
+		while (i < n_vectors && (gsize)bytes_written >= vectors[i].size)
+		{
+			bytes_written -= vectors[i].size;
+			i++;
+		}
+
+		if (i < n_vectors)
+		{
+			vectors[i].buffer = (gchar const*)vectors[i].buffer + bytes_written;
+			vectors[i].size -= bytes_written;
+		}
+	}
 
 	ret = TRUE;
 
 end:
+	if (!j_message_zerocopy_wait(socket_, zerocopy_count))
+	{
+		ret = FALSE;
+	}
+
 	if (error != NULL)
 	{
 		g_critical("%s", error->message);
@@ -717,6 +1436,139 @@ end:
 
 	return ret;
 }
+#endif
+
+gboolean
+j_message_send(JMessage* message, gpointer connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_autofree GOutputVector* vectors = NULL;
+	GOutputStream* stream;
+	JMessageHeaderCompat compat;
+	gboolean cork;
+	guint n_vectors;
+	guint32 version;
+	guint64 size;
+
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(connection != NULL, FALSE);
+
+	version = j_message_get_version(connection);
+
+	if (version >= 3 && message->header.trace_id != 0)
+	{
+		gchar const* name;
+
+		name = j_statistics_get_operation_name(j_message_get_type(message));
+
+		if (message->original_message != NULL)
+		{
+			// replies continue the span of their request
+			j_trace_flow(name, J_TRACE_FLOW_STEP, GUINT64_FROM_LE(message->header.span_id));
+		}
+		else
+		{
+			// every transmission of a request is a new span
+			message->header.span_id = GUINT64_TO_LE(j_trace_correlation_new());
+			j_trace_flow(name, J_TRACE_FLOW_BEGIN, GUINT64_FROM_LE(message->header.span_id));
+		}
+	}
+
+	if (version >= 2)
+	{
+		vectors = j_message_get_vectors(message, NULL, version, &n_vectors, &size);
+	}
+	else
+	{
+		if (!j_message_header_to_compat(message, &compat))
+		{
+			return FALSE;
+		}
+
+		vectors = j_message_get_vectors(message, &compat, 1, &n_vectors, &size);
+	}
+
+#if GLIB_CHECK_VERSION(2, 60, 0)
+	// messages that fit into a single system call do not have to be corked
+	cork = (n_vectors > J_MESSAGE_MAX_VECTORS);
+#else
+	cork = TRUE;
+#endif
+
+	if (cork)
+	{
+		j_helper_set_cork(connection, TRUE);
+	}
+
+#ifdef J_MESSAGE_ZEROCOPY
+	{
+		GSocket* socket_;
+		guint64 const* zerocopy_size_connection;
+		guint64 zerocopy_size;
+
+		socket_ = g_socket_connection_get_socket(connection);
+		zerocopy_size_connection = g_object_get_data(G_OBJECT(connection), "j-message-zerocopy-size");
+		zerocopy_size = (zerocopy_size_connection != NULL) ? *zerocopy_size_connection : j_configuration_get_zerocopy_size(j_configuration());
+
+		// small buffers are cheaper to copy than to pin
+		if (zerocopy_size > 0 && size >= zerocopy_size && j_message_zerocopy_enable(socket_))
+		{
+			ret = j_message_write_zerocopy(socket_, vectors, n_vectors);
+			goto end;
+		}
+	}
+#endif
+
+	stream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+	ret = j_message_write_vectors(stream, vectors, n_vectors);
+
+#ifdef J_MESSAGE_ZEROCOPY
+end:
+#endif
+	if (cork)
+	{
+		j_helper_set_cork(connection, FALSE);
+	}
+
+	return ret;
+}
+
+gboolean
+j_message_read(JMessage* message, GInputStream* stream)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(stream != NULL, FALSE);
+
+	return j_message_read_internal(message, stream, 1);
+}
+
+gboolean
+j_message_write(JMessage* message, GOutputStream* stream)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree GOutputVector* vectors = NULL;
+	JMessageHeaderCompat compat;
+	guint n_vectors;
+	guint64 size;
+
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(stream != NULL, FALSE);
+
+	if (!j_message_header_to_compat(message, &compat))
+	{
+		return FALSE;
+	}
+
+	vectors = j_message_get_vectors(message, &compat, 1, &n_vectors, &size);
+
+	return j_message_write_vectors(stream, vectors, n_vectors);
+}
 
 void
 j_message_add_send(JMessage* message, gconstpointer data, guint64 length)
@@ -751,6 +1603,23 @@ j_message_add_operation(JMessage* message, gsize length)
 	j_message_extend(message, length);
 }
 
+void
+j_message_reserve(JMessage* message, gsize length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gsize current_length;
+
+	g_return_if_fail(message != NULL);
+
+	current_length = j_message_length(message);
+
+	if (current_length + length > message->size)
+	{
+		j_message_resize(message, current_length + length, current_length);
+	}
+}
+
 void
 j_message_set_semantics(JMessage* message, JSemantics* semantics)
 {
@@ -46,6 +46,7 @@ j_operation_new(void)
 	operation->data = NULL;
 	operation->exec_func = NULL;
 	operation->free_func = NULL;
+	operation->size = 0;
 
 	return operation;
 }
@@ -25,6 +25,9 @@
 #include <glib.h>
 
 #include <jstatistics.h>
+
+#include <jhelper.h>
+#include <jmessage.h>
 #include <jtrace.h>
 
 /**
@@ -33,6 +36,39 @@
  * @{
  **/
 
+/**
+ * The number of message types.
+ **/
+#define J_STATISTICS_OPERATION_TYPES (J_MESSAGE_DB_EXPLAIN + 1)
+
+/**
+ * The statistics of one operation type.
+ **/
+struct JStatisticsOperation
+{
+	/**
+	 * The number of operations.
+	 **/
+	guint64 count;
+
+	/**
+	 * The number of transferred bytes.
+	 **/
+	guint64 bytes;
+
+	/**
+	 * The total latency per latency part.
+	 **/
+	guint64 latency_sum[2];
+
+	/**
+	 * The latency histograms per latency part.
+	 **/
+	guint64 latency[2][J_STATISTICS_LATENCY_BUCKETS];
+};
+
+typedef struct JStatisticsOperation JStatisticsOperation;
+
 /**
  * A statistics.
  **/
@@ -82,6 +118,12 @@ struct JStatistics
 	 * The number of sent bytes.
 	 **/
 	guint64 bytes_sent;
+
+	/**
+	 * The statistics per operation type.
+	 * Allocated when the first operation is recorded.
+	 **/
+	JStatisticsOperation* operations;
 };
 
 static gchar const*
@@ -130,6 +172,7 @@ j_statistics_new(gboolean trace)
 	statistics->bytes_written = 0;
 	statistics->bytes_received = 0;
 	statistics->bytes_sent = 0;
+	statistics->operations = NULL;
 
 	return statistics;
 }
@@ -141,6 +184,7 @@ j_statistics_free(JStatistics* statistics)
 
 	g_return_if_fail(statistics != NULL);
 
+	g_free(statistics->operations);
 	g_free(statistics);
 }
 
@@ -156,28 +200,28 @@ j_statistics_get(JStatistics* statistics, JStatisticsType type)
 	switch (type)
 	{
 		case J_STATISTICS_FILES_CREATED:
-			value = statistics->files_created;
+			value = j_helper_atomic_add(&(statistics->files_created), 0);
 			break;
 		case J_STATISTICS_FILES_DELETED:
-			value = statistics->files_deleted;
+			value = j_helper_atomic_add(&(statistics->files_deleted), 0);
 			break;
 		case J_STATISTICS_FILES_STATED:
-			value = statistics->files_stated;
+			value = j_helper_atomic_add(&(statistics->files_stated), 0);
 			break;
 		case J_STATISTICS_SYNC:
-			value = statistics->sync_count;
+			value = j_helper_atomic_add(&(statistics->sync_count), 0);
 			break;
 		case J_STATISTICS_BYTES_READ:
-			value = statistics->bytes_read;
+			value = j_helper_atomic_add(&(statistics->bytes_read), 0);
 			break;
 		case J_STATISTICS_BYTES_WRITTEN:
-			value = statistics->bytes_written;
+			value = j_helper_atomic_add(&(statistics->bytes_written), 0);
 			break;
 		case J_STATISTICS_BYTES_RECEIVED:
-			value = statistics->bytes_received;
+			value = j_helper_atomic_add(&(statistics->bytes_received), 0);
 			break;
 		case J_STATISTICS_BYTES_SENT:
-			value = statistics->bytes_sent;
+			value = j_helper_atomic_add(&(statistics->bytes_sent), 0);
 			break;
 		default:
 			g_warn_if_reached();
@@ -197,28 +241,28 @@ j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value)
 	switch (type)
 	{
 		case J_STATISTICS_FILES_CREATED:
-			statistics->files_created += value;
+			j_helper_atomic_add(&(statistics->files_created), value);
 			break;
 		case J_STATISTICS_FILES_DELETED:
-			statistics->files_deleted += value;
+			j_helper_atomic_add(&(statistics->files_deleted), value);
 			break;
 		case J_STATISTICS_FILES_STATED:
-			statistics->files_stated += value;
+			j_helper_atomic_add(&(statistics->files_stated), value);
 			break;
 		case J_STATISTICS_SYNC:
-			statistics->sync_count += value;
+			j_helper_atomic_add(&(statistics->sync_count), value);
 			break;
 		case J_STATISTICS_BYTES_READ:
-			statistics->bytes_read += value;
+			j_helper_atomic_add(&(statistics->bytes_read), value);
 			break;
 		case J_STATISTICS_BYTES_WRITTEN:
-			statistics->bytes_written += value;
+			j_helper_atomic_add(&(statistics->bytes_written), value);
 			break;
 		case J_STATISTICS_BYTES_RECEIVED:
-			statistics->bytes_received += value;
+			j_helper_atomic_add(&(statistics->bytes_received), value);
 			break;
 		case J_STATISTICS_BYTES_SENT:
-			statistics->bytes_sent += value;
+			j_helper_atomic_add(&(statistics->bytes_sent), value);
 			break;
 		default:
 			g_warn_if_reached();
@@ -231,6 +275,477 @@ j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value)
 	}
 }
 
+/**
+ * Returns the histogram bucket of a latency.
+ *
+ * \private
+ *
+ * \param latency A latency in microseconds.
+ *
+ * \return The bucket.
+ **/
+static guint
+j_statistics_latency_bucket(guint64 latency)
+{
+	guint exponent;
+	guint bucket;
+
+	if (latency < 4)
+	{
+		return latency;
+	}
+
+	// The two bits following the most significant one select the sub-bucket
+	exponent = g_bit_storage(latency) - 1;
+	bucket = (exponent - 1) * 4 + ((latency >> (exponent - 2)) & 3);
+
+	return MIN(bucket, J_STATISTICS_LATENCY_BUCKETS - 1);
+}
+
+/**
+ * Returns the statistics of an operation type, allocating them if necessary.
+ *
+ * \private
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ *
+ * \return The operation statistics.
+ **/
+static JStatisticsOperation*
+j_statistics_get_operation(JStatistics* statistics, JMessageType type)
+{
+	JStatisticsOperation* operations;
+
+	operations = g_atomic_pointer_get(&(statistics->operations));
+
+	if (G_UNLIKELY(operations == NULL))
+	{
+		operations = g_new0(JStatisticsOperation, J_STATISTICS_OPERATION_TYPES);
+		g_atomic_pointer_set(&(statistics->operations), operations);
+	}
+
+	return &(operations[type]);
+}
+
+/**
+ * Returns the statistics of an operation type for reading.
+ *
+ * \private
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ *
+ * \return The operation statistics, NULL if no operation has been recorded.
+ **/
+static JStatisticsOperation*
+j_statistics_peek_operation(JStatistics* statistics, JMessageType type)
+{
+	JStatisticsOperation* operations;
+
+	operations = g_atomic_pointer_get(&(statistics->operations));
+
+	return (operations != NULL) ? &(operations[type]) : NULL;
+}
+
+void
+j_statistics_merge(JStatistics* statistics, JStatistics* other)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(other != NULL);
+
+	for (JStatisticsType type = J_STATISTICS_FILES_CREATED; type <= J_STATISTICS_BYTES_SENT; type++)
+	{
+		guint64 value;
+
+		value = j_statistics_get(other, type);
+
+		if (value > 0)
+		{
+			j_statistics_add(statistics, type, value);
+		}
+	}
+
+	for (guint type = 0; type < J_STATISTICS_OPERATION_TYPES; type++)
+	{
+		JStatisticsOperation* operation;
+		JStatisticsOperation* other_operation;
+
+		other_operation = j_statistics_peek_operation(other, type);
+
+		if (other_operation == NULL || j_helper_atomic_add(&(other_operation->count), 0) == 0)
+		{
+			continue;
+		}
+
+		operation = j_statistics_get_operation(statistics, type);
+
+		j_helper_atomic_add(&(operation->count), j_helper_atomic_add(&(other_operation->count), 0));
+		j_helper_atomic_add(&(operation->bytes), j_helper_atomic_add(&(other_operation->bytes), 0));
+
+		for (guint i = 0; i < 2; i++)
+		{
+			j_helper_atomic_add(&(operation->latency_sum[i]), j_helper_atomic_add(&(other_operation->latency_sum[i]), 0));
+
+			for (guint j = 0; j < J_STATISTICS_LATENCY_BUCKETS; j++)
+			{
+				guint64 value;
+
+				value = j_helper_atomic_add(&(other_operation->latency[i][j]), 0);
+
+				if (value > 0)
+				{
+					j_helper_atomic_add(&(operation->latency[i][j]), value);
+				}
+			}
+		}
+	}
+}
+
+void
+j_statistics_add_operation(JStatistics* statistics, JMessageType type, guint64 bytes, guint64 server_time, guint64 backend_time)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsOperation* operation;
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(type < J_STATISTICS_OPERATION_TYPES);
+
+	operation = j_statistics_get_operation(statistics, type);
+
+	j_helper_atomic_add(&(operation->count), 1);
+	j_helper_atomic_add(&(operation->bytes), bytes);
+	j_helper_atomic_add(&(operation->latency_sum[J_STATISTICS_LATENCY_SERVER]), server_time);
+	j_helper_atomic_add(&(operation->latency_sum[J_STATISTICS_LATENCY_BACKEND]), backend_time);
+	j_helper_atomic_add(&(operation->latency[J_STATISTICS_LATENCY_SERVER][j_statistics_latency_bucket(server_time)]), 1);
+	j_helper_atomic_add(&(operation->latency[J_STATISTICS_LATENCY_BACKEND][j_statistics_latency_bucket(backend_time)]), 1);
+}
+
+gchar const*
+j_statistics_get_operation_name(JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (type)
+	{
+		case J_MESSAGE_NONE:
+			return "none";
+		case J_MESSAGE_PING:
+			return "ping";
+		case J_MESSAGE_STATISTICS:
+			return "statistics";
+		case J_MESSAGE_OBJECT_CREATE:
+			return "object_create";
+		case J_MESSAGE_OBJECT_DELETE:
+			return "object_delete";
+		case J_MESSAGE_OBJECT_GET_ALL:
+			return "object_get_all";
+		case J_MESSAGE_OBJECT_GET_BY_PREFIX:
+			return "object_get_by_prefix";
+		case J_MESSAGE_OBJECT_READ:
+			return "object_read";
+		case J_MESSAGE_OBJECT_STATUS:
+			return "object_status";
+		case J_MESSAGE_OBJECT_SYNC:
+			return "object_sync";
+		case J_MESSAGE_OBJECT_WRITE:
+			return "object_write";
+		case J_MESSAGE_KV_PUT:
+			return "kv_put";
+		case J_MESSAGE_KV_DELETE:
+			return "kv_delete";
+		case J_MESSAGE_KV_GET:
+			return "kv_get";
+		case J_MESSAGE_KV_GET_ALL:
+			return "kv_get_all";
+		case J_MESSAGE_KV_GET_BY_PREFIX:
+			return "kv_get_by_prefix";
+		case J_MESSAGE_DB_SCHEMA_CREATE:
+			return "db_schema_create";
+		case J_MESSAGE_DB_SCHEMA_GET:
+			return "db_schema_get";
+		case J_MESSAGE_DB_SCHEMA_DELETE:
+			return "db_schema_delete";
+		case J_MESSAGE_DB_INSERT:
+			return "db_insert";
+		case J_MESSAGE_DB_UPDATE:
+			return "db_update";
+		case J_MESSAGE_DB_DELETE:
+			return "db_delete";
+		case J_MESSAGE_DB_QUERY:
+			return "db_query";
+		case J_MESSAGE_DB_EXPLAIN:
+			return "db_explain";
+		default:
+			g_warn_if_reached();
+			return NULL;
+	}
+}
+
+guint64
+j_statistics_get_operations(JStatistics* statistics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsOperation* operation;
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_OPERATION_TYPES, 0);
+
+	operation = j_statistics_peek_operation(statistics, type);
+
+	return (operation != NULL) ? j_helper_atomic_add(&(operation->count), 0) : 0;
+}
+
+guint64
+j_statistics_get_operation_bytes(JStatistics* statistics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsOperation* operation;
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_OPERATION_TYPES, 0);
+
+	operation = j_statistics_peek_operation(statistics, type);
+
+	return (operation != NULL) ? j_helper_atomic_add(&(operation->bytes), 0) : 0;
+}
+
+guint64
+j_statistics_get_latency_sum(JStatistics* statistics, JMessageType type, JStatisticsLatency latency)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsOperation* operation;
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_OPERATION_TYPES, 0);
+	g_return_val_if_fail(latency <= J_STATISTICS_LATENCY_BACKEND, 0);
+
+	operation = j_statistics_peek_operation(statistics, type);
+
+	return (operation != NULL) ? j_helper_atomic_add(&(operation->latency_sum[latency]), 0) : 0;
+}
+
+guint64
+j_statistics_get_latency_bucket(JStatistics* statistics, JMessageType type, JStatisticsLatency latency, guint bucket)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsOperation* operation;
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_OPERATION_TYPES, 0);
+	g_return_val_if_fail(latency <= J_STATISTICS_LATENCY_BACKEND, 0);
+	g_return_val_if_fail(bucket < J_STATISTICS_LATENCY_BUCKETS, 0);
+
+	operation = j_statistics_peek_operation(statistics, type);
+
+	return (operation != NULL) ? j_helper_atomic_add(&(operation->latency[latency][bucket]), 0) : 0;
+}
+
+guint64
+j_statistics_get_latency_bucket_bound(guint bucket)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint exponent;
+
+	g_return_val_if_fail(bucket < J_STATISTICS_LATENCY_BUCKETS, 0);
+
+	if (bucket < 4)
+	{
+		return bucket + 1;
+	}
+
+	exponent = bucket / 4 + 1;
+
+	return (G_GUINT64_CONSTANT(5) + bucket % 4) << (exponent - 2);
+}
+
+guint64
+j_statistics_get_latency_percentile(JStatistics* statistics, JMessageType type, JStatisticsLatency latency, gdouble percentile)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 count = 0;
+	guint64 total = 0;
+	guint64 threshold;
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(percentile >= 0.0 && percentile <= 100.0, 0);
+
+	for (guint i = 0; i < J_STATISTICS_LATENCY_BUCKETS; i++)
+	{
+		total += j_statistics_get_latency_bucket(statistics, type, latency, i);
+	}
+
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	threshold = MAX(1, (guint64)(total * percentile / 100.0 + 0.5));
+
+	for (guint i = 0; i < J_STATISTICS_LATENCY_BUCKETS; i++)
+	{
+		count += j_statistics_get_latency_bucket(statistics, type, latency, i);
+
+		if (count >= threshold)
+		{
+			return j_statistics_get_latency_bucket_bound(i);
+		}
+	}
+
+	return j_statistics_get_latency_bucket_bound(J_STATISTICS_LATENCY_BUCKETS - 1);
+}
+
+void
+j_statistics_serialize_operations(JStatistics* statistics, JMessage* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gsize length = sizeof(guint32);
+	guint32 types = 0;
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(message != NULL);
+
+	// Only types and buckets that have been used are transferred
+	for (guint type = 0; type < J_STATISTICS_OPERATION_TYPES; type++)
+	{
+		if (j_statistics_get_operations(statistics, type) == 0)
+		{
+			continue;
+		}
+
+		types++;
+		length += sizeof(guint32) + 4 * sizeof(guint64);
+
+		for (guint i = 0; i < 2; i++)
+		{
+			length += sizeof(guint32);
+
+			for (guint j = 0; j < J_STATISTICS_LATENCY_BUCKETS; j++)
+			{
+				if (j_statistics_get_latency_bucket(statistics, type, i, j) > 0)
+				{
+					length += sizeof(guint32) + sizeof(guint64);
+				}
+			}
+		}
+	}
+
+	j_message_add_operation(message, length);
+	j_message_append_4(message, &types);
+
+	for (guint32 type = 0; type < J_STATISTICS_OPERATION_TYPES; type++)
+	{
+		guint64 value;
+
+		if (j_statistics_get_operations(statistics, type) == 0)
+		{
+			continue;
+		}
+
+		j_message_append_4(message, &type);
+		value = j_statistics_get_operations(statistics, type);
+		j_message_append_8(message, &value);
+		value = j_statistics_get_operation_bytes(statistics, type);
+		j_message_append_8(message, &value);
+		value = j_statistics_get_latency_sum(statistics, type, J_STATISTICS_LATENCY_SERVER);
+		j_message_append_8(message, &value);
+		value = j_statistics_get_latency_sum(statistics, type, J_STATISTICS_LATENCY_BACKEND);
+		j_message_append_8(message, &value);
+
+		for (guint i = 0; i < 2; i++)
+		{
+			guint32 buckets = 0;
+
+			for (guint j = 0; j < J_STATISTICS_LATENCY_BUCKETS; j++)
+			{
+				if (j_statistics_get_latency_bucket(statistics, type, i, j) > 0)
+				{
+					buckets++;
+				}
+			}
+
+			j_message_append_4(message, &buckets);
+
+			for (guint32 j = 0; j < J_STATISTICS_LATENCY_BUCKETS && buckets > 0; j++)
+			{
+				value = j_statistics_get_latency_bucket(statistics, type, i, j);
+
+				if (value > 0)
+				{
+					j_message_append_4(message, &j);
+					j_message_append_8(message, &value);
+					buckets--;
+				}
+			}
+		}
+	}
+}
+
+void
+j_statistics_deserialize_operations(JStatistics* statistics, JMessage* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 types;
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(message != NULL);
+
+	types = j_message_get_4(message);
+
+	for (guint i = 0; i < types; i++)
+	{
+		JStatisticsOperation* operation;
+		guint32 type;
+
+		type = j_message_get_4(message);
+
+		if (type >= J_STATISTICS_OPERATION_TYPES)
+		{
+			/// \todo skip unknown types sent by newer servers
+			break;
+		}
+
+		operation = j_statistics_get_operation(statistics, type);
+
+		j_helper_atomic_add(&(operation->count), j_message_get_8(message));
+		j_helper_atomic_add(&(operation->bytes), j_message_get_8(message));
+		j_helper_atomic_add(&(operation->latency_sum[J_STATISTICS_LATENCY_SERVER]), j_message_get_8(message));
+		j_helper_atomic_add(&(operation->latency_sum[J_STATISTICS_LATENCY_BACKEND]), j_message_get_8(message));
+
+		for (guint j = 0; j < 2; j++)
+		{
+			guint32 buckets;
+
+			buckets = j_message_get_4(message);
+
+			for (guint k = 0; k < buckets; k++)
+			{
+				guint32 bucket;
+				guint64 value;
+
+				bucket = j_message_get_4(message);
+				value = j_message_get_8(message);
+
+				if (bucket < J_STATISTICS_LATENCY_BUCKETS)
+				{
+					j_helper_atomic_add(&(operation->latency[j][bucket]), value);
+				}
+			}
+		}
+	}
+}
+
 /**
  * @}
  **/
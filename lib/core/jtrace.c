@@ -24,6 +24,15 @@
 
 #include <glib.h>
 #include <glib/gprintf.h>
+#include <glib/gstdio.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #ifdef HAVE_OTF
 #include <otf.h>
@@ -45,11 +54,124 @@ enum JTraceFlags
 	J_TRACE_OFF = 0,
 	J_TRACE_ECHO = 1 << 0,
 	J_TRACE_OTF = 1 << 1,
-	J_TRACE_SUMMARY = 1 << 2
+	J_TRACE_SUMMARY = 1 << 2,
+	J_TRACE_BINARY = 1 << 3
 };
 
 typedef enum JTraceFlags JTraceFlags;
 
+/**
+ * The number of events in a thread's ring buffer.
+ * Has to be a power of two.
+ **/
+#define J_TRACE_RING_SIZE 65536
+
+/**
+ * The number of nested traces that can be recorded without allocating memory.
+ **/
+#define J_TRACE_POOL_SIZE 64
+
+/**
+ * The interval in which ring buffers are flushed in milliseconds.
+ **/
+#define J_TRACE_FLUSH_INTERVAL 100
+
+enum JTraceEventType
+{
+	J_TRACE_EVENT_ENTER,
+	J_TRACE_EVENT_LEAVE,
+	J_TRACE_EVENT_COUNTER,
+	J_TRACE_EVENT_FLOW_BEGIN,
+	J_TRACE_EVENT_FLOW_STEP,
+	J_TRACE_EVENT_FLOW_END
+};
+
+typedef enum JTraceEventType JTraceEventType;
+
+/**
+ * A binary trace event.
+ **/
+struct JTraceEvent
+{
+	/**
+	 * The timestamp in ticks, see j_trace_ticks().
+	 **/
+	guint64 ticks;
+
+	/**
+	 * The correlation ID that was active when the event was recorded.
+	 **/
+	guint64 correlation;
+
+	/**
+	 * The current span ID, a counter value, a flow ID or the length of a file operation.
+	 **/
+	guint64 value;
+
+	/**
+	 * The interned function ID.
+	 **/
+	guint32 function;
+
+	/**
+	 * The event type.
+	 **/
+	guint32 type;
+};
+
+typedef struct JTraceEvent JTraceEvent;
+
+/**
+ * A single-producer single-consumer ring buffer of binary trace events.
+ * Events are written by the owning thread and read by the flush thread.
+ **/
+struct JTraceRing
+{
+	JTraceEvent* events;
+
+	/**
+	 * The number of written events, only modified by the owning thread.
+	 **/
+	gint head;
+
+	/**
+	 * The number of flushed events, only modified by the flush thread.
+	 **/
+	gint tail;
+
+	/**
+	 * The number of events dropped because the ring buffer was full.
+	 **/
+	gint dropped;
+	guint dropped_reported;
+
+	guint thread_id;
+	gchar* thread_name;
+	gboolean announced;
+
+	/**
+	 * Whether the owning thread has exited.
+	 **/
+	gint finished;
+};
+
+typedef struct JTraceRing JTraceRing;
+
+/**
+ * An interned function name.
+ **/
+struct JTraceFunction
+{
+	guint32 id;
+
+	/**
+	 * Whether the function matches JULEA_TRACE_FUNCTION.
+	 **/
+	gboolean traced;
+};
+
+typedef struct JTraceFunction JTraceFunction;
+
 struct JTraceStack
 {
 	gchar* name;
@@ -77,6 +199,11 @@ struct JTraceThread
 	 **/
 	gchar* thread_name;
 
+	/**
+	 * Thread ID.
+	 **/
+	guint thread_id;
+
 	/**
 	 * Function depth within the current thread.
 	 **/
@@ -84,6 +211,37 @@ struct JTraceThread
 
 	GArray* stack;
 
+	/**
+	 * The current correlation ID.
+	 **/
+	guint64 correlation;
+
+	/**
+	 * The current span ID.
+	 **/
+	guint64 span;
+
+	/**
+	 * Binary-specific structure.
+	 **/
+	struct
+	{
+		/**
+		 * The thread's ring buffer.
+		 **/
+		JTraceRing* ring;
+
+		/**
+		 * Caches interned functions by the address of their names.
+		 **/
+		GHashTable* functions;
+
+		/**
+		 * Traces that are handed out by j_trace_enter() without allocating memory.
+		 **/
+		JTrace* traces;
+	} binary;
+
 #ifdef HAVE_OTF
 	/**
 	 * OTF-specific structure.
@@ -104,6 +262,11 @@ struct JTrace
 {
 	gchar* name;
 	guint64 enter_time;
+
+	/**
+	 * Whether the trace belongs to the trace thread's pool.
+	 **/
+	gboolean pooled;
 };
 
 static JTraceFlags j_trace_flags = J_TRACE_OFF;
@@ -134,8 +297,44 @@ static void j_trace_thread_default_free(gpointer);
 static GPrivate j_trace_thread_default = G_PRIVATE_INIT(j_trace_thread_default_free);
 static GHashTable* j_trace_summary_table = NULL;
 
+static GHashTable* j_trace_binary_functions = NULL;
+static GPtrArray* j_trace_binary_names = NULL;
+static GList* j_trace_binary_rings = NULL;
+
+static FILE* j_trace_binary_file = NULL;
+static guint64 j_trace_binary_events = 0;
+
+static GThread* j_trace_binary_thread = NULL;
+static GMutex j_trace_binary_mutex;
+static GCond j_trace_binary_cond;
+static gboolean j_trace_binary_stop = FALSE;
+
+static guint64 j_trace_binary_ticks = 0;
+static gint64 j_trace_binary_monotonic = 0;
+static gint64 j_trace_binary_real = 0;
+
 G_LOCK_DEFINE_STATIC(j_trace_echo);
 G_LOCK_DEFINE_STATIC(j_trace_summary);
+G_LOCK_DEFINE_STATIC(j_trace_binary);
+G_LOCK_DEFINE_STATIC(j_trace_binary_rings);
+
+/**
+ * Returns the current time in ticks.
+ * On x86, the time stamp counter is used because it is considerably cheaper than a system call.
+ *
+ * \private
+ *
+ * \return The current time in ticks.
+ **/
+static inline guint64
+j_trace_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return g_get_monotonic_time();
+#endif
+}
 
 /**
  * Creates a new trace thread.
@@ -162,18 +361,47 @@ j_trace_thread_new(GThread* thread)
 	trace_thread = g_new(JTraceThread, 1);
 	trace_thread->function_depth = 0;
 	trace_thread->stack = g_array_new(FALSE, FALSE, sizeof(JTraceStack));
+	trace_thread->correlation = 0;
+	trace_thread->span = 0;
 
 	if (thread == NULL)
 	{
 		trace_thread->thread_name = g_strdup("Main process");
+		trace_thread->thread_id = 0;
 	}
 	else
 	{
-		guint thread_id;
-
 		/// \todo use name?
-		thread_id = g_atomic_int_add(&j_trace_thread_id, 1);
-		trace_thread->thread_name = g_strdup_printf("Thread %d", thread_id);
+		trace_thread->thread_id = g_atomic_int_add(&j_trace_thread_id, 1);
+		trace_thread->thread_name = g_strdup_printf("Thread %d", trace_thread->thread_id);
+	}
+
+	trace_thread->binary.ring = NULL;
+	trace_thread->binary.functions = NULL;
+	trace_thread->binary.traces = NULL;
+
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		JTraceRing* ring;
+
+		ring = g_new(JTraceRing, 1);
+		ring->events = g_new(JTraceEvent, J_TRACE_RING_SIZE);
+		ring->head = 0;
+		ring->tail = 0;
+		ring->dropped = 0;
+		ring->dropped_reported = 0;
+		ring->thread_id = trace_thread->thread_id;
+		ring->thread_name = g_strdup(trace_thread->thread_name);
+		ring->announced = FALSE;
+		ring->finished = FALSE;
+
+		G_LOCK(j_trace_binary_rings);
+		j_trace_binary_rings = g_list_prepend(j_trace_binary_rings, ring);
+		G_UNLOCK(j_trace_binary_rings);
+
+		trace_thread->binary.ring = ring;
+		trace_thread->binary.functions = g_hash_table_new(NULL, NULL);
+		trace_thread->binary.traces = g_new(JTrace, J_TRACE_POOL_SIZE);
 	}
 
 #ifdef HAVE_OTF
@@ -217,6 +445,15 @@ j_trace_thread_free(JTraceThread* trace_thread)
 	}
 #endif
 
+	if (trace_thread->binary.ring != NULL)
+	{
+		// the ring buffer is freed by the flush thread after its remaining events have been written
+		g_atomic_int_set(&(trace_thread->binary.ring->finished), TRUE);
+
+		g_hash_table_unref(trace_thread->binary.functions);
+		g_free(trace_thread->binary.traces);
+	}
+
 	g_free(trace_thread->thread_name);
 	g_array_free(trace_thread->stack, TRUE);
 	g_free(trace_thread);
@@ -352,6 +589,365 @@ j_trace_function_check(gchar const* name)
 	return TRUE;
 }
 
+/**
+ * Returns the interned function for a name.
+ * Names are cached by their address because they are usually string literals.
+ * This avoids hashing the name and taking a lock for every trace event.
+ *
+ * \private
+ *
+ * \param trace_thread A trace thread.
+ * \param name         A function name.
+ *
+ * \return The interned function.
+ **/
+static JTraceFunction const*
+j_trace_binary_function_get(JTraceThread* trace_thread, gchar const* name)
+{
+	JTraceFunction* function;
+
+	function = g_hash_table_lookup(trace_thread->binary.functions, name);
+
+	if (G_UNLIKELY(function == NULL))
+	{
+		G_LOCK(j_trace_binary);
+
+		function = g_hash_table_lookup(j_trace_binary_functions, name);
+
+		if (function == NULL)
+		{
+			function = g_new(JTraceFunction, 1);
+			function->id = j_trace_binary_names->len;
+			function->traced = j_trace_function_check(name);
+
+			g_ptr_array_add(j_trace_binary_names, g_strescape(name, NULL));
+			g_hash_table_insert(j_trace_binary_functions, g_strdup(name), function);
+		}
+
+		G_UNLOCK(j_trace_binary);
+
+		g_hash_table_insert(trace_thread->binary.functions, (gpointer)name, function);
+	}
+
+	return function;
+}
+
+/**
+ * Records a binary trace event in the trace thread's ring buffer.
+ * If the ring buffer is full, the event is dropped instead of blocking the thread.
+ *
+ * \private
+ *
+ * \param trace_thread A trace thread.
+ * \param type         An event type.
+ * \param function     An interned function ID.
+ * \param value        A value.
+ **/
+static void
+j_trace_binary_record(JTraceThread* trace_thread, JTraceEventType type, guint32 function, guint64 value)
+{
+	JTraceRing* ring = trace_thread->binary.ring;
+	JTraceEvent* event;
+	guint head;
+
+	head = ring->head;
+
+	if (head - (guint)g_atomic_int_get(&(ring->tail)) >= J_TRACE_RING_SIZE)
+	{
+		g_atomic_int_inc(&(ring->dropped));
+		return;
+	}
+
+	event = &(ring->events[head & (J_TRACE_RING_SIZE - 1)]);
+	event->ticks = j_trace_ticks();
+	event->correlation = trace_thread->correlation;
+	event->value = value;
+	event->function = function;
+	event->type = type;
+
+	// publish the event to the flush thread
+	g_atomic_int_set(&(ring->head), head + 1);
+}
+
+/**
+ * Frees a ring buffer.
+ *
+ * \private
+ *
+ * \param ring A ring buffer.
+ **/
+static void
+j_trace_binary_ring_free(JTraceRing* ring)
+{
+	g_free(ring->events);
+	g_free(ring->thread_name);
+	g_free(ring);
+}
+
+/**
+ * Returns the number of ticks per microsecond.
+ * The ratio is determined using the monotonic clock since j_trace_init(), becoming more accurate over time.
+ *
+ * \private
+ *
+ * \return The number of ticks per microsecond.
+ **/
+static gdouble
+j_trace_binary_calibrate(void)
+{
+	guint64 ticks;
+	gint64 monotonic;
+
+	monotonic = g_get_monotonic_time();
+
+	if (monotonic - j_trace_binary_monotonic < G_TIME_SPAN_MILLISECOND)
+	{
+		// a short interval would make the conversion inaccurate
+		g_usleep(G_TIME_SPAN_MILLISECOND);
+		monotonic = g_get_monotonic_time();
+	}
+
+	ticks = j_trace_ticks();
+
+	return (gdouble)(ticks - j_trace_binary_ticks) / (gdouble)(monotonic - j_trace_binary_monotonic);
+}
+
+/**
+ * Writes the common part of a Chrome Trace event.
+ *
+ * \private
+ *
+ * \param phase     The event phase.
+ * \param name      The event name, can be NULL.
+ * \param timestamp The timestamp in nanoseconds since the epoch.
+ * \param thread_id The thread ID.
+ **/
+static void
+j_trace_binary_write_prefix(gchar const* phase, gchar const* name, gint64 timestamp, guint thread_id)
+{
+	if (j_trace_binary_events > 0)
+	{
+		fputs(",\n", j_trace_binary_file);
+	}
+
+	j_trace_binary_events++;
+
+	fputs("{", j_trace_binary_file);
+
+	if (name != NULL)
+	{
+		fprintf(j_trace_binary_file, "\"name\":\"%s\",", name);
+	}
+
+	fprintf(j_trace_binary_file, "\"ph\":\"%s\",\"ts\":%" G_GINT64_FORMAT ".%03" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%u", phase, timestamp / 1000, timestamp % 1000, (gint)getpid(), thread_id);
+}
+
+/**
+ * Writes a binary trace event as a Chrome Trace event.
+ *
+ * \private
+ *
+ * \param ring           A ring buffer.
+ * \param event          An event.
+ * \param names          The interned function names.
+ * \param ticks_per_usec The number of ticks per microsecond.
+ **/
+static void
+j_trace_binary_write_event(JTraceRing* ring, JTraceEvent const* event, gchar const* const* names, gdouble ticks_per_usec)
+{
+	gchar const* flow_phases[] = { "s", "t", "f" };
+	gchar const* name = NULL;
+	gint64 timestamp;
+
+	if (event->type != J_TRACE_EVENT_LEAVE)
+	{
+		name = names[event->function];
+	}
+
+	timestamp = j_trace_binary_real * 1000 + (gint64)((gdouble)(event->ticks - j_trace_binary_ticks) * 1000.0 / ticks_per_usec);
+
+	switch (event->type)
+	{
+		case J_TRACE_EVENT_ENTER:
+			j_trace_binary_write_prefix("B", name, timestamp, ring->thread_id);
+
+			if (event->correlation != 0)
+			{
+				// IDs are written as strings because JSON numbers cannot represent all 64-bit values
+				fprintf(j_trace_binary_file, ",\"args\":{\"correlation\":\"%016" G_GINT64_MODIFIER "x\"", event->correlation);
+
+				if (event->value != 0)
+				{
+					fprintf(j_trace_binary_file, ",\"span\":\"%016" G_GINT64_MODIFIER "x\"", event->value);
+				}
+
+				fputs("}", j_trace_binary_file);
+			}
+
+			break;
+		case J_TRACE_EVENT_LEAVE:
+			j_trace_binary_write_prefix("E", NULL, timestamp, ring->thread_id);
+
+			if (event->value != 0)
+			{
+				fprintf(j_trace_binary_file, ",\"args\":{\"length\":%" G_GUINT64_FORMAT "}", event->value);
+			}
+
+			break;
+		case J_TRACE_EVENT_COUNTER:
+			j_trace_binary_write_prefix("C", name, timestamp, ring->thread_id);
+			fprintf(j_trace_binary_file, ",\"args\":{\"value\":%" G_GUINT64_FORMAT "}", event->value);
+			break;
+		case J_TRACE_EVENT_FLOW_BEGIN:
+		case J_TRACE_EVENT_FLOW_STEP:
+		case J_TRACE_EVENT_FLOW_END:
+			j_trace_binary_write_prefix(flow_phases[event->type - J_TRACE_EVENT_FLOW_BEGIN], name, timestamp, ring->thread_id);
+			fprintf(j_trace_binary_file, ",\"cat\":\"message\",\"id\":\"%016" G_GINT64_MODIFIER "x\"", event->value);
+
+			// steps and ends are bound to the enclosing slice
+			if (event->type != J_TRACE_EVENT_FLOW_BEGIN)
+			{
+				fputs(",\"bp\":\"e\"", j_trace_binary_file);
+			}
+
+			if (event->correlation != 0)
+			{
+				fprintf(j_trace_binary_file, ",\"args\":{\"correlation\":\"%016" G_GINT64_MODIFIER "x\"}", event->correlation);
+			}
+
+			break;
+		default:
+			g_warn_if_reached();
+			break;
+	}
+
+	fputs("}", j_trace_binary_file);
+}
+
+/**
+ * Writes the events of all ring buffers to the trace file.
+ * Ring buffers of threads that have exited are freed afterwards.
+ *
+ * Only the flush thread writes to the trace file.
+ * Interned names are never freed while tracing, so the events are formatted using a copy of the name array
+ * and threads interning new functions do not have to wait for the file to be written.
+ *
+ * \private
+ **/
+static void
+j_trace_binary_flush(void)
+{
+	g_autofree gchar const** names = NULL;
+	GList* rings;
+	gdouble ticks_per_usec;
+	guint names_len = 0;
+
+	ticks_per_usec = j_trace_binary_calibrate();
+
+	G_LOCK(j_trace_binary_rings);
+	rings = g_list_copy(j_trace_binary_rings);
+	G_UNLOCK(j_trace_binary_rings);
+
+	for (GList* l = rings; l != NULL; l = l->next)
+	{
+		JTraceRing* ring = l->data;
+		gboolean finished;
+		guint dropped;
+		guint head;
+		guint tail;
+
+		// check whether the thread has exited first, it does not record events afterwards
+		finished = g_atomic_int_get(&(ring->finished));
+		head = g_atomic_int_get(&(ring->head));
+		tail = ring->tail;
+
+		if (!ring->announced)
+		{
+			j_trace_binary_write_prefix("M", "thread_name", j_trace_binary_real * 1000, ring->thread_id);
+			fprintf(j_trace_binary_file, ",\"args\":{\"name\":\"%s\"}}", ring->thread_name);
+			ring->announced = TRUE;
+		}
+
+		// functions are interned before their events are published, so the copy covers all events up to head
+		G_LOCK(j_trace_binary);
+
+		if (j_trace_binary_names->len != names_len)
+		{
+			names_len = j_trace_binary_names->len;
+			names = g_renew(gchar const*, names, names_len);
+			memcpy(names, j_trace_binary_names->pdata, names_len * sizeof(gchar const*));
+		}
+
+		G_UNLOCK(j_trace_binary);
+
+		for (; tail != head; tail++)
+		{
+			j_trace_binary_write_event(ring, &(ring->events[tail & (J_TRACE_RING_SIZE - 1)]), names, ticks_per_usec);
+		}
+
+		g_atomic_int_set(&(ring->tail), tail);
+
+		dropped = g_atomic_int_get(&(ring->dropped));
+
+		if (dropped != ring->dropped_reported)
+		{
+			j_trace_binary_write_prefix("C", "dropped_events", g_get_real_time() * 1000, ring->thread_id);
+			fprintf(j_trace_binary_file, ",\"args\":{\"value\":%u}}", dropped);
+			ring->dropped_reported = dropped;
+		}
+
+		if (finished)
+		{
+			G_LOCK(j_trace_binary_rings);
+			j_trace_binary_rings = g_list_remove(j_trace_binary_rings, ring);
+			G_UNLOCK(j_trace_binary_rings);
+
+			j_trace_binary_ring_free(ring);
+		}
+	}
+
+	g_list_free(rings);
+
+	fflush(j_trace_binary_file);
+}
+
+/**
+ * Periodically flushes the ring buffers until j_trace_fini() is called.
+ *
+ * \private
+ *
+ * \param data Unused.
+ *
+ * \return NULL.
+ **/
+static gpointer
+j_trace_binary_thread_func(gpointer data)
+{
+	(void)data;
+
+	g_mutex_lock(&j_trace_binary_mutex);
+
+	while (!j_trace_binary_stop)
+	{
+		gint64 end_time;
+
+		end_time = g_get_monotonic_time() + J_TRACE_FLUSH_INTERVAL * G_TIME_SPAN_MILLISECOND;
+
+		if (g_cond_wait_until(&j_trace_binary_cond, &j_trace_binary_mutex, end_time) && !j_trace_binary_stop)
+		{
+			continue;
+		}
+
+		g_mutex_unlock(&j_trace_binary_mutex);
+		j_trace_binary_flush();
+		g_mutex_lock(&j_trace_binary_mutex);
+	}
+
+	g_mutex_unlock(&j_trace_binary_mutex);
+
+	return NULL;
+}
+
 void
 j_trace_init(gchar const* name)
 {
@@ -385,6 +981,10 @@ j_trace_init(gchar const* name)
 		{
 			j_trace_flags |= J_TRACE_SUMMARY;
 		}
+		else if (g_strcmp0(trace_parts[i], "binary") == 0)
+		{
+			j_trace_flags |= J_TRACE_BINARY;
+		}
 	}
 
 	if (j_trace_flags == J_TRACE_OFF)
@@ -433,6 +1033,49 @@ j_trace_init(gchar const* name)
 		j_trace_summary_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	}
 
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		g_autofree gchar* file_name = NULL;
+		g_autofree gchar* path = NULL;
+		gchar const* directory;
+
+		if ((directory = g_getenv("JULEA_TRACE_DIRECTORY")) == NULL)
+		{
+			directory = ".";
+		}
+
+		file_name = g_strdup_printf("%s-%d.json", name, (gint)getpid());
+		path = g_build_filename(directory, file_name, NULL);
+
+		if ((j_trace_binary_file = g_fopen(path, "w")) == NULL)
+		{
+			g_warning("Cannot open trace file %s.", path);
+			j_trace_flags &= ~J_TRACE_BINARY;
+		}
+	}
+
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		g_autofree gchar* escaped_name = NULL;
+
+		j_trace_binary_functions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+		j_trace_binary_names = g_ptr_array_new_with_free_func(g_free);
+		j_trace_binary_events = 0;
+
+		j_trace_binary_ticks = j_trace_ticks();
+		j_trace_binary_monotonic = g_get_monotonic_time();
+		j_trace_binary_real = g_get_real_time();
+
+		// the file is a JSON array of Chrome Trace events that can be loaded into Perfetto
+		escaped_name = g_strescape(name, NULL);
+		fputs("[\n", j_trace_binary_file);
+		j_trace_binary_write_prefix("M", "process_name", j_trace_binary_real * 1000, 0);
+		fprintf(j_trace_binary_file, ",\"args\":{\"name\":\"%s\"}}", escaped_name);
+
+		j_trace_binary_stop = FALSE;
+		j_trace_binary_thread = g_thread_new("JTrace", j_trace_binary_thread_func, NULL);
+	}
+
 	g_free(j_trace_name);
 	j_trace_name = g_strdup(name);
 }
@@ -445,6 +1088,9 @@ j_trace_fini(void)
 		return;
 	}
 
+	// free the current thread's trace thread while the back-ends are still available
+	g_private_replace(&j_trace_thread_default, NULL);
+
 #ifdef HAVE_OTF
 	if (j_trace_flags & J_TRACE_OTF)
 	{
@@ -483,6 +1129,34 @@ j_trace_fini(void)
 		g_hash_table_unref(j_trace_summary_table);
 	}
 
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		g_mutex_lock(&j_trace_binary_mutex);
+		j_trace_binary_stop = TRUE;
+		g_cond_signal(&j_trace_binary_cond);
+		g_mutex_unlock(&j_trace_binary_mutex);
+
+		g_thread_join(j_trace_binary_thread);
+		j_trace_binary_thread = NULL;
+
+		// write the events that have been recorded since the last flush
+		j_trace_binary_flush();
+
+		fputs("\n]\n", j_trace_binary_file);
+		fclose(j_trace_binary_file);
+		j_trace_binary_file = NULL;
+
+		// threads that are still running do not access their ring buffers after tracing has been disabled
+		g_list_free_full(j_trace_binary_rings, (GDestroyNotify)j_trace_binary_ring_free);
+		j_trace_binary_rings = NULL;
+
+		g_ptr_array_unref(j_trace_binary_names);
+		j_trace_binary_names = NULL;
+
+		g_hash_table_unref(j_trace_binary_functions);
+		j_trace_binary_functions = NULL;
+	}
+
 	j_trace_flags = J_TRACE_OFF;
 
 	if (j_trace_function_patterns != NULL)
@@ -495,8 +1169,8 @@ j_trace_fini(void)
 		}
 	}
 
-	g_free(j_trace_function_patterns);
-	g_free(j_trace_name);
+	g_clear_pointer(&j_trace_function_patterns, g_free);
+	g_clear_pointer(&j_trace_name, g_free);
 }
 
 JTrace*
@@ -516,7 +1190,42 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 
 	trace_thread = j_trace_thread_get_default();
 
-	if (!j_trace_function_check(name))
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		JTraceFunction const* function;
+
+		function = j_trace_binary_function_get(trace_thread, name);
+
+		if (!function->traced)
+		{
+			return NULL;
+		}
+
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_ENTER, function->id, trace_thread->span);
+
+		if (j_trace_flags == J_TRACE_BINARY)
+		{
+			// neither the name nor the enter time are needed, so traces can be reused
+			if (trace_thread->function_depth < J_TRACE_POOL_SIZE)
+			{
+				trace = &(trace_thread->binary.traces[trace_thread->function_depth]);
+				trace->pooled = TRUE;
+			}
+			else
+			{
+				trace = g_new(JTrace, 1);
+				trace->pooled = FALSE;
+			}
+
+			trace->name = NULL;
+			trace->enter_time = 0;
+
+			trace_thread->function_depth++;
+
+			return trace;
+		}
+	}
+	else if (!j_trace_function_check(name))
 	{
 		/// \todo also blacklist nested functions
 		return NULL;
@@ -527,6 +1236,7 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 	trace = g_new(JTrace, 1);
 	trace->name = g_strdup(name);
 	trace->enter_time = timestamp;
+	trace->pooled = FALSE;
 
 	va_start(args, format);
 
@@ -621,7 +1331,8 @@ j_trace_leave(JTrace* trace)
 
 	trace_thread = j_trace_thread_get_default();
 
-	if (!j_trace_function_check(trace->name))
+	// binary traces have already been checked in j_trace_enter()
+	if (!(j_trace_flags & J_TRACE_BINARY) && !j_trace_function_check(trace->name))
 	{
 		goto end;
 	}
@@ -633,6 +1344,17 @@ j_trace_leave(JTrace* trace)
 	}
 
 	trace_thread->function_depth--;
+
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_LEAVE, 0, 0);
+
+		if (j_trace_flags == J_TRACE_BINARY)
+		{
+			goto end;
+		}
+	}
+
 	timestamp = g_get_real_time();
 
 	if (j_trace_flags & J_TRACE_ECHO)
@@ -702,8 +1424,11 @@ j_trace_leave(JTrace* trace)
 	}
 
 end:
-	g_free(trace->name);
-	g_free(trace);
+	if (!trace->pooled)
+	{
+		g_free(trace->name);
+		g_free(trace);
+	}
 }
 
 void
@@ -722,6 +1447,15 @@ j_trace_file_begin(gchar const* path, JTraceFileOperation op)
 	trace_thread = j_trace_thread_get_default();
 	timestamp = g_get_real_time();
 
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		JTraceFunction const* function;
+
+		// paths do not fit into fixed-size events, only the operation is recorded
+		function = j_trace_binary_function_get(trace_thread, j_trace_file_operation_name(op));
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_ENTER, function->id, 0);
+	}
+
 	if (j_trace_flags & J_TRACE_ECHO)
 	{
 		G_LOCK(j_trace_echo);
@@ -773,6 +1507,11 @@ j_trace_file_end(gchar const* path, JTraceFileOperation op, guint64 length, guin
 	trace_thread = j_trace_thread_get_default();
 	timestamp = g_get_real_time();
 
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_LEAVE, 0, (op == J_TRACE_FILE_READ || op == J_TRACE_FILE_WRITE) ? length : 0);
+	}
+
 	if (j_trace_flags & J_TRACE_ECHO)
 	{
 		G_LOCK(j_trace_echo);
@@ -859,6 +1598,14 @@ j_trace_counter(gchar const* name, guint64 counter_value)
 	trace_thread = j_trace_thread_get_default();
 	timestamp = g_get_real_time();
 
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		JTraceFunction const* function;
+
+		function = j_trace_binary_function_get(trace_thread, name);
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_COUNTER, function->id, counter_value);
+	}
+
 	if (j_trace_flags & J_TRACE_ECHO)
 	{
 		G_LOCK(j_trace_echo);
@@ -894,6 +1641,120 @@ j_trace_counter(gchar const* name, guint64 counter_value)
 #endif
 }
 
+guint64
+j_trace_correlation_new(void)
+{
+	guint64 correlation;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return 0;
+	}
+
+	// random IDs allow matching the traces of different processes without coordination
+	do
+	{
+		correlation = ((guint64)g_random_int() << 32) | g_random_int();
+	} while (correlation == 0);
+
+	return correlation;
+}
+
+guint64
+j_trace_get_correlation(void)
+{
+	JTraceThread* trace_thread;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return 0;
+	}
+
+	trace_thread = j_trace_thread_get_default();
+
+	return trace_thread->correlation;
+}
+
+void
+j_trace_set_correlation(guint64 correlation)
+{
+	JTraceThread* trace_thread;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return;
+	}
+
+	trace_thread = j_trace_thread_get_default();
+	trace_thread->correlation = correlation;
+}
+
+guint64
+j_trace_get_span(void)
+{
+	JTraceThread* trace_thread;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return 0;
+	}
+
+	trace_thread = j_trace_thread_get_default();
+
+	return trace_thread->span;
+}
+
+void
+j_trace_set_span(guint64 span)
+{
+	JTraceThread* trace_thread;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return;
+	}
+
+	trace_thread = j_trace_thread_get_default();
+	trace_thread->span = span;
+}
+
+void
+j_trace_flow(gchar const* name, JTraceFlow flow, guint64 id)
+{
+	JTraceThread* trace_thread;
+	guint64 timestamp;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return;
+	}
+
+	g_return_if_fail(name != NULL);
+	g_return_if_fail(id != 0);
+
+	trace_thread = j_trace_thread_get_default();
+
+	if (j_trace_flags & J_TRACE_BINARY)
+	{
+		JTraceFunction const* function;
+
+		function = j_trace_binary_function_get(trace_thread, name);
+		j_trace_binary_record(trace_thread, J_TRACE_EVENT_FLOW_BEGIN + flow, function->id, id);
+	}
+
+	if (j_trace_flags & J_TRACE_ECHO)
+	{
+		gchar const* flow_names[] = { "BEGIN", "STEP", "END" };
+
+		timestamp = g_get_real_time();
+
+		G_LOCK(j_trace_echo);
+		j_trace_echo_printerr(trace_thread, timestamp);
+		g_printerr("FLOW %s %s %016" G_GINT64_MODIFIER "x\n", flow_names[flow], name, id);
+		G_UNLOCK(j_trace_echo);
+	}
+}
+
 /**
  * @}
  **/
@@ -845,3 +845,64 @@ j_bson_append_document_end(bson_t* bson, bson_t* bson_child, GError** error)
 _error:
 	return FALSE;
 }
+
+/**
+ * Determines the result type of an aggregate.
+ *
+ * The client and all DB backends rely on this function to agree on the type of aggregates.
+ * FALSE is returned if the aggregate can not be applied to the field type.
+ **/
+gboolean
+j_bson_aggregate_type(JDBAggregate aggregate, JDBType field_type, JDBType* type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (field_type == J_DB_TYPE_ID)
+	{
+		field_type = J_DB_TYPE_UINT64;
+	}
+
+	switch (aggregate)
+	{
+		case J_DB_AGGREGATE_COUNT:
+			*type = J_DB_TYPE_UINT64;
+			return TRUE;
+		case J_DB_AGGREGATE_MIN:
+		case J_DB_AGGREGATE_MAX:
+			*type = field_type;
+			return (field_type != J_DB_TYPE_BLOB);
+		case J_DB_AGGREGATE_SUM:
+		case J_DB_AGGREGATE_AVG:
+			break;
+		default:
+			return FALSE;
+	}
+
+	switch (field_type)
+	{
+		case J_DB_TYPE_SINT32:
+		case J_DB_TYPE_SINT64:
+			*type = J_DB_TYPE_SINT64;
+			break;
+		case J_DB_TYPE_UINT32:
+		case J_DB_TYPE_UINT64:
+			*type = J_DB_TYPE_UINT64;
+			break;
+		case J_DB_TYPE_FLOAT32:
+		case J_DB_TYPE_FLOAT64:
+			*type = J_DB_TYPE_FLOAT64;
+			break;
+		case J_DB_TYPE_STRING:
+		case J_DB_TYPE_BLOB:
+		case J_DB_TYPE_ID:
+		default:
+			return FALSE;
+	}
+
+	if (aggregate == J_DB_AGGREGATE_AVG)
+	{
+		*type = J_DB_TYPE_FLOAT64;
+	}
+
+	return TRUE;
+}
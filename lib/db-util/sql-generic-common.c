@@ -24,6 +24,7 @@
 GPrivate thread_variables_global = G_PRIVATE_INIT(thread_variables_fini);
 JSQLSpecifics* specs;
 G_LOCK_DEFINE(sql_backend_lock);
+gint prepared_generation_global = 0;
 
 gboolean
 sql_generic_init(JSQLSpecifics* specifics)
@@ -56,6 +57,19 @@ sql_generic_init(JSQLSpecifics* specifics)
 		goto _error;
 	}
 
+	if (G_UNLIKELY(!specs->func.sql_exec(connection,
+					     "CREATE TABLE IF NOT EXISTS schema_index ("
+					     "namespace VARCHAR(255),"
+					     "name VARCHAR(255),"
+					     "idx INTEGER,"
+					     "position INTEGER,"
+					     "varname VARCHAR(255)"
+					     ")",
+					     NULL)))
+	{
+		goto _error;
+	}
+
 	ret = TRUE;
 
 _error:
@@ -90,6 +104,18 @@ thread_variables_fini(void* ptr)
 			g_hash_table_destroy(thread_variables->schema_cache);
 		}
 
+		if (thread_variables->index_cache)
+		{
+			// keys and values will be freed by the at create time supplied free functions
+			g_hash_table_destroy(thread_variables->index_cache);
+		}
+
+		if (thread_variables->prepared_cache)
+		{
+			// keys and values will be freed by the at create time supplied free functions
+			g_hash_table_destroy(thread_variables->prepared_cache);
+		}
+
 		if (thread_variables->db_connection)
 		{
 			specs->func.connection_close(thread_variables->db_connection);
@@ -116,8 +142,13 @@ thread_variables_get(gpointer backend_data, GError** error)
 		thread_variables->db_connection = specs->func.connection_open(backend_data);
 		thread_variables->query_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (void (*)(void*))j_sql_statement_free);
 		thread_variables->schema_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (void (*)(void*))g_hash_table_unref);
+		thread_variables->index_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (void (*)(void*))g_ptr_array_unref);
+		// keys are part of the values
+		thread_variables->prepared_cache = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, j_sql_prepared_free);
+		g_queue_init(&thread_variables->prepared_lru);
+		thread_variables->prepared_generation = g_atomic_int_get(&prepared_generation_global);
 
-		if (!(thread_variables->db_connection && thread_variables->query_cache && thread_variables->schema_cache))
+		if (!(thread_variables->db_connection && thread_variables->query_cache && thread_variables->schema_cache && thread_variables->index_cache && thread_variables->prepared_cache))
 		{
 			goto _error;
 		}
@@ -21,6 +21,64 @@
 
 #include "sql-generic-internal.h"
 
+/**
+ * \brief Record one field of an index in the schema_index table.
+ *
+ * The planner uses these records to decide whether an index can serve a selector.
+ */
+static gboolean
+schema_index_insert(JThreadVariables* thread_variables, JSqlStatement* statement, gchar const* namespace, gchar const* name, guint idx, guint position, gchar const* varname, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+
+	value.val_string = namespace;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = name;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_uint32 = idx;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, 3, J_DB_TYPE_UINT32, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_uint32 = position;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, 4, J_DB_TYPE_UINT32, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = varname;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, 5, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_step_and_reset_check_done(thread_variables->db_connection, statement->stmt, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
 gboolean
 sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* schema, GError** error)
 {
@@ -36,7 +94,9 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 	JSqlBatch* batch = _batch;
 	JThreadVariables* thread_variables = NULL;
 	JSqlStatement* metadata_insert_query = NULL;
+	JSqlStatement* index_insert_query = NULL;
 	const gchar* metadata_insert_sql = "INSERT INTO schema_structure(namespace, name, varname, vartype) VALUES (?, ?, ?, ?)";
+	const gchar* index_insert_sql = "INSERT INTO schema_index(namespace, name, idx, position, varname) VALUES (?, ?, ?, ?, ?)";
 	g_autoptr(GString) create_sql = g_string_new(NULL);
 
 	g_return_val_if_fail(name != NULL, FALSE);
@@ -74,6 +134,34 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 		}
 	}
 
+	index_insert_query = g_hash_table_lookup(thread_variables->query_cache, index_insert_sql);
+
+	if (!index_insert_query)
+	{
+		g_autoptr(GArray) arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+		type = J_DB_TYPE_UINT32;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+
+		if (!(index_insert_query = j_sql_statement_new(index_insert_sql, arr_types_in, NULL, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(index_insert_sql), index_insert_query))
+		{
+			// in all other error cases index_insert_query is already owned by the hash table
+			j_sql_statement_free(index_insert_query);
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!_backend_batch_execute(backend_data, batch, error)))
 	{
 		//no ddl in transaction - most databases won't support that - continue without any open transaction
@@ -194,6 +282,7 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 		while (TRUE)
 		{
 			bson_iter_t iter_child2;
+			guint position = 0;
 			g_autoptr(GString) index_create = g_string_new(NULL);
 
 			if (G_UNLIKELY(!j_bson_iter_next(&iter_child, &has_next, error)))
@@ -247,6 +336,13 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 
 				string_tmp = value.val_string;
 				g_string_append_printf(index_create, "%s%s%s", specs->sql.quote, string_tmp, specs->sql.quote);
+
+				if (G_UNLIKELY(!schema_index_insert(thread_variables, index_insert_query, batch->namespace, name, i, position, string_tmp, error)))
+				{
+					goto _error;
+				}
+
+				position++;
 			}
 
 			g_string_append(index_create, " )");
@@ -389,7 +485,10 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 	JSqlBatch* batch = _batch;
 	g_autoptr(GString) table_drop_sql = NULL;
 	JSqlStatement* metadata_delete_query = NULL;
+	JSqlStatement* index_delete_query = NULL;
 	const gchar* metadata_delete_sql = "DELETE FROM schema_structure WHERE namespace=? AND name=?";
+	const gchar* index_delete_sql = "DELETE FROM schema_index WHERE namespace=? AND name=?";
+	g_autoptr(GString) cache_key = NULL;
 
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(batch != NULL, FALSE);
@@ -426,6 +525,30 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 		}
 	}
 
+	index_delete_query = g_hash_table_lookup(thread_variables->query_cache, index_delete_sql);
+
+	if (!index_delete_query)
+	{
+		JDBType type;
+		g_autoptr(GArray) arr_types_in = NULL;
+		arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+
+		if (!(index_delete_query = j_sql_statement_new(index_delete_sql, arr_types_in, NULL, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(index_delete_sql), index_delete_query))
+		{
+			// in all other error cases index_delete_query is already owned by the hash table
+			j_sql_statement_free(index_delete_query);
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!_backend_batch_execute(backend_data, batch, error)))
 	{
 		//no ddl in transaction - most databases wont support that - continue without any open transaction
@@ -451,11 +574,39 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 		goto _error;
 	}
 
+	value.val_string = batch->namespace;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, index_delete_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = name;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, index_delete_query->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_step_and_reset_check_done(thread_variables->db_connection, index_delete_query->stmt, error)))
+	{
+		goto _error;
+	}
+
+	// a schema with the same name might be created again, so the cached information of this thread is dropped
+	cache_key = g_string_new(batch->namespace);
+	g_string_append(cache_key, "_");
+	g_string_append(cache_key, name);
+	g_hash_table_remove(thread_variables->schema_cache, cache_key->str);
+	g_hash_table_remove(thread_variables->index_cache, cache_key->str);
 	if (G_UNLIKELY(!specs->func.sql_exec(thread_variables->db_connection, table_drop_sql->str, error)))
 	{
 		goto _error;
 	}
 
+	// prepared selectors do not record the schemas they refer to, so all threads drop theirs
+	g_atomic_int_inc(&prepared_generation_global);
+
 	if (G_UNLIKELY(!_backend_batch_start(backend_data, batch, error)))
 	{
 		goto _error;
@@ -302,524 +302,278 @@ sql_generic_schema_get(gpointer backend_data, gpointer _batch, gchar const* name
 	return ret;
 }
 
-gboolean
-build_query_condition_part(gpointer backend_data, JSqlBatch* batch, bson_iter_t* iter, GString* sql, JDBSelectorMode mode, GArray* arr_types_in, GHashTable* variable_types, GError** error)
+static gboolean
+build_query_selection_part(JSqlPlan* plan, gpointer backend_data, GString* sql, JSqlBatch* batch, GHashTable* out_variables_index, GHashTable* variables_type, GArray* arr_types_out, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean first = TRUE;
 
-	g_string_append(sql, "( ");
+	g_autoptr(GString) sqlTablesName = g_string_new(NULL);
 
-	while (TRUE)
+	// Iterate through all tables in join order
+	for (guint i = 0; i < plan->tables->len; i++)
 	{
-		JDBTypeValue value;
-		gboolean has_next;
-		bson_iter_t iterchild;
-		const gchar* key = NULL;
+		JSqlPlanAccess* access = g_ptr_array_index(plan->tables, i);
+		g_autoptr(GHashTable) schema = NULL;
+		GHashTableIter schemaIter;
+		gpointer key;
+		gpointer field_type;
 
-		if (G_UNLIKELY(!j_bson_iter_next(iter, &has_next, error)))
+		if (!(schema = get_schema(backend_data, batch->namespace, access->table, error)))
 		{
 			goto _error;
 		}
 
-		if (!has_next)
-		{
-			break;
-		}
+		// Fetch all fields in this schema and store their type and position in respective maps.
+		g_hash_table_iter_init(&schemaIter, schema);
 
-		if (G_UNLIKELY(!j_bson_iter_skip_key(iter, "m", error)))
+		while (g_hash_table_iter_next(&schemaIter, &key, &field_type))
 		{
-			// there was either an error or no key is left now
-			if (*error)
-			{
-				goto _error;
-			}
-			else
-			{
-				break;
-			}
-		}
+			JDBType itemDataType;
+			const gchar* field = key;
 
-		key = j_bson_iter_key(iter, error);
+			itemDataType = GPOINTER_TO_INT(field_type);
 
-		if (!first)
-		{
-			switch (mode)
+			if (!first)
 			{
-				case J_DB_SELECTOR_MODE_AND:
-					g_string_append(sql, " AND ");
-					break;
-				case J_DB_SELECTOR_MODE_OR:
-					g_string_append(sql, " OR ");
-					break;
-				default:
-					g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_OPERATOR_INVALID, "operator invalid");
-					goto _error;
+				g_string_append(sql, ", ");
 			}
-		}
 
-		first = FALSE;
+			first = FALSE;
 
-		if (g_str_equal(key, "_s"))
-		{
-			JDBSelectorMode mode_child;
+			g_string_append(sql, field);
 
-			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			if (!g_hash_table_insert(out_variables_index, g_strdup(field), GINT_TO_POINTER(g_hash_table_size(out_variables_index))))
 			{
 				goto _error;
 			}
 
-			j_bson_iter_find(&iterchild, "m", error);
-
-			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, J_DB_TYPE_UINT32, &value, error)))
+			if (!g_hash_table_insert(variables_type, g_strdup(field), GINT_TO_POINTER(itemDataType)))
 			{
 				goto _error;
 			}
 
-			mode_child = value.val_uint32;
-
-			if (G_UNLIKELY(!build_query_condition_part(backend_data, batch, &iterchild, sql, mode_child, arr_types_in, variable_types, error)))
-			{
-				goto _error;
-			}
+			g_array_append_val(arr_types_out, itemDataType);
 		}
-		else
-		{
-			JDBType type;
-			JDBSelectorOperator op;
-			g_autoptr(GString) full_name = NULL;
-			const gchar* field = NULL;
-			const gchar* table = NULL;
-			g_autoptr(GHashTable) schema = NULL;
-
-			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
-			{
-				goto _error;
-			}
-
-			field = j_bson_iter_key(iter, error);
-
-			if (!j_bson_iter_find(&iterchild, "t", error))
-			{
-				goto _error;
-			}
-
-			if (!j_bson_iter_value(&iterchild, J_DB_TYPE_STRING, &value, error))
-			{
-				goto _error;
-			}
-
-			table = value.val_string;
-
-			full_name = j_sql_get_full_field_name(batch->namespace, table, field);
-
-			schema = get_schema(backend_data, batch->namespace, table, error);
-
-			g_string_append(sql, full_name->str);
 
-			// add type infos
-			type = GPOINTER_TO_INT(g_hash_table_lookup(schema, full_name->str));
-			g_array_append_val(arr_types_in, type);
-
-			if (G_UNLIKELY(!j_bson_iter_find(&iterchild, "o", error)))
-			{
-				goto _error;
-			}
-
-			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, J_DB_TYPE_UINT32, &value, error)))
-			{
-				goto _error;
-			}
-
-			op = value.val_uint32;
-
-			switch (op)
-			{
-				case J_DB_SELECTOR_OPERATOR_LT:
-					g_string_append(sql, "<");
-					break;
-				case J_DB_SELECTOR_OPERATOR_LE:
-					g_string_append(sql, "<=");
-					break;
-				case J_DB_SELECTOR_OPERATOR_GT:
-					g_string_append(sql, ">");
-					break;
-				case J_DB_SELECTOR_OPERATOR_GE:
-					g_string_append(sql, ">=");
-					break;
-				case J_DB_SELECTOR_OPERATOR_EQ:
-					g_string_append(sql, "=");
-					break;
-				case J_DB_SELECTOR_OPERATOR_NE:
-					g_string_append(sql, "!=");
-					break;
-				default:
-					g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_COMPARATOR_INVALID, "comparator invalid");
-					goto _error;
-			}
-
-			g_string_append_printf(sql, " ?");
+		if (sqlTablesName->len > 0)
+		{
+			g_string_append(sqlTablesName, ", ");
 		}
-	}
 
-	g_string_append(sql, " )");
-
-	// the selector was empty (which is allowed and will be the case for simple queries like 'SELECT * FROM table')
-	if (first)
-	{
-		// this is only valid if sql does not contain any previous results!
-		// if we decide to append to previous query parts another solution would be to append "(TRUE)""
-		g_string_assign(sql, "");
+		g_string_append_printf(sqlTablesName, "%s%s_%s%s", specs->sql.quote, batch->namespace, access->table, specs->sql.quote);
 	}
 
+	g_string_append(sql, " FROM ");
+	g_string_append(sql, sqlTablesName->str);
+
 	return TRUE;
 
 _error:
 	return FALSE;
 }
 
+/**
+ * \brief Formulate the selection part of an aggregate query.
+ *
+ * The aggregate is returned as the pseudo field `_aggregate` of the aggregated table, followed by the group field if there is one.
+ */
 static gboolean
-_bind_selector_query(gpointer backend_data, const gchar* namespace, bson_iter_t* iter, JSqlStatement* statement, GHashTable* variable_types, guint64* position, GError** error)
+build_query_aggregate_part(JSqlPlan* plan, gpointer backend_data, bson_t const* selector, GString* sql, GString* sql_group_part, JSqlBatch* batch, GHashTable* out_variables_index, GHashTable* variables_type, GArray* arr_types_out, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JThreadVariables* thread_variables = NULL;
+	static gchar const* functions[] = { "COUNT", "MIN", "MAX", "SUM", "AVG" };
 
-	if (G_UNLIKELY(!(thread_variables = thread_variables_get(backend_data, error))))
+	JDBTypeValue value;
+	JDBAggregate aggregate;
+	JDBType field_type = BACKEND_ID_TYPE;
+	JDBType type;
+	bson_iter_t iter;
+	bson_iter_t iter_child;
+	gchar const* table;
+	g_autoptr(GHashTable) schema = NULL;
+	g_autoptr(GString) field = NULL;
+	g_autoptr(GString) group = NULL;
+	g_autoptr(GString) result = NULL;
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
 	{
 		goto _error;
 	}
 
-	while (TRUE)
+	if (G_UNLIKELY(!j_bson_iter_find(&iter, "a", error)))
 	{
-		bson_iter_t iterchild;
-		JDBTypeValue value;
-		gboolean has_next;
-		gboolean is_sub_selector = FALSE;
-
-		if (G_UNLIKELY(!j_bson_iter_next(iter, &has_next, error)))
-		{
-			goto _error;
-		}
-
-		if (!has_next)
-		{
-			break;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_skip_key(iter, "m", error)))
-		{
-			// there was either an error or no key is left now
-			if (*error)
-			{
-				goto _error;
-			}
-			else
-			{
-				break;
-			}
-		}
-
-		if (!j_bson_iter_key_equals(iter, "_s", &is_sub_selector, error))
-		{
-			goto _error;
-		}
-
-		if (is_sub_selector)
-		{
-			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
-			{
-				goto _error;
-			}
-
-			if (G_UNLIKELY(!_bind_selector_query(backend_data, namespace, &iterchild, statement, variable_types, position, error)))
-			{
-				goto _error;
-			}
-		}
-		else
-		{
-			JDBType type;
-			g_autoptr(GString) full_name = NULL;
-			const gchar* field;
-			const gchar* table;
-
-			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
-			{
-				goto _error;
-			}
-
-			field = j_bson_iter_key(iter, error);
-
-			if (!j_bson_iter_find(&iterchild, "t", error))
-			{
-				goto _error;
-			}
-
-			if (!j_bson_iter_value(&iterchild, J_DB_TYPE_STRING, &value, error))
-			{
-				goto _error;
-			}
-
-			table = value.val_string;
-
-			full_name = j_sql_get_full_field_name(namespace, table, field);
-
-			if (G_UNLIKELY(!j_bson_iter_find(&iterchild, "v", error)))
-			{
-				goto _error;
-			}
-
-			type = GPOINTER_TO_INT(g_hash_table_lookup(statement->variable_types, full_name->str));
-
-			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, type, &value, error)))
-			{
-				goto _error;
-			}
-
-			(*position)++;
-
-			if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, *position, type, &value, error)))
-			{
-				goto _error;
-			}
-		}
+		goto _error;
 	}
 
-	return TRUE;
-
-_error:
-	return FALSE;
-}
-
-gboolean
-bind_selector_query(gpointer backend_data, const gchar* namespace, bson_iter_t* iter, JSqlStatement* statement, GHashTable* schema, GError** error)
-{
-	guint64 pos = 0;
-
-	return _bind_selector_query(backend_data, namespace, iter, statement, schema, &pos, error);
-}
-
-static gboolean
-build_query_selection_part(bson_t const* selector, gpointer backend_data, GString* sql, JSqlBatch* batch, GHashTable* out_variables_index, GHashTable* variables_type, GArray* arr_types_out, GError** error)
-{
-	J_TRACE_FUNCTION(NULL);
-
-	bson_iter_t iterChildDocument;
-	bson_iter_t iterCurrentDocument;
-	gboolean first = TRUE;
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
 
-	g_autoptr(GString) sqlTablesName = g_string_new(NULL);
+	if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "f", error)))
+	{
+		goto _error;
+	}
 
-	if (G_UNLIKELY(!j_bson_iter_init(&iterCurrentDocument, selector, error)))
+	if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_UINT32, &value, error)))
 	{
 		goto _error;
 	}
 
-	// Look for the key that is assigned to BSON array that contains tables' information.
-	if (G_UNLIKELY(!j_bson_iter_find(&iterCurrentDocument, "t", error)))
+	if (G_UNLIKELY(value.val_uint32 > J_DB_AGGREGATE_AVG))
 	{
-		// no joins present
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_OPERATOR_INVALID, "operator invalid");
 		goto _error;
 	}
 
-	// recurse into table array
-	if (G_UNLIKELY(!j_bson_iter_recurse_array(&iterCurrentDocument, &iterChildDocument, error)))
+	aggregate = value.val_uint32;
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
 	{
 		goto _error;
 	}
 
-	// Iterate through all table names
-	while (TRUE)
+	if (G_UNLIKELY(!j_bson_iter_find(&iter_child, "t", error)))
 	{
-		gboolean hasItems;
-		g_autoptr(GString) tableName = NULL;
-		g_autoptr(GHashTable) schema = NULL;
-		GHashTableIter schemaIter;
-		JDBTypeValue itemValue;
-		gpointer key;
-		gpointer field_type;
+		goto _error;
+	}
 
-		if (G_UNLIKELY(!j_bson_iter_next(&iterChildDocument, &hasItems, error)))
-		{
-			goto _error;
-		}
+	if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
 
-		if (!hasItems)
-		{
-			break;
-		}
+	table = value.val_string;
 
-		// Extract the table's name
-		if (G_UNLIKELY(!j_bson_iter_value(&iterChildDocument, J_DB_TYPE_STRING, &itemValue, error)))
-		{
-			goto _error;
-		}
+	if (!(schema = get_schema(backend_data, batch->namespace, table, error)))
+	{
+		goto _error;
+	}
 
-		tableName = g_string_new(batch->namespace); // Add namespace for the table.
-		g_string_append(tableName, "_");
-		g_string_append(tableName, itemValue.val_string);
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+	{
+		goto _error;
+	}
 
-		if (!(schema = get_schema(backend_data, batch->namespace, itemValue.val_string, error)))
+	if (bson_iter_find(&iter_child, "n"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
 		{
 			goto _error;
 		}
 
-		// Fetch all fields in this schema and store their type and position in respective maps.
-		g_hash_table_iter_init(&schemaIter, schema);
+		field = j_sql_get_full_field_name(batch->namespace, table, value.val_string);
 
-		while (g_hash_table_iter_next(&schemaIter, &key, &field_type))
+		if (g_strcmp0(value.val_string, "_id") != 0)
 		{
-			JDBType itemDataType;
-			const gchar* field = key;
-
-			itemDataType = GPOINTER_TO_INT(field_type);
-
-			if (!first)
-			{
-				g_string_append(sql, ", ");
-			}
+			gpointer field_type_ptr;
 
-			first = FALSE;
-
-			g_string_append(sql, field);
-
-			if (!g_hash_table_insert(out_variables_index, g_strdup(field), GINT_TO_POINTER(g_hash_table_size(out_variables_index))))
+			if (G_UNLIKELY(!g_hash_table_lookup_extended(schema, field->str, NULL, &field_type_ptr)))
 			{
+				g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND, "variable %s not found", value.val_string);
 				goto _error;
 			}
 
-			if (!g_hash_table_insert(variables_type, g_strdup(field), GINT_TO_POINTER(itemDataType)))
-			{
-				goto _error;
-			}
-
-			g_array_append_val(arr_types_out, itemDataType);
-		}
-
-		if (sqlTablesName->len > 0)
-		{
-			g_string_append(sqlTablesName, ", ");
+			field_type = GPOINTER_TO_INT(field_type_ptr);
 		}
-
-		g_string_append_printf(sqlTablesName, "%s%s%s", specs->sql.quote, tableName->str, specs->sql.quote);
 	}
 
-	g_string_append(sql, " FROM ");
-	g_string_append(sql, sqlTablesName->str);
-
-	return TRUE;
-
-_error:
-	return FALSE;
-}
-
-static gboolean
-build_query_join_part(bson_t const* selector, JSqlBatch* batch, GString* sql, GError** error)
-{
-	J_TRACE_FUNCTION(NULL);
-
-	gboolean hasItems;
-	JDBTypeValue itemValue;
-
-	bson_iter_t iter_selector;
-	bson_iter_t iter_joins;
-	bson_iter_t iter_join_entry;
-
-	if (G_UNLIKELY(!j_bson_iter_init(&iter_selector, selector, error)))
+	if (G_UNLIKELY(!j_bson_aggregate_type(aggregate, field_type, &type)))
 	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_DB_TYPE_INVALID, "db type invalid");
 		goto _error;
 	}
 
-	if (!j_bson_iter_find(&iter_selector, "j", error))
-	{
-		goto _error;
-	}
+	g_string_append_printf(sql, "%s(%s)", functions[aggregate], (field != NULL) ? field->str : "*");
 
-	if (!j_bson_iter_recurse_document(&iter_selector, &iter_joins, error))
+	result = j_sql_get_full_field_name(batch->namespace, table, "_aggregate");
+	g_hash_table_insert(out_variables_index, g_strdup(result->str), GINT_TO_POINTER(0));
+	g_hash_table_insert(variables_type, g_strdup(result->str), GINT_TO_POINTER(type));
+	g_array_append_val(arr_types_out, type);
+
+	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
 	{
 		goto _error;
 	}
 
-	while (TRUE)
+	if (bson_iter_find(&iter_child, "g"))
 	{
-		g_autoptr(GString) first = NULL;
-		g_autoptr(GString) second = NULL;
-		gboolean next = FALSE;
-		const gchar* table = NULL;
-		const gchar* field = NULL;
+		gpointer group_type_ptr;
 
-		if (G_UNLIKELY(!j_bson_iter_next(&iter_joins, &hasItems, error)))
+		if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
 		{
 			goto _error;
 		}
 
-		if (!hasItems)
-		{
-			break;
-		}
+		group = j_sql_get_full_field_name(batch->namespace, table, value.val_string);
 
-		// Recurse into join of the form { "<table_name>" : "<field_name>", "<table_name>" : "<field_name>" }
-		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter_joins, &iter_join_entry, error)))
+		if (G_UNLIKELY(!g_hash_table_lookup_extended(schema, group->str, NULL, &group_type_ptr)))
 		{
+			g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND, "variable %s not found", value.val_string);
 			goto _error;
 		}
 
-		// First field
-		j_bson_iter_next(&iter_join_entry, &next, error);
+		type = GPOINTER_TO_INT(group_type_ptr);
 
-		if (!next)
-		{
-			goto _error;
-		}
+		g_string_append_printf(sql, ", %s", group->str);
+		g_string_append_printf(sql_group_part, " GROUP BY %s", group->str);
 
-		table = j_bson_iter_key(&iter_join_entry, error);
+		g_hash_table_insert(out_variables_index, g_strdup(group->str), GINT_TO_POINTER(1));
+		g_hash_table_insert(variables_type, g_strdup(group->str), GINT_TO_POINTER(type));
+		g_array_append_val(arr_types_out, type);
+	}
 
-		if (!j_bson_iter_value(&iter_join_entry, J_DB_TYPE_STRING, &itemValue, error))
-		{
-			goto _error;
-		}
+	// The other functions return NULL if there are no values, which is reported as no result instead
+	if (aggregate != J_DB_AGGREGATE_COUNT)
+	{
+		g_string_append_printf(sql_group_part, " HAVING COUNT(%s) > 0", (field != NULL) ? field->str : "*");
+	}
 
-		field = itemValue.val_string;
+	if (group != NULL)
+	{
+		// the order makes the result deterministic and independent of the DB backend
+		g_string_append_printf(sql_group_part, " ORDER BY %s", group->str);
+	}
 
-		first = j_sql_get_full_field_name(batch->namespace, table, field);
+	g_string_append(sql, " FROM ");
 
-		// Second field
-		j_bson_iter_next(&iter_join_entry, &next, error);
+	for (guint i = 0; i < plan->tables->len; i++)
+	{
+		JSqlPlanAccess* access = g_ptr_array_index(plan->tables, i);
 
-		if (!next)
-		{
-			goto _error;
-		}
+		g_string_append_printf(sql, "%s%s%s_%s%s", (i > 0) ? ", " : "", specs->sql.quote, batch->namespace, access->table, specs->sql.quote);
+	}
 
-		table = j_bson_iter_key(&iter_join_entry, error);
+	return TRUE;
 
-		if (!j_bson_iter_value(&iter_join_entry, J_DB_TYPE_STRING, &itemValue, error))
-		{
-			goto _error;
-		}
+_error:
+	return FALSE;
+}
 
-		field = itemValue.val_string;
+static void
+build_query_join_part(JSqlPlan* plan, GString* sql)
+{
+	J_TRACE_FUNCTION(NULL);
 
-		second = j_sql_get_full_field_name(batch->namespace, table, field);
+	for (guint i = 0; i < plan->joins->len; i++)
+	{
+		JSqlPlanJoin* join = g_ptr_array_index(plan->joins, i);
+		g_autoptr(GString) first = NULL;
+		g_autoptr(GString) second = NULL;
 
-		// add parts together
-		g_string_append(first, " = ");
-		g_string_append(first, second->str);
+		first = j_sql_get_full_field_name(plan->namespace, join->table[0], join->field[0]);
+		second = j_sql_get_full_field_name(plan->namespace, join->table[1], join->field[1]);
 
 		if (sql->len > 0)
 		{
 			g_string_append(sql, " AND ");
 		}
 
-		g_string_append(sql, first->str);
+		g_string_append_printf(sql, "%s = %s", first->str, second->str);
 	}
-
-	return TRUE;
-
-_error:
-	return FALSE;
 }
 
 gboolean
@@ -829,12 +583,13 @@ _backend_query_ids(gpointer backend_data, gpointer _batch, gchar const* name, bs
 
 	JDBTypeValue value;
 	guint count = 0;
-	bson_iter_t iter, child;
 	JSqlBatch* batch = _batch;
 	g_autoptr(GHashTable) schema = NULL;
+	g_autoptr(JSqlPlan) plan = NULL;
 	JSqlStatement* id_query = NULL;
 	JThreadVariables* thread_variables = NULL;
 	g_autoptr(GString) id_sql = g_string_new(NULL);
+	g_autoptr(GString) sql_condition_part = g_string_new(NULL);
 	g_autoptr(GArray) arr_types_in = NULL;
 	GArray* ids_out = NULL;
 
@@ -854,43 +609,17 @@ _backend_query_ids(gpointer backend_data, gpointer _batch, gchar const* name, bs
 
 	g_string_append_printf(id_sql, "SELECT DISTINCT _id FROM %s%s_%s%s", specs->sql.quote, batch->namespace, name, specs->sql.quote);
 
-	if (selector)
+	if (!(plan = j_sql_plan_new(backend_data, batch, name, selector, error)))
 	{
-		JDBSelectorMode mode_child;
-
-		g_string_append(id_sql, " WHERE ");
-
-		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_find(&iter, "s", error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &child, error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_find(&child, "m", error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_value(&child, J_DB_TYPE_UINT32, &value, error)))
-		{
-			goto _error;
-		}
+		goto _error;
+	}
 
-		mode_child = value.val_uint32;
+	j_sql_plan_build_condition(plan, sql_condition_part, arr_types_in);
 
-		if (G_UNLIKELY(!build_query_condition_part(backend_data, batch, &child, id_sql, mode_child, arr_types_in, schema, error)))
-		{
-			goto _error;
-		}
+	if (sql_condition_part->len > 0)
+	{
+		g_string_append(id_sql, " WHERE ");
+		g_string_append(id_sql, sql_condition_part->str);
 	}
 
 	// even though the string and variables_index need to be built anyway this statement is cached because the DB server might cache some ressources as consequence (e.g., the execution plan)
@@ -919,27 +648,9 @@ _backend_query_ids(gpointer backend_data, gpointer _batch, gchar const* name, bs
 		}
 	}
 
-	if (selector)
+	if (G_UNLIKELY(!j_sql_plan_bind(backend_data, plan, id_query, selector, error)))
 	{
-		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_find(&iter, "s", error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &child, error)))
-		{
-			goto _error;
-		}
-
-		if (G_UNLIKELY(!bind_selector_query(backend_data, batch->namespace, &child, id_query, schema, error)))
-		{
-			goto _error;
-		}
+		goto _error;
 	}
 
 	while (TRUE)
@@ -987,22 +698,108 @@ _error:
 	return FALSE;
 }
 
+void
+j_sql_prepared_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSqlPrepared* prepared = data;
+
+	j_sql_plan_free(prepared->plan);
+	bson_destroy(prepared->selector);
+	g_free(prepared);
+}
+
+/**
+ * \brief Drop the thread's prepared selectors if a schema has been deleted in the meantime.
+ *
+ * \param thread_variables The thread's variables.
+ */
+static void
+j_sql_prepared_validate(JThreadVariables* thread_variables)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gint generation;
+
+	generation = g_atomic_int_get(&prepared_generation_global);
+
+	if (G_UNLIKELY(thread_variables->prepared_generation != generation))
+	{
+		g_hash_table_remove_all(thread_variables->prepared_cache);
+		g_queue_init(&thread_variables->prepared_lru);
+		thread_variables->prepared_generation = generation;
+	}
+}
+
+JSqlPrepared*
+j_sql_prepared_lookup(JThreadVariables* thread_variables, gint64 handle)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSqlPrepared* prepared;
+
+	j_sql_prepared_validate(thread_variables);
+
+	if ((prepared = g_hash_table_lookup(thread_variables->prepared_cache, &handle)) != NULL)
+	{
+		g_queue_unlink(&thread_variables->prepared_lru, &prepared->link);
+		g_queue_push_head_link(&thread_variables->prepared_lru, &prepared->link);
+	}
+
+	return prepared;
+}
+
+void
+j_sql_prepared_insert(JThreadVariables* thread_variables, JSqlPrepared* prepared)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSqlPrepared* old;
+
+	j_sql_prepared_validate(thread_variables);
+
+	if ((old = g_hash_table_lookup(thread_variables->prepared_cache, &prepared->handle)) != NULL)
+	{
+		g_queue_unlink(&thread_variables->prepared_lru, &old->link);
+		g_hash_table_remove(thread_variables->prepared_cache, &prepared->handle);
+	}
+
+	while (g_hash_table_size(thread_variables->prepared_cache) >= J_SQL_PREPARED_CACHE_MAX)
+	{
+		GList* oldest;
+
+		oldest = g_queue_pop_tail_link(&thread_variables->prepared_lru);
+		g_hash_table_remove(thread_variables->prepared_cache, &((JSqlPrepared*)oldest->data)->handle);
+	}
+
+	prepared->link.data = prepared;
+	prepared->link.prev = NULL;
+	prepared->link.next = NULL;
+
+	g_hash_table_insert(thread_variables->prepared_cache, &prepared->handle, prepared);
+	g_queue_push_head_link(&thread_variables->prepared_lru, &prepared->link);
+}
+
 gboolean
 sql_generic_query(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, gpointer* iterator, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JDBSelectorMode mode_child;
 	JSqlBatch* batch = _batch;
-	bson_iter_t iter, iter_selection;
-	JDBTypeValue value;
 	JSqlStatement* statement = NULL;
 	JThreadVariables* thread_variables = NULL;
-	gboolean where_appended = FALSE;
+	JSqlPrepared* prepared = NULL;
+	bson_t* template = NULL;
+	bson_iter_t iter;
+	gint64 handle = 0;
+	g_autoptr(JSqlPlan) plan = NULL;
 	g_autoptr(GHashTable) out_variables_index = NULL; // Maintains indices for the fields (or columns) in the query so that their respective values can be fetched from the resultant vector using the indices.
 	g_autoptr(GHashTable) variables_type = NULL; // Maintains datatypes of the fields (or columns) that are involved in the query.
 	g_autoptr(GString) sql = g_string_new("SELECT "); // Maintains query string.
+	g_autoptr(GString) sql_join_part = g_string_new(NULL); // Maintains join part of the query string.
 	g_autoptr(GString) sql_condition_part = g_string_new(NULL); // Maintains condition part of the query string. (e.g. A = ? AND B < ? OR C > ? ,...)
+	g_autoptr(GString) sql_group_part = g_string_new(NULL); // Maintains the grouping of aggregate queries.
 	g_autoptr(GArray) arr_types_in = NULL; // Maintains in-params for MYSQL.
 	g_autoptr(GArray) arr_types_out = NULL; // Maintains out-params for MYSQL.
 
@@ -1017,136 +814,69 @@ sql_generic_query(gpointer backend_data, gpointer _batch, gchar const* name, bso
 		goto _error;
 	}
 
-	out_variables_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-
-	// contains joins?
-	if (bson_has_field(selector, "t"))
+	// Prepared selectors that have already been used by this thread only need their values to be bound.
+	if (selector != NULL && bson_iter_init_find(&iter, selector, "h") && BSON_ITER_HOLDS_INT64(&iter))
 	{
-		g_autoptr(GString) sql_join_part = g_string_new(NULL); // Maintains join part of the query string.
-		g_autoptr(GString) sql_selection_part = g_string_new(NULL); // Maintains selection part of the query string. (e.g. SELECT A,B,C,... FROM X,Y,Z,...)
-
-		variables_type = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-
-		// Formulate the selection part of the query.
-		if (!build_query_selection_part(selector, backend_data, sql_selection_part, batch, out_variables_index, variables_type, arr_types_out, error))
-		{
-			goto _error;
-		}
+		handle = bson_iter_int64(&iter);
 
-		// Extend the query string.
-		g_string_append(sql, sql_selection_part->str);
-
-		// Formulate the join part of the query.
-		if (!build_query_join_part(selector, batch, sql_join_part, error))
-		{
-			goto _error;
-		}
-
-		// Extend the query string.
-		if (sql_join_part->len > 0)
+		if ((prepared = j_sql_prepared_lookup(thread_variables, handle)) != NULL)
 		{
-			g_string_append(sql, " WHERE ");
-			g_string_append(sql, sql_join_part->str);
-			where_appended = TRUE;
-		}
-	}
-	else
-	{
-		g_autoptr(GHashTable) schema = NULL;
-		GHashTableIter schema_iter;
-		JDBType type;
-		const gchar* string_tmp;
-		gpointer type_tmp, key_tmp;
-		gboolean first_field = TRUE;
-
-		if (!(schema = get_schema(backend_data, batch->namespace, name, error)))
-		{
-			goto _error;
-		}
-
-		variables_type = g_hash_table_ref(schema);
-
-		g_hash_table_iter_init(&schema_iter, schema);
-
-		while (g_hash_table_iter_next(&schema_iter, &key_tmp, &type_tmp))
-		{
-			type = GPOINTER_TO_INT(type_tmp);
-			string_tmp = key_tmp;
-
-			if (!first_field)
-			{
-				g_string_append(sql, ", ");
-			}
-
-			g_string_append(sql, string_tmp);
-
-			first_field = FALSE;
-
-			if (!g_hash_table_insert(out_variables_index, g_strdup(string_tmp), GINT_TO_POINTER(g_hash_table_size(out_variables_index))))
+			if (G_UNLIKELY(!j_sql_plan_bind(backend_data, prepared->plan, prepared->statement, selector, error)))
 			{
 				goto _error;
 			}
 
-			g_array_append_val(arr_types_out, type);
-		}
+			*iterator = prepared->statement;
 
-		g_string_append_printf(sql, " FROM %s%s_%s%s", specs->sql.quote, batch->namespace, name, specs->sql.quote);
-	}
+			return TRUE;
+		}
 
-	// Formulate the condition part of the query.
-	if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
-	{
-		goto _error;
+		// the plan refers to the selector, so it has to outlive this query
+		template = bson_new();
+		bson_copy_to_excluding_noinit(selector, template, "p", NULL);
 	}
 
-	if (!j_bson_iter_find(&iter, "s", error))
+	// Normalize the selector, choose indexes and determine the join order.
+	if (!(plan = j_sql_plan_new(backend_data, batch, name, (template != NULL) ? template : selector, error)))
 	{
 		goto _error;
 	}
 
-	if (!j_bson_iter_recurse_document(&iter, &iter_selection, error))
-	{
-		goto _error;
-	}
+	out_variables_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	variables_type = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 
-	// Fetch the operator that would be appended in between parent and child selector.
-	if (G_UNLIKELY(!j_bson_iter_find(&iter_selection, "m", error)))
+	// Formulate the selection part of the query, aggregates are computed by the DBMS.
+	if (selector != NULL && bson_has_field(selector, "a"))
 	{
-		goto _error;
+		if (!build_query_aggregate_part(plan, backend_data, selector, sql, sql_group_part, batch, out_variables_index, variables_type, arr_types_out, error))
+		{
+			goto _error;
+		}
 	}
-
-	if (G_UNLIKELY(!j_bson_iter_value(&iter_selection, J_DB_TYPE_UINT32, &value, error)))
+	else if (!build_query_selection_part(plan, backend_data, sql, batch, out_variables_index, variables_type, arr_types_out, error))
 	{
 		goto _error;
 	}
 
-	mode_child = value.val_uint32;
-
-	if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_selection, error)))
-	{
-		goto _error;
-	}
+	// Formulate the join and condition parts of the query.
+	build_query_join_part(plan, sql_join_part);
+	j_sql_plan_build_condition(plan, sql_condition_part, arr_types_in);
 
-	if (G_UNLIKELY(!build_query_condition_part(backend_data, batch, &iter_selection, sql_condition_part, mode_child, arr_types_in, variables_type, error)))
+	// Extend the query string.
+	if (sql_join_part->len > 0)
 	{
-		goto _error;
+		g_string_append(sql, " WHERE ");
+		g_string_append(sql, sql_join_part->str);
 	}
 
-	// Extend the query string.
 	if (sql_condition_part->len > 0)
 	{
-		if (where_appended)
-		{
-			g_string_append(sql, " AND ");
-		}
-		else
-		{
-			g_string_append(sql, " WHERE ");
-		}
-
+		g_string_append(sql, (sql_join_part->len > 0) ? " AND " : " WHERE ");
 		g_string_append(sql, sql_condition_part->str);
 	}
 
+	g_string_append(sql, sql_group_part->str);
+
 	statement = g_hash_table_lookup(thread_variables->query_cache, sql->str);
 
 	if (G_UNLIKELY(!statement))
@@ -1163,33 +893,65 @@ sql_generic_query(gpointer backend_data, gpointer _batch, gchar const* name, bso
 		}
 	}
 
-	if (sql_condition_part->len > 0)
+	if (G_UNLIKELY(!j_sql_plan_bind(backend_data, plan, statement, selector, error)))
 	{
-		if (!j_bson_iter_init(&iter, selector, error))
-		{
-			goto _error;
-		}
-
-		if (!j_bson_iter_find(&iter, "s", error))
-		{
-			goto _error;
-		}
+		goto _error;
+	}
 
-		if (!j_bson_iter_recurse_document(&iter, &iter_selection, error))
-		{
-			goto _error;
-		}
+	if (template != NULL)
+	{
+		prepared = g_new(JSqlPrepared, 1);
+		prepared->selector = template;
+		prepared->plan = g_steal_pointer(&plan);
+		prepared->statement = statement;
+		prepared->handle = handle;
 
-		if (G_UNLIKELY(!bind_selector_query(backend_data, batch->namespace, &iter_selection, statement, statement->variable_types, error)))
-		{
-			goto _error;
-		}
+		j_sql_prepared_insert(thread_variables, prepared);
 	}
 
 	*iterator = statement;
 
 	return TRUE;
 
+_error:
+	if (template != NULL)
+	{
+		bson_destroy(template);
+	}
+
+	return FALSE;
+}
+
+gboolean
+sql_generic_explain(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t* result, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+	JSqlBatch* batch = _batch;
+	g_autoptr(JSqlPlan) plan = NULL;
+	g_autoptr(GString) report = g_string_new(NULL);
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(result != NULL, FALSE);
+
+	if (!(plan = j_sql_plan_new(backend_data, batch, name, selector, error)))
+	{
+		goto _error;
+	}
+
+	j_sql_plan_explain(plan, report);
+
+	value.val_string = report->str;
+
+	if (G_UNLIKELY(!j_bson_append_value(result, "plan", J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
 _error:
 	return FALSE;
 }
@@ -45,7 +45,14 @@
 #define BACKEND_ID_TYPE J_DB_TYPE_UINT64
 
 /**
- * \brief The JThreadVariables struct bundles the thread-local DB connection, the query cache and the schema cache.
+ * \brief The maximum number of prepared selectors cached per thread.
+ *
+ * The least recently used prepared selector is evicted if the cache is full.
+ */
+#define J_SQL_PREPARED_CACHE_MAX 256
+
+/**
+ * \brief The JThreadVariables struct bundles the thread-local DB connection, the query cache, the schema cache and the index cache.
  */
 struct JThreadVariables
 {
@@ -70,6 +77,31 @@ struct JThreadVariables
 	 * The keys are correctly quoted and can be used as part of SQL strings.
 	 */
 	GHashTable* schema_cache;
+
+	/**
+	 * \brief Cache for index definitions.
+	 *
+	 * namespace_name(char*) -> (GPtrArray* (JSqlIndex*))
+	 * A thread local cache of the indexes declared for a schema.
+	 * It is used by the query planner to decide whether an index can serve a selector.
+	 */
+	GHashTable* index_cache;
+
+	/**
+	 * \brief Cache for prepared selectors.
+	 *
+	 * handle(gint64*) -> (JSqlPrepared*)
+	 * A thread local cache of the plans and statements of prepared selectors.
+	 * Queries using a known handle only bind the new values, planning and generating the SQL string is skipped.
+	 * It holds at most J_SQL_PREPARED_CACHE_MAX entries.
+	 */
+	GHashTable* prepared_cache;
+
+	/// The prepared selectors ordered by their last use, the most recently used one first.
+	GQueue prepared_lru;
+
+	/// The value of prepared_generation_global the prepared cache is valid for.
+	gint prepared_generation;
 };
 
 typedef struct JThreadVariables JThreadVariables;
@@ -126,6 +158,118 @@ struct JSqlStatement
 
 typedef struct JSqlStatement JSqlStatement;
 
+/**
+ * \brief An index as declared by j_db_schema_add_index.
+ */
+struct JSqlIndex
+{
+	/// The name of the index in the DB backend (without quotes).
+	gchar* name;
+
+	/// The full names of the indexed fields in index order (gchar*).
+	GPtrArray* fields;
+
+	/// The names of the indexed fields as used in the schema (gchar*).
+	GPtrArray* names;
+};
+
+typedef struct JSqlIndex JSqlIndex;
+
+/**
+ * \brief A node of a normalized selector.
+ *
+ * The struct is private to the planner.
+ */
+typedef struct JSqlPlanNode JSqlPlanNode;
+
+/**
+ * \brief Describes how a single table of a query is accessed.
+ */
+struct JSqlPlanAccess
+{
+	/// The schema name of the table.
+	gchar const* table;
+
+	/// The indexes available for the table (JSqlIndex*).
+	GPtrArray* indexes;
+
+	/// The index that can serve the selector or NULL if the table has to be scanned.
+	JSqlIndex* index;
+
+	/// The number of leading index fields restricted by equality predicates.
+	guint index_eq;
+
+	/// TRUE if the index field following the equality predicates is restricted by a range predicate.
+	gboolean index_range;
+};
+
+typedef struct JSqlPlanAccess JSqlPlanAccess;
+
+/**
+ * \brief A join condition between two tables.
+ */
+struct JSqlPlanJoin
+{
+	gchar const* table[2];
+	gchar const* field[2];
+};
+
+typedef struct JSqlPlanJoin JSqlPlanJoin;
+
+/**
+ * \brief The result of planning a selector.
+ *
+ * A plan is built for every query and used to generate and bind the SQL statement.
+ * Normalized selectors lead to identical SQL strings for equivalent selectors, which improves the hit rate of the statement cache.
+ */
+struct JSqlPlan
+{
+	/// The namespace of the query.
+	gchar const* namespace;
+
+	/// The normalized selection. NULL if there is no condition.
+	JSqlPlanNode* root;
+
+	/// The accessed tables in join order (JSqlPlanAccess*).
+	GPtrArray* tables;
+
+	/// The join conditions (JSqlPlanJoin*).
+	GPtrArray* joins;
+
+	/// The number of predicates removed by merging ranges.
+	guint merged;
+
+	/// The number of duplicate predicates removed.
+	guint duplicates;
+};
+
+typedef struct JSqlPlan JSqlPlan;
+
+/**
+ * \brief A prepared selector.
+ *
+ * The plan of a prepared selector does not depend on the bound values, so it can be reused together with its statement.
+ */
+struct JSqlPrepared
+{
+	/// The template the plan refers to.
+	bson_t* selector;
+
+	/// The plan of the template. It is only used for binding.
+	JSqlPlan* plan;
+
+	/// The statement. It is owned by the query cache.
+	JSqlStatement* statement;
+
+	/// The handle of the template, it is also the key in the prepared cache.
+	gint64 handle;
+
+	/// The position in the prepared selectors' LRU list.
+	GList link;
+};
+
+typedef struct JSqlPrepared JSqlPrepared;
+
 // common
 
 /// Holds a thread-private pointer to JThreadVariables.
@@ -134,6 +278,14 @@ extern GPrivate thread_variables_global;
 /// Contains the specific string constants and functions for a DB backend.
 extern JSQLSpecifics* specs;
 
+/**
+ * \brief The generation of all prepared caches.
+ *
+ * Deleting a schema increments the generation, causing all threads to drop their prepared selectors before their next use.
+ * Prepared selectors do not record the schemas they refer to.
+ */
+extern gint prepared_generation_global;
+
 /// Starting a batch requires locking if the DB backend does not support concurrent accesses.
 G_LOCK_EXTERN(sql_backend_lock);
 
@@ -222,48 +374,117 @@ gboolean _backend_schema_get(gpointer backend_data, gchar const* namespace, gcha
 GHashTable* get_schema(gpointer backend_data, gchar const* namespace, gchar const* name, GError** error);
 
 /**
- * \brief Build the WHERE part of a SELECT statement from a selector.
+ * \brief Query the IDs of rows that match a selector.
+ *
+ * It is is used in the update and delete functions.
+ *
+ * \todo Update and delete could be done by adding the selection part to the respective query, making this function unnecessary.
  *
  * \param backend_data The backend-specific information to open a connection.
- * \param iter An initialized iterator over the relevant part of the selector bson document.
- * \param batch The batch of the operation.
- * \param[in,out] sql A GString to which the WHERE part of the query should be appended.
- * \param mode The mode of the selector (i.e., AND or OR).
- * \param arr_types_in An allocated GArray to which the found types will be appended.
- * \param schema The database schema in hash table format. \todo need to change this one for joins
+ * \param _batch A JSqlBatch object.
+ * \param name The schema name.
+ * \param selector A bson selector document sent by the client.
+ * \param[out] matches A GArray of the matched IDs.
  * \param[out] error An uninitialized GError* for error code passing.
  * \return gboolean TRUE on success, FALSE otherwise.
  */
-gboolean build_query_condition_part(gpointer backend_data, JSqlBatch* batch, bson_iter_t* iter, GString* sql, JDBSelectorMode mode, GArray* arr_types_in, GHashTable* schema, GError** error);
+gboolean _backend_query_ids(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, GArray** matches, GError** error);
+
+// Plan
+
+/**
+ * \brief Get the indexes declared for a schema.
+ *
+ * Uses a transparent cache for index definitions.
+ *
+ * \param backend_data The backend-specific information to open a connection if needed.
+ * \param namespace The namespace of the schema.
+ * \param name The schema name.
+ * \param[out] error An uninitialized GError* for error code passing.
+ * \return GPtrArray* An array of JSqlIndex on success or NULL otherwise. The array should be freed using g_ptr_array_unref (or by using g_autoptr).
+ */
+GPtrArray* get_indexes(gpointer backend_data, gchar const* namespace, gchar const* name, GError** error);
 
 /**
- * \brief Bind the variables in the WHERE part of a SELECT statement.
+ * \brief Plan a query.
+ *
+ * The selector is normalized (nested groups are flattened, redundant range predicates are merged, contradictions are detected and predicates are reordered).
+ * Afterwards, an index is chosen for every table and the join order is determined.
  *
  * \param backend_data The backend-specific information to open a connection.
- * \param iter An initialized iterator over the relevant part of the selector bson document. Should be retrieved the same way as for build_selector_query to ensure the same order of variables!
- * \param statement A JSqlStatement which
- * \param schema The database schema in hash table format. \todo need to change this one for joins
+ * \param batch The batch of the operation.
+ * \param name The schema name. Only used if the selector does not contain a list of tables.
+ * \param selector A bson selector document sent by the client. May be NULL.
  * \param[out] error An uninitialized GError* for error code passing.
- * \return gboolean TRUE on success, FALSE otherwise.
+ * \return JSqlPlan* The plan or NULL on error. The plan references the selector, which must stay valid.
  */
-gboolean bind_selector_query(gpointer backend_data, const gchar* namespace, bson_iter_t* iter, JSqlStatement* statement, GHashTable* schema, GError** error);
+JSqlPlan* j_sql_plan_new(gpointer backend_data, JSqlBatch* batch, gchar const* name, bson_t const* selector, GError** error);
 
 /**
- * \brief Query the IDs of rows that match a selector.
+ * \brief Free a plan.
  *
- * It is is used in the update and delete functions.
+ * \param plan The plan.
+ */
+void j_sql_plan_free(JSqlPlan* plan);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(JSqlPlan, j_sql_plan_free)
+
+/**
+ * \brief Build the condition part of a statement from a plan.
  *
- * \todo Update and delete could be done by adding the selection part to the respective query, making this function unnecessary.
+ * \param plan The plan.
+ * \param[in,out] sql A GString to which the condition should be appended. Nothing is appended if the plan does not contain a condition.
+ * \param arr_types_in An allocated GArray to which the types of the variables will be appended.
+ */
+void j_sql_plan_build_condition(JSqlPlan* plan, GString* sql, GArray* arr_types_in);
+
+/**
+ * \brief Bind the variables of the condition part of a statement.
+ *
+ * Parameters of prepared selectors are bound to the values contained in the selector.
  *
  * \param backend_data The backend-specific information to open a connection.
- * \param _batch A JSqlBatch object.
- * \param name The schema name.
- * \param selector A bson selector document sent by the client.
- * \param[out] matches A GArray of the matched IDs.
+ * \param plan The plan that was used to build the statement.
+ * \param statement The statement.
+ * \param selector The selector providing the values of the parameters. May be NULL if the plan does not contain parameters.
  * \param[out] error An uninitialized GError* for error code passing.
  * \return gboolean TRUE on success, FALSE otherwise.
  */
-gboolean _backend_query_ids(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, GArray** matches, GError** error);
+gboolean j_sql_plan_bind(gpointer backend_data, JSqlPlan* plan, JSqlStatement* statement, bson_t const* selector, GError** error);
+
+/**
+ * \brief Free a prepared selector.
+ *
+ * \param data The prepared selector (JSqlPrepared*).
+ */
+void j_sql_prepared_free(gpointer data);
+
+/**
+ * \brief Look up a prepared selector in the thread's prepared cache.
+ *
+ * \param thread_variables The thread's variables.
+ * \param handle The handle of the template.
+ * \return The prepared selector or NULL if it is not cached.
+ */
+JSqlPrepared* j_sql_prepared_lookup(JThreadVariables* thread_variables, gint64 handle);
+
+/**
+ * \brief Add a prepared selector to the thread's prepared cache.
+ *
+ * The least recently used prepared selector is evicted if the cache is full.
+ *
+ * \param thread_variables The thread's variables.
+ * \param prepared The prepared selector, ownership is transferred.
+ */
+void j_sql_prepared_insert(JThreadVariables* thread_variables, JSqlPrepared* prepared);
+
+/**
+ * \brief Describe a plan in human-readable form.
+ *
+ * \param plan The plan.
+ * \param[in,out] report A GString to which the description will be appended.
+ */
+void j_sql_plan_explain(JSqlPlan* plan, GString* report);
 
 // TCL
 
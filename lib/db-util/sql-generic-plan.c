@@ -0,0 +1,1594 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <math.h>
+#include <string.h>
+
+#include "sql-generic-internal.h"
+
+/**
+ * \file
+ *
+ * A small rule-based planner for selectors.
+ *
+ * The planner does not replace the optimizer of the DB backend.
+ * It removes redundancies the client may have introduced, detects selectors that can never match and determines which of the declared indexes can serve a selector.
+ * The result is used to generate the SQL statement and to answer EXPLAIN requests.
+ */
+
+struct JSqlPlanNode
+{
+	/// TRUE if the node is a group (i.e., a (sub) selector), FALSE if it is a predicate.
+	gboolean group;
+
+	/// The mode of a group.
+	JDBSelectorMode mode;
+
+	/// TRUE if the group can never match.
+	gboolean unsatisfiable;
+
+	/// The children of a group (JSqlPlanNode*). A satisfiable group without children always matches.
+	GPtrArray* children;
+
+	/// The schema name of a predicate. Points into the selector.
+	gchar const* table;
+
+	/// The quoted full field name of a predicate.
+	gchar* full_name;
+
+	JDBSelectorOperator op;
+	JDBType type;
+
+	/// The value of a predicate. Strings and blobs point into the selector.
+	JDBTypeValue value;
+
+	/// The parameter of a prepared selector that provides the value or -1 if the value is given directly.
+	gint64 parameter;
+
+	/// The index serving the predicate or NULL.
+	JSqlIndex* index;
+};
+
+static void
+j_sql_index_free(gpointer data)
+{
+	JSqlIndex* index = data;
+
+	g_free(index->name);
+	g_ptr_array_unref(index->fields);
+	g_ptr_array_unref(index->names);
+	g_free(index);
+}
+
+static JSqlIndex*
+j_sql_index_new(gchar* name)
+{
+	JSqlIndex* index;
+
+	index = g_new(JSqlIndex, 1);
+	index->name = name;
+	index->fields = g_ptr_array_new_with_free_func(g_free);
+	index->names = g_ptr_array_new_with_free_func(g_free);
+
+	return index;
+}
+
+static void
+j_sql_plan_node_free(gpointer data)
+{
+	JSqlPlanNode* node = data;
+
+	if (node->children != NULL)
+	{
+		g_ptr_array_unref(node->children);
+	}
+
+	g_free(node->full_name);
+	g_free(node);
+}
+
+static JSqlPlanNode*
+j_sql_plan_node_new_group(JDBSelectorMode mode)
+{
+	JSqlPlanNode* node;
+
+	node = g_new0(JSqlPlanNode, 1);
+	node->group = TRUE;
+	node->mode = mode;
+	node->children = g_ptr_array_new_with_free_func(j_sql_plan_node_free);
+
+	return node;
+}
+
+static void
+j_sql_plan_access_free(gpointer data)
+{
+	JSqlPlanAccess* access = data;
+
+	if (access->indexes != NULL)
+	{
+		g_ptr_array_unref(access->indexes);
+	}
+
+	g_free(access);
+}
+
+GPtrArray*
+get_indexes(gpointer backend_data, gchar const* namespace, gchar const* name, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+	JThreadVariables* thread_variables = NULL;
+	JSqlStatement* index_query = NULL;
+	GPtrArray* indexes = NULL;
+	JSqlIndex* index = NULL;
+	gint64 current = -1;
+	const gchar* index_query_sql = "SELECT idx, varname FROM schema_index WHERE namespace=? AND name=? ORDER BY idx, position";
+	g_autoptr(GString) cache_key = g_string_new(namespace);
+
+	g_string_append(cache_key, "_");
+	g_string_append(cache_key, name);
+
+	if (G_UNLIKELY(!(thread_variables = thread_variables_get(backend_data, error))))
+	{
+		goto _error;
+	}
+
+	indexes = g_hash_table_lookup(thread_variables->index_cache, cache_key->str);
+
+	if (indexes != NULL)
+	{
+		return g_ptr_array_ref(indexes);
+	}
+
+	index_query = g_hash_table_lookup(thread_variables->query_cache, index_query_sql);
+
+	if (G_UNLIKELY(!index_query))
+	{
+		JDBType type;
+
+		g_autoptr(GArray) arr_types_in = NULL;
+		g_autoptr(GArray) arr_types_out = NULL;
+		arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+		arr_types_out = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+		type = J_DB_TYPE_UINT32;
+		g_array_append_val(arr_types_out, type);
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_out, type);
+
+		if (!(index_query = j_sql_statement_new(index_query_sql, arr_types_in, arr_types_out, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(index_query_sql), index_query))
+		{
+			// in all other error cases index_query is already owned by the hash table
+			j_sql_statement_free(index_query);
+			index_query = NULL;
+			goto _error;
+		}
+	}
+
+	value.val_string = namespace;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, index_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = name;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, index_query->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	indexes = g_ptr_array_new_with_free_func(j_sql_index_free);
+
+	// the primary key is always indexed
+	index = j_sql_index_new(g_strdup("PRIMARY KEY"));
+	g_ptr_array_add(index->fields, g_string_free(j_sql_get_full_field_name(namespace, name, "_id"), FALSE));
+	g_ptr_array_add(index->names, g_strdup("_id"));
+	g_ptr_array_add(indexes, index);
+
+	while (TRUE)
+	{
+		gboolean sql_found;
+		guint32 idx;
+
+		if (G_UNLIKELY(!specs->func.statement_step(thread_variables->db_connection, index_query->stmt, &sql_found, error)))
+		{
+			goto _error;
+		}
+
+		if (!sql_found)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY(!specs->func.statement_column(thread_variables->db_connection, index_query->stmt, 0, J_DB_TYPE_UINT32, &value, error)))
+		{
+			goto _error;
+		}
+
+		idx = value.val_uint32;
+
+		if (G_UNLIKELY(!specs->func.statement_column(thread_variables->db_connection, index_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		if (current != idx)
+		{
+			// this has to match the index names used in sql_generic_schema_create
+			index = j_sql_index_new(g_strdup_printf("%s_%s_%u", namespace, name, idx));
+			g_ptr_array_add(indexes, index);
+			current = idx;
+		}
+
+		g_ptr_array_add(index->fields, g_string_free(j_sql_get_full_field_name(namespace, name, value.val_string), FALSE));
+		g_ptr_array_add(index->names, g_strdup(value.val_string));
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_reset(thread_variables->db_connection, index_query->stmt, error)))
+	{
+		index_query = NULL;
+		goto _error;
+	}
+
+	g_hash_table_insert(thread_variables->index_cache, g_strdup(cache_key->str), g_ptr_array_ref(indexes));
+
+	return indexes;
+
+_error:
+	if (index_query != NULL)
+	{
+		specs->func.statement_reset(thread_variables->db_connection, index_query->stmt, NULL);
+	}
+
+	if (indexes != NULL)
+	{
+		g_ptr_array_unref(indexes);
+	}
+
+	return NULL;
+}
+
+static gboolean
+j_sql_plan_type_is_numeric(JDBType type)
+{
+	return type == J_DB_TYPE_SINT32 || type == J_DB_TYPE_UINT32 || type == J_DB_TYPE_FLOAT32
+	       || type == J_DB_TYPE_SINT64 || type == J_DB_TYPE_UINT64 || type == J_DB_TYPE_FLOAT64
+	       || type == J_DB_TYPE_ID;
+}
+
+static gboolean
+j_sql_plan_op_is_range(JDBSelectorOperator op)
+{
+	return op == J_DB_SELECTOR_OPERATOR_LT || op == J_DB_SELECTOR_OPERATOR_LE
+	       || op == J_DB_SELECTOR_OPERATOR_GT || op == J_DB_SELECTOR_OPERATOR_GE;
+}
+
+static gint
+j_sql_plan_compare_value(JDBType type, JDBTypeValue const* a, JDBTypeValue const* b)
+{
+	gint ret = 0;
+
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			ret = (a->val_sint32 > b->val_sint32) - (a->val_sint32 < b->val_sint32);
+			break;
+		case J_DB_TYPE_UINT32:
+			ret = (a->val_uint32 > b->val_uint32) - (a->val_uint32 < b->val_uint32);
+			break;
+		case J_DB_TYPE_FLOAT32:
+			ret = (a->val_float32 > b->val_float32) - (a->val_float32 < b->val_float32);
+			break;
+		case J_DB_TYPE_SINT64:
+			ret = (a->val_sint64 > b->val_sint64) - (a->val_sint64 < b->val_sint64);
+			break;
+		case J_DB_TYPE_ID:
+		case J_DB_TYPE_UINT64:
+			ret = (a->val_uint64 > b->val_uint64) - (a->val_uint64 < b->val_uint64);
+			break;
+		case J_DB_TYPE_FLOAT64:
+			ret = (a->val_float64 > b->val_float64) - (a->val_float64 < b->val_float64);
+			break;
+		case J_DB_TYPE_STRING:
+			ret = g_strcmp0(a->val_string, b->val_string);
+			break;
+		case J_DB_TYPE_BLOB:
+			if (a->val_blob_length != b->val_blob_length)
+			{
+				ret = (a->val_blob_length > b->val_blob_length) ? 1 : -1;
+			}
+			else
+			{
+				ret = memcmp(a->val_blob, b->val_blob, a->val_blob_length);
+			}
+			break;
+		default:
+			g_warn_if_reached();
+	}
+
+	return ret;
+}
+
+/**
+ * Returns whether a predicate takes part in range merging.
+ *
+ * Strings are excluded because their order depends on the collation of the DB backend.
+ */
+static gboolean
+j_sql_plan_node_is_mergeable(JSqlPlanNode const* node)
+{
+	if (node->group || !j_sql_plan_type_is_numeric(node->type))
+	{
+		return FALSE;
+	}
+
+	// the value of a parameter is only known when binding
+	if (node->parameter >= 0)
+	{
+		return FALSE;
+	}
+
+	if (node->op != J_DB_SELECTOR_OPERATOR_EQ && !j_sql_plan_op_is_range(node->op))
+	{
+		return FALSE;
+	}
+
+	if (node->type == J_DB_TYPE_FLOAT32 && isnan(node->value.val_float32))
+	{
+		return FALSE;
+	}
+
+	if (node->type == J_DB_TYPE_FLOAT64 && isnan(node->value.val_float64))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+j_sql_plan_node_equal(JSqlPlanNode const* a, JSqlPlanNode const* b)
+{
+	if (a->group || b->group)
+	{
+		return FALSE;
+	}
+
+	return a->op == b->op && a->type == b->type && a->parameter == b->parameter && g_str_equal(a->full_name, b->full_name) && j_sql_plan_compare_value(a->type, &a->value, &b->value) == 0;
+}
+
+static gboolean
+j_sql_plan_parse(JSqlPlan* plan, gpointer backend_data, bson_iter_t* iter, JSqlPlanNode* group, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+
+	while (TRUE)
+	{
+		gboolean has_next;
+		bson_iter_t iterchild;
+		gchar const* key;
+
+		if (G_UNLIKELY(!j_bson_iter_next(iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		key = j_bson_iter_key(iter, error);
+
+		if (G_UNLIKELY(key == NULL))
+		{
+			goto _error;
+		}
+
+		if (g_str_equal(key, "m"))
+		{
+			if (G_UNLIKELY(!j_bson_iter_value(iter, J_DB_TYPE_UINT32, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(value.val_uint32 != J_DB_SELECTOR_MODE_AND && value.val_uint32 != J_DB_SELECTOR_MODE_OR))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_OPERATOR_INVALID, "operator invalid");
+				goto _error;
+			}
+
+			group->mode = value.val_uint32;
+		}
+		else if (g_str_equal(key, "_s"))
+		{
+			JSqlPlanNode* child;
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			{
+				goto _error;
+			}
+
+			child = j_sql_plan_node_new_group(J_DB_SELECTOR_MODE_AND);
+			g_ptr_array_add(group->children, child);
+
+			if (G_UNLIKELY(!j_sql_plan_parse(plan, backend_data, &iterchild, child, error)))
+			{
+				goto _error;
+			}
+		}
+		else
+		{
+			JSqlPlanNode* leaf;
+			GString* full_name;
+			gpointer type;
+			g_autoptr(GHashTable) schema = NULL;
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			{
+				goto _error;
+			}
+
+			leaf = g_new0(JSqlPlanNode, 1);
+			leaf->parameter = -1;
+			g_ptr_array_add(group->children, leaf);
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iterchild, "t", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			leaf->table = value.val_string;
+			full_name = j_sql_get_full_field_name(plan->namespace, leaf->table, key);
+			leaf->full_name = g_string_free(full_name, FALSE);
+
+			if (G_UNLIKELY(!(schema = get_schema(backend_data, plan->namespace, leaf->table, error))))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!g_hash_table_lookup_extended(schema, leaf->full_name, NULL, &type)))
+			{
+				g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_VARIABLE_NOT_FOUND, "variable %s not found", leaf->full_name);
+				goto _error;
+			}
+
+			leaf->type = GPOINTER_TO_INT(type);
+
+			// do not rely on the order of the keys
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iterchild, "o", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, J_DB_TYPE_UINT32, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(value.val_uint32 > J_DB_SELECTOR_OPERATOR_NE))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_COMPARATOR_INVALID, "comparator invalid");
+				goto _error;
+			}
+
+			leaf->op = value.val_uint32;
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			{
+				goto _error;
+			}
+
+			// prepared selectors refer to a parameter instead of containing the value
+			if (bson_iter_find(&iterchild, "p"))
+			{
+				if (G_UNLIKELY(!j_bson_iter_value(&iterchild, J_DB_TYPE_UINT32, &value, error)))
+				{
+					goto _error;
+				}
+
+				leaf->parameter = value.val_uint32;
+				continue;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(iter, &iterchild, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iterchild, "v", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iterchild, leaf->type, &leaf->value, error)))
+			{
+				goto _error;
+			}
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Merges the numeric predicates of an AND group that restrict the same field.
+ *
+ * Only the tightest bounds are kept.
+ * If the bounds contradict each other, the group is marked as unsatisfiable.
+ */
+static void
+j_sql_plan_merge_ranges(JSqlPlan* plan, JSqlPlanNode* group)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GPtrArray* children;
+	g_autoptr(GHashTable) done = NULL;
+	g_autoptr(GHashTable) drop = NULL;
+
+	done = g_hash_table_new(g_str_hash, g_str_equal);
+	drop = g_hash_table_new(NULL, NULL);
+
+	for (guint i = 0; i < group->children->len; i++)
+	{
+		JSqlPlanNode* node = g_ptr_array_index(group->children, i);
+		JSqlPlanNode* eq = NULL;
+		JSqlPlanNode* lower = NULL;
+		JSqlPlanNode* upper = NULL;
+		guint count = 0;
+		gint c;
+
+		if (!j_sql_plan_node_is_mergeable(node) || g_hash_table_contains(done, node->full_name))
+		{
+			continue;
+		}
+
+		g_hash_table_add(done, node->full_name);
+
+		for (guint j = i; j < group->children->len; j++)
+		{
+			JSqlPlanNode* other = g_ptr_array_index(group->children, j);
+
+			if (!j_sql_plan_node_is_mergeable(other) || !g_str_equal(other->full_name, node->full_name))
+			{
+				continue;
+			}
+
+			count++;
+
+			if (other->op == J_DB_SELECTOR_OPERATOR_EQ)
+			{
+				if (eq != NULL && j_sql_plan_compare_value(eq->type, &eq->value, &other->value) != 0)
+				{
+					group->unsatisfiable = TRUE;
+					return;
+				}
+
+				eq = other;
+			}
+			else if (other->op == J_DB_SELECTOR_OPERATOR_GT || other->op == J_DB_SELECTOR_OPERATOR_GE)
+			{
+				c = (lower == NULL) ? 1 : j_sql_plan_compare_value(other->type, &other->value, &lower->value);
+
+				if (c > 0 || (c == 0 && other->op == J_DB_SELECTOR_OPERATOR_GT))
+				{
+					lower = other;
+				}
+			}
+			else
+			{
+				c = (upper == NULL) ? -1 : j_sql_plan_compare_value(other->type, &other->value, &upper->value);
+
+				if (c < 0 || (c == 0 && other->op == J_DB_SELECTOR_OPERATOR_LT))
+				{
+					upper = other;
+				}
+			}
+		}
+
+		if (count < 2)
+		{
+			continue;
+		}
+
+		if (eq != NULL)
+		{
+			if (lower != NULL)
+			{
+				c = j_sql_plan_compare_value(eq->type, &eq->value, &lower->value);
+
+				if (c < 0 || (c == 0 && lower->op == J_DB_SELECTOR_OPERATOR_GT))
+				{
+					group->unsatisfiable = TRUE;
+					return;
+				}
+			}
+
+			if (upper != NULL)
+			{
+				c = j_sql_plan_compare_value(eq->type, &eq->value, &upper->value);
+
+				if (c > 0 || (c == 0 && upper->op == J_DB_SELECTOR_OPERATOR_LT))
+				{
+					group->unsatisfiable = TRUE;
+					return;
+				}
+			}
+
+			lower = NULL;
+			upper = NULL;
+		}
+		else if (lower != NULL && upper != NULL)
+		{
+			c = j_sql_plan_compare_value(lower->type, &lower->value, &upper->value);
+
+			if (c > 0 || (c == 0 && (lower->op == J_DB_SELECTOR_OPERATOR_GT || upper->op == J_DB_SELECTOR_OPERATOR_LT)))
+			{
+				group->unsatisfiable = TRUE;
+				return;
+			}
+
+			if (c == 0)
+			{
+				// x >= a AND x <= a
+				lower->op = J_DB_SELECTOR_OPERATOR_EQ;
+				eq = lower;
+				lower = NULL;
+				upper = NULL;
+			}
+		}
+
+		for (guint j = i; j < group->children->len; j++)
+		{
+			JSqlPlanNode* other = g_ptr_array_index(group->children, j);
+
+			if (!j_sql_plan_node_is_mergeable(other) || !g_str_equal(other->full_name, node->full_name))
+			{
+				continue;
+			}
+
+			if (other != eq && other != lower && other != upper)
+			{
+				g_hash_table_add(drop, other);
+				plan->merged++;
+			}
+		}
+	}
+
+	if (g_hash_table_size(drop) == 0)
+	{
+		return;
+	}
+
+	children = g_ptr_array_new_with_free_func(j_sql_plan_node_free);
+
+	for (guint i = 0; i < group->children->len; i++)
+	{
+		JSqlPlanNode* node = g_ptr_array_index(group->children, i);
+
+		if (g_hash_table_contains(drop, node))
+		{
+			j_sql_plan_node_free(node);
+		}
+		else
+		{
+			g_ptr_array_add(children, node);
+		}
+	}
+
+	g_ptr_array_set_free_func(group->children, NULL);
+	g_ptr_array_unref(group->children);
+	group->children = children;
+}
+
+/**
+ * Normalizes a group.
+ *
+ * Groups with a single child are replaced by the child, groups with the same mode as their parent are flattened,
+ * duplicate predicates are removed and constant groups are folded.
+ */
+static void
+j_sql_plan_normalize(JSqlPlan* plan, JSqlPlanNode* group)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GPtrArray* children = group->children;
+	gboolean always = FALSE;
+	guint dropped = 0;
+
+	g_ptr_array_set_free_func(children, NULL);
+	group->children = g_ptr_array_new_with_free_func(j_sql_plan_node_free);
+
+	for (guint i = 0; i < children->len; i++)
+	{
+		JSqlPlanNode* child = g_ptr_array_index(children, i);
+
+		if (child->group)
+		{
+			j_sql_plan_normalize(plan, child);
+
+			while (child->group && !child->unsatisfiable && child->children->len == 1)
+			{
+				JSqlPlanNode* grandchild;
+
+				grandchild = g_ptr_array_steal_index(child->children, 0);
+				j_sql_plan_node_free(child);
+				child = grandchild;
+			}
+		}
+
+		if (child->group && child->unsatisfiable)
+		{
+			if (group->mode == J_DB_SELECTOR_MODE_AND)
+			{
+				group->unsatisfiable = TRUE;
+			}
+
+			dropped++;
+			j_sql_plan_node_free(child);
+		}
+		else if (child->group && child->children->len == 0)
+		{
+			// an empty group always matches
+			if (group->mode == J_DB_SELECTOR_MODE_OR)
+			{
+				always = TRUE;
+			}
+
+			j_sql_plan_node_free(child);
+		}
+		else if (child->group && child->mode == group->mode)
+		{
+			for (guint j = 0; j < child->children->len; j++)
+			{
+				g_ptr_array_add(group->children, g_ptr_array_index(child->children, j));
+			}
+
+			g_ptr_array_set_free_func(child->children, NULL);
+			j_sql_plan_node_free(child);
+		}
+		else
+		{
+			g_ptr_array_add(group->children, child);
+		}
+	}
+
+	g_ptr_array_unref(children);
+
+	for (guint i = 0; i < group->children->len;)
+	{
+		JSqlPlanNode* child = g_ptr_array_index(group->children, i);
+		gboolean duplicate = FALSE;
+
+		for (guint j = 0; j < i && !duplicate; j++)
+		{
+			duplicate = j_sql_plan_node_equal(g_ptr_array_index(group->children, j), child);
+		}
+
+		if (duplicate)
+		{
+			g_ptr_array_remove_index(group->children, i);
+			plan->duplicates++;
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	if (group->mode == J_DB_SELECTOR_MODE_AND && !group->unsatisfiable)
+	{
+		j_sql_plan_merge_ranges(plan, group);
+	}
+	else if (group->mode == J_DB_SELECTOR_MODE_OR && !always && dropped > 0 && group->children->len == 0)
+	{
+		// all alternatives can never match
+		group->unsatisfiable = TRUE;
+	}
+
+	if (group->unsatisfiable || always)
+	{
+		g_ptr_array_set_size(group->children, 0);
+	}
+}
+
+/**
+ * Chooses the index that restricts most fields of a table.
+ *
+ * Only the top-level conjunction of the selector is considered.
+ * An index can be used for a prefix of its fields that are compared for equality, optionally followed by one field restricted by a range.
+ */
+static void
+j_sql_plan_choose_index(JSqlPlan* plan, JSqlPlanAccess* access)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint best_score = 0;
+
+	if (plan->root == NULL || plan->root->unsatisfiable || plan->root->mode != J_DB_SELECTOR_MODE_AND)
+	{
+		return;
+	}
+
+	for (guint i = 0; i < access->indexes->len; i++)
+	{
+		JSqlIndex* index = g_ptr_array_index(access->indexes, i);
+		guint eq = 0;
+		gboolean range = FALSE;
+		guint score;
+
+		for (guint k = 0; k < index->fields->len; k++)
+		{
+			gchar const* field = g_ptr_array_index(index->fields, k);
+			gboolean found_eq = FALSE;
+			gboolean found_range = FALSE;
+
+			for (guint j = 0; j < plan->root->children->len; j++)
+			{
+				JSqlPlanNode* node = g_ptr_array_index(plan->root->children, j);
+
+				if (node->group || !g_str_equal(node->full_name, field))
+				{
+					continue;
+				}
+
+				if (node->op == J_DB_SELECTOR_OPERATOR_EQ)
+				{
+					found_eq = TRUE;
+				}
+				else if (j_sql_plan_op_is_range(node->op))
+				{
+					found_range = TRUE;
+				}
+			}
+
+			if (found_eq)
+			{
+				eq++;
+				continue;
+			}
+
+			range = found_range;
+			break;
+		}
+
+		score = 2 * eq + (range ? 1 : 0);
+
+		if (score > best_score)
+		{
+			best_score = score;
+			access->index = index;
+			access->index_eq = eq;
+			access->index_range = range;
+		}
+	}
+
+	if (access->index == NULL)
+	{
+		return;
+	}
+
+	for (guint j = 0; j < plan->root->children->len; j++)
+	{
+		JSqlPlanNode* node = g_ptr_array_index(plan->root->children, j);
+
+		if (node->group)
+		{
+			continue;
+		}
+
+		for (guint k = 0; k < access->index_eq; k++)
+		{
+			if (node->op == J_DB_SELECTOR_OPERATOR_EQ && g_str_equal(node->full_name, g_ptr_array_index(access->index->fields, k)))
+			{
+				node->index = access->index;
+			}
+		}
+
+		if (access->index_range && j_sql_plan_op_is_range(node->op) && g_str_equal(node->full_name, g_ptr_array_index(access->index->fields, access->index_eq)))
+		{
+			node->index = access->index;
+		}
+	}
+}
+
+static guint
+j_sql_plan_access_score(JSqlPlanAccess const* access)
+{
+	return 2 * access->index_eq + (access->index_range ? 1 : 0);
+}
+
+static gboolean
+j_sql_plan_table_chosen(JSqlPlan* plan, gchar const* table)
+{
+	for (guint i = 0; i < plan->tables->len; i++)
+	{
+		JSqlPlanAccess* access = g_ptr_array_index(plan->tables, i);
+
+		if (g_str_equal(access->table, table))
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static gint
+j_sql_plan_access_compare(gconstpointer a, gconstpointer b)
+{
+	JSqlPlanAccess const* x = *(JSqlPlanAccess const* const*)a;
+	JSqlPlanAccess const* y = *(JSqlPlanAccess const* const*)b;
+
+	return g_strcmp0(x->table, y->table);
+}
+
+/**
+ * Determines the join order greedily.
+ *
+ * The most selective table is accessed first.
+ * Afterwards, tables that are joined with the already chosen tables are preferred,
+ * especially if the join field is the first field of one of their indexes.
+ */
+static void
+j_sql_plan_order_tables(JSqlPlan* plan)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GPtrArray* remaining = plan->tables;
+
+	plan->tables = g_ptr_array_new_with_free_func(j_sql_plan_access_free);
+	g_ptr_array_set_free_func(remaining, NULL);
+
+	// sort by name to make the order deterministic
+	g_ptr_array_sort(remaining, j_sql_plan_access_compare);
+
+	while (remaining->len > 0)
+	{
+		guint best = 0;
+		gint best_score = -1;
+		gboolean best_connected = FALSE;
+
+		for (guint i = 0; i < remaining->len; i++)
+		{
+			JSqlPlanAccess* access = g_ptr_array_index(remaining, i);
+			gboolean connected = FALSE;
+			gint score = j_sql_plan_access_score(access);
+
+			for (guint j = 0; j < plan->joins->len; j++)
+			{
+				JSqlPlanJoin* join = g_ptr_array_index(plan->joins, j);
+
+				for (guint side = 0; side < 2; side++)
+				{
+					if (!g_str_equal(join->table[side], access->table) || !j_sql_plan_table_chosen(plan, join->table[1 - side]))
+					{
+						continue;
+					}
+
+					connected = TRUE;
+
+					for (guint k = 0; k < access->indexes->len; k++)
+					{
+						JSqlIndex* index = g_ptr_array_index(access->indexes, k);
+
+						if (g_str_equal(g_ptr_array_index(index->names, 0), join->field[side]))
+						{
+							score++;
+							break;
+						}
+					}
+				}
+			}
+
+			if ((connected && !best_connected) || (connected == best_connected && score > best_score))
+			{
+				best = i;
+				best_score = score;
+				best_connected = connected;
+			}
+		}
+
+		g_ptr_array_add(plan->tables, g_ptr_array_remove_index(remaining, best));
+	}
+
+	g_ptr_array_unref(remaining);
+}
+
+static gint
+j_sql_plan_node_rank(JSqlPlanNode const* node)
+{
+	if (node->group)
+	{
+		return 3;
+	}
+
+	if (node->index != NULL)
+	{
+		return (node->op == J_DB_SELECTOR_OPERATOR_EQ) ? 0 : 1;
+	}
+
+	return 2;
+}
+
+static gint
+j_sql_plan_node_compare(gconstpointer a, gconstpointer b)
+{
+	JSqlPlanNode const* x = *(JSqlPlanNode const* const*)a;
+	JSqlPlanNode const* y = *(JSqlPlanNode const* const*)b;
+	gint ret;
+
+	ret = j_sql_plan_node_rank(x) - j_sql_plan_node_rank(y);
+
+	if (ret == 0 && !x->group)
+	{
+		ret = g_strcmp0(x->full_name, y->full_name);
+	}
+
+	if (ret == 0 && !x->group)
+	{
+		ret = (gint)x->op - (gint)y->op;
+	}
+
+	return ret;
+}
+
+/**
+ * Sorts the children of all groups.
+ *
+ * Predicates served by an index come first, followed by other predicates and groups.
+ * The order is canonical, so equivalent selectors result in the same statement.
+ */
+static void
+j_sql_plan_sort(JSqlPlanNode* node)
+{
+	if (!node->group)
+	{
+		return;
+	}
+
+	for (guint i = 0; i < node->children->len; i++)
+	{
+		j_sql_plan_sort(g_ptr_array_index(node->children, i));
+	}
+
+	// g_ptr_array_sort is stable
+	g_ptr_array_sort(node->children, j_sql_plan_node_compare);
+}
+
+static gchar const*
+j_sql_plan_op_string(JDBSelectorOperator op)
+{
+	gchar const* ret = NULL;
+
+	switch (op)
+	{
+		case J_DB_SELECTOR_OPERATOR_LT:
+			ret = "<";
+			break;
+		case J_DB_SELECTOR_OPERATOR_LE:
+			ret = "<=";
+			break;
+		case J_DB_SELECTOR_OPERATOR_GT:
+			ret = ">";
+			break;
+		case J_DB_SELECTOR_OPERATOR_GE:
+			ret = ">=";
+			break;
+		case J_DB_SELECTOR_OPERATOR_EQ:
+			ret = "=";
+			break;
+		case J_DB_SELECTOR_OPERATOR_NE:
+			ret = "!=";
+			break;
+		default:
+			g_warn_if_reached();
+	}
+
+	return ret;
+}
+
+static void
+j_sql_plan_build_node(JSqlPlanNode const* node, GString* sql, GArray* arr_types_in)
+{
+	if (node->group)
+	{
+		if (node->unsatisfiable)
+		{
+			g_string_append(sql, "( 1 = 0 )");
+			return;
+		}
+
+		g_string_append(sql, "( ");
+
+		for (guint i = 0; i < node->children->len; i++)
+		{
+			if (i > 0)
+			{
+				g_string_append(sql, (node->mode == J_DB_SELECTOR_MODE_AND) ? " AND " : " OR ");
+			}
+
+			j_sql_plan_build_node(g_ptr_array_index(node->children, i), sql, arr_types_in);
+		}
+
+		g_string_append(sql, " )");
+	}
+	else
+	{
+		JDBType type = node->type;
+
+		g_string_append(sql, node->full_name);
+		g_string_append(sql, j_sql_plan_op_string(node->op));
+		g_string_append(sql, " ?");
+
+		g_array_append_val(arr_types_in, type);
+	}
+}
+
+static gboolean
+j_sql_plan_bind_node(JThreadVariables* thread_variables, JSqlPlanNode const* node, JSqlStatement* statement, GArray* parameters, guint64* position, GError** error)
+{
+	if (node->group)
+	{
+		for (guint i = 0; i < node->children->len && !node->unsatisfiable; i++)
+		{
+			if (G_UNLIKELY(!j_sql_plan_bind_node(thread_variables, g_ptr_array_index(node->children, i), statement, parameters, position, error)))
+			{
+				goto _error;
+			}
+		}
+	}
+	else
+	{
+		JDBTypeValue value = node->value;
+
+		if (node->parameter >= 0)
+		{
+			if (G_UNLIKELY(parameters == NULL || node->parameter >= parameters->len))
+			{
+				g_set_error(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_NO_VARIABLE_SET, "parameter %" G_GINT64_FORMAT " not bound", node->parameter);
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&g_array_index(parameters, bson_iter_t, node->parameter), node->type, &value, error)))
+			{
+				goto _error;
+			}
+		}
+
+		(*position)++;
+
+		if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, statement->stmt, *position, node->type, &value, error)))
+		{
+			goto _error;
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+static gboolean
+j_sql_plan_has_condition(JSqlPlan* plan)
+{
+	return plan->root != NULL && (plan->root->unsatisfiable || plan->root->children->len > 0);
+}
+
+static gboolean
+j_sql_plan_add_table(JSqlPlan* plan, gpointer backend_data, gchar const* table, GError** error)
+{
+	JSqlPlanAccess* access;
+
+	access = g_new0(JSqlPlanAccess, 1);
+	access->table = table;
+	g_ptr_array_add(plan->tables, access);
+
+	if (G_UNLIKELY(!(access->indexes = get_indexes(backend_data, plan->namespace, table, error))))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+j_sql_plan_parse_joins(JSqlPlan* plan, bson_iter_t* iter_joins, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+
+	while (TRUE)
+	{
+		gboolean has_next;
+		bson_iter_t iter_join_entry;
+		JSqlPlanJoin* join;
+
+		if (G_UNLIKELY(!j_bson_iter_next(iter_joins, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		// Recurse into join of the form { "<table_name>" : "<field_name>", "<table_name>" : "<field_name>" }
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(iter_joins, &iter_join_entry, error)))
+		{
+			goto _error;
+		}
+
+		join = g_new0(JSqlPlanJoin, 1);
+		g_ptr_array_add(plan->joins, join);
+
+		for (guint side = 0; side < 2; side++)
+		{
+			if (G_UNLIKELY(!j_bson_iter_next(&iter_join_entry, &has_next, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!has_next))
+			{
+				g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_SELECTOR_EMPTY, "join incomplete");
+				goto _error;
+			}
+
+			join->table[side] = j_bson_iter_key(&iter_join_entry, error);
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_join_entry, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			join->field[side] = value.val_string;
+		}
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+JSqlPlan*
+j_sql_plan_new(gpointer backend_data, JSqlBatch* batch, gchar const* name, bson_t const* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSqlPlan* plan;
+	bson_iter_t iter;
+	bson_iter_t iter_child;
+
+	g_return_val_if_fail(batch != NULL, NULL);
+	g_return_val_if_fail(name != NULL, NULL);
+
+	plan = g_new0(JSqlPlan, 1);
+	plan->namespace = batch->namespace;
+	plan->tables = g_ptr_array_new_with_free_func(j_sql_plan_access_free);
+	plan->joins = g_ptr_array_new_with_free_func(g_free);
+
+	// contains joins?
+	if (selector != NULL && bson_has_field(selector, "t"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "t", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_array(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		while (TRUE)
+		{
+			gboolean has_next;
+			JDBTypeValue value;
+
+			if (G_UNLIKELY(!j_bson_iter_next(&iter_child, &has_next, error)))
+			{
+				goto _error;
+			}
+
+			if (!has_next)
+			{
+				break;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&iter_child, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_sql_plan_add_table(plan, backend_data, value.val_string, error)))
+			{
+				goto _error;
+			}
+		}
+
+		if (bson_has_field(selector, "j"))
+		{
+			if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_find(&iter, "j", error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+			{
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_sql_plan_parse_joins(plan, &iter_child, error)))
+			{
+				goto _error;
+			}
+		}
+	}
+	else
+	{
+		if (G_UNLIKELY(!j_sql_plan_add_table(plan, backend_data, name, error)))
+		{
+			goto _error;
+		}
+	}
+
+	if (selector != NULL && bson_has_field(selector, "s"))
+	{
+		if (G_UNLIKELY(!j_bson_iter_init(&iter, selector, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_find(&iter, "s", error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &iter_child, error)))
+		{
+			goto _error;
+		}
+
+		plan->root = j_sql_plan_node_new_group(J_DB_SELECTOR_MODE_AND);
+
+		if (G_UNLIKELY(!j_sql_plan_parse(plan, backend_data, &iter_child, plan->root, error)))
+		{
+			goto _error;
+		}
+
+		j_sql_plan_normalize(plan, plan->root);
+
+		// a selector that only consists of a sub selector
+		while (!plan->root->unsatisfiable && plan->root->children->len == 1 && ((JSqlPlanNode*)g_ptr_array_index(plan->root->children, 0))->group)
+		{
+			JSqlPlanNode* child;
+
+			child = g_ptr_array_steal_index(plan->root->children, 0);
+			j_sql_plan_node_free(plan->root);
+			plan->root = child;
+		}
+	}
+
+	for (guint i = 0; i < plan->tables->len; i++)
+	{
+		j_sql_plan_choose_index(plan, g_ptr_array_index(plan->tables, i));
+	}
+
+	if (plan->root != NULL)
+	{
+		j_sql_plan_sort(plan->root);
+	}
+
+	j_sql_plan_order_tables(plan);
+
+	return plan;
+
+_error:
+	j_sql_plan_free(plan);
+
+	return NULL;
+}
+
+void
+j_sql_plan_free(JSqlPlan* plan)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (plan == NULL)
+	{
+		return;
+	}
+
+	if (plan->root != NULL)
+	{
+		j_sql_plan_node_free(plan->root);
+	}
+
+	g_ptr_array_unref(plan->tables);
+	g_ptr_array_unref(plan->joins);
+	g_free(plan);
+}
+
+void
+j_sql_plan_build_condition(JSqlPlan* plan, GString* sql, GArray* arr_types_in)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(plan != NULL);
+
+	if (j_sql_plan_has_condition(plan))
+	{
+		j_sql_plan_build_node(plan->root, sql, arr_types_in);
+	}
+}
+
+gboolean
+j_sql_plan_bind(gpointer backend_data, JSqlPlan* plan, JSqlStatement* statement, bson_t const* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JThreadVariables* thread_variables = NULL;
+	g_autoptr(GArray) parameters = NULL;
+	guint64 position = 0;
+	bson_iter_t iter;
+
+	g_return_val_if_fail(plan != NULL, FALSE);
+	g_return_val_if_fail(statement != NULL, FALSE);
+
+	if (!j_sql_plan_has_condition(plan))
+	{
+		return TRUE;
+	}
+
+	if (G_UNLIKELY(!(thread_variables = thread_variables_get(backend_data, error))))
+	{
+		goto _error;
+	}
+
+	// collect the bound values of a prepared selector, they are stored in an array in parameter order
+	if (selector != NULL && bson_iter_init_find(&iter, selector, "p"))
+	{
+		bson_iter_t iter_parameter;
+
+		parameters = g_array_new(FALSE, FALSE, sizeof(bson_iter_t));
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_array(&iter, &iter_parameter, error)))
+		{
+			goto _error;
+		}
+
+		while (bson_iter_next(&iter_parameter))
+		{
+			g_array_append_val(parameters, iter_parameter);
+		}
+	}
+
+	if (G_UNLIKELY(!j_sql_plan_bind_node(thread_variables, plan->root, statement, parameters, &position, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+void
+j_sql_plan_explain(JSqlPlan* plan, GString* report)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(plan != NULL);
+	g_return_if_fail(report != NULL);
+
+	for (guint i = 0; i < plan->tables->len; i++)
+	{
+		JSqlPlanAccess* access = g_ptr_array_index(plan->tables, i);
+
+		if (access->index == NULL)
+		{
+			g_string_append_printf(report, "SCAN %s_%s\n", plan->namespace, access->table);
+			continue;
+		}
+
+		g_string_append_printf(report, "SEARCH %s_%s USING INDEX %s (", plan->namespace, access->table, access->index->name);
+
+		for (guint k = 0; k < access->index_eq; k++)
+		{
+			g_string_append_printf(report, "%s%s=?", (k > 0) ? " AND " : "", (gchar const*)g_ptr_array_index(access->index->names, k));
+		}
+
+		if (access->index_range)
+		{
+			g_string_append_printf(report, "%s%s range", (access->index_eq > 0) ? " AND " : "", (gchar const*)g_ptr_array_index(access->index->names, access->index_eq));
+		}
+
+		g_string_append(report, ")\n");
+	}
+
+	for (guint i = 0; i < plan->joins->len; i++)
+	{
+		JSqlPlanJoin* join = g_ptr_array_index(plan->joins, i);
+
+		g_string_append_printf(report, "JOIN %s_%s.%s = %s_%s.%s\n", plan->namespace, join->table[0], join->field[0], plan->namespace, join->table[1], join->field[1]);
+	}
+
+	if (j_sql_plan_has_condition(plan))
+	{
+		g_autoptr(GArray) arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+		g_string_append(report, "WHERE ");
+		j_sql_plan_build_node(plan->root, report, arr_types_in);
+		g_string_append(report, "\n");
+
+		if (plan->root->unsatisfiable)
+		{
+			g_string_append(report, "NOTE selector can never match\n");
+		}
+	}
+
+	if (plan->merged > 0 || plan->duplicates > 0)
+	{
+		g_string_append_printf(report, "NORMALIZE %u range predicate(s) merged, %u duplicate predicate(s) removed\n", plan->merged, plan->duplicates);
+	}
+}
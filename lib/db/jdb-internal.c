@@ -43,6 +43,25 @@ struct JDBIteratorHelper
 
 typedef struct JDBIteratorHelper JDBIteratorHelper;
 
+struct JDBExplainHelper
+{
+	bson_t bson;
+	gchar** plan;
+};
+
+typedef struct JDBExplainHelper JDBExplainHelper;
+
+struct JDBModifyHelper
+{
+	/**
+	 * The operation's error, it is only propagated after retrying.
+	 **/
+	GError* error;
+	GError** user_error;
+};
+
+typedef struct JDBModifyHelper JDBModifyHelper;
+
 GQuark
 j_db_error_quark(void)
 {
@@ -51,6 +70,37 @@ j_db_error_quark(void)
 	return g_quark_from_static_string("j-db-error-quark");
 }
 
+/**
+ * Invalidates the cached schema used by a failed operation.
+ *
+ * A failing operation is the cheap indicator that the schema might have been deleted or recreated by another process.
+ */
+static void
+j_backend_db_func_failed(JBackendOperation* data, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 version = 0;
+
+	if (type == J_MESSAGE_DB_INSERT || type == J_MESSAGE_DB_UPDATE || type == J_MESSAGE_DB_DELETE)
+	{
+		JDBEntry* entry = data->unref_values[0];
+
+		version = entry->schema->cache_version;
+	}
+	else if (type == J_MESSAGE_DB_QUERY)
+	{
+		JDBSchema* schema = data->unref_values[0];
+
+		version = schema->cache_version;
+	}
+
+	if (version != 0)
+	{
+		j_db_schema_cache_invalidate(data->in_param[0].ptr_const, data->in_param[1].ptr_const, version);
+	}
+}
+
 static gboolean
 j_backend_db_func_exec(JList* operations, JSemantics* semantics, JMessageType type)
 {
@@ -95,7 +145,11 @@ j_backend_db_func_exec(JList* operations, JSemantics* semantics, JMessageType ty
 			}
 			else
 			{
-				ret = data->backend_func(db_backend, batch, data) && ret;
+				if (!data->backend_func(db_backend, batch, data))
+				{
+					j_backend_db_func_failed(data, type);
+					ret = FALSE;
+				}
 			}
 		}
 	}
@@ -103,6 +157,24 @@ j_backend_db_func_exec(JList* operations, JSemantics* semantics, JMessageType ty
 	if (db_backend == NULL)
 	{
 		db_connection = j_connection_pool_pop(J_BACKEND_TYPE_DB, 0);
+
+		if (db_connection == NULL)
+		{
+			iter_recieve = j_list_iterator_new(operations);
+
+			while (j_list_iterator_next(iter_recieve))
+			{
+				GError** operation_error;
+
+				data = j_list_iterator_get(iter_recieve);
+				operation_error = data->out_param[data->out_param_count - 1].ptr;
+
+				g_set_error_literal(operation_error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_FAILED, "no connection to db server");
+			}
+
+			return FALSE;
+		}
+
 		j_message_send(message, db_connection);
 		reply = j_message_new_reply(message);
 		j_message_receive(reply, db_connection);
@@ -111,7 +183,12 @@ j_backend_db_func_exec(JList* operations, JSemantics* semantics, JMessageType ty
 		while (j_list_iterator_next(iter_recieve))
 		{
 			data = j_list_iterator_get(iter_recieve);
-			ret = j_backend_operation_from_message(reply, data->out_param, data->out_param_count) && ret;
+
+			if (!j_backend_operation_from_message(reply, data->out_param, data->out_param_count))
+			{
+				j_backend_db_func_failed(data, type);
+				ret = FALSE;
+			}
 		}
 
 		j_connection_pool_push(J_BACKEND_TYPE_DB, 0, db_connection);
@@ -183,12 +260,40 @@ j_db_internal_iterator_unref(gpointer iterator)
 	j_db_iterator_unref(iterator);
 }
 
+/**
+ * Removes the schemas of the given operations from the schema cache.
+ */
+static void
+j_db_schema_cache_invalidate_operations(JList* operations)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JListIterator) iter = NULL;
+
+	iter = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(iter))
+	{
+		JBackendOperation* data = j_list_iterator_get(iter);
+		JDBSchema* schema = data->unref_values[0];
+
+		j_db_schema_cache_invalidate(schema->namespace, schema->name, 0);
+	}
+}
+
 static gboolean
 j_db_schema_create_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_CREATE);
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_CREATE);
+
+	// A schema with the same name might have been deleted and recreated
+	j_db_schema_cache_invalidate_operations(operations);
+
+	return ret;
 }
 
 gboolean
@@ -201,6 +306,9 @@ j_db_internal_schema_create(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	// Schema lookups are answered from the cache when they are queued, so later operations in the same batch must not see a stale entry
+	j_db_schema_cache_invalidate(j_db_schema->namespace, j_db_schema->name, 0);
+
 	data = g_new(JBackendOperation, 1);
 	memcpy(data, &j_backend_operation_db_schema_create, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
@@ -228,7 +336,33 @@ j_db_schema_get_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_GET);
+	g_autoptr(JListIterator) iter = NULL;
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_GET);
+
+	iter = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(iter))
+	{
+		JBackendOperation* data = j_list_iterator_get(iter);
+
+		j_db_schema_cache_insert(data->unref_values[0]);
+	}
+
+	return ret;
+}
+
+static gboolean
+j_db_schema_get_cached_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	(void)operations;
+	(void)semantics;
+
+	// The schema has already been filled from the cache
+	return TRUE;
 }
 
 gboolean
@@ -241,6 +375,20 @@ j_db_internal_schema_get(JDBSchema* j_db_schema, JBatch* batch, GError** error)
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	if (j_db_schema_cache_lookup(j_db_schema))
+	{
+		// The batch still needs an operation for j_batch_execute to succeed
+		op = j_operation_new();
+		op->key = j_db_schema->namespace;
+		op->data = j_db_schema_ref(j_db_schema);
+		op->exec_func = j_db_schema_get_cached_exec;
+		op->free_func = j_db_internal_schema_unref;
+
+		j_batch_add(batch, op);
+
+		return TRUE;
+	}
+
 	data = g_new(JBackendOperation, 1);
 	memcpy(data, &j_backend_operation_db_schema_get, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
@@ -268,7 +416,13 @@ j_db_schema_delete_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_DELETE);
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_DELETE);
+
+	j_db_schema_cache_invalidate_operations(operations);
+
+	return ret;
 }
 
 gboolean
@@ -281,6 +435,8 @@ j_db_internal_schema_delete(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	j_db_schema_cache_invalidate(j_db_schema->namespace, j_db_schema->name, 0);
+
 	data = g_new(JBackendOperation, 1);
 	memcpy(data, &j_backend_operation_db_schema_delete, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
@@ -343,12 +499,115 @@ j_db_internal_insert(JDBEntry* j_db_entry, JBatch* batch, GError** error)
 	return TRUE;
 }
 
+static void
+j_db_internal_modify_helper_free(gpointer data)
+{
+	JDBModifyHelper* helper = data;
+
+	g_clear_error(&helper->error);
+	g_free(helper);
+}
+
+/**
+ * Executes update or delete operations.
+ *
+ * The server may have forgotten a prepared selector (e.g., because it was restarted or evicted the template).
+ * In this case, the template is sent again and the affected operations are retried, see j_db_iterator_new().
+ */
+static gboolean
+j_db_modify_exec(JList* operations, JSemantics* semantics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JList) retry = NULL;
+	g_autoptr(JListIterator) iter = NULL;
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, type);
+
+	if (!ret)
+	{
+		guint failed = 0;
+
+		retry = j_list_new(NULL);
+		iter = j_list_iterator_new(operations);
+
+		while (j_list_iterator_next(iter))
+		{
+			JBackendOperation* data = j_list_iterator_get(iter);
+			JDBSelector* selector = data->unref_values[1];
+			JDBModifyHelper* helper = data->unref_values[2];
+
+			if (helper->error == NULL)
+			{
+				continue;
+			}
+
+			failed++;
+
+			if (selector == NULL || !selector->registered || !g_error_matches(helper->error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_HANDLE_UNKNOWN))
+			{
+				continue;
+			}
+
+			g_clear_error(&helper->error);
+			selector->registered = FALSE;
+			selector->final_valid = FALSE;
+
+			if (G_UNLIKELY(!j_db_selector_finalize(selector, &helper->error)))
+			{
+				continue;
+			}
+
+			data->in_param[2].ptr_const = &selector->final;
+			j_list_append(retry, data);
+		}
+
+		if (j_list_length(retry) > 0)
+		{
+			// only succeed if every failed operation could be retried
+			ret = j_backend_db_func_exec(retry, semantics, type) && j_list_length(retry) == failed;
+		}
+
+		g_clear_pointer(&iter, j_list_iterator_free);
+	}
+
+	iter = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(iter))
+	{
+		JBackendOperation* data = j_list_iterator_get(iter);
+		JDBSelector* selector = data->unref_values[1];
+		JDBModifyHelper* helper = data->unref_values[2];
+
+		if (helper->error != NULL)
+		{
+			ret = FALSE;
+
+			if (helper->user_error != NULL && *helper->user_error == NULL)
+			{
+				*helper->user_error = g_steal_pointer(&helper->error);
+			}
+
+			g_clear_error(&helper->error);
+		}
+		else if (selector != NULL && selector->parameters->len > 0 && !selector->registered)
+		{
+			// from now on, only the handle and the bound values have to be sent
+			selector->registered = TRUE;
+			selector->final_valid = FALSE;
+		}
+	}
+
+	return ret;
+}
+
 static gboolean
 j_db_update_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_UPDATE);
+	return j_db_modify_exec(operations, semantics, J_MESSAGE_DB_UPDATE);
 }
 
 gboolean
@@ -356,24 +615,30 @@ j_db_internal_update(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JDBModifyHelper* helper;
 	JOperation* op;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	helper = g_new0(JDBModifyHelper, 1);
+	helper->user_error = error;
+
 	data = g_new(JBackendOperation, 1);
 	memcpy(data, &j_backend_operation_db_update, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
 	data->in_param[1].ptr_const = j_db_entry->schema->name;
 	data->in_param[2].ptr_const = j_db_selector_get_bson(j_db_selector);
 	data->in_param[3].ptr_const = &j_db_entry->bson;
-	data->out_param[0].ptr_const = error;
+	data->out_param[0].ptr_const = &helper->error;
 
-	data->unref_func_count = 2;
+	data->unref_func_count = 3;
 	data->unref_funcs[0] = j_db_internal_entry_unref;
 	data->unref_funcs[1] = j_db_internal_selector_unref;
+	data->unref_funcs[2] = j_db_internal_modify_helper_free;
 	data->unref_values[0] = j_db_entry_ref(j_db_entry);
 	data->unref_values[1] = j_db_selector_ref(j_db_selector);
+	data->unref_values[2] = helper;
 
 	op = j_operation_new();
 	op->key = j_db_entry->schema->namespace;
@@ -391,7 +656,7 @@ j_db_delete_exec(JList* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_DELETE);
+	return j_db_modify_exec(operations, semantics, J_MESSAGE_DB_DELETE);
 }
 
 gboolean
@@ -399,23 +664,29 @@ j_db_internal_delete(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JDBModifyHelper* helper;
 	JOperation* op;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
+	helper = g_new0(JDBModifyHelper, 1);
+	helper->user_error = error;
+
 	data = g_new(JBackendOperation, 1);
 	memcpy(data, &j_backend_operation_db_delete, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
 	data->in_param[1].ptr_const = j_db_entry->schema->name;
 	data->in_param[2].ptr_const = j_db_selector_get_bson(j_db_selector);
-	data->out_param[0].ptr_const = error;
+	data->out_param[0].ptr_const = &helper->error;
 
-	data->unref_func_count = 2;
+	data->unref_func_count = 3;
 	data->unref_funcs[0] = j_db_internal_entry_unref;
 	data->unref_funcs[1] = j_db_internal_selector_unref;
+	data->unref_funcs[2] = j_db_internal_modify_helper_free;
 	data->unref_values[0] = j_db_entry_ref(j_db_entry);
 	data->unref_values[1] = j_db_selector_ref(j_db_selector);
+	data->unref_values[2] = helper;
 
 	op = j_operation_new();
 	op->key = j_db_entry->schema->namespace;
@@ -479,6 +750,97 @@ j_db_internal_query(JDBSchema* j_db_schema, JDBSelector* j_db_selector, JDBItera
 	return TRUE;
 }
 
+static void
+j_db_internal_explain_helper_free(gpointer data)
+{
+	JDBExplainHelper* helper = data;
+	bson_t zerobson;
+
+	memset(&zerobson, 0, sizeof(bson_t));
+
+	if (memcmp(&helper->bson, &zerobson, sizeof(bson_t)))
+	{
+		bson_destroy(&helper->bson);
+	}
+
+	g_free(helper);
+}
+
+static gboolean
+j_db_explain_exec(JList* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JListIterator) iter = NULL;
+	gboolean ret;
+	bson_t zerobson;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_EXPLAIN);
+
+	memset(&zerobson, 0, sizeof(bson_t));
+	iter = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(iter))
+	{
+		JBackendOperation* data = j_list_iterator_get(iter);
+		JDBExplainHelper* helper = data->unref_values[1];
+		bson_iter_t bson_iter;
+		JDBTypeValue value;
+
+		// the BSON is only set if the operation succeeded
+		if (!memcmp(&helper->bson, &zerobson, sizeof(bson_t)))
+		{
+			continue;
+		}
+
+		if (j_bson_iter_init(&bson_iter, &helper->bson, NULL) && j_bson_iter_find(&bson_iter, "plan", NULL) && j_bson_iter_value(&bson_iter, J_DB_TYPE_STRING, &value, NULL))
+		{
+			*helper->plan = g_strdup(value.val_string);
+		}
+	}
+
+	return ret;
+}
+
+gboolean
+j_db_internal_explain(JDBSelector* j_db_selector, gchar** plan, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBExplainHelper* helper;
+	JOperation* op;
+	JBackendOperation* data;
+
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	helper = g_new0(JDBExplainHelper, 1);
+	helper->plan = plan;
+
+	data = g_new(JBackendOperation, 1);
+	memcpy(data, &j_backend_operation_db_explain, sizeof(JBackendOperation));
+	data->in_param[0].ptr_const = j_db_selector->schema->namespace;
+	data->in_param[1].ptr_const = j_db_selector->schema->name;
+	data->in_param[2].ptr_const = j_db_selector_get_bson(j_db_selector);
+	data->out_param[0].ptr_const = &helper->bson;
+	data->out_param[1].ptr_const = error;
+
+	data->unref_func_count = 2;
+	data->unref_funcs[0] = j_db_internal_selector_unref;
+	data->unref_funcs[1] = j_db_internal_explain_helper_free;
+	data->unref_values[0] = j_db_selector_ref(j_db_selector);
+	data->unref_values[1] = helper;
+
+	op = j_operation_new();
+	op->key = j_db_selector->schema->namespace;
+	op->data = data;
+	op->exec_func = j_db_explain_exec;
+	op->free_func = j_backend_db_func_free;
+
+	j_batch_add(batch, op);
+
+	return TRUE;
+}
+
 gboolean
 j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error)
 {
@@ -535,19 +897,19 @@ error2:
 	return FALSE;
 }
 
-gboolean
-j_db_selector_finalize(JDBSelector* selector, GError** error)
+/**
+ * \brief Build the tables, joins, selection and aggregate sections of a selector.
+ *
+ * \param selector The selector.
+ * \param bson An initialized BSON document the sections are appended to.
+ * \param error A GError.
+ * \return TRUE on success, FALSE otherwise.
+ */
+static gboolean
+j_db_selector_build(JDBSelector* selector, bson_t* bson, GError** error)
 {
-	J_TRACE_FUNCTION(NULL);
-
 	JDBTypeValue val;
 
-	g_return_val_if_fail(selector != NULL, FALSE);
-	g_return_val_if_fail(!selector->final_valid, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
-	j_bson_init(&selector->final, error);
-
 	// contains joins?
 	if (g_hash_table_size(selector->join_schema) > 1)
 	{
@@ -558,7 +920,7 @@ j_db_selector_finalize(JDBSelector* selector, GError** error)
 		guint table_count = 0;
 		gpointer key;
 
-		if (G_UNLIKELY(!j_bson_append_array_begin(&selector->final, "t", &tables, error)))
+		if (G_UNLIKELY(!j_bson_append_array_begin(bson, "t", &tables, error)))
 		{
 			goto _error;
 		}
@@ -579,23 +941,71 @@ j_db_selector_finalize(JDBSelector* selector, GError** error)
 			++table_count;
 		}
 
-		if (G_UNLIKELY(!j_bson_append_array_end(&selector->final, &tables, error)))
+		if (G_UNLIKELY(!j_bson_append_array_end(bson, &tables, error)))
 		{
 			goto _error;
 		}
 
-		if (G_UNLIKELY(!j_bson_append_document(&selector->final, "j", &selector->joins, error)))
+		if (G_UNLIKELY(!j_bson_append_document(bson, "j", &selector->joins, error)))
 		{
 			goto _error;
 		}
 	}
 
-	if (G_UNLIKELY(!j_bson_append_document(&selector->final, "s", &selector->selection, error)))
+	if (G_UNLIKELY(!j_bson_append_document(bson, "s", &selector->selection, error)))
 	{
 		goto _error;
 	}
 
-	selector->final_valid = TRUE;
+	if (selector->aggregated)
+	{
+		bson_t aggregate;
+
+		// append aggregate as `"a" : {"f" : <function>, "t" : <table_name>, "n" : <field>, "g" : <group_field>}`
+		if (G_UNLIKELY(!j_bson_append_document_begin(bson, "a", &aggregate, error)))
+		{
+			goto _error;
+		}
+
+		val.val_uint32 = selector->aggregate;
+
+		if (G_UNLIKELY(!j_bson_append_value(&aggregate, "f", J_DB_TYPE_UINT32, &val, error)))
+		{
+			goto _error;
+		}
+
+		val.val_string = selector->schema->name;
+
+		if (G_UNLIKELY(!j_bson_append_value(&aggregate, "t", J_DB_TYPE_STRING, &val, error)))
+		{
+			goto _error;
+		}
+
+		if (selector->aggregate_field != NULL)
+		{
+			val.val_string = selector->aggregate_field;
+
+			if (G_UNLIKELY(!j_bson_append_value(&aggregate, "n", J_DB_TYPE_STRING, &val, error)))
+			{
+				goto _error;
+			}
+		}
+
+		if (selector->aggregate_group != NULL)
+		{
+			val.val_string = selector->aggregate_group;
+
+			if (G_UNLIKELY(!j_bson_append_value(&aggregate, "g", J_DB_TYPE_STRING, &val, error)))
+			{
+				goto _error;
+			}
+		}
+
+		if (G_UNLIKELY(!j_bson_append_document_end(bson, &aggregate, error)))
+		{
+			goto _error;
+		}
+	}
 
 	return TRUE;
 
@@ -604,6 +1014,135 @@ _error:
 	return FALSE;
 }
 
+/**
+ * \brief Compute the handle of a template.
+ *
+ * The handle is derived from the namespace, the schema and the template, so equal templates share a handle.
+ */
+static guint64
+j_db_selector_hash(JDBSelector* selector)
+{
+	guint8 const* data;
+	guint64 hash = 14695981039346656037ULL;
+
+	// 64 bit FNV-1a
+	for (gchar const* c = selector->schema->namespace; *c != '\0'; c++)
+	{
+		hash = (hash ^ (guint8)*c) * 1099511628211ULL;
+	}
+
+	hash = (hash ^ '.') * 1099511628211ULL;
+
+	for (gchar const* c = selector->schema->name; *c != '\0'; c++)
+	{
+		hash = (hash ^ (guint8)*c) * 1099511628211ULL;
+	}
+
+	data = bson_get_data(&selector->template);
+
+	for (guint32 i = 0; i < selector->template.len; i++)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+gboolean
+j_db_selector_finalize(JDBSelector* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue val;
+	bson_t parameters;
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(!selector->final_valid, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	// this also handles selector modifications after selector usage
+	bson_reinit(&selector->final);
+
+	if (selector->parameters->len == 0)
+	{
+		if (G_UNLIKELY(!j_db_selector_build(selector, &selector->final, error)))
+		{
+			goto _error;
+		}
+
+		selector->final_valid = TRUE;
+
+		return TRUE;
+	}
+
+	for (guint i = 0; i < selector->arguments->len; i++)
+	{
+		if (G_UNLIKELY(g_ptr_array_index(selector->arguments, i) == NULL))
+		{
+			g_set_error(error, J_DB_ERROR, J_DB_ERROR_PARAMETER_NOT_BOUND, "parameter %u not bound", i);
+			goto _error;
+		}
+	}
+
+	if (!selector->template_valid)
+	{
+		bson_reinit(&selector->template);
+
+		if (G_UNLIKELY(!j_db_selector_build(selector, &selector->template, error)))
+		{
+			goto _error;
+		}
+
+		selector->handle = j_db_selector_hash(selector);
+		selector->template_valid = TRUE;
+		selector->registered = FALSE;
+	}
+
+	// append the template only if the server does not know it yet
+	if (!selector->registered && G_UNLIKELY(!bson_concat(&selector->final, &selector->template)))
+	{
+		g_set_error_literal(error, J_BACKEND_BSON_ERROR, J_BACKEND_BSON_ERROR_FAILED, "bson concat failed");
+		goto _error;
+	}
+
+	val.val_sint64 = selector->handle;
+
+	if (G_UNLIKELY(!j_bson_append_value(&selector->final, "h", J_DB_TYPE_SINT64, &val, error)))
+	{
+		goto _error;
+	}
+
+	// append the bound values as `"p" : [<value>, ...]`
+	if (G_UNLIKELY(!j_bson_append_array_begin(&selector->final, "p", &parameters, error)))
+	{
+		goto _error;
+	}
+
+	for (guint i = 0; i < selector->arguments->len; i++)
+	{
+		gchar key[16];
+
+		g_snprintf(key, sizeof(key), "%u", i);
+
+		if (G_UNLIKELY(!j_bson_append_value(&parameters, key, g_array_index(selector->parameters, JDBType, i), g_ptr_array_index(selector->arguments, i), error)))
+		{
+			goto _error;
+		}
+	}
+
+	if (G_UNLIKELY(!j_bson_append_array_end(&selector->final, &parameters, error)))
+	{
+		goto _error;
+	}
+
+	selector->final_valid = TRUE;
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
 bson_t*
 j_db_selector_get_bson(JDBSelector* selector)
 {
@@ -615,18 +1154,6 @@ j_db_selector_get_bson(JDBSelector* selector)
 
 	if (!selector->final_valid)
 	{
-		if (bson_has_field(&selector->final, "s"))
-		{
-			// final bson has already been build, rebuild it
-			// this case handles selector modifications after selector usage
-			j_bson_destroy(&selector->final);
-
-			if (!j_bson_init(&selector->final, &err))
-			{
-				goto _error;
-			}
-		}
-
 		if (!j_db_selector_finalize(selector, &err))
 		{
 			goto _error;
@@ -32,15 +32,44 @@
 #include <db/jdb-internal.h>
 #include <julea-db.h>
 
+/**
+ * \brief Run the query of an iterator.
+ *
+ * \param iterator The iterator.
+ * \param selector The selector. May be NULL.
+ * \param error A GError.
+ * \return TRUE on success, FALSE otherwise.
+ */
+static gboolean
+j_db_iterator_query(JDBIterator* iterator, JDBSelector* selector, GError** error)
+{
+	gboolean ret;
+	gboolean ret2;
+	JBatch* batch;
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	ret2 = j_db_internal_query(iterator->schema, selector, iterator, batch, error);
+	ret = ret2 && j_batch_execute(batch);
+	j_batch_unref(batch);
+
+	if (G_UNLIKELY(!ret && ret2))
+	{
+		while (j_db_internal_iterate(iterator, NULL))
+		{
+			/*do nothing*/
+		}
+	}
+
+	return ret;
+}
+
 JDBIterator*
 j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	guint ret;
-	guint ret2 = FALSE;
-	JBatch* batch;
 	JDBIterator* iterator = NULL;
+	g_autoptr(GError) err = NULL;
 
 	g_return_val_if_fail(schema != NULL, NULL);
 	g_return_val_if_fail((selector == NULL) || (selector->schema == schema), NULL);
@@ -48,6 +77,11 @@ j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 
 	iterator = j_helper_alloc_aligned(128, sizeof(JDBIterator));
 	iterator->schema = j_db_schema_ref(schema);
+	iterator->selector = NULL;
+	iterator->iterator = NULL;
+	iterator->ref_count = 1;
+	iterator->valid = FALSE;
+	iterator->bson_valid = FALSE;
 
 	if (G_UNLIKELY(!iterator->schema))
 	{
@@ -56,7 +90,10 @@ j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 
 	if (selector)
 	{
-		j_db_selector_finalize(selector, error);
+		if (!selector->final_valid && G_UNLIKELY(!j_db_selector_finalize(selector, error)))
+		{
+			goto _error;
+		}
 
 		iterator->selector = j_db_selector_ref(selector);
 
@@ -65,23 +102,35 @@ j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 			goto _error;
 		}
 	}
-	else
+
+	if (G_UNLIKELY(!j_db_iterator_query(iterator, selector, &err)))
 	{
-		iterator->selector = NULL;
-	}
+		// the server may have forgotten a prepared selector (e.g., because it was restarted), so send the template again
+		if (selector == NULL || !selector->registered || !g_error_matches(err, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_HANDLE_UNKNOWN))
+		{
+			if (err != NULL)
+			{
+				g_propagate_error(error, g_steal_pointer(&err));
+			}
 
-	iterator->iterator = NULL;
-	iterator->ref_count = 1;
-	iterator->valid = FALSE;
-	iterator->bson_valid = FALSE;
-	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
-	ret2 = j_db_internal_query(schema, selector, iterator, batch, error);
-	ret = ret2 && j_batch_execute(batch);
-	j_batch_unref(batch);
+			goto _error;
+		}
+
+		g_clear_error(&err);
+		selector->registered = FALSE;
+		selector->final_valid = FALSE;
+
+		if (G_UNLIKELY(!j_db_selector_finalize(selector, error) || !j_db_iterator_query(iterator, selector, error)))
+		{
+			goto _error;
+		}
+	}
 
-	if (G_UNLIKELY(!ret))
+	if (selector != NULL && selector->parameters->len > 0 && !selector->registered)
 	{
-		goto _error;
+		// from now on, only the handle and the bound values have to be sent
+		selector->registered = TRUE;
+		selector->final_valid = FALSE;
 	}
 
 	iterator->valid = TRUE;
@@ -89,14 +138,6 @@ j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 	return iterator;
 
 _error:
-	if (ret2)
-	{
-		while (j_db_internal_iterate(iterator, NULL))
-		{
-			/*do nothing*/
-		}
-	}
-
 	j_db_iterator_unref(iterator);
 
 	return NULL;
@@ -174,6 +215,64 @@ _error:
 	return FALSE;
 }
 
+static void
+j_db_iterator_copy_value(JDBType type, JDBTypeValue const* val, gpointer* value, guint64* length)
+{
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			*value = g_new(gint32, 1);
+			*((gint32*)*value) = val->val_sint32;
+			*length = sizeof(gint32);
+			break;
+		case J_DB_TYPE_UINT32:
+			*value = g_new(guint32, 1);
+			*((guint32*)*value) = val->val_uint32;
+			*length = sizeof(guint32);
+			break;
+		case J_DB_TYPE_FLOAT32:
+			*value = g_new(gfloat, 1);
+			*((gfloat*)*value) = val->val_float32;
+			*length = sizeof(gfloat);
+			break;
+		case J_DB_TYPE_SINT64:
+			*value = g_new(gint64, 1);
+			*((gint64*)*value) = val->val_sint64;
+			*length = sizeof(gint64);
+			break;
+		case J_DB_TYPE_UINT64:
+			*value = g_new(guint64, 1);
+			*((guint64*)*value) = val->val_uint64;
+			*length = sizeof(guint64);
+			break;
+		case J_DB_TYPE_FLOAT64:
+			*value = g_new(gdouble, 1);
+			*((gdouble*)*value) = val->val_float64;
+			*length = sizeof(gdouble);
+			break;
+		case J_DB_TYPE_STRING:
+			*value = g_strdup(val->val_string);
+			*length = strlen(val->val_string);
+			break;
+		case J_DB_TYPE_BLOB:
+			if (val->val_blob && val->val_blob_length)
+			{
+				*value = g_new(gchar, val->val_blob_length);
+				memcpy(*value, val->val_blob, val->val_blob_length);
+				*length = val->val_blob_length;
+			}
+			else
+			{
+				*value = NULL;
+				*length = 0;
+			}
+			break;
+		case J_DB_TYPE_ID:
+		default:
+			g_assert_not_reached();
+	}
+}
+
 gboolean
 j_db_iterator_get_field(JDBIterator* iterator, JDBSchema* schema, gchar const* name, JDBType* type, gpointer* value, guint64* length, GError** error)
 {
@@ -222,60 +321,77 @@ j_db_iterator_get_field(JDBIterator* iterator, JDBSchema* schema, gchar const* n
 		goto _error;
 	}
 
-	switch (*type)
+	j_db_iterator_copy_value(*type, &val, value, length);
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+j_db_iterator_get_aggregate(JDBIterator* iterator, JDBType* type, gpointer* value, guint64* length, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBSelector* selector;
+	JDBType field_type = J_DB_TYPE_UINT64;
+	JDBTypeValue val;
+	bson_iter_t iter;
+	g_autoptr(GString) field_name = NULL;
+
+	g_return_val_if_fail(iterator != NULL, FALSE);
+	g_return_val_if_fail(iterator->bson_valid, FALSE);
+	g_return_val_if_fail(iterator->selector != NULL && iterator->selector->aggregated, FALSE);
+	g_return_val_if_fail(type != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(length != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	selector = iterator->selector;
+
+	if (selector->aggregate_field != NULL && G_UNLIKELY(!j_db_schema_get_field(selector->schema, selector->aggregate_field, &field_type, error)))
 	{
-		case J_DB_TYPE_SINT32:
-			*value = g_new(gint32, 1);
-			*((gint32*)*value) = val.val_sint32;
-			*length = sizeof(gint32);
-			break;
-		case J_DB_TYPE_UINT32:
-			*value = g_new(guint32, 1);
-			*((guint32*)*value) = val.val_uint32;
-			*length = sizeof(guint32);
-			break;
-		case J_DB_TYPE_FLOAT32:
-			*value = g_new(gfloat, 1);
-			*((gfloat*)*value) = val.val_float32;
-			*length = sizeof(gfloat);
-			break;
-		case J_DB_TYPE_SINT64:
-			*value = g_new(gint64, 1);
-			*((gint64*)*value) = val.val_sint64;
-			*length = sizeof(gint64);
-			break;
-		case J_DB_TYPE_UINT64:
-			*value = g_new(guint64, 1);
-			*((guint64*)*value) = val.val_uint64;
-			*length = sizeof(guint64);
-			break;
-		case J_DB_TYPE_FLOAT64:
-			*value = g_new(gdouble, 1);
-			*((gdouble*)*value) = val.val_float64;
-			*length = sizeof(gdouble);
-			break;
-		case J_DB_TYPE_STRING:
-			*value = g_strdup(val.val_string);
-			*length = strlen(val.val_string);
-			break;
-		case J_DB_TYPE_BLOB:
-			if (val.val_blob && val.val_blob_length)
-			{
-				*value = g_new(gchar, val.val_blob_length);
-				memcpy(*value, val.val_blob, val.val_blob_length);
-				*length = val.val_blob_length;
-			}
-			else
-			{
-				*value = NULL;
-				*length = 0;
-			}
-			break;
-		case J_DB_TYPE_ID:
-		default:
-			g_assert_not_reached();
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_aggregate_type(selector->aggregate, field_type, type)))
+	{
+		g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_TYPE_INVALID, "type invalid");
+		goto _error;
+	}
+
+	field_name = g_string_new(selector->schema->namespace);
+	g_string_append(field_name, "_");
+	g_string_append(field_name, selector->schema->name);
+	g_string_append(field_name, "._aggregate");
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, &iterator->bson, error)))
+	{
+		goto _error;
 	}
 
+	if (G_UNLIKELY(!j_bson_iter_find(&iter, field_name->str, error)))
+	{
+		goto _error;
+	}
+
+	// MIN and MAX of strings are NULL if no entries match
+	if (BSON_ITER_HOLDS_NULL(&iter))
+	{
+		*value = NULL;
+		*length = 0;
+
+		return TRUE;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_value(&iter, *type, &val, error)))
+	{
+		goto _error;
+	}
+
+	j_db_iterator_copy_value(*type, &val, value, length);
+
 	return TRUE;
 
 _error:
@@ -32,6 +32,149 @@
 #include <db/jdb-internal.h>
 #include <julea-db.h>
 
+/**
+ * An entry of the client-side schema cache.
+ */
+struct JDBSchemaCacheEntry
+{
+	/// The schema as returned by the backend.
+	bson_t bson;
+
+	/// The version of this entry. Versions are unique for the lifetime of the process.
+	guint64 version;
+};
+
+typedef struct JDBSchemaCacheEntry JDBSchemaCacheEntry;
+
+/**
+ * The process-wide schema cache.
+ *
+ * (namespace, name) (gchar*) -> (JDBSchemaCacheEntry*)
+ * Schemas are immutable once created, so an entry only becomes stale if the schema is deleted (and possibly recreated).
+ * Stale entries are detected when an operation using the cached schema fails.
+ */
+static GHashTable* j_db_schema_cache = NULL;
+static guint64 j_db_schema_cache_version = 0;
+
+G_LOCK_DEFINE_STATIC(j_db_schema_cache);
+
+static void
+j_db_schema_cache_entry_free(gpointer data)
+{
+	JDBSchemaCacheEntry* entry = data;
+
+	bson_destroy(&entry->bson);
+	g_free(entry);
+}
+
+static gchar*
+j_db_schema_cache_key(gchar const* namespace, gchar const* name)
+{
+	// Prefix the namespace's length to keep the key unambiguous
+	return g_strdup_printf("%" G_GSIZE_FORMAT ":%s:%s", strlen(namespace), namespace, name);
+}
+
+gboolean
+j_db_schema_cache_lookup(JDBSchema* schema)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBSchemaCacheEntry* entry;
+	g_autofree gchar* key = NULL;
+	gboolean ret = FALSE;
+
+	g_return_val_if_fail(schema != NULL, FALSE);
+
+	key = j_db_schema_cache_key(schema->namespace, schema->name);
+
+	G_LOCK(j_db_schema_cache);
+
+	if (j_db_schema_cache != NULL && (entry = g_hash_table_lookup(j_db_schema_cache, key)) != NULL)
+	{
+		bson_destroy(&schema->bson);
+		bson_copy_to(&entry->bson, &schema->bson);
+		schema->cache_version = entry->version;
+		ret = TRUE;
+	}
+
+	G_UNLOCK(j_db_schema_cache);
+
+	return ret;
+}
+
+void
+j_db_schema_cache_insert(JDBSchema* schema)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBSchemaCacheEntry* entry;
+
+	g_return_if_fail(schema != NULL);
+
+	// Schemas that could not be fetched are left empty
+	if (bson_empty(&schema->bson))
+	{
+		return;
+	}
+
+	entry = g_new(JDBSchemaCacheEntry, 1);
+	bson_copy_to(&schema->bson, &entry->bson);
+
+	G_LOCK(j_db_schema_cache);
+
+	if (j_db_schema_cache == NULL)
+	{
+		j_db_schema_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, j_db_schema_cache_entry_free);
+	}
+
+	entry->version = ++j_db_schema_cache_version;
+	schema->cache_version = entry->version;
+	g_hash_table_insert(j_db_schema_cache, j_db_schema_cache_key(schema->namespace, schema->name), entry);
+
+	G_UNLOCK(j_db_schema_cache);
+}
+
+void
+j_db_schema_cache_invalidate(gchar const* namespace, gchar const* name, guint64 version)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBSchemaCacheEntry* entry;
+	g_autofree gchar* key = NULL;
+
+	g_return_if_fail(namespace != NULL);
+	g_return_if_fail(name != NULL);
+
+	key = j_db_schema_cache_key(namespace, name);
+
+	G_LOCK(j_db_schema_cache);
+
+	if (j_db_schema_cache != NULL && (entry = g_hash_table_lookup(j_db_schema_cache, key)) != NULL)
+	{
+		// Do not remove an entry that has been refreshed in the meantime
+		if (version == 0 || entry->version == version)
+		{
+			g_hash_table_remove(j_db_schema_cache, key);
+		}
+	}
+
+	G_UNLOCK(j_db_schema_cache);
+}
+
+void
+j_db_schema_cache_fini(void)
+{
+	G_LOCK(j_db_schema_cache);
+
+	if (j_db_schema_cache != NULL)
+	{
+		g_hash_table_unref(j_db_schema_cache);
+		j_db_schema_cache = NULL;
+	}
+
+	G_UNLOCK(j_db_schema_cache);
+}
+
 JDBSchema*
 j_db_schema_new(gchar const* namespace, gchar const* name, GError** error)
 {
@@ -52,6 +195,7 @@ j_db_schema_new(gchar const* namespace, gchar const* name, GError** error)
 	schema->index = g_array_new(FALSE, FALSE, sizeof(JDBSchemaIndex));
 	schema->bson_initialized = FALSE;
 	schema->bson_index_initialized = FALSE;
+	schema->cache_version = 0;
 	schema->ref_count = 1;
 	schema->server_side = FALSE;
 	/// \todo since schema->bson is used as the out_param in j_db_internal_schema_get, the schema passed to the backend's schema_get is initialized if and only if the backend runs on the client
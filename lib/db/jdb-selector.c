@@ -50,10 +50,20 @@ j_db_selector_new(JDBSchema* schema, JDBSelectorMode mode, GError** error)
 	selector->join_schema = NULL;
 	selector->schema = j_db_schema_ref(schema);
 	selector->final_valid = FALSE;
+	selector->aggregated = FALSE;
+	selector->aggregate = J_DB_AGGREGATE_COUNT;
+	selector->aggregate_field = NULL;
+	selector->aggregate_group = NULL;
+	selector->parameters = g_array_new(FALSE, FALSE, sizeof(JDBType));
+	selector->arguments = g_ptr_array_new_with_free_func(g_free);
+	selector->template_valid = FALSE;
+	selector->handle = 0;
+	selector->registered = FALSE;
 
 	bson_init(&selector->selection);
 	bson_init(&selector->joins);
 	bson_init(&selector->final);
+	bson_init(&selector->template);
 
 	selector->join_schema = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	g_hash_table_add(selector->join_schema, g_strdup(schema->name));
@@ -99,24 +109,78 @@ j_db_selector_unref(JDBSelector* selector)
 		bson_destroy(&selector->selection);
 		bson_destroy(&selector->joins);
 		bson_destroy(&selector->final);
+		bson_destroy(&selector->template);
+		g_free(selector->aggregate_field);
+		g_free(selector->aggregate_group);
+		g_array_unref(selector->parameters);
+		g_ptr_array_unref(selector->arguments);
 		// Free Selector.
 		g_free(selector);
 	}
 }
 
-gboolean
-j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, gconstpointer value, guint64 length, GError** error)
+/**
+ * \brief Convert a value given by the user.
+ *
+ * \param type The type of the field.
+ * \param value The value.
+ * \param length The length of the value. Only used if value is binary.
+ * \param[out] val The converted value. Strings and blobs point to value.
+ */
+static void
+j_db_selector_value(JDBType type, gconstpointer value, guint64 length, JDBTypeValue* val)
 {
-	J_TRACE_FUNCTION(NULL);
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			val->val_sint32 = *(gint32 const*)value;
+			break;
+		case J_DB_TYPE_UINT32:
+			val->val_uint32 = *(guint32 const*)value;
+			break;
+		case J_DB_TYPE_FLOAT32:
+			val->val_float32 = *(gfloat const*)value;
+			break;
+		case J_DB_TYPE_SINT64:
+			val->val_sint64 = *(gint64 const*)value;
+			break;
+		case J_DB_TYPE_UINT64:
+			val->val_sint64 = *(gint64 const*)value;
+			break;
+		case J_DB_TYPE_FLOAT64:
+			val->val_float64 = *(gdouble const*)value;
+			break;
+		case J_DB_TYPE_STRING:
+			val->val_string = value;
+			break;
+		case J_DB_TYPE_BLOB:
+			val->val_blob = value;
+			val->val_blob_length = length;
+			break;
+		case J_DB_TYPE_ID:
+		default:
+			g_assert_not_reached();
+	}
+}
 
+/**
+ * \brief Append a search field to the selection.
+ *
+ * \param selector The selector.
+ * \param name The name of the field.
+ * \param operator_ The operator.
+ * \param type The type of the value.
+ * \param key Either "v" if the value is given or "p" if the value is given by a parameter.
+ * \param val The value or the number of the parameter.
+ * \param error A GError.
+ * \return TRUE on success, FALSE otherwise.
+ */
+static gboolean
+j_db_selector_append_field(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, JDBType type, gchar const* key, JDBTypeValue const* value, GError** error)
+{
 	bson_t child;
-
-	JDBType type;
 	JDBTypeValue val;
 
-	g_return_val_if_fail(selector != NULL, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
 	// Current implemntation does not allow more than 500 BSON document elements.
 	if (G_UNLIKELY(selector->selection_count + 1 > 500))
 	{
@@ -124,13 +188,7 @@ j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOpe
 		goto _error;
 	}
 
-	// Extract the type of the requested field.
-	if (G_UNLIKELY(!j_db_schema_get_field(selector->schema, name, &type, error)))
-	{
-		goto _error;
-	}
-
-	// append field as `"name" : {"t" : <table_name>, "o" : <operator>, "v" : <value>}`
+	// append field as `"name" : {"t" : <table_name>, "o" : <operator>, "v" : <value>}` or `"name" : {"t" : <table_name>, "o" : <operator>, "p" : <parameter>}`
 	if (G_UNLIKELY(!j_bson_append_document_begin(&selector->selection, name, &child, error)))
 	{
 		goto _error;
@@ -150,40 +208,8 @@ j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOpe
 		goto _error;
 	}
 
-	switch (type)
-	{
-		case J_DB_TYPE_SINT32:
-			val.val_sint32 = *(gint32 const*)value;
-			break;
-		case J_DB_TYPE_UINT32:
-			val.val_uint32 = *(guint32 const*)value;
-			break;
-		case J_DB_TYPE_FLOAT32:
-			val.val_float32 = *(gfloat const*)value;
-			break;
-		case J_DB_TYPE_SINT64:
-			val.val_sint64 = *(gint64 const*)value;
-			break;
-		case J_DB_TYPE_UINT64:
-			val.val_sint64 = *(gint64 const*)value;
-			break;
-		case J_DB_TYPE_FLOAT64:
-			val.val_float64 = *(gdouble const*)value;
-			break;
-		case J_DB_TYPE_STRING:
-			val.val_string = value;
-			break;
-		case J_DB_TYPE_BLOB:
-			val.val_blob = value;
-			val.val_blob_length = length;
-			break;
-		case J_DB_TYPE_ID:
-		default:
-			g_assert_not_reached();
-	}
-
 	// Add value.
-	if (G_UNLIKELY(!j_bson_append_value(&child, "v", type, &val, error)))
+	if (G_UNLIKELY(!j_bson_append_value(&child, key, type, value, error)))
 	{
 		goto _error;
 	}
@@ -194,6 +220,8 @@ j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOpe
 	}
 
 	selector->selection_count++;
+	selector->final_valid = FALSE;
+	selector->template_valid = FALSE;
 
 	return TRUE;
 
@@ -201,6 +229,117 @@ _error:
 	return FALSE;
 }
 
+gboolean
+j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, gconstpointer value, guint64 length, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBType type;
+	JDBTypeValue val;
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	// Extract the type of the requested field.
+	if (G_UNLIKELY(!j_db_schema_get_field(selector->schema, name, &type, error)))
+	{
+		goto _error;
+	}
+
+	j_db_selector_value(type, value, length, &val);
+
+	if (G_UNLIKELY(!j_db_selector_append_field(selector, name, operator_, type, "v", &val, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+j_db_selector_add_parameter(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBType type;
+	JDBTypeValue val;
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	// Extract the type of the requested field.
+	if (G_UNLIKELY(!j_db_schema_get_field(selector->schema, name, &type, error)))
+	{
+		goto _error;
+	}
+
+	val.val_uint32 = selector->parameters->len;
+
+	if (G_UNLIKELY(!j_db_selector_append_field(selector, name, operator_, J_DB_TYPE_UINT32, "p", &val, error)))
+	{
+		goto _error;
+	}
+
+	g_array_append_val(selector->parameters, type);
+	g_ptr_array_add(selector->arguments, NULL);
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+j_db_selector_bind(JDBSelector* selector, guint32 index, gconstpointer value, guint64 length, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBType type;
+	JDBTypeValue* val;
+	gsize size = 0;
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(index < selector->parameters->len, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	type = g_array_index(selector->parameters, JDBType, index);
+
+	if (type == J_DB_TYPE_STRING)
+	{
+		size = strlen(value) + 1;
+	}
+	else if (type == J_DB_TYPE_BLOB)
+	{
+		size = length;
+	}
+
+	// strings and blobs are copied directly behind the value
+	val = g_malloc(sizeof(JDBTypeValue) + size);
+	j_db_selector_value(type, value, length, val);
+
+	if (type == J_DB_TYPE_STRING)
+	{
+		val->val_string = memcpy(val + 1, value, size);
+	}
+	else if (type == J_DB_TYPE_BLOB)
+	{
+		val->val_blob = memcpy(val + 1, value, size);
+	}
+
+	g_free(g_ptr_array_index(selector->arguments, index));
+	g_ptr_array_index(selector->arguments, index) = val;
+
+	// the template stays valid
+	selector->final_valid = FALSE;
+
+	return TRUE;
+}
+
 /**
  * \brief Copy join data from a sub selector to a primary selector.
  *
@@ -282,9 +421,11 @@ j_db_selector_add_selector(JDBSelector* selector, JDBSelector* sub_selector, GEr
 	g_return_val_if_fail(selector != sub_selector, FALSE);
 	// if the schemas are different the semantic is not clear anymore (what would be the joining field?)
 	g_return_val_if_fail(selector->schema == sub_selector->schema, FALSE);
+	g_return_val_if_fail(sub_selector->parameters->len == 0, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	selector->final_valid = FALSE;
+	selector->template_valid = FALSE;
 
 	// fetch selections from the sub_selector
 	if (!j_db_selector_add_sub_selection(selector, sub_selector, error))
@@ -318,9 +459,11 @@ j_db_selector_add_join(JDBSelector* selector, gchar const* selector_field, JDBSe
 	g_return_val_if_fail(selector->schema != sub_selector->schema, TRUE);
 	g_return_val_if_fail(selector_field != NULL, FALSE);
 	g_return_val_if_fail(sub_selector_field != NULL, FALSE);
+	g_return_val_if_fail(sub_selector->parameters->len == 0, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	selector->final_valid = FALSE;
+	selector->template_valid = FALSE;
 
 	if (!j_bson_init(&join_entry, error))
 	{
@@ -366,3 +509,72 @@ j_db_selector_add_join(JDBSelector* selector, gchar const* selector_field, JDBSe
 _error:
 	return FALSE;
 }
+
+gboolean
+j_db_selector_set_aggregate(JDBSelector* selector, JDBAggregate aggregate, gchar const* field, gchar const* group_by, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBType field_type = J_DB_TYPE_UINT64;
+	JDBType type;
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(field != NULL || aggregate == J_DB_AGGREGATE_COUNT, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (field != NULL && G_UNLIKELY(!j_db_schema_get_field(selector->schema, field, &field_type, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_aggregate_type(aggregate, field_type, &type)))
+	{
+		g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_TYPE_INVALID, "type invalid");
+		goto _error;
+	}
+
+	// only check that the field exists
+	if (group_by != NULL && G_UNLIKELY(!j_db_schema_get_field(selector->schema, group_by, &type, error)))
+	{
+		goto _error;
+	}
+
+	selector->final_valid = FALSE;
+	selector->template_valid = FALSE;
+
+	g_free(selector->aggregate_field);
+	g_free(selector->aggregate_group);
+
+	selector->aggregated = TRUE;
+	selector->aggregate = aggregate;
+	selector->aggregate_field = g_strdup(field);
+	selector->aggregate_group = g_strdup(group_by);
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+j_db_selector_explain(JDBSelector* selector, gchar** plan, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(selector != NULL, FALSE);
+	g_return_val_if_fail(plan != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	*plan = NULL;
+
+	if (G_UNLIKELY(!j_db_internal_explain(selector, plan, batch, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
@@ -75,6 +75,8 @@ j_db_init(void)
 static void
 j_db_fini(void)
 {
+	j_db_schema_cache_fini();
+
 	if (j_db_backend == NULL && j_db_module == NULL)
 	{
 		return;
@@ -242,12 +242,10 @@ H5VL_julea_db_attr_create(void* obj, const H5VL_loc_params_t* loc_params, const
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(GError) error = NULL;
-	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JDBEntry) entry = NULL;
 	JHDF5Object_t* object = NULL;
 	JHDF5Object_t* parent = obj;
 	JHDF5Object_t* file;
-	gchar dummy[1];
 
 	(void)loc_params;
 	(void)acpl_id;
@@ -280,11 +278,6 @@ H5VL_julea_db_attr_create(void* obj, const H5VL_loc_params_t* loc_params, const
 			j_goto_error();
 	}
 
-	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
-	{
-		j_goto_error();
-	}
-
 	if (!(object = H5VL_julea_db_object_new(J_HDF5_OBJECT_TYPE_ATTR)))
 	{
 		j_goto_error();
@@ -330,27 +323,8 @@ H5VL_julea_db_attr_create(void* obj, const H5VL_loc_params_t* loc_params, const
 		j_goto_error();
 	}
 
-	if (!j_db_entry_set_field(entry, "data", dummy, 0, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_entry_insert(entry, batch, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_batch_execute(batch))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_entry_get_id(entry, &object->backend_id, &object->backend_id_len, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!H5VL_julea_db_link_create_helper(parent, object, name))
+	// the data is set by the first write, the ID and the link are only known once the metadata has been flushed
+	if (!H5VL_julea_db_metadata_attr_insert(parent, object, entry, &error))
 	{
 		j_goto_error();
 	}
@@ -370,17 +344,9 @@ H5VL_julea_db_attr_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(GError) error = NULL;
-	g_autoptr(JBatch) batch = NULL;
-	g_autoptr(JDBIterator) iterator = NULL;
-	g_autoptr(JDBSelector) selector = NULL;
-	g_autofree void* space_id_buf = NULL;
-	g_autofree void* datatype_id_buf = NULL;
 	JHDF5Object_t* object = NULL;
 	JHDF5Object_t* parent = obj;
 	JHDF5Object_t* file;
-	JDBType type;
-	guint64 space_id_buf_len;
-	guint64 datatype_id_buf_len;
 
 	(void)loc_params;
 	(void)aapl_id;
@@ -412,11 +378,6 @@ H5VL_julea_db_attr_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 			j_goto_error();
 	}
 
-	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
-	{
-		j_goto_error();
-	}
-
 	if (!(object = H5VL_julea_db_object_new(J_HDF5_OBJECT_TYPE_ATTR)))
 	{
 		j_goto_error();
@@ -437,48 +398,12 @@ H5VL_julea_db_attr_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 		j_goto_error();
 	}
 
-	if (!(selector = j_db_selector_new(julea_db_schema_attr, J_DB_SELECTOR_MODE_AND, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(selector, "_id", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, &error))
+	// fetches all attributes of parent on first access
+	if (!H5VL_julea_db_metadata_attr_get(parent->type == J_HDF5_OBJECT_TYPE_FILE ? parent->file.root_group : parent, object))
 	{
 		j_goto_error();
 	}
 
-	if (!(iterator = j_db_iterator_new(julea_db_schema_attr, selector, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_iterator_next(iterator, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_iterator_get_field(iterator, NULL, "space", &type, &space_id_buf, &space_id_buf_len, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!(object->attr.space = H5VL_julea_db_space_decode(space_id_buf, space_id_buf_len)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_iterator_get_field(iterator, NULL, "datatype", &type, &datatype_id_buf, &datatype_id_buf_len, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!(object->attr.datatype = H5VL_julea_db_datatype_decode(datatype_id_buf, datatype_id_buf_len)))
-	{
-		j_goto_error();
-	}
-
-	g_assert(!j_db_iterator_next(iterator, NULL));
-
 	return object;
 
 _error:
@@ -514,6 +439,22 @@ H5VL_julea_db_attr_read(void* obj, hid_t mem_type_id, void* buf, hid_t dxpl_id,
 	data_size = object->dataset.datatype->datatype.type_total_size;
 	data_size *= object->attr.space->space.dim_total_count;
 
+	// new attributes are cached once they have been inserted
+	if (object->backend_id == NULL && !H5VL_julea_db_metadata_flush(object))
+	{
+		j_goto_error();
+	}
+
+	if (H5VL_julea_db_metadata_attr_read(object, buf, data_size))
+	{
+		return 0;
+	}
+
+	if (!H5VL_julea_db_metadata_flush(object))
+	{
+		j_goto_error();
+	}
+
 	if (!(selector = j_db_selector_new(julea_db_schema_attr, J_DB_SELECTOR_MODE_AND, &error)))
 	{
 		j_goto_error();
@@ -556,7 +497,6 @@ H5VL_julea_db_attr_write(void* obj, hid_t mem_type_id, const void* buf, hid_t dx
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(GError) error = NULL;
-	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JDBEntry) entry = NULL;
 	g_autoptr(JDBSelector) selector = NULL;
 	gsize data_size;
@@ -569,10 +509,30 @@ H5VL_julea_db_attr_write(void* obj, hid_t mem_type_id, const void* buf, hid_t dx
 	g_return_val_if_fail(buf != NULL, 1);
 	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_ATTR, 1);
 
-	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
 	data_size = object->dataset.datatype->datatype.type_total_size;
 	data_size *= object->attr.space->space.dim_total_count;
 
+	if (object->backend_id == NULL)
+	{
+		gboolean written;
+
+		// the first write of a new attribute is part of its insert
+		if (!H5VL_julea_db_metadata_attr_write_pending(object, buf, data_size, &written, &error))
+		{
+			j_goto_error();
+		}
+
+		if (written)
+		{
+			return 0;
+		}
+
+		if (!H5VL_julea_db_metadata_flush(object))
+		{
+			j_goto_error();
+		}
+	}
+
 	if (!(selector = j_db_selector_new(julea_db_schema_attr, J_DB_SELECTOR_MODE_AND, &error)))
 	{
 		j_goto_error();
@@ -608,15 +568,13 @@ H5VL_julea_db_attr_write(void* obj, hid_t mem_type_id, const void* buf, hid_t dx
 		j_goto_error();
 	}
 
-	if (!j_db_entry_update(entry, selector, batch, &error))
+	// the update is written together with other pending metadata
+	if (!H5VL_julea_db_metadata_update(object, entry, selector, &error))
 	{
 		j_goto_error();
 	}
 
-	if (!j_batch_execute(batch))
-	{
-		j_goto_error();
-	}
+	H5VL_julea_db_metadata_attr_set(object, buf, data_size);
 
 	return 0;
 
@@ -720,7 +678,10 @@ H5VL_julea_db_attr_close(void* obj, hid_t dxpl_id, void** req)
 
 	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_ATTR, 1);
 
-	H5VL_julea_db_object_unref(object);
+	if (!H5VL_julea_db_object_unref(object))
+	{
+		return 1;
+	}
 
 	return 0;
 }
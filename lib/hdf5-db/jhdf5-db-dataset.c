@@ -43,12 +43,19 @@
 #include "jhdf5-db.h"
 
 JDBSchema* julea_db_schema_dataset = NULL;
+JDBSchema* julea_db_schema_chunk = NULL;
 
 herr_t
 H5VL_julea_db_dataset_term(void)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	if (julea_db_schema_chunk != NULL)
+	{
+		j_db_schema_unref(julea_db_schema_chunk);
+		julea_db_schema_chunk = NULL;
+	}
+
 	if (julea_db_schema_dataset != NULL)
 	{
 		j_db_schema_unref(julea_db_schema_dataset);
@@ -58,142 +65,182 @@ H5VL_julea_db_dataset_term(void)
 	return 0;
 }
 
-herr_t
-H5VL_julea_db_dataset_init(hid_t vipl_id)
+/**
+ * Chunks of chunked datasets are stored as separate objects.
+ * The chunk schema records which chunks have been written, which allows reads to skip chunks that do not exist yet.
+ * It also stores a zone map per chunk, that is, the range of values within the chunk, which allows queries to skip chunks.
+ **/
+static gboolean
+H5VL_julea_db_dataset_chunk_define(JDBSchema* schema, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_autoptr(JBatch) batch = NULL;
-	g_autoptr(GError) error = NULL;
+	if (!j_db_schema_add_field(schema, "file", J_DB_TYPE_ID, error))
+	{
+		return FALSE;
+	}
 
-	(void)vipl_id;
+	if (!j_db_schema_add_field(schema, "dataset", J_DB_TYPE_ID, error))
+	{
+		return FALSE;
+	}
 
-	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
+	if (!j_db_schema_add_field(schema, "index", J_DB_TYPE_UINT64, error))
 	{
-		j_goto_error();
+		return FALSE;
 	}
 
-	if (!(julea_db_schema_dataset = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, "dataset", NULL)))
+	if (!j_db_schema_add_field(schema, "size", J_DB_TYPE_UINT64, error))
 	{
-		j_goto_error();
+		return FALSE;
+	}
+
+	if (!j_db_schema_add_field(schema, "min_value_i", J_DB_TYPE_SINT64, error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_schema_add_field(schema, "max_value_i", J_DB_TYPE_SINT64, error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_schema_add_field(schema, "min_value_f", J_DB_TYPE_FLOAT64, error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_schema_add_field(schema, "max_value_f", J_DB_TYPE_FLOAT64, error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_schema_add_field(schema, "count", J_DB_TYPE_UINT64, error))
+	{
+		return FALSE;
 	}
 
-	if (!(j_db_schema_get(julea_db_schema_dataset, batch, &error) && j_batch_execute(batch)))
 	{
-		if (error)
+		const gchar* index[] = {
+			"dataset",
+			"index",
+			NULL,
+		};
+
+		if (!j_db_schema_add_index(schema, index, error))
 		{
-			if (error->code == J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND)
-			{
-				g_error_free(error);
-				error = NULL;
+			return FALSE;
+		}
+	}
 
-				if (julea_db_schema_dataset)
-				{
-					j_db_schema_unref(julea_db_schema_dataset);
-				}
+	{
+		const gchar* index[] = {
+			"file",
+			NULL,
+		};
 
-				if (!(julea_db_schema_dataset = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, "dataset", NULL)))
-				{
-					j_goto_error();
-				}
+		if (!j_db_schema_add_index(schema, index, error))
+		{
+			return FALSE;
+		}
+	}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "file", J_DB_TYPE_ID, &error))
-				{
-					j_goto_error();
-				}
+	return TRUE;
+}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "datatype", J_DB_TYPE_ID, &error))
-				{
-					j_goto_error();
-				}
+static gboolean
+H5VL_julea_db_dataset_define(JDBSchema* schema, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "space", J_DB_TYPE_ID, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "file", J_DB_TYPE_ID, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "min_value_f", J_DB_TYPE_FLOAT64, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "datatype", J_DB_TYPE_ID, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "max_value_f", J_DB_TYPE_FLOAT64, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "space", J_DB_TYPE_ID, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "min_value_i", J_DB_TYPE_SINT64, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "min_value_f", J_DB_TYPE_FLOAT64, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_db_schema_add_field(julea_db_schema_dataset, "max_value_i", J_DB_TYPE_SINT64, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "max_value_f", J_DB_TYPE_FLOAT64, error))
+	{
+		return FALSE;
+	}
 
-				{
-					const gchar* index[] = {
-						"file",
-						NULL,
-					};
+	if (!j_db_schema_add_field(schema, "min_value_i", J_DB_TYPE_SINT64, error))
+	{
+		return FALSE;
+	}
 
-					if (!j_db_schema_add_index(julea_db_schema_dataset, index, &error))
-					{
-						j_goto_error();
-					}
-				}
+	if (!j_db_schema_add_field(schema, "max_value_i", J_DB_TYPE_SINT64, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_db_schema_create(julea_db_schema_dataset, batch, &error))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "layout", J_DB_TYPE_UINT32, error))
+	{
+		return FALSE;
+	}
 
-				if (!j_batch_execute(batch))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "chunk", J_DB_TYPE_BLOB, error))
+	{
+		return FALSE;
+	}
 
-				if (julea_db_schema_dataset)
-				{
-					j_db_schema_unref(julea_db_schema_dataset);
-				}
+	if (!j_db_schema_add_field(schema, "filter", J_DB_TYPE_BLOB, error))
+	{
+		return FALSE;
+	}
 
-				if (!(julea_db_schema_dataset = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, "dataset", NULL)))
-				{
-					j_goto_error();
-				}
+	if (!j_db_schema_add_field(schema, "fill", J_DB_TYPE_BLOB, error))
+	{
+		return FALSE;
+	}
 
-				/// \todo Use same key type for every db backend to remove get for every new schema.
-				if (!j_db_schema_get(julea_db_schema_dataset, batch, &error))
-				{
-					j_goto_error();
-				}
+	{
+		const gchar* index[] = {
+			"file",
+			NULL,
+		};
 
-				if (!j_batch_execute(batch))
-				{
-					j_goto_error();
-				}
-			}
-			else
-			{
-				g_assert_not_reached();
-				j_goto_error();
-			}
-		}
-		else
+		if (!j_db_schema_add_index(schema, index, error))
 		{
-			g_assert_not_reached();
-			j_goto_error();
+			return FALSE;
 		}
 	}
 
-	return 0;
+	return TRUE;
+}
 
-_error:
-	H5VL_julea_db_error_handler(error);
+herr_t
+H5VL_julea_db_dataset_init(hid_t vipl_id)
+{
+	J_TRACE_FUNCTION(NULL);
 
-	return 1;
+	(void)vipl_id;
+
+	if (H5VL_julea_db_schema_init("dataset", H5VL_julea_db_dataset_define, &julea_db_schema_dataset))
+	{
+		return 1;
+	}
+
+	if (H5VL_julea_db_schema_init("chunk", H5VL_julea_db_dataset_chunk_define, &julea_db_schema_chunk))
+	{
+		return 1;
+	}
+
+	return 0;
 }
 
 herr_t
@@ -243,6 +290,38 @@ H5VL_julea_db_dataset_truncate_file(void* obj)
 		}
 	}
 
+	g_clear_error(&error);
+	j_db_selector_unref(selector);
+	j_db_entry_unref(entry);
+
+	if (!(selector = j_db_selector_new(julea_db_schema_chunk, J_DB_SELECTOR_MODE_AND, &error)))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_selector_add_field(selector, "file", J_DB_SELECTOR_OPERATOR_EQ, file->backend_id, file->backend_id_len, &error))
+	{
+		j_goto_error();
+	}
+
+	if (!(entry = j_db_entry_new(julea_db_schema_chunk, &error)))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_delete(entry, selector, batch, &error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_batch_execute(batch))
+	{
+		if (!error || error->code != J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS)
+		{
+			j_goto_error();
+		}
+	}
+
 	return 0;
 
 _error:
@@ -251,6 +330,60 @@ _error:
 	return 1;
 }
 
+static gboolean
+H5VL_julea_db_dataset_fill_is_zero(gconstpointer fill, gsize length)
+{
+	guchar const* bytes = fill;
+
+	for (gsize i = 0; i < length; i++)
+	{
+		if (bytes[i] != 0)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Determines the fill value of a chunked dataset.
+ * Fill values consisting of zero bytes are not kept because unwritten elements are zero anyway.
+ **/
+static gboolean
+H5VL_julea_db_dataset_fill_from_dcpl(JHDF5Object_t* object, hid_t dcpl_id, hid_t type_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gchar* fill = NULL;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	H5D_fill_value_t status;
+
+	if (H5Pfill_value_defined(dcpl_id, &status) < 0)
+	{
+		return FALSE;
+	}
+
+	if (status != H5D_FILL_VALUE_USER_DEFINED)
+	{
+		return TRUE;
+	}
+
+	fill = g_malloc(data_size);
+
+	if (H5Pget_fill_value(dcpl_id, type_id, fill) < 0)
+	{
+		return FALSE;
+	}
+
+	if (!H5VL_julea_db_dataset_fill_is_zero(fill, data_size))
+	{
+		object->dataset.chunk.fill = g_steal_pointer(&fill);
+	}
+
+	return TRUE;
+}
+
 void*
 H5VL_julea_db_dataset_create(void* obj, const H5VL_loc_params_t* loc_params, const char* name, hid_t lcpl_id, hid_t type_id, hid_t space_id, hid_t dcpl_id, hid_t dapl_id, hid_t dxpl_id, void** req)
 {
@@ -263,10 +396,14 @@ H5VL_julea_db_dataset_create(void* obj, const H5VL_loc_params_t* loc_params, con
 	JHDF5Object_t* object = NULL;
 	JHDF5Object_t* parent = obj;
 	JHDF5Object_t* file;
+	g_autoptr(GArray) filters = NULL;
+	hsize_t no_chunk = 0;
+	JHDF5Filter no_filter = { H5Z_FILTER_NONE, 0 };
+	guint64 no_fill = 0;
+	guint32 layout = H5D_CONTIGUOUS;
 
 	(void)loc_params;
 	(void)lcpl_id;
-	(void)dcpl_id;
 	(void)dapl_id;
 	(void)dxpl_id;
 	(void)req;
@@ -310,6 +447,7 @@ H5VL_julea_db_dataset_create(void* obj, const H5VL_loc_params_t* loc_params, con
 	object->dataset.statistics.max_value_i = 0;
 	object->dataset.statistics.min_value_f = 0;
 	object->dataset.statistics.max_value_f = 0;
+	object->dataset.statistics.count = 0;
 
 	if (!(object->dataset.name = g_strdup(name)))
 	{
@@ -331,68 +469,172 @@ H5VL_julea_db_dataset_create(void* obj, const H5VL_loc_params_t* loc_params, con
 		j_goto_error();
 	}
 
-	if (!(entry = j_db_entry_new(julea_db_schema_dataset, &error)))
+	if (dcpl_id != H5P_DEFAULT && H5Pget_layout(dcpl_id) == H5D_CHUNKED)
 	{
-		j_goto_error();
-	}
+		gint ndims;
 
-	if (!j_db_entry_set_field(entry, "file", file->backend_id, file->backend_id_len, &error))
-	{
-		j_goto_error();
-	}
+		if ((ndims = H5Pget_chunk(dcpl_id, 0, NULL)) <= 0)
+		{
+			j_goto_error();
+		}
 
-	if (!j_db_entry_set_field(entry, "datatype", object->dataset.datatype->backend_id, object->dataset.datatype->backend_id_len, &error))
-	{
-		j_goto_error();
-	}
+		if (ndims != H5Sget_simple_extent_ndims(space_id))
+		{
+			g_debug("%s: Chunk rank does not match dataspace rank!", G_STRFUNC);
+			j_goto_error();
+		}
 
-	if (!j_db_entry_set_field(entry, "space", object->dataset.space->backend_id, object->dataset.space->backend_id_len, &error))
-	{
-		j_goto_error();
+		object->dataset.chunk.ndims = ndims;
+		object->dataset.chunk.dims = g_new(hsize_t, ndims);
+		object->dataset.chunk.stored = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, g_free);
+
+		if (H5Pget_chunk(dcpl_id, ndims, object->dataset.chunk.dims) < 0)
+		{
+			j_goto_error();
+		}
+
+		filters = g_array_new(FALSE, FALSE, sizeof(JHDF5Filter));
+
+		if (!H5VL_julea_db_filter_from_dcpl(dcpl_id, filters))
+		{
+			j_goto_error();
+		}
+
+		object->dataset.filter.count = filters->len;
+		object->dataset.filter.list = (JHDF5Filter*)(void*)g_array_free(g_steal_pointer(&filters), FALSE);
+
+		if (!H5VL_julea_db_dataset_fill_from_dcpl(object, dcpl_id, type_id))
+		{
+			j_goto_error();
+		}
+
+		layout = H5D_CHUNKED;
 	}
 
-	if (!j_db_entry_insert(entry, batch, &error))
+	if (!(entry = j_db_entry_new(julea_db_schema_dataset, &error)))
 	{
 		j_goto_error();
 	}
 
-	if (!j_batch_execute(batch))
+	if (!j_db_entry_set_field(entry, "file", file->backend_id, file->backend_id_len, &error))
 	{
 		j_goto_error();
 	}
 
-	if (!j_db_entry_get_id(entry, &object->backend_id, &object->backend_id_len, &error))
+	if (!j_db_entry_set_field(entry, "datatype", object->dataset.datatype->backend_id, object->dataset.datatype->backend_id_len, &error))
 	{
 		j_goto_error();
 	}
 
-	if (!(object->dataset.distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN)))
+	if (!j_db_entry_set_field(entry, "space", object->dataset.space->backend_id, object->dataset.space->backend_id_len, &error))
 	{
 		j_goto_error();
 	}
 
-	if (!(hex_buf = H5VL_julea_db_buf_to_hex("dataset", object->backend_id, object->backend_id_len)))
+	if (!j_db_entry_set_field(entry, "layout", &layout, sizeof(layout), &error))
 	{
 		j_goto_error();
 	}
 
-	if (!(object->dataset.object = j_distributed_object_new(JULEA_HDF5_DB_NAMESPACE, hex_buf, object->dataset.distribution)))
+	// contiguous datasets and datasets without filters store placeholders
+	if (layout == H5D_CHUNKED)
 	{
-		j_goto_error();
+		if (!j_db_entry_set_field(entry, "chunk", object->dataset.chunk.dims, object->dataset.chunk.ndims * sizeof(hsize_t), &error))
+		{
+			j_goto_error();
+		}
 	}
-
-	j_distributed_object_create(object->dataset.object, batch);
-
+	else
 	{
-		if (!j_batch_execute(batch))
+		if (!j_db_entry_set_field(entry, "chunk", &no_chunk, sizeof(no_chunk), &error))
 		{
 			j_goto_error();
 		}
 	}
 
-	if (!H5VL_julea_db_link_create_helper(parent, object, name))
+	if (object->dataset.filter.count > 0)
 	{
-		j_goto_error();
+		if (!j_db_entry_set_field(entry, "filter", object->dataset.filter.list, object->dataset.filter.count * sizeof(JHDF5Filter), &error))
+		{
+			j_goto_error();
+		}
+	}
+	else
+	{
+		if (!j_db_entry_set_field(entry, "filter", &no_filter, sizeof(no_filter), &error))
+		{
+			j_goto_error();
+		}
+	}
+
+	if (object->dataset.chunk.fill != NULL)
+	{
+		if (!j_db_entry_set_field(entry, "fill", object->dataset.chunk.fill, object->dataset.datatype->datatype.type_total_size, &error))
+		{
+			j_goto_error();
+		}
+	}
+	else
+	{
+		if (!j_db_entry_set_field(entry, "fill", &no_fill, sizeof(no_fill), &error))
+		{
+			j_goto_error();
+		}
+	}
+
+	if (!j_db_entry_insert(entry, batch, &error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_batch_execute(batch))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_get_id(entry, &object->backend_id, &object->backend_id_len, &error))
+	{
+		j_goto_error();
+	}
+
+	// chunks are created on demand when they are first written
+	if (layout == H5D_CHUNKED)
+	{
+		if (!H5VL_julea_db_link_create_helper(parent, object, name))
+		{
+			j_goto_error();
+		}
+
+		return object;
+	}
+
+	if (!(object->dataset.distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN)))
+	{
+		j_goto_error();
+	}
+
+	if (!(hex_buf = H5VL_julea_db_buf_to_hex("dataset", object->backend_id, object->backend_id_len)))
+	{
+		j_goto_error();
+	}
+
+	if (!(object->dataset.object = j_distributed_object_new(JULEA_HDF5_DB_NAMESPACE, hex_buf, object->dataset.distribution)))
+	{
+		j_goto_error();
+	}
+
+	j_distributed_object_create(object->dataset.object, batch);
+
+	{
+		if (!j_batch_execute(batch))
+		{
+			j_goto_error();
+		}
+	}
+
+	if (!H5VL_julea_db_link_create_helper(parent, object, name))
+	{
+		j_goto_error();
 	}
 
 	return object;
@@ -404,6 +646,118 @@ _error:
 	return NULL;
 }
 
+/**
+ * Adds the chunks matching the selector to the stored chunks.
+ * Chunks that are already known are kept, because they may have been updated by writes that have not been executed yet.
+ **/
+static gboolean
+H5VL_julea_db_dataset_chunk_query(JHDF5Object_t* object, JDBSelector* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JDBIterator) iterator = NULL;
+	JDBType type;
+	guint64 len;
+
+	if (!(iterator = j_db_iterator_new(julea_db_schema_chunk, selector, error)))
+	{
+		j_goto_error();
+	}
+
+	while (j_db_iterator_next(iterator, NULL))
+	{
+		g_autofree guint64* size = NULL;
+		g_autofree guint64* count = NULL;
+		g_autofree gint64* min_value_i = NULL;
+		g_autofree gint64* max_value_i = NULL;
+		g_autofree gdouble* min_value_f = NULL;
+		g_autofree gdouble* max_value_f = NULL;
+		guint64* index;
+		JHDF5Chunk* chunk;
+
+		if (!j_db_iterator_get_field(iterator, NULL, "size", &type, (gpointer*)&size, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "min_value_i", &type, (gpointer*)&min_value_i, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "max_value_i", &type, (gpointer*)&max_value_i, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "min_value_f", &type, (gpointer*)&min_value_f, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "max_value_f", &type, (gpointer*)&max_value_f, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "count", &type, (gpointer*)&count, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "index", &type, (gpointer*)&index, &len, error))
+		{
+			j_goto_error();
+		}
+
+		if (g_hash_table_contains(object->dataset.chunk.stored, index))
+		{
+			g_free(index);
+			continue;
+		}
+
+		chunk = g_new(JHDF5Chunk, 1);
+		chunk->size = *size;
+		chunk->statistics.min_value_i = *min_value_i;
+		chunk->statistics.max_value_i = *max_value_i;
+		chunk->statistics.min_value_f = *min_value_f;
+		chunk->statistics.max_value_f = *max_value_f;
+		chunk->statistics.count = *count;
+
+		g_hash_table_insert(object->dataset.chunk.stored, index, chunk);
+	}
+
+	return true;
+
+_error:
+	return false;
+}
+
+static gboolean
+H5VL_julea_db_dataset_chunk_load(JHDF5Object_t* object, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JDBSelector) selector = NULL;
+
+	object->dataset.chunk.stored = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, g_free);
+
+	if (!(selector = j_db_selector_new(julea_db_schema_chunk, J_DB_SELECTOR_MODE_AND, error)))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_selector_add_field(selector, "dataset", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, error))
+	{
+		j_goto_error();
+	}
+
+	return H5VL_julea_db_dataset_chunk_query(object, selector, error);
+
+_error:
+	return false;
+}
+
 gboolean
 H5VL_julea_db_dataset_set_info(JHDF5Object_t* object, GError** error)
 {
@@ -415,8 +769,15 @@ H5VL_julea_db_dataset_set_info(JHDF5Object_t* object, GError** error)
 	g_autofree char* hex_buf = NULL;
 	g_autofree void* space_id_buf = NULL;
 	g_autofree void* datatype_id_buf = NULL;
+	g_autofree guint32* layout = NULL;
+	g_autofree hsize_t* chunk_dims = NULL;
+	g_autofree JHDF5Filter* filters = NULL;
+	g_autofree gpointer fill = NULL;
 	JDBType type;
 	guint64 len;
+	guint64 chunk_dims_len;
+	guint64 filters_len;
+	guint64 fill_len;
 	guint64 space_id_buf_len;
 	guint64 datatype_id_buf_len;
 	guint64* tmp_ptr_i;
@@ -499,8 +860,48 @@ H5VL_julea_db_dataset_set_info(JHDF5Object_t* object, GError** error)
 		j_goto_error();
 	}
 
+	if (!j_db_iterator_get_field(iterator, NULL, "layout", &type, (gpointer*)&layout, &len, error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_iterator_get_field(iterator, NULL, "chunk", &type, (gpointer*)&chunk_dims, &chunk_dims_len, error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_iterator_get_field(iterator, NULL, "filter", &type, (gpointer*)&filters, &filters_len, error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_iterator_get_field(iterator, NULL, "fill", &type, &fill, &fill_len, error))
+	{
+		j_goto_error();
+	}
+
 	g_assert(!j_db_iterator_next(iterator, NULL));
 
+	if (*layout == H5D_CHUNKED)
+	{
+		object->dataset.chunk.ndims = chunk_dims_len / sizeof(hsize_t);
+		object->dataset.chunk.dims = g_steal_pointer(&chunk_dims);
+
+		if (filters_len >= sizeof(JHDF5Filter) && filters[0].id != H5Z_FILTER_NONE)
+		{
+			object->dataset.filter.count = filters_len / sizeof(JHDF5Filter);
+			object->dataset.filter.list = g_steal_pointer(&filters);
+		}
+
+		// placeholders consist of zero bytes
+		if (fill_len == object->dataset.datatype->datatype.type_total_size && !H5VL_julea_db_dataset_fill_is_zero(fill, fill_len))
+		{
+			object->dataset.chunk.fill = g_steal_pointer(&fill);
+		}
+
+		return H5VL_julea_db_dataset_chunk_load(object, error);
+	}
+
 	if (!(object->dataset.distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN)))
 	{
 		j_goto_error();
@@ -839,296 +1240,1943 @@ _error:
 	return NULL;
 }
 
-#define calculate_statistics_helper(_buf, _target_extension) \
-	do \
-	{ \
-		for (i = 0; i < n; i++) \
-		{ \
-			if (_buf < object->dataset.statistics.min_value##_target_extension) \
-				object->dataset.statistics.min_value##_target_extension = _buf; \
-			if (_buf > object->dataset.statistics.max_value##_target_extension) \
-				object->dataset.statistics.max_value##_target_extension = _buf; \
-		} \
-	} while (0)
-
 static void
-calculate_statistics(JHDF5Object_t* object, const void* buf, gsize bytes, hid_t memory_type)
+calculate_statistics(JHDF5Object_t* object, const void* buf, gsize bytes, hid_t type_id)
+{
+	JHDF5Statistics statistics;
+
+	H5VL_julea_db_statistics_init(&statistics);
+	H5VL_julea_db_statistics_compute(H5VL_julea_db_statistics_kind(type_id), buf, bytes / H5Tget_size(type_id), &statistics);
+	H5VL_julea_db_statistics_merge(&object->dataset.statistics, &statistics);
+}
+
+struct JHDF5ChunkPiece
+{
+	/// linear index of the chunk
+	guint64 chunk;
+	/// element offset within the chunk
+	guint64 offset;
+	/// element offset within the memory buffer
+	guint64 mem;
+	guint64 length;
+};
+
+typedef struct JHDF5ChunkPiece JHDF5ChunkPiece;
+
+struct JHDF5ChunkGather
+{
+	gchar* buf;
+	guint first;
+	guint last;
+};
+
+typedef struct JHDF5ChunkGather JHDF5ChunkGather;
+
+static gint
+H5VL_julea_db_dataset_chunk_piece_compare(gconstpointer a, gconstpointer b)
+{
+	JHDF5ChunkPiece const* piece_a = a;
+	JHDF5ChunkPiece const* piece_b = b;
+
+	if (piece_a->chunk != piece_b->chunk)
+	{
+		return (piece_a->chunk < piece_b->chunk) ? -1 : 1;
+	}
+
+	if (piece_a->offset != piece_b->offset)
+	{
+		return (piece_a->offset < piece_b->offset) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Returns the selection of a dataspace as a list of (start, length) element sequences in the order HDF5 pairs memory and file elements.
+ **/
+static GArray*
+H5VL_julea_db_space_to_sequences(hid_t space_id)
 {
+	J_TRACE_FUNCTION(NULL);
+
+	GArray* seq_arr = NULL;
+	hid_t iter = H5I_INVALID_HID;
+	hsize_t off[64];
+	size_t len[64];
+	size_t nseq;
+	size_t nelem;
 	guint i;
-	guint n;
-	guint element_size = H5Tget_size(memory_type);
-	n = bytes / element_size;
 
-	if (H5Tget_class(memory_type) == H5T_FLOAT)
+	seq_arr = g_array_new(FALSE, FALSE, sizeof(JHDF5IndexRange));
+
+	// an element size of 1 makes the returned offsets element indices
+	if ((iter = H5Ssel_iter_create(space_id, 1, 0)) < 0)
+	{
+		j_goto_error();
+	}
+
+	do
 	{
-		if (element_size == 4)
+		if (H5Ssel_iter_get_seq_list(iter, G_N_ELEMENTS(off), SIZE_MAX, &nseq, &nelem, off, len) < 0)
+		{
+			j_goto_error();
+		}
+
+		for (i = 0; i < nseq; i++)
 		{
-			calculate_statistics_helper(((gdouble)((const gfloat*)buf)[i]), _f);
+			JHDF5IndexRange range;
+
+			range.start = off[i];
+			range.stop = off[i] + len[i];
+
+			g_array_append_val(seq_arr, range);
 		}
-		else if (element_size == 8)
+	} while (nseq > 0);
+
+	H5Ssel_iter_close(iter);
+
+	return seq_arr;
+
+_error:
+	if (iter >= 0)
+	{
+		H5Ssel_iter_close(iter);
+	}
+
+	g_array_free(seq_arr, TRUE);
+
+	return NULL;
+}
+
+/**
+ * Maps a selection to the chunks it touches.
+ * The returned pieces never cross a chunk boundary and are sorted by chunk and chunk offset.
+ **/
+static GArray*
+H5VL_julea_db_dataset_chunk_pieces(JHDF5Object_t* object, hid_t mem_space_id, hid_t file_space_id, guint64* mem_extent)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GArray) mem_seq_arr = NULL;
+	g_autoptr(GArray) file_seq_arr = NULL;
+	g_autofree hsize_t* dims = NULL;
+	g_autofree hsize_t* chunk_count = NULL;
+	GArray* piece_arr = NULL;
+	hsize_t const* chunk_dims = object->dataset.chunk.dims;
+	hid_t stored_space_id = object->dataset.space->space.hdf5_id;
+	guint ndims = object->dataset.chunk.ndims;
+	guint mem_idx = 0;
+	guint file_idx = 0;
+	guint64 mem_done = 0;
+	guint64 file_done = 0;
+	hssize_t extent;
+	guint i;
+
+	if (file_space_id == H5S_ALL)
+	{
+		file_space_id = stored_space_id;
+	}
+
+	// H5S_ALL in memory means the file dataspace and selection
+	if (mem_space_id == H5S_ALL)
+	{
+		mem_space_id = file_space_id;
+	}
+
+	if ((guint)H5Sget_simple_extent_ndims(stored_space_id) != ndims)
+	{
+		return NULL;
+	}
+
+	if ((extent = H5Sget_simple_extent_npoints(mem_space_id)) < 0)
+	{
+		return NULL;
+	}
+
+	*mem_extent = extent;
+
+	dims = g_new(hsize_t, ndims);
+	chunk_count = g_new(hsize_t, ndims);
+	H5Sget_simple_extent_dims(stored_space_id, dims, NULL);
+
+	for (i = 0; i < ndims; i++)
+	{
+		chunk_count[i] = (dims[i] + chunk_dims[i] - 1) / chunk_dims[i];
+	}
+
+	if (!(mem_seq_arr = H5VL_julea_db_space_to_sequences(mem_space_id)))
+	{
+		return NULL;
+	}
+
+	if (!(file_seq_arr = H5VL_julea_db_space_to_sequences(file_space_id)))
+	{
+		return NULL;
+	}
+
+	piece_arr = g_array_new(FALSE, FALSE, sizeof(JHDF5ChunkPiece));
+
+	while (mem_idx < mem_seq_arr->len && file_idx < file_seq_arr->len)
+	{
+		JHDF5IndexRange* mem_seq = &g_array_index(mem_seq_arr, JHDF5IndexRange, mem_idx);
+		JHDF5IndexRange* file_seq = &g_array_index(file_seq_arr, JHDF5IndexRange, file_idx);
+		guint64 mem_pos = mem_seq->start + mem_done;
+		guint64 file_pos = file_seq->start + file_done;
+		guint64 count;
+
+		count = MIN(mem_seq->stop - mem_pos, file_seq->stop - file_pos);
+		mem_done += count;
+		file_done += count;
+
+		if (mem_seq->start + mem_done == mem_seq->stop)
 		{
-			calculate_statistics_helper(((const gdouble*)buf)[i], _f);
+			mem_idx++;
+			mem_done = 0;
 		}
+
+		if (file_seq->start + file_done == file_seq->stop)
+		{
+			file_idx++;
+			file_done = 0;
+		}
+
+		// split the sequence wherever it leaves a chunk in the fastest-varying dimension
+		while (count > 0)
+		{
+			JHDF5ChunkPiece piece;
+			guint64 rem = file_pos;
+			guint64 chunk_stride = 1;
+			guint64 offset_stride = 1;
+			guint64 coord_last = 0;
+
+			piece.chunk = 0;
+			piece.offset = 0;
+
+			for (i = ndims; i > 0; i--)
+			{
+				guint64 coord = rem % dims[i - 1];
+
+				rem /= dims[i - 1];
+
+				if (i == ndims)
+				{
+					coord_last = coord;
+				}
+
+				piece.chunk += (coord / chunk_dims[i - 1]) * chunk_stride;
+				piece.offset += (coord % chunk_dims[i - 1]) * offset_stride;
+				chunk_stride *= chunk_count[i - 1];
+				offset_stride *= chunk_dims[i - 1];
+			}
+
+			piece.mem = mem_pos;
+			piece.length = MIN(count, chunk_dims[ndims - 1] - (coord_last % chunk_dims[ndims - 1]));
+			piece.length = MIN(piece.length, dims[ndims - 1] - coord_last);
+
+			file_pos += piece.length;
+			mem_pos += piece.length;
+			count -= piece.length;
+
+			if (piece_arr->len > 0)
+			{
+				JHDF5ChunkPiece* last = &g_array_index(piece_arr, JHDF5ChunkPiece, piece_arr->len - 1);
+
+				if (last->chunk == piece.chunk && last->offset + last->length == piece.offset && last->mem + last->length == piece.mem)
+				{
+					last->length += piece.length;
+					continue;
+				}
+			}
+
+			g_array_append_val(piece_arr, piece);
+		}
+	}
+
+	g_array_sort(piece_arr, H5VL_julea_db_dataset_chunk_piece_compare);
+
+	return piece_arr;
+}
+
+static guint64
+H5VL_julea_db_dataset_chunk_size(JHDF5Object_t* object)
+{
+	guint64 size = object->dataset.datatype->datatype.type_total_size;
+	guint i;
+
+	for (i = 0; i < object->dataset.chunk.ndims; i++)
+	{
+		size *= object->dataset.chunk.dims[i];
+	}
+
+	return size;
+}
+
+static JObject*
+H5VL_julea_db_dataset_chunk_object(JHDF5Object_t* object, guint64 chunk)
+{
+	g_autofree char* hex_buf = NULL;
+	g_autofree char* name = NULL;
+
+	hex_buf = H5VL_julea_db_buf_to_hex("chunk", object->backend_id, object->backend_id_len);
+	name = g_strdup_printf("%s-%" G_GUINT64_FORMAT, hex_buf, chunk);
+
+	return j_object_new(JULEA_HDF5_DB_NAMESPACE, name);
+}
+
+/**
+ * Returns the number of elements of a chunk that lie within the dataset.
+ **/
+static guint64
+H5VL_julea_db_dataset_chunk_elements(JHDF5Object_t* object, guint64 chunk)
+{
+	g_autofree hsize_t* dims = NULL;
+	hsize_t const* chunk_dims = object->dataset.chunk.dims;
+	guint ndims = object->dataset.chunk.ndims;
+	guint64 elements = 1;
+
+	dims = g_new(hsize_t, ndims);
+	H5Sget_simple_extent_dims(object->dataset.space->space.hdf5_id, dims, NULL);
+
+	for (guint i = ndims; i > 0; i--)
+	{
+		guint64 chunk_count = (dims[i - 1] + chunk_dims[i - 1] - 1) / chunk_dims[i - 1];
+		guint64 coord = (chunk % chunk_count) * chunk_dims[i - 1];
+
+		elements *= MIN(chunk_dims[i - 1], dims[i - 1] - coord);
+		chunk /= chunk_count;
+	}
+
+	return elements;
+}
+
+/**
+ * Records a chunk that has been written for the first time or whose stored size or zone map has changed.
+ **/
+static gboolean
+H5VL_julea_db_dataset_chunk_record(JHDF5Object_t* object, guint64 chunk, JHDF5Chunk const* stored, gboolean update, GPtrArray* entries, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JDBSelector) selector = NULL;
+	JHDF5Object_t* file = object->dataset.file;
+	JDBEntry* entry;
+
+	if (!(entry = j_db_entry_new(julea_db_schema_chunk, error)))
+	{
+		j_goto_error();
+	}
+
+	g_ptr_array_add(entries, entry);
+
+	if (!j_db_entry_set_field(entry, "size", &stored->size, sizeof(stored->size), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "min_value_i", &stored->statistics.min_value_i, sizeof(stored->statistics.min_value_i), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "max_value_i", &stored->statistics.max_value_i, sizeof(stored->statistics.max_value_i), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "min_value_f", &stored->statistics.min_value_f, sizeof(stored->statistics.min_value_f), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "max_value_f", &stored->statistics.max_value_f, sizeof(stored->statistics.max_value_f), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "count", &stored->statistics.count, sizeof(stored->statistics.count), error))
+	{
+		j_goto_error();
+	}
+
+	if (update)
+	{
+		if (!(selector = j_db_selector_new(julea_db_schema_chunk, J_DB_SELECTOR_MODE_AND, error)))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_selector_add_field(selector, "dataset", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_selector_add_field(selector, "index", J_DB_SELECTOR_OPERATOR_EQ, &chunk, sizeof(chunk), error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_entry_update(entry, selector, batch, error))
+		{
+			j_goto_error();
+		}
+
+		return TRUE;
+	}
+
+	if (!j_db_entry_set_field(entry, "file", file->backend_id, file->backend_id_len, error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "dataset", object->backend_id, object->backend_id_len, error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_set_field(entry, "index", &chunk, sizeof(chunk), error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_entry_insert(entry, batch, error))
+	{
+		j_goto_error();
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+static void
+H5VL_julea_db_dataset_chunk_set(JHDF5Object_t* object, guint64 chunk, JHDF5Chunk const* stored)
+{
+	guint64* index;
+	JHDF5Chunk* stored_chunk;
+
+	index = g_new(guint64, 1);
+	stored_chunk = g_new(JHDF5Chunk, 1);
+	*index = chunk;
+	*stored_chunk = *stored;
+
+	g_hash_table_insert(object->dataset.chunk.stored, index, stored_chunk);
+	H5VL_julea_db_statistics_merge(&object->dataset.statistics, &stored->statistics);
+}
+
+/**
+ * Looks up the chunks touched by a write that are not known to be stored.
+ * They may have been written using another handle of the same dataset, in which case they must neither be overwritten with fill values nor be recorded again.
+ **/
+static gboolean
+H5VL_julea_db_dataset_chunk_lookup(JHDF5Object_t* object, GArray* piece_arr, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JDBSelector) selector = NULL;
+	guint64 first = G_MAXUINT64;
+	guint64 last = 0;
+
+	for (guint i = 0; i < piece_arr->len; i++)
+	{
+		JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, i);
+
+		if (!g_hash_table_contains(object->dataset.chunk.stored, &piece->chunk))
+		{
+			first = MIN(first, piece->chunk);
+			last = MAX(last, piece->chunk);
+		}
+	}
+
+	if (first > last)
+	{
+		return TRUE;
+	}
+
+	// a range keeps the selector small, chunks within it that are already known are ignored
+	if (!(selector = j_db_selector_new(julea_db_schema_chunk, J_DB_SELECTOR_MODE_AND, error)))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_selector_add_field(selector, "dataset", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_selector_add_field(selector, "index", J_DB_SELECTOR_OPERATOR_GE, &first, sizeof(first), error))
+	{
+		return FALSE;
+	}
+
+	if (!j_db_selector_add_field(selector, "index", J_DB_SELECTOR_OPERATOR_LE, &last, sizeof(last), error))
+	{
+		return FALSE;
+	}
+
+	return H5VL_julea_db_dataset_chunk_query(object, selector, error);
+}
+
+/**
+ * Initializes elements that have not been written with the dataset's fill value.
+ * It does not call HDF5, so it may be used from worker threads.
+ **/
+static void
+H5VL_julea_db_dataset_chunk_fill(JHDF5Object_t* object, gchar* buf, guint64 elements)
+{
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+
+	if (object->dataset.chunk.fill == NULL)
+	{
+		memset(buf, 0, elements * data_size);
+		return;
+	}
+
+	for (guint64 i = 0; i < elements; i++)
+	{
+		memcpy(buf + i * data_size, object->dataset.chunk.fill, data_size);
+	}
+}
+
+/**
+ * Computes the zone map of a chunk whose stored contents consist of the given pieces only.
+ * Elements that are not covered by the pieces contain the fill value.
+ *
+ * \param fill The fill value, NULL if it is zero.
+ **/
+static void
+H5VL_julea_db_dataset_chunk_statistics(JHDF5StatisticsKind kind, gsize data_size, GArray* piece_arr, guint first, guint last, const gchar* buf, guint64 elements, gconstpointer fill, JHDF5Statistics* statistics)
+{
+	guint64 covered = 0;
+
+	H5VL_julea_db_statistics_init(statistics);
+
+	for (guint i = first; i < last; i++)
+	{
+		JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, i);
+
+		H5VL_julea_db_statistics_compute(kind, buf + piece->mem * data_size, piece->length, statistics);
+		covered += piece->length;
+	}
+
+	if (covered < elements)
+	{
+		// large enough for all supported kinds
+		static const guint64 zero = 0;
+
+		H5VL_julea_db_statistics_compute(kind, (fill != NULL) ? fill : &zero, 1, statistics);
+	}
+
+	statistics->count = elements;
+}
+
+struct JHDF5ChunkUpdate
+{
+	guint64 index;
+	JHDF5Chunk chunk;
+};
+
+typedef struct JHDF5ChunkUpdate JHDF5ChunkUpdate;
+
+struct JHDF5ChunkCodec
+{
+	JHDF5Object_t* object;
+	GArray* piece_arr;
+	/// pieces [first, last) belong to this chunk
+	guint first;
+	guint last;
+	guint64 chunk;
+	/// the user buffer
+	gchar* mem;
+	gpointer encoded;
+	guint64 encoded_length;
+	/// whether the chunk has already been stored
+	gboolean stored;
+	/// whether the stored chunk has to be decoded before applying the pieces
+	gboolean merge;
+	/// whether the chunk does not have to be encoded or decoded
+	gboolean skip;
+	/// number of elements of the chunk that lie within the dataset
+	guint64 elements;
+	JHDF5StatisticsKind kind;
+	/// the zone map of the encoded chunk
+	JHDF5Statistics statistics;
+};
+
+typedef struct JHDF5ChunkCodec JHDF5ChunkCodec;
+
+static gpointer
+H5VL_julea_db_dataset_chunk_encode(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5ChunkCodec* codec = data;
+	JHDF5Object_t* object = codec->object;
+	g_autofree gchar* chunk_buf = NULL;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint64 chunk_size = H5VL_julea_db_dataset_chunk_size(object);
+
+	if (codec->merge)
+	{
+		chunk_buf = g_malloc(chunk_size);
+
+		if (!H5VL_julea_db_filter_decode(object->dataset.filter.list, object->dataset.filter.count, data_size, codec->encoded, codec->encoded_length, chunk_buf, chunk_size))
+		{
+			return NULL;
+		}
+
+		g_clear_pointer(&codec->encoded, g_free);
+	}
+	else
+	{
+		chunk_buf = g_malloc(chunk_size);
+		H5VL_julea_db_dataset_chunk_fill(object, chunk_buf, chunk_size / data_size);
+	}
+
+	for (guint i = codec->first; i < codec->last; i++)
+	{
+		JHDF5ChunkPiece* piece = &g_array_index(codec->piece_arr, JHDF5ChunkPiece, i);
+
+		memcpy(chunk_buf + piece->offset * data_size, codec->mem + piece->mem * data_size, piece->length * data_size);
+	}
+
+	if (codec->merge)
+	{
+		// the padding of edge chunks contains the fill value, so including it keeps the zone map conservative
+		H5VL_julea_db_statistics_init(&codec->statistics);
+		H5VL_julea_db_statistics_compute(codec->kind, chunk_buf, chunk_size / data_size, &codec->statistics);
+		codec->statistics.count = codec->elements;
+	}
+	else
+	{
+		H5VL_julea_db_dataset_chunk_statistics(codec->kind, data_size, codec->piece_arr, codec->first, codec->last, codec->mem, codec->elements, object->dataset.chunk.fill, &codec->statistics);
+	}
+
+	if (!H5VL_julea_db_filter_encode(object->dataset.filter.list, object->dataset.filter.count, data_size, chunk_buf, chunk_size, &codec->encoded, &codec->encoded_length))
+	{
+		return NULL;
+	}
+
+	return codec;
+}
+
+static gpointer
+H5VL_julea_db_dataset_chunk_decode(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5ChunkCodec* codec = data;
+	JHDF5Object_t* object = codec->object;
+	g_autofree gchar* chunk_buf = NULL;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint64 chunk_size = H5VL_julea_db_dataset_chunk_size(object);
+
+	chunk_buf = g_malloc(chunk_size);
+
+	if (!H5VL_julea_db_filter_decode(object->dataset.filter.list, object->dataset.filter.count, data_size, codec->encoded, codec->encoded_length, chunk_buf, chunk_size))
+	{
+		return NULL;
+	}
+
+	for (guint i = codec->first; i < codec->last; i++)
+	{
+		JHDF5ChunkPiece* piece = &g_array_index(codec->piece_arr, JHDF5ChunkPiece, i);
+
+		memcpy(codec->mem + piece->mem * data_size, chunk_buf + piece->offset * data_size, piece->length * data_size);
+	}
+
+	return codec;
+}
+
+/**
+ * Groups the pieces by chunk.
+ **/
+static JHDF5ChunkCodec*
+H5VL_julea_db_dataset_chunk_codecs(JHDF5Object_t* object, GArray* piece_arr, gchar* mem, guint* count)
+{
+	JHDF5ChunkCodec* codecs;
+	guint i;
+	guint j;
+
+	*count = 0;
+
+	for (i = 0; i < piece_arr->len; i++)
+	{
+		if (i == 0 || g_array_index(piece_arr, JHDF5ChunkPiece, i).chunk != g_array_index(piece_arr, JHDF5ChunkPiece, i - 1).chunk)
+		{
+			(*count)++;
+		}
+	}
+
+	codecs = g_new0(JHDF5ChunkCodec, *count);
+
+	for (i = 0, j = 0; i < piece_arr->len; j++)
+	{
+		JHDF5ChunkCodec* codec = &codecs[j];
+
+		codec->object = object;
+		codec->piece_arr = piece_arr;
+		codec->first = i;
+		codec->chunk = g_array_index(piece_arr, JHDF5ChunkPiece, i).chunk;
+		codec->mem = mem;
+		codec->stored = g_hash_table_contains(object->dataset.chunk.stored, &codec->chunk);
+
+		for (i++; i < piece_arr->len && g_array_index(piece_arr, JHDF5ChunkPiece, i).chunk == codec->chunk; i++)
+		{
+		}
+
+		codec->last = i;
+	}
+
+	return codecs;
+}
+
+static void
+H5VL_julea_db_dataset_chunk_codecs_free(JHDF5ChunkCodec* codecs, guint count)
+{
+	for (guint i = 0; i < count; i++)
+	{
+		g_free(codecs[i].encoded);
+	}
+
+	g_free(codecs);
+}
+
+static gboolean
+H5VL_julea_db_dataset_chunk_codecs_run(JHDF5ChunkCodec* codecs, guint count, JBackgroundOperationFunc func)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gpointer* data = NULL;
+	gboolean ret = TRUE;
+	guint n = 0;
+
+	data = g_new(gpointer, count);
+
+	for (guint i = 0; i < count; i++)
+	{
+		data[i] = NULL;
+
+		if (!codecs[i].skip)
+		{
+			data[i] = &codecs[i];
+			n++;
+		}
+	}
+
+	if (n == 0)
+	{
+		return TRUE;
+	}
+
+	j_helper_execute_parallel(func, data, count);
+
+	for (guint i = 0; i < count; i++)
+	{
+		if (!codecs[i].skip && data[i] == NULL)
+		{
+			ret = FALSE;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Elements that are contiguous both in the user buffer and in the transfer's local buffer.
+ **/
+struct JHDF5DatasetConvertRun
+{
+	guint64 mem;
+	guint64 local;
+	guint64 length;
+};
+
+typedef struct JHDF5DatasetConvertRun JHDF5DatasetConvertRun;
+
+/**
+ * The state of a single dataset within a read or write of possibly multiple datasets.
+ * All datasets queue their operations into a shared batch, which is executed once before the transfers are finished.
+ **/
+struct JHDF5DatasetTransfer
+{
+	JHDF5Object_t* object;
+	hid_t mem_type_id;
+	/// the user buffer
+	gchar* buf;
+	/// the data in the dataset's datatype, which may be the user buffer
+	gchar* local_buf;
+	gpointer local_buf_org;
+	/// maps the user buffer to the local buffer if the datatypes differ
+	GArray* convert_runs;
+	/// number of elements in memory
+	guint64 mem_extent;
+	/// the pieces of chunked datasets
+	GArray* piece_arr;
+	/// the ranges of contiguous datasets
+	GArray* mem_space_arr;
+	GArray* file_space_arr;
+	/// buffers and entries that have to stay alive until the batch has been executed
+	GPtrArray* buffers;
+	GPtrArray* entries;
+	/// chunks whose stored state changes once the batch has been executed
+	GArray* updated;
+	GArray* gathers;
+	JHDF5ChunkCodec* codecs;
+	guint codec_count;
+	/// the object operations report their progress here, which happens after the functions queueing them have returned
+	guint64 bytes_read;
+	guint64 bytes_written;
+};
+
+typedef struct JHDF5DatasetTransfer JHDF5DatasetTransfer;
+
+static gboolean
+H5VL_julea_db_dataset_transfer_init(JHDF5DatasetTransfer* transfer, JHDF5Object_t* object, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id, gpointer buf)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	// asynchronous transfers may outlive the dataset's handle
+	transfer->object = H5VL_julea_db_object_ref(object);
+	transfer->mem_type_id = mem_type_id;
+	transfer->buf = buf;
+	transfer->local_buf = buf;
+	transfer->buffers = g_ptr_array_new_with_free_func(g_free);
+	transfer->entries = g_ptr_array_new_with_free_func((GDestroyNotify)j_db_entry_unref);
+	transfer->updated = g_array_new(FALSE, FALSE, sizeof(JHDF5ChunkUpdate));
+	transfer->gathers = g_array_new(FALSE, FALSE, sizeof(JHDF5ChunkGather));
+
+	if (object->dataset.chunk.ndims > 0)
+	{
+		if (!(transfer->piece_arr = H5VL_julea_db_dataset_chunk_pieces(object, mem_space_id, file_space_id, &transfer->mem_extent)))
+		{
+			return FALSE;
+		}
+
+		return TRUE;
+	}
+
+	if (!(transfer->mem_space_arr = H5VL_julea_db_space_hdf5_to_range(mem_space_id, object->dataset.space->space.hdf5_id)))
+	{
+		return FALSE;
+	}
+
+	if (!(transfer->file_space_arr = H5VL_julea_db_space_hdf5_to_range(file_space_id, object->dataset.space->space.hdf5_id)))
+	{
+		return FALSE;
+	}
+
+	for (guint i = 0; i < transfer->mem_space_arr->len; i++)
+	{
+		JHDF5IndexRange* mem_space_range = &g_array_index(transfer->mem_space_arr, JHDF5IndexRange, i);
+
+		transfer->mem_extent += mem_space_range->stop - mem_space_range->start;
+	}
+
+	return TRUE;
+}
+
+static void
+H5VL_julea_db_dataset_transfer_add_run(JHDF5DatasetTransfer* transfer, guint64 mem, guint64 local, guint64 length)
+{
+	JHDF5DatasetConvertRun run;
+
+	if (transfer->convert_runs->len > 0)
+	{
+		JHDF5DatasetConvertRun* last = &g_array_index(transfer->convert_runs, JHDF5DatasetConvertRun, transfer->convert_runs->len - 1);
+
+		if (last->mem + last->length == mem && last->local + last->length == local)
+		{
+			last->length += length;
+			return;
+		}
+	}
+
+	run.mem = mem;
+	run.local = local;
+	run.length = length;
+
+	g_array_append_val(transfer->convert_runs, run);
+}
+
+/**
+ * Sets up the local buffer of a transfer.
+ * The user buffer is used directly if the datatypes match.
+ * Otherwise, only the selected elements are buffered, packed in the order in which they are transferred, and the memory positions of the pieces or ranges are changed to refer to the local buffer.
+ **/
+static void
+H5VL_julea_db_dataset_transfer_prepare(JHDF5DatasetTransfer* transfer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint64 local = 0;
+
+	if (H5Tequal(transfer->mem_type_id, object->dataset.datatype->datatype.hdf5_id) > 0)
+	{
+		transfer->local_buf = transfer->buf;
+		return;
+	}
+
+	transfer->convert_runs = g_array_new(FALSE, FALSE, sizeof(JHDF5DatasetConvertRun));
+
+	if (transfer->piece_arr != NULL)
+	{
+		for (guint i = 0; i < transfer->piece_arr->len; i++)
+		{
+			JHDF5ChunkPiece* piece = &g_array_index(transfer->piece_arr, JHDF5ChunkPiece, i);
+
+			H5VL_julea_db_dataset_transfer_add_run(transfer, piece->mem, local, piece->length);
+			piece->mem = local;
+			local += piece->length;
+		}
+	}
+	else
+	{
+		for (guint i = 0; i < transfer->mem_space_arr->len; i++)
+		{
+			JHDF5IndexRange* range = &g_array_index(transfer->mem_space_arr, JHDF5IndexRange, i);
+			guint64 length = range->stop - range->start;
+
+			H5VL_julea_db_dataset_transfer_add_run(transfer, range->start, local, length);
+			range->start = local;
+			range->stop = local + length;
+			local += length;
+		}
+	}
+
+	transfer->local_buf_org = g_malloc(local * data_size);
+	transfer->local_buf = transfer->local_buf_org;
+}
+
+/**
+ * Converts the selected elements between the user buffer and the local buffer.
+ *
+ * \param to_local Whether to convert from the user buffer to the local buffer or the other way around.
+ **/
+static gboolean
+H5VL_julea_db_dataset_transfer_convert(JHDF5DatasetTransfer* transfer, gboolean to_local)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	hid_t type_id = transfer->object->dataset.datatype->datatype.hdf5_id;
+	gsize data_size = transfer->object->dataset.datatype->datatype.type_total_size;
+	gsize mem_size;
+
+	if (transfer->convert_runs == NULL)
+	{
+		return TRUE;
+	}
+
+	if ((mem_size = H5Tget_size(transfer->mem_type_id)) == 0)
+	{
+		return FALSE;
+	}
+
+	for (guint i = 0; i < transfer->convert_runs->len; i++)
+	{
+		JHDF5DatasetConvertRun* run = &g_array_index(transfer->convert_runs, JHDF5DatasetConvertRun, i);
+		gchar* mem = transfer->buf + run->mem * mem_size;
+		gchar* local = transfer->local_buf + run->local * data_size;
+
+		if (to_local && !H5VL_julea_db_datatype_convert(transfer->mem_type_id, type_id, mem, local, run->length))
+		{
+			return FALSE;
+		}
+
+		if (!to_local && !H5VL_julea_db_datatype_convert(type_id, transfer->mem_type_id, local, mem, run->length))
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static void
+H5VL_julea_db_dataset_transfer_clear(JHDF5DatasetTransfer* transfer)
+{
+	if (transfer->gathers != NULL)
+	{
+		for (guint i = 0; i < transfer->gathers->len; i++)
+		{
+			g_free(g_array_index(transfer->gathers, JHDF5ChunkGather, i).buf);
+		}
+
+		g_array_unref(transfer->gathers);
+	}
+
+	if (transfer->codecs != NULL)
+	{
+		H5VL_julea_db_dataset_chunk_codecs_free(transfer->codecs, transfer->codec_count);
+	}
+
+	g_clear_pointer(&transfer->piece_arr, g_array_unref);
+	g_clear_pointer(&transfer->mem_space_arr, g_array_unref);
+	g_clear_pointer(&transfer->file_space_arr, g_array_unref);
+	g_clear_pointer(&transfer->buffers, g_ptr_array_unref);
+	g_clear_pointer(&transfer->entries, g_ptr_array_unref);
+	g_clear_pointer(&transfer->updated, g_array_unref);
+	g_clear_pointer(&transfer->convert_runs, g_array_unref);
+	g_free(transfer->local_buf_org);
+
+	if (transfer->object != NULL)
+	{
+		H5VL_julea_db_object_unref(transfer->object);
+	}
+}
+
+/**
+ * Queues the writes of a contiguous dataset.
+ **/
+static void
+H5VL_julea_db_dataset_write_contiguous(JHDF5DatasetTransfer* transfer, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	JHDF5IndexRange* mem_space_range = NULL;
+	JHDF5IndexRange* file_space_range = NULL;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint mem_space_idx = 0;
+	guint file_space_idx = 0;
+	guint64 current_count1;
+	guint64 current_count2;
+
+	while ((mem_space_idx < transfer->mem_space_arr->len) && (file_space_idx < transfer->file_space_arr->len))
+	{
+		if (mem_space_range == NULL)
+		{
+			mem_space_range = &g_array_index(transfer->mem_space_arr, JHDF5IndexRange, mem_space_idx++);
+		}
+
+		if (file_space_range == NULL)
+		{
+			file_space_range = &g_array_index(transfer->file_space_arr, JHDF5IndexRange, file_space_idx++);
+		}
+
+		current_count1 = mem_space_range->stop - mem_space_range->start;
+		current_count2 = file_space_range->stop - file_space_range->start;
+		current_count1 = current_count1 < current_count2 ? current_count1 : current_count2;
+		calculate_statistics(object, transfer->local_buf + mem_space_range->start * data_size, data_size * current_count1, object->dataset.datatype->datatype.hdf5_id);
+		j_distributed_object_write(object->dataset.object, transfer->local_buf + mem_space_range->start * data_size, data_size * current_count1, file_space_range->start * data_size, &transfer->bytes_written, batch);
+
+		if (mem_space_range->start + current_count1 == mem_space_range->stop)
+		{
+			mem_space_range = NULL;
+		}
+
+		if (file_space_range->start + current_count1 == file_space_range->stop)
+		{
+			file_space_range = NULL;
+		}
+	}
+}
+
+/**
+ * Queues the reads of a contiguous dataset.
+ **/
+static void
+H5VL_julea_db_dataset_read_contiguous(JHDF5DatasetTransfer* transfer, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	JHDF5IndexRange* mem_space_range = NULL;
+	JHDF5IndexRange* file_space_range = NULL;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint mem_space_idx = 0;
+	guint file_space_idx = 0;
+	guint64 current_count1;
+	guint64 current_count2;
+
+	while ((mem_space_idx < transfer->mem_space_arr->len) && (file_space_idx < transfer->file_space_arr->len))
+	{
+		if (mem_space_range == NULL)
+		{
+			mem_space_range = &g_array_index(transfer->mem_space_arr, JHDF5IndexRange, mem_space_idx++);
+		}
+
+		if (file_space_range == NULL)
+		{
+			file_space_range = &g_array_index(transfer->file_space_arr, JHDF5IndexRange, file_space_idx++);
+		}
+
+		current_count1 = mem_space_range->stop - mem_space_range->start;
+		current_count2 = file_space_range->stop - file_space_range->start;
+		current_count1 = current_count1 < current_count2 ? current_count1 : current_count2;
+		j_distributed_object_read(object->dataset.object, transfer->local_buf + mem_space_range->start * data_size, data_size * current_count1, file_space_range->start * data_size, &transfer->bytes_read, batch);
+
+		if (mem_space_range->start + current_count1 == mem_space_range->stop)
+		{
+			mem_space_range = NULL;
+		}
+
+		if (file_space_range->start + current_count1 == file_space_range->stop)
+		{
+			file_space_range = NULL;
+		}
+	}
+}
+
+/**
+ * Queues the writes of pieces [first, last) of a chunk with one write per contiguous run.
+ **/
+static void
+H5VL_julea_db_dataset_chunk_write_runs(JHDF5DatasetTransfer* transfer, JObject* chunk_object, guint first, guint last, JBatch* batch)
+{
+	GArray* piece_arr = transfer->piece_arr;
+	const gchar* buf = transfer->local_buf;
+	gsize data_size = transfer->object->dataset.datatype->datatype.type_total_size;
+	guint k;
+
+	// coalesce pieces that are adjacent within the chunk into a single write
+	for (k = first; k < last;)
+	{
+		JHDF5ChunkPiece* run_first = &g_array_index(piece_arr, JHDF5ChunkPiece, k);
+		guint64 run_length = run_first->length;
+		guint l;
+
+		for (l = k + 1; l < last; l++)
+		{
+			JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, l);
+
+			if (run_first->offset + run_length != piece->offset)
+			{
+				break;
+			}
+
+			run_length += piece->length;
+		}
+
+		if (l == k + 1)
+		{
+			j_object_write(chunk_object, buf + run_first->mem * data_size, run_length * data_size, run_first->offset * data_size, &transfer->bytes_written, batch);
+		}
+		else
+		{
+			gchar* run_buf;
+			guint m;
+
+			run_buf = g_malloc(run_length * data_size);
+			g_ptr_array_add(transfer->buffers, run_buf);
+
+			for (m = k; m < l; m++)
+			{
+				JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, m);
+
+				memcpy(run_buf + (piece->offset - run_first->offset) * data_size, buf + piece->mem * data_size, piece->length * data_size);
+			}
+
+			j_object_write(chunk_object, run_buf, run_length * data_size, run_first->offset * data_size, &transfer->bytes_written, batch);
+		}
+
+		k = l;
+	}
+}
+
+/**
+ * Queues the writes of the pieces of each touched chunk.
+ * Only the selected elements are written, unwritten parts of a chunk object are read as zero.
+ * New chunks of datasets with a non-zero fill value are written in full, so that unselected elements contain the fill value.
+ * The zone maps of existing chunks are widened to cover the new values, because the overwritten values are not known.
+ **/
+static gboolean
+H5VL_julea_db_dataset_write_raw(JHDF5DatasetTransfer* transfer, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	GArray* piece_arr = transfer->piece_arr;
+	const gchar* buf = transfer->local_buf;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	guint64 chunk_size = H5VL_julea_db_dataset_chunk_size(object);
+	JHDF5StatisticsKind kind = H5VL_julea_db_statistics_kind(object->dataset.datatype->datatype.hdf5_id);
+	guint i;
+	guint j;
+
+	for (i = 0; i < piece_arr->len; i = j)
+	{
+		g_autoptr(JObject) chunk_object = NULL;
+		JHDF5ChunkPiece* first = &g_array_index(piece_arr, JHDF5ChunkPiece, i);
+		JHDF5Chunk const* stored;
+		JHDF5ChunkUpdate update;
+
+		for (j = i + 1; j < piece_arr->len && g_array_index(piece_arr, JHDF5ChunkPiece, j).chunk == first->chunk; j++)
+		{
+		}
+
+		chunk_object = H5VL_julea_db_dataset_chunk_object(object, first->chunk);
+		update.index = first->chunk;
+		update.chunk.size = chunk_size;
+		H5VL_julea_db_dataset_chunk_statistics(kind, data_size, piece_arr, i, j, buf, H5VL_julea_db_dataset_chunk_elements(object, first->chunk), object->dataset.chunk.fill, &update.chunk.statistics);
+
+		if ((stored = g_hash_table_lookup(object->dataset.chunk.stored, &first->chunk)) == NULL)
+		{
+			j_object_create(chunk_object, batch);
+
+			if (object->dataset.chunk.fill != NULL)
+			{
+				gchar* chunk_buf;
+
+				chunk_buf = g_malloc(chunk_size);
+				g_ptr_array_add(transfer->buffers, chunk_buf);
+				H5VL_julea_db_dataset_chunk_fill(object, chunk_buf, chunk_size / data_size);
+
+				for (guint k = i; k < j; k++)
+				{
+					JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, k);
+
+					memcpy(chunk_buf + piece->offset * data_size, buf + piece->mem * data_size, piece->length * data_size);
+				}
+
+				j_object_write(chunk_object, chunk_buf, chunk_size, 0, &transfer->bytes_written, batch);
+			}
+			else
+			{
+				H5VL_julea_db_dataset_chunk_write_runs(transfer, chunk_object, i, j, batch);
+			}
+
+			if (!H5VL_julea_db_dataset_chunk_record(object, first->chunk, &update.chunk, FALSE, transfer->entries, batch, error))
+			{
+				j_goto_error();
+			}
+
+			g_array_append_val(transfer->updated, update);
+
+			continue;
+		}
+
+		update.chunk.statistics.count = stored->statistics.count;
+		H5VL_julea_db_statistics_merge(&update.chunk.statistics, &stored->statistics);
+
+		if (!H5VL_julea_db_statistics_equal(&update.chunk.statistics, &stored->statistics))
+		{
+			if (!H5VL_julea_db_dataset_chunk_record(object, first->chunk, &update.chunk, TRUE, transfer->entries, batch, error))
+			{
+				j_goto_error();
+			}
+
+			g_array_append_val(transfer->updated, update);
+		}
+
+		H5VL_julea_db_dataset_chunk_write_runs(transfer, chunk_object, i, j, batch);
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Queues the reads of stored chunks that are only partially overwritten, because filtered chunks are always rewritten as a whole.
+ *
+ * \return TRUE if reads have been queued, FALSE otherwise.
+ **/
+static gboolean
+H5VL_julea_db_dataset_write_filtered_prepare(JHDF5DatasetTransfer* transfer, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	GArray* piece_arr = transfer->piece_arr;
+	JHDF5StatisticsKind kind = H5VL_julea_db_statistics_kind(object->dataset.datatype->datatype.hdf5_id);
+	gboolean pending = FALSE;
+
+	transfer->codecs = H5VL_julea_db_dataset_chunk_codecs(object, piece_arr, transfer->local_buf, &transfer->codec_count);
+
+	for (guint i = 0; i < transfer->codec_count; i++)
+	{
+		JHDF5ChunkCodec* codec = &transfer->codecs[i];
+		g_autoptr(JObject) chunk_object = NULL;
+		guint64 covered = 0;
+
+		codec->kind = kind;
+		codec->elements = H5VL_julea_db_dataset_chunk_elements(object, codec->chunk);
+
+		if (!codec->stored)
+		{
+			continue;
+		}
+
+		for (guint k = codec->first; k < codec->last; k++)
+		{
+			covered += g_array_index(piece_arr, JHDF5ChunkPiece, k).length;
+		}
+
+		if (covered == codec->elements)
+		{
+			continue;
+		}
+
+		codec->merge = TRUE;
+		codec->encoded_length = ((JHDF5Chunk*)g_hash_table_lookup(object->dataset.chunk.stored, &codec->chunk))->size;
+		codec->encoded = g_malloc(codec->encoded_length);
+
+		chunk_object = H5VL_julea_db_dataset_chunk_object(object, codec->chunk);
+		j_object_read(chunk_object, codec->encoded, codec->encoded_length, 0, &transfer->bytes_read, batch);
+		pending = TRUE;
+	}
+
+	return pending;
+}
+
+/**
+ * Encodes chunks through the filter pipeline and queues their writes.
+ * Encoding runs in parallel across chunks.
+ **/
+static gboolean
+H5VL_julea_db_dataset_write_filtered(JHDF5DatasetTransfer* transfer, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+
+	if (!H5VL_julea_db_dataset_chunk_codecs_run(transfer->codecs, transfer->codec_count, H5VL_julea_db_dataset_chunk_encode))
+	{
+		j_goto_error();
+	}
+
+	for (guint i = 0; i < transfer->codec_count; i++)
+	{
+		JHDF5ChunkCodec* codec = &transfer->codecs[i];
+		g_autoptr(JObject) chunk_object = NULL;
+		JHDF5Chunk const* stored = NULL;
+		JHDF5ChunkUpdate update;
+
+		chunk_object = H5VL_julea_db_dataset_chunk_object(object, codec->chunk);
+		update.index = codec->chunk;
+		update.chunk.size = codec->encoded_length;
+		update.chunk.statistics = codec->statistics;
+
+		if (!codec->stored)
+		{
+			j_object_create(chunk_object, batch);
+		}
+		else
+		{
+			stored = g_hash_table_lookup(object->dataset.chunk.stored, &codec->chunk);
+		}
+
+		j_object_write(chunk_object, codec->encoded, codec->encoded_length, 0, &transfer->bytes_written, batch);
+
+		if (stored == NULL || stored->size != update.chunk.size || !H5VL_julea_db_statistics_equal(&stored->statistics, &update.chunk.statistics))
+		{
+			if (!H5VL_julea_db_dataset_chunk_record(object, codec->chunk, &update.chunk, codec->stored, transfer->entries, batch, error))
+			{
+				j_goto_error();
+			}
+		}
+
+		g_array_append_val(transfer->updated, update);
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+/**
+ * Queues the reads of the pieces of each touched chunk with one read per contiguous run.
+ * Chunks that have not been written are not accessed and read as the fill value.
+ *
+ * \return TRUE if reads have been queued, FALSE otherwise.
+ **/
+static gboolean
+H5VL_julea_db_dataset_read_raw(JHDF5DatasetTransfer* transfer, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	GArray* piece_arr = transfer->piece_arr;
+	gchar* buf = transfer->local_buf;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	gboolean pending = FALSE;
+	guint i;
+	guint j;
+
+	for (i = 0; i < piece_arr->len; i = j)
+	{
+		g_autoptr(JObject) chunk_object = NULL;
+		JHDF5ChunkPiece* first = &g_array_index(piece_arr, JHDF5ChunkPiece, i);
+		guint k;
+
+		for (j = i + 1; j < piece_arr->len && g_array_index(piece_arr, JHDF5ChunkPiece, j).chunk == first->chunk; j++)
+		{
+		}
+
+		if (!g_hash_table_contains(object->dataset.chunk.stored, &first->chunk))
+		{
+			for (k = i; k < j; k++)
+			{
+				JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, k);
+
+				H5VL_julea_db_dataset_chunk_fill(object, buf + piece->mem * data_size, piece->length);
+			}
+
+			continue;
+		}
+
+		chunk_object = H5VL_julea_db_dataset_chunk_object(object, first->chunk);
+		pending = TRUE;
+
+		// coalesce pieces that are adjacent within the chunk into a single read
+		for (k = i; k < j;)
+		{
+			JHDF5ChunkPiece* run_first = &g_array_index(piece_arr, JHDF5ChunkPiece, k);
+			guint64 run_length = run_first->length;
+			guint l;
+
+			for (l = k + 1; l < j; l++)
+			{
+				JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, l);
+
+				if (run_first->offset + run_length != piece->offset)
+				{
+					break;
+				}
+
+				run_length += piece->length;
+			}
+
+			// sparsely written chunks may end before the run, the missing elements are zero
+			if (l == k + 1)
+			{
+				memset(buf + run_first->mem * data_size, 0, run_length * data_size);
+				j_object_read(chunk_object, buf + run_first->mem * data_size, run_length * data_size, run_first->offset * data_size, &transfer->bytes_read, batch);
+			}
+			else
+			{
+				JHDF5ChunkGather gather;
+
+				gather.buf = g_malloc0(run_length * data_size);
+				gather.first = k;
+				gather.last = l;
+				g_array_append_val(transfer->gathers, gather);
+
+				j_object_read(chunk_object, gather.buf, run_length * data_size, run_first->offset * data_size, &transfer->bytes_read, batch);
+			}
+
+			k = l;
+		}
+	}
+
+	return pending;
+}
+
+/**
+ * Queues the reads of whole chunks, which are decoded once the batch has been executed.
+ * Chunks that have not been written are not accessed and read as the fill value.
+ *
+ * \return TRUE if reads have been queued, FALSE otherwise.
+ **/
+static gboolean
+H5VL_julea_db_dataset_read_filtered(JHDF5DatasetTransfer* transfer, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	GArray* piece_arr = transfer->piece_arr;
+	gchar* buf = transfer->local_buf;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+	gboolean pending = FALSE;
+
+	transfer->codecs = H5VL_julea_db_dataset_chunk_codecs(object, piece_arr, buf, &transfer->codec_count);
+
+	for (guint i = 0; i < transfer->codec_count; i++)
+	{
+		JHDF5ChunkCodec* codec = &transfer->codecs[i];
+		g_autoptr(JObject) chunk_object = NULL;
+
+		if (!codec->stored)
+		{
+			for (guint k = codec->first; k < codec->last; k++)
+			{
+				JHDF5ChunkPiece* piece = &g_array_index(piece_arr, JHDF5ChunkPiece, k);
+
+				H5VL_julea_db_dataset_chunk_fill(object, buf + piece->mem * data_size, piece->length);
+			}
+
+			codec->skip = TRUE;
+
+			continue;
+		}
+
+		codec->encoded_length = ((JHDF5Chunk*)g_hash_table_lookup(object->dataset.chunk.stored, &codec->chunk))->size;
+		codec->encoded = g_malloc(codec->encoded_length);
+
+		chunk_object = H5VL_julea_db_dataset_chunk_object(object, codec->chunk);
+		j_object_read(chunk_object, codec->encoded, codec->encoded_length, 0, &transfer->bytes_read, batch);
+		pending = TRUE;
+	}
+
+	return pending;
+}
+
+/**
+ * Scatters gathered runs, decodes filtered chunks and converts the data to the memory datatype.
+ **/
+static gboolean
+H5VL_julea_db_dataset_read_finish(JHDF5DatasetTransfer* transfer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Object_t* object = transfer->object;
+	gsize data_size = object->dataset.datatype->datatype.type_total_size;
+
+	for (guint i = 0; i < transfer->gathers->len; i++)
+	{
+		JHDF5ChunkGather* gather = &g_array_index(transfer->gathers, JHDF5ChunkGather, i);
+		JHDF5ChunkPiece* run_first = &g_array_index(transfer->piece_arr, JHDF5ChunkPiece, gather->first);
+
+		for (guint j = gather->first; j < gather->last; j++)
+		{
+			JHDF5ChunkPiece* piece = &g_array_index(transfer->piece_arr, JHDF5ChunkPiece, j);
+
+			memcpy(transfer->local_buf + piece->mem * data_size, gather->buf + (piece->offset - run_first->offset) * data_size, piece->length * data_size);
+		}
+	}
+
+	if (transfer->codecs != NULL && !H5VL_julea_db_dataset_chunk_codecs_run(transfer->codecs, transfer->codec_count, H5VL_julea_db_dataset_chunk_decode))
+	{
+		return FALSE;
+	}
+
+	return H5VL_julea_db_dataset_transfer_convert(transfer, FALSE);
+}
+
+/**
+ * The transfers of a read or write, which may outlive the call if it is executed asynchronously.
+ **/
+struct JHDF5DatasetIO
+{
+	JHDF5DatasetTransfer* transfers;
+	size_t count;
+	// set if the transfers are executed asynchronously
+	void* request;
+};
+
+typedef struct JHDF5DatasetIO JHDF5DatasetIO;
+
+static JHDF5DatasetIO*
+H5VL_julea_db_dataset_io_new(size_t count)
+{
+	JHDF5DatasetIO* io;
+
+	io = g_new(JHDF5DatasetIO, 1);
+	io->transfers = g_new0(JHDF5DatasetTransfer, count);
+	io->count = count;
+	io->request = NULL;
+
+	return io;
+}
+
+static void
+H5VL_julea_db_dataset_io_free(gpointer data)
+{
+	JHDF5DatasetIO* io = data;
+
+	for (size_t i = 0; i < io->count; i++)
+	{
+		H5VL_julea_db_dataset_transfer_clear(&io->transfers[i]);
+	}
+
+	g_free(io->transfers);
+	g_free(io);
+}
+
+/**
+ * Executes the transfers' batch asynchronously and marks their datasets as pending until the request has been completed.
+ **/
+static void
+H5VL_julea_db_dataset_io_execute_async(JHDF5DatasetIO* io, JBatch* batch, JHDF5RequestCompleteFunc complete, void** req)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	io->request = H5VL_julea_db_request_new(batch, complete, io, H5VL_julea_db_dataset_io_free);
+
+	for (size_t i = 0; i < io->count; i++)
+	{
+		if (io->transfers[i].object != NULL)
+		{
+			io->transfers[i].object->dataset.request = io->request;
+		}
+	}
+
+	*req = io->request;
+}
+
+/**
+ * Clears the pending request of the transfers' datasets.
+ **/
+static void
+H5VL_julea_db_dataset_io_done(JHDF5DatasetIO* io)
+{
+	if (io->request == NULL)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < io->count; i++)
+	{
+		JHDF5Object_t* object = io->transfers[i].object;
+
+		if (object != NULL && object->dataset.request == io->request)
+		{
+			object->dataset.request = NULL;
+		}
+	}
+}
+
+/**
+ * Waits for the pending asynchronous operations of the given datasets.
+ * Reads and writes of a dataset are serialized this way, because they depend on the data and the stored chunks of previous writes.
+ * The results of the pending operations are reported by their own requests.
+ **/
+static void
+H5VL_julea_db_dataset_wait(size_t count, void* obj[])
+{
+	J_TRACE_FUNCTION(NULL);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		JHDF5Object_t* object = obj[i];
+		H5VL_request_status_t status;
+
+		// completing the request clears it
+		if (object->dataset.request != NULL)
+		{
+			H5VL_julea_db_request_wait(object->dataset.request, H5ES_WAIT_FOREVER, &status);
+		}
+	}
+}
+
+/**
+ * Updates the stored chunks once the writes have been executed.
+ **/
+static gboolean
+H5VL_julea_db_dataset_write_complete(gpointer data, gboolean success)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5DatasetIO* io = data;
+
+	H5VL_julea_db_dataset_io_done(io);
+
+	if (!success)
+	{
+		return FALSE;
+	}
+
+	for (size_t i = 0; i < io->count; i++)
+	{
+		JHDF5DatasetTransfer* transfer = &io->transfers[i];
+
+		for (guint j = 0; j < transfer->updated->len; j++)
+		{
+			JHDF5ChunkUpdate* update = &g_array_index(transfer->updated, JHDF5ChunkUpdate, j);
+
+			H5VL_julea_db_dataset_chunk_set(transfer->object, update->index, &update->chunk);
+		}
+	}
+
+	return TRUE;
+}
+
+static gboolean
+H5VL_julea_db_dataset_read_complete(gpointer data, gboolean success)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5DatasetIO* io = data;
+
+	H5VL_julea_db_dataset_io_done(io);
+
+	if (!success)
+	{
+		return FALSE;
 	}
-	else if (H5Tget_class(memory_type) == H5T_INTEGER)
+
+	for (size_t i = 0; i < io->count; i++)
 	{
-		if (H5Tget_sign(memory_type) == H5T_SGN_NONE)
-		{
-			if (element_size == 1)
-			{
-				calculate_statistics_helper(((gint8)((const guint8*)buf)[i]), _i);
-			}
-			else if (element_size == 2)
-			{
-				calculate_statistics_helper(((gint16)((const guint16*)buf)[i]), _i);
-			}
-			else if (element_size == 4)
-			{
-				calculate_statistics_helper(((gint32)((const guint32*)buf)[i]), _i);
-			}
-			else if (element_size == 8)
-			{
-				calculate_statistics_helper(((gint64)((const guint64*)buf)[i]), _i);
-			}
-		}
-		else
+		if (io->transfers[i].mem_extent > 0 && !H5VL_julea_db_dataset_read_finish(&io->transfers[i]))
 		{
-			if (element_size == 1)
-			{
-				calculate_statistics_helper(((const gint8*)buf)[i], _i);
-			}
-			else if (element_size == 2)
-			{
-				calculate_statistics_helper(((const gint16*)buf)[i], _i);
-			}
-			else if (element_size == 4)
-			{
-				calculate_statistics_helper(((const gint32*)buf)[i], _i);
-			}
-			else if (element_size == 8)
-			{
-				calculate_statistics_helper(((const gint64*)buf)[i], _i);
-			}
+			return FALSE;
 		}
 	}
+
+	return TRUE;
 }
 
-herr_t
-H5VL_julea_db_dataset_write(size_t count, void* obj[], hid_t mem_type_id[], hid_t mem_space_id[], hid_t file_space_id[], hid_t dxpl_id, const void* buf[], void** req)
+/**
+ * Writes a set of distinct datasets using a single batch.
+ * Chunks that are only partially overwritten in filtered datasets have to be read first, which requires an additional batch.
+ * If req is not NULL, the final batch is executed asynchronously and *req is set to the request.
+ **/
+static gboolean
+H5VL_julea_db_dataset_write_multi(size_t count, void* obj[], hid_t mem_type_id[], hid_t mem_space_id[], hid_t file_space_id[], const void* buf[], void** req)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_autofree void* local_buf_org = NULL;
+	g_autoptr(GError) error = NULL;
 	g_autoptr(JBatch) batch = NULL;
-	g_autoptr(GArray) mem_space_arr = NULL;
-	g_autoptr(GArray) file_space_arr = NULL;
-	const void* local_buf;
-	guint64 bytes_written;
-	gsize data_size;
-	gsize data_count;
-	JHDF5Object_t* object = obj[0];
-	guint mem_space_idx;
-	guint file_space_idx;
-	JHDF5IndexRange* mem_space_range = NULL;
-	JHDF5IndexRange* file_space_range = NULL;
-	guint64 current_count1;
-	guint64 current_count2;
-	guint i;
-
-	/// \todo support multi-write
-	const void* buf0 = *buf;
-	hid_t mem_type_id0 = *mem_type_id;
-	hid_t mem_space_id0 = *mem_space_id;
-	hid_t file_space_id0 = *file_space_id;
-
-	(void)dxpl_id;
-	(void)req;
+	JHDF5DatasetIO* io;
+	gboolean pending = FALSE;
+	size_t i;
 
-	/// \todo support multi-write
-	g_return_val_if_fail(count == 1, 1);
-	g_return_val_if_fail(buf0 != NULL, 1);
-	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_DATASET, 1);
+	H5VL_julea_db_dataset_wait(count, obj);
 
-	data_size = object->dataset.datatype->datatype.type_total_size;
+	io = H5VL_julea_db_dataset_io_new(count);
 
 	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
 	{
 		j_goto_error();
 	}
 
-	if (!(mem_space_arr = H5VL_julea_db_space_hdf5_to_range(mem_space_id0, object->dataset.space->space.hdf5_id)))
+	for (i = 0; i < count; i++)
 	{
-		j_goto_error();
+		JHDF5DatasetTransfer* transfer = &io->transfers[i];
+		JHDF5Object_t* object = obj[i];
+
+		if (!H5VL_julea_db_dataset_transfer_init(transfer, object, mem_type_id[i], mem_space_id[i], file_space_id[i], (gpointer)buf[i]))
+		{
+			j_goto_error();
+		}
+
+		if (transfer->mem_extent == 0)
+		{
+			continue;
+		}
+
+		H5VL_julea_db_dataset_transfer_prepare(transfer);
+
+		if (!H5VL_julea_db_dataset_transfer_convert(transfer, TRUE))
+		{
+			j_goto_error();
+		}
+
+		if (object->dataset.chunk.ndims > 0 && !H5VL_julea_db_dataset_chunk_lookup(object, transfer->piece_arr, &error))
+		{
+			j_goto_error();
+		}
+
+		if (object->dataset.chunk.ndims > 0 && object->dataset.filter.count > 0)
+		{
+			pending = H5VL_julea_db_dataset_write_filtered_prepare(transfer, batch) || pending;
+		}
 	}
 
-	if (!(file_space_arr = H5VL_julea_db_space_hdf5_to_range(file_space_id0, object->dataset.space->space.hdf5_id)))
+	// batches without operations fail to execute
+	if (pending && !j_batch_execute(batch))
 	{
 		j_goto_error();
 	}
 
-	data_count = 0;
+	pending = FALSE;
 
-	for (i = 0; i < mem_space_arr->len; i++)
+	for (i = 0; i < count; i++)
 	{
-		mem_space_range = &g_array_index(mem_space_arr, JHDF5IndexRange, i);
-		data_count += mem_space_range->stop - mem_space_range->start;
-	}
-
-	local_buf_org = g_new(char, data_size* data_count);
+		JHDF5DatasetTransfer* transfer = &io->transfers[i];
+		JHDF5Object_t* object = transfer->object;
 
-	local_buf = H5VL_julea_db_datatype_convert_type(mem_type_id0, object->dataset.datatype->datatype.hdf5_id, buf0, local_buf_org, data_count);
-	mem_space_idx = 0;
-	file_space_idx = 0;
-
-	while ((mem_space_idx < mem_space_arr->len) && (file_space_idx < file_space_arr->len))
-	{
-		if (mem_space_range == NULL)
+		if (transfer->mem_extent == 0)
 		{
-			mem_space_range = &g_array_index(mem_space_arr, JHDF5IndexRange, mem_space_idx++);
+			continue;
 		}
 
-		if (file_space_range == NULL)
+		// the dataset statistics of chunked datasets are updated from the zone maps of the written chunks
+		if (object->dataset.chunk.ndims == 0)
 		{
-			file_space_range = &g_array_index(file_space_arr, JHDF5IndexRange, file_space_idx++);
+			H5VL_julea_db_dataset_write_contiguous(transfer, batch);
 		}
-
-		current_count1 = mem_space_range->stop - mem_space_range->start;
-		current_count2 = file_space_range->stop - file_space_range->start;
-		current_count1 = current_count1 < current_count2 ? current_count1 : current_count2;
-		calculate_statistics(object, ((const char*)local_buf) + mem_space_range->start * data_size, data_size * current_count1, mem_type_id0);
-		j_distributed_object_write(object->dataset.object, ((const char*)local_buf) + mem_space_range->start * data_size, data_size * current_count1, file_space_range->start * data_size, &bytes_written, batch);
-
-		if (mem_space_range->start + current_count1 == mem_space_range->stop)
+		else if (object->dataset.filter.count > 0)
 		{
-			mem_space_range = NULL;
+			if (!H5VL_julea_db_dataset_write_filtered(transfer, batch, &error))
+			{
+				j_goto_error();
+			}
 		}
-
-		if (file_space_range->start + current_count1 == file_space_range->stop)
+		else if (!H5VL_julea_db_dataset_write_raw(transfer, batch, &error))
 		{
-			file_space_range = NULL;
+			j_goto_error();
 		}
+
+		pending = TRUE;
 	}
 
-	if (!j_batch_execute(batch))
+	if (pending && req != NULL)
+	{
+		H5VL_julea_db_dataset_io_execute_async(io, batch, H5VL_julea_db_dataset_write_complete, req);
+
+		return TRUE;
+	}
+
+	if (pending && !j_batch_execute(batch))
 	{
 		j_goto_error();
 	}
 
-	return 0;
+	H5VL_julea_db_dataset_write_complete(io, TRUE);
+	H5VL_julea_db_dataset_io_free(io);
+
+	return TRUE;
 
 _error:
-	return 1;
+	H5VL_julea_db_error_handler(error);
+	H5VL_julea_db_dataset_io_free(io);
+
+	return FALSE;
 }
 
+/**
+ * Writes one or more datasets.
+ * All datasets share a single batch, so that writing many small datasets does not require a round trip per dataset.
+ * Datasets that occur more than once are written in separate rounds, so that each round sees the chunks stored by the previous one.
+ * Such writes are always executed synchronously, all others are executed asynchronously if req is not NULL.
+ **/
 herr_t
-H5VL_julea_db_dataset_read(size_t count, void* obj[], hid_t mem_type_id[], hid_t mem_space_id[],
-			   hid_t file_space_id[], hid_t dxpl_id, void* buf[], void** req)
+H5VL_julea_db_dataset_write(size_t count, void* obj[], hid_t mem_type_id[], hid_t mem_space_id[], hid_t file_space_id[], hid_t dxpl_id, const void* buf[], void** req)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_autofree void* local_buf_org = NULL;
-	g_autoptr(JBatch) batch = NULL;
-	g_autoptr(GArray) mem_space_arr = NULL;
-	g_autoptr(GArray) file_space_arr = NULL;
-	const void* local_buf;
-	guint64 bytes_read;
-	gsize data_size;
-	gsize data_count;
-	JHDF5Object_t* object = obj[0];
-	guint mem_space_idx;
-	guint file_space_idx;
-	JHDF5IndexRange* mem_space_range = NULL;
-	JHDF5IndexRange* file_space_range = NULL;
-	guint64 current_count1;
-	guint64 current_count2;
-	guint i;
-	/// \todo support multi-write
-	void* buf0 = *buf;
-	hid_t mem_type_id0 = *mem_type_id;
-	hid_t mem_space_id0 = *mem_space_id;
-	hid_t file_space_id0 = *file_space_id;
+	size_t first;
+	size_t last;
 
 	(void)dxpl_id;
-	(void)req;
-
-	/// \todo Should we support multiple dset?
-	g_return_val_if_fail(count == 1, 1);
-	g_return_val_if_fail(buf0 != NULL, 1);
-	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_DATASET, 1);
 
-	data_size = object->dataset.datatype->datatype.type_total_size;
+	g_return_val_if_fail(count > 0, 1);
 
-	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
+	for (size_t i = 0; i < count; i++)
 	{
-		j_goto_error();
-	}
+		JHDF5Object_t* object = obj[i];
 
-	if (!(mem_space_arr = H5VL_julea_db_space_hdf5_to_range(mem_space_id0, object->dataset.space->space.hdf5_id)))
-	{
-		j_goto_error();
+		g_return_val_if_fail(buf[i] != NULL, 1);
+		g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_DATASET, 1);
 	}
 
-	if (!(file_space_arr = H5VL_julea_db_space_hdf5_to_range(file_space_id0, object->dataset.space->space.hdf5_id)))
+	for (first = 0; first < count; first = last)
 	{
-		j_goto_error();
+		for (last = first + 1; last < count; last++)
+		{
+			gboolean duplicate = FALSE;
+
+			for (size_t j = first; j < last; j++)
+			{
+				duplicate = duplicate || (obj[j] == obj[last]);
+			}
+
+			if (duplicate)
+			{
+				break;
+			}
+		}
+
+		if (!H5VL_julea_db_dataset_write_multi(last - first, obj + first, mem_type_id + first, mem_space_id + first, file_space_id + first, buf + first, (first == 0 && last == count) ? req : NULL))
+		{
+			return 1;
+		}
 	}
 
-	data_count = 0;
+	return 0;
+}
+
+/**
+ * Reads one or more datasets.
+ * All datasets share a single batch, so that reading many small datasets does not require a round trip per dataset.
+ * If req is not NULL, the batch is executed asynchronously and *req is set to the request.
+ **/
+herr_t
+H5VL_julea_db_dataset_read(size_t count, void* obj[], hid_t mem_type_id[], hid_t mem_space_id[],
+			   hid_t file_space_id[], hid_t dxpl_id, void* buf[], void** req)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JBatch) batch = NULL;
+	JHDF5DatasetIO* io;
+	gboolean pending = FALSE;
+	size_t i;
+
+	(void)dxpl_id;
+
+	g_return_val_if_fail(count > 0, 1);
 
-	for (i = 0; i < mem_space_arr->len; i++)
+	for (i = 0; i < count; i++)
 	{
-		mem_space_range = &g_array_index(mem_space_arr, JHDF5IndexRange, i);
-		data_count += mem_space_range->stop - mem_space_range->start;
+		JHDF5Object_t* object = obj[i];
+
+		g_return_val_if_fail(buf[i] != NULL, 1);
+		g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_DATASET, 1);
 	}
 
-	local_buf_org = g_new(char, data_size* data_count);
+	H5VL_julea_db_dataset_wait(count, obj);
 
-	mem_space_idx = 0;
-	file_space_idx = 0;
+	io = H5VL_julea_db_dataset_io_new(count);
 
-	while ((mem_space_idx < mem_space_arr->len) && (file_space_idx < file_space_arr->len))
+	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
 	{
-		if (mem_space_range == NULL)
+		j_goto_error();
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		JHDF5DatasetTransfer* transfer = &io->transfers[i];
+		JHDF5Object_t* object = obj[i];
+
+		if (!H5VL_julea_db_dataset_transfer_init(transfer, object, mem_type_id[i], mem_space_id[i], file_space_id[i], buf[i]))
 		{
-			mem_space_range = &g_array_index(mem_space_arr, JHDF5IndexRange, mem_space_idx++);
+			j_goto_error();
 		}
 
-		if (file_space_range == NULL)
+		if (transfer->mem_extent == 0)
 		{
-			file_space_range = &g_array_index(file_space_arr, JHDF5IndexRange, file_space_idx++);
+			continue;
 		}
 
-		current_count1 = mem_space_range->stop - mem_space_range->start;
-		current_count2 = file_space_range->stop - file_space_range->start;
-		current_count1 = current_count1 < current_count2 ? current_count1 : current_count2;
-		j_distributed_object_read(object->dataset.object, ((char*)buf0) + mem_space_range->start * data_size, data_size * current_count1, file_space_range->start * data_size, &bytes_read, batch);
+		H5VL_julea_db_dataset_transfer_prepare(transfer);
 
-		if (mem_space_range->start + current_count1 == mem_space_range->stop)
+		if (object->dataset.chunk.ndims == 0)
 		{
-			mem_space_range = NULL;
+			H5VL_julea_db_dataset_read_contiguous(transfer, batch);
+			pending = TRUE;
 		}
-
-		if (file_space_range->start + current_count1 == file_space_range->stop)
+		else if (object->dataset.filter.count > 0)
 		{
-			file_space_range = NULL;
+			pending = H5VL_julea_db_dataset_read_filtered(transfer, batch) || pending;
+		}
+		else
+		{
+			pending = H5VL_julea_db_dataset_read_raw(transfer, batch) || pending;
 		}
 	}
 
-	if (!j_batch_execute(batch))
+	if (pending && req != NULL)
 	{
-		j_goto_error();
+		H5VL_julea_db_dataset_io_execute_async(io, batch, H5VL_julea_db_dataset_read_complete, req);
+
+		return 0;
 	}
 
-	local_buf = H5VL_julea_db_datatype_convert_type(mem_type_id0, object->dataset.datatype->datatype.hdf5_id, buf0, local_buf_org, data_count);
+	// batches without operations fail to execute
+	if (pending && !j_batch_execute(batch))
+	{
+		j_goto_error();
+	}
 
-	if (local_buf != buf0)
+	if (!H5VL_julea_db_dataset_read_complete(io, TRUE))
 	{
-		memcpy(buf0, local_buf, data_size * data_count);
+		j_goto_error();
 	}
 
+	H5VL_julea_db_dataset_io_free(io);
+
 	return 0;
 
 _error:
+	H5VL_julea_db_dataset_io_free(io);
+
 	return 1;
 }
 
@@ -1153,6 +3201,37 @@ H5VL_julea_db_dataset_get(void* obj, H5VL_dataset_get_args_t* args, hid_t dxpl_i
 		case H5VL_DATASET_GET_DCPL:
 			/// \todo modify when we support different access and create property lists
 			args->args.get_dcpl.dcpl_id = H5P_DEFAULT;
+
+			if (object->dataset.chunk.ndims > 0)
+			{
+				hid_t dcpl_id;
+
+				if ((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+				{
+					return 1;
+				}
+
+				if (H5Pset_chunk(dcpl_id, object->dataset.chunk.ndims, object->dataset.chunk.dims) < 0)
+				{
+					H5Pclose(dcpl_id);
+					return 1;
+				}
+
+				if (!H5VL_julea_db_filter_to_dcpl(object->dataset.filter.list, object->dataset.filter.count, dcpl_id))
+				{
+					H5Pclose(dcpl_id);
+					return 1;
+				}
+
+				if (object->dataset.chunk.fill != NULL && H5Pset_fill_value(dcpl_id, object->dataset.datatype->datatype.hdf5_id, object->dataset.chunk.fill) < 0)
+				{
+					H5Pclose(dcpl_id);
+					return 1;
+				}
+
+				args->args.get_dcpl.dcpl_id = dcpl_id;
+			}
+
 			break;
 		case H5VL_DATASET_GET_SPACE:
 			args->args.get_space.space_id = object->dataset.space->space.hdf5_id;
@@ -1269,7 +3348,10 @@ H5VL_julea_db_dataset_close(void* obj, hid_t dxpl_id, void** req)
 		j_goto_error();
 	}
 
-	H5VL_julea_db_object_unref(object);
+	if (!H5VL_julea_db_object_unref(object))
+	{
+		return 1;
+	}
 
 	return 0;
 
@@ -1280,3 +3362,133 @@ _error:
 
 	return 1;
 }
+
+/**
+ * Selects the parts of a dataset that may contain values within [min, max].
+ *
+ * The selection of space is replaced by the union of all chunks whose zone maps overlap the range, clipped to the extent of the dataset.
+ * Chunks that have not been written consist of zeros.
+ * Contiguous datasets only have global statistics and are either selected completely or not at all.
+ * Datasets with unsupported datatypes are always selected completely.
+ *
+ * \param dataset_id A dataset.
+ * \param space_id   A dataspace with the same rank as the dataset.
+ * \param min        The lower bound of the range.
+ * \param max        The upper bound of the range.
+ *
+ * \return A non-negative value on success, a negative value otherwise.
+ **/
+herr_t
+j_hdf5_dataset_select_range(hid_t dataset_id, hid_t space_id, gdouble min, gdouble max)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree hsize_t* dims = NULL;
+	g_autofree hsize_t* start = NULL;
+	g_autofree hsize_t* count = NULL;
+	JHDF5Object_t* object;
+	JHDF5StatisticsKind kind;
+	gchar connector[16];
+	guint64 chunks = 1;
+	guint ndims;
+	gboolean unwritten;
+
+	if (H5VLget_connector_name(dataset_id, connector, sizeof(connector)) < 0 || g_strcmp0(connector, "julea-db") != 0)
+	{
+		j_goto_error();
+	}
+
+	if ((object = H5VLobject(dataset_id)) == NULL || object->type != J_HDF5_OBJECT_TYPE_DATASET)
+	{
+		j_goto_error();
+	}
+
+	// the zone maps of pending writes are only known once they have been completed
+	H5VL_julea_db_dataset_wait(1, (void**)&object);
+
+	kind = H5VL_julea_db_statistics_kind(object->dataset.datatype->datatype.hdf5_id);
+
+	if (kind == J_HDF5_STATISTICS_NONE)
+	{
+		return H5Sselect_all(space_id);
+	}
+
+	if (object->dataset.chunk.ndims == 0)
+	{
+		if (H5VL_julea_db_statistics_overlaps(&object->dataset.statistics, kind, min, max))
+		{
+			return H5Sselect_all(space_id);
+		}
+
+		return H5Sselect_none(space_id);
+	}
+
+	ndims = object->dataset.chunk.ndims;
+
+	if (H5Sget_simple_extent_ndims(space_id) != (gint)ndims)
+	{
+		j_goto_error();
+	}
+
+	dims = g_new(hsize_t, ndims);
+	start = g_new(hsize_t, ndims);
+	count = g_new(hsize_t, ndims);
+	H5Sget_simple_extent_dims(object->dataset.space->space.hdf5_id, dims, NULL);
+
+	for (guint i = 0; i < ndims; i++)
+	{
+		chunks *= (dims[i] + object->dataset.chunk.dims[i] - 1) / object->dataset.chunk.dims[i];
+	}
+
+	// chunks that have not been written contain the fill value
+	if (object->dataset.chunk.fill != NULL)
+	{
+		JHDF5Statistics fill;
+
+		H5VL_julea_db_statistics_init(&fill);
+		H5VL_julea_db_statistics_compute(kind, object->dataset.chunk.fill, 1, &fill);
+		unwritten = H5VL_julea_db_statistics_overlaps(&fill, kind, min, max);
+	}
+	else
+	{
+		unwritten = (min <= 0 && max >= 0);
+	}
+
+	if (H5Sselect_none(space_id) < 0)
+	{
+		j_goto_error();
+	}
+
+	for (guint64 chunk = 0; chunk < chunks; chunk++)
+	{
+		JHDF5Chunk const* stored;
+		guint64 index = chunk;
+
+		stored = g_hash_table_lookup(object->dataset.chunk.stored, &chunk);
+
+		if ((stored == NULL && !unwritten) || (stored != NULL && !H5VL_julea_db_statistics_overlaps(&stored->statistics, kind, min, max)))
+		{
+			continue;
+		}
+
+		for (guint i = ndims; i > 0; i--)
+		{
+			hsize_t chunk_dim = object->dataset.chunk.dims[i - 1];
+			guint64 chunk_count = (dims[i - 1] + chunk_dim - 1) / chunk_dim;
+
+			start[i - 1] = (index % chunk_count) * chunk_dim;
+			count[i - 1] = MIN(chunk_dim, dims[i - 1] - start[i - 1]);
+			index /= chunk_count;
+		}
+
+		if (H5Sselect_hyperslab(space_id, H5S_SELECT_OR, start, NULL, count, NULL) < 0)
+		{
+			j_goto_error();
+		}
+	}
+
+	return 0;
+
+_error:
+	return -1;
+}
@@ -44,55 +44,82 @@
 
 JDBSchema* julea_db_schema_datatype_header = NULL;
 
-static const void*
-H5VL_julea_db_datatype_convert_type_change(hid_t type_id_from, hid_t type_id_to, const char* from_buf, char* target_buf, guint count)
+/**
+ * Conversions are performed in blocks of this size, so that each block is still cached when it is converted.
+ **/
+#define J_HDF5_DB_DATATYPE_CONVERT_BLOCK_SIZE (1024 * 1024)
+
+/**
+ * Converts elements between two datatypes.
+ * Elements are copied into a buffer of fixed size and converted there, because HDF5 converts in place and the destination may be larger than the source.
+ * Compound datatypes are converted using the destination's current contents as background, so that members missing in the source are preserved.
+ *
+ * \param from_buf The elements to convert.
+ * \param to_buf   The buffer for the converted elements, which may be from_buf to convert in place if both datatypes have the same size.
+ * \param count    The number of elements.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_datatype_convert(hid_t type_id_from, hid_t type_id_to, const gchar* from_buf, gchar* to_buf, guint64 count)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	(void)from_buf;
-	(void)count;
-
-	g_assert(H5Tget_class(type_id_from) == H5Tget_class(type_id_to));
-	g_assert(H5Tget_size(type_id_from) == H5Tget_size(type_id_to));
-
-	/// \todo doesn't do anything?
-
-	switch (H5Tget_class(type_id_from))
-	{
-		case H5T_FLOAT: // no conversion
-			break;
-		case H5T_INTEGER: // no conversion
-			break;
-		case H5T_STRING:
-		case H5T_BITFIELD:
-		case H5T_OPAQUE:
-		case H5T_COMPOUND:
-		case H5T_REFERENCE:
-		case H5T_ENUM:
-		case H5T_VLEN:
-		case H5T_ARRAY:
-		case H5T_NO_CLASS:
-		case H5T_TIME:
-		case H5T_NCLASSES:
-		default:
-			g_critical("%s NOT implemented !!", G_STRLOC);
-			g_assert_not_reached();
+	g_autofree gchar* block = NULL;
+	g_autofree gchar* background = NULL;
+	gsize from_size;
+	gsize to_size;
+	guint64 block_count;
+
+	from_size = H5Tget_size(type_id_from);
+	to_size = H5Tget_size(type_id_to);
+
+	if (from_size == 0 || to_size == 0)
+	{
+		return FALSE;
 	}
 
-	return target_buf;
-}
+	g_return_val_if_fail(from_buf != to_buf || from_size == to_size, FALSE);
 
-const void*
-H5VL_julea_db_datatype_convert_type(hid_t type_id_from, hid_t type_id_to, const char* from_buf, char* tmp_buf, guint count)
-{
-	J_TRACE_FUNCTION(NULL);
+	if (H5Tequal(type_id_from, type_id_to) > 0)
+	{
+		if (from_buf != to_buf)
+		{
+			memcpy(to_buf, from_buf, from_size * count);
+		}
+
+		return TRUE;
+	}
+
+	block_count = MAX(J_HDF5_DB_DATATYPE_CONVERT_BLOCK_SIZE / MAX(from_size, to_size), 1);
+	block_count = MIN(block_count, count);
+	block = g_malloc(block_count * MAX(from_size, to_size));
 
-	if (H5Tequal(type_id_from, type_id_to))
+	if (H5Tdetect_class(type_id_from, H5T_COMPOUND) > 0 || H5Tdetect_class(type_id_to, H5T_COMPOUND) > 0)
 	{
-		return from_buf;
+		background = g_malloc(block_count * to_size);
+	}
+
+	for (guint64 i = 0; i < count; i += block_count)
+	{
+		guint64 n = MIN(block_count, count - i);
+
+		memcpy(block, from_buf + i * from_size, n * from_size);
+
+		if (background != NULL)
+		{
+			memcpy(background, to_buf + i * to_size, n * to_size);
+		}
+
+		if (H5Tconvert(type_id_from, type_id_to, n, block, background, H5P_DEFAULT) < 0)
+		{
+			return FALSE;
+		}
+
+		memcpy(to_buf + i * to_size, block, n * to_size);
 	}
 
-	return H5VL_julea_db_datatype_convert_type_change(type_id_from, type_id_to, from_buf, tmp_buf, count);
+	return TRUE;
 }
 
 herr_t
@@ -694,6 +694,11 @@ H5VL_julea_db_file_specific(void* obj, H5VL_file_specific_args_t* args, hid_t dx
 	switch (args->op_type)
 	{
 		case H5VL_FILE_FLUSH:
+			if (!H5VL_julea_db_metadata_flush(object))
+			{
+				j_goto_error();
+			}
+			break;
 		case H5VL_FILE_REOPEN:
 			g_warning("%s: Feature number %i is not implemented!", G_STRFUNC, args->op_type);
 			break;
@@ -743,13 +748,23 @@ H5VL_julea_db_file_close(void* obj, hid_t dxpl_id, void** req)
 	J_TRACE_FUNCTION(NULL);
 
 	JHDF5Object_t* object = obj;
+	herr_t ret = 0;
 
 	(void)dxpl_id;
 	(void)req;
 
 	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_FILE, 1);
 
-	H5VL_julea_db_object_unref(object);
+	// the file object may outlive this call if other objects are still open
+	if (!H5VL_julea_db_metadata_flush(object))
+	{
+		ret = 1;
+	}
 
-	return 0;
+	if (!H5VL_julea_db_object_unref(object))
+	{
+		ret = 1;
+	}
+
+	return ret;
 }
@@ -0,0 +1,396 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <hdf5.h>
+#include <H5PLextern.h>
+
+#include <string.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#include <julea.h>
+#include <julea-db.h>
+#include <julea-object.h>
+
+#include "jhdf5-db.h"
+
+/*
+ * Chunks are encoded by applying the filter pipeline in order and decoded by applying it in reverse.
+ * Shuffle filters have to precede the compressor and there can be at most one compressor.
+ * If compression does not reduce the size of a chunk, the chunk is stored raw, which is detected by its stored size being equal to the chunk size.
+ */
+
+#define J_HDF5_ZSTD_DEFAULT_LEVEL 3
+
+static gboolean
+H5VL_julea_db_filter_is_compressor(guint32 id)
+{
+	return id == J_HDF5_FILTER_ZSTD || id == J_HDF5_FILTER_LZ4;
+}
+
+static gboolean
+H5VL_julea_db_filter_is_supported(guint32 id)
+{
+	switch (id)
+	{
+		case H5Z_FILTER_SHUFFLE:
+			return TRUE;
+		case J_HDF5_FILTER_ZSTD:
+#ifdef HAVE_ZSTD
+			return TRUE;
+#else
+			return FALSE;
+#endif
+		case J_HDF5_FILTER_LZ4:
+#ifdef HAVE_LZ4
+			return TRUE;
+#else
+			return FALSE;
+#endif
+		default:
+			return FALSE;
+	}
+}
+
+static void
+H5VL_julea_db_filter_shuffle(guchar* out, guchar const* in, guint64 length, gsize element_size)
+{
+	guint64 n = length / element_size;
+
+	for (gsize b = 0; b < element_size; b++)
+	{
+		for (guint64 i = 0; i < n; i++)
+		{
+			out[b * n + i] = in[i * element_size + b];
+		}
+	}
+
+	// trailing bytes that do not form a complete element are copied unchanged
+	memcpy(out + n * element_size, in + n * element_size, length - n * element_size);
+}
+
+static void
+H5VL_julea_db_filter_unshuffle(guchar* out, guchar const* in, guint64 length, gsize element_size)
+{
+	guint64 n = length / element_size;
+
+	for (gsize b = 0; b < element_size; b++)
+	{
+		for (guint64 i = 0; i < n; i++)
+		{
+			out[i * element_size + b] = in[b * n + i];
+		}
+	}
+
+	memcpy(out + n * element_size, in + n * element_size, length - n * element_size);
+}
+
+static gboolean
+H5VL_julea_db_filter_compress(JHDF5Filter const* filter, gconstpointer data, guint64 length, gpointer* compressed, guint64* compressed_length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (filter->id)
+	{
+#ifdef HAVE_ZSTD
+		case J_HDF5_FILTER_ZSTD:
+		{
+			gsize bound = ZSTD_compressBound(length);
+			gsize size;
+
+			*compressed = g_malloc(bound);
+			size = ZSTD_compress(*compressed, bound, data, length, filter->level);
+
+			if (ZSTD_isError(size))
+			{
+				g_debug("%s: %s", G_STRFUNC, ZSTD_getErrorName(size));
+				j_goto_error();
+			}
+
+			*compressed_length = size;
+		}
+		break;
+#endif
+#ifdef HAVE_LZ4
+		case J_HDF5_FILTER_LZ4:
+		{
+			gint bound;
+			gint size;
+
+			if (length > LZ4_MAX_INPUT_SIZE)
+			{
+				j_goto_error();
+			}
+
+			bound = LZ4_compressBound(length);
+			*compressed = g_malloc(bound);
+
+			if ((size = LZ4_compress_default(data, *compressed, length, bound)) <= 0)
+			{
+				j_goto_error();
+			}
+
+			*compressed_length = size;
+		}
+		break;
+#endif
+		default:
+			j_goto_error();
+	}
+
+	return TRUE;
+
+_error:
+	g_free(*compressed);
+	*compressed = NULL;
+
+	return FALSE;
+}
+
+static gboolean
+H5VL_julea_db_filter_decompress(JHDF5Filter const* filter, gconstpointer compressed, guint64 compressed_length, gpointer data, guint64 length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (filter->id)
+	{
+#ifdef HAVE_ZSTD
+		case J_HDF5_FILTER_ZSTD:
+		{
+			gsize size;
+
+			size = ZSTD_decompress(data, length, compressed, compressed_length);
+
+			if (ZSTD_isError(size) || size != length)
+			{
+				j_goto_error();
+			}
+		}
+		break;
+#endif
+#ifdef HAVE_LZ4
+		case J_HDF5_FILTER_LZ4:
+			if (LZ4_decompress_safe(compressed, data, compressed_length, length) != (gint)length)
+			{
+				j_goto_error();
+			}
+			break;
+#endif
+		default:
+			j_goto_error();
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+H5VL_julea_db_filter_from_dcpl(hid_t dcpl_id, GArray* filters)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean compressor = FALSE;
+	gint count;
+
+	g_return_val_if_fail(filters != NULL, FALSE);
+
+	if ((count = H5Pget_nfilters(dcpl_id)) < 0)
+	{
+		j_goto_error();
+	}
+
+	for (gint i = 0; i < count; i++)
+	{
+		JHDF5Filter filter;
+		H5Z_filter_t id;
+		guint flags;
+		guint cd_values[8];
+		gsize cd_nelmts = G_N_ELEMENTS(cd_values);
+
+		if ((id = H5Pget_filter2(dcpl_id, i, &flags, &cd_nelmts, cd_values, 0, NULL, NULL)) < 0)
+		{
+			j_goto_error();
+		}
+
+		// nothing may follow the compressor
+		if (!H5VL_julea_db_filter_is_supported(id) || compressor)
+		{
+			if (flags & H5Z_FLAG_OPTIONAL)
+			{
+				g_debug("%s: Skipping unsupported optional filter %d.", G_STRFUNC, id);
+				continue;
+			}
+
+			g_debug("%s: Unsupported filter %d!", G_STRFUNC, id);
+			j_goto_error();
+		}
+
+		filter.id = id;
+		filter.level = 0;
+
+		if (id == J_HDF5_FILTER_ZSTD)
+		{
+			filter.level = (cd_nelmts > 0) ? cd_values[0] : J_HDF5_ZSTD_DEFAULT_LEVEL;
+		}
+
+		compressor = compressor || H5VL_julea_db_filter_is_compressor(id);
+
+		g_array_append_val(filters, filter);
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
+gboolean
+H5VL_julea_db_filter_to_dcpl(JHDF5Filter const* filters, guint count, hid_t dcpl_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	for (guint i = 0; i < count; i++)
+	{
+		if (filters[i].id == H5Z_FILTER_SHUFFLE)
+		{
+			if (H5Pset_shuffle(dcpl_id) < 0)
+			{
+				return FALSE;
+			}
+		}
+		else
+		{
+			guint cd_values[1] = { filters[i].level };
+
+			if (H5Pset_filter(dcpl_id, filters[i].id, H5Z_FLAG_OPTIONAL, (filters[i].id == J_HDF5_FILTER_ZSTD) ? 1 : 0, cd_values) < 0)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+gboolean
+H5VL_julea_db_filter_encode(JHDF5Filter const* filters, guint count, gsize element_size, gconstpointer data, guint64 length, gpointer* encoded, guint64* encoded_length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree guchar* shuffled = NULL;
+	gconstpointer current = data;
+
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(encoded != NULL, FALSE);
+	g_return_val_if_fail(encoded_length != NULL, FALSE);
+
+	*encoded = NULL;
+
+	for (guint i = 0; i < count; i++)
+	{
+		if (filters[i].id == H5Z_FILTER_SHUFFLE)
+		{
+			guchar* out;
+
+			out = g_malloc(length);
+			H5VL_julea_db_filter_shuffle(out, current, length, element_size);
+			g_free(shuffled);
+			shuffled = out;
+			current = shuffled;
+		}
+		else
+		{
+			if (!H5VL_julea_db_filter_compress(&filters[i], current, length, encoded, encoded_length))
+			{
+				return FALSE;
+			}
+
+			if (*encoded_length < length)
+			{
+				return TRUE;
+			}
+
+			g_clear_pointer(encoded, g_free);
+		}
+	}
+
+	// store raw data if the chunk could not be compressed
+#if GLIB_CHECK_VERSION(2, 68, 0)
+	*encoded = g_memdup2(data, length);
+#else
+	*encoded = g_memdup(data, length);
+#endif
+	*encoded_length = length;
+
+	return TRUE;
+}
+
+gboolean
+H5VL_julea_db_filter_decode(JHDF5Filter const* filters, guint count, gsize element_size, gconstpointer encoded, guint64 encoded_length, gpointer data, guint64 length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree guchar* tmp = NULL;
+
+	g_return_val_if_fail(encoded != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	if (encoded_length == length)
+	{
+		memcpy(data, encoded, length);
+
+		return TRUE;
+	}
+
+	tmp = g_malloc(length);
+
+	// the compressor is always the last filter
+	if (count == 0 || !H5VL_julea_db_filter_decompress(&filters[count - 1], encoded, encoded_length, tmp, length))
+	{
+		return FALSE;
+	}
+
+	memcpy(data, tmp, length);
+
+	for (guint i = count - 1; i > 0; i--)
+	{
+		if (filters[i - 1].id == H5Z_FILTER_SHUFFLE)
+		{
+			H5VL_julea_db_filter_unshuffle(data, tmp, length, element_size);
+			memcpy(tmp, data, length);
+		}
+	}
+
+	return TRUE;
+}
@@ -464,13 +464,23 @@ H5VL_julea_db_group_close(void* obj, hid_t dxpl_id, void** req)
 	J_TRACE_FUNCTION(NULL);
 
 	JHDF5Object_t* object = obj;
+	herr_t ret = 0;
 
 	(void)dxpl_id;
 	(void)req;
 
 	g_return_val_if_fail(object->type == J_HDF5_OBJECT_TYPE_GROUP, 1);
 
-	H5VL_julea_db_object_unref(object);
+	// writes the metadata of the group's children
+	if (!H5VL_julea_db_metadata_flush(object))
+	{
+		ret = 1;
+	}
 
-	return 0;
+	if (!H5VL_julea_db_object_unref(object))
+	{
+		ret = 1;
+	}
+
+	return ret;
 }
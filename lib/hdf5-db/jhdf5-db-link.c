@@ -265,12 +265,7 @@ H5VL_julea_db_link_get_helper(JHDF5Object_t* parent, JHDF5Object_t* child, const
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_autoptr(GError) error = NULL;
-	g_autoptr(JDBIterator) iterator = NULL;
-	g_autoptr(JDBSelector) selector = NULL;
-	g_autofree gpointer child_type = NULL;
-	JDBType type;
-	size_t size;
+	gboolean exists;
 
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(parent != NULL, FALSE);
@@ -282,56 +277,20 @@ H5VL_julea_db_link_get_helper(JHDF5Object_t* parent, JHDF5Object_t* child, const
 		parent = parent->file.root_group;
 	}
 
-	if (!(selector = j_db_selector_new(julea_db_schema_link, J_DB_SELECTOR_MODE_AND, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(selector, "parent", J_DB_SELECTOR_OPERATOR_EQ, parent->backend_id, parent->backend_id_len, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(selector, "parent_type", J_DB_SELECTOR_OPERATOR_EQ, &parent->type, sizeof(parent->type), &error))
+	if (!H5VL_julea_db_metadata_link_get(parent, name, child, &exists))
 	{
 		j_goto_error();
 	}
 
-	if (!j_db_selector_add_field(selector, "name", J_DB_SELECTOR_OPERATOR_EQ, name, strlen(name), &error))
-	{
-		j_goto_error();
-	}
-
-	if (!(iterator = j_db_iterator_new(julea_db_schema_link, selector, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_iterator_next(iterator, &error))
+	if (!exists)
 	{
 		//name must exist for parent before
 		j_goto_error();
 	}
 
-	if (!j_db_iterator_get_field(iterator, NULL, "child", &type, &child->backend_id, &child->backend_id_len, &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_iterator_get_field(iterator, NULL, "child_type", &type, &child_type, &size, &error))
-	{
-		j_goto_error();
-	}
-
-	child->type = *(JHDF5ObjectType*)child_type;
-
-	g_assert(!j_db_iterator_next(iterator, NULL));
-
 	return TRUE;
 
 _error:
-	H5VL_julea_db_error_handler(error);
-
 	return FALSE;
 }
 
@@ -341,11 +300,9 @@ H5VL_julea_db_link_create_helper(JHDF5Object_t* parent, JHDF5Object_t* child, co
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(GError) error = NULL;
-	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JDBEntry) entry = NULL;
-	g_autoptr(JDBIterator) iterator = NULL;
-	g_autoptr(JDBSelector) selector = NULL;
 	JHDF5Object_t* file;
+	gboolean exists;
 
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(parent != NULL, FALSE);
@@ -395,37 +352,12 @@ H5VL_julea_db_link_create_helper(JHDF5Object_t* parent, JHDF5Object_t* child, co
 			j_goto_error();
 	}
 
-	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
-	{
-		j_goto_error();
-	}
-
-	if (!(selector = j_db_selector_new(julea_db_schema_link, J_DB_SELECTOR_MODE_AND, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(selector, "parent", J_DB_SELECTOR_OPERATOR_EQ, parent->backend_id, parent->backend_id_len, &error))
+	if (!H5VL_julea_db_metadata_link_get(parent, name, NULL, &exists))
 	{
 		j_goto_error();
 	}
 
-	if (!j_db_selector_add_field(selector, "parent_type", J_DB_SELECTOR_OPERATOR_EQ, &parent->type, sizeof(parent->type), &error))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(selector, "name", J_DB_SELECTOR_OPERATOR_EQ, name, strlen(name), &error))
-	{
-		j_goto_error();
-	}
-
-	if (!(iterator = j_db_iterator_new(julea_db_schema_link, selector, &error)))
-	{
-		j_goto_error();
-	}
-
-	if (j_db_iterator_next(iterator, NULL))
+	if (exists)
 	{
 		//name must not exist for parent before
 		j_goto_error();
@@ -466,15 +398,13 @@ H5VL_julea_db_link_create_helper(JHDF5Object_t* parent, JHDF5Object_t* child, co
 		j_goto_error();
 	}
 
-	if (!j_db_entry_insert(entry, batch, &error))
+	// the link is written together with other pending metadata
+	if (!H5VL_julea_db_metadata_insert(file, entry, &error))
 	{
 		j_goto_error();
 	}
 
-	if (!j_batch_execute(batch))
-	{
-		j_goto_error();
-	}
+	H5VL_julea_db_metadata_link_add(parent, name, child);
 
 	return TRUE;
 
@@ -620,6 +550,12 @@ H5VL_julea_db_link_iterate_helper(JHDF5Object_t* object, hbool_t recursive, gboo
 		j_goto_error();
 	}
 
+	// links may still be pending
+	if (!H5VL_julea_db_metadata_flush(curr_parent_obj))
+	{
+		j_goto_error();
+	}
+
 	// build selector (parent == backend_id && parent_type == object/file)
 	if ((link_selector = j_db_selector_new(julea_db_schema_link, J_DB_SELECTOR_MODE_AND, NULL)) == NULL)
 	{
@@ -719,42 +655,20 @@ _error:
 herr_t
 H5VL_julea_db_link_exists_helper(JHDF5Object_t* object, const gchar* name, hbool_t* exists)
 {
-	g_autoptr(JDBSelector) link_selector = NULL;
-	g_autoptr(JDBIterator) link_iterator = NULL;
-	g_autoptr(GError) err = NULL;
+	gboolean found;
 
-	if ((link_selector = j_db_selector_new(julea_db_schema_link, J_DB_SELECTOR_MODE_AND, NULL)) == NULL)
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(link_selector, "parent", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, NULL))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(link_selector, "parent_type", J_DB_SELECTOR_OPERATOR_EQ, &object->type, sizeof(JHDF5ObjectType), NULL))
-	{
-		j_goto_error();
-	}
-
-	if (!j_db_selector_add_field(link_selector, "name", J_DB_SELECTOR_OPERATOR_EQ, name, strlen(name), NULL))
+	// special case: file -> root group
+	if (object->type == J_HDF5_OBJECT_TYPE_FILE)
 	{
-		j_goto_error();
+		object = object->file.root_group;
 	}
 
-	if ((link_iterator = j_db_iterator_new(julea_db_schema_link, link_selector, NULL)) == NULL)
+	if (!H5VL_julea_db_metadata_link_get(object, name, NULL, &found))
 	{
 		j_goto_error();
 	}
 
-	*exists = j_db_iterator_next(link_iterator, &err);
-
-	if (err != NULL)
-	{
-		g_error_free(err);
-		j_goto_error();
-	}
+	*exists = found;
 
 	return 0;
 
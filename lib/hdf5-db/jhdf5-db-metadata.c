@@ -0,0 +1,960 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <string.h>
+
+#include <hdf5.h>
+#include <H5PLextern.h>
+
+#include <julea.h>
+#include <julea-db.h>
+
+#include "jhdf5-db.h"
+
+/*
+ * Attribute and link metadata is buffered per file.
+ * Inserts and updates are collected in a single batch that is executed when the file or a group is closed, the file is flushed or too many operations are pending.
+ * The links of a parent and the attributes attached to it are loaded with one query when they are accessed for the first time.
+ * New attributes are only linked to their parents once their IDs are known, that is, after their entries have been inserted.
+ * Their links are therefore written by a second batch when flushing, so that creating many attributes does not require a round trip per attribute.
+ * The cache assumes that a file is only modified through one file object at a time.
+ */
+
+/// number of pending operations that triggers a flush
+#define J_HDF5_DB_METADATA_THRESHOLD 256
+
+/// number of attributes fetched per query, selectors are limited to 500 fields
+#define J_HDF5_DB_METADATA_PREFETCH_COUNT 256
+
+struct JHDF5Link
+{
+	void* child;
+	guint64 child_len;
+	JHDF5ObjectType child_type;
+};
+
+typedef struct JHDF5Link JHDF5Link;
+
+struct JHDF5AttrRecord
+{
+	void* datatype;
+	guint64 datatype_len;
+	void* space;
+	guint64 space_len;
+	void* data;
+	guint64 data_len;
+};
+
+typedef struct JHDF5AttrRecord JHDF5AttrRecord;
+
+/**
+ * An attribute whose entry has been queued but not inserted yet.
+ **/
+struct JHDF5PendingAttr
+{
+	JHDF5Object_t* parent;
+	gchar* parent_key;
+	JHDF5Object_t* attr;
+	JDBEntry* entry;
+	/// whether the data has been set in the entry
+	gboolean written;
+	gpointer data;
+	guint64 data_len;
+};
+
+typedef struct JHDF5PendingAttr JHDF5PendingAttr;
+
+struct JHDF5Metadata
+{
+	/// pending inserts and updates
+	JBatch* batch;
+	guint pending;
+	/// attributes that have to be linked to their parents, see JHDF5PendingAttr
+	GPtrArray* attrs_pending;
+
+	/// maps parent keys to tables mapping link names to JHDF5Link
+	GHashTable* links;
+	/// maps attribute keys to JHDF5AttrRecord
+	GHashTable* attrs;
+	/// parent keys whose attributes have already been fetched
+	GHashTable* prefetched;
+};
+
+static gpointer
+H5VL_julea_db_metadata_memdup(gconstpointer data, guint64 length)
+{
+	if (length == 0)
+	{
+		return NULL;
+	}
+
+#if GLIB_CHECK_VERSION(2, 68, 0)
+	return g_memdup2(data, length);
+#else
+	return g_memdup(data, length);
+#endif
+}
+
+static void
+H5VL_julea_db_metadata_link_free(gpointer data)
+{
+	JHDF5Link* link = data;
+
+	g_free(link->child);
+	g_free(link);
+}
+
+static void
+H5VL_julea_db_metadata_attr_record_free(gpointer data)
+{
+	JHDF5AttrRecord* record = data;
+
+	g_free(record->datatype);
+	g_free(record->space);
+	g_free(record->data);
+	g_free(record);
+}
+
+static void
+H5VL_julea_db_metadata_pending_attr_free(gpointer data)
+{
+	JHDF5PendingAttr* pending = data;
+
+	H5VL_julea_db_object_unref(pending->parent);
+	H5VL_julea_db_object_unref(pending->attr);
+	j_db_entry_unref(pending->entry);
+	g_free(pending->parent_key);
+	g_free(pending->data);
+	g_free(pending);
+}
+
+static gchar*
+H5VL_julea_db_metadata_key(JHDF5Object_t* object)
+{
+	gchar prefix[2] = { 'a' + object->type, '\0' };
+
+	return H5VL_julea_db_buf_to_hex(prefix, object->backend_id, object->backend_id_len);
+}
+
+static JHDF5Metadata*
+H5VL_julea_db_metadata_of(JHDF5Object_t* object)
+{
+	JHDF5Object_t* file;
+
+	switch (object->type)
+	{
+		case J_HDF5_OBJECT_TYPE_FILE:
+			file = object;
+			break;
+		case J_HDF5_OBJECT_TYPE_DATASET:
+			file = object->dataset.file;
+			break;
+		case J_HDF5_OBJECT_TYPE_ATTR:
+			file = object->attr.file;
+			break;
+		case J_HDF5_OBJECT_TYPE_GROUP:
+			file = object->group.file;
+			break;
+		case J_HDF5_OBJECT_TYPE_DATATYPE:
+		case J_HDF5_OBJECT_TYPE_SPACE:
+		case _J_HDF5_OBJECT_TYPE_COUNT:
+		default:
+			g_assert_not_reached();
+			return NULL;
+	}
+
+	if (file->file.metadata == NULL)
+	{
+		file->file.metadata = H5VL_julea_db_metadata_new();
+	}
+
+	return file->file.metadata;
+}
+
+static gboolean
+H5VL_julea_db_metadata_queued(JHDF5Object_t* object, JHDF5Metadata* metadata)
+{
+	metadata->pending++;
+
+	if (metadata->pending >= J_HDF5_DB_METADATA_THRESHOLD)
+	{
+		return H5VL_julea_db_metadata_flush(object);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Returns the links of a parent, loading them if necessary.
+ *
+ * \param object The parent.
+ *
+ * \return A table mapping link names to JHDF5Link, or NULL on failure.
+ **/
+static GHashTable*
+H5VL_julea_db_metadata_links(JHDF5Object_t* object)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JDBIterator) iterator = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	g_autofree gchar* key = NULL;
+	JHDF5Metadata* metadata;
+	GHashTable* links = NULL;
+
+	metadata = H5VL_julea_db_metadata_of(object);
+	key = H5VL_julea_db_metadata_key(object);
+
+	if ((links = g_hash_table_lookup(metadata->links, key)) != NULL)
+	{
+		return links;
+	}
+
+	// pending links have to be visible to the query
+	if (!H5VL_julea_db_metadata_flush(object))
+	{
+		j_goto_error();
+	}
+
+	links = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, H5VL_julea_db_metadata_link_free);
+
+	if (!(selector = j_db_selector_new(julea_db_schema_link, J_DB_SELECTOR_MODE_AND, &error)))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_selector_add_field(selector, "parent", J_DB_SELECTOR_OPERATOR_EQ, object->backend_id, object->backend_id_len, &error))
+	{
+		j_goto_error();
+	}
+
+	if (!j_db_selector_add_field(selector, "parent_type", J_DB_SELECTOR_OPERATOR_EQ, &object->type, sizeof(object->type), &error))
+	{
+		j_goto_error();
+	}
+
+	if (!(iterator = j_db_iterator_new(julea_db_schema_link, selector, &error)))
+	{
+		j_goto_error();
+	}
+
+	while (j_db_iterator_next(iterator, NULL))
+	{
+		g_autofree gchar* name = NULL;
+		g_autofree gpointer child = NULL;
+		g_autofree gpointer child_type = NULL;
+		JHDF5Link* link;
+		JDBType type;
+		guint64 child_len;
+		guint64 length;
+
+		if (!j_db_iterator_get_field(iterator, NULL, "name", &type, (gpointer*)&name, &length, &error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "child", &type, &child, &child_len, &error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_db_iterator_get_field(iterator, NULL, "child_type", &type, &child_type, &length, &error))
+		{
+			j_goto_error();
+		}
+
+		link = g_new(JHDF5Link, 1);
+		link->child = g_steal_pointer(&child);
+		link->child_len = child_len;
+		link->child_type = *(JHDF5ObjectType*)child_type;
+
+		g_hash_table_replace(links, g_steal_pointer(&name), link);
+	}
+
+	g_hash_table_insert(metadata->links, g_steal_pointer(&key), links);
+
+	return links;
+
+_error:
+	H5VL_julea_db_error_handler(error);
+
+	if (links != NULL)
+	{
+		g_hash_table_unref(links);
+	}
+
+	return NULL;
+}
+
+/**
+ * Fetches the attributes attached to a parent.
+ *
+ * \param object The parent.
+ * \param links  The parent's links.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+H5VL_julea_db_metadata_prefetch(JHDF5Object_t* object, GHashTable* links)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) children = NULL;
+	JHDF5Metadata* metadata;
+	GHashTableIter iter;
+	gpointer value;
+
+	metadata = H5VL_julea_db_metadata_of(object);
+	children = g_ptr_array_new();
+
+	g_hash_table_iter_init(&iter, links);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		JHDF5Link* link = value;
+
+		if (link->child_type == J_HDF5_OBJECT_TYPE_ATTR)
+		{
+			g_ptr_array_add(children, link);
+		}
+	}
+
+	// updates of attributes that have not been fetched yet have to be visible to the query
+	if (children->len > 0 && !H5VL_julea_db_metadata_flush(object))
+	{
+		j_goto_error();
+	}
+
+	for (guint i = 0; i < children->len; i += J_HDF5_DB_METADATA_PREFETCH_COUNT)
+	{
+		g_autoptr(JDBIterator) iterator = NULL;
+		g_autoptr(JDBSelector) selector = NULL;
+		guint end = MIN(i + J_HDF5_DB_METADATA_PREFETCH_COUNT, children->len);
+
+		if (!(selector = j_db_selector_new(julea_db_schema_attr, J_DB_SELECTOR_MODE_OR, &error)))
+		{
+			j_goto_error();
+		}
+
+		for (guint j = i; j < end; j++)
+		{
+			JHDF5Link* link = g_ptr_array_index(children, j);
+
+			if (!j_db_selector_add_field(selector, "_id", J_DB_SELECTOR_OPERATOR_EQ, link->child, link->child_len, &error))
+			{
+				j_goto_error();
+			}
+		}
+
+		if (!(iterator = j_db_iterator_new(julea_db_schema_attr, selector, &error)))
+		{
+			j_goto_error();
+		}
+
+		while (j_db_iterator_next(iterator, NULL))
+		{
+			g_autofree gpointer id = NULL;
+			g_autofree gpointer datatype = NULL;
+			g_autofree gpointer space = NULL;
+			g_autofree gpointer data = NULL;
+			JHDF5AttrRecord* record;
+			JDBType type;
+			guint64 id_len;
+			guint64 datatype_len;
+			guint64 space_len;
+			guint64 data_len;
+			gchar prefix[2] = { 'a' + J_HDF5_OBJECT_TYPE_ATTR, '\0' };
+
+			if (!j_db_iterator_get_field(iterator, NULL, "_id", &type, &id, &id_len, &error))
+			{
+				j_goto_error();
+			}
+
+			if (!j_db_iterator_get_field(iterator, NULL, "datatype", &type, &datatype, &datatype_len, &error))
+			{
+				j_goto_error();
+			}
+
+			if (!j_db_iterator_get_field(iterator, NULL, "space", &type, &space, &space_len, &error))
+			{
+				j_goto_error();
+			}
+
+			if (!j_db_iterator_get_field(iterator, NULL, "data", &type, &data, &data_len, &error))
+			{
+				j_goto_error();
+			}
+
+			record = g_new(JHDF5AttrRecord, 1);
+			record->datatype = g_steal_pointer(&datatype);
+			record->datatype_len = datatype_len;
+			record->space = g_steal_pointer(&space);
+			record->space_len = space_len;
+			record->data = g_steal_pointer(&data);
+			record->data_len = data_len;
+
+			g_hash_table_replace(metadata->attrs, H5VL_julea_db_buf_to_hex(prefix, id, id_len), record);
+		}
+	}
+
+	return TRUE;
+
+_error:
+	H5VL_julea_db_error_handler(error);
+
+	return FALSE;
+}
+
+JHDF5Metadata*
+H5VL_julea_db_metadata_new(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+
+	metadata = g_new(JHDF5Metadata, 1);
+	metadata->batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	metadata->pending = 0;
+	metadata->attrs_pending = g_ptr_array_new_with_free_func(H5VL_julea_db_metadata_pending_attr_free);
+	metadata->links = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_hash_table_unref);
+	metadata->attrs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, H5VL_julea_db_metadata_attr_record_free);
+	metadata->prefetched = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	return metadata;
+}
+
+/**
+ * Frees the metadata of a file, writing all pending operations.
+ *
+ * \param metadata The metadata, may be NULL.
+ *
+ * \return TRUE if the pending operations have been written, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_free(JHDF5Metadata* metadata)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	if (metadata == NULL)
+	{
+		return TRUE;
+	}
+
+	// pending attributes keep their file alive, so only plain inserts and updates can be left
+	g_assert(metadata->attrs_pending->len == 0);
+
+	if (metadata->pending > 0)
+	{
+		ret = j_batch_execute(metadata->batch);
+	}
+
+	j_batch_unref(metadata->batch);
+	g_ptr_array_unref(metadata->attrs_pending);
+
+	g_hash_table_unref(metadata->links);
+	g_hash_table_unref(metadata->attrs);
+	g_hash_table_unref(metadata->prefetched);
+
+	g_free(metadata);
+
+	return ret;
+}
+
+/**
+ * Queues an insert of an attribute or link entry.
+ *
+ * \param object An object belonging to the file.
+ * \param entry  The entry.
+ * \param error  A GError pointer.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_insert(JHDF5Object_t* object, JDBEntry* entry, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+
+	g_return_val_if_fail(object != NULL, FALSE);
+	g_return_val_if_fail(entry != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(object);
+
+	if (!j_db_entry_insert(entry, metadata->batch, error))
+	{
+		return FALSE;
+	}
+
+	return H5VL_julea_db_metadata_queued(object, metadata);
+}
+
+/**
+ * Queues an update of attribute or link entries.
+ *
+ * \param object   An object belonging to the file.
+ * \param entry    The entry.
+ * \param selector The selector.
+ * \param error    A GError pointer.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_update(JHDF5Object_t* object, JDBEntry* entry, JDBSelector* selector, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+
+	g_return_val_if_fail(object != NULL, FALSE);
+	g_return_val_if_fail(entry != NULL, FALSE);
+	g_return_val_if_fail(selector != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(object);
+
+	if (!j_db_entry_update(entry, selector, metadata->batch, error))
+	{
+		return FALSE;
+	}
+
+	return H5VL_julea_db_metadata_queued(object, metadata);
+}
+
+/**
+ * Executes all pending metadata operations of a file.
+ * If attributes have been created, their links are written using a second batch.
+ *
+ * \param object An object belonging to the file.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_flush(JHDF5Object_t* object)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_pending = NULL;
+	JHDF5Metadata* metadata;
+	gchar dummy[1];
+
+	g_return_val_if_fail(object != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(object);
+
+	if (metadata->pending == 0)
+	{
+		return TRUE;
+	}
+
+	// attributes that have not been written are inserted without data
+	for (guint i = 0; i < metadata->attrs_pending->len; i++)
+	{
+		JHDF5PendingAttr* pending = g_ptr_array_index(metadata->attrs_pending, i);
+
+		if (!pending->written && !j_db_entry_set_field(pending->entry, "data", dummy, 0, &error))
+		{
+			j_goto_error();
+		}
+	}
+
+	// linking the attributes may flush again, which must not see them
+	attrs_pending = metadata->attrs_pending;
+	metadata->attrs_pending = g_ptr_array_new_with_free_func(H5VL_julea_db_metadata_pending_attr_free);
+	metadata->pending = 0;
+
+	if (!j_batch_execute(metadata->batch))
+	{
+		j_goto_error();
+	}
+
+	if (attrs_pending->len == 0)
+	{
+		return TRUE;
+	}
+
+	for (guint i = 0; i < attrs_pending->len; i++)
+	{
+		JHDF5PendingAttr* pending = g_ptr_array_index(attrs_pending, i);
+
+		if (!j_db_entry_get_id(pending->entry, &pending->attr->backend_id, &pending->attr->backend_id_len, &error))
+		{
+			j_goto_error();
+		}
+
+		if (!H5VL_julea_db_link_create_helper(pending->parent, pending->attr, pending->attr->attr.name))
+		{
+			j_goto_error();
+		}
+
+		H5VL_julea_db_metadata_attr_set(pending->attr, pending->data, pending->data_len);
+	}
+
+	return H5VL_julea_db_metadata_flush(object);
+
+_error:
+	H5VL_julea_db_error_handler(error);
+
+	return FALSE;
+}
+
+/**
+ * Queues the insert of a new attribute.
+ * The attribute's ID is set and it is linked to its parent when the metadata is flushed.
+ *
+ * \param parent The parent.
+ * \param attr   The attribute.
+ * \param entry  The attribute's entry, without data.
+ * \param error  A GError pointer.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_attr_insert(JHDF5Object_t* parent, JHDF5Object_t* attr, JDBEntry* entry, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+	JHDF5PendingAttr* pending;
+	JHDF5Object_t* link_parent = parent;
+	gboolean exists;
+
+	g_return_val_if_fail(parent != NULL, FALSE);
+	g_return_val_if_fail(attr != NULL, FALSE);
+	g_return_val_if_fail(entry != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(attr);
+
+	// special case: file -> root group
+	if (parent->type == J_HDF5_OBJECT_TYPE_FILE)
+	{
+		link_parent = parent->file.root_group;
+	}
+
+	if (!H5VL_julea_db_metadata_link_get(link_parent, attr->attr.name, NULL, &exists))
+	{
+		return FALSE;
+	}
+
+	if (exists)
+	{
+		//name must not exist for parent before
+		return FALSE;
+	}
+
+	pending = g_new0(JHDF5PendingAttr, 1);
+	pending->parent = H5VL_julea_db_object_ref(parent);
+	pending->parent_key = H5VL_julea_db_metadata_key(link_parent);
+	pending->attr = H5VL_julea_db_object_ref(attr);
+	pending->entry = j_db_entry_ref(entry);
+
+	// has to be registered before the insert is queued, which may flush
+	g_ptr_array_add(metadata->attrs_pending, pending);
+
+	return H5VL_julea_db_metadata_insert(attr, entry, error);
+}
+
+/**
+ * Sets the data of an attribute that has not been inserted yet.
+ *
+ * \param attr    The attribute.
+ * \param data    The data.
+ * \param length  The data's length.
+ * \param written Returns whether the data has been set, which is only possible once.
+ * \param error   A GError pointer.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_attr_write_pending(JHDF5Object_t* attr, gconstpointer data, guint64 length, gboolean* written, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+
+	g_return_val_if_fail(attr != NULL, FALSE);
+	g_return_val_if_fail(written != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(attr);
+	*written = FALSE;
+
+	for (guint i = 0; i < metadata->attrs_pending->len; i++)
+	{
+		JHDF5PendingAttr* pending = g_ptr_array_index(metadata->attrs_pending, i);
+
+		if (pending->attr != attr || pending->written)
+		{
+			continue;
+		}
+
+		if (!j_db_entry_set_field(pending->entry, "data", data, length, error))
+		{
+			return FALSE;
+		}
+
+		pending->written = TRUE;
+		pending->data = H5VL_julea_db_metadata_memdup(data, length);
+		pending->data_len = length;
+		*written = TRUE;
+
+		break;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Looks up a link.
+ *
+ * \param parent The parent.
+ * \param name   The link's name.
+ * \param child  An object that receives the child's ID and type, or NULL.
+ * \param exists Returns whether the link exists.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_link_get(JHDF5Object_t* parent, const gchar* name, JHDF5Object_t* child, gboolean* exists)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+	GHashTable* links;
+	JHDF5Link* link;
+
+	g_return_val_if_fail(parent != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(exists != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(parent);
+
+	// links of pending attributes are only known once they have been written
+	if (metadata->attrs_pending->len > 0)
+	{
+		g_autofree gchar* key = H5VL_julea_db_metadata_key(parent);
+
+		for (guint i = 0; i < metadata->attrs_pending->len; i++)
+		{
+			JHDF5PendingAttr* pending = g_ptr_array_index(metadata->attrs_pending, i);
+
+			if (g_strcmp0(pending->parent_key, key) == 0 && g_strcmp0(pending->attr->attr.name, name) == 0)
+			{
+				if (!H5VL_julea_db_metadata_flush(parent))
+				{
+					return FALSE;
+				}
+
+				break;
+			}
+		}
+	}
+
+	if (!(links = H5VL_julea_db_metadata_links(parent)))
+	{
+		return FALSE;
+	}
+
+	link = g_hash_table_lookup(links, name);
+	*exists = (link != NULL);
+
+	if (link != NULL && child != NULL)
+	{
+		g_free(child->backend_id);
+		child->backend_id = H5VL_julea_db_metadata_memdup(link->child, link->child_len);
+		child->backend_id_len = link->child_len;
+		child->type = link->child_type;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Adds a link that has been queued to the cache.
+ *
+ * \param parent The parent.
+ * \param name   The link's name.
+ * \param child  The child.
+ **/
+void
+H5VL_julea_db_metadata_link_add(JHDF5Object_t* parent, const gchar* name, JHDF5Object_t* child)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gchar* key = NULL;
+	JHDF5Metadata* metadata;
+	GHashTable* links;
+	JHDF5Link* link;
+
+	g_return_if_fail(parent != NULL);
+	g_return_if_fail(name != NULL);
+	g_return_if_fail(child != NULL);
+
+	metadata = H5VL_julea_db_metadata_of(parent);
+	key = H5VL_julea_db_metadata_key(parent);
+
+	// links that have not been loaded yet will be read from the database
+	if ((links = g_hash_table_lookup(metadata->links, key)) == NULL)
+	{
+		return;
+	}
+
+	link = g_new(JHDF5Link, 1);
+	link->child = H5VL_julea_db_metadata_memdup(child->backend_id, child->backend_id_len);
+	link->child_len = child->backend_id_len;
+	link->child_type = child->type;
+
+	g_hash_table_replace(links, g_strdup(name), link);
+}
+
+/**
+ * Looks up an attribute's datatype and space, fetching all attributes of its parent if necessary.
+ *
+ * \param parent The parent.
+ * \param attr   The attribute, its ID has to be set.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_attr_get(JHDF5Object_t* parent, JHDF5Object_t* attr)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gchar* parent_key = NULL;
+	g_autofree gchar* key = NULL;
+	JHDF5Metadata* metadata;
+	JHDF5AttrRecord* record;
+
+	g_return_val_if_fail(parent != NULL, FALSE);
+	g_return_val_if_fail(attr != NULL, FALSE);
+	g_return_val_if_fail(attr->type == J_HDF5_OBJECT_TYPE_ATTR, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(parent);
+	parent_key = H5VL_julea_db_metadata_key(parent);
+	key = H5VL_julea_db_metadata_key(attr);
+
+	if (!g_hash_table_contains(metadata->prefetched, parent_key))
+	{
+		GHashTable* links;
+
+		if (!(links = H5VL_julea_db_metadata_links(parent)))
+		{
+			return FALSE;
+		}
+
+		if (!H5VL_julea_db_metadata_prefetch(parent, links))
+		{
+			return FALSE;
+		}
+
+		g_hash_table_add(metadata->prefetched, g_steal_pointer(&parent_key));
+	}
+
+	if ((record = g_hash_table_lookup(metadata->attrs, key)) == NULL)
+	{
+		return FALSE;
+	}
+
+	if (!(attr->attr.space = H5VL_julea_db_space_decode(record->space, record->space_len)))
+	{
+		return FALSE;
+	}
+
+	if (!(attr->attr.datatype = H5VL_julea_db_datatype_decode(record->datatype, record->datatype_len)))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Reads an attribute's data from the cache.
+ *
+ * \param attr   The attribute.
+ * \param buf    A buffer.
+ * \param length The buffer's length.
+ *
+ * \return TRUE if the data was cached, FALSE otherwise.
+ **/
+gboolean
+H5VL_julea_db_metadata_attr_read(JHDF5Object_t* attr, gpointer buf, guint64 length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gchar* key = NULL;
+	JHDF5Metadata* metadata;
+	JHDF5AttrRecord* record;
+
+	g_return_val_if_fail(attr != NULL, FALSE);
+	g_return_val_if_fail(buf != NULL, FALSE);
+
+	metadata = H5VL_julea_db_metadata_of(attr);
+	key = H5VL_julea_db_metadata_key(attr);
+
+	if ((record = g_hash_table_lookup(metadata->attrs, key)) == NULL || record->data_len != length)
+	{
+		return FALSE;
+	}
+
+	memcpy(buf, record->data, length);
+
+	return TRUE;
+}
+
+/**
+ * Stores an attribute's metadata and data in the cache.
+ *
+ * \param attr   The attribute, its ID, datatype and space have to be set.
+ * \param data   The data.
+ * \param length The data's length.
+ **/
+void
+H5VL_julea_db_metadata_attr_set(JHDF5Object_t* attr, gconstpointer data, guint64 length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Metadata* metadata;
+	JHDF5AttrRecord* record;
+
+	g_return_if_fail(attr != NULL);
+	g_return_if_fail(attr->type == J_HDF5_OBJECT_TYPE_ATTR);
+
+	metadata = H5VL_julea_db_metadata_of(attr);
+
+	record = g_new(JHDF5AttrRecord, 1);
+	record->datatype = H5VL_julea_db_metadata_memdup(attr->attr.datatype->backend_id, attr->attr.datatype->backend_id_len);
+	record->datatype_len = attr->attr.datatype->backend_id_len;
+	record->space = H5VL_julea_db_metadata_memdup(attr->attr.space->backend_id, attr->attr.space->backend_id_len);
+	record->space_len = attr->attr.space->backend_id_len;
+	record->data = H5VL_julea_db_metadata_memdup(data, length);
+	record->data_len = length;
+
+	g_hash_table_replace(metadata->attrs, H5VL_julea_db_metadata_key(attr), record);
+}
@@ -0,0 +1,256 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <hdf5.h>
+#include <H5PLextern.h>
+
+#include <julea.h>
+#include <julea-db.h>
+#include <julea-object.h>
+
+#include "jhdf5-db.h"
+
+/*
+ * Asynchronous requests execute their batch in the background.
+ * The batch's callback only records the result, everything else happens when the application waits for, cancels or frees the request.
+ * This keeps HDF5 and the plugin's objects out of JULEA's background threads.
+ */
+
+struct JHDF5Request
+{
+	JBatch* batch;
+
+	GMutex mutex;
+	GCond cond;
+
+	/// set by the batch's callback
+	gboolean done;
+	gboolean success;
+
+	/// whether the request has been completed in the application's thread
+	gboolean completed;
+	H5VL_request_status_t status;
+
+	JHDF5RequestCompleteFunc complete;
+	gpointer data;
+	GDestroyNotify data_free;
+
+	H5VL_request_notify_t notify;
+	void* notify_ctx;
+};
+
+typedef struct JHDF5Request JHDF5Request;
+
+static void
+H5VL_julea_db_request_callback(JBatch* batch, gboolean ret, gpointer user_data)
+{
+	JHDF5Request* request = user_data;
+
+	(void)batch;
+
+	g_mutex_lock(&request->mutex);
+	request->done = TRUE;
+	request->success = ret;
+	g_cond_broadcast(&request->cond);
+	g_mutex_unlock(&request->mutex);
+}
+
+static void
+H5VL_julea_db_request_complete(JHDF5Request* request)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (request->completed)
+	{
+		return;
+	}
+
+	j_batch_wait(request->batch);
+
+	request->completed = TRUE;
+	request->status = H5VL_REQUEST_STATUS_FAIL;
+
+	if (request->complete != NULL ? request->complete(request->data, request->success) : request->success)
+	{
+		request->status = H5VL_REQUEST_STATUS_SUCCEED;
+	}
+
+	if (request->notify != NULL)
+	{
+		request->notify(request->notify_ctx, request->status);
+	}
+}
+
+/**
+ * Executes a batch asynchronously.
+ *
+ * \param batch     A batch with pending operations.
+ * \param complete  A function that completes the operation, or NULL.
+ * \param data      The data passed to complete.
+ * \param data_free A function to free data, or NULL.
+ *
+ * \return The request.
+ **/
+void*
+H5VL_julea_db_request_new(JBatch* batch, JHDF5RequestCompleteFunc complete, gpointer data, GDestroyNotify data_free)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Request* request;
+
+	g_return_val_if_fail(batch != NULL, NULL);
+
+	request = g_new0(JHDF5Request, 1);
+	request->batch = j_batch_ref(batch);
+	request->status = H5VL_REQUEST_STATUS_IN_PROGRESS;
+	request->complete = complete;
+	request->data = data;
+	request->data_free = data_free;
+
+	g_mutex_init(&request->mutex);
+	g_cond_init(&request->cond);
+
+	j_batch_execute_async(batch, H5VL_julea_db_request_callback, request);
+
+	return request;
+}
+
+herr_t
+H5VL_julea_db_request_wait(void* req, uint64_t timeout, H5VL_request_status_t* status)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Request* request = req;
+	gboolean done;
+
+	g_return_val_if_fail(request != NULL, -1);
+	g_return_val_if_fail(status != NULL, -1);
+
+	g_mutex_lock(&request->mutex);
+
+	if (timeout == H5ES_WAIT_FOREVER)
+	{
+		while (!request->done)
+		{
+			g_cond_wait(&request->cond, &request->mutex);
+		}
+	}
+	else
+	{
+		// the timeout is given in nanoseconds
+		gint64 end_time = g_get_monotonic_time() + timeout / 1000;
+
+		while (!request->done)
+		{
+			if (!g_cond_wait_until(&request->cond, &request->mutex, end_time))
+			{
+				break;
+			}
+		}
+	}
+
+	done = request->done;
+
+	g_mutex_unlock(&request->mutex);
+
+	if (done)
+	{
+		H5VL_julea_db_request_complete(request);
+	}
+
+	*status = request->status;
+
+	return 0;
+}
+
+herr_t
+H5VL_julea_db_request_notify(void* req, H5VL_request_notify_t cb, void* ctx)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Request* request = req;
+
+	g_return_val_if_fail(request != NULL, -1);
+
+	request->notify = cb;
+	request->notify_ctx = ctx;
+
+	// requests that have already been completed notify immediately
+	if (request->completed && cb != NULL)
+	{
+		cb(ctx, request->status);
+	}
+
+	return 0;
+}
+
+herr_t
+H5VL_julea_db_request_cancel(void* req, H5VL_request_status_t* status)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Request* request = req;
+	H5VL_request_status_t wait_status;
+
+	g_return_val_if_fail(request != NULL, -1);
+
+	// batches cannot be aborted once they have been started, but finished requests report their result
+	H5VL_julea_db_request_wait(request, 0, &wait_status);
+
+	if (status != NULL)
+	{
+		*status = (wait_status == H5VL_REQUEST_STATUS_IN_PROGRESS) ? H5VL_REQUEST_STATUS_CANT_CANCEL : wait_status;
+	}
+
+	return 0;
+}
+
+herr_t
+H5VL_julea_db_request_free(void* req)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHDF5Request* request = req;
+	H5VL_request_status_t status;
+
+	g_return_val_if_fail(request != NULL, -1);
+
+	H5VL_julea_db_request_wait(request, H5ES_WAIT_FOREVER, &status);
+
+	if (request->data_free != NULL)
+	{
+		request->data_free(request->data);
+	}
+
+	j_batch_unref(request->batch);
+
+	g_cond_clear(&request->cond);
+	g_mutex_clear(&request->mutex);
+
+	g_free(request);
+
+	return 0;
+}
@@ -68,6 +68,143 @@ H5VL_julea_db_buf_to_hex(const char* prefix, const char* buf, guint buf_len)
 	return str;
 }
 
+/**
+ * Gets one of the plugin's schemas, creating it if it does not exist yet.
+ *
+ * An existing schema has to contain all fields added by \p define.
+ * Fields cannot be added to existing schemas and entries refer to each other by their IDs, so schemas created by an older version of the plugin cannot be migrated.
+ * Initialization fails with an error message in this case.
+ *
+ * \param name The schema's name.
+ * \param define Adds the schema's fields and indexes.
+ * \param[out] schema The schema.
+ *
+ * \return 0 on success, 1 otherwise.
+ **/
+herr_t
+H5VL_julea_db_schema_init(gchar const* name, JHDF5SchemaDefineFunc define, JDBSchema** schema)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JDBSchema) expected = NULL;
+	g_autoptr(GError) error = NULL;
+	gchar** names = NULL;
+	g_autofree JDBType* types = NULL;
+	guint32 count = 0;
+
+	g_return_val_if_fail(name != NULL, 1);
+	g_return_val_if_fail(define != NULL, 1);
+	g_return_val_if_fail(schema != NULL, 1);
+
+	*schema = NULL;
+
+	if (!(batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT)))
+	{
+		j_goto_error();
+	}
+
+	if (!(expected = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, name, NULL)))
+	{
+		j_goto_error();
+	}
+
+	if (!define(expected, &error))
+	{
+		j_goto_error();
+	}
+
+	if (!(*schema = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, name, NULL)))
+	{
+		j_goto_error();
+	}
+
+	if (!(j_db_schema_get(*schema, batch, &error) && j_batch_execute(batch)))
+	{
+		if (error == NULL || error->code != J_BACKEND_DB_ERROR_SCHEMA_NOT_FOUND)
+		{
+			j_goto_error();
+		}
+
+		g_clear_error(&error);
+
+		if (!j_db_schema_create(expected, batch, &error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_batch_execute(batch))
+		{
+			j_goto_error();
+		}
+
+		j_db_schema_unref(*schema);
+
+		if (!(*schema = j_db_schema_new(JULEA_HDF5_DB_NAMESPACE, name, NULL)))
+		{
+			j_goto_error();
+		}
+
+		/// \todo Use same key type for every db backend to remove get for every new schema.
+		if (!j_db_schema_get(*schema, batch, &error))
+		{
+			j_goto_error();
+		}
+
+		if (!j_batch_execute(batch))
+		{
+			j_goto_error();
+		}
+	}
+
+	if (!(count = j_db_schema_get_all_fields(expected, &names, &types, &error)))
+	{
+		j_goto_error();
+	}
+
+	for (guint32 i = 0; i < count && names[i] != NULL; i++)
+	{
+		g_autoptr(GError) field_error = NULL;
+		JDBType type;
+
+		if (!j_db_schema_get_field(*schema, names[i], &type, &field_error) || type != types[i])
+		{
+			g_critical("Schema %s.%s has been created by an incompatible version of the julea-db HDF5 plugin (field %s is missing or has a different type). Please delete the namespace's schemas or use a new storage location.", JULEA_HDF5_DB_NAMESPACE, name, names[i]);
+			j_goto_error();
+		}
+	}
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		g_free(names[i]);
+	}
+
+	g_free(names);
+
+	return 0;
+
+_error:
+	H5VL_julea_db_error_handler(error);
+
+	if (names != NULL)
+	{
+		for (guint32 i = 0; i < count; i++)
+		{
+			g_free(names[i]);
+		}
+
+		g_free(names);
+	}
+
+	if (*schema != NULL)
+	{
+		j_db_schema_unref(*schema);
+		*schema = NULL;
+	}
+
+	return 1;
+}
+
 void
 H5VL_julea_db_error_handler(GError* error)
 {
@@ -109,11 +246,19 @@ H5VL_julea_db_object_new(JHDF5ObjectType type)
 	return object;
 }
 
-void
+/**
+ * Decreases an object's reference count, freeing it when the last reference is dropped.
+ * Dropping the last reference to a file writes its pending metadata.
+ *
+ * \return FALSE if pending metadata could not be written, TRUE otherwise.
+ **/
+gboolean
 H5VL_julea_db_object_unref(JHDF5Object_t* object)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	gboolean ret = TRUE;
+
 	if (object && g_atomic_int_dec_and_test(&object->ref_count))
 	{
 		switch (object->type)
@@ -121,6 +266,9 @@ H5VL_julea_db_object_unref(JHDF5Object_t* object)
 			case J_HDF5_OBJECT_TYPE_FILE:
 				g_free(object->file.name);
 
+				// writes pending metadata
+				ret = H5VL_julea_db_metadata_free(object->file.metadata);
+
 				// root group ressources can be directly freed here
 				if (object->file.root_group)
 				{
@@ -131,7 +279,7 @@ H5VL_julea_db_object_unref(JHDF5Object_t* object)
 
 				break;
 			case J_HDF5_OBJECT_TYPE_DATASET:
-				H5VL_julea_db_object_unref(object->dataset.file);
+				ret = H5VL_julea_db_object_unref(object->dataset.file);
 				g_free(object->dataset.name);
 
 				H5VL_julea_db_object_unref(object->dataset.space);
@@ -147,9 +295,18 @@ H5VL_julea_db_object_unref(JHDF5Object_t* object)
 					j_distributed_object_unref(object->dataset.object);
 				}
 
+				g_free(object->dataset.chunk.dims);
+				g_free(object->dataset.chunk.fill);
+				g_free(object->dataset.filter.list);
+
+				if (object->dataset.chunk.stored)
+				{
+					g_hash_table_unref(object->dataset.chunk.stored);
+				}
+
 				break;
 			case J_HDF5_OBJECT_TYPE_ATTR:
-				H5VL_julea_db_object_unref(object->attr.file);
+				ret = H5VL_julea_db_object_unref(object->attr.file);
 				g_free(object->attr.name);
 
 				H5VL_julea_db_object_unref(object->attr.space);
@@ -157,7 +314,7 @@ H5VL_julea_db_object_unref(JHDF5Object_t* object)
 
 				break;
 			case J_HDF5_OBJECT_TYPE_GROUP:
-				H5VL_julea_db_object_unref(object->group.file);
+				ret = H5VL_julea_db_object_unref(object->group.file);
 				g_free(object->group.name);
 				break;
 			case J_HDF5_OBJECT_TYPE_DATATYPE:
@@ -174,6 +331,8 @@ H5VL_julea_db_object_unref(JHDF5Object_t* object)
 		g_free(object->backend_id);
 		g_free(object);
 	}
+
+	return ret;
 }
 
 H5I_type_t
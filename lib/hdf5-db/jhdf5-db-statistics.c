@@ -0,0 +1,480 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <hdf5.h>
+#include <H5PLextern.h>
+
+#include <math.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define J_HDF5_STATISTICS_X86 1
+#endif
+
+#include <julea.h>
+#include <julea-db.h>
+#include <julea-object.h>
+
+#include "jhdf5-db.h"
+
+/*
+ * Min/max kernels for the supported element types.
+ * All types except unsigned 64-bit integers are processed with AVX2 if the CPU supports it, and double and float data fall back to SSE2.
+ * Unsigned 64-bit integers, other CPUs and other architectures use scalar loops.
+ * NaNs are ignored, matching the scalar comparisons.
+ */
+
+#define J_HDF5_STATISTICS_SCALAR(_name, _type, _acc) \
+	static void \
+	_name(gconstpointer data, guint64 count, _acc* min, _acc* max) \
+	{ \
+		_type const* buf = data; \
+\
+		for (guint64 i = 0; i < count; i++) \
+		{ \
+			_acc value = buf[i]; \
+\
+			if (value < *min) \
+			{ \
+				*min = value; \
+			} \
+\
+			if (value > *max) \
+			{ \
+				*max = value; \
+			} \
+		} \
+	}
+
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_f64_scalar, gdouble, gdouble)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_f32_scalar, gfloat, gdouble)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_s8_scalar, gint8, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_s16_scalar, gint16, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_s32_scalar, gint32, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_s64_scalar, gint64, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_u8_scalar, guint8, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_u16_scalar, guint16, gint64)
+J_HDF5_STATISTICS_SCALAR(H5VL_julea_db_statistics_u32_scalar, guint32, gint64)
+
+static void
+H5VL_julea_db_statistics_u64_scalar(gconstpointer data, guint64 count, gint64* min, gint64* max)
+{
+	guint64 const* buf = data;
+
+	// Values that do not fit are clamped, H5VL_julea_db_statistics_overlaps() treats a clamped maximum as unbounded
+	for (guint64 i = 0; i < count; i++)
+	{
+		gint64 value = MIN(buf[i], (guint64)G_MAXINT64);
+
+		if (value < *min)
+		{
+			*min = value;
+		}
+
+		if (value > *max)
+		{
+			*max = value;
+		}
+	}
+}
+
+#ifdef J_HDF5_STATISTICS_X86
+
+/*
+ * Floating-point lanes start out at neutral values and never contain NaNs, because the vector instructions return their second operand in that case.
+ */
+#define H5VL_julea_db_statistics_reduce(_lanes_min, _lanes_max, _n, _min, _max) \
+	do \
+	{ \
+		for (guint _j = 0; _j < (_n); _j++) \
+		{ \
+			*(_min) = MIN(*(_min), (_lanes_min)[_j]); \
+			*(_max) = MAX(*(_max), (_lanes_max)[_j]); \
+		} \
+	} while (0)
+
+__attribute__((target("avx2"))) static void
+H5VL_julea_db_statistics_f64_avx2(gconstpointer data, guint64 count, gdouble* min, gdouble* max)
+{
+	gdouble const* buf = data;
+	gdouble lanes_min[4];
+	gdouble lanes_max[4];
+	__m256d vmin = _mm256_set1_pd(*min);
+	__m256d vmax = _mm256_set1_pd(*max);
+	guint64 i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d value = _mm256_loadu_pd(buf + i);
+
+		vmin = _mm256_min_pd(value, vmin);
+		vmax = _mm256_max_pd(value, vmax);
+	}
+
+	_mm256_storeu_pd(lanes_min, vmin);
+	_mm256_storeu_pd(lanes_max, vmax);
+
+	H5VL_julea_db_statistics_reduce(lanes_min, lanes_max, 4, min, max);
+	H5VL_julea_db_statistics_f64_scalar(buf + i, count - i, min, max);
+}
+
+__attribute__((target("avx2"))) static void
+H5VL_julea_db_statistics_f32_avx2(gconstpointer data, guint64 count, gdouble* min, gdouble* max)
+{
+	gfloat const* buf = data;
+	gfloat lanes_min[8];
+	gfloat lanes_max[8];
+	__m256 vmin = _mm256_set1_ps(INFINITY);
+	__m256 vmax = _mm256_set1_ps(-INFINITY);
+	guint64 i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 value = _mm256_loadu_ps(buf + i);
+
+		vmin = _mm256_min_ps(value, vmin);
+		vmax = _mm256_max_ps(value, vmax);
+	}
+
+	_mm256_storeu_ps(lanes_min, vmin);
+	_mm256_storeu_ps(lanes_max, vmax);
+
+	H5VL_julea_db_statistics_reduce(lanes_min, lanes_max, 8, min, max);
+	H5VL_julea_db_statistics_f32_scalar(buf + i, count - i, min, max);
+}
+
+/*
+ * Integer lanes start out at the type's limits, so they only take part in the reduction if at least one vector has been processed.
+ */
+#define J_HDF5_STATISTICS_AVX2(_name, _scalar, _type, _lanes, _vset1, _vmin, _vmax, _type_min, _type_max) \
+	__attribute__((target("avx2"))) static void \
+	_name(gconstpointer data, guint64 count, gint64* min, gint64* max) \
+	{ \
+		_type const* buf = data; \
+		_type lanes_min[_lanes]; \
+		_type lanes_max[_lanes]; \
+		__m256i vmin = _vset1(_type_max); \
+		__m256i vmax = _vset1(_type_min); \
+		guint64 i = 0; \
+\
+		for (; i + (_lanes) <= count; i += (_lanes)) \
+		{ \
+			__m256i value = _mm256_loadu_si256((__m256i const*)(buf + i)); \
+\
+			vmin = _vmin(value, vmin); \
+			vmax = _vmax(value, vmax); \
+		} \
+\
+		_mm256_storeu_si256((__m256i*)lanes_min, vmin); \
+		_mm256_storeu_si256((__m256i*)lanes_max, vmax); \
+\
+		if (i > 0) \
+		{ \
+			H5VL_julea_db_statistics_reduce(lanes_min, lanes_max, (_lanes), min, max); \
+		} \
+\
+		_scalar(buf + i, count - i, min, max); \
+	}
+
+/*
+ * AVX2 has no 64-bit integer min/max instructions, so they are emulated using comparisons.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+H5VL_julea_db_statistics_min_epi64(__m256i a, __m256i b)
+{
+	return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+H5VL_julea_db_statistics_max_epi64(__m256i a, __m256i b)
+{
+	return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_s8_avx2, H5VL_julea_db_statistics_s8_scalar, gint8, 32, _mm256_set1_epi8, _mm256_min_epi8, _mm256_max_epi8, G_MININT8, G_MAXINT8)
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_s16_avx2, H5VL_julea_db_statistics_s16_scalar, gint16, 16, _mm256_set1_epi16, _mm256_min_epi16, _mm256_max_epi16, G_MININT16, G_MAXINT16)
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_s32_avx2, H5VL_julea_db_statistics_s32_scalar, gint32, 8, _mm256_set1_epi32, _mm256_min_epi32, _mm256_max_epi32, G_MININT32, G_MAXINT32)
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_s64_avx2, H5VL_julea_db_statistics_s64_scalar, gint64, 4, _mm256_set1_epi64x, H5VL_julea_db_statistics_min_epi64, H5VL_julea_db_statistics_max_epi64, G_MININT64, G_MAXINT64)
+// The set functions take signed arguments, the bit patterns are what matters
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_u8_avx2, H5VL_julea_db_statistics_u8_scalar, guint8, 32, _mm256_set1_epi8, _mm256_min_epu8, _mm256_max_epu8, 0, (gint8)G_MAXUINT8)
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_u16_avx2, H5VL_julea_db_statistics_u16_scalar, guint16, 16, _mm256_set1_epi16, _mm256_min_epu16, _mm256_max_epu16, 0, (gint16)G_MAXUINT16)
+J_HDF5_STATISTICS_AVX2(H5VL_julea_db_statistics_u32_avx2, H5VL_julea_db_statistics_u32_scalar, guint32, 8, _mm256_set1_epi32, _mm256_min_epu32, _mm256_max_epu32, 0, (gint32)G_MAXUINT32)
+
+static void
+H5VL_julea_db_statistics_f64_sse2(gconstpointer data, guint64 count, gdouble* min, gdouble* max)
+{
+	gdouble const* buf = data;
+	gdouble lanes_min[2];
+	gdouble lanes_max[2];
+	__m128d vmin = _mm_set1_pd(*min);
+	__m128d vmax = _mm_set1_pd(*max);
+	guint64 i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128d value = _mm_loadu_pd(buf + i);
+
+		vmin = _mm_min_pd(value, vmin);
+		vmax = _mm_max_pd(value, vmax);
+	}
+
+	_mm_storeu_pd(lanes_min, vmin);
+	_mm_storeu_pd(lanes_max, vmax);
+
+	H5VL_julea_db_statistics_reduce(lanes_min, lanes_max, 2, min, max);
+	H5VL_julea_db_statistics_f64_scalar(buf + i, count - i, min, max);
+}
+
+static void
+H5VL_julea_db_statistics_f32_sse2(gconstpointer data, guint64 count, gdouble* min, gdouble* max)
+{
+	gfloat const* buf = data;
+	gfloat lanes_min[4];
+	gfloat lanes_max[4];
+	__m128 vmin = _mm_set1_ps(INFINITY);
+	__m128 vmax = _mm_set1_ps(-INFINITY);
+	guint64 i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 value = _mm_loadu_ps(buf + i);
+
+		vmin = _mm_min_ps(value, vmin);
+		vmax = _mm_max_ps(value, vmax);
+	}
+
+	_mm_storeu_ps(lanes_min, vmin);
+	_mm_storeu_ps(lanes_max, vmax);
+
+	H5VL_julea_db_statistics_reduce(lanes_min, lanes_max, 4, min, max);
+	H5VL_julea_db_statistics_f32_scalar(buf + i, count - i, min, max);
+}
+
+#endif
+
+void
+H5VL_julea_db_statistics_init(JHDF5Statistics* statistics)
+{
+	g_return_if_fail(statistics != NULL);
+
+	statistics->min_value_i = G_MAXINT64;
+	statistics->max_value_i = G_MININT64;
+	statistics->min_value_f = INFINITY;
+	statistics->max_value_f = -INFINITY;
+	statistics->count = 0;
+}
+
+JHDF5StatisticsKind
+H5VL_julea_db_statistics_kind(hid_t type_id)
+{
+	gsize size;
+
+	size = H5Tget_size(type_id);
+
+	switch (H5Tget_class(type_id))
+	{
+		case H5T_FLOAT:
+			if (size == 4)
+			{
+				return J_HDF5_STATISTICS_F32;
+			}
+			else if (size == 8)
+			{
+				return J_HDF5_STATISTICS_F64;
+			}
+			break;
+		case H5T_INTEGER:
+		{
+			gboolean is_signed = (H5Tget_sign(type_id) != H5T_SGN_NONE);
+
+			switch (size)
+			{
+				case 1:
+					return (is_signed) ? J_HDF5_STATISTICS_S8 : J_HDF5_STATISTICS_U8;
+				case 2:
+					return (is_signed) ? J_HDF5_STATISTICS_S16 : J_HDF5_STATISTICS_U16;
+				case 4:
+					return (is_signed) ? J_HDF5_STATISTICS_S32 : J_HDF5_STATISTICS_U32;
+				case 8:
+					return (is_signed) ? J_HDF5_STATISTICS_S64 : J_HDF5_STATISTICS_U64;
+				default:
+					break;
+			}
+		}
+		break;
+		case H5T_STRING:
+		case H5T_BITFIELD:
+		case H5T_OPAQUE:
+		case H5T_COMPOUND:
+		case H5T_REFERENCE:
+		case H5T_ENUM:
+		case H5T_VLEN:
+		case H5T_ARRAY:
+		case H5T_NO_CLASS:
+		case H5T_TIME:
+		case H5T_NCLASSES:
+		default:
+			break;
+	}
+
+	return J_HDF5_STATISTICS_NONE;
+}
+
+void
+H5VL_julea_db_statistics_compute(JHDF5StatisticsKind kind, gconstpointer data, guint64 count, JHDF5Statistics* statistics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(data != NULL || count == 0);
+	g_return_if_fail(statistics != NULL);
+
+#ifdef J_HDF5_STATISTICS_X86
+	gboolean avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+#ifdef J_HDF5_STATISTICS_X86
+#define J_HDF5_STATISTICS_INTEGER(_avx2, _scalar) \
+	if (avx2) \
+	{ \
+		_avx2(data, count, &statistics->min_value_i, &statistics->max_value_i); \
+	} \
+	else \
+	{ \
+		_scalar(data, count, &statistics->min_value_i, &statistics->max_value_i); \
+	}
+#else
+#define J_HDF5_STATISTICS_INTEGER(_avx2, _scalar) _scalar(data, count, &statistics->min_value_i, &statistics->max_value_i);
+#endif
+
+	switch (kind)
+	{
+		case J_HDF5_STATISTICS_F32:
+#ifdef J_HDF5_STATISTICS_X86
+			if (avx2)
+			{
+				H5VL_julea_db_statistics_f32_avx2(data, count, &statistics->min_value_f, &statistics->max_value_f);
+			}
+			else
+			{
+				H5VL_julea_db_statistics_f32_sse2(data, count, &statistics->min_value_f, &statistics->max_value_f);
+			}
+#else
+			H5VL_julea_db_statistics_f32_scalar(data, count, &statistics->min_value_f, &statistics->max_value_f);
+#endif
+			break;
+		case J_HDF5_STATISTICS_F64:
+#ifdef J_HDF5_STATISTICS_X86
+			if (avx2)
+			{
+				H5VL_julea_db_statistics_f64_avx2(data, count, &statistics->min_value_f, &statistics->max_value_f);
+			}
+			else
+			{
+				H5VL_julea_db_statistics_f64_sse2(data, count, &statistics->min_value_f, &statistics->max_value_f);
+			}
+#else
+			H5VL_julea_db_statistics_f64_scalar(data, count, &statistics->min_value_f, &statistics->max_value_f);
+#endif
+			break;
+		case J_HDF5_STATISTICS_S8:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_s8_avx2, H5VL_julea_db_statistics_s8_scalar)
+			break;
+		case J_HDF5_STATISTICS_S16:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_s16_avx2, H5VL_julea_db_statistics_s16_scalar)
+			break;
+		case J_HDF5_STATISTICS_S32:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_s32_avx2, H5VL_julea_db_statistics_s32_scalar)
+			break;
+		case J_HDF5_STATISTICS_S64:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_s64_avx2, H5VL_julea_db_statistics_s64_scalar)
+			break;
+		case J_HDF5_STATISTICS_U8:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_u8_avx2, H5VL_julea_db_statistics_u8_scalar)
+			break;
+		case J_HDF5_STATISTICS_U16:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_u16_avx2, H5VL_julea_db_statistics_u16_scalar)
+			break;
+		case J_HDF5_STATISTICS_U32:
+			J_HDF5_STATISTICS_INTEGER(H5VL_julea_db_statistics_u32_avx2, H5VL_julea_db_statistics_u32_scalar)
+			break;
+		case J_HDF5_STATISTICS_U64:
+			H5VL_julea_db_statistics_u64_scalar(data, count, &statistics->min_value_i, &statistics->max_value_i);
+			break;
+		case J_HDF5_STATISTICS_NONE:
+		default:
+			return;
+	}
+
+#undef J_HDF5_STATISTICS_INTEGER
+
+	statistics->count += count;
+}
+
+gboolean
+H5VL_julea_db_statistics_equal(JHDF5Statistics const* a, JHDF5Statistics const* b)
+{
+	return a->min_value_i == b->min_value_i && a->max_value_i == b->max_value_i && a->min_value_f == b->min_value_f && a->max_value_f == b->max_value_f && a->count == b->count;
+}
+
+/**
+ * Widens the value range of statistics to cover other.
+ * The element count is left unchanged because the element sets may overlap.
+ **/
+void
+H5VL_julea_db_statistics_merge(JHDF5Statistics* statistics, JHDF5Statistics const* other)
+{
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(other != NULL);
+
+	statistics->min_value_i = MIN(statistics->min_value_i, other->min_value_i);
+	statistics->max_value_i = MAX(statistics->max_value_i, other->max_value_i);
+	statistics->min_value_f = MIN(statistics->min_value_f, other->min_value_f);
+	statistics->max_value_f = MAX(statistics->max_value_f, other->max_value_f);
+}
+
+/**
+ * Checks whether statistics may contain values within [min, max].
+ * Empty statistics never overlap.
+ **/
+gboolean
+H5VL_julea_db_statistics_overlaps(JHDF5Statistics const* statistics, JHDF5StatisticsKind kind, gdouble min, gdouble max)
+{
+	g_return_val_if_fail(statistics != NULL, FALSE);
+
+	if (kind == J_HDF5_STATISTICS_F32 || kind == J_HDF5_STATISTICS_F64)
+	{
+		return statistics->min_value_f <= max && statistics->max_value_f >= min;
+	}
+
+	// Unsigned 64-bit values above G_MAXINT64 have been clamped, so the real maximum is unknown
+	if (kind == J_HDF5_STATISTICS_U64 && statistics->max_value_i == G_MAXINT64)
+	{
+		return (gdouble)statistics->min_value_i <= max;
+	}
+
+	// converting to double is monotonic, so the comparison stays conservative
+	return (gdouble)statistics->min_value_i <= max && (gdouble)statistics->max_value_i >= min;
+}
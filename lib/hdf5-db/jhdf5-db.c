@@ -47,7 +47,7 @@
 #define JULEA_DB 530
 
 #define H5VL_JULEA_DB_CAP_FLAGS \
-	(H5VL_CAP_FLAG_ATTR_BASIC | H5VL_CAP_FLAG_ATTR_MORE | H5VL_CAP_FLAG_DATASET_BASIC | H5VL_CAP_FLAG_DATASET_MORE | H5VL_CAP_FLAG_FILE_BASIC | H5VL_CAP_FLAG_FILE_MORE | H5VL_CAP_FLAG_GROUP_BASIC | H5VL_CAP_FLAG_GROUP_MORE | H5VL_CAP_FLAG_LINK_BASIC | H5VL_CAP_FLAG_LINK_MORE | H5VL_CAP_FLAG_OBJECT_BASIC | H5VL_CAP_FLAG_ITERATE | H5VL_CAP_FLAG_STORAGE_SIZE)
+	(H5VL_CAP_FLAG_ATTR_BASIC | H5VL_CAP_FLAG_ATTR_MORE | H5VL_CAP_FLAG_DATASET_BASIC | H5VL_CAP_FLAG_DATASET_MORE | H5VL_CAP_FLAG_FILE_BASIC | H5VL_CAP_FLAG_FILE_MORE | H5VL_CAP_FLAG_GROUP_BASIC | H5VL_CAP_FLAG_GROUP_MORE | H5VL_CAP_FLAG_LINK_BASIC | H5VL_CAP_FLAG_LINK_MORE | H5VL_CAP_FLAG_OBJECT_BASIC | H5VL_CAP_FLAG_ITERATE | H5VL_CAP_FLAG_STORAGE_SIZE | H5VL_CAP_FLAG_ASYNC)
 
 static herr_t
 H5VL_julea_db_init(hid_t vipl_id)
@@ -282,12 +282,12 @@ static const H5VL_class_t H5VL_julea_db_g = {
 		.opt_query = H5VL_julea_db_introspect_opt_query,
 	},
 	.request_cls = {
-		.wait = NULL,
-		.notify = NULL,
-		.cancel = NULL,
+		.wait = H5VL_julea_db_request_wait,
+		.notify = H5VL_julea_db_request_notify,
+		.cancel = H5VL_julea_db_request_cancel,
 		.specific = NULL,
 		.optional = NULL,
-		.free = NULL,
+		.free = H5VL_julea_db_request_free,
 	},
 	.blob_cls = {
 		.put = NULL,
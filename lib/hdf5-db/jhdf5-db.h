@@ -43,6 +43,67 @@ enum JHDF5ObjectType
 
 typedef enum JHDF5ObjectType JHDF5ObjectType;
 
+// registered HDF5 filter identifiers
+#define J_HDF5_FILTER_LZ4 32004
+#define J_HDF5_FILTER_ZSTD 32015
+
+struct JHDF5Filter
+{
+	guint32 id;
+	guint32 level;
+};
+
+typedef struct JHDF5Filter JHDF5Filter;
+
+struct JHDF5Statistics
+{
+	gint64 min_value_i;
+	gdouble min_value_f;
+	gint64 max_value_i;
+	gdouble max_value_f;
+	// number of elements the statistics have been computed from
+	guint64 count;
+};
+
+typedef struct JHDF5Statistics JHDF5Statistics;
+
+/**
+ * Element types supported by the statistics kernels.
+ * The kind is resolved up front because HDF5 may not be called from worker threads.
+ **/
+enum JHDF5StatisticsKind
+{
+	J_HDF5_STATISTICS_NONE,
+	J_HDF5_STATISTICS_F32,
+	J_HDF5_STATISTICS_F64,
+	J_HDF5_STATISTICS_S8,
+	J_HDF5_STATISTICS_S16,
+	J_HDF5_STATISTICS_S32,
+	J_HDF5_STATISTICS_S64,
+	J_HDF5_STATISTICS_U8,
+	J_HDF5_STATISTICS_U16,
+	J_HDF5_STATISTICS_U32,
+	J_HDF5_STATISTICS_U64
+};
+
+typedef enum JHDF5StatisticsKind JHDF5StatisticsKind;
+
+/**
+ * A chunk that has been written, including its zone map.
+ **/
+struct JHDF5Chunk
+{
+	guint64 size;
+	// may cover more than the current contents of the chunk after partial overwrites
+	JHDF5Statistics statistics;
+};
+
+typedef struct JHDF5Chunk JHDF5Chunk;
+
+struct JHDF5Metadata;
+
+typedef struct JHDF5Metadata JHDF5Metadata;
+
 typedef struct JHDF5Object_t JHDF5Object_t;
 struct JHDF5Object_t
 {
@@ -56,6 +117,8 @@ struct JHDF5Object_t
 		{
 			char* name;
 			JHDF5Object_t* root_group;
+			// buffered attribute and link metadata
+			JHDF5Metadata* metadata;
 		} file;
 		struct
 		{
@@ -67,11 +130,23 @@ struct JHDF5Object_t
 			JDistributedObject* object;
 			struct
 			{
-				gint64 min_value_i;
-				gdouble min_value_f;
-				gint64 max_value_i;
-				gdouble max_value_f;
-			} statistics;
+				// 0 for contiguous datasets
+				guint ndims;
+				hsize_t* dims;
+				// maps the indices of the chunks that have been written to JHDF5Chunk
+				GHashTable* stored;
+				// the fill value in the dataset's datatype, NULL if it consists of zero bytes
+				gpointer fill;
+			} chunk;
+			struct
+			{
+				// only applied to chunked datasets
+				guint count;
+				JHDF5Filter* list;
+			} filter;
+			JHDF5Statistics statistics;
+			// the last asynchronous read or write, later ones wait for it to complete
+			void* request;
 		} dataset;
 		struct
 		{
@@ -184,14 +259,36 @@ herr_t H5VL_julea_db_link_optional(void* obj, const H5VL_loc_params_t* loc_param
 // object
 void* H5VL_julea_db_object_open(void* obj, const H5VL_loc_params_t* loc_params, H5I_type_t* opened_type, hid_t dxpl, void** req);
 
+// request
+herr_t H5VL_julea_db_request_wait(void* req, uint64_t timeout, H5VL_request_status_t* status);
+herr_t H5VL_julea_db_request_notify(void* req, H5VL_request_notify_t cb, void* ctx);
+herr_t H5VL_julea_db_request_cancel(void* req, H5VL_request_status_t* status);
+herr_t H5VL_julea_db_request_free(void* req);
+
 /* internal helper functions */
 
+/**
+ * Completes an asynchronous operation after its batch has been executed.
+ * It is always called from the application's thread, so it may use HDF5.
+ * success tells whether the batch has been executed successfully, the return value is the request's final result.
+ **/
+typedef gboolean (*JHDF5RequestCompleteFunc)(gpointer data, gboolean success);
+
+void* H5VL_julea_db_request_new(JBatch* batch, JHDF5RequestCompleteFunc complete, gpointer data, GDestroyNotify data_free);
+
+/**
+ * Adds the fields and indexes of a schema.
+ **/
+typedef gboolean (*JHDF5SchemaDefineFunc)(JDBSchema* schema, GError** error);
+
+herr_t H5VL_julea_db_schema_init(gchar const* name, JHDF5SchemaDefineFunc define, JDBSchema** schema);
+
 void H5VL_julea_db_error_handler(GError* error);
 char* H5VL_julea_db_buf_to_hex(const char* prefix, const char* buf, guint buf_len);
 
 JHDF5Object_t* H5VL_julea_db_object_new(JHDF5ObjectType type);
 JHDF5Object_t* H5VL_julea_db_object_ref(JHDF5Object_t* object);
-void H5VL_julea_db_object_unref(JHDF5Object_t* object);
+gboolean H5VL_julea_db_object_unref(JHDF5Object_t* object);
 gboolean H5VL_julea_db_dataset_set_info(JHDF5Object_t* object, GError** error);
 
 H5I_type_t H5VL_julea_db_type_intern_to_hdf(JHDF5ObjectType type);
@@ -203,10 +300,24 @@ herr_t H5VL_julea_db_dataset_truncate_file(void* obj);
 herr_t H5VL_julea_db_group_truncate_file(void* obj);
 
 // datatype helper
-const void* H5VL_julea_db_datatype_convert_type(hid_t type_id_from, hid_t type_id_to, const char* from_buf, char* tmp_buf, guint count);
+gboolean H5VL_julea_db_datatype_convert(hid_t type_id_from, hid_t type_id_to, const gchar* from_buf, gchar* to_buf, guint64 count);
 JHDF5Object_t* H5VL_julea_db_datatype_decode(void* backend_id, guint64 backend_id_len);
 JHDF5Object_t* H5VL_julea_db_datatype_encode(hid_t* type_id);
 
+// filter helper
+gboolean H5VL_julea_db_filter_from_dcpl(hid_t dcpl_id, GArray* filters);
+gboolean H5VL_julea_db_filter_to_dcpl(JHDF5Filter const* filters, guint count, hid_t dcpl_id);
+gboolean H5VL_julea_db_filter_encode(JHDF5Filter const* filters, guint count, gsize element_size, gconstpointer data, guint64 length, gpointer* encoded, guint64* encoded_length);
+gboolean H5VL_julea_db_filter_decode(JHDF5Filter const* filters, guint count, gsize element_size, gconstpointer encoded, guint64 encoded_length, gpointer data, guint64 length);
+
+// statistics helper
+JHDF5StatisticsKind H5VL_julea_db_statistics_kind(hid_t type_id);
+void H5VL_julea_db_statistics_init(JHDF5Statistics* statistics);
+void H5VL_julea_db_statistics_compute(JHDF5StatisticsKind kind, gconstpointer data, guint64 count, JHDF5Statistics* statistics);
+gboolean H5VL_julea_db_statistics_equal(JHDF5Statistics const* a, JHDF5Statistics const* b);
+void H5VL_julea_db_statistics_merge(JHDF5Statistics* statistics, JHDF5Statistics const* other);
+gboolean H5VL_julea_db_statistics_overlaps(JHDF5Statistics const* statistics, JHDF5StatisticsKind kind, gdouble min, gdouble max);
+
 // space helper
 JHDF5Object_t* H5VL_julea_db_space_decode(void* backend_id, guint64 backend_id_len);
 JHDF5Object_t* H5VL_julea_db_space_encode(hid_t* type_id);
@@ -218,7 +329,22 @@ herr_t H5VL_julea_db_link_get_info_helper(JHDF5Object_t* obj, const H5VL_loc_par
 herr_t H5VL_julea_db_link_iterate_helper(JHDF5Object_t* object, hbool_t recursive, gboolean attr, H5_index_t idx_type, H5_iter_order_t order, hsize_t* idx_p, JHDF5Iterate_Func_t op, void* op_data);
 herr_t H5VL_julea_db_link_exists_helper(JHDF5Object_t* object, const gchar* name, hbool_t* exists);
 
+// metadata helper
+JHDF5Metadata* H5VL_julea_db_metadata_new(void);
+gboolean H5VL_julea_db_metadata_free(JHDF5Metadata* metadata);
+gboolean H5VL_julea_db_metadata_insert(JHDF5Object_t* object, JDBEntry* entry, GError** error);
+gboolean H5VL_julea_db_metadata_update(JHDF5Object_t* object, JDBEntry* entry, JDBSelector* selector, GError** error);
+gboolean H5VL_julea_db_metadata_flush(JHDF5Object_t* object);
+gboolean H5VL_julea_db_metadata_attr_insert(JHDF5Object_t* parent, JHDF5Object_t* attr, JDBEntry* entry, GError** error);
+gboolean H5VL_julea_db_metadata_attr_write_pending(JHDF5Object_t* attr, gconstpointer data, guint64 length, gboolean* written, GError** error);
+gboolean H5VL_julea_db_metadata_link_get(JHDF5Object_t* parent, const gchar* name, JHDF5Object_t* child, gboolean* exists);
+void H5VL_julea_db_metadata_link_add(JHDF5Object_t* parent, const gchar* name, JHDF5Object_t* child);
+gboolean H5VL_julea_db_metadata_attr_get(JHDF5Object_t* parent, JHDF5Object_t* attr);
+gboolean H5VL_julea_db_metadata_attr_read(JHDF5Object_t* attr, gpointer buf, guint64 length);
+void H5VL_julea_db_metadata_attr_set(JHDF5Object_t* attr, gconstpointer data, guint64 length);
+
 // shared structs
+extern JDBSchema* julea_db_schema_attr;
 extern JDBSchema* julea_db_schema_link;
 extern JDBSchema* julea_db_schema_group;
 
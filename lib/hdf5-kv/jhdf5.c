@@ -52,7 +52,7 @@
 #define JULEA 520
 
 #define H5VL_JULEA_KV_CAP_FLAGS \
-	(H5VL_CAP_FLAG_ATTR_BASIC | H5VL_CAP_FLAG_DATASET_BASIC | H5VL_CAP_FLAG_FILE_BASIC | H5VL_CAP_FLAG_GROUP_BASIC | H5VL_CAP_FLAG_LINK_BASIC | H5VL_CAP_FLAG_STORAGE_SIZE)
+	(H5VL_CAP_FLAG_ATTR_BASIC | H5VL_CAP_FLAG_DATASET_BASIC | H5VL_CAP_FLAG_FILE_BASIC | H5VL_CAP_FLAG_GROUP_BASIC | H5VL_CAP_FLAG_LINK_BASIC | H5VL_CAP_FLAG_STORAGE_SIZE | H5VL_CAP_FLAG_ASYNC)
 
 enum JHDF5Type
 {
@@ -106,6 +106,45 @@ struct JHA_t
 
 typedef struct JHA_t JHA_t;
 
+/* structure for asynchronous request */
+struct JHR_t
+{
+	JBatch* batch;
+	GMutex mutex;
+	GCond cond;
+	gboolean done;
+	gboolean success;
+	gboolean completed;
+	H5VL_request_status_t status;
+	gboolean (*complete)(gpointer);
+	gpointer data;
+	GDestroyNotify data_free;
+	H5VL_request_notify_t notify;
+	void* notify_ctx;
+};
+
+typedef struct JHR_t JHR_t;
+
+/* structure for contiguous byte range of a selection */
+struct JHS_t
+{
+	guint64 offset;
+	guint64 length;
+};
+
+typedef struct JHS_t JHS_t;
+
+/* structure for dataset read */
+struct JHDR_t
+{
+	gchar* buf;
+	gchar* staging;
+	GArray* mem_seqs;
+	guint64* bytes_read;
+};
+
+typedef struct JHDR_t JHDR_t;
+
 static JSemantics* j_hdf5_semantics;
 
 /**
@@ -1346,7 +1385,274 @@ H5VL_julea_dataset_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 }
 
 /**
- * Reads the data from the dataset
+ * Records the result of an asynchronously executed batch
+ **/
+static void
+H5VL_julea_request_callback(JBatch* batch, gboolean ret, gpointer user_data)
+{
+	JHR_t* r = (JHR_t*)user_data;
+
+	(void)batch;
+
+	g_mutex_lock(&r->mutex);
+	r->done = TRUE;
+	r->success = ret;
+	g_cond_broadcast(&r->cond);
+	g_mutex_unlock(&r->mutex);
+}
+
+/**
+ * Executes a batch asynchronously
+ *
+ * \param complete Called in the application's thread once the batch has been executed successfully, may be NULL
+ *
+ * \return r The request, which takes ownership of data
+ **/
+static void*
+H5VL_julea_request_new(JBatch* batch, gboolean (*complete)(gpointer), gpointer data, GDestroyNotify data_free)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHR_t* r;
+
+	r = g_new0(JHR_t, 1);
+	r->batch = j_batch_ref(batch);
+	r->status = H5VL_REQUEST_STATUS_IN_PROGRESS;
+	r->complete = complete;
+	r->data = data;
+	r->data_free = data_free;
+	g_mutex_init(&r->mutex);
+	g_cond_init(&r->cond);
+
+	j_batch_execute_async(batch, H5VL_julea_request_callback, r);
+
+	return r;
+}
+
+/**
+ * Waits for a request to finish, at most for timeout nanoseconds
+ **/
+static herr_t
+H5VL_julea_request_wait(void* req, uint64_t timeout, H5VL_request_status_t* status)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JHR_t* r = (JHR_t*)req;
+	gboolean done;
+
+	g_mutex_lock(&r->mutex);
+
+	if (timeout == H5ES_WAIT_FOREVER)
+	{
+		while (!r->done)
+		{
+			g_cond_wait(&r->cond, &r->mutex);
+		}
+	}
+	else
+	{
+		gint64 end_time = g_get_monotonic_time() + timeout / 1000;
+
+		while (!r->done)
+		{
+			if (!g_cond_wait_until(&r->cond, &r->mutex, end_time))
+			{
+				break;
+			}
+		}
+	}
+
+	done = r->done;
+
+	g_mutex_unlock(&r->mutex);
+
+	if (done && !r->completed)
+	{
+		j_batch_wait(r->batch);
+
+		r->completed = TRUE;
+		r->status = H5VL_REQUEST_STATUS_FAIL;
+
+		if (r->success && (r->complete == NULL || r->complete(r->data)))
+		{
+			r->status = H5VL_REQUEST_STATUS_SUCCEED;
+		}
+
+		if (r->notify != NULL)
+		{
+			r->notify(r->notify_ctx, r->status);
+		}
+	}
+
+	*status = r->status;
+
+	return 0;
+}
+
+/**
+ * Registers a callback that is invoked once the request has finished
+ **/
+static herr_t
+H5VL_julea_request_notify(void* req, H5VL_request_notify_t cb, void* ctx)
+{
+	JHR_t* r = (JHR_t*)req;
+
+	r->notify = cb;
+	r->notify_ctx = ctx;
+
+	// completed requests notify immediately
+	if (r->completed && cb != NULL)
+	{
+		cb(ctx, r->status);
+	}
+
+	return 0;
+}
+
+/**
+ * Batches cannot be aborted once they have been started, finished requests report their result instead
+ **/
+static herr_t
+H5VL_julea_request_cancel(void* req, H5VL_request_status_t* status)
+{
+	H5VL_request_status_t wait_status;
+
+	H5VL_julea_request_wait(req, 0, &wait_status);
+
+	*status = (wait_status == H5VL_REQUEST_STATUS_IN_PROGRESS) ? H5VL_REQUEST_STATUS_CANT_CANCEL : wait_status;
+
+	return 0;
+}
+
+/**
+ * Frees the request after waiting for it to finish
+ **/
+static herr_t
+H5VL_julea_request_free(void* req)
+{
+	JHR_t* r = (JHR_t*)req;
+	H5VL_request_status_t status;
+
+	H5VL_julea_request_wait(req, H5ES_WAIT_FOREVER, &status);
+
+	if (r->data_free != NULL)
+	{
+		r->data_free(r->data);
+	}
+
+	j_batch_unref(r->batch);
+	g_cond_clear(&r->cond);
+	g_mutex_clear(&r->mutex);
+	g_free(r);
+
+	return 0;
+}
+
+/**
+ * Converts a selection into byte ranges, merging adjacent ranges
+ *
+ * The ranges are returned in the selection's iteration order, so that the n-th selected elements of two selections correspond to each other.
+ *
+ * \return seqs The byte ranges
+ **/
+static GArray*
+H5VL_julea_dataset_sequences(hid_t space_id, size_t element_size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GArray* seqs;
+	hid_t iter;
+	hsize_t offsets[64];
+	size_t lengths[64];
+	size_t nseq;
+	size_t nelem;
+
+	seqs = g_array_new(FALSE, FALSE, sizeof(JHS_t));
+
+	if ((iter = H5Ssel_iter_create(space_id, element_size, 0)) < 0)
+	{
+		g_array_unref(seqs);
+		return NULL;
+	}
+
+	do
+	{
+		if (H5Ssel_iter_get_seq_list(iter, G_N_ELEMENTS(offsets), SIZE_MAX, &nseq, &nelem, offsets, lengths) < 0)
+		{
+			g_clear_pointer(&seqs, g_array_unref);
+			break;
+		}
+
+		for (size_t i = 0; i < nseq; i++)
+		{
+			JHS_t* last = (seqs->len > 0) ? &g_array_index(seqs, JHS_t, seqs->len - 1) : NULL;
+
+			if (last != NULL && last->offset + last->length == offsets[i])
+			{
+				last->length += lengths[i];
+			}
+			else
+			{
+				JHS_t seq = { offsets[i], lengths[i] };
+
+				g_array_append_val(seqs, seq);
+			}
+		}
+	} while (nseq > 0);
+
+	H5Ssel_iter_close(iter);
+
+	return seqs;
+}
+
+static void
+H5VL_julea_dataset_read_clear(gpointer data)
+{
+	JHDR_t* r = data;
+
+	g_free(r->staging);
+	g_clear_pointer(&r->mem_seqs, g_array_unref);
+	g_free(r->bytes_read);
+	g_free(r);
+}
+
+/**
+ * Scatters the data that has been read into a staging buffer into the memory selections
+ **/
+static gboolean
+H5VL_julea_dataset_read_complete(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GPtrArray* reads = data;
+
+	for (guint i = 0; i < reads->len; i++)
+	{
+		JHDR_t* r = g_ptr_array_index(reads, i);
+		gsize position = 0;
+
+		if (r->staging == NULL)
+		{
+			continue;
+		}
+
+		for (guint j = 0; j < r->mem_seqs->len; j++)
+		{
+			JHS_t* seq = &g_array_index(r->mem_seqs, JHS_t, j);
+
+			memcpy(r->buf + seq->offset, r->staging + position, seq->length);
+			position += seq->length;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Reads the data from one or more datasets using a single batch
+ *
+ * Only the selected parts of the dataset are read.
+ * If the memory selection is not contiguous, the data is read into a staging buffer and scattered afterwards.
  **/
 static herr_t
 H5VL_julea_dataset_read(size_t count, void* dset[], hid_t mem_type_id[], hid_t mem_space_id[], hid_t file_space_id[], hid_t dxpl_id, void* buf[], void** req)
@@ -1354,35 +1660,103 @@ H5VL_julea_dataset_read(size_t count, void* dset[], hid_t mem_type_id[], hid_t m
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JBatch) batch = NULL;
-	guint64 bytes_read;
-	/// \todo support multi-read
-	void* buf0 = buf[0];
-	JHD_t* d = (JHD_t*)dset[0];
+	g_autoptr(GPtrArray) reads = NULL;
+	gboolean pending = FALSE;
 
-	(void)mem_type_id;
-	(void)mem_space_id;
-	(void)file_space_id;
 	(void)dxpl_id;
-	(void)req;
 
-	/// \todo support multi-read
-	g_return_val_if_fail(count == 1, -1);
+	g_return_val_if_fail(count > 0, -1);
+	g_assert(buf != NULL);
 
 	batch = j_batch_new(j_hdf5_semantics);
+	reads = g_ptr_array_new_with_free_func(H5VL_julea_dataset_read_clear);
 
-	bytes_read = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		JHD_t* d = (JHD_t*)dset[i];
+		JHDR_t* r;
+		g_autoptr(GArray) file_seqs = NULL;
+		gchar* target;
+		size_t element_size;
 
-	g_assert(buf != NULL);
+		g_assert(d->object != NULL);
+
+		r = g_new0(JHDR_t, 1);
+		r->buf = buf[i];
+		g_ptr_array_add(reads, r);
+
+		element_size = H5Tget_size(mem_type_id[i]);
+
+		if (file_space_id[i] == H5S_ALL)
+		{
+			JHS_t seq = { 0, d->data_size };
+
+			file_seqs = g_array_new(FALSE, FALSE, sizeof(JHS_t));
+			g_array_append_val(file_seqs, seq);
+		}
+		else if (!(file_seqs = H5VL_julea_dataset_sequences(file_space_id[i], element_size)))
+		{
+			return -1;
+		}
+
+		if (mem_space_id[i] == H5S_ALL)
+		{
+			// the memory layout matches the file's
+			r->mem_seqs = g_array_ref(file_seqs);
+		}
+		else if (!(r->mem_seqs = H5VL_julea_dataset_sequences(mem_space_id[i], element_size)))
+		{
+			return -1;
+		}
+
+		if (r->mem_seqs->len == 1)
+		{
+			target = r->buf + g_array_index(r->mem_seqs, JHS_t, 0).offset;
+		}
+		else
+		{
+			gsize size = 0;
+
+			for (guint j = 0; j < r->mem_seqs->len; j++)
+			{
+				size += g_array_index(r->mem_seqs, JHS_t, j).length;
+			}
 
-	g_assert(d->object != NULL);
+			r->staging = g_malloc(size);
+			target = r->staging;
+		}
+
+		r->bytes_read = g_new0(guint64, file_seqs->len);
 
-	j_distributed_object_read(d->object, buf0, d->data_size, 0, &bytes_read, batch);
+		for (guint j = 0; j < file_seqs->len; j++)
+		{
+			JHS_t* seq = &g_array_index(file_seqs, JHS_t, j);
+
+			j_distributed_object_read(d->object, target, seq->length, seq->offset, &r->bytes_read[j], batch);
+			target += seq->length;
+			pending = TRUE;
+		}
+	}
+
+	// empty selections do not require any I/O
+	if (!pending)
+	{
+		return 1;
+	}
+
+	if (req != NULL)
+	{
+		*req = H5VL_julea_request_new(batch, H5VL_julea_dataset_read_complete, g_steal_pointer(&reads), (GDestroyNotify)g_ptr_array_unref);
+		return 1;
+	}
 
 	if (!j_batch_execute(batch))
 	{
 		/// \todo check return value properly
 	}
 
+	H5VL_julea_dataset_read_complete(reads);
+
 	return 1;
 }
 
@@ -1462,7 +1836,7 @@ H5VL_julea_dataset_get(void* dset, H5VL_dataset_get_args_t* args, hid_t dxpl_id,
 }
 
 /**
- * Writes the data to the dataset
+ * Writes the data to one or more datasets using a single batch
  **/
 static herr_t
 H5VL_julea_dataset_write(size_t count, void* dset[], hid_t mem_type_id[], hid_t mem_space_id[],
@@ -1471,25 +1845,30 @@ H5VL_julea_dataset_write(size_t count, void* dset[], hid_t mem_type_id[], hid_t
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JBatch) batch = NULL;
-	guint64 bytes_written;
-	/// \todo support multi-write
-	JHD_t* d = (JHD_t*)dset[0];
-	const void* buf0 = buf[0];
+	g_autofree guint64* bytes_written = NULL;
 
 	(void)mem_type_id;
 	(void)mem_space_id;
 	(void)file_space_id;
 	(void)dxpl_id;
-	(void)req;
 
-	/// \todo support multi-write
-	g_return_val_if_fail(count == 1, -1);
+	g_return_val_if_fail(count > 0, -1);
 
 	batch = j_batch_new(j_hdf5_semantics);
+	bytes_written = g_new0(guint64, count);
 
-	bytes_written = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		JHD_t* d = (JHD_t*)dset[i];
 
-	j_distributed_object_write(d->object, buf0, d->data_size, 0, &bytes_written, batch);
+		j_distributed_object_write(d->object, buf[i], d->data_size, 0, &bytes_written[i], batch);
+	}
+
+	if (req != NULL)
+	{
+		*req = H5VL_julea_request_new(batch, NULL, g_steal_pointer(&bytes_written), g_free);
+		return 1;
+	}
 
 	if (!j_batch_execute(batch))
 	{
@@ -1644,12 +2023,12 @@ static const H5VL_class_t H5VL_julea_g = {
 		.opt_query = H5VL_julea_introspect_opt_query,
 	},
 	.request_cls = {
-		.wait = NULL,
-		.notify = NULL,
-		.cancel = NULL,
+		.wait = H5VL_julea_request_wait,
+		.notify = H5VL_julea_request_notify,
+		.cancel = H5VL_julea_request_cancel,
 		.specific = NULL,
 		.optional = NULL,
-		.free = NULL,
+		.free = H5VL_julea_request_free,
 	},
 	.blob_cls = {
 		.put = NULL,
@@ -1732,3 +2111,17 @@ j_hdf5_set_semantics(JSemantics* semantics)
 
 	j_hdf5_semantics = j_semantics_ref(semantics);
 }
+
+/**
+ * Selects the parts of a dataset that may contain values within [min, max].
+ * No statistics are kept, so the dataset is always selected completely.
+ **/
+herr_t
+j_hdf5_dataset_select_range(hid_t dataset_id, hid_t space_id, gdouble min, gdouble max)
+{
+	(void)dataset_id;
+	(void)min;
+	(void)max;
+
+	return H5Sselect_all(space_id);
+}
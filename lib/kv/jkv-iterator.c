@@ -95,6 +95,12 @@ fetch_reply(guint32 index, gchar const* namespace, gchar const* prefix)
 	}
 
 	kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+
+	if (kv_connection == NULL)
+	{
+		return NULL;
+	}
+
 	j_message_send(message, kv_connection);
 
 	reply = j_message_new_reply(message);
@@ -237,7 +243,8 @@ j_kv_iterator_next(JKVIterator* iterator)
 	if (iterator->kv_backend == NULL)
 	{
 	retry:
-		iterator->len = j_message_get_4(iterator->replies[iterator->replies_cur]);
+		// Servers that could not be reached do not have a reply
+		iterator->len = (iterator->replies[iterator->replies_cur] != NULL) ? j_message_get_4(iterator->replies[iterator->replies_cur]) : 0;
 
 		if (iterator->len > 0)
 		{
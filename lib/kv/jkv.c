@@ -62,6 +62,11 @@ struct JKVOperation
 
 typedef struct JKVOperation JKVOperation;
 
+/**
+ * Returns the message size required by an operation.
+ **/
+typedef gsize (*JKVSizeFunc)(gpointer operation);
+
 /**
  * A JKV.
  **/
@@ -185,6 +190,63 @@ j_kv_get_free(gpointer data)
 	g_free(operation);
 }
 
+static gsize
+j_kv_put_size(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* operation = data;
+
+	return strlen(operation->put.kv->key) + 1 + 4 + operation->put.value_len;
+}
+
+static gsize
+j_kv_delete_size(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKV* kv = data;
+
+	return strlen(kv->key) + 1;
+}
+
+static gsize
+j_kv_get_size(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* operation = data;
+
+	return strlen(operation->get.kv->key) + 1;
+}
+
+/**
+ * Sizes a message up front, so that adding the operations does not reallocate it.
+ *
+ * \private
+ *
+ * \param message    A message.
+ * \param operations A list of operations.
+ * \param size_func  A function returning the message size required by an operation.
+ **/
+static void
+j_kv_message_reserve(JMessage* message, JList* operations, JKVSizeFunc size_func)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JListIterator) it = NULL;
+	gsize size = 0;
+
+	it = j_list_iterator_new(operations);
+
+	while (j_list_iterator_next(it))
+	{
+		size += size_func(j_list_iterator_get(it));
+	}
+
+	j_message_reserve(message, size);
+}
+
 static gboolean
 j_kv_put_exec(JList* operations, JSemantics* semantics)
 {
@@ -232,6 +294,8 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 		message = j_message_new(J_MESSAGE_KV_PUT, namespace_len);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, namespace, namespace_len);
+
+		j_kv_message_reserve(message, operations, j_kv_put_size);
 	}
 	else
 	{
@@ -264,6 +328,12 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 		gpointer kv_connection;
 
 		kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+
+		if (kv_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, kv_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -325,6 +395,8 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 		message = j_message_new(J_MESSAGE_KV_DELETE, namespace_len);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, namespace, namespace_len);
+
+		j_kv_message_reserve(message, operations, j_kv_delete_size);
 	}
 	else
 	{
@@ -355,6 +427,12 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 		gpointer kv_connection;
 
 		kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+
+		if (kv_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, kv_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -422,6 +500,8 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 		message = j_message_new(J_MESSAGE_KV_GET, namespace_len);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, namespace, namespace_len);
+
+		j_kv_message_reserve(message, operations, j_kv_get_size);
 	}
 	else
 	{
@@ -469,13 +549,34 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 		gpointer kv_connection;
 
 		kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
+		iter = j_list_iterator_new(operations);
+
+		if (kv_connection == NULL)
+		{
+			// Report all keys as not found, callbacks have to be called anyway
+			while (j_list_iterator_next(iter))
+			{
+				JKVOperation* kop = j_list_iterator_get(iter);
+
+				if (kop->get.func != NULL)
+				{
+					kop->get.func(NULL, 0, kop->get.data);
+				}
+				else
+				{
+					*(kop->get.value) = NULL;
+					*(kop->get.value_len) = 0;
+				}
+			}
+
+			return FALSE;
+		}
+
 		j_message_send(message, kv_connection);
 
 		reply = j_message_new_reply(message);
 		j_message_receive(reply, kv_connection);
 
-		iter = j_list_iterator_new(operations);
-
 		while (j_list_iterator_next(iter))
 		{
 			JKVOperation* kop = j_list_iterator_get(iter);
@@ -612,6 +713,7 @@ j_kv_put(JKV* kv, gpointer value, guint32 value_len, GDestroyNotify value_destro
 	operation->data = kop;
 	operation->exec_func = j_kv_put_exec;
 	operation->free_func = j_kv_put_free;
+	operation->size = value_len;
 
 	j_batch_add(batch, operation);
 }
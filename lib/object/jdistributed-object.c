@@ -238,6 +238,14 @@ j_distributed_object_create_background_operation(gpointer data)
 	persistency = j_semantics_get(background_data->semantics, J_SEMANTICS_PERSISTENCY);
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
 
+	if (object_connection == NULL)
+	{
+		j_message_unref(background_data->message);
+		g_free(background_data);
+
+		return NULL;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -281,6 +289,14 @@ j_distributed_object_delete_background_operation(gpointer data)
 	persistency = j_semantics_get(background_data->semantics, J_SEMANTICS_PERSISTENCY);
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
 
+	if (object_connection == NULL)
+	{
+		background_data->ret = FALSE;
+		j_message_unref(background_data->message);
+
+		return data;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -331,6 +347,16 @@ j_distributed_object_read_background_operation(gpointer data)
 	guint32 operation_count;
 
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	if (object_connection == NULL)
+	{
+		background_data->ret = FALSE;
+		j_message_unref(background_data->message);
+		j_list_unref(background_data->read.buffers);
+
+		return data;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	reply = j_message_new_reply(background_data->message);
@@ -349,7 +375,11 @@ j_distributed_object_read_background_operation(gpointer data)
 	{
 		guint32 reply_operation_count;
 
-		j_message_receive(reply, object_connection);
+		if (!j_message_receive(reply, object_connection))
+		{
+			background_data->ret = FALSE;
+			break;
+		}
 
 		reply_operation_count = j_message_get_count(reply);
 
@@ -359,7 +389,7 @@ j_distributed_object_read_background_operation(gpointer data)
 			break;
 		}
 
-		for (guint i = 0; i < reply_operation_count && j_list_iterator_next(it); i++)
+		for (guint i = 0; i < reply_operation_count && background_data->ret && j_list_iterator_next(it); i++)
 		{
 			JDistributedObjectReadBuffer* buffer = j_list_iterator_get(it);
 			gchar* read_data = buffer->data;
@@ -368,15 +398,27 @@ j_distributed_object_read_background_operation(gpointer data)
 			guint64 nbytes;
 
 			nbytes = j_message_get_8(reply);
-			j_helper_atomic_add(bytes_read, nbytes);
 
 			if (nbytes > 0)
 			{
 				GInputStream* input;
 
+				// The server closes the connection if it can not deliver the announced data
 				input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-				g_input_stream_read_all(input, read_data, nbytes, NULL, NULL, NULL);
+
+				if (!g_input_stream_read_all(input, read_data, nbytes, NULL, NULL, NULL))
+				{
+					background_data->ret = FALSE;
+					break;
+				}
 			}
+
+			j_helper_atomic_add(bytes_read, nbytes);
+		}
+
+		if (!background_data->ret)
+		{
+			break;
 		}
 
 		operations_done += reply_operation_count;
@@ -384,6 +426,12 @@ j_distributed_object_read_background_operation(gpointer data)
 
 	j_message_unref(background_data->message);
 
+	// The rest of the reply can not be skipped reliably, so the pool has to replace the connection
+	if (!background_data->ret)
+	{
+		g_io_stream_close(G_IO_STREAM(object_connection), NULL, NULL);
+	}
+
 	j_connection_pool_push(J_BACKEND_TYPE_OBJECT, background_data->index, object_connection);
 
 	j_list_unref(background_data->read.buffers);
@@ -413,6 +461,16 @@ j_distributed_object_write_background_operation(gpointer data)
 
 	persistency = j_semantics_get(background_data->semantics, J_SEMANTICS_PERSISTENCY);
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	if (object_connection == NULL)
+	{
+		background_data->ret = FALSE;
+		j_message_unref(background_data->message);
+		j_list_unref(background_data->write.bytes_written);
+
+		return data;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -472,6 +530,15 @@ j_distributed_object_status_background_operation(gpointer data)
 	gpointer object_connection;
 
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	if (object_connection == NULL)
+	{
+		j_message_unref(background_data->message);
+		g_free(background_data);
+
+		return NULL;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	reply = j_message_new_reply(background_data->message);
@@ -532,6 +599,15 @@ j_distributed_object_sync_background_operation(gpointer data)
 
 	persistency = j_semantics_get(background_data->semantics, J_SEMANTICS_PERSISTENCY);
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, background_data->index);
+
+	if (object_connection == NULL)
+	{
+		j_message_unref(background_data->message);
+		g_free(background_data);
+
+		return NULL;
+	}
+
 	j_message_send(background_data->message, object_connection);
 
 	if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -1465,6 +1541,8 @@ j_distributed_object_read(JDistributedObject* object, gpointer data, guint64 len
 
 	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
 
+	*bytes_read = 0;
+
 	// Chunk operation if necessary
 	while (length > 0)
 	{
@@ -1484,6 +1562,7 @@ j_distributed_object_read(JDistributedObject* object, gpointer data, guint64 len
 		operation->data = iop;
 		operation->exec_func = j_distributed_object_read_exec;
 		operation->free_func = j_distributed_object_read_free;
+		operation->size = chunk_size;
 
 		j_batch_add(batch, operation);
 
@@ -1491,8 +1570,6 @@ j_distributed_object_read(JDistributedObject* object, gpointer data, guint64 len
 		length -= chunk_size;
 		offset += chunk_size;
 	}
-
-	*bytes_read = 0;
 }
 
 void
@@ -1511,6 +1588,8 @@ j_distributed_object_write(JDistributedObject* object, gconstpointer data, guint
 
 	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
 
+	*bytes_written = 0;
+
 	// Chunk operation if necessary
 	while (length > 0)
 	{
@@ -1530,6 +1609,7 @@ j_distributed_object_write(JDistributedObject* object, gconstpointer data, guint
 		operation->data = iop;
 		operation->exec_func = j_distributed_object_write_exec;
 		operation->free_func = j_distributed_object_write_free;
+		operation->size = chunk_size;
 
 		j_batch_add(batch, operation);
 
@@ -1537,8 +1617,6 @@ j_distributed_object_write(JDistributedObject* object, gconstpointer data, guint
 		length -= chunk_size;
 		offset += chunk_size;
 	}
-
-	*bytes_written = 0;
 }
 
 void
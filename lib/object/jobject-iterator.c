@@ -89,6 +89,12 @@ fetch_reply(guint32 index, gchar const* namespace, gchar const* prefix)
 	}
 
 	object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+
+	if (object_connection == NULL)
+	{
+		return NULL;
+	}
+
 	j_message_send(message, object_connection);
 
 	reply = j_message_new_reply(message);
@@ -217,7 +223,8 @@ j_object_iterator_next(JObjectIterator* iterator)
 	if (iterator->object_backend == NULL)
 	{
 	retry:
-		iterator->name = j_message_get_string(iterator->replies[iterator->replies_cur]);
+		// Servers that could not be reached do not have a reply
+		iterator->name = (iterator->replies[iterator->replies_cur] != NULL) ? j_message_get_string(iterator->replies[iterator->replies_cur]) : "";
 
 		if (iterator->name[0] != '\0')
 		{
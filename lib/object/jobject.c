@@ -304,6 +304,12 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 
 		persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
 		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+
+		if (object_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, object_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -396,6 +402,12 @@ j_object_delete_exec(JList* operations, JSemantics* semantics)
 
 		persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
 		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+
+		if (object_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, object_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -435,7 +447,9 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 	JListIterator* it;
 	g_autoptr(JMessage) message = NULL;
 	JObject* object;
+	gpointer object_connection = NULL;
 	gpointer object_handle;
+	guint64 segment_size = G_MAXUINT64;
 
 	/// \todo
 	//JLock* lock = NULL;
@@ -463,6 +477,20 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		namespace_len = strlen(object->namespace) + 1;
 		name_len = strlen(object->name) + 1;
 
+		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, object->index);
+
+		if (object_connection == NULL)
+		{
+			j_list_iterator_free(it);
+			return FALSE;
+		}
+
+		// Servers using protocol version 1 cannot handle operations larger than their memory chunk
+		if (j_message_get_version(object_connection) < 2)
+		{
+			segment_size = j_configuration_get_max_operation_size(j_configuration());
+		}
+
 		message = j_message_new(J_MESSAGE_OBJECT_READ, namespace_len + name_len);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, object->namespace, namespace_len);
@@ -492,9 +520,20 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 
 		if (object_backend == NULL)
 		{
-			j_message_add_operation(message, sizeof(guint64) + sizeof(guint64));
-			j_message_append_8(message, &length);
-			j_message_append_8(message, &offset);
+			for (guint64 done = 0; done < length;)
+			{
+				guint64 segment;
+				guint64 segment_offset;
+
+				segment = MIN(length - done, segment_size);
+				segment_offset = offset + done;
+
+				j_message_add_operation(message, sizeof(guint64) + sizeof(guint64));
+				j_message_append_8(message, &segment);
+				j_message_append_8(message, &segment_offset);
+
+				done += segment;
+			}
 		}
 		else
 		{
@@ -512,11 +551,11 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 	if (object_backend == NULL)
 	{
 		g_autoptr(JMessage) reply = NULL;
-		gpointer object_connection;
+		JObjectOperation* operation = NULL;
+		guint64 position = 0;
 		guint32 operations_done;
 		guint32 operation_count;
 
-		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, object->index);
 		j_message_send(message, object_connection);
 
 		reply = j_message_new_reply(message);
@@ -535,7 +574,11 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		{
 			guint32 reply_operation_count;
 
-			j_message_receive(reply, object_connection);
+			if (!j_message_receive(reply, object_connection))
+			{
+				ret = FALSE;
+				break;
+			}
 
 			reply_operation_count = j_message_get_count(reply);
 
@@ -545,31 +588,64 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 				break;
 			}
 
-			for (guint i = 0; i < reply_operation_count && j_list_iterator_next(it); i++)
+			for (guint i = 0; i < reply_operation_count && ret; i++)
 			{
-				JObjectOperation* operation = j_list_iterator_get(it);
-				gpointer data = operation->read.data;
-				guint64* bytes_read = operation->read.bytes_read;
-
 				guint64 nbytes;
 
+				// Operations might have been split into several segments
+				if (operation == NULL)
+				{
+					if (!j_list_iterator_next(it))
+					{
+						break;
+					}
+
+					operation = j_list_iterator_get(it);
+					position = 0;
+				}
+
 				nbytes = j_message_get_8(reply);
-				j_helper_atomic_add(bytes_read, nbytes);
 
 				if (nbytes > 0)
 				{
 					GInputStream* input;
 
+					// The server closes the connection if it can not deliver the announced data
 					input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-					g_input_stream_read_all(input, data, nbytes, NULL, NULL, NULL);
+
+					if (!g_input_stream_read_all(input, (gchar*)operation->read.data + position, nbytes, NULL, NULL, NULL))
+					{
+						ret = FALSE;
+						break;
+					}
+				}
+
+				j_helper_atomic_add(operation->read.bytes_read, nbytes);
+
+				position += MIN(operation->read.length - position, segment_size);
+
+				if (position >= operation->read.length)
+				{
+					operation = NULL;
 				}
 			}
 
+			if (!ret)
+			{
+				break;
+			}
+
 			operations_done += reply_operation_count;
 		}
 
 		j_list_iterator_free(it);
 
+		// The rest of the reply can not be skipped reliably, so the pool has to replace the connection
+		if (!ret)
+		{
+			g_io_stream_close(G_IO_STREAM(object_connection), NULL, NULL);
+		}
+
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, object->index, object_connection);
 	}
 	else
@@ -602,7 +678,9 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	JListIterator* it;
 	g_autoptr(JMessage) message = NULL;
 	JObject* object;
+	gpointer object_connection = NULL;
 	gpointer object_handle;
+	guint64 segment_size = G_MAXUINT64;
 
 	/// \todo
 	//JLock* lock = NULL;
@@ -630,6 +708,20 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 		namespace_len = strlen(object->namespace) + 1;
 		name_len = strlen(object->name) + 1;
 
+		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, object->index);
+
+		if (object_connection == NULL)
+		{
+			j_list_iterator_free(it);
+			return FALSE;
+		}
+
+		// Servers using protocol version 1 cannot handle operations larger than their memory chunk
+		if (j_message_get_version(object_connection) < 2)
+		{
+			segment_size = j_configuration_get_max_operation_size(j_configuration());
+		}
+
 		message = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len);
 		j_message_set_semantics(message, semantics);
 		j_message_append_n(message, object->namespace, namespace_len);
@@ -666,10 +758,21 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 
 		if (object_backend == NULL)
 		{
-			j_message_add_operation(message, sizeof(guint64) + sizeof(guint64));
-			j_message_append_8(message, &length);
-			j_message_append_8(message, &offset);
-			j_message_add_send(message, data, length);
+			for (guint64 done = 0; done < length;)
+			{
+				guint64 segment;
+				guint64 segment_offset;
+
+				segment = MIN(length - done, segment_size);
+				segment_offset = offset + done;
+
+				j_message_add_operation(message, sizeof(guint64) + sizeof(guint64));
+				j_message_append_8(message, &segment);
+				j_message_append_8(message, &segment_offset);
+				j_message_add_send(message, (gchar const*)data + done, segment);
+
+				done += segment;
+			}
 
 			// Fake bytes_written here instead of doing another loop further down
 			if (j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY) == J_SEMANTICS_PERSISTENCY_NONE)
@@ -694,10 +797,7 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	{
 		JSemanticsPersistency persistency;
 
-		gpointer object_connection;
-
 		persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
-		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, object->index);
 		j_message_send(message, object_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -717,8 +817,12 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 					JObjectOperation* operation = j_list_iterator_get(it);
 					guint64* bytes_written = operation->write.bytes_written;
 
-					nbytes = j_message_get_8(reply);
-					j_helper_atomic_add(bytes_written, nbytes);
+					// Operations might have been split into several segments
+					for (guint64 done = 0; done < operation->write.length; done += MIN(operation->write.length - done, segment_size))
+					{
+						nbytes = j_message_get_8(reply);
+						j_helper_atomic_add(bytes_written, nbytes);
+					}
 				}
 
 				j_list_iterator_free(it);
@@ -823,6 +927,12 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 		gpointer object_connection;
 
 		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+
+		if (object_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, object_connection);
 
 		reply = j_message_new_reply(message);
@@ -933,6 +1043,12 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 
 		persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
 		object_connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, index);
+
+		if (object_connection == NULL)
+		{
+			return FALSE;
+		}
+
 		j_message_send(message, object_connection);
 
 		if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -1064,43 +1180,29 @@ j_object_read(JObject* object, gpointer data, guint64 length, guint64 offset, gu
 
 	JObjectOperation* iop;
 	JOperation* operation;
-	guint64 max_operation_size;
 
 	g_return_if_fail(object != NULL);
 	g_return_if_fail(data != NULL);
 	g_return_if_fail(length > 0);
 	g_return_if_fail(bytes_read != NULL);
 
-	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
-
-	// Chunk operation if necessary
-	while (length > 0)
-	{
-		guint64 chunk_size;
-
-		chunk_size = MIN(length, max_operation_size);
-
-		iop = g_new(JObjectOperation, 1);
-		iop->read.object = j_object_ref(object);
-		iop->read.data = data;
-		iop->read.length = chunk_size;
-		iop->read.offset = offset;
-		iop->read.bytes_read = bytes_read;
-
-		operation = j_operation_new();
-		operation->key = object;
-		operation->data = iop;
-		operation->exec_func = j_object_read_exec;
-		operation->free_func = j_object_read_free;
-
-		j_batch_add(batch, operation);
+	iop = g_new(JObjectOperation, 1);
+	iop->read.object = j_object_ref(object);
+	iop->read.data = data;
+	iop->read.length = length;
+	iop->read.offset = offset;
+	iop->read.bytes_read = bytes_read;
 
-		data = (gchar*)data + chunk_size;
-		length -= chunk_size;
-		offset += chunk_size;
-	}
+	operation = j_operation_new();
+	operation->key = object;
+	operation->data = iop;
+	operation->exec_func = j_object_read_exec;
+	operation->free_func = j_object_read_free;
+	operation->size = length;
 
 	*bytes_read = 0;
+
+	j_batch_add(batch, operation);
 }
 
 void
@@ -1110,43 +1212,29 @@ j_object_write(JObject* object, gconstpointer data, guint64 length, guint64 offs
 
 	JObjectOperation* iop;
 	JOperation* operation;
-	guint64 max_operation_size;
 
 	g_return_if_fail(object != NULL);
 	g_return_if_fail(data != NULL);
 	g_return_if_fail(length > 0);
 	g_return_if_fail(bytes_written != NULL);
 
-	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
-
-	// Chunk operation if necessary
-	while (length > 0)
-	{
-		guint64 chunk_size;
-
-		chunk_size = MIN(length, max_operation_size);
-
-		iop = g_new(JObjectOperation, 1);
-		iop->write.object = j_object_ref(object);
-		iop->write.data = data;
-		iop->write.length = chunk_size;
-		iop->write.offset = offset;
-		iop->write.bytes_written = bytes_written;
-
-		operation = j_operation_new();
-		operation->key = object;
-		operation->data = iop;
-		operation->exec_func = j_object_write_exec;
-		operation->free_func = j_object_write_free;
-
-		j_batch_add(batch, operation);
+	iop = g_new(JObjectOperation, 1);
+	iop->write.object = j_object_ref(object);
+	iop->write.data = data;
+	iop->write.length = length;
+	iop->write.offset = offset;
+	iop->write.bytes_written = bytes_written;
 
-		data = (gchar const*)data + chunk_size;
-		length -= chunk_size;
-		offset += chunk_size;
-	}
+	operation = j_operation_new();
+	operation->key = object;
+	operation->data = iop;
+	operation->exec_func = j_object_write_exec;
+	operation->free_func = j_object_write_free;
+	operation->size = length;
 
 	*bytes_written = 0;
+
+	j_batch_add(batch, operation);
 }
 
 void
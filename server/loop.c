@@ -22,6 +22,8 @@
 #include <glib.h>
 #include <gio/gio.h>
 
+#include <string.h>
+
 #include <julea.h>
 
 #include "server.h"
@@ -193,6 +195,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			JMessage* reply;
 			gpointer object;
 			gboolean ret;
+			gboolean broken = FALSE;
 
 			namespace = j_message_get_string(message);
 			path = j_message_get_string(message);
@@ -218,9 +221,72 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 				if (length > memory_chunk_size)
 				{
-					/// \todo return proper error
+					GOutputStream* output;
+					gint64 modification_time;
+					guint64 size = 0;
+
+					// Large operations are streamed in segments that fit into the memory chunk
+					if (j_message_get_count(reply) > 0)
+					{
+						j_message_send(reply, connection);
+						j_message_unref(reply);
+
+						reply = j_message_new_reply(message);
+					}
+
+					j_memory_chunk_reset(memory_chunk);
+
+					// The length has to be sent before the data, so only the available bytes are announced
+					if (j_backend_object_status(jd_object_backend, object, &modification_time, &size) && size > offset)
+					{
+						bytes_read = MIN(length, size - offset);
+					}
+
 					j_message_add_operation(reply, sizeof(guint64));
 					j_message_append_8(reply, &bytes_read);
+					broken = !j_message_send(reply, connection);
+					j_message_unref(reply);
+
+					reply = j_message_new_reply(message);
+
+					output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+
+					for (guint64 done = 0; done < bytes_read && !broken;)
+					{
+						guint64 segment;
+						guint64 nbytes = 0;
+
+						segment = MIN(bytes_read - done, memory_chunk_size);
+						buf = j_memory_chunk_get(memory_chunk, segment);
+
+						// The announced length can not be taken back, so a short read (for example, because the object has been truncated concurrently) breaks the stream
+						if (!j_backend_object_read(jd_object_backend, object, buf, segment, offset + done, &nbytes) || nbytes < segment)
+						{
+							broken = TRUE;
+							break;
+						}
+
+						j_statistics_add(statistics, J_STATISTICS_BYTES_READ, nbytes);
+
+						if (!g_output_stream_write_all(output, buf, segment, NULL, NULL, NULL))
+						{
+							broken = TRUE;
+							break;
+						}
+
+						j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, segment);
+
+						j_memory_chunk_reset(memory_chunk);
+						done += segment;
+					}
+
+					j_memory_chunk_reset(memory_chunk);
+
+					if (broken)
+					{
+						break;
+					}
+
 					continue;
 				}
 
@@ -257,7 +323,17 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				j_backend_object_close(jd_object_backend, object);
 			}
 
-			j_message_send(reply, connection);
+			// The client would interpret anything sent after a broken stream as data, closing the connection makes its read fail
+			// Streamed operations might already have answered everything
+			if (broken)
+			{
+				g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+			}
+			else if (j_message_get_count(reply) > 0 || !ret)
+			{
+				j_message_send(reply, connection);
+			}
+
 			j_message_unref(reply);
 
 			j_memory_chunk_reset(memory_chunk);
@@ -290,35 +366,42 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				length = j_message_get_8(message);
 				offset = j_message_get_8(message);
 
-				if (length > memory_chunk_size && reply != NULL && G_LIKELY(ret))
+				input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+
+				// Large operations are streamed in segments that fit into the memory chunk
+				for (guint64 done = 0; done < length;)
 				{
-					/// \todo return proper error
-					j_message_add_operation(reply, sizeof(guint64));
-					j_message_append_8(reply, &bytes_written);
-					continue;
-				}
+					guint64 segment;
 
-				// Guaranteed to work because memory_chunk is reset below
-				buf = j_memory_chunk_get(memory_chunk, length);
-				g_assert(buf != NULL);
+					segment = MIN(length - done, memory_chunk_size);
 
-				input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
-				g_input_stream_read_all(input, buf, length, NULL, NULL, NULL);
-				j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, length);
+					// Guaranteed to work because memory_chunk is reset below
+					buf = j_memory_chunk_get(memory_chunk, segment);
+					g_assert(buf != NULL);
 
-				if (G_LIKELY(ret))
-				{
-					j_backend_object_write(jd_object_backend, object, buf, length, offset, &bytes_written);
-					j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_written);
+					// The data has to be received even if the object could not be opened
+					g_input_stream_read_all(input, buf, segment, NULL, NULL, NULL);
+					j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, segment);
 
-					if (reply != NULL)
+					if (G_LIKELY(ret))
 					{
-						j_message_add_operation(reply, sizeof(guint64));
-						j_message_append_8(reply, &bytes_written);
+						guint64 nbytes = 0;
+
+						j_backend_object_write(jd_object_backend, object, buf, segment, offset + done, &nbytes);
+						j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, nbytes);
+
+						bytes_written += nbytes;
 					}
+
+					j_memory_chunk_reset(memory_chunk);
+					done += segment;
 				}
 
-				j_memory_chunk_reset(memory_chunk);
+				if (G_LIKELY(ret) && reply != NULL)
+				{
+					j_message_add_operation(reply, sizeof(guint64));
+					j_message_append_8(reply, &bytes_written);
+				}
 			}
 
 			if (persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
@@ -417,12 +500,13 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			guint64 value;
 
 			get_all = j_message_get_1(message);
-			r_statistics = (get_all == 0) ? statistics : jd_statistics;
+			r_statistics = statistics;
 
 			if (get_all != 0)
 			{
-				g_mutex_lock(jd_statistics_mutex);
-				/// \todo add statistics of all threads
+				// Includes connections that are still open
+				r_statistics = j_statistics_new(FALSE);
+				jd_statistics_get_all(r_statistics);
 			}
 
 			reply = j_message_new_reply(message);
@@ -445,9 +529,12 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			value = j_statistics_get(r_statistics, J_STATISTICS_BYTES_SENT);
 			j_message_append_8(reply, &value);
 
+			// Older clients only read the counters above
+			j_statistics_serialize_operations(r_statistics, reply);
+
 			if (get_all != 0)
 			{
-				g_mutex_unlock(jd_statistics_mutex);
+				j_statistics_free(r_statistics);
 			}
 
 			j_message_send(reply, connection);
@@ -456,8 +543,10 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_PING:
 		{
 			g_autoptr(JMessage) reply = NULL;
+			g_autofree gchar* server_version = NULL;
 			gchar const* client_checksum;
 			gchar const* server_checksum;
+			guint32 version = 1;
 			guint num;
 
 			num = g_atomic_int_add(&jd_thread_num, 1);
@@ -467,6 +556,19 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			client_checksum = j_message_get_string(message);
 			server_checksum = j_configuration_get_checksum(jd_configuration);
 
+			// Older clients do not send their version
+			for (i = 0; i < operation_count; i++)
+			{
+				gchar const* client_version;
+
+				client_version = j_message_get_string(message);
+
+				if (g_str_has_prefix(client_version, "version "))
+				{
+					version = MIN(g_ascii_strtoull(client_version + strlen("version "), NULL, 10), J_MESSAGE_VERSION);
+				}
+			}
+
 			if (g_strcmp0(client_checksum, server_checksum) != 0)
 			{
 				g_warning("Client %d uses different configuration than server.", num);
@@ -493,7 +595,18 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				j_message_append_string(reply, "db");
 			}
 
+			// Older clients ignore unknown strings
+			server_version = g_strdup_printf("version %d", J_MESSAGE_VERSION);
+			j_message_add_operation(reply, strlen(server_version) + 1);
+			j_message_append_string(reply, server_version);
+
+			// The reply still uses the old version, both sides switch afterwards
 			j_message_send(reply, connection);
+
+			if (version >= 2)
+			{
+				j_message_set_version(connection, version);
+			}
 		}
 		break;
 		case J_MESSAGE_KV_PUT:
@@ -728,6 +841,13 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				memcpy(&backend_operation, &j_backend_operation_db_query, sizeof(JBackendOperation));
 				message_matched = TRUE;
 			}
+			// fallthrough
+		case J_MESSAGE_DB_EXPLAIN:
+			if (!message_matched)
+			{
+				memcpy(&backend_operation, &j_backend_operation_db_explain, sizeof(JBackendOperation));
+				message_matched = TRUE;
+			}
 			{
 				g_autoptr(JMessage) reply = NULL;
 				GError* error = NULL;
@@ -18,6 +18,12 @@
 
 #include <julea-config.h>
 
+#ifdef HAVE_SCHED_SETAFFINITY
+// CPU affinity is not part of POSIX
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <glib-unix.h>
@@ -36,12 +42,50 @@
 JStatistics* jd_statistics = NULL;
 GMutex jd_statistics_mutex[1] = { 0 };
 
+/**
+ * The statistics of all open connections, protected by jd_statistics_mutex.
+ **/
+static GList* jd_statistics_connections = NULL;
+
 JBackend* jd_object_backend = NULL;
 JBackend* jd_kv_backend = NULL;
 JBackend* jd_db_backend = NULL;
 
 JConfiguration* jd_configuration = NULL;
 
+/**
+ * The CPUs the server's threads run on, NULL if not restricted.
+ **/
+static GArray* jd_cpus = NULL;
+
+/**
+ * Whether every connection thread is pinned to a single CPU.
+ **/
+static gboolean jd_pin_threads = FALSE;
+
+/**
+ * The index of the CPU to pin the next connection thread to.
+ **/
+static gint jd_next_cpu = 0;
+
+void
+jd_statistics_get_all(JStatistics* statistics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_mutex_lock(jd_statistics_mutex);
+
+	j_statistics_merge(statistics, jd_statistics);
+
+	// Connections update their statistics without locking, so they can be read while they are open
+	for (GList* l = jd_statistics_connections; l != NULL; l = l->next)
+	{
+		j_statistics_merge(statistics, l->data);
+	}
+
+	g_mutex_unlock(jd_statistics_mutex);
+}
+
 static gboolean
 jd_signal(gpointer data)
 {
@@ -57,6 +101,167 @@ jd_signal(gpointer data)
 	return FALSE;
 }
 
+/**
+ * Parses a list of CPUs such as 0-3,8,10-11.
+ *
+ * \param list A list of CPUs.
+ *
+ * \return An array of CPU numbers, NULL if the list is invalid.
+ **/
+static GArray*
+jd_parse_cpu_list(gchar const* list)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_auto(GStrv) ranges = NULL;
+	GArray* cpus;
+
+	cpus = g_array_new(FALSE, FALSE, sizeof(guint));
+	ranges = g_strsplit(list, ",", 0);
+
+	for (guint i = 0; ranges[i] != NULL; i++)
+	{
+		g_auto(GStrv) bounds = NULL;
+		guint64 first;
+		guint64 last;
+
+		g_strstrip(ranges[i]);
+
+		if (ranges[i][0] == '\0')
+		{
+			continue;
+		}
+
+		bounds = g_strsplit(ranges[i], "-", 2);
+
+		if (!g_ascii_string_to_unsigned(bounds[0], 10, 0, G_MAXUINT16, &first, NULL))
+		{
+			goto error;
+		}
+
+		last = first;
+
+		if (bounds[1] != NULL && !g_ascii_string_to_unsigned(bounds[1], 10, first, G_MAXUINT16, &last, NULL))
+		{
+			goto error;
+		}
+
+		for (guint cpu = first; cpu <= last; cpu++)
+		{
+			g_array_append_val(cpus, cpu);
+		}
+	}
+
+	if (cpus->len > 0)
+	{
+		return cpus;
+	}
+
+error:
+	g_array_unref(cpus);
+
+	return NULL;
+}
+
+/**
+ * Returns the CPUs of a NUMA node.
+ *
+ * \param node A NUMA node.
+ *
+ * \return A list of CPUs, NULL if the node does not exist.
+ **/
+static gchar*
+jd_get_numa_node_cpus(gint node)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autofree gchar* path = NULL;
+	gchar* cpus = NULL;
+
+	path = g_strdup_printf("/sys/devices/system/node/node%d/cpulist", node);
+
+	if (!g_file_get_contents(path, &cpus, NULL, NULL))
+	{
+		return NULL;
+	}
+
+	return g_strstrip(cpus);
+}
+
+/**
+ * Restricts the calling thread to a set of CPUs.
+ * Threads created afterwards inherit the restriction.
+ *
+ * \param cpus An array of CPU numbers.
+ * \param len  The number of CPUs.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+jd_set_affinity(guint const* cpus, guint len)
+{
+	J_TRACE_FUNCTION(NULL);
+
+#ifdef HAVE_SCHED_SETAFFINITY
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+
+	for (guint i = 0; i < len; i++)
+	{
+		if (cpus[i] >= CPU_SETSIZE)
+		{
+			return FALSE;
+		}
+
+		CPU_SET(cpus[i], &set);
+	}
+
+	// 0 refers to the calling thread
+	return (sched_setaffinity(0, sizeof(set), &set) == 0);
+#else
+	(void)cpus;
+	(void)len;
+
+	return FALSE;
+#endif
+}
+
+/**
+ * Returns the CPUs the calling thread may run on.
+ *
+ * \return An array of CPU numbers, NULL if an error occurred.
+ **/
+static GArray*
+jd_get_affinity(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+#ifdef HAVE_SCHED_SETAFFINITY
+	GArray* cpus;
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof(set), &set) != 0)
+	{
+		return NULL;
+	}
+
+	cpus = g_array_new(FALSE, FALSE, sizeof(guint));
+
+	for (guint cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (CPU_ISSET(cpu, &set))
+		{
+			g_array_append_val(cpus, cpu);
+		}
+	}
+
+	return cpus;
+#else
+	return NULL;
+#endif
+}
+
 static gboolean
 jd_on_run(GThreadedSocketService* service, GSocketConnection* connection, GObject* source_object, gpointer user_data)
 {
@@ -73,40 +278,61 @@ jd_on_run(GThreadedSocketService* service, GSocketConnection* connection, GObjec
 
 	j_helper_set_nodelay(connection, TRUE);
 
+	if (jd_pin_threads)
+	{
+		guint cpu;
+
+		// Buffers are only backed by memory when they are first written, so pinning before allocating them makes them local to the CPU's NUMA node
+		cpu = g_array_index(jd_cpus, guint, (guint)g_atomic_int_add(&jd_next_cpu, 1) % jd_cpus->len);
+
+		if (!jd_set_affinity(&cpu, 1))
+		{
+			g_warning("Could not pin connection thread to CPU %u.", cpu);
+		}
+	}
+
 	statistics = j_statistics_new(TRUE);
 	memory_chunk_size = j_configuration_get_max_operation_size(jd_configuration);
 	memory_chunk = j_memory_chunk_new(memory_chunk_size);
 
 	message = j_message_new(J_MESSAGE_NONE, 0);
 
+	g_mutex_lock(jd_statistics_mutex);
+	jd_statistics_connections = g_list_prepend(jd_statistics_connections, statistics);
+	g_mutex_unlock(jd_statistics_mutex);
+
 	while (j_message_receive(message, connection))
 	{
-		jd_handle_message(message, connection, memory_chunk, memory_chunk_size, statistics);
-	}
+		guint64 backend_time;
+		guint64 bytes;
+		gint64 start;
+		guint64 time;
 
-	{
-		guint64 value;
+		start = g_get_monotonic_time();
+		backend_time = j_backend_get_thread_time();
+		bytes = j_statistics_get(statistics, J_STATISTICS_BYTES_RECEIVED) + j_statistics_get(statistics, J_STATISTICS_BYTES_SENT);
 
-		g_mutex_lock(jd_statistics_mutex);
+		// backend calls are traced as children of the client's span
+		j_trace_set_correlation(j_message_get_trace_id(message));
+		j_trace_set_span(j_message_get_span_id(message));
 
-		value = j_statistics_get(statistics, J_STATISTICS_FILES_CREATED);
-		j_statistics_add(jd_statistics, J_STATISTICS_FILES_CREATED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_FILES_DELETED);
-		j_statistics_add(jd_statistics, J_STATISTICS_FILES_DELETED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_SYNC);
-		j_statistics_add(jd_statistics, J_STATISTICS_SYNC, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_READ);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_READ, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_WRITTEN);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_WRITTEN, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_RECEIVED);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_RECEIVED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_SENT);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_SENT, value);
+		jd_handle_message(message, connection, memory_chunk, memory_chunk_size, statistics);
 
-		g_mutex_unlock(jd_statistics_mutex);
+		j_trace_set_span(0);
+		j_trace_set_correlation(0);
+
+		time = g_get_monotonic_time() - start;
+		backend_time = j_backend_get_thread_time() - backend_time;
+		bytes = j_statistics_get(statistics, J_STATISTICS_BYTES_RECEIVED) + j_statistics_get(statistics, J_STATISTICS_BYTES_SENT) - bytes;
+
+		j_statistics_add_operation(statistics, j_message_get_type(message), j_message_get_length(message) + bytes, time - MIN(time, backend_time), backend_time);
 	}
 
+	g_mutex_lock(jd_statistics_mutex);
+	jd_statistics_connections = g_list_remove(jd_statistics_connections, statistics);
+	j_statistics_merge(jd_statistics, statistics);
+	g_mutex_unlock(jd_statistics_mutex);
+
 	j_memory_chunk_free(memory_chunk);
 	j_statistics_free(statistics);
 
@@ -266,6 +492,9 @@ main(int argc, char** argv)
 	gboolean opt_daemon = FALSE;
 	g_autofree gchar* opt_host = NULL;
 	gint opt_port = 0;
+	g_autofree gchar* opt_cpus = NULL;
+	gint opt_numa_node = -1;
+	gboolean opt_pin_threads = FALSE;
 
 	JTrace* trace;
 	GError* error = NULL;
@@ -281,6 +510,9 @@ main(int argc, char** argv)
 		{ "daemon", 0, 0, G_OPTION_ARG_NONE, &opt_daemon, "Run as daemon", NULL },
 		{ "host", 0, 0, G_OPTION_ARG_STRING, &opt_host, "Override host name", "hostname" },
 		{ "port", 0, 0, G_OPTION_ARG_INT, &opt_port, "Port to use", "0" },
+		{ "cpus", 0, 0, G_OPTION_ARG_STRING, &opt_cpus, "Run on these CPUs only", "0-3,8" },
+		{ "numa-node", 0, 0, G_OPTION_ARG_INT, &opt_numa_node, "Run on the CPUs of this NUMA node only", "0" },
+		{ "pin-threads", 0, 0, G_OPTION_ARG_NONE, &opt_pin_threads, "Pin every connection thread to a single CPU", NULL },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
 
@@ -327,6 +559,47 @@ main(int argc, char** argv)
 		opt_port = j_configuration_get_port(jd_configuration);
 	}
 
+	if (opt_numa_node >= 0 && opt_cpus == NULL)
+	{
+		if ((opt_cpus = jd_get_numa_node_cpus(opt_numa_node)) == NULL)
+		{
+			g_warning("NUMA node %d does not exist.", opt_numa_node);
+			return 1;
+		}
+	}
+
+	if (opt_cpus != NULL)
+	{
+		if ((jd_cpus = jd_parse_cpu_list(opt_cpus)) == NULL)
+		{
+			g_warning("Invalid CPU list %s.", opt_cpus);
+			return 1;
+		}
+
+		// All threads created afterwards, including the backends' and the connection threads, inherit the affinity
+		if (!jd_set_affinity((guint const*)(gpointer)jd_cpus->data, jd_cpus->len))
+		{
+			g_warning("Could not restrict server to CPUs %s.", opt_cpus);
+			return 1;
+		}
+	}
+
+	if (opt_pin_threads)
+	{
+		if (jd_cpus == NULL)
+		{
+			jd_cpus = jd_get_affinity();
+		}
+
+		if (jd_cpus == NULL || jd_cpus->len == 0)
+		{
+			g_warning("Pinning threads is not supported.");
+			return 1;
+		}
+
+		jd_pin_threads = TRUE;
+	}
+
 	socket_service = g_threaded_socket_service_new(-1);
 	g_socket_listener_set_backlog(G_SOCKET_LISTENER(socket_service), 128);
 
@@ -431,6 +704,11 @@ main(int argc, char** argv)
 
 	j_configuration_unref(jd_configuration);
 
+	if (jd_cpus != NULL)
+	{
+		g_array_unref(jd_cpus);
+	}
+
 	j_trace_leave(trace);
 
 	j_trace_fini();
@@ -37,6 +37,8 @@ G_GNUC_INTERNAL extern JBackend* jd_db_backend;
 
 G_GNUC_INTERNAL extern JConfiguration* jd_configuration;
 
+G_GNUC_INTERNAL void jd_statistics_get_all(JStatistics*);
+
 G_GNUC_INTERNAL gboolean jd_handle_message(JMessage*, GSocketConnection*, JMemoryChunk*, guint64, JStatistics*);
 
 #endif
@@ -60,9 +60,134 @@ test_background_operation_wait(void)
 	J_TEST_TRAP_END;
 }
 
+static gpointer
+on_background_operation_increment(gpointer data)
+{
+	return GUINT_TO_POINTER(GPOINTER_TO_UINT(data) + 1);
+}
+
+static gpointer
+on_background_operation_fan_out(gpointer data)
+{
+	JBackgroundOperation* background_operations[16];
+	guint sum = 0;
+
+	(void)data;
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		background_operations[i] = j_background_operation_new(on_background_operation_increment, GUINT_TO_POINTER(i));
+	}
+
+	j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		sum += GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i]));
+		j_background_operation_unref(background_operations[i]);
+	}
+
+	return GUINT_TO_POINTER(sum);
+}
+
+static void
+test_background_operation_wait_all(void)
+{
+	JBackgroundOperation* background_operations[64];
+
+	J_TEST_TRAP_START;
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		// NULL entries are skipped
+		background_operations[i] = (i % 8 == 7) ? NULL : j_background_operation_new(on_background_operation_increment, GUINT_TO_POINTER(i));
+	}
+
+	j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		if (background_operations[i] == NULL)
+		{
+			continue;
+		}
+
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i])), ==, i + 1);
+		j_background_operation_unref(background_operations[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_background_operation_nested(void)
+{
+	JBackgroundOperation* background_operations[32];
+
+	J_TEST_TRAP_START;
+	// Nested background operations must not deadlock, even if all workers are waiting
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		background_operations[i] = j_background_operation_new(on_background_operation_fan_out, NULL);
+	}
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		// 1 + 2 + ... + 16
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i])), ==, 136);
+		j_background_operation_unref(background_operations[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
+static gpointer
+on_background_operation_record_thread(gpointer data)
+{
+	GThread** thread = data;
+
+	g_atomic_pointer_set(thread, g_thread_self());
+
+	return NULL;
+}
+
+static void
+test_background_operation_wait_own(void)
+{
+	JBackgroundOperation* background_operations[64];
+	GThread* threads[G_N_ELEMENTS(background_operations)];
+	JBackgroundOperation* background_operation;
+
+	J_TEST_TRAP_START;
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		threads[i] = NULL;
+		background_operations[i] = j_background_operation_new(on_background_operation_record_thread, &(threads[i]));
+	}
+
+	background_operation = j_background_operation_new(on_background_operation_increment, GUINT_TO_POINTER(0));
+	g_assert_cmpuint(GPOINTER_TO_UINT(j_background_operation_wait(background_operation)), ==, 1);
+	j_background_operation_unref(background_operation);
+
+	// Threads that are not workers must not execute background operations they are not waiting for
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		g_assert_true(g_atomic_pointer_get(&(threads[i])) != g_thread_self());
+	}
+
+	j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		g_assert_nonnull(threads[i]);
+		j_background_operation_unref(background_operations[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
 void
 test_core_background_operation(void)
 {
 	g_test_add_func("/core/background_operation/new_ref_unref", test_background_operation_new_ref_unref);
 	g_test_add_func("/core/background_operation/wait", test_background_operation_wait);
+	g_test_add_func("/core/background_operation/wait_all", test_background_operation_wait_all);
+	g_test_add_func("/core/background_operation/nested", test_background_operation_nested);
+	g_test_add_func("/core/background_operation/wait_own", test_background_operation_wait_own);
 }
@@ -22,6 +22,7 @@
 
 #include <julea.h>
 #include <julea-item.h>
+#include <julea-kv.h>
 
 #include "test.h"
 
@@ -138,6 +139,125 @@ test_batch_execute_async(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_batch_execute_auto(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) get_batch = NULL;
+	g_autoptr(GPtrArray) kvs = NULL;
+	g_autofree gpointer value = NULL;
+	guint32 value_len = 0;
+	guint64 handle;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	kvs = g_ptr_array_new_with_free_func((GDestroyNotify)j_kv_unref);
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	ret = j_batch_set_auto(batch, 4, 0, 0);
+	g_assert_true(ret);
+
+	for (guint i = 0; i < 10; i++)
+	{
+		g_autofree gchar* key = NULL;
+		JKV* kv;
+
+		key = g_strdup_printf("test-batch-auto-%u", i);
+		kv = j_kv_new("test", key);
+		g_ptr_array_add(kvs, kv);
+
+		j_kv_put(kv, g_strdup("value"), 6, g_free, batch);
+	}
+
+	// The first eight operations are executed automatically
+	handle = j_batch_get_handle(batch);
+	g_assert_cmpuint(handle, ==, 10);
+
+	ret = j_batch_wait_handle(batch, 8);
+	g_assert_true(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	get_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	j_kv_get(g_ptr_array_index(kvs, 9), &value, &value_len, get_batch);
+	ret = j_batch_execute(get_batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(value_len, ==, 6);
+	g_assert_cmpstr(value, ==, "value");
+
+	// Nothing has been added since the last execution
+	ret = j_batch_execute(batch);
+	g_assert_false(ret);
+
+	for (guint i = 0; i < kvs->len; i++)
+	{
+		j_kv_delete(g_ptr_array_index(kvs, i), batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_batch_execute_auto_failure(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JKV) kv = NULL;
+	g_autofree gpointer value = NULL;
+	guint32 value_len = 0;
+	guint64 handle;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	ret = j_batch_set_auto(batch, 1, 0, 0);
+	g_assert_true(ret);
+
+	kv = j_kv_new("test", "test-batch-auto-failure");
+
+	// Getting a key that does not exist fails
+	j_kv_get(kv, &value, &value_len, batch);
+	handle = j_batch_get_handle(batch);
+
+	ret = j_batch_wait_handle(batch, handle);
+	g_assert_false(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_false(ret);
+
+	// Failures are only reported until the next execution
+	j_kv_put(kv, g_strdup("value"), 6, g_free, batch);
+	handle = j_batch_get_handle(batch);
+
+	ret = j_batch_wait_handle(batch, handle);
+	g_assert_true(ret);
+
+	j_kv_delete(kv, batch);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_batch_execute_auto_semantics(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	semantics = j_semantics_new(J_SEMANTICS_TEMPLATE_DEFAULT);
+	j_semantics_set(semantics, J_SEMANTICS_CONSISTENCY, J_SEMANTICS_CONSISTENCY_EVENTUAL);
+
+	batch = j_batch_new(semantics);
+	ret = j_batch_set_auto(batch, 4, 0, 0);
+	g_assert_false(ret);
+	J_TEST_TRAP_END;
+}
+
 void
 test_core_batch(void)
 {
@@ -146,4 +266,7 @@ test_core_batch(void)
 	g_test_add_func("/core/batch/execute_empty", test_batch_execute_empty);
 	g_test_add_func("/core/batch/execute", test_batch_execute);
 	g_test_add_func("/core/batch/execute_async", test_batch_execute_async);
+	g_test_add_func("/core/batch/execute_auto", test_batch_execute_auto);
+	g_test_add_func("/core/batch/execute_auto_failure", test_batch_execute_auto_failure);
+	g_test_add_func("/core/batch/execute_auto_semantics", test_batch_execute_auto_semantics);
 }
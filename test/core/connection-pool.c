@@ -0,0 +1,149 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+static void
+test_connection_pool_reuse(void)
+{
+	gpointer connection;
+	guint64 hits;
+	guint64 connections;
+
+	J_TEST_TRAP_START;
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+	g_assert_nonnull(connection);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection);
+
+	hits = j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_HITS);
+	connections = j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS);
+	g_assert_cmpuint(connections, >=, 1);
+
+	// The idle connection is reused instead of establishing a new one
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+	g_assert_nonnull(connection);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection);
+
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_HITS), ==, hits + 1);
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS), ==, connections);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_connection_pool_broken(void)
+{
+	gpointer connection;
+	guint64 broken;
+	guint64 connections;
+
+	J_TEST_TRAP_START;
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+	g_assert_nonnull(connection);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection);
+
+	broken = j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_BROKEN);
+	connections = j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS);
+
+	// The pool still references the idle connection, which is checked before being reused
+	g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+	g_assert_nonnull(connection);
+	g_assert_false(g_io_stream_is_closed(G_IO_STREAM(connection)));
+
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_BROKEN), ==, broken + 1);
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS), ==, connections);
+
+	// Connections that break while being used are dropped when they are returned
+	g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection);
+
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_BROKEN), ==, broken + 2);
+	g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS), ==, connections - 1);
+
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+	g_assert_nonnull(connection);
+	j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_connection_pool_idle(void)
+{
+	JConfiguration* configuration = j_configuration();
+
+	// The subprocess does not inherit the test mode
+	if (!g_test_subprocess() && !g_test_slow())
+	{
+		g_test_skip("Waiting for the idle timeout takes too long for quick tests.");
+		return;
+	}
+
+	if (j_configuration_get_max_connections(configuration) < 2)
+	{
+		g_test_skip("Shrinking the pool requires at least two connections.");
+		return;
+	}
+
+	{
+		gpointer connection_idle;
+		gpointer connection_used;
+		guint64 closed;
+
+		J_TEST_TRAP_START;
+		connection_idle = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+		g_assert_nonnull(connection_idle);
+		connection_used = j_connection_pool_pop(J_BACKEND_TYPE_KV, 0);
+		g_assert_nonnull(connection_used);
+
+		closed = j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_IDLE_CLOSED);
+
+		j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection_idle);
+		g_usleep((j_configuration_get_idle_timeout(configuration) + 1) * G_USEC_PER_SEC);
+
+		// Returning a connection closes the ones that have been idle for too long, as long as there are more than the minimum
+		j_connection_pool_push(J_BACKEND_TYPE_KV, 0, connection_used);
+
+		if (j_configuration_get_min_connections(configuration) < 2)
+		{
+			g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_IDLE_CLOSED), >, closed);
+		}
+		else
+		{
+			g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_IDLE_CLOSED), ==, closed);
+		}
+
+		g_assert_cmpuint(j_connection_pool_get_statistics(J_BACKEND_TYPE_KV, 0, J_CONNECTION_POOL_CONNECTIONS), >=, j_configuration_get_min_connections(configuration));
+		J_TEST_TRAP_END;
+	}
+}
+
+void
+test_core_connection_pool(void)
+{
+	g_test_add_func("/core/connection-pool/reuse", test_connection_pool_reuse);
+	g_test_add_func("/core/connection-pool/broken", test_connection_pool_broken);
+	g_test_add_func("/core/connection-pool/idle", test_connection_pool_idle);
+}
@@ -176,6 +176,546 @@ test_message_write_read(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_message_write_read_send(void)
+{
+	g_autoptr(JMessage) message_recv = NULL;
+	g_autoptr(JMessage) message_send = NULL;
+	g_autoptr(GOutputStream) output = NULL;
+	g_autoptr(GInputStream) input = NULL;
+	g_autofree gchar* data = NULL;
+	g_autofree gchar* data_recv = NULL;
+	// more buffers than can be passed to a single system call
+	guint const count = 2000;
+	gsize bytes_read;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	output = g_memory_output_stream_new(NULL, 0, g_realloc, g_free);
+	input = g_memory_input_stream_new();
+
+	data = g_malloc(count * 3);
+	data_recv = g_malloc(count * 3);
+
+	for (guint i = 0; i < count * 3; i++)
+	{
+		data[i] = i % 127;
+	}
+
+	message_send = j_message_new(J_MESSAGE_NONE, 0);
+	g_assert_true(message_send != NULL);
+	message_recv = j_message_new(J_MESSAGE_NONE, 0);
+	g_assert_true(message_recv != NULL);
+
+	for (guint i = 0; i < count; i++)
+	{
+		guint64 length = 3;
+
+		j_message_add_operation(message_send, sizeof(guint64));
+		ret = j_message_append_8(message_send, &length);
+		g_assert_true(ret);
+		j_message_add_send(message_send, data + (i * 3), length);
+	}
+
+	ret = j_message_write(message_send, output);
+	g_assert_true(ret);
+
+	g_memory_input_stream_add_data(
+		G_MEMORY_INPUT_STREAM(input),
+		g_memory_output_stream_get_data(G_MEMORY_OUTPUT_STREAM(output)),
+		g_memory_output_stream_get_data_size(G_MEMORY_OUTPUT_STREAM(output)),
+		NULL);
+
+	ret = j_message_read(message_recv, input);
+	g_assert_true(ret);
+	g_assert_cmpuint(j_message_get_count(message_recv), ==, count);
+
+	for (guint i = 0; i < count; i++)
+	{
+		g_assert_cmpuint(j_message_get_8(message_recv), ==, 3);
+	}
+
+	ret = g_input_stream_read_all(input, data_recv, count * 3, &bytes_read, NULL, NULL);
+	g_assert_true(ret);
+	g_assert_cmpuint(bytes_read, ==, count * 3);
+	g_assert_cmpmem(data, count * 3, data_recv, count * 3);
+	J_TEST_TRAP_END;
+}
+
+struct TestMessagePeer
+{
+	GSocketConnection* connection;
+	JMessage* message;
+	gchar* data;
+	guint64 length;
+	guint64 segment_size;
+};
+
+typedef struct TestMessagePeer TestMessagePeer;
+
+/**
+ * Connects two sockets using the loopback device.
+ *
+ * \param listener        Returns the listener, which has to be kept alive.
+ * \param connection_send Returns the sending side.
+ * \param connection_recv Returns the receiving side.
+ **/
+static void
+test_message_connect(GSocketListener** listener, GSocketConnection** connection_send, GSocketConnection** connection_recv)
+{
+	g_autoptr(GSocketClient) client = NULL;
+	guint16 port;
+
+	*listener = g_socket_listener_new();
+	port = g_socket_listener_add_any_inet_port(*listener, NULL, NULL);
+	g_assert_cmpuint(port, >, 0);
+
+	client = g_socket_client_new();
+	*connection_send = g_socket_client_connect_to_host(client, "127.0.0.1", port, NULL, NULL);
+	g_assert_true(*connection_send != NULL);
+	*connection_recv = g_socket_listener_accept(*listener, NULL, NULL, NULL);
+	g_assert_true(*connection_recv != NULL);
+}
+
+static gpointer
+test_message_send_zerocopy_receive(gpointer data)
+{
+	TestMessagePeer* peer = data;
+	gsize bytes_read = 0;
+
+	if (!j_message_receive(peer->message, peer->connection))
+	{
+		return GINT_TO_POINTER(FALSE);
+	}
+
+	if (!g_input_stream_read_all(g_io_stream_get_input_stream(G_IO_STREAM(peer->connection)), peer->data, peer->length, &bytes_read, NULL, NULL))
+	{
+		return GINT_TO_POINTER(FALSE);
+	}
+
+	return GINT_TO_POINTER(bytes_read == peer->length);
+}
+
+static void
+test_message_send_zerocopy(void)
+{
+	g_autoptr(GSocketListener) listener = NULL;
+	g_autoptr(GSocketConnection) connection_send = NULL;
+	g_autoptr(GSocketConnection) connection_recv = NULL;
+	g_autoptr(JMessage) message_recv = NULL;
+	g_autoptr(JMessage) message_send = NULL;
+	g_autofree gchar* data = NULL;
+	g_autofree gchar* data_recv = NULL;
+	TestMessagePeer peer;
+	GThread* thread;
+	// larger than the socket buffers, so sending has to wait for the receiver
+	guint64 const length = 16 * 1024 * 1024;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_message_connect(&listener, &connection_send, &connection_recv);
+
+	// falls back to regular transmission if zero-copy is not supported
+	j_message_set_zerocopy_size(connection_send, 1);
+
+	data = g_malloc(length);
+	data_recv = g_malloc(length);
+
+	for (guint64 i = 0; i < length; i++)
+	{
+		data[i] = i % 127;
+	}
+
+	message_send = j_message_new(J_MESSAGE_NONE, 0);
+	g_assert_true(message_send != NULL);
+	message_recv = j_message_new(J_MESSAGE_NONE, 0);
+	g_assert_true(message_recv != NULL);
+
+	j_message_add_operation(message_send, sizeof(guint64));
+	ret = j_message_append_8(message_send, &length);
+	g_assert_true(ret);
+	j_message_add_send(message_send, data, length);
+
+	peer.connection = connection_recv;
+	peer.message = message_recv;
+	peer.data = data_recv;
+	peer.length = length;
+	peer.segment_size = 0;
+
+	thread = g_thread_new("zerocopy", test_message_send_zerocopy_receive, &peer);
+
+	ret = j_message_send(message_send, connection_send);
+	g_assert_true(ret);
+
+	ret = GPOINTER_TO_INT(g_thread_join(thread));
+	g_assert_true(ret);
+
+	g_assert_cmpuint(j_message_get_count(message_recv), ==, 1);
+	g_assert_cmpuint(j_message_get_8(message_recv), ==, length);
+	g_assert_cmpmem(data, length, data_recv, length);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_message_header_v2(void)
+{
+	g_autoptr(GSocketListener) listener = NULL;
+	g_autoptr(GSocketConnection) connection_send = NULL;
+	g_autoptr(GSocketConnection) connection_recv = NULL;
+	g_autoptr(JMessage) message_recv = NULL;
+	g_autoptr(JMessage) message_send = NULL;
+	GInputStream* input;
+	// the extended header without the trace context, followed by the data
+	gchar raw[24 + sizeof(guint64)];
+	guint64 const value = 42;
+	guint64 length;
+	guint32 op_type;
+	guint32 op_count;
+	gsize bytes_read;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_message_connect(&listener, &connection_send, &connection_recv);
+
+	j_message_set_version(connection_send, 2);
+	j_message_set_version(connection_recv, 2);
+
+	input = g_io_stream_get_input_stream(G_IO_STREAM(connection_recv));
+
+	message_send = j_message_new(J_MESSAGE_OBJECT_READ, sizeof(guint64));
+	g_assert_true(message_send != NULL);
+	j_message_add_operation(message_send, sizeof(guint64));
+	ret = j_message_append_8(message_send, &value);
+	g_assert_true(ret);
+
+	ret = j_message_send(message_send, connection_send);
+	g_assert_true(ret);
+
+	ret = g_input_stream_read_all(input, raw, sizeof(raw), &bytes_read, NULL, NULL);
+	g_assert_true(ret);
+	g_assert_cmpuint(bytes_read, ==, sizeof(raw));
+
+	// length (8 bytes), ID, semantics, operation type and operation count (4 bytes each)
+	memcpy(&length, raw, sizeof(guint64));
+	memcpy(&op_type, raw + 16, sizeof(guint32));
+	memcpy(&op_count, raw + 20, sizeof(guint32));
+
+	g_assert_cmpuint(GUINT64_FROM_LE(length), ==, sizeof(guint64));
+	g_assert_cmpuint(GUINT32_FROM_LE(op_type), ==, J_MESSAGE_OBJECT_READ);
+	g_assert_cmpuint(GUINT32_FROM_LE(op_count), ==, 1);
+
+	memcpy(&length, raw + 24, sizeof(guint64));
+	g_assert_cmpuint(GUINT64_FROM_LE(length), ==, value);
+
+	// the same message has to survive a round trip
+	ret = j_message_send(message_send, connection_send);
+	g_assert_true(ret);
+
+	message_recv = j_message_new(J_MESSAGE_NONE, 0);
+	g_assert_true(message_recv != NULL);
+	ret = j_message_receive(message_recv, connection_recv);
+	g_assert_true(ret);
+
+	g_assert_true(j_message_get_type(message_recv) == J_MESSAGE_OBJECT_READ);
+	g_assert_cmpuint(j_message_get_count(message_recv), ==, 1);
+	g_assert_cmpuint(j_message_get_8(message_recv), ==, value);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_message_v1_too_long(void)
+{
+	if (sizeof(gsize) <= sizeof(guint32))
+	{
+		g_test_skip("Messages larger than 4 GiB require a 64-bit system.");
+		return;
+	}
+
+	// the subprocess does not inherit the test mode
+	if (!g_test_subprocess() && !g_test_slow())
+	{
+		g_test_skip("Messages larger than 4 GiB require too much memory for quick tests.");
+		return;
+	}
+
+	{
+		g_autoptr(GOutputStream) output = NULL;
+		g_autoptr(JMessage) message = NULL;
+		g_autofree gchar* data = NULL;
+		guint64 const length = (guint64)G_MAXUINT32 + 1;
+		gboolean ret;
+
+		J_TEST_TRAP_START;
+		output = g_memory_output_stream_new(NULL, 0, g_realloc, g_free);
+
+		data = g_malloc0(length);
+
+		message = j_message_new(J_MESSAGE_NONE, 0);
+		g_assert_true(message != NULL);
+		j_message_add_operation(message, length);
+		ret = j_message_append_n(message, data, length);
+		g_assert_true(ret);
+
+		// streams always use protocol version 1, whose header cannot carry the length
+		g_test_expect_message("JULEA", G_LOG_LEVEL_CRITICAL, "*requires protocol version 2*");
+		ret = j_message_write(message, output);
+		g_test_assert_expected_messages();
+
+		g_assert_false(ret);
+		g_assert_cmpuint(g_memory_output_stream_get_data_size(G_MEMORY_OUTPUT_STREAM(output)), ==, 0);
+		J_TEST_TRAP_END;
+	}
+}
+
+/**
+ * Answers an object write and an object read like a server using protocol version 1.
+ * Such servers only handle operations of up to one memory chunk.
+ **/
+static gpointer
+test_message_segments_v1_peer(gpointer data)
+{
+	TestMessagePeer* peer = data;
+	GInputStream* input;
+
+	input = g_io_stream_get_input_stream(G_IO_STREAM(peer->connection));
+
+	for (guint m = 0; m < 2; m++)
+	{
+		g_autoptr(JMessage) message = NULL;
+		g_autoptr(JMessage) reply = NULL;
+		JMessageType type;
+		guint32 count;
+
+		message = j_message_new(J_MESSAGE_NONE, 0);
+
+		if (!j_message_receive(message, peer->connection))
+		{
+			return GINT_TO_POINTER(FALSE);
+		}
+
+		type = j_message_get_type(message);
+		count = j_message_get_count(message);
+		reply = j_message_new_reply(message);
+
+		for (guint32 i = 0; i < count; i++)
+		{
+			guint64 length;
+			guint64 offset;
+
+			length = j_message_get_8(message);
+			offset = j_message_get_8(message);
+
+			if (length > peer->segment_size || offset + length > peer->length)
+			{
+				return GINT_TO_POINTER(FALSE);
+			}
+
+			if (type == J_MESSAGE_OBJECT_WRITE && !g_input_stream_read_all(input, peer->data + offset, length, NULL, NULL, NULL))
+			{
+				return GINT_TO_POINTER(FALSE);
+			}
+
+			j_message_add_operation(reply, sizeof(guint64));
+			j_message_append_8(reply, &length);
+
+			if (type == J_MESSAGE_OBJECT_READ)
+			{
+				j_message_add_send(reply, peer->data + offset, length);
+			}
+		}
+
+		if (!j_message_send(reply, peer->connection))
+		{
+			return GINT_TO_POINTER(FALSE);
+		}
+	}
+
+	return GINT_TO_POINTER(TRUE);
+}
+
+static void
+test_message_segments_v1(void)
+{
+	g_autoptr(GSocketListener) listener = NULL;
+	g_autoptr(GSocketConnection) connection_send = NULL;
+	g_autoptr(GSocketConnection) connection_recv = NULL;
+	g_autoptr(JMessage) message_read = NULL;
+	g_autoptr(JMessage) message_write = NULL;
+	g_autoptr(JMessage) reply_read = NULL;
+	g_autoptr(JMessage) reply_write = NULL;
+	g_autofree gchar* data = NULL;
+	g_autofree gchar* data_peer = NULL;
+	g_autofree gchar* data_read = NULL;
+	GInputStream* input;
+	TestMessagePeer peer;
+	GThread* thread;
+	guint64 const segment_size = 1024 * 1024;
+	// not a multiple of the segment size
+	guint64 const length = 4 * segment_size + 1;
+	guint64 nbytes;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_message_connect(&listener, &connection_send, &connection_recv);
+
+	// neither side negotiates a version, as is the case for old servers
+	g_assert_cmpuint(j_message_get_version(connection_send), ==, 1);
+
+	input = g_io_stream_get_input_stream(G_IO_STREAM(connection_send));
+
+	data = g_malloc(length);
+	data_peer = g_malloc0(length);
+	data_read = g_malloc0(length);
+
+	for (guint64 i = 0; i < length; i++)
+	{
+		data[i] = i % 127;
+	}
+
+	peer.connection = connection_recv;
+	peer.message = NULL;
+	peer.data = data_peer;
+	peer.length = length;
+	peer.segment_size = segment_size;
+
+	thread = g_thread_new("v1-peer", test_message_segments_v1_peer, &peer);
+
+	// split the operations like clients do for servers using protocol version 1
+	message_write = j_message_new(J_MESSAGE_OBJECT_WRITE, 0);
+	message_read = j_message_new(J_MESSAGE_OBJECT_READ, 0);
+
+	for (guint64 done = 0; done < length;)
+	{
+		guint64 segment;
+
+		segment = MIN(length - done, segment_size);
+
+		j_message_add_operation(message_write, sizeof(guint64) + sizeof(guint64));
+		j_message_append_8(message_write, &segment);
+		j_message_append_8(message_write, &done);
+		j_message_add_send(message_write, data + done, segment);
+
+		j_message_add_operation(message_read, sizeof(guint64) + sizeof(guint64));
+		j_message_append_8(message_read, &segment);
+		j_message_append_8(message_read, &done);
+
+		done += segment;
+	}
+
+	g_assert_cmpuint(j_message_get_count(message_write), ==, 5);
+
+	ret = j_message_send(message_write, connection_send);
+	g_assert_true(ret);
+
+	reply_write = j_message_new_reply(message_write);
+	ret = j_message_receive(reply_write, connection_send);
+	g_assert_true(ret);
+	g_assert_cmpuint(j_message_get_count(reply_write), ==, 5);
+
+	nbytes = 0;
+
+	for (guint i = 0; i < 5; i++)
+	{
+		nbytes += j_message_get_8(reply_write);
+	}
+
+	g_assert_cmpuint(nbytes, ==, length);
+
+	ret = j_message_send(message_read, connection_send);
+	g_assert_true(ret);
+
+	reply_read = j_message_new_reply(message_read);
+	ret = j_message_receive(reply_read, connection_send);
+	g_assert_true(ret);
+	g_assert_cmpuint(j_message_get_count(reply_read), ==, 5);
+
+	nbytes = 0;
+
+	for (guint i = 0; i < 5; i++)
+	{
+		guint64 segment;
+
+		segment = j_message_get_8(reply_read);
+		ret = g_input_stream_read_all(input, data_read + nbytes, segment, NULL, NULL, NULL);
+		g_assert_true(ret);
+
+		nbytes += segment;
+	}
+
+	g_assert_cmpuint(nbytes, ==, length);
+
+	ret = GPOINTER_TO_INT(g_thread_join(thread));
+	g_assert_true(ret);
+
+	g_assert_cmpmem(data, length, data_peer, length);
+	g_assert_cmpmem(data, length, data_read, length);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_message_reserve(void)
+{
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	// messages and their buffers are recycled, make sure reused ones behave like new ones
+	for (guint i = 0; i < 100; i++)
+	{
+		g_autoptr(JMessage) message = NULL;
+		g_autoptr(JMessage) reply = NULL;
+
+		message = j_message_new(J_MESSAGE_NONE, 0);
+		g_assert_true(message != NULL);
+
+		j_message_reserve(message, 1024 * sizeof(guint32));
+
+		for (guint32 j = 0; j < 1024; j++)
+		{
+			ret = j_message_append_4(message, &j);
+			g_assert_true(ret);
+		}
+
+		reply = j_message_new_reply(message);
+		g_assert_true(reply != NULL);
+		g_assert_cmpuint(j_message_get_count(reply), ==, 0);
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_message_version(void)
+{
+	g_autoptr(GInputStream) connection = NULL;
+
+	J_TEST_TRAP_START;
+	// any object can carry the version
+	connection = g_memory_input_stream_new();
+
+	g_assert_cmpuint(j_message_get_version(connection), ==, 1);
+
+	j_message_set_version(connection, J_MESSAGE_VERSION);
+	g_assert_cmpuint(j_message_get_version(connection), ==, J_MESSAGE_VERSION);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_message_trace(void)
+{
+	g_autoptr(JMessage) message = NULL;
+	g_autoptr(JMessage) reply = NULL;
+
+	J_TEST_TRAP_START;
+	// spans are only created when sending
+	message = j_message_new(J_MESSAGE_OBJECT_READ, 0);
+	g_assert_cmpuint(j_message_get_trace_id(message), ==, j_trace_get_correlation());
+	g_assert_cmpuint(j_message_get_span_id(message), ==, 0);
+
+	reply = j_message_new_reply(message);
+	g_assert_cmpuint(j_message_get_trace_id(reply), ==, j_message_get_trace_id(message));
+	g_assert_cmpuint(j_message_get_span_id(reply), ==, j_message_get_span_id(message));
+	J_TEST_TRAP_END;
+}
+
 static void
 test_message_semantics(void)
 {
@@ -208,5 +748,13 @@ test_core_message(void)
 	g_test_add_func("/core/message/header", test_message_header);
 	g_test_add_func("/core/message/append", test_message_append);
 	g_test_add_func("/core/message/write_read", test_message_write_read);
+	g_test_add_func("/core/message/write_read_send", test_message_write_read_send);
+	g_test_add_func("/core/message/send_zerocopy", test_message_send_zerocopy);
+	g_test_add_func("/core/message/reserve", test_message_reserve);
+	g_test_add_func("/core/message/version", test_message_version);
+	g_test_add_func("/core/message/header_v2", test_message_header_v2);
+	g_test_add_func("/core/message/v1_too_long", test_message_v1_too_long);
+	g_test_add_func("/core/message/segments_v1", test_message_segments_v1);
+	g_test_add_func("/core/message/trace", test_message_trace);
 	g_test_add_func("/core/message/semantics", test_message_semantics);
 }
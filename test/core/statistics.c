@@ -0,0 +1,157 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <julea.h>
+
+#include <jmessage.h>
+#include <jstatistics.h>
+
+#include "test.h"
+
+static void
+test_statistics_bucket_bound(void)
+{
+	guint64 previous = 0;
+
+	J_TEST_TRAP_START;
+	g_assert_cmpuint(j_statistics_get_latency_bucket_bound(0), ==, 1);
+
+	for (guint i = 0; i < J_STATISTICS_LATENCY_BUCKETS; i++)
+	{
+		guint64 bound;
+
+		bound = j_statistics_get_latency_bucket_bound(i);
+		g_assert_cmpuint(bound, >, previous);
+		previous = bound;
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_statistics_operation(void)
+{
+	JStatistics* statistics;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+
+	g_assert_cmpuint(j_statistics_get_operations(statistics, J_MESSAGE_KV_PUT), ==, 0);
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_SERVER, 50.0), ==, 0);
+
+	for (guint i = 0; i < 99; i++)
+	{
+		j_statistics_add_operation(statistics, J_MESSAGE_KV_PUT, 10, 3, 100);
+	}
+
+	j_statistics_add_operation(statistics, J_MESSAGE_KV_PUT, 10, 1000, 100);
+
+	g_assert_cmpuint(j_statistics_get_operations(statistics, J_MESSAGE_KV_PUT), ==, 100);
+	g_assert_cmpuint(j_statistics_get_operations(statistics, J_MESSAGE_KV_GET), ==, 0);
+	g_assert_cmpuint(j_statistics_get_operation_bytes(statistics, J_MESSAGE_KV_PUT), ==, 1000);
+	g_assert_cmpuint(j_statistics_get_latency_sum(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_SERVER), ==, 99 * 3 + 1000);
+	g_assert_cmpuint(j_statistics_get_latency_sum(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_BACKEND), ==, 100 * 100);
+
+	// percentiles are accurate to a quarter of a power of two
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_SERVER, 50.0), ==, 4);
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_SERVER, 100.0), >, 1000);
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_SERVER, 100.0), <=, 1250);
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_BACKEND, 99.0), >, 100);
+	g_assert_cmpuint(j_statistics_get_latency_percentile(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_LATENCY_BACKEND, 99.0), <=, 125);
+
+	j_statistics_free(statistics);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_statistics_merge_serialize(void)
+{
+	JStatistics* statistics;
+	JStatistics* statistics_merged;
+	JStatistics* statistics_recv;
+	g_autoptr(JMessage) message_send = NULL;
+	g_autoptr(JMessage) message_recv = NULL;
+	g_autoptr(GOutputStream) output = NULL;
+	g_autoptr(GInputStream) input = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+	statistics_merged = j_statistics_new(FALSE);
+	statistics_recv = j_statistics_new(FALSE);
+
+	j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, 42);
+	j_statistics_add_operation(statistics, J_MESSAGE_OBJECT_READ, 4096, 20, 300);
+	j_statistics_add_operation(statistics, J_MESSAGE_DB_QUERY, 128, 50, 7000);
+
+	j_statistics_merge(statistics_merged, statistics);
+	j_statistics_merge(statistics_merged, statistics);
+
+	g_assert_cmpuint(j_statistics_get(statistics_merged, J_STATISTICS_BYTES_SENT), ==, 84);
+	g_assert_cmpuint(j_statistics_get_operations(statistics_merged, J_MESSAGE_OBJECT_READ), ==, 2);
+	g_assert_cmpuint(j_statistics_get_operation_bytes(statistics_merged, J_MESSAGE_DB_QUERY), ==, 256);
+
+	output = g_memory_output_stream_new(NULL, 0, g_realloc, g_free);
+	input = g_memory_input_stream_new();
+
+	message_send = j_message_new(J_MESSAGE_STATISTICS, 0);
+	message_recv = j_message_new(J_MESSAGE_NONE, 0);
+
+	j_statistics_serialize_operations(statistics_merged, message_send);
+	g_assert_cmpuint(j_message_get_count(message_send), ==, 1);
+
+	ret = j_message_write(message_send, output);
+	g_assert_true(ret);
+
+	g_memory_input_stream_add_data(
+		G_MEMORY_INPUT_STREAM(input),
+		g_memory_output_stream_get_data(G_MEMORY_OUTPUT_STREAM(output)),
+		g_memory_output_stream_get_data_size(G_MEMORY_OUTPUT_STREAM(output)),
+		NULL);
+
+	ret = j_message_read(message_recv, input);
+	g_assert_true(ret);
+
+	j_statistics_deserialize_operations(statistics_recv, message_recv);
+
+	g_assert_cmpuint(j_statistics_get_operations(statistics_recv, J_MESSAGE_OBJECT_READ), ==, 2);
+	g_assert_cmpuint(j_statistics_get_operations(statistics_recv, J_MESSAGE_DB_QUERY), ==, 2);
+	g_assert_cmpuint(j_statistics_get_operations(statistics_recv, J_MESSAGE_KV_GET), ==, 0);
+	g_assert_cmpuint(j_statistics_get_operation_bytes(statistics_recv, J_MESSAGE_OBJECT_READ), ==, 8192);
+	g_assert_cmpuint(j_statistics_get_latency_sum(statistics_recv, J_MESSAGE_DB_QUERY, J_STATISTICS_LATENCY_BACKEND), ==, 14000);
+
+	for (guint i = 0; i < J_STATISTICS_LATENCY_BUCKETS; i++)
+	{
+		g_assert_cmpuint(j_statistics_get_latency_bucket(statistics_recv, J_MESSAGE_OBJECT_READ, J_STATISTICS_LATENCY_SERVER, i), ==, j_statistics_get_latency_bucket(statistics_merged, J_MESSAGE_OBJECT_READ, J_STATISTICS_LATENCY_SERVER, i));
+	}
+
+	j_statistics_free(statistics);
+	j_statistics_free(statistics_merged);
+	j_statistics_free(statistics_recv);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_statistics(void)
+{
+	g_test_add_func("/core/statistics/bucket_bound", test_statistics_bucket_bound);
+	g_test_add_func("/core/statistics/operation", test_statistics_operation);
+	g_test_add_func("/core/statistics/merge_serialize", test_statistics_merge_serialize);
+}
@@ -0,0 +1,214 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <string.h>
+#include <unistd.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+/**
+ * Restarts tracing with binary tracing enabled.
+ *
+ * \return The trace directory, to be passed to test_trace_binary_stop().
+ **/
+static gchar*
+test_trace_binary_start(void)
+{
+	gchar* directory;
+
+	directory = g_dir_make_tmp("julea-trace-XXXXXX", NULL);
+	g_assert_true(directory != NULL);
+
+	// tracing has already been initialized using the environment of the test
+	j_trace_fini();
+
+	g_setenv("JULEA_TRACE", "binary", TRUE);
+	g_setenv("JULEA_TRACE_DIRECTORY", directory, TRUE);
+	g_unsetenv("JULEA_TRACE_FUNCTION");
+
+	j_trace_init("test-trace");
+
+	return directory;
+}
+
+/**
+ * Stops tracing and returns the trace file's lines.
+ *
+ * \param directory The trace directory.
+ *
+ * \return The lines, to be freed with g_strfreev().
+ **/
+static gchar**
+test_trace_binary_stop(gchar* directory)
+{
+	g_autofree gchar* contents = NULL;
+	g_autofree gchar* file_name = NULL;
+	g_autofree gchar* path = NULL;
+	gchar** lines;
+	gboolean ret;
+
+	j_trace_fini();
+
+	file_name = g_strdup_printf("test-trace-%d.json", (gint)getpid());
+	path = g_build_filename(directory, file_name, NULL);
+
+	ret = g_file_get_contents(path, &contents, NULL, NULL);
+	g_assert_true(ret);
+
+	g_remove(path);
+	g_rmdir(directory);
+	g_free(directory);
+
+	// the file is a JSON array with one event per line
+	g_assert_true(g_str_has_prefix(contents, "[\n"));
+	g_assert_true(g_str_has_suffix(contents, "\n]\n"));
+
+	lines = g_strsplit(contents, "\n", 0);
+
+	for (guint i = 1; lines[i + 2] != NULL; i++)
+	{
+		g_assert_true(g_str_has_prefix(lines[i], "{"));
+		g_assert_true(g_str_has_suffix(lines[i], (lines[i + 3] != NULL) ? "}," : "}"));
+	}
+
+	return lines;
+}
+
+/**
+ * Returns the first line containing all of the given strings.
+ *
+ * \param lines The lines.
+ * \param ...   Strings, terminated by NULL.
+ *
+ * \return The line, NULL if none matches.
+ **/
+static gchar const*
+test_trace_find(gchar** lines, ...)
+{
+	for (guint i = 0; lines[i] != NULL; i++)
+	{
+		gboolean found = TRUE;
+		gchar const* str;
+		va_list args;
+
+		va_start(args, lines);
+
+		while (found && (str = va_arg(args, gchar const*)) != NULL)
+		{
+			found = (strstr(lines[i], str) != NULL);
+		}
+
+		va_end(args);
+
+		if (found)
+		{
+			return lines[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void
+test_trace_binary_events(void)
+{
+	g_auto(GStrv) lines = NULL;
+	gchar* directory;
+	JTrace* trace;
+
+	J_TEST_TRAP_START;
+	directory = test_trace_binary_start();
+
+	j_trace_set_correlation(0x2a);
+
+	trace = j_trace_enter("test-function", NULL);
+	j_trace_counter("test-counter", 42);
+	j_trace_flow("test-flow", J_TRACE_FLOW_BEGIN, 1);
+	j_trace_leave(trace);
+
+	lines = test_trace_binary_stop(directory);
+
+	g_assert_nonnull(test_trace_find(lines, "\"name\":\"process_name\",\"ph\":\"M\"", "\"args\":{\"name\":\"test-trace\"}", NULL));
+	g_assert_nonnull(test_trace_find(lines, "\"name\":\"thread_name\",\"ph\":\"M\"", NULL));
+	g_assert_nonnull(test_trace_find(lines, "\"name\":\"test-function\",\"ph\":\"B\"", "\"correlation\":\"000000000000002a\"", NULL));
+	g_assert_nonnull(test_trace_find(lines, "\"ph\":\"E\"", NULL));
+	g_assert_nonnull(test_trace_find(lines, "\"name\":\"test-counter\",\"ph\":\"C\"", "\"args\":{\"value\":42}", NULL));
+	g_assert_nonnull(test_trace_find(lines, "\"name\":\"test-flow\",\"ph\":\"s\"", "\"id\":\"0000000000000001\"", NULL));
+	J_TEST_TRAP_END;
+}
+
+static void
+test_trace_binary_dropped(void)
+{
+	g_auto(GStrv) lines = NULL;
+	g_autofree gchar* tid = NULL;
+	gchar const* line;
+	gchar* directory;
+	// the ring buffers hold 65536 events, so events are dropped unless the flush thread keeps up
+	guint64 const count = 4 * 65536;
+	guint64 recorded = 0;
+	guint64 dropped = 0;
+
+	J_TEST_TRAP_START;
+	directory = test_trace_binary_start();
+
+	for (guint64 i = 0; i < count; i++)
+	{
+		j_trace_counter("test-dropped", i);
+	}
+
+	lines = test_trace_binary_stop(directory);
+
+	line = test_trace_find(lines, "\"name\":\"test-dropped\"", NULL);
+	g_assert_nonnull(line);
+
+	line = strstr(line, "\"tid\":");
+	tid = g_strdup_printf("\"tid\":%" G_GUINT64_FORMAT ",", g_ascii_strtoull(line + strlen("\"tid\":"), NULL, 10));
+
+	for (guint i = 0; lines[i] != NULL; i++)
+	{
+		if (strstr(lines[i], "\"name\":\"test-dropped\"") != NULL)
+		{
+			recorded++;
+		}
+		else if (strstr(lines[i], "\"name\":\"dropped_events\"") != NULL && strstr(lines[i], tid) != NULL)
+		{
+			// the counter is cumulative
+			line = strstr(lines[i], "\"value\":");
+			dropped = g_ascii_strtoull(line + strlen("\"value\":"), NULL, 10);
+		}
+	}
+
+	g_assert_cmpuint(recorded, >, 0);
+	g_assert_cmpuint(recorded + dropped, ==, count);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_trace(void)
+{
+	g_test_add_func("/core/trace/binary_events", test_trace_binary_events);
+	g_test_add_func("/core/trace/binary_dropped", test_trace_binary_dropped);
+}
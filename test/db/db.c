@@ -415,6 +415,287 @@ iterator_get(void)
 	g_assert_cmpuint(entries, ==, 1);
 }
 
+static void
+selector_explain(void)
+{
+	g_autoptr(GError) error = NULL;
+
+	gboolean success = TRUE;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	g_autofree gchar* plan = NULL;
+
+	gchar const* file = "demo.bp";
+	gdouble min_low = 1.0;
+	gdouble min_high = 2.0;
+
+	schema = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+	success = j_db_schema_get(schema, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+	success = j_db_selector_add_field(selector, "min", J_DB_SELECTOR_OPERATOR_GE, &min_low, 0, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_db_selector_add_field(selector, "min", J_DB_SELECTOR_OPERATOR_GE, &min_high, 0, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_db_selector_add_field(selector, "file", J_DB_SELECTOR_OPERATOR_EQ, file, strlen(file), &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+
+	success = j_db_selector_explain(selector, &plan, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	g_assert_nonnull(plan);
+	// the index on "file" is preferred over the one on "min" because of the equality predicate
+	g_assert_nonnull(strstr(plan, "USING INDEX adios2_variables_0"));
+	g_assert_nonnull(strstr(plan, "1 range predicate(s) merged"));
+}
+
+static void
+selector_aggregate(void)
+{
+	g_autoptr(GError) error = NULL;
+
+	gboolean success = TRUE;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	g_autoptr(JDBSelector) selector_max = NULL;
+	g_autoptr(JDBIterator) iterator = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	JDBType type;
+	guint64 len;
+	guint groups = 0;
+
+	schema = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+	success = j_db_schema_get(schema, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+	success = j_db_selector_set_aggregate(selector, J_DB_AGGREGATE_COUNT, NULL, "file", &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	while (j_db_iterator_next(iterator, NULL))
+	{
+		g_autofree guint64* count = NULL;
+		g_autofree gchar* file = NULL;
+
+		success = j_db_iterator_get_aggregate(iterator, &type, (gpointer*)&count, &len, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		g_assert_cmpint(type, ==, J_DB_TYPE_UINT64);
+		g_assert_cmpuint(*count, ==, 1);
+		success = j_db_iterator_get_field(iterator, NULL, "file", &type, (gpointer*)&file, &len, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		g_assert_cmpstr(file, ==, "demo.bp");
+
+		groups++;
+	}
+
+	g_assert_cmpuint(groups, ==, 1);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	selector_max = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector_max);
+	g_assert_no_error(error);
+	success = j_db_selector_set_aggregate(selector_max, J_DB_AGGREGATE_MAX, "max", NULL, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, selector_max, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	success = j_db_iterator_next(iterator, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+
+	{
+		g_autofree gdouble* max = NULL;
+
+		success = j_db_iterator_get_aggregate(iterator, &type, (gpointer*)&max, &len, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		g_assert_cmpint(type, ==, J_DB_TYPE_FLOAT64);
+		g_assert_cmpfloat(*max, ==, 42.0);
+	}
+
+	// SUM is only defined for numeric fields
+	success = j_db_selector_set_aggregate(selector_max, J_DB_AGGREGATE_SUM, "name", NULL, &error);
+	g_assert_false(success);
+	g_assert_error(error, J_DB_ERROR, J_DB_ERROR_TYPE_INVALID);
+	g_clear_error(&error);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	// Nothing matches, so there is no maximum
+	{
+		g_autoptr(JDBSelector) selector_empty = NULL;
+		gchar const* file = "missing.bp";
+
+		selector_empty = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+		g_assert_nonnull(selector_empty);
+		g_assert_no_error(error);
+		success = j_db_selector_add_field(selector_empty, "file", J_DB_SELECTOR_OPERATOR_EQ, file, strlen(file), &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		success = j_db_selector_set_aggregate(selector_empty, J_DB_AGGREGATE_MAX, "max", NULL, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+
+		iterator = j_db_iterator_new(schema, selector_empty, &error);
+		g_assert_nonnull(iterator);
+		g_assert_no_error(error);
+
+		success = j_db_iterator_next(iterator, NULL);
+		g_assert_false(success);
+		g_clear_pointer(&iterator, j_db_iterator_unref);
+	}
+
+	// Counting still returns a result
+	{
+		g_autoptr(JDBSelector) selector_empty = NULL;
+		g_autofree guint64* count = NULL;
+		gchar const* file = "missing.bp";
+
+		selector_empty = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+		g_assert_nonnull(selector_empty);
+		g_assert_no_error(error);
+		success = j_db_selector_add_field(selector_empty, "file", J_DB_SELECTOR_OPERATOR_EQ, file, strlen(file), &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		success = j_db_selector_set_aggregate(selector_empty, J_DB_AGGREGATE_COUNT, NULL, NULL, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+
+		iterator = j_db_iterator_new(schema, selector_empty, &error);
+		g_assert_nonnull(iterator);
+		g_assert_no_error(error);
+
+		success = j_db_iterator_next(iterator, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+
+		success = j_db_iterator_get_aggregate(iterator, &type, (gpointer*)&count, &len, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		g_assert_cmpuint(*count, ==, 0);
+	}
+}
+
+static void
+selector_prepared(void)
+{
+	g_autoptr(GError) error = NULL;
+
+	gboolean success = TRUE;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	gchar const* files[] = { "demo.bp", "other.bp", "demo.bp" };
+	gdouble min = 0.0;
+
+	schema = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+	success = j_db_schema_get(schema, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+	success = j_db_selector_add_parameter(selector, "file", J_DB_SELECTOR_OPERATOR_EQ, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_db_selector_add_field(selector, "min", J_DB_SELECTOR_OPERATOR_GE, &min, 0, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+
+	// all parameters have to be bound
+	{
+		g_autoptr(JDBIterator) iterator = NULL;
+
+		iterator = j_db_iterator_new(schema, selector, &error);
+		g_assert_null(iterator);
+		g_assert_error(error, J_DB_ERROR, J_DB_ERROR_PARAMETER_NOT_BOUND);
+		g_clear_error(&error);
+	}
+
+	// the template is sent with the first query only
+	for (guint i = 0; i < G_N_ELEMENTS(files); i++)
+	{
+		g_autoptr(JDBIterator) iterator = NULL;
+		guint entries = 0;
+
+		success = j_db_selector_bind(selector, 0, files[i], strlen(files[i]), &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+
+		iterator = j_db_iterator_new(schema, selector, &error);
+		g_assert_nonnull(iterator);
+		g_assert_no_error(error);
+
+		while (j_db_iterator_next(iterator, NULL))
+		{
+			entries++;
+		}
+
+		g_assert_cmpuint(entries, ==, g_str_equal(files[i], "demo.bp") ? 1 : 0);
+	}
+
+	// updates can use the registered template, too
+	{
+		g_autoptr(JDBEntry) entry = NULL;
+		gdouble unchanged = 1.0;
+
+		success = j_db_selector_bind(selector, 0, files[0], strlen(files[0]), &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+
+		entry = j_db_entry_new(schema, &error);
+		g_assert_nonnull(entry);
+		g_assert_no_error(error);
+		success = j_db_entry_set_field(entry, "min", &unchanged, sizeof(unchanged), &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		success = j_db_entry_update(entry, selector, batch, &error);
+		g_assert_true(success);
+		g_assert_no_error(error);
+		success = j_batch_execute(batch);
+		g_assert_true(success);
+		g_assert_no_error(error);
+	}
+}
+
 static void
 entry_update(void)
 {
@@ -509,25 +790,114 @@ entry_delete(void)
 	g_assert_true(success);
 }
 
+/**
+ * Returns the number of connections taken from the DB server's connection pool.
+ **/
+static guint64
+schema_get_connection_count(void)
+{
+	if (j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_DB) == 0)
+	{
+		return 0;
+	}
+
+	return j_connection_pool_get_statistics(J_BACKEND_TYPE_DB, 0, J_CONNECTION_POOL_HITS) + j_connection_pool_get_statistics(J_BACKEND_TYPE_DB, 0, J_CONNECTION_POOL_MISSES);
+}
+
+static void
+schema_get_cached(void)
+{
+	g_autoptr(GError) error = NULL;
+
+	gboolean success;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSchema) schema_cached = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	guint64 connections;
+	gboolean equal = FALSE;
+
+	schema = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+	success = j_db_schema_get(schema, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	connections = schema_get_connection_count();
+
+	// The schema is in the cache now, so getting it again must not contact the server
+	schema_cached = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema_cached);
+	g_assert_no_error(error);
+	success = j_db_schema_get(schema_cached, batch, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	success = j_batch_execute(batch);
+	g_assert_true(success);
+
+	g_assert_cmpuint(schema_get_connection_count(), ==, connections);
+	success = j_db_schema_equals(schema, schema_cached, &equal, &error);
+	g_assert_true(success);
+	g_assert_no_error(error);
+	g_assert_true(equal);
+}
+
 static void
 schema_delete(void)
 {
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_get = NULL;
 
 	gboolean success;
 	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSchema) schema_get = NULL;
 	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
 
 	schema = j_db_schema_new("adios2", "variables", &error);
 	g_assert_nonnull(schema);
 	g_assert_no_error(error);
+	schema_get = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema_get);
+	g_assert_no_error(error);
 
 	success = j_db_schema_delete(schema, batch, &error);
 	g_assert_true(success);
 	g_assert_no_error(error);
 
+	// The schema is still cached, but must not be served from the cache after the delete in the same batch
+	success = j_db_schema_get(schema_get, batch, &error_get);
+	g_assert_true(success);
+	g_assert_no_error(error_get);
+
 	success = j_batch_execute(batch);
+	g_assert_false(success);
+	g_assert_no_error(error);
+	g_assert_nonnull(error_get);
+}
+
+static void
+schema_get_deleted(void)
+{
+	g_autoptr(GError) error = NULL;
+
+	gboolean success;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	schema = j_db_schema_new("adios2", "variables", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+
+	// The schema must not be served from the client-side cache after it has been deleted
+	success = j_db_schema_get(schema, batch, &error);
 	g_assert_true(success);
+	g_assert_no_error(error);
+
+	success = j_batch_execute(batch);
+	g_assert_false(success);
+	g_assert_nonnull(error);
 }
 
 static void
@@ -537,9 +907,14 @@ test_db_all(void)
 	schema_create();
 	entry_insert();
 	iterator_get();
+	selector_explain();
+	selector_aggregate();
+	selector_prepared();
+	schema_get_cached();
 	entry_update();
 	entry_delete();
 	schema_delete();
+	schema_get_deleted();
 	J_TEST_TRAP_END;
 }
 
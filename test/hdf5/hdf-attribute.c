@@ -275,6 +275,86 @@ test_hdf_attribute_iterate(hid_t* file_fixture, gconstpointer udata)
 	j_expect_vol_kv_fail();
 }
 
+static void
+test_hdf_attribute_many(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, group, attribute;
+	herr_t error;
+	// more attributes than are buffered or fetched at once
+	guint const count = 600;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate(H5S_SCALAR);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	group = H5Gcreate(file, "attributes", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(group, !=, H5I_INVALID_HID);
+
+	for (guint i = 0; i < count; i++)
+	{
+		g_autofree gchar* name = g_strdup_printf("attr_%u", i);
+
+		attribute = H5Acreate(group, name, H5T_NATIVE_UINT, space, H5P_DEFAULT, H5P_DEFAULT);
+		g_assert_cmpint(attribute, !=, H5I_INVALID_HID);
+
+		error = H5Awrite(attribute, H5T_NATIVE_UINT, &i);
+		g_assert_cmpint(error, >=, 0);
+
+		error = H5Aclose(attribute);
+		g_assert_cmpint(error, >=, 0);
+	}
+
+	// the last attributes are still buffered and have to be found nevertheless
+	{
+		g_autofree gchar* name = g_strdup_printf("attr_%u", count - 1);
+		guint value = 0;
+
+		attribute = H5Aopen(group, name, H5P_DEFAULT);
+		g_assert_cmpint(attribute, !=, H5I_INVALID_HID);
+
+		error = H5Aread(attribute, H5T_NATIVE_UINT, &value);
+		g_assert_cmpint(error, >=, 0);
+		g_assert_cmpuint(value, ==, count - 1);
+
+		error = H5Aclose(attribute);
+		g_assert_cmpint(error, >=, 0);
+	}
+
+	error = H5Gclose(group);
+	g_assert_cmpint(error, >=, 0);
+
+	group = H5Gopen(file, "attributes", H5P_DEFAULT);
+	g_assert_cmpint(group, !=, H5I_INVALID_HID);
+
+	for (guint i = 0; i < count; i++)
+	{
+		g_autofree gchar* name = g_strdup_printf("attr_%u", i);
+		guint value = 0;
+
+		attribute = H5Aopen(group, name, H5P_DEFAULT);
+		g_assert_cmpint(attribute, !=, H5I_INVALID_HID);
+
+		error = H5Aread(attribute, H5T_NATIVE_UINT, &value);
+		g_assert_cmpint(error, >=, 0);
+		g_assert_cmpuint(value, ==, i);
+
+		error = H5Aclose(attribute);
+		g_assert_cmpint(error, >=, 0);
+	}
+
+	error = H5Gclose(group);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+}
+
 #endif
 
 void
@@ -290,6 +370,7 @@ test_hdf_attribute(void)
 	g_test_add("/hdf5/attribute/set", hid_t, "attribute_file.h5", j_test_hdf_file_fixture_setup, test_hdf_attribute_set, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/attribute/type", hid_t, "attribute_file.h5", j_test_hdf_file_fixture_setup, test_hdf_attribute_type, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/attribute/iterate", hid_t, "attribute_file.h5", j_test_hdf_file_fixture_setup, test_hdf_attribute_iterate, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/attribute/many", hid_t, "attribute_file.h5", j_test_hdf_file_fixture_setup, test_hdf_attribute_many, j_test_hdf_file_fixture_teardown);
 	g_test_add_func("/hdf5/attribute/create_invalid", test_hdf_attribute_invalid_object);
 
 #endif
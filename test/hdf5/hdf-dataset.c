@@ -24,6 +24,8 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <julea.h>
 
 #include "test.h"
@@ -347,6 +349,252 @@ test_hdf_dataset_write_read_selection(hid_t* file_fixture, gconstpointer udata)
 	j_expect_vol_kv_fail();
 }
 
+static void
+test_hdf_dataset_read_selection(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, hyperslab, elements, mem_space;
+	hsize_t rank = 2;
+	hsize_t dim[] = { 100, 100 };
+	hsize_t start[] = { 1, 0 };
+	hsize_t stride[] = { 2, 2 };
+	hsize_t count[] = { 50, 50 };
+	hsize_t coord[] = { 3, 3, 7, 1 };
+	hsize_t mem_dim[] = { 4 };
+	hsize_t mem_start[] = { 0 };
+	hsize_t mem_stride[] = { 2 };
+	hsize_t mem_count[] = { 2 };
+	g_autofree int* data = NULL;
+	g_autofree int* read_data = NULL;
+	int read_points[] = { -1, -1, -1, -1 };
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	set = H5Dcreate(file, "read_selection", H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	data = g_malloc(10000 * sizeof(int));
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		data[i] = i;
+	}
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	// every second value of every second row into contiguous memory
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, stride, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, count, count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	read_data = g_malloc(2500 * sizeof(int));
+
+	error = H5Dread(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		for (int j = 0; j < 50; ++j)
+		{
+			g_assert_cmpint(read_data[i * 50 + j], ==, (2 * i + 1) * 100 + 2 * j);
+		}
+	}
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	// single values into non-contiguous memory
+	elements = H5Scopy(space);
+	g_assert_cmpint(elements, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_elements(elements, H5S_SELECT_SET, 2, coord);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(1, mem_dim, mem_dim);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(mem_space, H5S_SELECT_SET, mem_start, mem_stride, mem_count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dread(set, H5T_NATIVE_INT, mem_space, elements, H5P_DEFAULT, read_points);
+	g_assert_cmpint(error, >=, 0);
+
+	g_assert_cmpint(read_points[0], ==, 303);
+	g_assert_cmpint(read_points[1], ==, -1);
+	g_assert_cmpint(read_points[2], ==, 701);
+	g_assert_cmpint(read_points[3], ==, -1);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(elements);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+}
+
+static void
+test_hdf_dataset_write_read_convert(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	g_autofree int* data = NULL;
+	g_autofree int* read_data = NULL;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	// the stored datatype differs from the native one in byte order
+	set = H5Dcreate(file, "convert", (G_BYTE_ORDER == G_LITTLE_ENDIAN) ? H5T_STD_I32BE : H5T_STD_I32LE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	data = g_malloc(1000 * sizeof(int));
+	read_data = g_malloc(1000 * sizeof(int));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		data[i] = i;
+	}
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	// the user buffer must not be modified by the conversion
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(data[i], ==, i);
+	}
+
+	error = H5Dread(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(read_data[i], ==, i);
+	}
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_convert_size(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	hsize_t chunk_size[] = { 64 };
+	hsize_t start[] = { 100 };
+	hsize_t stride[] = { 3 };
+	hsize_t count[] = { 200 };
+	g_autofree short* data = NULL;
+	g_autofree double* read_data = NULL;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	// the memory datatypes are smaller and larger than the stored one
+	set = H5Dcreate(file, "convert_size", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, stride, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	data = g_malloc(1000 * sizeof(short));
+	read_data = g_malloc(1000 * sizeof(double));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		data[i] = i;
+		read_data[i] = -1.0;
+	}
+
+	error = H5Dwrite(set, H5T_NATIVE_SHORT, hyperslab, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(data[i], ==, i);
+	}
+
+	error = H5Dread(set, H5T_NATIVE_DOUBLE, hyperslab, hyperslab, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	// elements outside the selection must not be modified
+	for (int i = 0; i < 1000; ++i)
+	{
+		gboolean selected = (i >= 100 && i < 700 && (i - 100) % 3 == 0);
+
+		g_assert_cmpfloat(read_data[i], ==, selected ? (double)i : -1.0);
+	}
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
 static void
 test_hdf_dataset_write_read_chunked(hid_t* file_fixture, gconstpointer udata)
 {
@@ -401,6 +649,775 @@ test_hdf_dataset_write_read_chunked(hid_t* file_fixture, gconstpointer udata)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_hdf_dataset_write_read_chunked_partial(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab, mem_space;
+	hsize_t rank = 3;
+	hsize_t dim[] = { 64, 64, 64 };
+	hsize_t chunk_size[] = { 16, 16, 16 };
+	hsize_t start[] = { 20, 0, 0 };
+	hsize_t count[] = { 1, 64, 64 };
+	hsize_t block_start[] = { 0, 0, 0 };
+	hsize_t block_count[] = { 16, 16, 32 };
+	g_autofree int* data = NULL;
+	g_autofree int* read_data = NULL;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	// only write the first chunk and half of the second one
+	set = H5Dcreate(file, "write_read_chunked_partial_test", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, block_start, NULL, block_count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, block_count, block_count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	data = g_malloc(16 * 16 * 32 * sizeof(int));
+	for (int i = 0; i < 16 * 16 * 32; ++i)
+		data[i] = i + 1;
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	read_data = g_malloc(16 * 16 * 48 * sizeof(int));
+
+	// read across the written chunks and one that has not been written
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	block_count[2] = 48;
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, block_start, NULL, block_count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, block_count, block_count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	error = H5Dread(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 16 * 16; ++i)
+	{
+		for (int j = 0; j < 48; ++j)
+		{
+			g_assert_cmpint(read_data[i * 48 + j], ==, (j < 32) ? i * 32 + j + 1 : 0);
+		}
+	}
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	// a plane in the slowest dimension touches one layer of chunks
+	g_free(data);
+	data = g_malloc(64 * 64 * 64 * sizeof(int));
+	for (int i = 0; i < 64 * 64 * 64; ++i)
+		data[i] = i;
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, count, count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	error = H5Dread(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 64 * 64; ++i)
+		g_assert_cmpint(read_data[i], ==, 20 * 64 * 64 + i);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_chunked_fill(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, other, dcpl, hyperslab, mem_space;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 256 };
+	hsize_t chunk_size[] = { 64 };
+	hsize_t start[] = { 10 };
+	hsize_t count[] = { 10 };
+	int fill = -1;
+	int data[10];
+	int read_data[256];
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+	g_assert_cmpint(error, >=, 0);
+
+	set = H5Dcreate(file, "write_read_chunked_fill_test", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	// the second handle does not know about the chunk written using the first one
+	other = H5Dopen(file, "write_read_chunked_fill_test", H5P_DEFAULT);
+	g_assert_cmpint(other, !=, H5I_INVALID_HID);
+
+	mem_space = H5Screate_simple(rank, count, count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	for (int i = 0; i < 10; ++i)
+		data[i] = i + 1;
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	start[0] = 30;
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dwrite(other, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dclose(other);
+	g_assert_cmpint(error, >=, 0);
+
+	other = H5Dopen(file, "write_read_chunked_fill_test", H5P_DEFAULT);
+	g_assert_cmpint(other, !=, H5I_INVALID_HID);
+
+	error = H5Dread(other, H5T_NATIVE_INT, space, space, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	// neither write overwrites the other one and unwritten elements contain the fill value
+	for (int i = 0; i < 256; ++i)
+	{
+		if (i >= 10 && i < 20)
+		{
+			g_assert_cmpint(read_data[i], ==, i - 10 + 1);
+		}
+		else if (i >= 30 && i < 40)
+		{
+			g_assert_cmpint(read_data[i], ==, i - 30 + 1);
+		}
+		else
+		{
+			g_assert_cmpint(read_data[i], ==, fill);
+		}
+	}
+
+	error = H5Dclose(other);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_compressed(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab, mem_space;
+	hsize_t rank = 2;
+	hsize_t dim[] = { 1000, 1000 };
+	hsize_t chunk_size[] = { 100, 100 };
+	hsize_t start[] = { 150, 150 };
+	hsize_t count[] = { 100, 100 };
+	guint level = 3;
+	g_autofree int* data = NULL;
+	g_autofree int* write_data = NULL;
+	hid_t create_plist;
+#ifdef HAVE_ZSTD
+	guint flags;
+	guint values[1];
+	size_t nelements = G_N_ELEMENTS(values);
+#endif
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pset_shuffle(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	// Zstandard
+	error = H5Pset_filter(dcpl, 32015, H5Z_FLAG_OPTIONAL, 1, &level);
+	g_assert_cmpint(error, >=, 0);
+
+	set = H5Dcreate(file, "write_read_compressed_test", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	// Optional filters are dropped silently if they are not supported, make sure compression is actually tested
+	create_plist = H5Dget_create_plist(set);
+	g_assert_cmpint(create_plist, !=, H5I_INVALID_HID);
+
+#ifdef HAVE_ZSTD
+	g_assert_cmpint(H5Pget_nfilters(create_plist), ==, 2);
+
+	error = H5Pget_filter_by_id(create_plist, 32015, &flags, &nelements, values, 0, NULL, NULL);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpuint(nelements, ==, 1);
+	g_assert_cmpuint(values[0], ==, level);
+#else
+	g_assert_cmpint(H5Pget_nfilters(create_plist), ==, 1);
+#endif
+
+	error = H5Pclose(create_plist);
+	g_assert_cmpint(error, >=, 0);
+
+	data = g_malloc(1000000 * sizeof(int));
+	for (int i = 0; i < 1000000; ++i)
+		data[i] = i % 1000;
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	// partially overwrite four chunks
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, count, count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	write_data = g_malloc(10000 * sizeof(int));
+	for (int i = 0; i < 10000; ++i)
+		write_data[i] = -1;
+
+	error = H5Dwrite(set, H5T_NATIVE_INT, mem_space, hyperslab, H5P_DEFAULT, write_data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000000; ++i)
+		data[i] = 0;
+
+	error = H5Dread(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		for (int j = 0; j < 1000; ++j)
+		{
+			gboolean inside = (i >= 150 && i < 250 && j >= 150 && j < 250);
+
+			g_assert_cmpint(data[i * 1000 + j], ==, inside ? -1 : j);
+		}
+	}
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_select_range(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	hsize_t chunk_size[] = { 100 };
+	hsize_t start[] = { 0 };
+	hsize_t count[] = { 800 };
+	g_autofree double* data = NULL;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	set = H5Dcreate(file, "select_range_test", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	// leave the last two chunks unwritten
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	data = g_malloc(1000 * sizeof(double));
+	for (int i = 0; i < 1000; ++i)
+		data[i] = 1000 + i;
+
+	error = H5Dwrite(set, H5T_NATIVE_DOUBLE, hyperslab, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	// chunks 2 and 3
+	error = j_hdf5_dataset_select_range(set, hyperslab, 1250.0, 1349.5);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpint(H5Sget_select_npoints(hyperslab), ==, 200);
+
+	for (int i = 0; i < 1000; ++i)
+		data[i] = -1;
+
+	error = H5Dread(set, H5T_NATIVE_DOUBLE, hyperslab, hyperslab, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000; ++i)
+		g_assert_cmpfloat(data[i], ==, (i >= 200 && i < 400) ? 1000 + i : -1);
+
+	// the unwritten chunks consist of zeros
+	error = j_hdf5_dataset_select_range(set, hyperslab, -1.0, 1.0);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpint(H5Sget_select_npoints(hyperslab), ==, 200);
+
+	error = j_hdf5_dataset_select_range(set, hyperslab, 5000.0, 6000.0);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpint(H5Sget_select_npoints(hyperslab), ==, 0);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_select_range_u64(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 200 };
+	hsize_t chunk_size[] = { 100 };
+	g_autofree guint64* data = NULL;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	set = H5Dcreate(file, "select_range_u64_test", H5T_NATIVE_UINT64, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	// the second chunk only contains values that do not fit into signed 64-bit integers
+	data = g_malloc(200 * sizeof(guint64));
+	for (int i = 0; i < 200; ++i)
+		data[i] = (i < 100) ? (guint64)i : (G_GUINT64_CONSTANT(1) << 63) + (guint64)i * 8192;
+
+	error = H5Dwrite(set, H5T_NATIVE_UINT64, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = j_hdf5_dataset_select_range(set, hyperslab, 9223372036854784000.0, 18446744073709551616.0);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpint(H5Sget_select_npoints(hyperslab), ==, 100);
+
+	error = j_hdf5_dataset_select_range(set, hyperslab, 0.0, 99.0);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpint(H5Sget_select_npoints(hyperslab), ==, 100);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_multi(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, dcpl;
+	hid_t sets[3];
+	hid_t types[3];
+	hid_t spaces[3];
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	hsize_t chunk_size[] = { 64 };
+	g_autofree int* data_a = NULL;
+	g_autofree int* data_b = NULL;
+	g_autofree double* data_c = NULL;
+	const void* write_bufs[3];
+	void* read_bufs[3];
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	// one contiguous and two chunked datasets
+	sets[0] = H5Dcreate(file, "multi_a", H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(sets[0], !=, H5I_INVALID_HID);
+
+	sets[1] = H5Dcreate(file, "multi_b", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(sets[1], !=, H5I_INVALID_HID);
+
+	sets[2] = H5Dcreate(file, "multi_c", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(sets[2], !=, H5I_INVALID_HID);
+
+	types[0] = H5T_NATIVE_INT;
+	types[1] = H5T_NATIVE_INT;
+	types[2] = H5T_NATIVE_DOUBLE;
+
+	spaces[0] = space;
+	spaces[1] = space;
+	spaces[2] = space;
+
+	data_a = g_malloc(1000 * sizeof(int));
+	data_b = g_malloc(1000 * sizeof(int));
+	data_c = g_malloc(1000 * sizeof(double));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		data_a[i] = i;
+		data_b[i] = -i;
+		data_c[i] = i / 2.0;
+	}
+
+	write_bufs[0] = data_a;
+	write_bufs[1] = data_b;
+	write_bufs[2] = data_c;
+
+	error = H5Dwrite_multi(3, sets, types, spaces, spaces, H5P_DEFAULT, write_bufs);
+	g_assert_cmpint(error, >=, 0);
+
+	memset(data_a, 0, 1000 * sizeof(int));
+	memset(data_b, 0, 1000 * sizeof(int));
+	memset(data_c, 0, 1000 * sizeof(double));
+
+	read_bufs[0] = data_a;
+	read_bufs[1] = data_b;
+	read_bufs[2] = data_c;
+
+	error = H5Dread_multi(3, sets, types, spaces, spaces, H5P_DEFAULT, read_bufs);
+	g_assert_cmpint(error, >=, 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(data_a[i], ==, i);
+		g_assert_cmpint(data_b[i], ==, -i);
+		g_assert_cmpfloat(data_c[i], ==, i / 2.0);
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		error = H5Dclose(sets[i]);
+		g_assert_cmpint(error, >=, 0);
+	}
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_async(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, es;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	g_autofree int* data = NULL;
+	size_t num_in_progress;
+	hbool_t err_occurred;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	es = H5EScreate();
+	g_assert_cmpint(es, !=, H5I_INVALID_HID);
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	set = H5Dcreate(file, "async", H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	data = g_malloc(1000 * sizeof(int));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		data[i] = i;
+	}
+
+	error = H5Dwrite_async(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data, es);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5ESwait(es, H5ES_WAIT_FOREVER, &num_in_progress, &err_occurred);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpuint(num_in_progress, ==, 0);
+	g_assert_false(err_occurred);
+
+	memset(data, 0, 1000 * sizeof(int));
+
+	error = H5Dread_async(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data, es);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5ESwait(es, H5ES_WAIT_FOREVER, &num_in_progress, &err_occurred);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpuint(num_in_progress, ==, 0);
+	g_assert_false(err_occurred);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(data[i], ==, i);
+	}
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5ESclose(es);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+}
+
+static void
+test_hdf_dataset_write_read_async_chunked(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, dcpl, hyperslab, es;
+	hsize_t rank = 1;
+	hsize_t dim[] = { 1000 };
+	hsize_t chunk_size[] = { 100 };
+	hsize_t start[] = { 250 };
+	hsize_t count[] = { 500 };
+	g_autofree int* data = NULL;
+	g_autofree int* overwrite = NULL;
+	size_t num_in_progress;
+	hbool_t err_occurred;
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	es = H5EScreate();
+	g_assert_cmpint(es, !=, H5I_INVALID_HID);
+
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	dcpl = H5Pcopy(H5P_DATASET_CREATE_DEFAULT);
+	g_assert_cmpint(dcpl, !=, H5I_INVALID_HID);
+
+	error = H5Pset_chunk(dcpl, rank, chunk_size);
+	g_assert_cmpint(error, >=, 0);
+
+	set = H5Dcreate(file, "async_chunked", H5T_NATIVE_INT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	data = g_malloc(1000 * sizeof(int));
+	overwrite = g_malloc(1000 * sizeof(int));
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		data[i] = i;
+		overwrite[i] = -i;
+	}
+
+	// the second write touches chunks created by the first one before it has been waited for
+	error = H5Dwrite_async(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data, es);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dwrite_async(set, H5T_NATIVE_INT, hyperslab, hyperslab, H5P_DEFAULT, overwrite, es);
+	g_assert_cmpint(error, >=, 0);
+
+	memset(data, 0, 1000 * sizeof(int));
+
+	error = H5Dread_async(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data, es);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5ESwait(es, H5ES_WAIT_FOREVER, &num_in_progress, &err_occurred);
+	g_assert_cmpint(error, >=, 0);
+	g_assert_cmpuint(num_in_progress, ==, 0);
+	g_assert_false(err_occurred);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		g_assert_cmpint(data[i], ==, (i >= 250 && i < 750) ? -i : i);
+	}
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Pclose(dcpl);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5ESclose(es);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_kv_fail();
+}
+
 static void
 test_hdf_dataset_write_read_single(hid_t* file_fixture, gconstpointer udata)
 {
@@ -490,7 +1507,18 @@ test_hdf_dataset(void)
 	g_test_add("/hdf5/dataset/invalid_extend", hid_t, "set_invalid_extend.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_invalid_extend, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read", hid_t, "set_write_read.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read_selection", hid_t, "set_write_read_sel.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_selection, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/read_selection", hid_t, "set_read_selection.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_read_selection, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_convert", hid_t, "set_write_read_convert.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_convert, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_convert_size", hid_t, "set_write_read_convert_size.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_convert_size, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read_chunked", hid_t, "set_write_read_chunked.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_chunked, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_chunked_partial", hid_t, "set_write_read_chunked_partial.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_chunked_partial, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_chunked_fill", hid_t, "set_write_read_chunked_fill.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_chunked_fill, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_compressed", hid_t, "set_write_read_compressed.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_compressed, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/select_range", hid_t, "set_select_range.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_select_range, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/select_range_u64", hid_t, "set_select_range_u64.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_select_range_u64, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_multi", hid_t, "set_write_read_multi.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_multi, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_async", hid_t, "set_write_read_async.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_async, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_async_chunked", hid_t, "set_write_read_async_chunked.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_async_chunked, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read_single", hid_t, "set_write_read_single.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_single, j_test_hdf_file_fixture_teardown);
 
 #endif
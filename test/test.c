@@ -45,6 +45,7 @@ main(int argc, char** argv)
 	test_core_batch();
 	test_core_cache();
 	test_core_configuration();
+	test_core_connection_pool();
 	test_core_credentials();
 	test_core_dir_iterator();
 	test_core_distribution();
@@ -53,6 +54,8 @@ main(int argc, char** argv)
 	test_core_memory_chunk();
 	test_core_message();
 	test_core_semantics();
+	test_core_statistics();
+	test_core_trace();
 
 	// Object client
 	test_object_distributed_object();
@@ -40,6 +40,7 @@ void test_core_background_operation(void);
 void test_core_batch(void);
 void test_core_cache(void);
 void test_core_configuration(void);
+void test_core_connection_pool(void);
 void test_core_credentials(void);
 void test_core_dir_iterator(void);
 void test_core_distribution(void);
@@ -48,6 +49,8 @@ void test_core_list_iterator(void);
 void test_core_memory_chunk(void);
 void test_core_message(void);
 void test_core_semantics(void);
+void test_core_statistics(void);
+void test_core_trace(void);
 
 void test_object_distributed_object(void);
 void test_object_object(void);
@@ -40,8 +40,11 @@ static gchar const* opt_db_backend = NULL;
 static gchar const* opt_db_path = NULL;
 static gint64 opt_max_operation_size = 0;
 static gint64 opt_max_inject_size = 0;
+static gint64 opt_zerocopy_size = 0;
 static gint opt_port = 0;
 static gint opt_max_connections = 0;
+static gint opt_min_connections = 0;
+static gint opt_idle_timeout = 0;
 static gint64 opt_stripe_size = 0;
 
 static gchar**
@@ -105,8 +108,11 @@ write_config(gchar* path)
 	key_file = g_key_file_new();
 	g_key_file_set_int64(key_file, "core", "max-operation-size", opt_max_operation_size);
 	g_key_file_set_int64(key_file, "core", "max-inject-size", opt_max_inject_size);
+	g_key_file_set_int64(key_file, "core", "zerocopy-size", opt_zerocopy_size);
 	g_key_file_set_integer(key_file, "core", "port", opt_port);
 	g_key_file_set_integer(key_file, "clients", "max-connections", opt_max_connections);
+	g_key_file_set_integer(key_file, "clients", "min-connections", opt_min_connections);
+	g_key_file_set_integer(key_file, "clients", "idle-timeout", opt_idle_timeout);
 	g_key_file_set_int64(key_file, "clients", "stripe-size", opt_stripe_size);
 	g_key_file_set_string_list(key_file, "servers", "object", (gchar const* const*)servers_object, g_strv_length(servers_object));
 	g_key_file_set_string_list(key_file, "servers", "kv", (gchar const* const*)servers_kv, g_strv_length(servers_kv));
@@ -161,8 +167,11 @@ main(gint argc, gchar** argv)
 		{ "db-path", 0, 0, G_OPTION_ARG_STRING, &opt_db_path, "Database path to use", "/path/to/storage" },
 		{ "max-operation-size", 0, 0, G_OPTION_ARG_INT64, &opt_max_operation_size, "Maximum size of an operation", "0" },
 		{ "max-inject-size", 0, 0, G_OPTION_ARG_INT64, &opt_max_inject_size, "Maximum inject size", "0" },
+		{ "zerocopy-size", 0, 0, G_OPTION_ARG_INT64, &opt_zerocopy_size, "Minimum payload size for zero-copy transmission (0 disables it)", "0" },
 		{ "port", 0, 0, G_OPTION_ARG_INT, &opt_port, "Default network port", "0" },
 		{ "max-connections", 0, 0, G_OPTION_ARG_INT, &opt_max_connections, "Maximum number of connections", "0" },
+		{ "min-connections", 0, 0, G_OPTION_ARG_INT, &opt_min_connections, "Number of connections to establish at startup and to keep when idle", "0" },
+		{ "idle-timeout", 0, 0, G_OPTION_ARG_INT, &opt_idle_timeout, "Seconds after which idle connections are closed", "0" },
 		{ "stripe-size", 0, 0, G_OPTION_ARG_INT64, &opt_stripe_size, "Default stripe size", "0" },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
@@ -190,7 +199,10 @@ main(gint argc, gchar** argv)
 	    || (!opt_read && (opt_servers_object == NULL || opt_servers_kv == NULL || opt_servers_db == NULL || opt_object_backend == NULL || opt_object_path == NULL || opt_kv_backend == NULL || opt_kv_path == NULL || opt_db_backend == NULL || opt_db_path == NULL))
 	    || opt_max_operation_size < 0
 	    || opt_max_inject_size < 0
+	    || opt_zerocopy_size < 0
 	    || opt_max_connections < 0
+	    || opt_min_connections < 0
+	    || opt_idle_timeout < 0
 	    || opt_stripe_size < 0
 	    || opt_port < 0 || opt_port > 65535)
 	{
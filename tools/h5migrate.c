@@ -20,14 +20,49 @@
 
 #include <glib.h>
 
+#include <locale.h>
+#include <stdio.h>
+#include <string.h>
+
 #include <julea.h>
 
 #include <hdf5.h>
 
+static gint64 opt_block_size = 64 * 1024 * 1024;
+static gint opt_jobs = 4;
+static gboolean opt_progress = FALSE;
+static gchar* opt_checkpoint = NULL;
+
+/**
+ * State shared by the whole copy.
+ */
+struct JHDF5CopyState_t
+{
+	/// buffers of buffer_size bytes that are reused for all datasets
+	gchar** buffers;
+	gsize buffer_size;
+	/// one event set per buffer, which contains the pending write of the buffer
+	hid_t* event_sets;
+	guint buffer_count;
+	/// the datasets that have been copied completely by a previous run
+	GHashTable* completed;
+	/// the checkpoint file, completed datasets are appended
+	FILE* checkpoint;
+	guint64 bytes_total;
+	guint64 bytes_copied;
+	gint64 start_time;
+	gint64 last_report;
+};
+
+typedef struct JHDF5CopyState_t JHDF5CopyState_t;
+
 struct JHDF5CopyParam_t
 {
 	hid_t dest_curr_group;
 	hid_t dxpl;
+	/// the path of the current group
+	gchar* path;
+	JHDF5CopyState_t* state;
 };
 
 typedef struct JHDF5CopyParam_t JHDF5CopyParam_t;
@@ -138,7 +173,7 @@ create_fapl_for_vol(const gchar* vol)
  * \return A negative value on error.
  */
 static herr_t
-copy_file(hid_t src_file, hid_t dest_file)
+copy_file(hid_t src_file, hid_t dest_file, JHDF5CopyState_t* state)
 {
 	JHDF5CopyParam_t copy_data;
 	herr_t retval = -1;
@@ -151,8 +186,12 @@ copy_file(hid_t src_file, hid_t dest_file)
 
 	copy_data.dest_curr_group = dest_file;
 	copy_data.dxpl = H5P_DEFAULT;
+	copy_data.path = g_strdup("/");
+	copy_data.state = state;
 	retval = H5Literate(src_file, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, iterate_copy, &copy_data);
 
+	g_free(copy_data.path);
+
 	return retval;
 }
 
@@ -183,6 +222,12 @@ copy_attribute(hid_t location_id, const char* attr_name, const H5A_info_t* ainfo
 
 	(void)ainfo;
 
+	// attributes that have been copied by a previous run are kept
+	if (H5Aexists(dst, attr_name) > 0)
+	{
+		return 0;
+	}
+
 	if ((attr = H5Aopen(location_id, attr_name, H5P_DEFAULT)) == H5I_INVALID_HID)
 	{
 		return retval;
@@ -251,25 +296,119 @@ copy_attributes(hid_t src, hid_t dst)
 	return H5Aiterate(src, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, copy_attribute, &dst);
 }
 
+/**
+ * Print the progress of the copy, at most once per second unless forced.
+ *
+ * \param state The copy state.
+ * \param force Whether to print regardless of when the progress has been printed last.
+ */
+static void
+report_progress(JHDF5CopyState_t* state, gboolean force)
+{
+	g_autofree gchar* copied = NULL;
+	g_autofree gchar* total = NULL;
+	g_autofree gchar* rate = NULL;
+	gint64 now;
+	gdouble elapsed;
+
+	if (!opt_progress)
+	{
+		return;
+	}
+
+	now = g_get_monotonic_time();
+
+	if (!force && now - state->last_report < G_USEC_PER_SEC)
+	{
+		return;
+	}
+
+	state->last_report = now;
+	elapsed = MAX((gdouble)(now - state->start_time) / G_USEC_PER_SEC, 1e-6);
+
+	copied = g_format_size(state->bytes_copied);
+	total = g_format_size(state->bytes_total);
+	rate = g_format_size(state->bytes_copied / elapsed);
+
+	g_printerr("%s of %s copied (%.1f%%, %s/s)\n", copied, total, (state->bytes_total > 0) ? 100.0 * state->bytes_copied / state->bytes_total : 100.0, rate);
+}
+
+/**
+ * Wait for the pending write of a buffer.
+ *
+ * \param state The copy state.
+ * \param slot The buffer's index.
+ *
+ * \return A negative value on error.
+ */
+static herr_t
+wait_buffer(JHDF5CopyState_t* state, guint slot)
+{
+	size_t in_progress = 0;
+	hbool_t failed = FALSE;
+
+	if (H5ESwait(state->event_sets[slot], H5ES_WAIT_FOREVER, &in_progress, &failed) < 0 || failed)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Wait for the pending writes of all buffers.
+ *
+ * \param state The copy state.
+ *
+ * \return A negative value on error.
+ */
+static herr_t
+wait_buffers(JHDF5CopyState_t* state)
+{
+	herr_t retval = 0;
+
+	for (guint i = 0; i < state->buffer_count; i++)
+	{
+		if (wait_buffer(state, i) < 0)
+		{
+			retval = -1;
+		}
+	}
+
+	return retval;
+}
+
 /**
  * Copy a dataset to a new location.
  *
+ * The dataset is copied block-wise along its first dimension, so that at most opt_block_size bytes are read at once.
+ * Each block is written asynchronously, allowing up to opt_jobs blocks to be written while the next ones are read.
+ * Rows that are larger than opt_block_size are copied one at a time.
+ *
  * \param set The dataset to copy.
  * \param dst_loc The location identfier of the target group.
  * \param dst_name The name of the new copy.
  * \param dxpl_id The dataset transfer property list.
+ * \param state The copy state.
  *
  * \return A negative value on error.
  */
 static herr_t
-copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
+copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id, JHDF5CopyState_t* state)
 {
 	g_auto(hid_t) dst = H5I_INVALID_HID;
 	g_auto(hid_t) space = H5I_INVALID_HID;
 	g_auto(hid_t) dtype = H5I_INVALID_HID;
 	g_auto(hid_t) dapl = H5I_INVALID_HID;
-	g_autofree gchar* buf = NULL;
-	size_t mem_size;
+	g_autofree hsize_t* dims = NULL;
+	g_autofree hsize_t* start = NULL;
+	g_autofree hsize_t* count = NULL;
+	size_t type_size;
+	hssize_t npoints;
+	gsize row_size = 1;
+	hsize_t rows_per_block;
+	int rank;
+	guint slot = 0;
 	herr_t retval = -1;
 
 	// copy general attributes of the set
@@ -288,13 +427,18 @@ copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
 		return retval;
 	}
 
-	// determine size of data set in memory
-	if ((mem_size = H5Sget_select_npoints(space) * H5Tget_size(dtype)) <= 0)
+	if ((type_size = H5Tget_size(dtype)) == 0 || (npoints = H5Sget_simple_extent_npoints(space)) <= 0)
+	{
+		return retval;
+	}
+
+	if ((rank = H5Sget_simple_extent_ndims(space)) < 0)
 	{
 		return retval;
 	}
 
-	if (!(buf = g_malloc(mem_size)))
+	// datasets left behind by an interrupted run are copied again
+	if (H5Lexists(dst_loc, dst_name, H5P_DEFAULT) > 0 && H5Ldelete(dst_loc, dst_name, H5P_DEFAULT) < 0)
 	{
 		return retval;
 	}
@@ -309,12 +453,104 @@ copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
 		return retval;
 	}
 
-	if (H5Dread(set, dtype, space, space, dxpl_id, buf) < 0)
+	// scalar datasets are treated as a single row
+	dims = g_new(hsize_t, MAX(rank, 1));
+	start = g_new0(hsize_t, MAX(rank, 1));
+	count = g_new(hsize_t, MAX(rank, 1));
+
+	if (rank == 0)
 	{
-		return retval;
+		dims[0] = 1;
+	}
+	else
+	{
+		H5Sget_simple_extent_dims(space, dims, NULL);
+	}
+
+	for (int i = 1; i < rank; i++)
+	{
+		row_size *= dims[i];
+	}
+
+	row_size *= type_size;
+	rows_per_block = MAX((gsize)opt_block_size / row_size, 1);
+
+	if (rows_per_block * row_size > state->buffer_size)
+	{
+		g_warning("%s: Rows of dataset %s exceed the block size, copying %" G_GSIZE_FORMAT " bytes at a time.", G_STRLOC, dst_name, row_size);
+
+		if (wait_buffers(state) < 0)
+		{
+			return retval;
+		}
+
+		state->buffer_size = rows_per_block * row_size;
+
+		for (guint i = 0; i < state->buffer_count; i++)
+		{
+			g_free(state->buffers[i]);
+			state->buffers[i] = g_malloc(state->buffer_size);
+		}
+	}
+
+	for (hsize_t row = 0; row < dims[0]; row += rows_per_block)
+	{
+		g_auto(hid_t) mem_space = H5I_INVALID_HID;
+		g_auto(hid_t) file_space = H5I_INVALID_HID;
+		gchar* buf;
+		hsize_t rows = MIN(rows_per_block, dims[0] - row);
+
+		// reuse the buffer whose write has been issued first
+		if (wait_buffer(state, slot) < 0)
+		{
+			return retval;
+		}
+
+		buf = state->buffers[slot];
+
+		if (rank == 0)
+		{
+			mem_space = H5Scopy(space);
+			file_space = H5Scopy(space);
+		}
+		else
+		{
+			memcpy(count, dims, rank * sizeof(hsize_t));
+			start[0] = row;
+			count[0] = rows;
+
+			mem_space = H5Screate_simple(rank, count, NULL);
+			file_space = H5Scopy(space);
+
+			if (file_space != H5I_INVALID_HID && H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+			{
+				return retval;
+			}
+		}
+
+		if (mem_space == H5I_INVALID_HID || file_space == H5I_INVALID_HID)
+		{
+			return retval;
+		}
+
+		if (H5Dread(set, dtype, mem_space, file_space, dxpl_id, buf) < 0)
+		{
+			return retval;
+		}
+
+		if (H5Dwrite_async(dst, dtype, mem_space, file_space, dxpl_id, buf, state->event_sets[slot]) < 0)
+		{
+			return retval;
+		}
+
+		state->bytes_copied += rows * row_size;
+		report_progress(state, FALSE);
+
+		slot = (slot + 1) % state->buffer_count;
 	}
 
-	if (H5Dwrite(dst, dtype, space, space, dxpl_id, buf) < 0)
+	// the dataset only counts as copied once all of its blocks have been written
+	if (wait_buffers(state) < 0)
 	{
 		return retval;
 	}
@@ -338,27 +574,60 @@ copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
 static herr_t
 handle_copy(hid_t object, const gchar* name, JHDF5CopyParam_t* copy_data)
 {
+	g_autofree gchar* path = NULL;
+	gchar* tmp_path;
 	hid_t tmp_grp;
 	herr_t retval = -1;
 
+	path = g_build_path("/", copy_data->path, name, NULL);
+
 	switch (H5Iget_type(object))
 	{
 		case H5I_GROUP:
 			tmp_grp = copy_data->dest_curr_group;
-			if ((copy_data->dest_curr_group = H5Gcreate(tmp_grp, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) != H5I_INVALID_HID)
+			tmp_path = copy_data->path;
+
+			// groups created by an interrupted run are reused
+			if (H5Lexists(tmp_grp, name, H5P_DEFAULT) > 0)
+			{
+				copy_data->dest_curr_group = H5Gopen(tmp_grp, name, H5P_DEFAULT);
+			}
+			else
 			{
+				copy_data->dest_curr_group = H5Gcreate(tmp_grp, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+			}
+
+			if (copy_data->dest_curr_group != H5I_INVALID_HID)
+			{
+				copy_data->path = path;
+
 				if ((retval = H5Literate(object, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, iterate_copy, copy_data)) >= 0)
 				{
 					retval = copy_attributes(object, copy_data->dest_curr_group);
 				}
 
 				H5Gclose(copy_data->dest_curr_group);
-				copy_data->dest_curr_group = tmp_grp;
 			}
+
+			copy_data->dest_curr_group = tmp_grp;
+			copy_data->path = tmp_path;
 			break;
 
 		case H5I_DATASET:
-			retval = copy_dataset(object, copy_data->dest_curr_group, name, copy_data->dxpl);
+			if (g_hash_table_contains(copy_data->state->completed, path))
+			{
+				retval = 0;
+				break;
+			}
+
+			if ((retval = copy_dataset(object, copy_data->dest_curr_group, name, copy_data->dxpl, copy_data->state)) >= 0 && copy_data->state->checkpoint != NULL)
+			{
+				// record the dataset only after all of its data has been written
+				if (fprintf(copy_data->state->checkpoint, "%s\n", path) < 0 || fflush(copy_data->state->checkpoint) != 0)
+				{
+					retval = -1;
+				}
+			}
 			break;
 
 		case H5I_DATATYPE:
@@ -427,7 +696,95 @@ static void
 usage(void)
 {
 	/// \todo use argv[0]
-	printf("Usage: h5migrate [volname://]source [volname://]target\n");
+	printf("Usage: h5migrate [OPTION…] [volname://]source [volname://]target\n");
+	printf("Run with --help for a list of options.\n");
+}
+
+/**
+ * Add the size of a dataset to the total size of the copy. Function of type H5O_iterate2_t.
+ *
+ * Gets called by H5Ovisit3().
+ *
+ * \param object The object currently visited.
+ * \param name The name of the object.
+ * \param info Information about the object.
+ * \param op_data A pointer to the JHDF5CopyState_t.
+ *
+ * \return A negative value on error.
+ */
+static herr_t
+visit_size(hid_t object, const char* name, const H5O_info2_t* info, void* op_data)
+{
+	JHDF5CopyState_t* state = op_data;
+	g_auto(hid_t) set = H5I_INVALID_HID;
+	g_auto(hid_t) space = H5I_INVALID_HID;
+	g_auto(hid_t) dtype = H5I_INVALID_HID;
+	g_autofree gchar* path = NULL;
+
+	if (info->type != H5O_TYPE_DATASET)
+	{
+		return 0;
+	}
+
+	path = g_build_path("/", "/", name, NULL);
+
+	if ((set = H5Dopen(object, name, H5P_DEFAULT)) == H5I_INVALID_HID)
+	{
+		return -1;
+	}
+
+	if ((space = H5Dget_space(set)) == H5I_INVALID_HID || (dtype = H5Dget_type(set)) == H5I_INVALID_HID)
+	{
+		return -1;
+	}
+
+	// datasets completed by a previous run count as copied
+	if (g_hash_table_contains(state->completed, path))
+	{
+		state->bytes_copied += H5Sget_simple_extent_npoints(space) * H5Tget_size(dtype);
+	}
+
+	state->bytes_total += H5Sget_simple_extent_npoints(space) * H5Tget_size(dtype);
+
+	return 0;
+}
+
+/**
+ * Read the datasets that have been completed by a previous run.
+ *
+ * \param path The path of the checkpoint file.
+ * \param completed The set to add the datasets to.
+ *
+ * \return FALSE if the checkpoint exists but could not be read.
+ */
+static gboolean
+load_checkpoint(const gchar* path, GHashTable* completed)
+{
+	g_autofree gchar* contents = NULL;
+	g_auto(GStrv) lines = NULL;
+
+	if (!g_file_test(path, G_FILE_TEST_EXISTS))
+	{
+		return TRUE;
+	}
+
+	if (!g_file_get_contents(path, &contents, NULL, NULL))
+	{
+		return FALSE;
+	}
+
+	lines = g_strsplit(contents, "\n", -1);
+
+	for (guint i = 0; lines[i] != NULL; i++)
+	{
+		// incomplete last lines belong to datasets that have to be copied again
+		if (lines[i][0] != '\0' && lines[i + 1] != NULL)
+		{
+			g_hash_table_add(completed, g_strdup(lines[i]));
+		}
+	}
+
+	return TRUE;
 }
 
 int
@@ -439,22 +796,46 @@ main(int argc, char** argv)
 	g_auto(hid_t) fapl_vol_dst = H5I_INVALID_HID;
 	g_auto(GStrv) src_components = NULL;
 	g_auto(GStrv) dst_components = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GError) error = NULL;
+	JHDF5CopyState_t state = { 0 };
+	gboolean resume = FALSE;
 	gchar* source = NULL;
 	gchar* destination = NULL;
 	herr_t retval = -1;
 
+	GOptionEntry entries[] = {
+		{ "block-size", 'b', 0, G_OPTION_ARG_INT64, &opt_block_size, "Number of bytes to copy at once", "67108864" },
+		{ "jobs", 'j', 0, G_OPTION_ARG_INT, &opt_jobs, "Number of blocks to write concurrently", "4" },
+		{ "progress", 'p', 0, G_OPTION_ARG_NONE, &opt_progress, "Print progress and throughput", NULL },
+		{ "checkpoint", 'c', 0, G_OPTION_ARG_FILENAME, &opt_checkpoint, "Record completed datasets and resume from them", "file" },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
+
 	/**
 	 * \todo Needed because otherwise native VOL cannot be used.
 	 */
 	g_setenv("HDF5_VOL_CONNECTOR", "native", true);
 
-	if (argc <= 2)
+	context = g_option_context_new("[volname://]source [volname://]target");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		g_printerr("%s\n", error->message);
+		return retval;
+	}
+
+	if (argc <= 2 || opt_block_size <= 0 || opt_jobs <= 0)
 	{
 		usage();
 		return retval;
 	}
 
-	/// \todo add options (e.g. chunked copy or copy only some objects like h5copy)
+	/// \todo add options to copy only some objects like h5copy
 	source = argv[1];
 	destination = argv[2];
 
@@ -485,25 +866,97 @@ main(int argc, char** argv)
 		return retval;
 	}
 
+	state.completed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	if (opt_checkpoint != NULL)
+	{
+		resume = g_file_test(opt_checkpoint, G_FILE_TEST_EXISTS);
+
+		if (!load_checkpoint(opt_checkpoint, state.completed))
+		{
+			g_critical("%s: Could not read checkpoint file!", G_STRLOC);
+			goto end;
+		}
+
+		if ((state.checkpoint = fopen(opt_checkpoint, "a")) == NULL)
+		{
+			g_critical("%s: Could not open checkpoint file!", G_STRLOC);
+			goto end;
+		}
+	}
+
 	if ((src = H5Fopen(src_components[1], H5F_ACC_RDONLY, fapl_vol_src)) == H5I_INVALID_HID)
 	{
 		g_critical("%s: Could not open source file!", G_STRLOC);
-		return retval;
+		goto end;
+	}
+
+	// resumed copies continue in the existing target file
+	if (resume)
+	{
+		dst = H5Fopen(dst_components[1], H5F_ACC_RDWR, fapl_vol_dst);
+	}
+	else
+	{
+		dst = H5Fcreate(dst_components[1], H5F_ACC_EXCL, H5P_DEFAULT, fapl_vol_dst);
 	}
 
-	if ((dst = H5Fcreate(dst_components[1], H5F_ACC_EXCL, H5P_DEFAULT, fapl_vol_dst)) == H5I_INVALID_HID)
+	if (dst == H5I_INVALID_HID)
 	{
 		g_critical("%s: Could not create target file!", G_STRLOC);
-		return retval;
+		goto end;
+	}
+
+	state.buffer_count = opt_jobs;
+	state.buffer_size = opt_block_size;
+	state.buffers = g_new(gchar*, state.buffer_count);
+	state.event_sets = g_new(hid_t, state.buffer_count);
+
+	for (guint i = 0; i < state.buffer_count; i++)
+	{
+		state.buffers[i] = g_malloc(state.buffer_size);
+		state.event_sets[i] = H5EScreate();
+	}
+
+	state.start_time = g_get_monotonic_time();
+
+	if (opt_progress && H5Ovisit3(src, H5_INDEX_NAME, H5_ITER_NATIVE, visit_size, &state, H5O_INFO_BASIC) < 0)
+	{
+		g_warning("%s: Could not determine the size of the source file!", G_STRLOC);
 	}
 
 	g_info("Copying %s to %s!", source, destination);
-	retval = copy_file(src, dst);
+	retval = copy_file(src, dst, &state);
+
+	if (wait_buffers(&state) < 0)
+	{
+		retval = -1;
+	}
+
+	report_progress(&state, TRUE);
 
 	if (retval < 0)
 	{
 		g_critical("%s: Could not copy all of the data!", G_STRLOC);
 	}
 
+	for (guint i = 0; i < state.buffer_count; i++)
+	{
+		H5ESclose(state.event_sets[i]);
+		g_free(state.buffers[i]);
+	}
+
+	g_free(state.event_sets);
+	g_free(state.buffers);
+
+end:
+	if (state.checkpoint != NULL)
+	{
+		fclose(state.checkpoint);
+	}
+
+	g_hash_table_unref(state.completed);
+	g_free(opt_checkpoint);
+
 	return retval;
 }
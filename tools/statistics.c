@@ -28,6 +28,8 @@
 #include <jmessage.h>
 #include <jstatistics.h>
 
+static gboolean opt_prometheus = FALSE;
+
 static void
 print_statistics(JStatistics* statistics)
 {
@@ -54,39 +56,199 @@ print_statistics(JStatistics* statistics)
 	g_free(size_written);
 	g_free(size_received);
 	g_free(size_sent);
+
+	for (JMessageType type = J_MESSAGE_NONE; type <= J_MESSAGE_DB_EXPLAIN; type++)
+	{
+		g_autofree gchar* size = NULL;
+		guint64 operations;
+
+		operations = j_statistics_get_operations(statistics, type);
+
+		if (operations == 0)
+		{
+			continue;
+		}
+
+		size = g_format_size(j_statistics_get_operation_bytes(statistics, type));
+
+		g_print("  %" G_GUINT64_FORMAT " %s operations (%s)\n", operations, j_statistics_get_operation_name(type), size);
+		g_print("    server latency:  p50 %" G_GUINT64_FORMAT " µs, p99 %" G_GUINT64_FORMAT " µs, p99.9 %" G_GUINT64_FORMAT " µs\n",
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_SERVER, 50.0),
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_SERVER, 99.0),
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_SERVER, 99.9));
+		g_print("    backend latency: p50 %" G_GUINT64_FORMAT " µs, p99 %" G_GUINT64_FORMAT " µs, p99.9 %" G_GUINT64_FORMAT " µs\n",
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_BACKEND, 50.0),
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_BACKEND, 99.0),
+			j_statistics_get_latency_percentile(statistics, type, J_STATISTICS_LATENCY_BACKEND, 99.9));
+	}
+}
+
+static void
+print_prometheus_counter(JStatistics** statistics, gchar const** servers, guint count, gchar const* name, gchar const* help, JStatisticsType type)
+{
+	g_print("# HELP julea_%s %s\n", name, help);
+	g_print("# TYPE julea_%s counter\n", name);
+
+	for (guint i = 0; i < count; i++)
+	{
+		g_print("julea_%s{server=\"%s\"} %" G_GUINT64_FORMAT "\n", name, servers[i], j_statistics_get(statistics[i], type));
+	}
+}
+
+static void
+print_prometheus(JStatistics** statistics, gchar const** servers, guint count)
+{
+	gchar const* latency_names[] = { "server", "backend" };
+
+	// All samples of a metric have to be grouped, so every metric iterates over all servers
+
+	print_prometheus_counter(statistics, servers, count, "files_created_total", "Number of created files.", J_STATISTICS_FILES_CREATED);
+	print_prometheus_counter(statistics, servers, count, "files_deleted_total", "Number of deleted files.", J_STATISTICS_FILES_DELETED);
+	print_prometheus_counter(statistics, servers, count, "files_stated_total", "Number of stat'ed files.", J_STATISTICS_FILES_STATED);
+	print_prometheus_counter(statistics, servers, count, "syncs_total", "Number of syncs.", J_STATISTICS_SYNC);
+	print_prometheus_counter(statistics, servers, count, "read_bytes_total", "Number of bytes read from the backend.", J_STATISTICS_BYTES_READ);
+	print_prometheus_counter(statistics, servers, count, "written_bytes_total", "Number of bytes written to the backend.", J_STATISTICS_BYTES_WRITTEN);
+	print_prometheus_counter(statistics, servers, count, "received_bytes_total", "Number of bytes received from clients.", J_STATISTICS_BYTES_RECEIVED);
+	print_prometheus_counter(statistics, servers, count, "sent_bytes_total", "Number of bytes sent to clients.", J_STATISTICS_BYTES_SENT);
+
+	g_print("# HELP julea_operations_total Number of handled messages.\n");
+	g_print("# TYPE julea_operations_total counter\n");
+
+	for (guint i = 0; i < count; i++)
+	{
+		for (JMessageType type = J_MESSAGE_NONE; type <= J_MESSAGE_DB_EXPLAIN; type++)
+		{
+			if (j_statistics_get_operations(statistics[i], type) > 0)
+			{
+				g_print("julea_operations_total{server=\"%s\",type=\"%s\"} %" G_GUINT64_FORMAT "\n", servers[i], j_statistics_get_operation_name(type), j_statistics_get_operations(statistics[i], type));
+			}
+		}
+	}
+
+	g_print("# HELP julea_operation_bytes_total Number of bytes transferred by handled messages.\n");
+	g_print("# TYPE julea_operation_bytes_total counter\n");
+
+	for (guint i = 0; i < count; i++)
+	{
+		for (JMessageType type = J_MESSAGE_NONE; type <= J_MESSAGE_DB_EXPLAIN; type++)
+		{
+			if (j_statistics_get_operations(statistics[i], type) > 0)
+			{
+				g_print("julea_operation_bytes_total{server=\"%s\",type=\"%s\"} %" G_GUINT64_FORMAT "\n", servers[i], j_statistics_get_operation_name(type), j_statistics_get_operation_bytes(statistics[i], type));
+			}
+		}
+	}
+
+	g_print("# HELP julea_operation_latency_seconds Latency of handled messages, split into server and backend time.\n");
+	g_print("# TYPE julea_operation_latency_seconds histogram\n");
+
+	for (guint i = 0; i < count; i++)
+	{
+		for (JMessageType type = J_MESSAGE_NONE; type <= J_MESSAGE_DB_EXPLAIN; type++)
+		{
+			if (j_statistics_get_operations(statistics[i], type) == 0)
+			{
+				continue;
+			}
+
+			for (JStatisticsLatency latency = J_STATISTICS_LATENCY_SERVER; latency <= J_STATISTICS_LATENCY_BACKEND; latency++)
+			{
+				g_autofree gchar* labels = NULL;
+				guint64 cumulative = 0;
+
+				labels = g_strdup_printf("server=\"%s\",type=\"%s\",part=\"%s\"", servers[i], j_statistics_get_operation_name(type), latency_names[latency]);
+
+				// Only powers of two are exported to keep the number of series manageable
+				for (guint bucket = 0; bucket < J_STATISTICS_LATENCY_BUCKETS; bucket++)
+				{
+					guint64 bound;
+
+					bound = j_statistics_get_latency_bucket_bound(bucket);
+					cumulative += j_statistics_get_latency_bucket(statistics[i], type, latency, bucket);
+
+					if ((bound & (bound - 1)) == 0)
+					{
+						g_print("julea_operation_latency_seconds_bucket{%s,le=\"%g\"} %" G_GUINT64_FORMAT "\n", labels, bound / 1000000.0, cumulative);
+					}
+				}
+
+				g_print("julea_operation_latency_seconds_bucket{%s,le=\"+Inf\"} %" G_GUINT64_FORMAT "\n", labels, cumulative);
+				g_print("julea_operation_latency_seconds_sum{%s} %g\n", labels, j_statistics_get_latency_sum(statistics[i], type, latency) / 1000000.0);
+				g_print("julea_operation_latency_seconds_count{%s} %" G_GUINT64_FORMAT "\n", labels, cumulative);
+			}
+		}
+	}
 }
 
 int
 main(int argc, char** argv)
 {
 	JConfiguration* configuration;
+	g_autoptr(GOptionContext) context = NULL;
 	g_autoptr(JMessage) message = NULL;
+	g_autofree JStatistics** statistics = NULL;
+	g_autofree gchar const** servers = NULL;
+	GError* error = NULL;
 	JStatistics* statistics_total;
 	gchar get_all;
+	gint ret = 0;
+	guint server_count;
 
-	(void)argc;
-	(void)argv;
+	GOptionEntry entries[] = {
+		{ "prometheus", 0, 0, G_OPTION_ARG_NONE, &opt_prometheus, "Print statistics in the Prometheus text format", NULL },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
 
 	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
 	setlocale(LC_ALL, "C.UTF-8");
 
+	context = g_option_context_new(NULL);
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+
+		return 1;
+	}
+
+	// Prometheus expects a dot as the decimal separator
+	if (opt_prometheus)
+	{
+		setlocale(LC_NUMERIC, "C");
+	}
+
 	get_all = 1;
 	configuration = j_configuration();
+	server_count = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT);
 	statistics_total = j_statistics_new(FALSE);
+	statistics = g_new(JStatistics*, server_count);
+	servers = g_new(gchar const*, server_count);
 
 	message = j_message_new(J_MESSAGE_STATISTICS, sizeof(gchar));
 	j_message_add_operation(message, 0);
 	j_message_append_1(message, &get_all);
 
-	for (guint i = 0; i < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT); i++)
+	for (guint i = 0; i < server_count; i++)
 	{
 		g_autoptr(JMessage) reply = NULL;
-		JStatistics* statistics;
 		gpointer connection;
 		guint64 value;
 
 		connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, i);
-		statistics = j_statistics_new(FALSE);
+		statistics[i] = j_statistics_new(FALSE);
+		servers[i] = j_configuration_get_server(configuration, J_BACKEND_TYPE_OBJECT, i);
+
+		if (connection == NULL)
+		{
+			g_printerr("Can not connect to data server %s.\n", servers[i]);
+			ret = 1;
+			continue;
+		}
 
 		j_message_send(message, connection);
 
@@ -94,57 +256,70 @@ main(int argc, char** argv)
 		j_message_receive(reply, connection);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_CREATED, value);
+		j_statistics_add(statistics[i], J_STATISTICS_FILES_CREATED, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_DELETED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_DELETED, value);
+		j_statistics_add(statistics[i], J_STATISTICS_FILES_DELETED, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_STATED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_STATED, value);
+		j_statistics_add(statistics[i], J_STATISTICS_FILES_STATED, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_SYNC, value);
-		j_statistics_add(statistics_total, J_STATISTICS_SYNC, value);
+		j_statistics_add(statistics[i], J_STATISTICS_SYNC, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_READ, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_READ, value);
+		j_statistics_add(statistics[i], J_STATISTICS_BYTES_READ, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_WRITTEN, value);
+		j_statistics_add(statistics[i], J_STATISTICS_BYTES_WRITTEN, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_RECEIVED, value);
+		j_statistics_add(statistics[i], J_STATISTICS_BYTES_RECEIVED, value);
 
 		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_SENT, value);
+		j_statistics_add(statistics[i], J_STATISTICS_BYTES_SENT, value);
 
-		g_print("Data server %d\n", i);
-		print_statistics(statistics);
-
-		if (i != j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT) - 1)
+		// Older servers do not send operation statistics
+		if (j_message_get_count(reply) > 1)
 		{
-			g_print("\n");
+			j_statistics_deserialize_operations(statistics[i], reply);
 		}
 
-		j_statistics_free(statistics);
+		j_statistics_merge(statistics_total, statistics[i]);
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, i, connection);
 	}
 
-	if (j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT) > 1)
+	if (opt_prometheus)
+	{
+		print_prometheus(statistics, servers, server_count);
+	}
+	else
+	{
+		for (guint i = 0; i < server_count; i++)
+		{
+			g_print("Data server %d\n", i);
+			print_statistics(statistics[i]);
+
+			if (i != server_count - 1)
+			{
+				g_print("\n");
+			}
+		}
+
+		if (server_count > 1)
+		{
+			g_print("\n");
+			g_print("Total\n");
+			print_statistics(statistics_total);
+		}
+	}
+
+	for (guint i = 0; i < server_count; i++)
 	{
-		g_print("\n");
-		g_print("Total\n");
-		print_statistics(statistics_total);
+		j_statistics_free(statistics[i]);
 	}
 
 	j_statistics_free(statistics_total);
 
-	return 0;
+	return ret;
 }
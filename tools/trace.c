@@ -0,0 +1,577 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <locale.h>
+#include <string.h>
+
+#include <bson.h>
+
+/**
+ * A request and its replies, as recorded by clients and servers.
+ * Timestamps are in microseconds and negative if they have not been recorded.
+ **/
+struct Span
+{
+	gchar* name;
+	guint64 trace_id;
+
+	gdouble client_begin;
+	gdouble client_end;
+	gdouble server_begin;
+	gdouble server_end;
+
+	/**
+	 * The time spent in backend functions.
+	 **/
+	gdouble backend;
+};
+
+typedef struct Span Span;
+
+/**
+ * A function that has been entered but not left yet.
+ **/
+struct Frame
+{
+	gdouble timestamp;
+	guint64 span_id;
+	gboolean backend;
+};
+
+typedef struct Frame Frame;
+
+/**
+ * The parts of a Chrome Trace event that are relevant for the analysis.
+ **/
+struct Event
+{
+	gchar const* name;
+	gchar const* phase;
+	gdouble timestamp;
+	gint64 pid;
+	gint64 tid;
+	guint64 id;
+	guint64 trace_id;
+	guint64 span_id;
+};
+
+typedef struct Event Event;
+
+struct Breakdown
+{
+	guint64 count;
+	gdouble total;
+	gdouble network;
+	gdouble server;
+	gdouble backend;
+};
+
+typedef struct Breakdown Breakdown;
+
+/**
+ * All messages that share a trace ID.
+ **/
+struct Batch
+{
+	guint64 trace_id;
+
+	/**
+	 * The sum of all messages.
+	 **/
+	Breakdown all;
+
+	/**
+	 * The slowest message, which is the batch's critical path.
+	 **/
+	Breakdown critical;
+};
+
+typedef struct Batch Batch;
+
+static gint opt_batches = 10;
+static gchar** opt_files = NULL;
+
+static GHashTable* spans = NULL;
+static GHashTable* stacks = NULL;
+
+static void
+span_free(gpointer data)
+{
+	Span* span = data;
+
+	g_free(span->name);
+	g_free(span);
+}
+
+static Span*
+span_get(guint64 id)
+{
+	Span* span;
+
+	span = g_hash_table_lookup(spans, &id);
+
+	if (span == NULL)
+	{
+		guint64* key;
+
+		key = g_new(guint64, 1);
+		*key = id;
+
+		span = g_new(Span, 1);
+		span->name = NULL;
+		span->trace_id = 0;
+		span->client_begin = -1.0;
+		span->client_end = -1.0;
+		span->server_begin = -1.0;
+		span->server_end = -1.0;
+		span->backend = 0.0;
+
+		g_hash_table_insert(spans, key, span);
+	}
+
+	return span;
+}
+
+static void
+span_get_breakdown(Span const* span, Breakdown* breakdown)
+{
+	gdouble server = 0.0;
+
+	breakdown->count = 1;
+	breakdown->total = span->client_end - span->client_begin;
+
+	if (span->server_begin >= 0.0)
+	{
+		server = span->server_end - span->server_begin;
+	}
+
+	// client and server clocks might differ, so only durations measured by the same host are combined
+	breakdown->network = MAX(breakdown->total - server, 0.0);
+	breakdown->backend = MIN(span->backend, server);
+	breakdown->server = server - breakdown->backend;
+}
+
+static void
+breakdown_add(Breakdown* breakdown, Breakdown const* other)
+{
+	breakdown->count += other->count;
+	breakdown->total += other->total;
+	breakdown->network += other->network;
+	breakdown->server += other->server;
+	breakdown->backend += other->backend;
+}
+
+static guint64
+parse_id(bson_iter_t* iter)
+{
+	if (!BSON_ITER_HOLDS_UTF8(iter))
+	{
+		return 0;
+	}
+
+	return g_ascii_strtoull(bson_iter_utf8(iter, NULL), NULL, 16);
+}
+
+static gboolean
+parse_event(bson_t const* document, Event* event)
+{
+	bson_iter_t iter;
+
+	memset(event, 0, sizeof(Event));
+
+	if (!bson_iter_init(&iter, document))
+	{
+		return FALSE;
+	}
+
+	while (bson_iter_next(&iter))
+	{
+		gchar const* key;
+
+		key = bson_iter_key(&iter);
+
+		if (g_strcmp0(key, "name") == 0 && BSON_ITER_HOLDS_UTF8(&iter))
+		{
+			event->name = bson_iter_utf8(&iter, NULL);
+		}
+		else if (g_strcmp0(key, "ph") == 0 && BSON_ITER_HOLDS_UTF8(&iter))
+		{
+			event->phase = bson_iter_utf8(&iter, NULL);
+		}
+		else if (g_strcmp0(key, "ts") == 0)
+		{
+			if (BSON_ITER_HOLDS_DOUBLE(&iter))
+			{
+				event->timestamp = bson_iter_double(&iter);
+			}
+			else
+			{
+				event->timestamp = bson_iter_as_int64(&iter);
+			}
+		}
+		else if (g_strcmp0(key, "pid") == 0)
+		{
+			event->pid = bson_iter_as_int64(&iter);
+		}
+		else if (g_strcmp0(key, "tid") == 0)
+		{
+			event->tid = bson_iter_as_int64(&iter);
+		}
+		else if (g_strcmp0(key, "id") == 0)
+		{
+			event->id = parse_id(&iter);
+		}
+		else if (g_strcmp0(key, "args") == 0 && BSON_ITER_HOLDS_DOCUMENT(&iter))
+		{
+			bson_iter_t args;
+
+			bson_iter_recurse(&iter, &args);
+
+			while (bson_iter_next(&args))
+			{
+				if (g_strcmp0(bson_iter_key(&args), "correlation") == 0)
+				{
+					event->trace_id = parse_id(&args);
+				}
+				else if (g_strcmp0(bson_iter_key(&args), "span") == 0)
+				{
+					event->span_id = parse_id(&args);
+				}
+			}
+		}
+	}
+
+	return (event->phase != NULL);
+}
+
+static void
+process_event(Event const* event)
+{
+	g_autofree gchar* thread = NULL;
+	GArray* stack;
+	Span* span;
+
+	thread = g_strdup_printf("%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT, event->pid, event->tid);
+	stack = g_hash_table_lookup(stacks, thread);
+
+	if (stack == NULL)
+	{
+		stack = g_array_new(FALSE, FALSE, sizeof(Frame));
+		g_hash_table_insert(stacks, g_strdup(thread), stack);
+	}
+
+	switch (event->phase[0])
+	{
+		case 'B':
+		{
+			Frame frame;
+
+			frame.timestamp = event->timestamp;
+			frame.span_id = event->span_id;
+			frame.backend = (event->name != NULL && g_str_has_prefix(event->name, "backend_"));
+
+			g_array_append_val(stack, frame);
+			break;
+		}
+		case 'E':
+		{
+			Frame frame;
+			gboolean nested = FALSE;
+
+			if (stack->len == 0)
+			{
+				break;
+			}
+
+			frame = g_array_index(stack, Frame, stack->len - 1);
+			g_array_set_size(stack, stack->len - 1);
+
+			// only count the outermost backend function
+			for (guint i = 0; i < stack->len; i++)
+			{
+				nested = nested || g_array_index(stack, Frame, i).backend;
+			}
+
+			if (frame.backend && frame.span_id != 0 && !nested)
+			{
+				span = span_get(frame.span_id);
+				span->backend += event->timestamp - frame.timestamp;
+			}
+
+			break;
+		}
+		case 's':
+			span = span_get(event->id);
+			span->client_begin = event->timestamp;
+			span->trace_id = event->trace_id;
+
+			if (span->name == NULL && event->name != NULL)
+			{
+				span->name = g_strdup(event->name);
+			}
+
+			break;
+		case 't':
+			// the server records a step when receiving the request and when sending each reply
+			span = span_get(event->id);
+			span->server_begin = (span->server_begin < 0.0) ? event->timestamp : MIN(span->server_begin, event->timestamp);
+			span->server_end = MAX(span->server_end, event->timestamp);
+			break;
+		case 'f':
+			span = span_get(event->id);
+			span->client_end = MAX(span->client_end, event->timestamp);
+			break;
+		default:
+			break;
+	}
+}
+
+static gboolean
+process_file(gchar const* path)
+{
+	g_autofree gchar* content = NULL;
+	g_auto(GStrv) lines = NULL;
+	GError* error = NULL;
+
+	if (!g_file_get_contents(path, &content, NULL, &error))
+	{
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	// trace files contain one event per line
+	lines = g_strsplit(content, "\n", 0);
+
+	for (guint i = 0; lines[i] != NULL; i++)
+	{
+		bson_error_t bson_error;
+		bson_t* document;
+		gchar* line;
+		gsize length;
+		Event event;
+
+		line = g_strstrip(lines[i]);
+		length = strlen(line);
+
+		if (length > 0 && line[length - 1] == ',')
+		{
+			length--;
+		}
+
+		if (length == 0 || line[0] != '{')
+		{
+			continue;
+		}
+
+		if ((document = bson_new_from_json((guint8 const*)line, length, &bson_error)) == NULL)
+		{
+			g_printerr("%s:%u: %s\n", path, i + 1, bson_error.message);
+			continue;
+		}
+
+		if (parse_event(document, &event))
+		{
+			process_event(&event);
+		}
+
+		bson_destroy(document);
+	}
+
+	return TRUE;
+}
+
+static void
+print_breakdown(gchar const* label, Breakdown const* breakdown)
+{
+	g_print("%-24s %8" G_GUINT64_FORMAT " %12.1f %12.1f %12.1f %12.1f\n",
+		label,
+		breakdown->count,
+		breakdown->total / breakdown->count,
+		breakdown->network / breakdown->count,
+		breakdown->server / breakdown->count,
+		breakdown->backend / breakdown->count);
+}
+
+static gint
+compare_batches(gconstpointer a, gconstpointer b)
+{
+	Batch const* batch_a = *(Batch* const*)a;
+	Batch const* batch_b = *(Batch* const*)b;
+
+	if (batch_a->all.total < batch_b->all.total)
+	{
+		return 1;
+	}
+	else if (batch_a->all.total > batch_b->all.total)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GHashTable) types = NULL;
+	g_autoptr(GHashTable) batches = NULL;
+	g_autoptr(GPtrArray) sorted = NULL;
+	GError* error = NULL;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	GOptionEntry entries[] = {
+		{ "batches", 'b', 0, G_OPTION_ARG_INT, &opt_batches, "Number of slowest batches to print", "10" },
+		{ G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &opt_files, NULL, "FILE..." },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
+	// Explicitly enable UTF-8 since the output contains UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
+
+	context = g_option_context_new(NULL);
+	g_option_context_set_summary(context, "Analyzes binary traces of clients and servers, see JULEA_TRACE=binary.");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		}
+
+		return 1;
+	}
+
+	if (opt_files == NULL)
+	{
+		g_autofree gchar* help = NULL;
+
+		help = g_option_context_get_help(context, TRUE, NULL);
+		g_print("%s", help);
+
+		return 1;
+	}
+
+	spans = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, span_free);
+	stacks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_array_unref);
+
+	for (guint i = 0; opt_files[i] != NULL; i++)
+	{
+		if (!process_file(opt_files[i]))
+		{
+			return 1;
+		}
+	}
+
+	types = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+	batches = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, g_free);
+
+	g_hash_table_iter_init(&iter, spans);
+
+	while (g_hash_table_iter_next(&iter, &key, &value))
+	{
+		Span* span = value;
+		Breakdown breakdown;
+		Breakdown* type;
+		Batch* batch;
+
+		// spans are only complete if the client trace is available
+		if (span->client_begin < 0.0 || span->client_end < 0.0 || span->name == NULL)
+		{
+			continue;
+		}
+
+		span_get_breakdown(span, &breakdown);
+
+		if ((type = g_hash_table_lookup(types, span->name)) == NULL)
+		{
+			type = g_new0(Breakdown, 1);
+			g_hash_table_insert(types, span->name, type);
+		}
+
+		breakdown_add(type, &breakdown);
+
+		if (span->trace_id == 0)
+		{
+			continue;
+		}
+
+		if ((batch = g_hash_table_lookup(batches, &(span->trace_id))) == NULL)
+		{
+			batch = g_new0(Batch, 1);
+			batch->trace_id = span->trace_id;
+			g_hash_table_insert(batches, &(batch->trace_id), batch);
+		}
+
+		breakdown_add(&(batch->all), &breakdown);
+
+		if (breakdown.total > batch->critical.total)
+		{
+			batch->critical = breakdown;
+		}
+	}
+
+	g_print("Average per message in µs:\n");
+	g_print("%-24s %8s %12s %12s %12s %12s\n", "type", "count", "total", "network", "server", "backend");
+
+	g_hash_table_iter_init(&iter, types);
+
+	while (g_hash_table_iter_next(&iter, &key, &value))
+	{
+		print_breakdown(key, value);
+	}
+
+	sorted = g_ptr_array_new();
+	g_hash_table_iter_init(&iter, batches);
+
+	while (g_hash_table_iter_next(&iter, &key, &value))
+	{
+		g_ptr_array_add(sorted, value);
+	}
+
+	// batches are sorted by the duration of all their messages
+	g_ptr_array_sort(sorted, compare_batches);
+
+	g_print("\nSlowest batches, critical message in µs:\n");
+	g_print("%-24s %8s %12s %12s %12s %12s\n", "batch", "messages", "total", "network", "server", "backend");
+
+	for (guint i = 0; i < sorted->len && i < (guint)opt_batches; i++)
+	{
+		Batch* batch = g_ptr_array_index(sorted, i);
+		g_autofree gchar* label = NULL;
+
+		label = g_strdup_printf("%016" G_GINT64_MODIFIER "x", batch->trace_id);
+
+		g_print("%-24s %8" G_GUINT64_FORMAT " %12.1f %12.1f %12.1f %12.1f\n", label, batch->all.count, batch->critical.total, batch->critical.network, batch->critical.server, batch->critical.backend);
+	}
+
+	g_hash_table_unref(stacks);
+	g_hash_table_unref(spans);
+	g_strfreev(opt_files);
+
+	return 0;
+}